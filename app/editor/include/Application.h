@@ -98,6 +98,8 @@ private:
     
     // Primitive meshes
     std::unordered_map<scene::MeshRendererComponent::PrimitiveType, std::unique_ptr<assets::Mesh>> m_PrimitiveMeshes;
+    // Registry meshes whose last reference was dropped, kept until the frame slot that took them comes round again
+    std::vector<std::unique_ptr<assets::Mesh>> m_RetiredMeshes[gfx::MAX_FRAMES_IN_FLIGHT];
     
     // Editable mesh GPU buffers (entity ID -> GPU mesh)
     std::unordered_map<scene::EntityID, std::unique_ptr<assets::Mesh>> m_EditableMeshGPU;
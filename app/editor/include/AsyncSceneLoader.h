@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SceneIO.h"
+#include "lucent/core/Base.h"
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lucent {
+
+// Loads a .lucent scene without stalling the editor.
+//
+// The file is parsed in a job while the current scene stays untouched. Once parsing finishes,
+// Update() replaces the scene with every entity (transforms, cameras, lights, materials) in one
+// step, so the scene is usable straight away. Editable mesh topology is then built by jobs,
+// largest mesh first, and attached by Update() as each one completes; until then the entity is
+// listed in GetPendingMeshes() with its local-space bounds so the viewport can draw a placeholder.
+// The replaced scene is kept until the load completes, so cancelling can put it back.
+//
+// Main thread only (the work it schedules runs on the JobSystem).
+class AsyncSceneLoader : public NonMovable {
+public:
+    enum class Event {
+        None,
+        SceneReplaced,  // Entities were created; meshes may still be pending
+        MeshesAttached, // One or more pending meshes were attached
+        Completed,      // Every mesh has been attached
+        Failed          // Parsing failed and the scene was left as it was (see GetError())
+    };
+
+    struct PendingMesh {
+        scene::EntityID entity;
+        uint32_t meshIndex;  // Index into the parsed SceneDescription
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    AsyncSceneLoader() = default;
+    ~AsyncSceneLoader();
+
+    // Begin loading `filepath` into `scene`, cancelling any load already in progress
+    void Start(scene::Scene* scene, const std::string& filepath);
+
+    // Stop loading. Before SceneReplaced the scene is untouched; afterwards the scene it replaced is
+    // restored (edits made to the loaded scene since are dropped). Returns true if it was restored.
+    bool Cancel();
+
+    // Advance the load; call once per frame. Returns what happened during this call.
+    Event Update();
+
+    bool IsLoading() const { return m_Phase != Phase::Idle; }
+    // The scene has been replaced but meshes are still being built (cancelling now restores the old one)
+    bool IsBuildingMeshes() const { return m_Phase == Phase::BuildingMeshes; }
+    // Whether `filepath` may still be read (binary meshes stay memory-mapped): during a load of it,
+    // and after cancelling one until its jobs have finished. Writing it then is unsafe.
+    bool IsReadingFile(const std::string& filepath) const;
+    // Progress of the current phase, 0..1
+    float GetProgress() const;
+    // "Parsing" or "Building meshes"
+    const char* GetStatus() const;
+
+    const std::string& GetPath() const { return m_Path; }
+    const std::string& GetError() const { return m_Error; }
+    const std::vector<PendingMesh>& GetPendingMeshes() const { return m_PendingMeshes; }
+
+private:
+    struct SharedState;
+
+    enum class Phase {
+        Idle,
+        Parsing,
+        BuildingMeshes
+    };
+
+    void ScheduleMeshBuilds();
+
+    // Kept alive by the jobs as well, so cancelling never waits on (or races with) running work
+    std::shared_ptr<SharedState> m_State;
+    // A cancelled load whose jobs may still be reading m_CancelledPath
+    std::weak_ptr<SharedState> m_CancelledState;
+    std::string m_CancelledPath;
+    scene::Scene* m_Scene = nullptr;
+    Phase m_Phase = Phase::Idle;
+    std::string m_Path;
+    std::string m_Error;
+    std::vector<PendingMesh> m_PendingMeshes;
+    // What m_Scene held before SceneReplaced, until the load completes
+    std::unique_ptr<scene::Scene> m_PreviousScene;
+};
+
+} // namespace lucent
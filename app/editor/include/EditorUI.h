@@ -6,6 +6,8 @@
 #include "lucent/mesh/EditableMesh.h"
 #include "lucent/mesh/MeshOps.h"
 #include "MaterialGraphPanel.h"
+#include "MaterialThumbnails.h"
+#include "AsyncSceneLoader.h"
 #include <vulkan/vulkan.h>
 #include <imgui.h>
 #include <glm/glm.hpp>
@@ -179,6 +181,8 @@ private:
     void DrawConsolePanel();
     void DrawRenderPropertiesPanel();
     void ApplySceneEnvironment();
+    // Save m_Scene in the current scene format (binary unless a text scene was opened)
+    bool SaveSceneTo(const std::string& path);
     
     void DrawEntityNode(scene::Entity entity);
     void DrawComponentsPanel(scene::Entity entity);
@@ -204,6 +208,13 @@ private:
     // Scene indicators (lights/cameras)
     void DrawEntityIndicators();
     
+    // Asynchronous scene loading
+    void OpenSceneAsync(const std::string& path);
+    // Cancel a scene load; one cancelled after the scene was replaced restores the previous scene
+    void CancelSceneLoad();
+    void UpdateSceneLoad();
+    void DrawSceneLoadOverlay();
+    
     // Interactive Transform (Blender-style G/R/S)
     void StartInteractiveTransform(InteractiveTransformType type);
     void UpdateInteractiveTransform();
@@ -322,6 +333,11 @@ private:
     // Scene file management
     std::string m_CurrentScenePath;
     bool m_SceneDirty = false;
+    bool m_SaveSceneAsText = false;
+    AsyncSceneLoader m_SceneLoader;
+    // Restored along with the scene when a load is cancelled after replacing it
+    std::string m_PreviousScenePath;
+    bool m_PreviousSaveSceneAsText = false;
     
     // Modals
     bool m_ShowAboutModal = false;
@@ -333,6 +349,9 @@ private:
     std::string m_ContentBrowserSearch;
     bool m_IconFontLoaded = false;
     
+    // Material thumbnails, shared by the content browser and the material graph panel
+    MaterialThumbnails m_MaterialThumbnails;
+    
     // Material graph panel
     MaterialGraphPanel m_MaterialGraphPanel;
 };
@@ -18,6 +18,8 @@ namespace gfx {
     class Device;
 }
 
+class MaterialThumbnails;
+
 // Node Editor panel for editing material graphs
 class MaterialGraphPanel {
 public:
@@ -49,12 +51,18 @@ public:
     using NavigateToAssetCallback = std::function<void(const std::string& path)>;
     void SetNavigateToAssetCallback(NavigateToAssetCallback callback) { m_NavigateToAsset = callback; }
     
+    // CPU thumbnails shown while the GPU preview has no pipeline (set by EditorUI)
+    void SetThumbnails(MaterialThumbnails* thumbnails) { m_Thumbnails = thumbnails; }
+    
 private:
     void DrawToolbar();
     void DrawNodeEditor();
     void DrawNodeCreationMenu();
     void DrawQuickAddPopup();
     void DrawCompileStatus();
+    void DrawBakePopup();
+    void BakeMaterial();
+    void PollBakeJob();
     void HandleAutoCompile();
     void RenderMaterialPreviewIfNeeded();
     void RenderMaterialPreview();
@@ -107,10 +115,18 @@ private:
     bool m_WasDirty = false;
     float m_DirtySinceTime = 0.0f;
     
+    // Bake to textures; the bake runs as a job and PollBakeJob() finishes it on the main thread
+    struct BakeJob;
+    bool m_OpenBakePopup = false;
+    int m_BakeResolution = 1024;
+    std::string m_BakeStatus;
+    std::shared_ptr<BakeJob> m_BakeJob;
+    
     // Material preview (offscreen)
     bool m_ShowPreview = true;
     bool m_PreviewDirty = true;
     uint64_t m_PreviewGraphHash = 0;
+    uint64_t m_PreviewParameterHash = 0;
     uint32_t m_PreviewSize = 256;
     gfx::Image m_PreviewColor;
     gfx::Image m_PreviewDepth;
@@ -119,6 +135,7 @@ private:
     VkFramebuffer m_PreviewFramebuffer = VK_NULL_HANDLE;
     VkDescriptorSet m_PreviewImGuiTex = VK_NULL_HANDLE;
     std::unique_ptr<assets::Mesh> m_PreviewSphere;
+    MaterialThumbnails* m_Thumbnails = nullptr;
     
     // Asset navigation callback
     NavigateToAssetCallback m_NavigateToAsset;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include "lucent/gfx/Image.h"
+#include "lucent/material/MaterialPreview.h"
+#include <imgui.h>
+#include <vulkan/vulkan.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace lucent {
+
+namespace gfx {
+    class Device;
+}
+
+// Material thumbnails for the content browser and the material editor.
+//
+// Thumbnails are rendered on the CPU by material::MaterialPreviewCache (in the background, cached
+// on disk) and uploaded here to one ImGui texture per material, rewritten in place when a newer
+// thumbnail arrives. Uploads are limited per frame so opening a folder of materials does not stall.
+//
+// Main thread only.
+class MaterialThumbnails : public NonMovable {
+public:
+    static constexpr uint32_t kThumbnailSize = 128;
+
+    MaterialThumbnails() = default;
+    ~MaterialThumbnails();
+
+    bool Init(gfx::Device* device, const std::string& cacheDirectory);
+    // Call with the device idle
+    void Shutdown();
+
+    // Thumbnail of a `.lmat` file, read again when its write time changes. Null until ready.
+    ImTextureID GetFileThumbnail(const std::filesystem::path& path, std::filesystem::file_time_type writeTime);
+    // Thumbnail of a graph being edited; `key` is usually the material path. Null until ready.
+    ImTextureID GetGraphThumbnail(const std::string& key, const material::MaterialGraph& graph);
+    // Why the key's latest thumbnail could not be made (empty when it could)
+    std::string GetError(const std::string& key) const;
+
+    material::MaterialPreviewStats GetStats() const;
+
+private:
+    struct Texture {
+        std::shared_ptr<const material::MaterialPreviewImage> image;   // Uploaded
+        gfx::Image gpuImage;
+        VkDescriptorSet descriptor = VK_NULL_HANDLE;
+    };
+
+    ImTextureID Resolve(const std::string& key, std::shared_ptr<const material::MaterialPreviewImage> image);
+    bool Upload(Texture& texture, const material::MaterialPreviewImage& image);
+
+    gfx::Device* m_Device = nullptr;
+    VkSampler m_Sampler = VK_NULL_HANDLE;
+    std::unique_ptr<material::MaterialPreviewCache> m_Cache;
+    std::unordered_map<std::string, std::unique_ptr<Texture>> m_Textures;
+    std::unordered_map<std::string, std::string> m_Errors;
+
+    int m_UploadFrame = -1;
+    uint32_t m_UploadsThisFrame = 0;
+};
+
+} // namespace lucent
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "lucent/core/MappedFile.h"
+#include "lucent/scene/Scene.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace lucent {
+
+// Binary chunked scene format (.lucent, selected by SceneIO::SceneFormat::Binary).
+//
+// Layout (little-endian, every chunk starts on a kChunkAlignment boundary):
+//   FileHeader            magic, version, chunk count, TOC offset, file size
+//   chunks...             SCNE (SceneRecord), STRS (string blob), ENTS (EntityRecord[]),
+//                         MESH (MeshChunkHeader + aligned positions/uvs/faceSizes/faceIndices)
+//   ChunkEntry[count]     table of contents
+//
+// Mesh arrays are stored exactly as EditableMesh::FlatData holds them, so a mapped file can be
+// handed to EditableMesh::FromArrays() without any parsing or intermediate copies.
+namespace SceneBinary {
+
+inline constexpr char kMagic[8] = { 'L', 'U', 'C', 'E', 'N', 'T', 'S', 'B' };
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint32_t kChunkAlignment = 64;
+inline constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+enum class ChunkType : uint32_t {
+    Scene    = MakeFourCC('S', 'C', 'N', 'E'),
+    Strings  = MakeFourCC('S', 'T', 'R', 'S'),
+    Entities = MakeFourCC('E', 'N', 'T', 'S'),
+    Mesh     = MakeFourCC('M', 'E', 'S', 'H'),
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunkCount;
+    uint64_t tocOffset;
+    uint64_t fileSize;
+    uint32_t reserved[8];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct ChunkEntry {
+    uint32_t type;  // ChunkType
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(ChunkEntry) == 24);
+
+// Strings are (offset, length) ranges into the STRS chunk
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SceneRecord {
+    StringRef name;
+    StringRef environmentMap;
+    uint32_t entityCount;
+    uint32_t meshCount;
+};
+
+enum ComponentBits : uint32_t {
+    kHasTransform    = 1u << 0,
+    kHasCamera       = 1u << 1,
+    kHasLight        = 1u << 2,
+    kHasMeshRenderer = 1u << 3,
+    kHasEditableMesh = 1u << 4,
+};
+
+struct EntityRecord {
+    StringRef name;
+    uint32_t components;  // ComponentBits
+    uint32_t meshChunk;   // TOC index of the MESH chunk, or kInvalidIndex
+
+    float position[3];
+    float rotation[3];
+    float scale[3];
+
+    int32_t cameraProjection;
+    float cameraFov;
+    float cameraOrthoSize;
+    float cameraNear;
+    float cameraFar;
+    uint32_t cameraPrimary;
+
+    int32_t lightType;
+    float lightColor[3];
+    float lightIntensity;
+    float lightRange;
+    float lightInnerAngle;
+    float lightOuterAngle;
+    int32_t lightAreaShape;
+    float lightAreaWidth;
+    float lightAreaHeight;
+    float lightShadowSoftness;
+    uint32_t lightCastShadows;
+
+    int32_t primitiveType;
+    uint32_t visible;
+    uint32_t castShadows;
+    uint32_t receiveShadows;
+    float baseColor[3];
+    float metallic;
+    float roughness;
+    float emissive[3];
+    float emissiveIntensity;
+    StringRef materialPath;
+
+    int32_t sourcePrimitive;
+    uint32_t fromImport;
+};
+
+// Array offsets are relative to the start of the MESH chunk and kChunkAlignment-aligned
+struct MeshChunkHeader {
+    uint32_t vertexCount;
+    uint32_t faceCount;
+    uint32_t indexCount;
+    uint32_t hasUVs;
+    uint64_t positionsOffset;  // glm::vec3[vertexCount]
+    uint64_t uvsOffset;        // glm::vec2[vertexCount] (if hasUVs)
+    uint64_t faceSizesOffset;  // uint32_t[faceCount]
+    uint64_t indicesOffset;    // uint32_t[indexCount]
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Zero-copy view of one mesh chunk inside a mapped file
+struct MeshView {
+    std::span<const glm::vec3> positions;
+    std::span<const glm::vec2> uvs;
+    std::span<const uint32_t> faceSizes;
+    std::span<const uint32_t> faceIndices;
+    glm::vec3 boundsMin{ 0.0f };
+    glm::vec3 boundsMax{ 0.0f };
+};
+
+// Write `scene` in binary form. On failure returns false and sets `error`.
+bool Write(scene::Scene* scene, const std::string& filepath, std::string& error);
+
+// True if the file starts with the binary scene magic
+bool IsBinarySceneFile(const std::string& filepath);
+
+// Memory-mapped reader; all views returned stay valid while the reader is open.
+class Reader : public NonCopyable {
+public:
+    bool Open(const std::string& filepath, std::string& error);
+    void Close();
+
+    const SceneRecord& GetScene() const { return *m_Scene; }
+    std::span<const EntityRecord> GetEntities() const { return m_Entities; }
+    std::string_view GetString(const StringRef& ref) const;
+
+    // Validates the chunk and returns views into the mapping
+    bool GetMesh(uint32_t chunkIndex, MeshView& out) const;
+
+private:
+    const ChunkEntry* FindChunk(ChunkType type) const;
+
+    MappedFile m_File;
+    std::span<const ChunkEntry> m_Chunks;
+    const SceneRecord* m_Scene = nullptr;
+    std::span<const char> m_Strings;
+    std::span<const EntityRecord> m_Entities;
+};
+
+// Create an entity with every component described by `record` except the editable mesh.
+// `name` and `materialPath` replace the record's string refs (resolve them with Reader::GetString()).
+scene::Entity CreateEntity(scene::Scene* scene, const EntityRecord& record,
+                           std::string_view name, std::string_view materialPath);
+
+} // namespace SceneBinary
+
+} // namespace lucent
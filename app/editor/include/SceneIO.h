@@ -1,13 +1,18 @@
 #pragma once
 
+#include "SceneBinary.h"
 #include "lucent/scene/Scene.h"
 #include "lucent/gfx/Device.h"
+#include "lucent/mesh/EditableMesh.h"
+#include <atomic>
 #include <string>
+#include <vector>
 
 namespace lucent {
 
-// Simple text-based scene serialization (.lucent format)
-// Format is line-based for easy debugging:
+// Scene serialization (.lucent). Two encodings share the extension:
+// - Binary (SceneBinary.h): chunked, mesh arrays stored raw and memory-mapped on load.
+// - Text: line-based and diff-friendly, for debugging and version control:
 //   LUCENT_SCENE_V1
 //   SCENE_NAME: <name>
 //   ENTITY_BEGIN
@@ -20,14 +25,65 @@ namespace lucent {
 
 namespace SceneIO {
 
+enum class SceneFormat {
+    Text,
+    Binary
+};
+
 // Save scene to file
 // Returns true on success
-bool SaveScene(scene::Scene* scene, const std::string& filepath);
+bool SaveScene(scene::Scene* scene, const std::string& filepath, SceneFormat format = SceneFormat::Text);
 
-// Load scene from file
+// Load scene from file (format is detected from the file header)
 // Returns true on success (scene is cleared first)
 bool LoadScene(scene::Scene* scene, const std::string& filepath);
 
+// Format of an existing scene file (Text if it is not a binary scene)
+SceneFormat DetectSceneFormat(const std::string& filepath);
+
+// Contents of a scene file, independent of the scene it will be loaded into.
+// Produced by ParseScene() (safe on any thread), consumed on the main thread by InstantiateScene().
+struct SceneDescription {
+    struct Entity {
+        SceneBinary::EntityRecord record{};  // Component data; string refs are resolved into the fields below
+        std::string name;
+        std::string materialPath;
+        uint32_t mesh = SceneBinary::kInvalidIndex;  // Index into meshes
+    };
+
+    struct Mesh {
+        SceneBinary::MeshView view;               // Arrays for EditableMesh::FromArrays()
+        mesh::EditableMesh::FlatData storage;     // Backs `view` for text scenes
+    };
+
+    std::string name;
+    std::string environmentMap;
+    std::vector<Entity> entities;
+    std::vector<Mesh> meshes;
+    SceneBinary::Reader binary;  // Backs mesh views for binary scenes
+};
+
+// Progress/cancellation shared with a ParseScene() call running on another thread
+struct SceneParseProgress {
+    std::atomic<float> fraction{ 0.0f };
+    std::atomic<bool> cancelled{ false };
+};
+
+// Parse a scene file. Touches no scene or GPU state, so it can run on a worker.
+// Returns false on error or cancellation and sets `error`.
+bool ParseScene(const std::string& filepath, SceneDescription& out, std::string& error,
+                SceneParseProgress* progress = nullptr);
+
+// Clear `scene` and create every entity in `desc` except editable meshes.
+// Returns the created entity IDs in description order.
+std::vector<scene::EntityID> InstantiateScene(scene::Scene* scene, const SceneDescription& desc);
+
+// Build the topology for one described mesh (thread-safe; no scene access)
+mesh::EditableMesh BuildMesh(const SceneDescription::Mesh& source);
+
+// Give `entity` its built editable mesh, with the flags recorded in `desc`
+void AttachMesh(scene::Entity entity, const SceneDescription::Entity& desc, mesh::EditableMesh&& built);
+
 // Import glTF/GLB model into existing scene (adds entities, does not clear)
 // Returns number of entities created, or -1 on error
 int ImportGLTF(scene::Scene* scene, gfx::Device* device, const std::string& filepath);
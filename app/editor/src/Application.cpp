@@ -1,16 +1,34 @@
 #include "Application.h"
 #include "EditorSettings.h"
+#include "lucent/core/Arena.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Profiler.h"
 #include "lucent/gfx/DebugUtils.h"
+#include "lucent/gfx/TextureCache.h"
 #include "lucent/gfx/VkResultUtils.h"
+#include "lucent/assets/MeshOptimizer.h"
 #include "lucent/assets/MeshRegistry.h"
+#include "lucent/assets/ModelLoader.h"
 #include "lucent/scene/Components.h"
+#include "lucent/material/CustomCode.h"
 #include "lucent/material/MaterialAsset.h"
+#include "lucent/material/MaterialCompileQueue.h"
 #include "lucent/material/MaterialGraphEval.h"
 #include "lucent/material/MaterialIR.h"
+#include "lucent/material/MaterialOptimizer.h"
+#include "lucent/material/ShaderCache.h"
+#include "lucent/material/RTMaterialCompiler.h"
+#include "lucent/material/TracerMaterials.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <unordered_map>
 
 // GLFW native access (Win32 HWND)
 #define GLFW_EXPOSE_NATIVE_WIN32
@@ -64,6 +82,103 @@ static bool HasCameraChanged(const CameraSnapshot& prev, const scene::EditorCame
     return false;
 }
 
+// Entities drawn with the same mesh and the same per-draw constants collapse into one instanced
+// draw; only the model matrix varies per instance (vertex binding 1)
+struct InstanceBatchKey {
+    assets::Mesh* mesh = nullptr;
+    uint32_t lod = 0;
+    glm::vec4 baseColor{ 0.0f };
+    glm::vec4 materialParams{ 0.0f };
+    glm::vec4 emissive{ 0.0f };
+
+    bool operator==(const InstanceBatchKey&) const = default;
+};
+
+struct InstanceBatchKeyHash {
+    size_t operator()(const InstanceBatchKey& key) const {
+        size_t h = std::hash<const void*>{}(key.mesh) ^ (static_cast<size_t>(key.lod) << 1);
+        for (const glm::vec4* v : { &key.baseColor, &key.materialParams, &key.emissive }) {
+            for (int i = 0; i < 4; ++i) {
+                const float component = (*v)[i];
+                uint32_t bits;
+                std::memcpy(&bits, &component, sizeof(bits));
+                h ^= bits + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            }
+        }
+        return h;
+    }
+};
+
+// Screen-space LOD selection: the LOD whose simplification error stays under a pixel at the
+// bounding sphere's nearest point. projectionScale is viewportHeight / (2 * tan(fovY / 2)).
+uint32_t SelectMeshLOD(const assets::Mesh& mesh, const glm::mat4& transform, const glm::vec3& cameraPos,
+                       float projectionScale, float nearClip) {
+    if (mesh.GetLODCount() <= 1) return 0;
+    
+    const glm::vec3 center = glm::vec3(transform * glm::vec4(mesh.GetBounds().GetCenter(), 1.0f));
+    const float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                                   glm::length(glm::vec3(transform[2])) });
+    const float radius = glm::length(mesh.GetBounds().GetExtents()) * scale;
+    const float distance = std::max(glm::length(center - cameraPos) - radius, nearClip);
+    return mesh.SelectLOD(projectionScale * scale / distance);
+}
+
+class InstanceBatcher {
+public:
+    explicit InstanceBatcher(std::pmr::memory_resource* memory)
+        : m_BatchIndex(memory), m_Batches(memory), m_Instances(memory) {}
+
+    void Add(const InstanceBatchKey& key, const glm::mat4& transform) {
+        auto [it, inserted] = m_BatchIndex.try_emplace(key, static_cast<uint32_t>(m_Batches.size()));
+        if (inserted) {
+            m_Batches.push_back({ key, 0, 0 });
+        }
+        m_Batches[it->second].count++;
+        m_Instances.push_back({ it->second, transform });
+    }
+
+    // Uploads every batch's transforms contiguously, binds the instance buffer and calls
+    // draw(key, instanceCount, firstInstance) once per batch in first-seen order
+    template<typename DrawFn>
+    void Flush(gfx::Renderer& renderer, VkCommandBuffer cmd, DrawFn&& draw) {
+        if (m_Instances.empty()) return;
+
+        uint32_t offset = 0;
+        for (Batch& batch : m_Batches) {
+            batch.first = offset;
+            offset += batch.count;
+        }
+        std::pmr::vector<glm::mat4> transforms(m_Instances.size(), m_Instances.get_allocator());
+        std::pmr::vector<uint32_t> cursor(m_Batches.size(), 0, m_Instances.get_allocator());
+        for (const Instance& instance : m_Instances) {
+            const Batch& batch = m_Batches[instance.batch];
+            transforms[batch.first + cursor[instance.batch]++] = instance.transform;
+        }
+
+        const uint32_t base = renderer.AppendInstances(transforms.data(), static_cast<uint32_t>(transforms.size()));
+        if (base == UINT32_MAX) return;
+        renderer.BindInstanceBuffer(cmd);
+        for (const Batch& batch : m_Batches) {
+            draw(batch.key, batch.count, base + batch.first);
+        }
+    }
+
+private:
+    struct Batch {
+        InstanceBatchKey key;
+        uint32_t count;
+        uint32_t first;
+    };
+    struct Instance {
+        uint32_t batch;
+        glm::mat4 transform;
+    };
+
+    std::pmr::unordered_map<InstanceBatchKey, uint32_t, InstanceBatchKeyHash> m_BatchIndex;
+    std::pmr::vector<Batch> m_Batches;
+    std::pmr::vector<Instance> m_Instances;
+};
+
 #ifdef _WIN32
 constexpr wchar_t kSplashClassName[] = L"LucentSplashWindow";
 
@@ -142,6 +257,7 @@ Application::~Application() {
 
 bool Application::Init(const ApplicationConfig& config) {
     m_Config = config;
+    LUCENT_PROFILE_THREAD("Main");
 
 #ifdef _WIN32
     ShowSplashScreen();
@@ -184,7 +300,16 @@ bool Application::Init(const ApplicationConfig& config) {
         return false;
     }
 
+    // Shared worker pool for BVH builds, imports and background compiles
+    JobSystem::Get().Init();
+
     gfx::EnvironmentMapLibrary::Get().Init(&m_Device);
+    gfx::TextureCache::Get().Init(&m_Device);
+    // Processed (mipped, block-compressed) textures live next to Assets/ between runs
+    gfx::TextureCache::Get().SetDiskCacheDirectory((std::filesystem::current_path() / "Cache" / "Textures").string());
+    assets::ModelLoader::SetImportCacheDirectory((std::filesystem::current_path() / "Cache" / "Models").string());
+    gfx::EnvironmentMapLibrary::Get().SetDiskCacheDirectory((std::filesystem::current_path() / "Cache" / "Environments").string());
+    material::ShaderCache::Get().SetDirectory((std::filesystem::current_path() / "Cache" / "Shaders").string());
     
     // Initialize renderer
     gfx::RendererConfig rendererConfig{};
@@ -289,36 +414,42 @@ void Application::UpdateEditableMeshGPU(scene::Entity entity) {
     auto* editMesh = entity.GetComponent<scene::EditableMeshComponent>();
     if (!editMesh || !editMesh->HasMesh()) return;
     
-    // Get triangulated output
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec4> tangents;
-    std::vector<uint32_t> indices;
-    
-    bool updated = editMesh->GetTriangulatedOutput(positions, normals, uvs, tangents, indices);
-    
-    if (!updated && m_EditableMeshGPU.count(entity.GetID()) > 0) {
-        // Mesh not dirty and we already have GPU buffers
+    // Not dirty: either the GPU copy is current or there is nothing to upload.
+    if (!editMesh->dirty) {
         return;
     }
     
-    if (positions.empty() || indices.empty()) {
+    // Triangulate into scratch memory; Mesh::Create copies what it keeps.
+    ScratchScope scratch;
+    std::pmr::vector<mesh::TriangleOutput::Vertex> triVertices(scratch.Resource());
+    std::pmr::vector<uint32_t> indices(scratch.Resource());
+    
+    if (!editMesh->GetTriangulatedOutput(triVertices, indices)) {
         return;
     }
     
     // Build vertex data in the format expected by assets::Mesh
-    std::vector<assets::Vertex> vertices;
-    vertices.reserve(positions.size());
-    for (size_t i = 0; i < positions.size(); ++i) {
+    std::pmr::vector<assets::Vertex> vertices(scratch.Resource());
+    vertices.reserve(triVertices.size());
+    for (const auto& tv : triVertices) {
         assets::Vertex v;
-        v.position = positions[i];
-        v.normal = (i < normals.size()) ? normals[i] : glm::vec3(0, 1, 0);
-        v.uv = (i < uvs.size()) ? uvs[i] : glm::vec2(0, 0);
-        v.tangent = (i < tangents.size()) ? tangents[i] : glm::vec4(1, 0, 0, 1);
+        v.position = tv.position;
+        v.normal = tv.normal;
+        v.uv = tv.uv;
+        v.tangent = tv.tangent;
         vertices.push_back(v);
     }
     
+    // Interactive edits upload as-is; once the mesh is committed (Edit Mode exited) it is
+    // reordered for the vertex cache, overdraw and vertex fetch like imported meshes
+    const bool editing = m_EditorUI.IsInEditMode() && m_EditorUI.GetEditedEntity().GetID() == entity.GetID();
+    if (!editing) {
+        assets::MeshOptimizer::Stats stats;
+        vertices.resize(assets::MeshOptimizer::Optimize(vertices, indices, {}, &stats));
+        LUCENT_CORE_DEBUG("Editable mesh {}: ACMR {:.2f} -> {:.2f}, {} KB vertex data",
+            entity.GetID(), stats.acmrBefore, stats.acmrAfter, stats.vertexBytes / 1024);
+    }
+    
     // Create or update GPU mesh
     auto& gpuMesh = m_EditableMeshGPU[entity.GetID()];
     if (!gpuMesh) {
@@ -353,6 +484,8 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
     
     // Get camera position for specular calculations
     glm::vec3 camPos = m_EditorCamera.GetPosition();
+    const float projectionScale = static_cast<float>(m_Renderer.GetOffscreenImage()->GetHeight()) /
+        (2.0f * std::tan(glm::radians(m_EditorCamera.GetFOV()) * 0.5f));
     
     // Push constants structure (shared between both passes)
     struct PushConstants {
@@ -365,6 +498,9 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
         glm::mat4 lightViewProj;   // Light space matrix for shadows
     };
     
+    // Default-pipeline entities are gathered here and drawn instanced after the opaque pass
+    InstanceBatcher batcher(FrameArena::Resource());
+    
     // Helper lambda to render an entity
     auto renderEntity = [&](scene::Entity entity, scene::MeshRendererComponent& renderer, 
                             scene::TransformComponent& transform, VkPipeline& currentPipeline, 
@@ -376,7 +512,12 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
         material::MaterialAsset* mat = nullptr;
         if (renderer.UsesMaterialAsset()) {
             mat = material::MaterialAssetManager::Get().GetMaterial(renderer.materialPath);
-            if (mat && mat->IsValid()) {
+            if (mat) {
+                // Drawn materials compile before off-screen ones
+                material::MaterialAssetManager::Get().MarkVisible(mat);
+            }
+            // Compiling volumes are volumes too, so they are never drawn as opaque surfaces
+            if (mat && (mat->IsValid() || mat->IsRecompileInProgress())) {
                 isVolumeMaterial = mat->IsVolumeMaterial();
             }
         }
@@ -384,6 +525,8 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
         // Skip based on pass
         if (volumePass && !isVolumeMaterial) return;
         if (!volumePass && isVolumeMaterial) return;
+        // A volume has nothing to draw until its first pipeline lands
+        if (isVolumeMaterial && !mat->GetPipeline()) return;
         
         assets::Mesh* mesh = nullptr;
         
@@ -405,26 +548,31 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
                 auto it = m_PrimitiveMeshes.find(renderer.primitiveType);
                 if (it == m_PrimitiveMeshes.end() || !it->second) return;
                 mesh = it->second.get();
-            } else if (renderer.meshAssetID != UINT32_MAX) {
-                mesh = lucent::assets::MeshRegistry::Get().GetMesh(renderer.meshAssetID);
+            } else if (renderer.meshAsset.IsValid()) {
+                mesh = renderer.meshAsset.Get();
                 if (!mesh) return;
             } else {
                 return;
             }
         }
         
-        // Determine pipeline and layout to use
-        VkPipeline pipeline = defaultPipeline;
-        VkPipelineLayout layout = defaultLayout;
-        bool usesMaterialPipeline = false;
+        const glm::vec4 baseColor(renderer.baseColor, 1.0f);
+        const glm::vec4 materialParams(renderer.metallic, renderer.roughness, renderer.emissiveIntensity, m_ShadowBias);
+        const glm::vec4 emissive(renderer.emissive, m_ShadowsEnabled ? 1.0f : 0.0f);
+        const glm::mat4 model = transform.GetLocalMatrix();
+        const uint32_t lod = SelectMeshLOD(*mesh, model, camPos, projectionScale, m_EditorCamera.GetNearClip());
         
-        // Check if entity has a material asset assigned
-        if (mat && mat->GetPipeline()) {
-            pipeline = mat->GetPipeline();
-            layout = mat->GetPipelineLayout();
-            usesMaterialPipeline = true;
+        // Default pipeline: the model matrix comes from the instance buffer, so entities sharing a
+        // mesh, LOD and material values collapse into one draw
+        if (!mat || !mat->GetPipeline()) {
+            batcher.Add({ mesh, lod, baseColor, materialParams, emissive }, model);
+            return;
         }
         
+        // Material pipelines keep per-entity draws with the model matrix in push constants
+        VkPipeline pipeline = mat->GetPipeline();
+        VkPipelineLayout layout = mat->GetPipelineLayout();
+        
         // Bind pipeline if changed
         if (pipeline != currentPipeline) {
             vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
@@ -432,27 +580,20 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
             currentLayout = layout;
         }
         
-        // Bind descriptor set(s)
-        if (usesMaterialPipeline) {
-            // Bind material texture set at set 0
-            if (mat && mat->HasDescriptorSet()) {
-                VkDescriptorSet matSet = mat->GetDescriptorSet();
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
-                    0, 1, &matSet, 0, nullptr);
-            }
-        } else {
-            // Bind shadow set for default pipeline
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultLayout,
-                0, 1, &shadowSet, 0, nullptr);
+        // Bind material texture set at set 0
+        if (mat->HasDescriptorSet()) {
+            VkDescriptorSet matSet = mat->GetDescriptorSet();
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+                0, 1, &matSet, 0, nullptr);
         }
         
         // Push constants with full material data
         PushConstants pc;
-        pc.model = transform.GetLocalMatrix();
+        pc.model = model;
         pc.viewProj = viewProj;
-        pc.baseColor = glm::vec4(renderer.baseColor, 1.0f);
-        pc.materialParams = glm::vec4(renderer.metallic, renderer.roughness, renderer.emissiveIntensity, m_ShadowBias);
-        pc.emissive = glm::vec4(renderer.emissive, m_ShadowsEnabled ? 1.0f : 0.0f);
+        pc.baseColor = baseColor;
+        pc.materialParams = materialParams;
+        pc.emissive = emissive;
         pc.cameraPos = glm::vec4(camPos, m_EditorUI.GetExposure());
         pc.lightViewProj = m_LightViewProj;
         
@@ -460,7 +601,7 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
             VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstants), &pc);
         
         mesh->Bind(cmd);
-        mesh->Draw(cmd);
+        mesh->Draw(cmd, 1, 0, lod);
     };
     
     // Track currently bound pipeline for batching
@@ -473,6 +614,34 @@ void Application::RenderMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj) {
         renderEntity(entity, renderer, transform, currentPipeline, currentLayout, /*volumePass=*/false);
     });
     
+    // Instanced draws for everything on the default pipeline
+    bool defaultBound = false;
+    batcher.Flush(m_Renderer, cmd, [&](const InstanceBatchKey& key, uint32_t instanceCount, uint32_t firstInstance) {
+        if (!defaultBound) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultPipeline);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultLayout,
+                0, 1, &shadowSet, 0, nullptr);
+            currentPipeline = defaultPipeline;
+            currentLayout = defaultLayout;
+            defaultBound = true;
+        }
+        
+        PushConstants pc;
+        pc.model = glm::mat4(1.0f);     // Unused by mesh.vert (per-instance attribute)
+        pc.viewProj = viewProj;
+        pc.baseColor = key.baseColor;
+        pc.materialParams = key.materialParams;
+        pc.emissive = key.emissive;
+        pc.cameraPos = glm::vec4(camPos, m_EditorUI.GetExposure());
+        pc.lightViewProj = m_LightViewProj;
+        
+        vkCmdPushConstants(cmd, defaultLayout, 
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstants), &pc);
+        
+        key.mesh->Bind(cmd);
+        key.mesh->Draw(cmd, instanceCount, firstInstance, key.lod);
+    });
+    
     // PASS 2: Render volume materials (after opaque, for correct alpha blending)
     view.Each([&](scene::Entity entity, scene::MeshRendererComponent& renderer, scene::TransformComponent& transform) {
         renderEntity(entity, renderer, transform, currentPipeline, currentLayout, /*volumePass=*/true);
@@ -559,6 +728,13 @@ void Application::InitScene() {
 
 void Application::Run() {
     while (m_Running && !glfwWindowShouldClose(m_Window)) {
+        LUCENT_PROFILE_FRAME();
+
+        // Release last frame's transient allocations
+        FrameArena::NextFrame();
+        LUCENT_PROFILE_COUNTER("Frame arena KB", FrameArena::GetStats().frameBytes / 1024);
+        LUCENT_PROFILE_COUNTER("Scratch KB", FrameArena::GetStats().scratchBytes / 1024);
+
         // Calculate delta time
         double currentTime = glfwGetTime();
         m_DeltaTime = static_cast<float>(currentTime - m_LastFrameTime);
@@ -578,7 +754,10 @@ void Application::Run() {
             m_FpsTimer = 0.0;
         }
         
-        glfwPollEvents();
+        {
+            LUCENT_PROFILE_ZONE("PollEvents");
+            glfwPollEvents();
+        }
         
         // Skip rendering if minimized
         int width, height;
@@ -623,10 +802,19 @@ void Application::Shutdown() {
 #endif
     if (!m_Window) return;
     
+    // Drain in-flight jobs before the systems they reference go away
+    material::MaterialCompileQueue::Get().Shutdown();
+    JobSystem::Get().Shutdown();
     material::MaterialAssetManager::Get().Shutdown();
     gfx::EnvironmentMapLibrary::Get().Shutdown();
     m_EditorUI.Shutdown();
     m_Renderer.Shutdown();
+    // The GPU is idle: drop the scene's mesh references and destroy every registry mesh
+    m_Scene.Clear();
+    for (auto& retired : m_RetiredMeshes) retired.clear();
+    assets::MeshRegistry::Get().Clear();
+    // After materials and tracers have released their handles
+    gfx::TextureCache::Get().Shutdown();
     m_Device.Shutdown();
     m_VulkanContext.Shutdown();
     
@@ -789,6 +977,8 @@ void Application::RenderSceneToViewport(VkCommandBuffer cmd) {
     gfx::RenderMode renderMode = m_Renderer.GetRenderMode();
     // Keep settings mode in sync (used for convergence logic)
     m_Renderer.GetSettings().activeMode = renderMode;
+    // Upload environments that finished loading in the background before picking the active one
+    gfx::EnvironmentMapLibrary::Get().Update();
     UpdateEnvironmentMapFromSettings();
     
     if (renderMode == gfx::RenderMode::Traced && m_Renderer.GetTracerCompute()) {
@@ -1027,8 +1217,20 @@ void Application::RenderSceneToViewport(VkCommandBuffer cmd) {
 }
 
 void Application::RenderFrame() {
-    if (!m_Renderer.BeginFrame()) {
-        return;
+    LUCENT_PROFILE_FUNCTION();
+
+    {
+        LUCENT_PROFILE_ZONE("Renderer::BeginFrame");
+        if (!m_Renderer.BeginFrame()) {
+            return;
+        }
+    }
+
+    // BeginFrame waited for this slot's previous frame, the last one that could draw the meshes
+    // retired into it; meshes released since then wait for the next time round
+    {
+        auto& retired = m_RetiredMeshes[m_Renderer.GetCurrentFrameIndex()];
+        retired = assets::MeshRegistry::Get().TakeRetired();
     }
 
     if (auto* finalRender = m_Renderer.GetFinalRender();
@@ -1040,12 +1242,21 @@ void Application::RenderFrame() {
     gfx::Image* offscreen = m_Renderer.GetOffscreenImage();
 
     // Apply any finished background material compiles on the main thread.
-    material::MaterialAssetManager::Get().PumpAsyncCompiles();
+    JobSystem::Get().PumpMainThreadJobs();
+    // Submit decoded textures before materials check for newly resident ones
+    gfx::TextureCache::Get().Update();
+    // Tracer materials and volumes are built from the compile state; rebuild when it changes
+    if (!material::MaterialAssetManager::Get().PumpAsyncCompiles().empty()) {
+        m_TracerSceneDirty = true;
+    }
     
     // =========================================================================
     // Pass 1: Render scene to offscreen image (viewport content)
     // =========================================================================
-    RenderSceneToViewport(cmd);
+    {
+        LUCENT_PROFILE_ZONE("RenderSceneToViewport");
+        RenderSceneToViewport(cmd);
+    }
     
     // Update viewport texture for ImGui (once per resize)
     if (!m_ViewportTextureReady) {
@@ -1073,8 +1284,11 @@ void Application::RenderFrame() {
     // =========================================================================
     // Pass 2: Begin ImGui frame and prepare UI
     // =========================================================================
-    m_EditorUI.BeginFrame();
-    m_EditorUI.EndFrame();
+    {
+        LUCENT_PROFILE_ZONE("EditorUI");
+        m_EditorUI.BeginFrame();
+        m_EditorUI.EndFrame();
+    }
     
     // =========================================================================
     // Pass 3: Render ImGui to swapchain
@@ -1101,7 +1315,10 @@ void Application::RenderFrame() {
     // Render ImGui platform windows after the main swapchain pass.
     m_EditorUI.RenderPlatformWindows();
     
-    m_Renderer.EndFrame();
+    {
+        LUCENT_PROFILE_ZONE("Renderer::EndFrame");
+        m_Renderer.EndFrame();
+    }
 
     // Stop cleanly on fatal Vulkan errors (prevents infinite retry loops / driver resets)
     if (m_Renderer.HasFatalError()) {
@@ -1307,7 +1524,12 @@ void Application::RenderShadowPass(VkCommandBuffer cmd) {
     // Bind shadow pipeline
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Renderer.GetShadowPipeline());
     
-    // Render all meshes to shadow map
+    // Casters are grouped by mesh and drawn instanced; the light matrix is the only push constant.
+    // Each caster uses the LOD the main view picks for it.
+    const glm::vec3 camPos = m_EditorCamera.GetPosition();
+    const float projectionScale = static_cast<float>(m_Renderer.GetOffscreenImage()->GetHeight()) /
+        (2.0f * std::tan(glm::radians(m_EditorCamera.GetFOV()) * 0.5f));
+    InstanceBatcher batcher(FrameArena::Resource());
     auto view = m_Scene.GetView<scene::MeshRendererComponent, scene::TransformComponent>();
     view.Each([&](scene::Entity entity, scene::MeshRendererComponent& renderer, scene::TransformComponent& transform) {
         (void)entity;
@@ -1319,26 +1541,34 @@ void Application::RenderShadowPass(VkCommandBuffer cmd) {
             auto it = m_PrimitiveMeshes.find(renderer.primitiveType);
             if (it == m_PrimitiveMeshes.end() || !it->second) return;
             mesh = it->second.get();
-        } else if (renderer.meshAssetID != UINT32_MAX) {
-            mesh = lucent::assets::MeshRegistry::Get().GetMesh(renderer.meshAssetID);
+        } else if (renderer.meshAsset.IsValid()) {
+            mesh = renderer.meshAsset.Get();
             if (!mesh) return;
         } else {
             return;
         }
         
-        struct ShadowPushConstants {
-            glm::mat4 model;
-            glm::mat4 lightViewProj;
-        } pc;
-        
-        pc.model = transform.GetLocalMatrix();
-        pc.lightViewProj = m_LightViewProj;
-        
-        vkCmdPushConstants(cmd, m_Renderer.GetShadowPipelineLayout(), 
-            VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ShadowPushConstants), &pc);
-        
-        mesh->Bind(cmd);
-        mesh->Draw(cmd);
+        const glm::mat4 model = transform.GetLocalMatrix();
+        InstanceBatchKey key;
+        key.mesh = mesh;
+        key.lod = SelectMeshLOD(*mesh, model, camPos, projectionScale, m_EditorCamera.GetNearClip());
+        batcher.Add(key, model);
+    });
+    
+    struct ShadowPushConstants {
+        glm::mat4 model;            // Unused by shadow_depth.vert (per-instance attribute)
+        glm::mat4 lightViewProj;
+    } pc;
+    
+    pc.model = glm::mat4(1.0f);
+    pc.lightViewProj = m_LightViewProj;
+    
+    vkCmdPushConstants(cmd, m_Renderer.GetShadowPipelineLayout(), 
+        VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ShadowPushConstants), &pc);
+    
+    batcher.Flush(m_Renderer, cmd, [&](const InstanceBatchKey& key, uint32_t instanceCount, uint32_t firstInstance) {
+        key.mesh->Bind(cmd);
+        key.mesh->Draw(cmd, instanceCount, firstInstance, key.lod);
     });
     
     // End shadow render pass
@@ -1352,6 +1582,8 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
                                        std::vector<gfx::RTTextureKey>* outRTTextures,
                                        std::vector<gfx::RTMaterialHeader>* outRTHeaders,
                                        std::vector<gfx::RTMaterialInstr>* outRTInstrs) {
+    LUCENT_PROFILE_FUNCTION();
+
     triangles.clear();
     materials.clear();
     lights.clear();
@@ -1431,690 +1663,30 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
         outRTHeaders->push_back(gfx::RTMaterialHeader{}); // default material has no IR
     }
 
-    // Minimal RT material IR compiler (Surface domain only, UV + Texture2D + basic math).
-    // This feeds the raytracing closest-hit interpreter in `shaders/rt_closesthit.rchit`.
-    auto compileGraphToRTIR = [&](const material::MaterialGraph& graph,
-                                  gfx::RTMaterialHeader& outHdr,
-                                  std::vector<gfx::RTMaterialInstr>& outInstrsLocal,
-                                  std::string& outErr) -> bool {
-        outHdr = gfx::RTMaterialHeader{};
-        outInstrsLocal.clear();
-        outErr.clear();
-
-        // V1: surface-only
-        if (graph.GetDomain() == material::MaterialDomain::Volume) {
-            outErr = "Volume domain not supported for RT per-hit evaluation";
-            return false;
-        }
-
-        const material::NodeID outNodeId = graph.GetOutputNodeId();
-        const material::MaterialNode* outNode = graph.GetNode(outNodeId);
-        if (!outNode || outNode->type != material::NodeType::PBROutput) {
-            outErr = "Missing PBR output node";
-            return false;
-        }
-
-        // ---------------------------------------------------------------------
-        // RT material IR opcodes (must match `shaders/rt_closesthit.rchit`)
-        // ---------------------------------------------------------------------
-        constexpr uint32_t OP_CONST       = 1u;
-        constexpr uint32_t OP_UV          = 2u;
-        constexpr uint32_t OP_TEX2D       = 3u;
-        constexpr uint32_t OP_ADD         = 4u;
-        constexpr uint32_t OP_MUL         = 5u;
-        constexpr uint32_t OP_LERP        = 6u;
-        constexpr uint32_t OP_CLAMP       = 7u;
-        constexpr uint32_t OP_SATURATE    = 8u;
-        constexpr uint32_t OP_ONEMINUS    = 9u;
-        constexpr uint32_t OP_SWIZZLE     = 10u; // texIndex: 0=x,1=y,2=z,3=w,4=xyz (w=1)
-        constexpr uint32_t OP_COMBINE3    = 11u;
-        constexpr uint32_t OP_FRESNEL     = 12u;
-        constexpr uint32_t OP_SUB         = 13u;
-        constexpr uint32_t OP_DIV         = 14u;
-        constexpr uint32_t OP_POW         = 15u;
-        // NOTE: Remap is expanded into primitive ops on the CPU side (keeps interpreter simpler)
-        constexpr uint32_t OP_STEP        = 17u;
-        constexpr uint32_t OP_SMOOTHSTEP  = 18u;
-        constexpr uint32_t OP_SIN         = 19u;
-        constexpr uint32_t OP_COS         = 20u;
-        constexpr uint32_t OP_ABS         = 21u;
-        constexpr uint32_t OP_MIN         = 22u;
-        constexpr uint32_t OP_MAX         = 23u;
-        constexpr uint32_t OP_SQRT        = 24u;
-        constexpr uint32_t OP_FLOOR       = 25u;
-        constexpr uint32_t OP_CEIL        = 26u;
-        constexpr uint32_t OP_FRACT       = 27u;
-        constexpr uint32_t OP_MOD         = 28u;
-        constexpr uint32_t OP_EXP         = 29u;
-        constexpr uint32_t OP_LOG         = 30u;
-        constexpr uint32_t OP_NEGATE      = 31u;
-        constexpr uint32_t OP_DOT         = 32u;
-        constexpr uint32_t OP_NORMALIZE   = 33u;
-        constexpr uint32_t OP_LENGTH      = 34u;
-        constexpr uint32_t OP_CROSS       = 35u;
-        constexpr uint32_t OP_REFLECT     = 36u;
-        constexpr uint32_t OP_REFRACT     = 37u;
-        constexpr uint32_t OP_COMBINE2    = 38u;
-        constexpr uint32_t OP_COMBINE4    = 39u;
-        constexpr uint32_t OP_WORLDPOS    = 40u;
-        constexpr uint32_t OP_WORLDNORM   = 41u;
-        constexpr uint32_t OP_VIEWDIR     = 42u;
-        constexpr uint32_t OP_TIME        = 43u;
-        constexpr uint32_t OP_VCOLOR      = 44u;
-        constexpr uint32_t OP_NORMALMAP   = 45u;
-        constexpr uint32_t OP_NOISE       = 46u; // imm = (scale, detail, roughness, distortion), texIndex selects type
-
-        auto emit = [&](uint32_t type,
-                        uint32_t a = 0, uint32_t b = 0, uint32_t c = 0,
-                        uint32_t texIndex = 0,
-                        const glm::vec4& imm = glm::vec4(0.0f)) -> uint32_t {
-            gfx::RTMaterialInstr ins{};
-            ins.type = type;
-            ins.a = a;
-            ins.b = b;
-            ins.c = c;
-            ins.texIndex = texIndex;
-            ins.imm = imm;
-            outInstrsLocal.push_back(ins);
-            return static_cast<uint32_t>(outInstrsLocal.size()); // reg = instrIndex+1 => size
-        };
-
-        auto emitConstFromValue = [&](const material::PinValue& v) -> uint32_t {
-            if (std::holds_alternative<float>(v)) {
-                return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(std::get<float>(v), 0.0f, 0.0f, 0.0f));
-            }
-            if (std::holds_alternative<glm::vec2>(v)) {
-                auto vv = std::get<glm::vec2>(v);
-                return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(vv.x, vv.y, 0.0f, 0.0f));
-            }
-            if (std::holds_alternative<glm::vec3>(v)) {
-                auto vv = std::get<glm::vec3>(v);
-                return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(vv, 1.0f));
-            }
-            if (std::holds_alternative<glm::vec4>(v)) {
-                return emit(OP_CONST, 0, 0, 0, 0, std::get<glm::vec4>(v));
-            }
-            // String / other: not constant-evaluable here
-            return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(0.0f));
-        };
-
-        auto isConnectedInput = [&](const material::MaterialNode& node, size_t inputIndex) -> bool {
-            if (inputIndex >= node.inputPins.size()) return false;
-            return graph.FindLinkByEndPin(node.inputPins[inputIndex]) != material::INVALID_LINK_ID;
-        };
-
-        // Helpers for swizzling components from a packed vec4 register.
-        auto emitSwizzle = [&](uint32_t vReg, uint32_t component) -> uint32_t {
-            return emit(OP_SWIZZLE, vReg, 0u, 0u, component);
-        };
-
-        // Cache per-pin output register
-        std::unordered_map<material::PinID, uint32_t> pinToReg;
-        std::unordered_map<material::PinID, uint8_t> state; // 0=unvisited, 1=visiting, 2=done
-
-        std::function<uint32_t(material::PinID)> compilePin;
-        compilePin = [&](material::PinID pinId) -> uint32_t {
-            if (pinId == material::INVALID_PIN_ID) return 0u;
-
-            auto itCached = pinToReg.find(pinId);
-            if (itCached != pinToReg.end()) return itCached->second;
-
-            uint8_t& st = state[pinId];
-            if (st == 1) {
-                // cycle
-                return 0u;
-            }
-            st = 1;
-
-            const material::MaterialPin* pin = graph.GetPin(pinId);
-            if (!pin) { st = 2; return 0u; }
-
-            // Input pins resolve to their connected source, or default value
-            if (pin->direction == material::PinDirection::Input) {
-                material::LinkID linkId = graph.FindLinkByEndPin(pinId);
-                if (linkId != material::INVALID_LINK_ID) {
-                    const material::MaterialLink* link = graph.GetLink(linkId);
-                    if (link) {
-                        uint32_t r = compilePin(link->startPinId);
-                        pinToReg[pinId] = r;
-                        st = 2;
-                        return r;
-                    }
-                }
-                uint32_t r = emitConstFromValue(pin->defaultValue);
-                pinToReg[pinId] = r;
-                st = 2;
-                return r;
-            }
-
-            const material::MaterialNode* node = graph.GetNode(pin->nodeId);
-            if (!node) { st = 2; return 0u; }
-
-            // Determine which output index this pin is
-            int outIdx = -1;
-            for (int i = 0; i < (int)node->outputPins.size(); ++i) {
-                if (node->outputPins[i] == pinId) { outIdx = i; break; }
-            }
-
-            uint32_t r = 0u;
-            switch (node->type) {
-                // -------------------------------------------------------------
-                // Inputs
-                // -------------------------------------------------------------
-                case material::NodeType::UV:
-                    r = emit(OP_UV);
-                    break;
-                case material::NodeType::WorldPosition:
-                    r = emit(OP_WORLDPOS);
-                    break;
-                case material::NodeType::WorldNormal:
-                    r = emit(OP_WORLDNORM);
-                    break;
-                case material::NodeType::ViewDirection:
-                    r = emit(OP_VIEWDIR);
-                    break;
-                case material::NodeType::Time:
-                    r = emit(OP_TIME);
-                    break;
-                case material::NodeType::VertexColor:
-                    // RT vertices currently don't carry color; default to white.
-                    r = emit(OP_VCOLOR);
-                    break;
-
-                case material::NodeType::ConstFloat:
-                case material::NodeType::ConstVec2:
-                case material::NodeType::ConstVec3:
-                case material::NodeType::ConstVec4:
-                    r = emitConstFromValue(node->parameter);
-                    break;
-
-                case material::NodeType::Texture2D:
-                {
-                    uint32_t uvReg = 0u;
-                    if (!node->inputPins.empty()) {
-                        // If UV is unconnected, leave uvReg = 0 -> shader defaults to mesh UV input
-                        material::LinkID linkId = graph.FindLinkByEndPin(node->inputPins[0]);
-                        if (linkId != material::INVALID_LINK_ID) {
-                            uvReg = compilePin(node->inputPins[0]);
-                        }
-                    }
-
-                    std::string path;
-                    if (std::holds_alternative<std::string>(node->parameter)) path = std::get<std::string>(node->parameter);
-
-                    bool sRGB = (node->type == material::NodeType::Texture2D);
-                    if (!path.empty()) {
-                        const auto& slots = graph.GetTextureSlots();
-                        for (const auto& slot : slots) {
-                            if (slot.path == path) { sRGB = slot.sRGB; break; }
-                        }
-                    }
-
-                    uint32_t texIndex = 0u;
-                    if (outRTTextures) {
-                        const std::string key = std::string(sRGB ? "S:" : "U:") + path;
-                        auto it = texKeyToIndex.find(key);
-                        if (it != texKeyToIndex.end()) {
-                            texIndex = it->second;
-                        } else {
-                            // Reserve index 0 for fallback; array size is 256.
-                            if (outRTTextures->size() < 256) {
-                                texIndex = static_cast<uint32_t>(outRTTextures->size());
-                                outRTTextures->push_back(gfx::RTTextureKey{ path, sRGB });
-                                texKeyToIndex[key] = texIndex;
-                            } else {
-                                texIndex = 0u;
-                            }
-                        }
-                    }
-
-                    uint32_t sampleReg = emit(OP_TEX2D, uvReg, 0u, 0u, texIndex);
-
-                    // outputs: 0=RGB, 1=R, 2=G, 3=B, 4=A (see MaterialGraph SetupNodePins)
-                    uint32_t swz = 4u;
-                    if (outIdx == 1) swz = 0u;
-                    else if (outIdx == 2) swz = 1u;
-                    else if (outIdx == 3) swz = 2u;
-                    else if (outIdx == 4) swz = 3u;
-                    r = emit(OP_SWIZZLE, sampleReg, 0u, 0u, swz);
-                    break;
-                }
-
-                case material::NodeType::NormalMap: {
-                    uint32_t uvReg = 0u;
-                    if (!node->inputPins.empty()) {
-                        material::LinkID linkId = graph.FindLinkByEndPin(node->inputPins[0]);
-                        if (linkId != material::INVALID_LINK_ID) {
-                            uvReg = compilePin(node->inputPins[0]);
-                        }
-                    }
-                    uint32_t strengthReg = (node->inputPins.size() >= 2) ? compilePin(node->inputPins[1]) : emit(OP_CONST, 0, 0, 0, 0, glm::vec4(1, 0, 0, 0));
-
-                    std::string path;
-                    if (std::holds_alternative<std::string>(node->parameter)) path = std::get<std::string>(node->parameter);
-
-                    // Normal maps are data textures by default; honor explicit slot sRGB flag if present.
-                    bool sRGB = false;
-                    if (!path.empty()) {
-                        const auto& slots = graph.GetTextureSlots();
-                        for (const auto& slot : slots) {
-                            if (slot.path == path) { sRGB = slot.sRGB; break; }
-                        }
-                    }
-
-                    uint32_t texIndex = 0u;
-                    if (outRTTextures) {
-                        const std::string key = std::string(sRGB ? "S:" : "U:") + path;
-                        auto it = texKeyToIndex.find(key);
-                        if (it != texKeyToIndex.end()) {
-                            texIndex = it->second;
-                        } else {
-                            if (outRTTextures->size() < 256) {
-                                texIndex = static_cast<uint32_t>(outRTTextures->size());
-                                outRTTextures->push_back(gfx::RTTextureKey{ path, sRGB });
-                                texKeyToIndex[key] = texIndex;
-                            } else {
-                                texIndex = 0u;
-                            }
-                        }
-                    }
-
-                    r = emit(OP_NORMALMAP, uvReg, strengthReg, 0u, texIndex);
-                    break;
-                }
-
-                // -------------------------------------------------------------
-                // Procedural
-                // -------------------------------------------------------------
-                case material::NodeType::Noise: {
-                    // Provide a useful default for Vector when unconnected: vec3(UV, 0)
-                    uint32_t vecReg = 0u;
-                    if (isConnectedInput(*node, 0)) {
-                        vecReg = compilePin(node->inputPins[0]);
-                    } else {
-                        uint32_t uv2 = emit(OP_UV);
-                        uint32_t z0 = emit(OP_CONST, 0, 0, 0, 0, glm::vec4(0, 0, 0, 0));
-                        uint32_t ux = emitSwizzle(uv2, 0u);
-                        uint32_t uy = emitSwizzle(uv2, 1u);
-                        vecReg = emit(OP_COMBINE3, ux, uy, z0);
-                    }
-
-                    // Parameters: use node.parameter defaults (pins are allowed but not currently dynamic in RT IR)
-                    glm::vec4 p = glm::vec4(5.0f, 4.0f, 0.5f, 0.0f); // scale, detail, roughness, distortion
-                    if (std::holds_alternative<glm::vec4>(node->parameter)) {
-                        p = std::get<glm::vec4>(node->parameter);
-                    }
-
-                    uint32_t noiseType = 0u; // 0=fbm,1=value,2=ridged,3=turbulence
-                    if (std::holds_alternative<std::string>(node->parameter)) {
-                        // Keep as FBM for now (parameter may be "NOISE2:..." blob)
-                        noiseType = 0u;
-                    }
-
-                    // Emit noise; pack as vec4(n, n, n, 1)
-                    uint32_t n = emit(OP_NOISE, vecReg, 0u, 0u, noiseType, p);
-
-                    // outputs: 0=Value (float), 1=Color (vec3)
-                    if (outIdx == 0) r = emitSwizzle(n, 0u);
-                    else r = emit(OP_SWIZZLE, n, 0u, 0u, 4u);
-                    break;
-                }
-
-                case material::NodeType::Add:
-                    r = emit(OP_ADD, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-
-                case material::NodeType::Subtract:
-                    r = emit(OP_SUB, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-
-                case material::NodeType::Multiply:
-                    r = emit(OP_MUL, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-
-                case material::NodeType::Divide:
-                    r = emit(OP_DIV, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-
-                case material::NodeType::Lerp:
-                    r = emit(OP_LERP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
-                    break;
-
-                case material::NodeType::Clamp:
-                    r = emit(OP_CLAMP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
-                    break;
-
-                case material::NodeType::Saturate:
-                    r = emit(OP_SATURATE, compilePin(node->inputPins[0]));
-                    break;
-
-                case material::NodeType::OneMinus:
-                    r = emit(OP_ONEMINUS, compilePin(node->inputPins[0]));
-                    break;
-
-                case material::NodeType::SeparateVec3: {
-                    uint32_t v = compilePin(node->inputPins[0]);
-                    uint32_t swz = (outIdx == 1) ? 1u : (outIdx == 2) ? 2u : 0u;
-                    r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
-                    break;
-                }
-
-                case material::NodeType::CombineVec3:
-                    r = emit(OP_COMBINE3, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
-                    break;
-
-                case material::NodeType::Fresnel:
-                    // Fresnel term from N·V (view-dependent; evaluated in shader using current hit normal + ray direction)
-                    r = emit(OP_FRESNEL, compilePin(node->inputPins[0]));
-                    break;
-
-                case material::NodeType::Power:
-                    r = emit(OP_POW, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Remap:
-                    // Expand remap to primitive ops:
-                    // t = (x - inMin) / (inMax - inMin); out = outMin + t * (outMax - outMin)
-                    {
-                        uint32_t x = compilePin(node->inputPins[0]);
-                        uint32_t inMin = compilePin(node->inputPins[1]);
-                        uint32_t inMax = compilePin(node->inputPins[2]);
-                        uint32_t outMin = compilePin(node->inputPins[3]);
-                        uint32_t outMax = compilePin(node->inputPins[4]);
-                        uint32_t denom = emit(OP_SUB, inMax, inMin);
-                        uint32_t num = emit(OP_SUB, x, inMin);
-                        uint32_t t = emit(OP_DIV, num, denom);
-                        uint32_t range = emit(OP_SUB, outMax, outMin);
-                        uint32_t scaled = emit(OP_MUL, t, range);
-                        r = emit(OP_ADD, scaled, outMin);
-                    }
-                    break;
-                case material::NodeType::Step:
-                    // step(edge, x)
-                    r = emit(OP_STEP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Smoothstep:
-                    r = emit(OP_SMOOTHSTEP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
-                    break;
-                case material::NodeType::Sin:
-                    r = emit(OP_SIN, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Cos:
-                    r = emit(OP_COS, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Abs:
-                    r = emit(OP_ABS, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Min:
-                    r = emit(OP_MIN, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Max:
-                    r = emit(OP_MAX, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Sqrt:
-                    r = emit(OP_SQRT, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Floor:
-                    r = emit(OP_FLOOR, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Ceil:
-                    r = emit(OP_CEIL, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Fract:
-                    r = emit(OP_FRACT, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Mod:
-                    r = emit(OP_MOD, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Exp:
-                    r = emit(OP_EXP, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Log:
-                    r = emit(OP_LOG, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Negate:
-                    r = emit(OP_NEGATE, compilePin(node->inputPins[0]));
-                    break;
-
-                case material::NodeType::Dot:
-                    r = emit(OP_DOT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Normalize:
-                    r = emit(OP_NORMALIZE, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Length:
-                    r = emit(OP_LENGTH, compilePin(node->inputPins[0]));
-                    break;
-                case material::NodeType::Cross:
-                    r = emit(OP_CROSS, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Reflect:
-                    r = emit(OP_REFLECT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::Refract:
-                    r = emit(OP_REFRACT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
-                    break;
-
-                case material::NodeType::SeparateVec4: {
-                    uint32_t v = compilePin(node->inputPins[0]);
-                    uint32_t swz = (outIdx == 3) ? 3u : (outIdx == 2) ? 2u : (outIdx == 1) ? 1u : 0u;
-                    r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
-                    break;
-                }
-                case material::NodeType::SeparateVec2: {
-                    uint32_t v = compilePin(node->inputPins[0]);
-                    uint32_t swz = (outIdx == 1) ? 1u : 0u;
-                    r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
-                    break;
-                }
-                case material::NodeType::CombineVec2:
-                    r = emit(OP_COMBINE2, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
-                    break;
-                case material::NodeType::CombineVec4:
-                    {
-                        uint32_t rr = compilePin(node->inputPins[0]);
-                        uint32_t gg = compilePin(node->inputPins[1]);
-                        uint32_t bb = compilePin(node->inputPins[2]);
-                        uint32_t aa = compilePin(node->inputPins[3]);
-                        // OP_COMBINE4 takes rgb operands in (a,b,c) and stores alpha operand register in texIndex.
-                        r = emit(OP_COMBINE4, rr, gg, bb, aa);
-                    }
-                    break;
-
-                case material::NodeType::FloatToVec3: {
-                    uint32_t f = compilePin(node->inputPins[0]);
-                    r = emit(OP_COMBINE3, f, f, f);
-                    break;
-                }
-
-                case material::NodeType::Vec3ToFloat: {
-                    uint32_t v = compilePin(node->inputPins[0]);
-                    r = emit(OP_SWIZZLE, v, 0u, 0u, 0u);
-                    break;
-                }
-
-                case material::NodeType::Vec4ToVec3: {
-                    uint32_t v = compilePin(node->inputPins[0]);
-                    r = emit(OP_SWIZZLE, v, 0u, 0u, 4u);
-                    break;
-                }
-
-                case material::NodeType::Vec2ToVec3: {
-                    uint32_t v2 = compilePin(node->inputPins[0]);
-                    uint32_t z = compilePin(node->inputPins[1]);
-                    uint32_t x = emitSwizzle(v2, 0u);
-                    uint32_t y = emitSwizzle(v2, 1u);
-                    r = emit(OP_COMBINE3, x, y, z);
-                    break;
-                }
-
-                case material::NodeType::Vec3ToVec4: {
-                    uint32_t v3 = compilePin(node->inputPins[0]);
-                    uint32_t a = compilePin(node->inputPins[1]);
-                    // Reuse COMBINE4 by swizzling xyz.
-                    uint32_t x = emitSwizzle(v3, 0u);
-                    uint32_t y = emitSwizzle(v3, 1u);
-                    uint32_t z = emitSwizzle(v3, 2u);
-                    r = emit(OP_COMBINE4, x, y, z, a);
-                    break;
-                }
-
-                case material::NodeType::ColorRamp: {
-                    // Compile a piecewise-linear color ramp into basic ops.
-                    // NOTE: Graph stores stops in node.parameter string: "RAMP:t,r,g,b;...".
-                    // We output vec4(color.rgb, alpha=1).
-                    uint32_t tReg = compilePin(node->inputPins[0]);
-
-                    // Parse stops
-                    std::vector<std::pair<float, glm::vec3>> stops;
-                    if (std::holds_alternative<std::string>(node->parameter)) {
-                        const std::string blob = std::get<std::string>(node->parameter);
-                        const std::string prefix = "RAMP:";
-                        size_t start = (blob.rfind(prefix, 0) == 0) ? prefix.size() : 0;
-                        while (start < blob.size()) {
-                            size_t end = blob.find(';', start);
-                            std::string token = blob.substr(start, end == std::string::npos ? std::string::npos : (end - start));
-                            if (!token.empty()) {
-                                float tt = 0, rr = 1, gg = 1, bb = 1;
-                                if (sscanf_s(token.c_str(), "%f,%f,%f,%f", &tt, &rr, &gg, &bb) == 4) {
-                                    stops.push_back({ tt, glm::vec3(rr, gg, bb) });
-                                }
-                            }
-                            if (end == std::string::npos) break;
-                            start = end + 1;
-                        }
-                    }
-                    if (stops.empty()) {
-                        stops.push_back({ 0.0f, glm::vec3(0.0f) });
-                        stops.push_back({ 1.0f, glm::vec3(1.0f) });
-                    }
-                    std::sort(stops.begin(), stops.end(), [](auto& a, auto& b) { return a.first < b.first; });
-                    // Limit stop count to keep instruction counts bounded
-                    if (stops.size() > 8) {
-                        std::vector<std::pair<float, glm::vec3>> reduced;
-                        reduced.reserve(8);
-                        for (size_t i = 0; i < 8; ++i) {
-                            size_t idx = (i * (stops.size() - 1)) / 7;
-                            reduced.push_back(stops[idx]);
-                        }
-                        stops = std::move(reduced);
-                    }
-
-                    auto constFloat = [&](float v) { return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(v, 0, 0, 0)); };
-                    auto constVec3 = [&](glm::vec3 v) { return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(v, 1)); };
-                    auto constOne = [&]() { return constFloat(1.0f); };
-                    auto constZero = [&]() { return constFloat(0.0f); };
-
-                    // colorAccum = 0
-                    uint32_t colorAccum = constVec3(glm::vec3(0.0f));
-
-                    // Below first stop: maskBelow = 1 - step(t0, t)
-                    const float t0f = stops.front().first;
-                    const glm::vec3 c0 = stops.front().second;
-                    uint32_t t0 = constFloat(t0f);
-                    uint32_t maskBelow = emit(OP_ONEMINUS, emit(OP_STEP, t0, tReg));
-                    colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, constVec3(c0), maskBelow));
-
-                    // Segments
-                    for (size_t i = 0; i + 1 < stops.size(); ++i) {
-                        float ta = stops[i].first;
-                        float tb = stops[i + 1].first;
-                        glm::vec3 ca = stops[i].second;
-                        glm::vec3 cb = stops[i + 1].second;
-
-                        uint32_t taR = constFloat(ta);
-                        uint32_t tbR = constFloat(tb);
-
-                        // segMask = step(ta, t) * (1 - step(tb, t))
-                        uint32_t inA = emit(OP_STEP, taR, tReg);
-                        uint32_t inB = emit(OP_ONEMINUS, emit(OP_STEP, tbR, tReg));
-                        uint32_t segMask = emit(OP_MUL, inA, inB);
-
-                        // u = clamp((t - ta) / (tb - ta), 0..1)
-                        uint32_t denom = emit(OP_SUB, tbR, taR);
-                        uint32_t num = emit(OP_SUB, tReg, taR);
-                        uint32_t u = emit(OP_DIV, num, denom);
-                        u = emit(OP_CLAMP, u, constZero(), constOne());
-
-                        uint32_t caR = constVec3(ca);
-                        uint32_t cbR = constVec3(cb);
-                        uint32_t segColor = emit(OP_LERP, caR, cbR, u);
-
-                        colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, segColor, segMask));
-                    }
-
-                    // Above last stop: maskAbove = step(tLast, t)
-                    const float tLf = stops.back().first;
-                    const glm::vec3 cL = stops.back().second;
-                    uint32_t tL = constFloat(tLf);
-                    uint32_t maskAbove = emit(OP_STEP, tL, tReg);
-                    colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, constVec3(cL), maskAbove));
-
-                    // Pack output as vec4(rgb, 1)
-                    r = emit(OP_SWIZZLE, colorAccum, 0u, 0u, 4u);
-                    break;
-                }
-
-                case material::NodeType::Reroute:
-                    r = compilePin(node->inputPins[0]);
-                    break;
-
-                default:
-                    // Unsupported for RT per-hit evaluation
-                    outErr = std::string("Unsupported node for RT per-hit eval: ") + material::GetNodeTypeName(node->type);
-                    r = emit(1u, 0, 0, 0, 0, glm::vec4(0.0f));
-                    break;
-            }
+    // Texture slots shared by every material's RT program (material::CompileRTMaterialProgram)
+    auto rtTextureSlot = [&](const std::string& path, bool sRGB) -> uint32_t {
+        const std::string key = std::string(sRGB ? "S:" : "U:") + path;
+        auto it = texKeyToIndex.find(key);
+        if (it != texKeyToIndex.end()) return it->second;
+        // Reserve index 0 for fallback; array size is 256.
+        if (outRTTextures->size() >= 256) return 0u;
+        const uint32_t texIndex = static_cast<uint32_t>(outRTTextures->size());
+        outRTTextures->push_back(gfx::RTTextureKey{ path, sRGB });
+        texKeyToIndex[key] = texIndex;
+        return texIndex;
+    };
 
-            pinToReg[pinId] = r;
-            st = 2;
-            return r;
+    // Instances share materials: each asset graph is evaluated and compiled once per build, and
+    // entities that fall back to component values share one material per distinct set of them.
+    const auto gatherStart = std::chrono::steady_clock::now();
+    material::TracerMaterialTable::RTCompileFunction compileRT;
+    if (outRTTextures) {
+        compileRT = [&](const material::MaterialGraph& graph, gfx::RTMaterialHeader& header,
+                        std::pmr::vector<gfx::RTMaterialInstr>& instrs, std::string& error) {
+            return material::CompileRTMaterialProgram(graph, header, instrs, error, rtTextureSlot);
         };
-
-        // Find PBR output pins by name (compile from inputs so defaults work)
-        material::PinID baseColorIn = material::INVALID_PIN_ID;
-        material::PinID metallicIn = material::INVALID_PIN_ID;
-        material::PinID roughnessIn = material::INVALID_PIN_ID;
-        material::PinID emissiveIn = material::INVALID_PIN_ID;
-        material::PinID normalIn = material::INVALID_PIN_ID;
-        material::PinID alphaIn = material::INVALID_PIN_ID;
-
-        for (material::PinID pid : outNode->inputPins) {
-            const material::MaterialPin* p = graph.GetPin(pid);
-            if (!p) continue;
-            if (p->name == "Base Color") baseColorIn = pid;
-            else if (p->name == "Metallic") metallicIn = pid;
-            else if (p->name == "Roughness") roughnessIn = pid;
-            else if (p->name == "Emissive") emissiveIn = pid;
-            else if (p->name == "Normal") normalIn = pid;
-            else if (p->name == "Alpha") alphaIn = pid;
-        }
-
-        outHdr.baseColorReg = compilePin(baseColorIn);
-        outHdr.metallicReg = compilePin(metallicIn);
-        outHdr.roughnessReg = compilePin(roughnessIn);
-        outHdr.emissiveReg = compilePin(emissiveIn);
-        // Important: if Normal is unconnected, keep geometry normal (normalReg = 0).
-        if (normalIn != material::INVALID_PIN_ID && graph.FindLinkByEndPin(normalIn) != material::INVALID_LINK_ID) {
-            outHdr.normalReg = compilePin(normalIn);
-        } else {
-            outHdr.normalReg = 0u;
-        }
-        // Alpha currently not used by tracer shading, but we can still evaluate it for future use.
-        if (alphaIn != material::INVALID_PIN_ID && graph.FindLinkByEndPin(alphaIn) != material::INVALID_LINK_ID) {
-            outHdr.alphaReg = compilePin(alphaIn);
-        } else {
-            outHdr.alphaReg = 0u;
-        }
-
-        // Clamp instruction count to shader interpreter limit
-        if (outInstrsLocal.size() > 128) {
-            outErr = "Material graph too complex for RT interpreter (instr limit)";
-            return false;
-        }
-
-        outHdr.instrCount = static_cast<uint32_t>(outInstrsLocal.size());
-        return true;
-    };
+    }
+    material::TracerMaterialTable materialTable(materials, outRTHeaders, outRTInstrs, std::move(compileRT));
 
     auto view = m_Scene.GetView<scene::MeshRendererComponent, scene::TransformComponent>();
     view.Each([&](scene::Entity entity, scene::MeshRendererComponent& renderer, scene::TransformComponent& transform) {
@@ -2122,18 +1694,22 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
 
         if (!renderer.visible) return;
 
+        // Per-entity temporaries live in scratch memory and are released when the entity is done.
+        ScratchScope scratch;
+
         // Prefer editable mesh topology when present (Edit Mode / converted primitives).
         // Tracers operate on triangles, so we triangulate ngons here.
-        std::vector<assets::Vertex> tempVertices;
-        std::vector<uint32_t> tempIndices;
-        const std::vector<assets::Vertex>* verticesPtr = nullptr;
-        const std::vector<uint32_t>* indicesPtr = nullptr;
+        std::pmr::vector<assets::Vertex> tempVertices(scratch.Resource());
+        std::pmr::vector<uint32_t> tempIndices(scratch.Resource());
+        std::span<const assets::Vertex> vertices;
+        std::span<const uint32_t> indices;
 
         if (auto* editMesh = entity.GetComponent<scene::EditableMeshComponent>(); editMesh && editMesh->HasMesh()) {
-            auto triOut = editMesh->mesh->ToTriangles();
-            if (!triOut.vertices.empty() && !triOut.indices.empty()) {
-                tempVertices.reserve(triOut.vertices.size());
-                for (const auto& v : triOut.vertices) {
+            std::pmr::vector<mesh::TriangleOutput::Vertex> triVertices(scratch.Resource());
+            editMesh->mesh->AppendTriangles(triVertices, tempIndices);
+            if (!triVertices.empty() && !tempIndices.empty()) {
+                tempVertices.reserve(triVertices.size());
+                for (const auto& v : triVertices) {
                     assets::Vertex av{};
                     av.position = v.position;
                     av.normal = v.normal;
@@ -2141,32 +1717,28 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
                     av.tangent = v.tangent;
                     tempVertices.push_back(av);
                 }
-                tempIndices = std::move(triOut.indices);
-                verticesPtr = &tempVertices;
-                indicesPtr = &tempIndices;
+                vertices = tempVertices;
+                indices = tempIndices;
             }
         }
 
         assets::Mesh* mesh = nullptr;
-        if (!verticesPtr || !indicesPtr) {
+        if (vertices.empty() || indices.empty()) {
             if (renderer.primitiveType != scene::MeshRendererComponent::PrimitiveType::None) {
                 auto it = m_PrimitiveMeshes.find(renderer.primitiveType);
                 if (it == m_PrimitiveMeshes.end() || !it->second) return;
                 mesh = it->second.get();
-            } else if (renderer.meshAssetID != UINT32_MAX) {
-                mesh = lucent::assets::MeshRegistry::Get().GetMesh(renderer.meshAssetID);
+            } else if (renderer.meshAsset.IsValid()) {
+                mesh = renderer.meshAsset.Get();
                 if (!mesh) return;
             } else {
                 return;
             }
 
-            verticesPtr = &mesh->GetCPUVertices();
-            indicesPtr = &mesh->GetCPUIndices();
+            vertices = mesh->GetCPUVertices();
+            indices = mesh->GetCPUIndices();
         }
 
-        const auto& vertices = *verticesPtr;
-        const auto& indices = *indicesPtr;
-
         if (vertices.empty() || indices.empty()) return;
 
         glm::mat4 modelMatrix = transform.GetLocalMatrix();
@@ -2177,9 +1749,12 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
         if (renderer.UsesMaterialAsset()) {
             matAsset = material::MaterialAssetManager::Get().GetMaterial(renderer.materialPath);
         }
+        // The graph is loaded with the asset, before its shader compiles; only a failed compile
+        // (an unusable graph) falls back to the component values
+        const bool useGraph = matAsset && (matAsset->IsValid() || matAsset->IsRecompileInProgress());
 
         // If this mesh uses a volume material, add a volume instance and SKIP surface triangles
-        if (matAsset && matAsset->IsValid() && matAsset->IsVolumeMaterial()) {
+        if (useGraph && matAsset->IsVolumeMaterial()) {
             gfx::GPUVolume vol{};
             vol.transform = glm::inverse(modelMatrix);
 
@@ -2476,75 +2051,15 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
             return; // IMPORTANT: don't also add surface triangles/material for volume containers
         }
 
-        // Add material for this mesh
-        uint32_t matId = static_cast<uint32_t>(materials.size());
-        gfx::GPUMaterial mat{};
-
-        // Traced material pipeline:
-        // If the entity uses a MaterialAsset, evaluate constant channels for the tracer backends (V1).
-        if (matAsset && matAsset->IsValid()) {
-            material::TracerMaterialConstants baked{};
-            std::string bakeErr;
-            if (material::EvaluateTracerConstants(matAsset->GetGraph(), baked, bakeErr)) {
-                mat.baseColor = baked.baseColor;
-                mat.emissive = baked.emissive;
-                mat.metallic = baked.metallic;
-                mat.roughness = baked.roughness;
-                mat.ior = baked.ior;
-                mat.flags = baked.flags;
-            } else {
-                // If evaluation fails (unsupported nodes), fallback to IR constant evaluation,
-                // then to component values.
-                material::MaterialIR ir{};
-                std::string irErr;
-                if (material::MaterialIRCompiler::Compile(matAsset->GetGraph(), ir, irErr) && ir.IsValid()) {
-                    auto data = ir.EvaluateConstant();
-                    mat.baseColor = data.baseColor;
-                    mat.emissive = data.emissive;
-                    mat.metallic = data.metallic;
-                    mat.roughness = data.roughness;
-                    mat.ior = data.ior;
-                    mat.flags = data.flags;
-                } else {
-                    mat.baseColor = glm::vec4(renderer.baseColor, 1.0f);
-                    mat.emissive = glm::vec4(renderer.emissive, renderer.emissiveIntensity);
-                    mat.metallic = renderer.metallic;
-                    mat.roughness = renderer.roughness;
-                    mat.ior = 1.5f;
-                    mat.flags = 0;
-                }
-            }
-        } else {
-            // No material asset: use component values
-            mat.baseColor = glm::vec4(renderer.baseColor, 1.0f);
-            mat.emissive = glm::vec4(renderer.emissive, renderer.emissiveIntensity);
-            mat.metallic = renderer.metallic;
-            mat.roughness = renderer.roughness;
-            mat.ior = 1.5f;
-            mat.flags = 0;
-        }
-
-        materials.push_back(mat);
-
-        // Optional RT per-hit material evaluation (UV-driven)
-        if (outRTHeaders) {
-            gfx::RTMaterialHeader hdr{};
-
-            if (outRTInstrs && outRTTextures && matAsset && matAsset->IsValid() && !matAsset->IsVolumeMaterial()) {
-                std::vector<gfx::RTMaterialInstr> localInstrs;
-                std::string irErr;
-                if (compileGraphToRTIR(matAsset->GetGraph(), hdr, localInstrs, irErr) && hdr.instrCount > 0) {
-                    hdr.instrOffset = static_cast<uint32_t>(outRTInstrs->size());
-                    outRTInstrs->insert(outRTInstrs->end(), localInstrs.begin(), localInstrs.end());
-                } else {
-                    // Leave hdr empty; constants buffer will be used
-                    (void)irErr;
-                    hdr = gfx::RTMaterialHeader{};
-                }
-            }
-
-            outRTHeaders->push_back(hdr);
-        }
+        gfx::GPUMaterial componentMat{};
+        componentMat.baseColor = glm::vec4(renderer.baseColor, 1.0f);
+        componentMat.emissive = glm::vec4(renderer.emissive, renderer.emissiveIntensity);
+        componentMat.metallic = renderer.metallic;
+        componentMat.roughness = renderer.roughness;
+        componentMat.ior = 1.5f;
+        componentMat.flags = 0;
+        const uint32_t matId = materialTable.Add(matAsset, useGraph ? &matAsset->GetGraph() : nullptr, componentMat,
+                                                 useGraph ? std::string_view(matAsset->GetFilePath()) : std::string_view());
 
         // Add triangles using the Vertex struct
         for (size_t i = 0; i + 2 < indices.size(); i += 3) {
@@ -2573,9 +2088,25 @@ void Application::BuildTracerSceneData(std::vector<gfx::BVHBuilder::Triangle>& t
             triangles.push_back(tri);
         }
     });
+
+    const material::TracerMaterialStats materialStats = materialTable.GetStats();
+    const double gatherMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - gatherStart).count();
+    LUCENT_CORE_DEBUG("Tracer scene: {} mesh instances share {} materials, {:.1f} KB material data ({:.1f} KB unshared), "
+                      "gathered in {:.2f} ms",
+                      materialStats.instances, materials.size() - 1, materialStats.sharedBytes / 1024.0,
+                      materialStats.unsharedBytes / 1024.0, gatherMs);
+    if (const gfx::RTMaterialLinker* rtLinker = materialTable.GetRTLinker()) {
+        LUCENT_CORE_DEBUG("Tracer RT materials: {} programs ({} shared), {} instructions ({:.1f} KB), peak {} / {} registers",
+                          rtLinker->GetMaterialCount(), rtLinker->GetSharedCount(), outRTInstrs->size(),
+                          outRTInstrs->size() * sizeof(gfx::RTMaterialInstr) / 1024.0, rtLinker->GetPeakRegisters(),
+                          gfx::RT_MATERIAL_MAX_REGS);
+    }
 }
 
 void Application::UpdateTracerScene() {
+    LUCENT_PROFILE_FUNCTION();
+
     // Build scene data for the tracer
     std::vector<gfx::BVHBuilder::Triangle> triangles;
     std::vector<gfx::GPUMaterial> materials;
@@ -2601,6 +2132,9 @@ void Application::UpdateTracerScene() {
         }
     }
 
+    LUCENT_PROFILE_COUNTER("Tracer triangles", triangles.size());
+    LUCENT_PROFILE_COUNTER("Tracer materials", materials.size());
+
     m_LastTracerLights = lights;
     m_TracerSceneDirty = false;
 }
@@ -2890,10 +2424,19 @@ void Application::UpdateEnvironmentMapFromSettings() {
         desiredHandle = m_DefaultEnvMapHandle;
     }
 
-    auto* envMap = gfx::EnvironmentMapLibrary::Get().Get(desiredHandle);
-    if (!envMap && m_DefaultEnvMapHandle != gfx::EnvironmentMapLibrary::InvalidHandle) {
+    // Keep rendering with the current environment until the requested one has been uploaded
+    auto& library = gfx::EnvironmentMapLibrary::Get();
+    if (library.IsPending(desiredHandle)) {
+        return;
+    }
+
+    auto* envMap = library.Get(desiredHandle);
+    if ((!envMap || !envMap->IsLoaded()) && m_DefaultEnvMapHandle != gfx::EnvironmentMapLibrary::InvalidHandle) {
+        // Failed to load: fall back to the default sky and stop asking for the broken one
         desiredHandle = m_DefaultEnvMapHandle;
-        envMap = gfx::EnvironmentMapLibrary::Get().Get(desiredHandle);
+        envMap = library.Get(desiredHandle);
+        settings.envMapHandle = desiredHandle;
+        settings.envMapPath.clear();
     }
 
     if (!envMap) {
@@ -2901,6 +2444,8 @@ void Application::UpdateEnvironmentMapFromSettings() {
     }
 
     ApplyEnvironmentMapHandle(desiredHandle);
+    // Samples accumulated while the new environment was loading used the old one
+    settings.MarkDirty();
 }
 
 void Application::InitEnvironmentMap() {
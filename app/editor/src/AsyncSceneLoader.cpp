@@ -0,0 +1,219 @@
+#include "AsyncSceneLoader.h"
+#include "lucent/scene/Components.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <utility>
+
+namespace lucent {
+
+struct AsyncSceneLoader::SharedState {
+    SceneIO::SceneDescription description;
+    SceneIO::SceneParseProgress parse;  // Its cancel flag also stops queued mesh builds
+    std::string error;
+    bool parseSucceeded = false;        // Published by parseDone
+    std::atomic<bool> parseDone{ false };
+
+    // Face corners built so far, against a total fixed before the builds are scheduled
+    std::atomic<uint64_t> cornersBuilt{ 0 };
+    uint64_t cornersTotal = 0;
+
+    // Mesh indices, largest first; each build job claims the next one, whichever order they run in
+    std::vector<uint32_t> buildOrder;
+    std::atomic<uint32_t> nextBuild{ 0 };
+
+    std::mutex resultsMutex;
+    std::vector<std::pair<uint32_t, std::unique_ptr<mesh::EditableMesh>>> results;
+
+    // Main thread only: owning description entity and created entity per mesh index
+    std::vector<uint32_t> meshOwners;
+    std::vector<scene::EntityID> entityIDs;
+};
+
+AsyncSceneLoader::~AsyncSceneLoader() {
+    // The scene may already be gone; only stop the jobs
+    m_PreviousScene.reset();
+    Cancel();
+}
+
+void AsyncSceneLoader::Start(scene::Scene* scene, const std::string& filepath) {
+    Cancel();
+
+    m_Scene = scene;
+    m_Path = filepath;
+    m_Error.clear();
+    m_State = std::make_shared<SharedState>();
+    m_Phase = Phase::Parsing;
+
+    JobSystem::Get().Schedule([state = m_State, filepath]() {
+        LUCENT_PROFILE_ZONE("AsyncSceneLoader::Parse");
+        state->parseSucceeded = SceneIO::ParseScene(filepath, state->description, state->error, &state->parse);
+        state->parseDone.store(true, std::memory_order_release);
+    });
+}
+
+bool AsyncSceneLoader::Cancel() {
+    if (m_Phase == Phase::Idle) return false;
+
+    // Running jobs finish on their own copy of the state; their results are simply dropped
+    m_State->parse.cancelled.store(true, std::memory_order_relaxed);
+    m_CancelledState = m_State;
+    m_CancelledPath = m_Path;
+    m_State.reset();
+    m_PendingMeshes.clear();
+    m_Phase = Phase::Idle;
+
+    const bool restored = m_PreviousScene != nullptr;
+    if (restored) {
+        m_Scene->Swap(*m_PreviousScene);
+        m_PreviousScene.reset();
+    }
+    LUCENT_CORE_INFO("Scene load cancelled: {}{}", m_Path, restored ? " (previous scene restored)" : "");
+    return restored;
+}
+
+bool AsyncSceneLoader::IsReadingFile(const std::string& filepath) const {
+    auto samePath = [&](const std::string& other) {
+        std::error_code ec;
+        return std::filesystem::equivalent(filepath, other, ec) || filepath == other;
+    };
+    if (IsLoading() && samePath(m_Path)) return true;
+    return !m_CancelledState.expired() && samePath(m_CancelledPath);
+}
+
+AsyncSceneLoader::Event AsyncSceneLoader::Update() {
+    if (m_Phase == Phase::Idle) return Event::None;
+    LUCENT_PROFILE_FUNCTION();
+
+    if (m_Phase == Phase::Parsing) {
+        if (!m_State->parseDone.load(std::memory_order_acquire)) {
+            return Event::None;
+        }
+
+        if (!m_State->parseSucceeded) {
+            m_Error = m_State->error;
+            m_State.reset();
+            m_Phase = Phase::Idle;
+            LUCENT_CORE_ERROR("Failed to load scene {}: {}", m_Path, m_Error);
+            return Event::Failed;
+        }
+
+        const SceneIO::SceneDescription& desc = m_State->description;
+        m_PreviousScene = std::make_unique<scene::Scene>();
+        m_PreviousScene->Swap(*m_Scene);
+        m_State->entityIDs = SceneIO::InstantiateScene(m_Scene, desc);
+
+        m_State->meshOwners.assign(desc.meshes.size(), 0);
+        m_PendingMeshes.clear();
+        m_PendingMeshes.reserve(desc.meshes.size());
+        for (uint32_t i = 0; i < desc.entities.size(); ++i) {
+            const uint32_t meshIndex = desc.entities[i].mesh;
+            if (meshIndex == SceneBinary::kInvalidIndex) continue;
+
+            const SceneBinary::MeshView& view = desc.meshes[meshIndex].view;
+            m_State->meshOwners[meshIndex] = i;
+            m_PendingMeshes.push_back({ m_State->entityIDs[i], meshIndex, view.boundsMin, view.boundsMax });
+        }
+
+        LUCENT_CORE_INFO("Scene entities created from {} ({} entities, {} meshes pending)",
+            m_Path, desc.entities.size(), m_PendingMeshes.size());
+
+        ScheduleMeshBuilds();
+        m_Phase = Phase::BuildingMeshes;
+        return Event::SceneReplaced;
+    }
+
+    std::vector<std::pair<uint32_t, std::unique_ptr<mesh::EditableMesh>>> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_State->resultsMutex);
+        finished.swap(m_State->results);
+    }
+
+    if (!finished.empty()) {
+        const SceneIO::SceneDescription& desc = m_State->description;
+        std::vector<bool> attached(desc.meshes.size(), false);
+
+        for (auto& [meshIndex, built] : finished) {
+            attached[meshIndex] = true;
+            const uint32_t owner = m_State->meshOwners[meshIndex];
+
+            // The entity may have been deleted, or given a mesh by the user, while this one was building
+            scene::Entity entity = m_Scene->GetEntity(m_State->entityIDs[owner]);
+            if (!entity.IsValid()) continue;
+            const auto* existing = entity.GetComponent<scene::EditableMeshComponent>();
+            if (existing && existing->HasMesh()) continue;
+
+            SceneIO::AttachMesh(entity, desc.entities[owner], std::move(*built));
+        }
+
+        std::erase_if(m_PendingMeshes, [&attached](const PendingMesh& pending) {
+            return attached[pending.meshIndex];
+        });
+    }
+
+    if (m_PendingMeshes.empty()) {
+        m_State.reset();
+        m_PreviousScene.reset();
+        m_Phase = Phase::Idle;
+        LUCENT_CORE_INFO("Scene loaded from: {}", m_Path);
+        return Event::Completed;
+    }
+
+    return finished.empty() ? Event::None : Event::MeshesAttached;
+}
+
+float AsyncSceneLoader::GetProgress() const {
+    switch (m_Phase) {
+        case Phase::Parsing:
+            return m_State->parse.fraction.load(std::memory_order_relaxed);
+        case Phase::BuildingMeshes:
+            return m_State->cornersTotal > 0
+                ? static_cast<float>(m_State->cornersBuilt.load(std::memory_order_relaxed)) /
+                  static_cast<float>(m_State->cornersTotal)
+                : 1.0f;
+        case Phase::Idle:
+            break;
+    }
+    return 0.0f;
+}
+
+const char* AsyncSceneLoader::GetStatus() const {
+    return m_Phase == Phase::Parsing ? "Parsing" : "Building meshes";
+}
+
+void AsyncSceneLoader::ScheduleMeshBuilds() {
+    const SceneIO::SceneDescription& desc = m_State->description;
+
+    // Largest first: the big meshes bound the total time. The scheduler is work-stealing, so jobs
+    // do not start in the order they were scheduled; each one takes the largest mesh left instead.
+    std::vector<uint32_t>& order = m_State->buildOrder;
+    order.reserve(m_PendingMeshes.size());
+    for (const PendingMesh& pending : m_PendingMeshes) {
+        order.push_back(pending.meshIndex);
+        m_State->cornersTotal += desc.meshes[pending.meshIndex].view.faceIndices.size();
+    }
+    std::stable_sort(order.begin(), order.end(), [&desc](uint32_t a, uint32_t b) {
+        return desc.meshes[a].view.faceIndices.size() > desc.meshes[b].view.faceIndices.size();
+    });
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        JobSystem::Get().Schedule([state = m_State]() {
+            if (state->parse.cancelled.load(std::memory_order_relaxed)) return;
+
+            const uint32_t meshIndex = state->buildOrder[state->nextBuild.fetch_add(1, std::memory_order_relaxed)];
+            const SceneIO::SceneDescription::Mesh& source = state->description.meshes[meshIndex];
+            auto built = std::make_unique<mesh::EditableMesh>(SceneIO::BuildMesh(source));
+            state->cornersBuilt.fetch_add(source.view.faceIndices.size(), std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(state->resultsMutex);
+            state->results.emplace_back(meshIndex, std::move(built));
+        });
+    }
+}
+
+} // namespace lucent
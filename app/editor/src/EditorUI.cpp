@@ -4,13 +4,17 @@
 #include "EditorSettings.h"
 #include "UndoStack.h"
 #include "EditorIcons.h"
+#include "lucent/core/Arena.h"
+#include "lucent/core/Profiler.h"
 #include "lucent/gfx/VulkanContext.h"
 #include "lucent/gfx/Device.h"
 #include "lucent/gfx/Renderer.h"
 #include "lucent/gfx/EnvironmentMapLibrary.h"
+#include "lucent/gfx/TextureCache.h"
 #include "lucent/assets/MeshRegistry.h"
 #include "lucent/scene/Components.h"
 #include "lucent/material/MaterialAsset.h"
+#include "lucent/material/ShaderCache.h"
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -34,6 +38,7 @@
 #include <filesystem>
 #include <algorithm>
 #include <cmath>
+#include <memory_resource>
 
 namespace lucent {
 
@@ -83,21 +88,21 @@ static ImVec4 ThemeMutedText() { return ImGui::GetStyle().Colors[ImGuiCol_TextDi
 
 static bool InitEditableMeshFromAsset(scene::EditableMeshComponent& editMesh,
                                       const scene::MeshRendererComponent& meshRenderer) {
-    if (meshRenderer.meshAssetID == UINT32_MAX) {
+    if (!meshRenderer.meshAsset.IsValid()) {
         LUCENT_CORE_WARN("Cannot enter Edit Mode: mesh renderer has no mesh asset");
         return false;
     }
 
-    const auto* mesh = assets::MeshRegistry::Get().GetMesh(meshRenderer.meshAssetID);
+    const auto* mesh = meshRenderer.meshAsset.Get();
     if (!mesh) {
-        LUCENT_CORE_WARN("Cannot enter Edit Mode: mesh asset {} not found", meshRenderer.meshAssetID);
+        LUCENT_CORE_WARN("Cannot enter Edit Mode: mesh asset {} not found", meshRenderer.meshAsset.GetID());
         return false;
     }
 
     const auto& vertices = mesh->GetCPUVertices();
     const auto& indices = mesh->GetCPUIndices();
     if (vertices.empty() || indices.empty()) {
-        LUCENT_CORE_WARN("Cannot enter Edit Mode: mesh asset {} has no CPU geometry", meshRenderer.meshAssetID);
+        LUCENT_CORE_WARN("Cannot enter Edit Mode: mesh asset {} has no CPU geometry", meshRenderer.meshAsset.GetID());
         return false;
     }
 
@@ -116,7 +121,7 @@ static bool InitEditableMeshFromAsset(scene::EditableMeshComponent& editMesh,
 
     editMesh.InitFromTriangles(positions, normals, uvs, indices);
     if (!editMesh.HasMesh()) {
-        LUCENT_CORE_WARN("Cannot enter Edit Mode: failed to build editable mesh from asset {}", meshRenderer.meshAssetID);
+        LUCENT_CORE_WARN("Cannot enter Edit Mode: failed to build editable mesh from asset {}", meshRenderer.meshAsset.GetID());
         return false;
     }
 
@@ -230,8 +235,12 @@ bool EditorUI::Init(GLFWwindow* window, gfx::VulkanContext* context, gfx::Device
     // Load layout if exists
     LoadLayout();
     
+    // Material thumbnails (content browser and material editor)
+    m_MaterialThumbnails.Init(device, (std::filesystem::current_path() / "Cache" / "Thumbnails").string());
+    
     // Initialize material graph panel
     m_MaterialGraphPanel.Init(device);
+    m_MaterialGraphPanel.SetThumbnails(&m_MaterialThumbnails);
     
     // Set up callback for navigating to assets from material graph
     m_MaterialGraphPanel.SetNavigateToAssetCallback([this](const std::string& path) {
@@ -292,6 +301,7 @@ void EditorUI::Shutdown() {
     
     // Shutdown material graph panel
     m_MaterialGraphPanel.Shutdown();
+    m_MaterialThumbnails.Shutdown();
     
     SaveLayout();
     
@@ -493,6 +503,8 @@ void EditorUI::BeginFrame() {
     // Handle global keyboard shortcuts
     HandleGlobalShortcuts();
     
+    UpdateSceneLoad();
+    
     DrawDockspace();
     
     if (m_ShowViewport) DrawViewportPanel();
@@ -699,17 +711,18 @@ void EditorUI::DrawDockspace() {
                             std::string path = Win32FileDialogs::SaveFile(L"Save Scene", 
                                 {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
                             if (!path.empty()) {
-                                SceneIO::SaveScene(m_Scene, path);
+                                SaveSceneTo(path);
                                 m_CurrentScenePath = path;
                             }
                         } else {
-                            SceneIO::SaveScene(m_Scene, m_CurrentScenePath);
+                            SaveSceneTo(m_CurrentScenePath);
                         }
                     } else if (result == Win32FileDialogs::MsgBoxResult::Cancel) {
                         proceed = false;
                     }
                 }
                 if (proceed && m_Scene) {
+                    m_SceneLoader.Cancel();
                     m_Scene->Clear();
                     m_Scene->SetName("New Scene");
                     // Create default camera and light
@@ -723,6 +736,7 @@ void EditorUI::DrawDockspace() {
                     
                     ClearSelection();
                     m_CurrentScenePath.clear();
+                    m_SaveSceneAsText = false;
                     m_SceneDirty = false;
                 }
             }
@@ -733,12 +747,12 @@ void EditorUI::DrawDockspace() {
                         L"Save changes before opening another scene?");
                     if (result == Win32FileDialogs::MsgBoxResult::Yes) {
                         if (!m_CurrentScenePath.empty()) {
-                            SceneIO::SaveScene(m_Scene, m_CurrentScenePath);
+                            SaveSceneTo(m_CurrentScenePath);
                         } else {
                             std::string path = Win32FileDialogs::SaveFile(L"Save Scene", 
                                 {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
                             if (!path.empty()) {
-                                SceneIO::SaveScene(m_Scene, path);
+                                SaveSceneTo(path);
                             }
                         }
                     } else if (result == Win32FileDialogs::MsgBoxResult::Cancel) {
@@ -749,40 +763,33 @@ void EditorUI::DrawDockspace() {
                     std::string path = Win32FileDialogs::OpenFile(L"Open Scene", 
                         {{L"Lucent Scene", L"*.lucent"}, {L"All Files", L"*.*"}}, L"lucent");
                     if (!path.empty() && m_Scene) {
-                        if (SceneIO::LoadScene(m_Scene, path)) {
-                            m_CurrentScenePath = path;
-                            m_SceneDirty = false;
-                            ClearSelection();
-                            ApplySceneEnvironment();
-                        } else {
-                            Win32FileDialogs::ShowError(L"Error", L"Failed to load scene file.");
-                        }
+                        OpenSceneAsync(path);
                     }
                 }
             }
             ImGui::Separator();
-            if (ImGui::MenuItem(m_IconFontLoaded ? (LUCENT_ICON_SAVE " Save Scene") : "Save Scene", "Ctrl+S")) {
+            // A scene that is still loading is incomplete; saving waits until it finishes or is cancelled
+            const bool canSave = !m_SceneLoader.IsLoading();
+            if (ImGui::MenuItem(m_IconFontLoaded ? (LUCENT_ICON_SAVE " Save Scene") : "Save Scene", "Ctrl+S", false, canSave)) {
                 if (m_Scene) {
                     if (m_CurrentScenePath.empty()) {
                         std::string path = Win32FileDialogs::SaveFile(L"Save Scene", 
                             {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
-                        if (!path.empty()) {
-                            SceneIO::SaveScene(m_Scene, path);
+                        if (!path.empty() && SaveSceneTo(path)) {
                             m_CurrentScenePath = path;
                             m_SceneDirty = false;
                         }
-                    } else {
-                        SceneIO::SaveScene(m_Scene, m_CurrentScenePath);
+                    } else if (SaveSceneTo(m_CurrentScenePath)) {
                         m_SceneDirty = false;
                     }
                 }
             }
-            if (ImGui::MenuItem(m_IconFontLoaded ? (LUCENT_ICON_SAVE " Save Scene As...") : "Save Scene As...", "Ctrl+Shift+S")) {
+            if (ImGui::MenuItem(m_IconFontLoaded ? (LUCENT_ICON_SAVE " Save Scene As...") : "Save Scene As...", "Ctrl+Shift+S",
+                                false, canSave)) {
                 if (m_Scene) {
                     std::string path = Win32FileDialogs::SaveFile(L"Save Scene As", 
                         {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
-                    if (!path.empty()) {
-                        SceneIO::SaveScene(m_Scene, path);
+                    if (!path.empty() && SaveSceneTo(path)) {
                         m_CurrentScenePath = path;
                         m_SceneDirty = false;
                     }
@@ -830,13 +837,22 @@ void EditorUI::DrawDockspace() {
                     }
                 }
             }
-            if (ImGui::BeginMenu("Export")) {
+            if (ImGui::BeginMenu("Export", canSave)) {
                 if (ImGui::MenuItem("Scene (.lucent)...")) {
                     if (m_Scene) {
                         std::string path = Win32FileDialogs::SaveFile(L"Export Scene", 
                             {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
                         if (!path.empty()) {
-                            SceneIO::SaveScene(m_Scene, path);
+                            SceneIO::SaveScene(m_Scene, path, SceneIO::SceneFormat::Binary);
+                        }
+                    }
+                }
+                if (ImGui::MenuItem("Scene as Text (.lucent)...")) {
+                    if (m_Scene) {
+                        std::string path = Win32FileDialogs::SaveFile(L"Export Scene as Text", 
+                            {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
+                        if (!path.empty()) {
+                            SceneIO::SaveScene(m_Scene, path, SceneIO::SceneFormat::Text);
                         }
                     }
                 }
@@ -850,12 +866,12 @@ void EditorUI::DrawDockspace() {
                         L"Save changes before exiting?");
                     if (result == Win32FileDialogs::MsgBoxResult::Yes) {
                         if (!m_CurrentScenePath.empty()) {
-                            SceneIO::SaveScene(m_Scene, m_CurrentScenePath);
+                            SaveSceneTo(m_CurrentScenePath);
                         } else {
                             std::string path = Win32FileDialogs::SaveFile(L"Save Scene", 
                                 {{L"Lucent Scene", L"*.lucent"}}, L"lucent");
                             if (!path.empty()) {
-                                SceneIO::SaveScene(m_Scene, path);
+                                SaveSceneTo(path);
                             }
                         }
                     } else if (result == Win32FileDialogs::MsgBoxResult::Cancel) {
@@ -1114,6 +1130,25 @@ void EditorUI::DrawDockspace() {
             if (ImGui::MenuItem("Save Layout")) {
                 SaveLayout();
             }
+#if LUCENT_ENABLE_PROFILER
+            ImGui::Separator();
+            ImGui::TextDisabled("Profiling");
+            Profiler& profiler = Profiler::Get();
+            const bool capturing = profiler.IsCapturing();
+            if (ImGui::MenuItem("Capture 120 Frames", nullptr, false, !capturing)) {
+                profiler.CaptureFrames(120, "lucent_profile.json");
+            }
+            if (ImGui::MenuItem("Record Trace", nullptr, capturing)) {
+                if (capturing) {
+                    profiler.StopCapture("lucent_profile.json");
+                } else {
+                    profiler.StartCapture();
+                }
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Writes lucent_profile.json (open in chrome://tracing or ui.perfetto.dev)");
+            }
+#endif
             ImGui::EndMenu();
         }
         
@@ -1178,6 +1213,29 @@ void EditorUI::DrawDockspace() {
         float fpsWidth = 120.0f;
         ImGui::SetCursorPosX(windowWidth - fpsWidth);
         ImGui::TextDisabled("%.1f FPS", ImGui::GetIO().Framerate);
+        if (ImGui::IsItemHovered()) {
+            const FrameArenaStats& arenaStats = FrameArena::GetStats();
+            ImGui::BeginTooltip();
+            ImGui::Text("Frame arena: %.1f KB (peak %.1f KB)",
+                arenaStats.frameBytes / 1024.0, arenaStats.peakFrameBytes / 1024.0);
+            ImGui::Text("Scratch: %.1f KB/frame", arenaStats.scratchBytes / 1024.0);
+            ImGui::Text("Arena heap blocks: %llu/frame, %.1f KB reserved",
+                static_cast<unsigned long long>(arenaStats.upstreamAllocations), arenaStats.capacity / 1024.0);
+            const gfx::TextureCacheStats texStats = gfx::TextureCache::Get().GetStats();
+            ImGui::Text("Textures: %u cached (%u in use), %.1f / %.0f MB",
+                texStats.textureCount, texStats.referencedCount,
+                texStats.residentBytes / (1024.0 * 1024.0), texStats.budgetBytes / (1024.0 * 1024.0));
+            ImGui::Text("Texture cache: %llu hits, %llu misses (%llu reloads), %llu evictions",
+                static_cast<unsigned long long>(texStats.hits), static_cast<unsigned long long>(texStats.misses),
+                static_cast<unsigned long long>(texStats.reloads), static_cast<unsigned long long>(texStats.evictions));
+            ImGui::Text("Texture streaming: %u pending, %.1f MB staging in flight",
+                texStats.streamingCount, texStats.stagingBytesInUse / (1024.0 * 1024.0));
+            const material::ShaderCacheStats shaderStats = material::ShaderCache::Get().GetStats();
+            ImGui::Text("Shader cache: %llu hits, %llu misses (%.0f%%), %.1f s saved, %.1f MB",
+                static_cast<unsigned long long>(shaderStats.hits), static_cast<unsigned long long>(shaderStats.misses),
+                shaderStats.GetHitRate() * 100.0, shaderStats.secondsSaved, shaderStats.diskBytes / (1024.0 * 1024.0));
+            ImGui::EndTooltip();
+        }
         
         ImGui::EndMenuBar();
     }
@@ -1274,6 +1332,9 @@ void EditorUI::DrawViewportPanel() {
     // Draw scene indicators (lights/cameras) as 2D overlay projected from world space
     DrawEntityIndicators();
     
+    // Placeholder bounds and progress while a scene is loading
+    DrawSceneLoadOverlay();
+    
     // Gizmo toolbar overlay
     ImGui::SetCursorPos(ImVec2(10, 30));
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(4, 4));
@@ -1599,6 +1660,113 @@ void EditorUI::DrawEntityIndicators() {
     drawList->PopClipRect();
 }
 
+// ============================================================================
+// Asynchronous Scene Loading
+// ============================================================================
+
+void EditorUI::OpenSceneAsync(const std::string& path) {
+    // The current scene stays editable until parsing finishes; UpdateSceneLoad() swaps it in
+    CancelSceneLoad();
+    m_SceneLoader.Start(m_Scene, path);
+}
+
+void EditorUI::CancelSceneLoad() {
+    // Cancelled after the swap, the loader puts the previous scene back rather than leaving one
+    // that lacks the meshes still building
+    if (!m_SceneLoader.Cancel()) return;
+    m_CurrentScenePath = m_PreviousScenePath;
+    m_SaveSceneAsText = m_PreviousSaveSceneAsText;
+    ClearSelection();
+    ApplySceneEnvironment();
+    // Different geometry again: let the tracer rebuild its scene
+    m_SceneDirty = true;
+}
+
+void EditorUI::UpdateSceneLoad() {
+    if (!m_Scene) return;
+    
+    switch (m_SceneLoader.Update()) {
+        case AsyncSceneLoader::Event::SceneReplaced: {
+            const std::string& path = m_SceneLoader.GetPath();
+            m_PreviousScenePath = m_CurrentScenePath;
+            m_PreviousSaveSceneAsText = m_SaveSceneAsText;
+            m_CurrentScenePath = path;
+            // Keep text scenes text so they stay diff-friendly
+            m_SaveSceneAsText = SceneIO::DetectSceneFormat(path) == SceneIO::SceneFormat::Text;
+            m_SceneDirty = false;
+            ClearSelection();
+            ApplySceneEnvironment();
+            break;
+        }
+        case AsyncSceneLoader::Event::MeshesAttached:
+        case AsyncSceneLoader::Event::Completed:
+            // New geometry: let the tracer rebuild its scene
+            m_SceneDirty = true;
+            break;
+        case AsyncSceneLoader::Event::Failed:
+            Win32FileDialogs::ShowError(L"Error", L"Failed to load scene file.");
+            break;
+        case AsyncSceneLoader::Event::None:
+            break;
+    }
+}
+
+void EditorUI::DrawSceneLoadOverlay() {
+    if (!m_SceneLoader.IsLoading()) return;
+    
+    if (m_Scene && m_EditorCamera && m_ViewportSize.x > 1.0f && m_ViewportSize.y > 1.0f) {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImVec2 clipMin(m_ViewportPosition.x, m_ViewportPosition.y);
+        const ImVec2 clipMax(m_ViewportPosition.x + m_ViewportSize.x, m_ViewportPosition.y + m_ViewportSize.y);
+        drawList->PushClipRect(clipMin, clipMax, true);
+        
+        const ImU32 color = MulAlpha(ImGui::GetColorU32(ThemeAccent()), 0.8f);
+        
+        // Wire box around the bounds of every mesh that is still being built
+        for (const AsyncSceneLoader::PendingMesh& pending : m_SceneLoader.GetPendingMeshes()) {
+            scene::Entity entity = m_Scene->GetEntity(pending.entity);
+            if (!entity.IsValid()) continue;
+            auto* transform = entity.GetComponent<scene::TransformComponent>();
+            const glm::mat4 model = transform ? transform->GetLocalMatrix() : glm::mat4(1.0f);
+            
+            glm::vec3 corners[8];
+            for (int i = 0; i < 8; ++i) {
+                const glm::vec3 local(
+                    (i & 1) ? pending.boundsMax.x : pending.boundsMin.x,
+                    (i & 2) ? pending.boundsMax.y : pending.boundsMin.y,
+                    (i & 4) ? pending.boundsMax.z : pending.boundsMin.z);
+                corners[i] = WorldToScreen(glm::vec3(model * glm::vec4(local, 1.0f)));
+            }
+            
+            static constexpr int kEdges[12][2] = {
+                { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+                { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+                { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+            };
+            for (const auto& edge : kEdges) {
+                const glm::vec3& a = corners[edge[0]];
+                const glm::vec3& b = corners[edge[1]];
+                if (a.z < 0.0f || b.z < 0.0f) continue; // Behind camera
+                drawList->AddLine(ImVec2(a.x, a.y), ImVec2(b.x, b.y), color, 1.5f);
+            }
+        }
+        
+        drawList->PopClipRect();
+    }
+    
+    // Progress strip along the bottom of the viewport
+    const ImVec2 savedCursor = ImGui::GetCursorPos();
+    ImGui::SetCursorPos(ImVec2(10.0f, ImGui::GetWindowHeight() - ImGui::GetFrameHeightWithSpacing() - 6.0f));
+    ImGui::TextColored(ThemeAccent(), "Loading scene: %s...", m_SceneLoader.GetStatus());
+    ImGui::SameLine();
+    ImGui::ProgressBar(m_SceneLoader.GetProgress(), ImVec2(160.0f, 0.0f));
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Cancel")) {
+        CancelSceneLoad();
+    }
+    ImGui::SetCursorPos(savedCursor);
+}
+
 void EditorUI::DrawGizmo() {
     scene::Entity selected = GetSelectedEntity();
     if (!selected.IsValid() || !m_EditorCamera || !m_Scene) {
@@ -2255,8 +2423,11 @@ void EditorUI::DrawContentBrowserPanel() {
     ImGui::PushStyleColor(ImGuiCol_ButtonHovered, WithAlpha(ThemeAccent(), 0.15f));
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, WithAlpha(ThemeAccent(), 0.25f));
     
+    // Per-frame UI temporaries come from the frame arena
+    std::pmr::memory_resource* frameMem = FrameArena::Resource();
+    
     // Build path segments
-    std::vector<std::filesystem::path> segments;
+    std::pmr::vector<std::filesystem::path> segments(frameMem);
     std::filesystem::path temp = m_ContentBrowserPath;
     while (temp != temp.root_path() && temp.has_parent_path()) {
         segments.push_back(temp);
@@ -2314,18 +2485,21 @@ void EditorUI::DrawContentBrowserPanel() {
     
     int itemIndex = 0;
     
+    // Lower-case the search once per frame rather than once per entry
+    std::pmr::string lowerSearch(m_ContentBrowserSearch.begin(), m_ContentBrowserSearch.end(), frameMem);
+    std::transform(lowerSearch.begin(), lowerSearch.end(), lowerSearch.begin(), ::tolower);
+    std::pmr::string lowerName(frameMem);
+    
     // List directory contents
     if (std::filesystem::exists(m_ContentBrowserPath)) {
         for (const auto& entry : std::filesystem::directory_iterator(m_ContentBrowserPath)) {
             std::string name = entry.path().filename().string();
             
             // Filter by search
-            if (!m_ContentBrowserSearch.empty()) {
-                std::string lowerName = name;
-                std::string lowerSearch = m_ContentBrowserSearch;
+            if (!lowerSearch.empty()) {
+                lowerName.assign(name.begin(), name.end());
                 std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-                std::transform(lowerSearch.begin(), lowerSearch.end(), lowerSearch.begin(), ::tolower);
-                if (lowerName.find(lowerSearch) == std::string::npos) {
+                if (lowerName.find(lowerSearch) == std::pmr::string::npos) {
                     continue;
                 }
             }
@@ -2357,7 +2531,7 @@ void EditorUI::DrawContentBrowserPanel() {
                 color = ThemeAccent();
                 icon = m_IconFontLoaded ? LUCENT_ICON_FILE : "SCN";
                 shortLabel = "Scene";
-            } else if (ext == ".mat") {
+            } else if (ext == ".mat" || ext == ".lmat") {
                 color = ImVec4(0.72f, 0.52f, 0.95f, 1.0f);
                 icon = m_IconFontLoaded ? LUCENT_ICON_EDIT : "MAT";
                 shortLabel = "Material";
@@ -2382,21 +2556,36 @@ void EditorUI::DrawContentBrowserPanel() {
 
             ImVec2 iconCenter(cardMin.x + cardWidth * 0.5f, cardMin.y + thumbnailSize * 0.5f + 6.0f);
             float iconRadius = thumbnailSize * 0.30f;
-            drawList->AddCircleFilled(iconCenter, iconRadius, ImGui::ColorConvertFloat4ToU32(WithAlpha(color, 0.65f)));
 
-            ImVec2 iconSize = ImGui::CalcTextSize(icon);
-            ImVec2 iconPos(iconCenter.x - iconSize.x * 0.5f, iconCenter.y - iconSize.y * 0.5f);
-            drawList->AddText(iconPos, ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.92f)), icon);
+            // Materials show their rendered thumbnail once the background render has finished
+            ImTextureID thumbnail{};
+            if (ext == ".lmat") {
+                std::error_code timeError;
+                const auto writeTime = entry.last_write_time(timeError);
+                if (!timeError) thumbnail = m_MaterialThumbnails.GetFileThumbnail(entry.path(), writeTime);
+            }
+
+            if (thumbnail) {
+                const float half = thumbnailSize * 0.42f;
+                drawList->AddImage(thumbnail, ImVec2(iconCenter.x - half, iconCenter.y - half),
+                                   ImVec2(iconCenter.x + half, iconCenter.y + half));
+            } else {
+                drawList->AddCircleFilled(iconCenter, iconRadius, ImGui::ColorConvertFloat4ToU32(WithAlpha(color, 0.65f)));
+
+                ImVec2 iconSize = ImGui::CalcTextSize(icon);
+                ImVec2 iconPos(iconCenter.x - iconSize.x * 0.5f, iconCenter.y - iconSize.y * 0.5f);
+                drawList->AddText(iconPos, ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.92f)), icon);
+            }
 
             ImVec2 labelSize = ImGui::CalcTextSize(shortLabel);
             ImVec2 labelPos(cardMin.x + (cardWidth - labelSize.x) * 0.5f, cardMin.y + thumbnailSize + 8.0f);
             drawList->AddText(labelPos, ImGui::ColorConvertFloat4ToU32(WithAlpha(ThemeMutedText(), 0.95f)), shortLabel);
 
             const char* displayName = name.c_str();
-            std::string clipped;
+            char clipped[16];
             if (name.length() > 14) {
-                clipped = name.substr(0, 12) + "...";
-                displayName = clipped.c_str();
+                snprintf(clipped, sizeof(clipped), "%.12s...", name.c_str());
+                displayName = clipped;
             }
             ImVec2 nameSize = ImGui::CalcTextSize(displayName);
             ImVec2 namePos(cardMin.x + (cardWidth - nameSize.x) * 0.5f, cardMin.y + thumbnailSize + 24.0f);
@@ -2528,7 +2717,7 @@ void EditorUI::OpenMaterialInEditor(const std::string& path) {
     
     if (material) {
         // Compile it if needed
-        if (!material->IsValid()) {
+        if (!material->IsValid() && !material->IsRecompileInProgress()) {
             material->Recompile();
         }
         
@@ -2567,7 +2756,7 @@ void EditorUI::HandleMaterialDrop(const std::string& materialPath) {
             // Load the material to make sure it's valid
             auto* material = material::MaterialAssetManager::Get().LoadMaterial(materialPath);
             if (material) {
-                if (!material->IsValid()) {
+                if (!material->IsValid() && !material->IsRecompileInProgress()) {
                     material->Recompile();
                 }
                 
@@ -2831,7 +3020,8 @@ void EditorUI::DrawRenderPropertiesPanel() {
                 std::string path = Win32FileDialogs::OpenFile(L"Open HDRI",
                     {{L"HDR Images", L"*.hdr;*.exr"}, {L"All Files", L"*.*"}});
                 if (!path.empty()) {
-                    uint32_t handle = gfx::EnvironmentMapLibrary::Get().LoadFromFile(path);
+                    // Loads in the background; the renderer switches over once it is uploaded
+                    uint32_t handle = gfx::EnvironmentMapLibrary::Get().RequestLoad(path);
                     if (handle != gfx::EnvironmentMapLibrary::InvalidHandle) {
                         settings.envMapPath = path;
                         settings.envMapHandle = handle;
@@ -2860,6 +3050,9 @@ void EditorUI::DrawRenderPropertiesPanel() {
                 ImGui::TextDisabled("Using default sky environment.");
             } else {
                 ImGui::TextWrapped("%s", settings.envMapPath.c_str());
+                if (gfx::EnvironmentMapLibrary::Get().IsPending(settings.envMapHandle)) {
+                    ImGui::TextDisabled("Loading...");
+                }
             }
         }
     }
@@ -3284,6 +3477,20 @@ bool EditorUI::RayIntersectsSphere(const glm::vec3& rayOrigin, const glm::vec3&
     return false;
 }
 
+bool EditorUI::SaveSceneTo(const std::string& path) {
+    // The loading scene is incomplete, and a binary scene file stays mapped while its meshes build
+    if (m_SceneLoader.IsLoading() || m_SceneLoader.IsReadingFile(path)) {
+        LUCENT_CORE_WARN("Not saving '{}' while a scene load is using it", path);
+        return false;
+    }
+    const auto format = m_SaveSceneAsText ? SceneIO::SceneFormat::Text : SceneIO::SceneFormat::Binary;
+    if (!SceneIO::SaveScene(m_Scene, path, format)) {
+        LUCENT_CORE_ERROR("Failed to save scene: {}", SceneIO::GetLastError());
+        return false;
+    }
+    return true;
+}
+
 void EditorUI::ApplySceneEnvironment() {
     if (!m_Renderer || !m_Scene) {
         return;
@@ -3301,7 +3508,7 @@ void EditorUI::ApplySceneEnvironment() {
         return;
     }
 
-    uint32_t handle = gfx::EnvironmentMapLibrary::Get().LoadFromFile(path);
+    uint32_t handle = gfx::EnvironmentMapLibrary::Get().RequestLoad(path);
     if (handle == gfx::EnvironmentMapLibrary::InvalidHandle) {
         LUCENT_CORE_WARN("Failed to load HDRI from scene: {}", path);
         return;
@@ -4006,7 +4213,14 @@ void EditorUI::SetEditorMode(EditorMode mode) {
         
         LUCENT_CORE_INFO("Entered Edit Mode for entity: {}", entity.GetComponent<scene::TagComponent>()->name);
     } else {
-        // Exiting Edit Mode
+        // Exiting Edit Mode: rebuild the GPU mesh once more so the committed topology gets the
+        // optimised triangle/vertex order (skipped while editing)
+        scene::Entity edited = GetEditedEntity();
+        if (edited.IsValid()) {
+            if (auto* editMesh = edited.GetComponent<scene::EditableMeshComponent>()) {
+                editMesh->MarkDirty();
+            }
+        }
         m_EditorMode = EditorMode::Object;
         m_EditedEntityID = UINT32_MAX;
         
@@ -1,16 +1,25 @@
 #include "MaterialGraphPanel.h"
+#include "MaterialThumbnails.h"
 #include "UndoStack.h"
 #include "EditorIcons.h"
 #include "lucent/material/MaterialAsset.h"
+#include "lucent/material/MaterialBaker.h"
+#include "lucent/core/Arena.h"
+#include "lucent/core/JobSystem.h"
 #include "lucent/core/Log.h"
 #include "TextEditor.h"
 #include <imgui-node-editor/imgui_node_editor.h>
 #include <imgui_impl_vulkan.h>
 #include <array>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cctype>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <memory_resource>
+#include <string_view>
 #include <imgui_internal.h>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -198,6 +207,16 @@ static std::string GetTokenPrefixForEditor(const TextEditor& editor) {
 
 } // namespace
 
+struct MaterialGraphPanel::BakeJob {
+    material::MaterialGraph graph;  // Copy: the open graph keeps changing while the job runs
+    material::MaterialBakeSettings settings;
+    material::MaterialBakeProgress progress;
+    material::MaterialBakeResult result;
+    std::string error;
+    bool succeeded = false;         // Published by done
+    std::atomic<bool> done{ false };
+};
+
 MaterialGraphPanel::~MaterialGraphPanel() {
     Shutdown();
 }
@@ -215,6 +234,12 @@ bool MaterialGraphPanel::Init(gfx::Device* device) {
 }
 
 void MaterialGraphPanel::Shutdown() {
+    // A running bake finishes on its own copy of the state; nothing is written once cancelled
+    if (m_BakeJob) {
+        m_BakeJob->progress.cancelled.store(true, std::memory_order_relaxed);
+        m_BakeJob.reset();
+    }
+    
     if (m_NodeEditorContext) {
         ed::DestroyEditor(m_NodeEditorContext);
         m_NodeEditorContext = nullptr;
@@ -247,6 +272,8 @@ void MaterialGraphPanel::Shutdown() {
 void MaterialGraphPanel::SetMaterial(material::MaterialAsset* material) {
     m_Material = material;
     m_FirstFrame = true;
+    // Edits to the open material compile ahead of everything else
+    material::MaterialAssetManager::Get().SetSelectedMaterial(material);
 }
 
 material::MaterialAsset* MaterialGraphPanel::CreateNewMaterial() {
@@ -294,9 +321,10 @@ void MaterialGraphPanel::HandleAutoCompile() {
             m_DirtySinceTime = now;
         }
         
-        // Wait a little before recompiling to avoid compiling every keystroke/drag tick
+        // Wait a little before recompiling to avoid compiling every keystroke/drag tick.
+        // Constant value edits only rewrite the parameter buffer, so those apply right away.
         const float debounceSeconds = 0.35f;
-        if ((now - m_DirtySinceTime) >= debounceSeconds) {
+        if (!m_Material->NeedsShaderRecompile() || (now - m_DirtySinceTime) >= debounceSeconds) {
             m_Material->RequestRecompileAsync();
             m_CompileAnimTimer = 1.0f;
             m_WasDirty = false;
@@ -341,10 +369,10 @@ void MaterialGraphPanel::RenderMaterialPreviewIfNeeded() {
         return;
     }
     
-    // Re-render if graph hash changed (after a successful compile)
+    // Re-render if graph or parameter hash changed (after a successful compile / parameter update)
     if (m_Material->IsValid()) {
         uint64_t h = m_Material->GetGraphHash();
-        if (h != 0 && h != m_PreviewGraphHash) {
+        if (h != 0 && (h != m_PreviewGraphHash || m_Material->GetParameterHash() != m_PreviewParameterHash)) {
             m_PreviewDirty = true;
         }
     }
@@ -361,15 +389,32 @@ void MaterialGraphPanel::RenderMaterialPreviewIfNeeded() {
         RenderMaterialPreview();
         if (m_Material->IsValid()) {
             m_PreviewGraphHash = m_Material->GetGraphHash();
+            m_PreviewParameterHash = m_Material->GetParameterHash();
         }
         m_PreviewDirty = false;
     }
     
     if (m_PreviewImGuiTex != VK_NULL_HANDLE) {
         ImGui::Image((ImTextureID)m_PreviewImGuiTex, ImVec2((float)m_PreviewSize, (float)m_PreviewSize));
-    } else {
-        ImGui::TextDisabled("Preview not ready yet.");
+        return;
+    }
+    
+    // No pipeline yet (first compile still running, or it failed): show the CPU thumbnail
+    if (m_Thumbnails) {
+        const std::string& key = m_Material->GetFilePath();
+        ImTextureID thumbnail = m_Thumbnails->GetGraphThumbnail(key, m_Material->GetGraph());
+        if (thumbnail) {
+            ImGui::Image(thumbnail, ImVec2((float)m_PreviewSize, (float)m_PreviewSize));
+            ImGui::TextDisabled("CPU preview (GPU preview not ready yet)");
+            return;
+        }
+        const std::string error = m_Thumbnails->GetError(key);
+        if (!error.empty()) {
+            ImGui::TextDisabled("No preview: %s", error.c_str());
+            return;
+        }
     }
+    ImGui::TextDisabled("Preview not ready yet.");
 }
 
 void MaterialGraphPanel::RenderMaterialPreview() {
@@ -604,6 +649,10 @@ void MaterialGraphPanel::DrawToolbar() {
             if (ImGui::MenuItem((LUCENT_ICON_SAVE " Save As..."), "Ctrl+Shift+S", false, m_Material != nullptr)) {
                 // TODO: Save file dialog
             }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Bake to Textures...", nullptr, false, m_Material && !m_Material->IsVolumeMaterial())) {
+                m_OpenBakePopup = true;
+            }
             ImGui::EndMenu();
         }
         
@@ -625,6 +674,14 @@ void MaterialGraphPanel::DrawToolbar() {
         ImGui::EndMenuBar();
     }
     
+    if (m_OpenBakePopup) {
+        ImGui::OpenPopup("Bake Material");
+        if (!m_BakeJob) m_BakeStatus.clear();
+        m_OpenBakePopup = false;
+    }
+    PollBakeJob();
+    DrawBakePopup();
+    
     // Toolbar buttons
     if (m_Material) {
         // Material name
@@ -1350,23 +1407,25 @@ void MaterialGraphPanel::DrawNode(const material::MaterialNode& node) {
             // ColorRamp (custom UI). Store stops as: "RAMP:t,r,g,b;..."
             // NOTE: We intentionally do NOT use ImGradient::Edit() from ImGuizmo because the vcpkg
             // build calls ImDrawList::AddRect() with legacy corner flag values and triggers an ImGui assert.
-            std::string blob = std::holds_alternative<std::string>(node.parameter) ? std::get<std::string>(node.parameter) : std::string();
-            if (blob.empty()) blob = "RAMP:0.0,0.0,0.0,0.0;1.0,1.0,1.0,1.0";
+            // Parsed every frame for every ramp node: read the blob in place and keep the stops in
+            // the frame arena instead of copying strings/vectors on the heap.
+            static const std::string kDefaultRamp = "RAMP:0.0,0.0,0.0,0.0;1.0,1.0,1.0,1.0";
+            const std::string* blobParam = std::get_if<std::string>(&node.parameter);
+            const std::string& blob = (blobParam && !blobParam->empty()) ? *blobParam : kDefaultRamp;
 
             struct Stop { float t; ImVec4 c; }; // rgb in xyz, w unused
-            std::vector<Stop> stops;
+            std::pmr::vector<Stop> stops(FrameArena::Resource());
             stops.reserve(8);
 
             try {
-                const std::string prefix = "RAMP:";
+                const std::string_view prefix = "RAMP:";
                 size_t start = (blob.rfind(prefix, 0) == 0) ? prefix.size() : 0;
                 while (start < blob.size()) {
                     size_t end = blob.find(';', start);
-                    std::string token = blob.substr(start, end == std::string::npos ? std::string::npos : (end - start));
-                    if (!token.empty()) {
+                    if (end != start) {
                         float t = 0, r = 1, g = 1, b = 1;
-                        // t,r,g,b
-                        const int n = sscanf_s(token.c_str(), "%f,%f,%f,%f", &t, &r, &g, &b);
+                        // t,r,g,b (sscanf stops at the ';' separator)
+                        const int n = sscanf_s(blob.c_str() + start, "%f,%f,%f,%f", &t, &r, &g, &b);
                         if (n == 4) {
                             t = std::clamp(t, 0.0f, 1.0f);
                             stops.push_back({ t, ImVec4(r, g, b, 1.0f) });
@@ -2121,6 +2180,103 @@ void MaterialGraphPanel::DrawNodeCreationMenu() {
     }
 }
 
+void MaterialGraphPanel::DrawBakePopup() {
+    if (!ImGui::BeginPopupModal("Bake Material", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) return;
+    
+    static const int kResolutions[] = { 256, 512, 1024, 2048, 4096 };
+    const std::string current = std::to_string(m_BakeResolution);
+    if (ImGui::BeginCombo("Resolution", current.c_str())) {
+        for (int resolution : kResolutions) {
+            const std::string label = std::to_string(resolution);
+            if (ImGui::Selectable(label.c_str(), resolution == m_BakeResolution)) {
+                m_BakeResolution = resolution;
+            }
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::TextDisabled("Evaluates the surface outputs over the UV square on the CPU and\n"
+                        "creates a material that samples the baked textures.");
+    
+    if (m_BakeJob) {
+        const float fraction = m_BakeJob->progress.fraction.load(std::memory_order_relaxed);
+        ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), fraction < 1.0f ? nullptr : "Writing textures...");
+        const bool cancelling = m_BakeJob->progress.cancelled.load(std::memory_order_relaxed);
+        ImGui::BeginDisabled(cancelling);
+        if (ImGui::Button(cancelling ? "Cancelling..." : "Cancel")) {
+            m_BakeJob->progress.cancelled.store(true, std::memory_order_relaxed);
+        }
+        ImGui::EndDisabled();
+    } else {
+        if (ImGui::Button(LUCENT_ICON_PLAY " Bake") && m_Material) {
+            BakeMaterial();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+    }
+    if (!m_BakeStatus.empty()) {
+        ImGui::Separator();
+        ImGui::TextUnformatted(m_BakeStatus.c_str());
+    }
+    ImGui::EndPopup();
+}
+
+void MaterialGraphPanel::BakeMaterial() {
+    auto& manager = material::MaterialAssetManager::Get();
+    const std::filesystem::path materialPath = m_Material->GetFilePath();
+    const std::filesystem::path directory = materialPath.empty()
+        ? std::filesystem::path(manager.GetMaterialsPath()) : materialPath.parent_path();
+    
+    m_BakeJob = std::make_shared<BakeJob>();
+    m_BakeJob->graph = m_Material->GetGraph();
+    material::MaterialBakeSettings& settings = m_BakeJob->settings;
+    settings.resolution = static_cast<uint32_t>(m_BakeResolution);
+    settings.outputDirectory = (directory / "Baked").generic_string();
+    settings.name = materialPath.empty() ? std::string("material") : materialPath.stem().string();
+    m_BakeStatus.clear();
+    
+    // The baker's own tile ParallelFor runs nested inside this job
+    JobSystem::Get().Schedule([job = m_BakeJob]() {
+        job->succeeded = material::BakeMaterialToTextures(job->graph, job->settings, job->result, job->error,
+                                                          &job->progress);
+        job->done.store(true, std::memory_order_release);
+    });
+}
+
+void MaterialGraphPanel::PollBakeJob() {
+    if (!m_BakeJob || !m_BakeJob->done.load(std::memory_order_acquire)) return;
+    const std::shared_ptr<BakeJob> job = std::move(m_BakeJob);
+    
+    if (!job->succeeded) {
+        m_BakeStatus = "Bake failed: " + job->error;
+        return;
+    }
+    
+    // The baked graph goes into a new material; the procedural source stays as it is
+    auto& manager = material::MaterialAssetManager::Get();
+    const material::MaterialBakeResult& result = job->result;
+    material::MaterialAsset* baked = manager.CreateMaterial(result.graph.GetName());
+    if (!baked) {
+        m_BakeStatus = "Bake succeeded but the baked material could not be created";
+        return;
+    }
+    baked->GetGraph() = result.graph;
+    baked->Recompile();
+    manager.SaveMaterial(baked, baked->GetFilePath());
+    
+    const material::MaterialBakeStats& stats = result.stats;
+    char status[512];
+    std::snprintf(status, sizeof(status),
+                  "Baked %zu texture(s) in %.1f ms (+%.1f ms writing)\n"
+                  "Shader cost: %u -> %u instructions, %u -> %u texture samples\n"
+                  "Saved %s",
+                  result.texturePaths.size(), stats.bakeMs, stats.writeMs, stats.sourceInstructions,
+                  stats.bakedInstructions, stats.sourceTextureSamples, stats.bakedTextureSamples,
+                  baked->GetFilePath().c_str());
+    m_BakeStatus = status;
+}
+
 void MaterialGraphPanel::DrawCompileStatus() {
     if (!m_Material) return;
     
@@ -0,0 +1,177 @@
+#include "MaterialThumbnails.h"
+#include "lucent/gfx/Buffer.h"
+#include "lucent/gfx/Device.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+#include <imgui_impl_vulkan.h>
+
+namespace lucent {
+
+namespace {
+
+// Each texture holds an ImGui descriptor set; stay well inside the editor's descriptor pool
+constexpr size_t kMaxTextures = 512;
+// Each upload waits for the GPU, so only a few per frame
+constexpr uint32_t kMaxUploadsPerFrame = 4;
+
+} // namespace
+
+MaterialThumbnails::~MaterialThumbnails() {
+    Shutdown();
+}
+
+bool MaterialThumbnails::Init(gfx::Device* device, const std::string& cacheDirectory) {
+    m_Device = device;
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(device->GetHandle(), &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS) {
+        LUCENT_CORE_ERROR("MaterialThumbnails: failed to create sampler");
+        m_Device = nullptr;
+        return false;
+    }
+
+    m_Cache = std::make_unique<material::MaterialPreviewCache>(kThumbnailSize);
+    m_Cache->SetDirectory(cacheDirectory);
+    return true;
+}
+
+void MaterialThumbnails::Shutdown() {
+    if (!m_Device) return;
+
+    // Waits for renders still running
+    if (m_Cache) {
+        m_Cache->LogStats();
+        m_Cache.reset();
+    }
+
+    for (auto& [key, texture] : m_Textures) {
+        if (texture->descriptor != VK_NULL_HANDLE) ImGui_ImplVulkan_RemoveTexture(texture->descriptor);
+        texture->gpuImage.Shutdown();
+    }
+    m_Textures.clear();
+    m_Errors.clear();
+
+    if (m_Sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(m_Device->GetHandle(), m_Sampler, nullptr);
+        m_Sampler = VK_NULL_HANDLE;
+    }
+    m_Device = nullptr;
+}
+
+ImTextureID MaterialThumbnails::GetFileThumbnail(const std::filesystem::path& path,
+                                                 std::filesystem::file_time_type writeTime) {
+    if (!m_Cache) return ImTextureID{};
+    const std::string key = path.generic_string();
+    return Resolve(key, m_Cache->RequestFile(key, writeTime));
+}
+
+ImTextureID MaterialThumbnails::GetGraphThumbnail(const std::string& key, const material::MaterialGraph& graph) {
+    if (!m_Cache) return ImTextureID{};
+    return Resolve(key, m_Cache->Request(key, graph));
+}
+
+std::string MaterialThumbnails::GetError(const std::string& key) const {
+    auto it = m_Errors.find(key);
+    return it != m_Errors.end() ? it->second : std::string();
+}
+
+material::MaterialPreviewStats MaterialThumbnails::GetStats() const {
+    return m_Cache ? m_Cache->GetStats() : material::MaterialPreviewStats{};
+}
+
+ImTextureID MaterialThumbnails::Resolve(const std::string& key,
+                                        std::shared_ptr<const material::MaterialPreviewImage> image) {
+    auto it = m_Textures.find(key);
+    Texture* texture = it != m_Textures.end() ? it->second.get() : nullptr;
+    if (!image || (texture && texture->image == image)) {
+        return texture && texture->descriptor != VK_NULL_HANDLE ? (ImTextureID)texture->descriptor : ImTextureID{};
+    }
+
+    // A new thumbnail (or a new error) for this key
+    if (!image->IsValid()) {
+        m_Errors[key] = image->error;
+        if (texture) texture->image = image;
+        return texture && texture->descriptor != VK_NULL_HANDLE ? (ImTextureID)texture->descriptor : ImTextureID{};
+    }
+    m_Errors.erase(key);
+
+    const int frame = ImGui::GetFrameCount();
+    if (frame != m_UploadFrame) {
+        m_UploadFrame = frame;
+        m_UploadsThisFrame = 0;
+    }
+    if (!texture && m_Textures.size() >= kMaxTextures) return ImTextureID{};
+    if (m_UploadsThisFrame >= kMaxUploadsPerFrame) {
+        // Show the previous thumbnail until a later frame has room
+        return texture && texture->descriptor != VK_NULL_HANDLE ? (ImTextureID)texture->descriptor : ImTextureID{};
+    }
+    ++m_UploadsThisFrame;
+
+    if (!texture) {
+        texture = m_Textures.emplace(key, std::make_unique<Texture>()).first->second.get();
+    }
+    if (Upload(*texture, *image)) texture->image = image;
+    return texture->descriptor != VK_NULL_HANDLE ? (ImTextureID)texture->descriptor : ImTextureID{};
+}
+
+bool MaterialThumbnails::Upload(Texture& texture, const material::MaterialPreviewImage& image) {
+    LUCENT_PROFILE_FUNCTION();
+
+    if (texture.gpuImage.GetHandle() == VK_NULL_HANDLE || texture.gpuImage.GetWidth() != image.size) {
+        if (texture.descriptor != VK_NULL_HANDLE) {
+            ImGui_ImplVulkan_RemoveTexture(texture.descriptor);
+            texture.descriptor = VK_NULL_HANDLE;
+        }
+        texture.gpuImage.Shutdown();
+
+        gfx::ImageDesc desc{};
+        desc.width = image.size;
+        desc.height = image.size;
+        desc.format = VK_FORMAT_R8G8B8A8_SRGB;
+        desc.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        desc.debugName = "MaterialThumbnail";
+        if (!texture.gpuImage.Init(m_Device, desc)) return false;
+    }
+
+    gfx::BufferDesc stagingDesc{};
+    stagingDesc.size = image.pixels.size();
+    stagingDesc.usage = gfx::BufferUsage::Staging;
+    stagingDesc.hostVisible = true;
+    stagingDesc.debugName = "MaterialThumbnailStaging";
+    gfx::Buffer staging;
+    if (!staging.Init(m_Device, stagingDesc)) return false;
+    staging.Upload(image.pixels.data(), image.pixels.size());
+
+    // The previous thumbnail may still be sampled by a frame in flight; the barrier orders the copy
+    // after those reads
+    const VkImageLayout oldLayout =
+        texture.descriptor != VK_NULL_HANDLE ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    VkCommandBuffer cmd = m_Device->BeginSingleTimeCommands();
+    texture.gpuImage.TransitionLayout(cmd, oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { image.size, image.size, 1 };
+    vkCmdCopyBufferToImage(cmd, staging.GetHandle(), texture.gpuImage.GetHandle(),
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    texture.gpuImage.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    m_Device->EndSingleTimeCommands(cmd);
+    staging.Shutdown();
+
+    if (texture.descriptor == VK_NULL_HANDLE) {
+        texture.descriptor = ImGui_ImplVulkan_AddTexture(m_Sampler, texture.gpuImage.GetView(),
+                                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    return texture.descriptor != VK_NULL_HANDLE;
+}
+
+} // namespace lucent
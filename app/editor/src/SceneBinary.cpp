@@ -0,0 +1,443 @@
+#include "SceneBinary.h"
+#include "lucent/scene/Components.h"
+#include "lucent/mesh/EditableMesh.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace lucent {
+namespace SceneBinary {
+
+static_assert(std::endian::native == std::endian::little, "Binary scene format assumes a little-endian host");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float) && sizeof(glm::vec2) == 2 * sizeof(float),
+    "Mesh arrays are mapped directly as glm vectors");
+static_assert(std::is_trivially_copyable_v<EntityRecord> && std::is_trivially_copyable_v<MeshChunkHeader>);
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void CopyVec3(float* dst, const glm::vec3& v) {
+    dst[0] = v.x;
+    dst[1] = v.y;
+    dst[2] = v.z;
+}
+
+glm::vec3 ToVec3(const float* src) {
+    return glm::vec3(src[0], src[1], src[2]);
+}
+
+// Sequential writer that tracks the file offset and pads to chunk boundaries
+class ChunkWriter {
+public:
+    explicit ChunkWriter(std::ofstream& out) : m_Out(out) {}
+
+    void Write(const void* data, size_t size) {
+        if (size == 0) return;
+        m_Out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        m_Offset += size;
+    }
+
+    template<typename T>
+    void WriteArray(const std::vector<T>& values) {
+        Write(values.data(), values.size() * sizeof(T));
+    }
+
+    void PadTo(uint64_t alignment) {
+        static constexpr char kZeros[kChunkAlignment] = {};
+        const uint64_t target = AlignUp(m_Offset, alignment);
+        Write(kZeros, static_cast<size_t>(target - m_Offset));
+    }
+
+    uint64_t Offset() const { return m_Offset; }
+
+private:
+    std::ofstream& m_Out;
+    uint64_t m_Offset = 0;
+};
+
+} // namespace
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+bool Write(scene::Scene* scene, const std::string& filepath, std::string& error) {
+    LUCENT_PROFILE_FUNCTION();
+
+    std::string strings;
+    auto addString = [&strings](const std::string& s) {
+        StringRef ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size()) };
+        strings += s;
+        return ref;
+    };
+
+    SceneRecord sceneRecord{};
+    sceneRecord.name = addString(scene->GetName());
+    sceneRecord.environmentMap = addString(scene->GetEnvironmentMapPath());
+
+    std::vector<EntityRecord> entities;
+    // Flattened one at a time while writing, so only one mesh copy is alive at once
+    std::vector<const mesh::EditableMesh*> meshes;
+    entities.reserve(scene->GetEntities().size());
+
+    for (scene::EntityID id : scene->GetEntities()) {
+        scene::Entity entity = scene->GetEntity(id);
+        EntityRecord record{};
+        record.meshChunk = kInvalidIndex;
+        record.sourcePrimitive = 0;
+
+        if (auto* tag = entity.GetComponent<scene::TagComponent>()) {
+            record.name = addString(tag->name);
+        }
+
+        if (auto* transform = entity.GetComponent<scene::TransformComponent>()) {
+            record.components |= kHasTransform;
+            CopyVec3(record.position, transform->position);
+            CopyVec3(record.rotation, transform->rotation);
+            CopyVec3(record.scale, transform->scale);
+        }
+
+        if (auto* camera = entity.GetComponent<scene::CameraComponent>()) {
+            record.components |= kHasCamera;
+            record.cameraProjection = static_cast<int32_t>(camera->projectionType);
+            record.cameraFov = camera->fov;
+            record.cameraOrthoSize = camera->orthoSize;
+            record.cameraNear = camera->nearClip;
+            record.cameraFar = camera->farClip;
+            record.cameraPrimary = camera->primary ? 1u : 0u;
+        }
+
+        if (auto* light = entity.GetComponent<scene::LightComponent>()) {
+            record.components |= kHasLight;
+            record.lightType = static_cast<int32_t>(light->type);
+            CopyVec3(record.lightColor, light->color);
+            record.lightIntensity = light->intensity;
+            record.lightRange = light->range;
+            record.lightInnerAngle = light->innerAngle;
+            record.lightOuterAngle = light->outerAngle;
+            record.lightAreaShape = static_cast<int32_t>(light->areaShape);
+            record.lightAreaWidth = light->areaWidth;
+            record.lightAreaHeight = light->areaHeight;
+            record.lightShadowSoftness = light->shadowSoftness;
+            record.lightCastShadows = light->castShadows ? 1u : 0u;
+        }
+
+        if (auto* mr = entity.GetComponent<scene::MeshRendererComponent>()) {
+            record.components |= kHasMeshRenderer;
+            record.primitiveType = static_cast<int32_t>(mr->primitiveType);
+            record.visible = mr->visible ? 1u : 0u;
+            record.castShadows = mr->castShadows ? 1u : 0u;
+            record.receiveShadows = mr->receiveShadows ? 1u : 0u;
+            CopyVec3(record.baseColor, mr->baseColor);
+            record.metallic = mr->metallic;
+            record.roughness = mr->roughness;
+            CopyVec3(record.emissive, mr->emissive);
+            record.emissiveIntensity = mr->emissiveIntensity;
+            record.materialPath = addString(mr->materialPath);
+        }
+
+        auto* editMesh = entity.GetComponent<scene::EditableMeshComponent>();
+        if (editMesh && editMesh->HasMesh() && editMesh->mesh->VertexCount() > 0) {
+            record.components |= kHasEditableMesh;
+            record.sourcePrimitive = static_cast<int32_t>(editMesh->sourcePrimitive);
+            record.fromImport = editMesh->fromImport ? 1u : 0u;
+            // Chunk order: SCNE, STRS, ENTS, then meshes
+            record.meshChunk = static_cast<uint32_t>(3 + meshes.size());
+            meshes.push_back(editMesh->mesh.get());
+        }
+
+        entities.push_back(record);
+    }
+
+    sceneRecord.entityCount = static_cast<uint32_t>(entities.size());
+    sceneRecord.meshCount = static_cast<uint32_t>(meshes.size());
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error = "Failed to open file for writing: " + filepath;
+        return false;
+    }
+
+    ChunkWriter writer(file);
+    std::vector<ChunkEntry> toc;
+    toc.reserve(3 + meshes.size());
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    writer.Write(&header, sizeof(header)); // patched once offsets are known
+
+    auto beginChunk = [&](ChunkType type) {
+        writer.PadTo(kChunkAlignment);
+        toc.push_back(ChunkEntry{ static_cast<uint32_t>(type), 0, writer.Offset(), 0 });
+    };
+    auto endChunk = [&]() {
+        toc.back().size = writer.Offset() - toc.back().offset;
+    };
+
+    beginChunk(ChunkType::Scene);
+    writer.Write(&sceneRecord, sizeof(sceneRecord));
+    endChunk();
+
+    beginChunk(ChunkType::Strings);
+    writer.Write(strings.data(), strings.size());
+    endChunk();
+
+    beginChunk(ChunkType::Entities);
+    writer.WriteArray(entities);
+    endChunk();
+
+    for (const mesh::EditableMesh* editable : meshes) {
+        const mesh::EditableMesh::FlatData data = editable->SerializeFlat();
+        MeshChunkHeader mh{};
+        mh.vertexCount = static_cast<uint32_t>(data.positions.size());
+        mh.faceCount = static_cast<uint32_t>(data.faceSizes.size());
+        mh.indexCount = static_cast<uint32_t>(data.faceIndices.size());
+        mh.hasUVs = data.uvs.size() == data.positions.size() ? 1u : 0u;
+
+        uint64_t cursor = AlignUp(sizeof(MeshChunkHeader), kChunkAlignment);
+        mh.positionsOffset = cursor;
+        cursor = AlignUp(cursor + data.positions.size() * sizeof(glm::vec3), kChunkAlignment);
+        mh.uvsOffset = cursor;
+        if (mh.hasUVs) {
+            cursor = AlignUp(cursor + data.uvs.size() * sizeof(glm::vec2), kChunkAlignment);
+        }
+        mh.faceSizesOffset = cursor;
+        cursor = AlignUp(cursor + data.faceSizes.size() * sizeof(uint32_t), kChunkAlignment);
+        mh.indicesOffset = cursor;
+
+        glm::vec3 bmin(std::numeric_limits<float>::max());
+        glm::vec3 bmax(std::numeric_limits<float>::lowest());
+        for (const glm::vec3& p : data.positions) {
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+        CopyVec3(mh.boundsMin, bmin);
+        CopyVec3(mh.boundsMax, bmax);
+
+        beginChunk(ChunkType::Mesh);
+        writer.Write(&mh, sizeof(mh));
+        writer.PadTo(kChunkAlignment);
+        writer.WriteArray(data.positions);
+        if (mh.hasUVs) {
+            writer.PadTo(kChunkAlignment);
+            writer.WriteArray(data.uvs);
+        }
+        writer.PadTo(kChunkAlignment);
+        writer.WriteArray(data.faceSizes);
+        writer.PadTo(kChunkAlignment);
+        writer.WriteArray(data.faceIndices);
+        endChunk();
+    }
+
+    writer.PadTo(alignof(ChunkEntry));
+    header.tocOffset = writer.Offset();
+    header.chunkCount = static_cast<uint32_t>(toc.size());
+    writer.WriteArray(toc);
+    header.fileSize = writer.Offset();
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    if (!file) {
+        error = "Failed to write scene file: " + filepath;
+        return false;
+    }
+    return true;
+}
+
+bool IsBinarySceneFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+bool Reader::Open(const std::string& filepath, std::string& error) {
+    Close();
+
+    if (!m_File.Open(filepath)) {
+        error = "Failed to open file: " + filepath;
+        return false;
+    }
+
+    const std::byte* base = m_File.Data();
+    const uint64_t size = m_File.Size();
+
+    auto fail = [&](const std::string& message) {
+        error = message + ": " + filepath;
+        Close();
+        return false;
+    };
+
+    if (size < sizeof(FileHeader)) {
+        return fail("Truncated scene file");
+    }
+    const auto* header = reinterpret_cast<const FileHeader*>(base);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail("Not a binary scene file");
+    }
+    if (header->version != kVersion) {
+        return fail("Unsupported binary scene version " + std::to_string(header->version));
+    }
+    if (header->fileSize != size || header->tocOffset % alignof(ChunkEntry) != 0 ||
+        header->tocOffset > size || (size - header->tocOffset) / sizeof(ChunkEntry) < header->chunkCount) {
+        return fail("Corrupt scene file header");
+    }
+
+    m_Chunks = { reinterpret_cast<const ChunkEntry*>(base + header->tocOffset), header->chunkCount };
+    for (const ChunkEntry& chunk : m_Chunks) {
+        if (chunk.offset % kChunkAlignment != 0 || chunk.offset > size || chunk.size > size - chunk.offset) {
+            return fail("Corrupt scene chunk table");
+        }
+    }
+
+    const ChunkEntry* sceneChunk = FindChunk(ChunkType::Scene);
+    const ChunkEntry* stringsChunk = FindChunk(ChunkType::Strings);
+    const ChunkEntry* entitiesChunk = FindChunk(ChunkType::Entities);
+    if (!sceneChunk || !stringsChunk || !entitiesChunk || sceneChunk->size < sizeof(SceneRecord)) {
+        return fail("Scene file is missing required chunks");
+    }
+
+    m_Scene = reinterpret_cast<const SceneRecord*>(base + sceneChunk->offset);
+    m_Strings = { reinterpret_cast<const char*>(base + stringsChunk->offset), static_cast<size_t>(stringsChunk->size) };
+    if (entitiesChunk->size / sizeof(EntityRecord) < m_Scene->entityCount) {
+        return fail("Truncated entity table");
+    }
+    m_Entities = { reinterpret_cast<const EntityRecord*>(base + entitiesChunk->offset), m_Scene->entityCount };
+    return true;
+}
+
+void Reader::Close() {
+    m_File.Close();
+    m_Chunks = {};
+    m_Scene = nullptr;
+    m_Strings = {};
+    m_Entities = {};
+}
+
+std::string_view Reader::GetString(const StringRef& ref) const {
+    if (ref.offset > m_Strings.size() || ref.length > m_Strings.size() - ref.offset) {
+        return {};
+    }
+    return { m_Strings.data() + ref.offset, ref.length };
+}
+
+const ChunkEntry* Reader::FindChunk(ChunkType type) const {
+    for (const ChunkEntry& chunk : m_Chunks) {
+        if (chunk.type == static_cast<uint32_t>(type)) {
+            return &chunk;
+        }
+    }
+    return nullptr;
+}
+
+bool Reader::GetMesh(uint32_t chunkIndex, MeshView& out) const {
+    if (chunkIndex >= m_Chunks.size()) return false;
+    const ChunkEntry& chunk = m_Chunks[chunkIndex];
+    if (chunk.type != static_cast<uint32_t>(ChunkType::Mesh) || chunk.size < sizeof(MeshChunkHeader)) {
+        return false;
+    }
+
+    const std::byte* base = m_File.Data() + chunk.offset;
+    const auto* mh = reinterpret_cast<const MeshChunkHeader*>(base);
+
+    auto inChunk = [&](uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t alignment) {
+        return offset % alignment == 0 && offset <= chunk.size &&
+               count <= (chunk.size - offset) / elementSize;
+    };
+    if (!inChunk(mh->positionsOffset, mh->vertexCount, sizeof(glm::vec3), alignof(glm::vec3)) ||
+        (mh->hasUVs && !inChunk(mh->uvsOffset, mh->vertexCount, sizeof(glm::vec2), alignof(glm::vec2))) ||
+        !inChunk(mh->faceSizesOffset, mh->faceCount, sizeof(uint32_t), alignof(uint32_t)) ||
+        !inChunk(mh->indicesOffset, mh->indexCount, sizeof(uint32_t), alignof(uint32_t))) {
+        return false;
+    }
+
+    out.positions = { reinterpret_cast<const glm::vec3*>(base + mh->positionsOffset), mh->vertexCount };
+    out.uvs = mh->hasUVs
+        ? std::span<const glm::vec2>(reinterpret_cast<const glm::vec2*>(base + mh->uvsOffset), mh->vertexCount)
+        : std::span<const glm::vec2>();
+    out.faceSizes = { reinterpret_cast<const uint32_t*>(base + mh->faceSizesOffset), mh->faceCount };
+    out.faceIndices = { reinterpret_cast<const uint32_t*>(base + mh->indicesOffset), mh->indexCount };
+    out.boundsMin = ToVec3(mh->boundsMin);
+    out.boundsMax = ToVec3(mh->boundsMax);
+    return true;
+}
+
+// ============================================================================
+// Entity reconstruction
+// ============================================================================
+
+scene::Entity CreateEntity(scene::Scene* scene, const EntityRecord& record,
+                           std::string_view name, std::string_view materialPath) {
+    scene::Entity entity = scene->CreateEntity(std::string(name));
+
+    if (record.components & kHasTransform) {
+        if (auto* transform = entity.GetComponent<scene::TransformComponent>()) {
+            transform->position = ToVec3(record.position);
+            transform->rotation = ToVec3(record.rotation);
+            transform->scale = ToVec3(record.scale);
+        }
+    }
+
+    if (record.components & kHasCamera) {
+        auto& cam = entity.AddComponent<scene::CameraComponent>();
+        cam.projectionType = static_cast<scene::CameraComponent::ProjectionType>(record.cameraProjection);
+        cam.fov = record.cameraFov;
+        cam.orthoSize = record.cameraOrthoSize;
+        cam.nearClip = record.cameraNear;
+        cam.farClip = record.cameraFar;
+        cam.primary = record.cameraPrimary != 0;
+    }
+
+    if (record.components & kHasLight) {
+        auto& light = entity.AddComponent<scene::LightComponent>();
+        light.type = static_cast<scene::LightType>(record.lightType);
+        light.color = ToVec3(record.lightColor);
+        light.intensity = record.lightIntensity;
+        light.range = record.lightRange;
+        light.innerAngle = record.lightInnerAngle;
+        light.outerAngle = record.lightOuterAngle;
+        light.areaShape = static_cast<scene::AreaShape>(record.lightAreaShape);
+        light.areaWidth = record.lightAreaWidth;
+        light.areaHeight = record.lightAreaHeight;
+        light.shadowSoftness = record.lightShadowSoftness;
+        light.castShadows = record.lightCastShadows != 0;
+    }
+
+    if (record.components & kHasMeshRenderer) {
+        auto& mr = entity.AddComponent<scene::MeshRendererComponent>();
+        mr.primitiveType = static_cast<scene::MeshRendererComponent::PrimitiveType>(record.primitiveType);
+        mr.visible = record.visible != 0;
+        mr.castShadows = record.castShadows != 0;
+        mr.receiveShadows = record.receiveShadows != 0;
+        mr.baseColor = ToVec3(record.baseColor);
+        mr.metallic = record.metallic;
+        mr.roughness = record.roughness;
+        mr.emissive = ToVec3(record.emissive);
+        mr.emissiveIntensity = record.emissiveIntensity;
+        mr.materialPath = std::string(materialPath);
+    }
+
+    return entity;
+}
+
+} // namespace SceneBinary
+} // namespace lucent
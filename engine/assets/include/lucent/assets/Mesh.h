@@ -3,6 +3,7 @@
 #include "lucent/core/Core.h"
 #include "lucent/gfx/Buffer.h"
 #include <glm/glm.hpp>
+#include <span>
 #include <vector>
 #include <string>
 
@@ -26,6 +27,13 @@ struct Submesh {
     uint32_t materialIndex = 0;
 };
 
+// Simplified level of detail: a range of the mesh's index buffer over the same vertices
+struct MeshLOD {
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;     // Largest deviation from the full mesh, in object-space units
+};
+
 // Bounding volumes
 struct AABB {
     glm::vec3 min = glm::vec3(FLT_MAX);
@@ -45,22 +53,34 @@ public:
     Mesh() = default;
     ~Mesh();
     
-    // Create from vertex/index data
+    // Create from vertex/index data (copied; the source may be a transient/scratch buffer).
+    // Optional LODs index `lodIndices` (offsets relative to it) and are stored after the full
+    // mesh in the same index buffer, finest first.
     bool Create(gfx::Device* device, 
-                const std::vector<Vertex>& vertices, 
-                const std::vector<uint32_t>& indices,
-                const std::string& name = "Mesh");
+                std::span<const Vertex> vertices, 
+                std::span<const uint32_t> indices,
+                const std::string& name = "Mesh",
+                std::span<const uint32_t> lodIndices = {},
+                std::span<const MeshLOD> lods = {});
     
     void Destroy();
     
     // Bind for rendering
     void Bind(VkCommandBuffer cmd) const;
-    void Draw(VkCommandBuffer cmd, uint32_t instanceCount = 1) const;
+    void Draw(VkCommandBuffer cmd, uint32_t instanceCount = 1, uint32_t firstInstance = 0, uint32_t lod = 0) const;
+    
+    // Level of detail: LOD 0 is the full mesh
+    uint32_t GetLODCount() const { return static_cast<uint32_t>(m_LODs.size()); }
+    const MeshLOD& GetLOD(uint32_t lod) const { return m_LODs[lod]; }
+    // Coarsest LOD whose error stays under maxErrorPixels when one object-space unit covers
+    // pixelsPerUnit pixels on screen
+    uint32_t SelectLOD(float pixelsPerUnit, float maxErrorPixels = 1.0f) const;
     
     // Submesh support
     void AddSubmesh(uint32_t indexOffset, uint32_t indexCount, uint32_t materialIndex = 0);
     const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
-    void DrawSubmesh(VkCommandBuffer cmd, uint32_t submeshIndex, uint32_t instanceCount = 1) const;
+    void DrawSubmesh(VkCommandBuffer cmd, uint32_t submeshIndex, uint32_t instanceCount = 1,
+                     uint32_t firstInstance = 0) const;
     
     // Getters
     uint32_t GetVertexCount() const { return m_VertexCount; }
@@ -85,10 +105,11 @@ private:
     uint32_t m_IndexCount = 0;
     
     std::vector<Submesh> m_Submeshes;
+    std::vector<MeshLOD> m_LODs;    // Absolute index buffer ranges
     AABB m_Bounds;
     std::string m_Name;
     
-    // CPU-side copies for path tracing
+    // CPU-side copies for path tracing (full detail only)
     std::vector<Vertex> m_CPUVertices;
     std::vector<uint32_t> m_CPUIndices;
 };
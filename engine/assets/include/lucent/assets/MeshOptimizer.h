@@ -0,0 +1,64 @@
+#pragma once
+
+#include "lucent/assets/Mesh.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lucent::assets {
+
+struct ImportedMesh;
+
+// Import-time mesh optimisation: triangle order for the post-transform vertex cache and for
+// overdraw, then vertex order for fetch locality. Triangles are only reordered within their
+// submesh, so submesh ranges and materials stay valid; the set of triangles is unchanged.
+namespace MeshOptimizer {
+
+// Cache size the reordering targets and the statistics are simulated with (FIFO)
+inline constexpr uint32_t kCacheSize = 32;
+
+struct Stats {
+    float acmrBefore = 0.0f;        // Average cache misses per triangle
+    float acmrAfter = 0.0f;
+    size_t vertexCountBefore = 0;
+    size_t vertexCountAfter = 0;    // Unreferenced vertices are dropped
+    size_t vertexBytes = 0;         // Vertex buffer size after optimisation
+};
+
+// Forsyth-style greedy reordering of one triangle list for the post-transform vertex cache
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+
+// Splits a cache-optimised triangle list into clusters (at cache-miss boundaries, allowing the
+// ACMR to degrade by at most `threshold`) and sorts them front-most first, view-independently,
+// so early depth rejection discards more. Run after OptimizeVertexCache.
+void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold = 1.05f);
+
+// Renumbers vertices in first-use order and remaps the indices. Returns the number of vertices
+// kept; unreferenced vertices are dropped and vertices beyond the returned count are undefined.
+size_t OptimizeVertexFetch(std::span<Vertex> vertices, std::span<uint32_t> indices);
+
+// All three passes, per submesh for the triangle passes. Returns the new vertex count (the
+// caller shrinks its vertex array). Empty submeshes: the whole index buffer is one range.
+size_t Optimize(std::span<Vertex> vertices, std::span<uint32_t> indices, std::span<const Submesh> submeshes,
+                Stats* outStats = nullptr);
+
+// Convenience for importers: optimises in place and resizes the vertex array
+Stats Optimize(ImportedMesh& mesh);
+
+float ComputeACMR(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = kCacheSize);
+
+// LOD generation defaults: up to kMaxLODs levels, each at most half the previous level's
+// triangles, with the simplification error bounded by kMaxLODError of the mesh extent
+inline constexpr uint32_t kMaxLODs = 4;
+inline constexpr float kMaxLODError = 0.05f;
+
+// Fills mesh.lods / mesh.lodIndices (replaced) with a chain of simplified index lists over the
+// unchanged vertex array (see lucent::mesh::Simplifier). Every submesh is simplified on its own
+// with its borders locked, so submesh ranges stay watertight against each other. Levels stop
+// early once a halving step no longer removes enough triangles. Returns the number of LODs.
+size_t GenerateLODs(ImportedMesh& mesh, uint32_t maxLODs = kMaxLODs, float maxError = kMaxLODError);
+
+} // namespace MeshOptimizer
+
+} // namespace lucent::assets
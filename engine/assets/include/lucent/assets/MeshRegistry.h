@@ -9,7 +9,8 @@
 namespace lucent::assets {
 
 // Simple runtime registry for meshes loaded at runtime (e.g., glTF import).
-// Returns stable integer IDs suitable for storing in components.
+// Returns stable integer IDs suitable for storing in components. Entries are reference counted
+// so many entities (e.g. every instance of a glTF mesh) can share one mesh; IDs are never reused.
 class MeshRegistry : public NonCopyable {
 public:
     static MeshRegistry& Get() {
@@ -17,20 +18,61 @@ public:
         return instance;
     }
 
-    // Takes ownership; returns an ID you can store.
+    // Takes ownership; returns an ID you can store, holding one reference.
     uint32_t Register(std::unique_ptr<Mesh> mesh);
 
+    // Another user of an existing mesh. Returns false if the ID is invalid or was released.
+    bool AddRef(uint32_t id);
+    // Drops one reference. With the last one the mesh leaves the registry but is not destroyed:
+    // it waits in TakeRetired() until the renderer knows no frame in flight still draws it.
+    void Release(uint32_t id);
+    uint32_t GetRefCount(uint32_t id) const;
+
+    // Meshes released since the last call; the caller destroys them once the GPU is done.
+    std::vector<std::unique_ptr<Mesh>> TakeRetired();
     // Returns nullptr if id invalid or mesh was removed.
     Mesh* GetMesh(uint32_t id);
     const Mesh* GetMesh(uint32_t id) const;
 
+    // Destroys every mesh, released or not. Only once the GPU is idle (shutdown).
     void Clear();
 
 private:
     MeshRegistry() = default;
 
     mutable std::mutex m_Mutex;
-    std::vector<std::unique_ptr<Mesh>> m_Meshes;
+    struct Entry {
+        std::unique_ptr<Mesh> mesh;
+        uint32_t refCount = 0;
+    };
+    std::vector<Entry> m_Meshes;
+    std::vector<std::unique_ptr<Mesh>> m_Retired;
+};
+
+// One reference to a registry mesh, as stored in MeshRendererComponent. Copies take another
+// reference and destruction drops it, so duplicating, removing or destroying an entity and
+// clearing a scene keep the count right without explicit AddRef/Release calls.
+class MeshHandle {
+public:
+    MeshHandle() = default;
+    // Takes over a reference the caller already holds (from Register or AddRef)
+    static MeshHandle Adopt(uint32_t id);
+
+    MeshHandle(const MeshHandle& other);
+    MeshHandle(MeshHandle&& other) noexcept;
+    MeshHandle& operator=(const MeshHandle& other);
+    MeshHandle& operator=(MeshHandle&& other) noexcept;
+    ~MeshHandle() { Reset(); }
+
+    void Reset();
+
+    uint32_t GetID() const { return m_ID; }
+    bool IsValid() const { return m_ID != UINT32_MAX; }
+    // Null for an empty handle
+    Mesh* Get() const { return IsValid() ? MeshRegistry::Get().GetMesh(m_ID) : nullptr; }
+
+private:
+    uint32_t m_ID = UINT32_MAX;
 };
 
 } // namespace lucent::assets
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "lucent/core/MappedFile.h"
+#include "lucent/assets/Mesh.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lucent::assets {
+
+class Model;
+
+// Processed geometry of one imported mesh, before GPU buffers exist
+struct ImportedMesh {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    // Simplified LODs, finest first; their ranges index lodIndices
+    std::vector<uint32_t> lodIndices;
+    std::vector<MeshLOD> lods;
+};
+
+// Binary cache of an imported model (.lmc), written after the first import and memory-mapped on
+// later ones so the importer and its post-processing do not run again.
+//
+// Layout (little-endian, every section starts on a kSectionAlignment boundary):
+//   FileHeader            magic, version, source/settings hashes, section table
+//   sections...           strings, MeshRecord[], Submesh[], Vertex[], uint32 indices,
+//                         MaterialRecord[], CameraRecord[], LightRecord[], NodeRecord[],
+//                         uint32 child links, uint32 root nodes, MeshLOD[], uint32 LOD indices
+//
+// Vertices, indices and submeshes are stored exactly as the in-memory types, so a mapped file is
+// handed to Mesh::Create() without parsing or intermediate copies. A file is only accepted for
+// the source hash and import settings it was written with.
+namespace ModelCache {
+
+inline constexpr char kMagic[8] = { 'L', 'U', 'C', 'E', 'N', 'T', 'M', 'C' };
+inline constexpr uint32_t kVersion = 2;
+inline constexpr uint32_t kSectionAlignment = 64;
+
+enum class Section : uint32_t {
+    Strings,
+    Meshes,
+    Submeshes,
+    Vertices,
+    Indices,
+    Materials,
+    Cameras,
+    Lights,
+    Nodes,
+    NodeChildren,
+    RootNodes,
+    LODs,
+    LODIndices,
+    Count
+};
+inline constexpr uint32_t kSectionCount = static_cast<uint32_t>(Section::Count);
+
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexSize;   // sizeof(Vertex) when written
+    uint64_t sourceHash;
+    uint64_t settingsHash;
+    uint64_t fileSize;
+    SectionEntry sections[kSectionCount];
+    uint64_t reserved[1];
+};
+static_assert(sizeof(FileHeader) == 256);
+
+// Strings are (offset, length) ranges into the strings section
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Ranges are element indices into the submesh / vertex / index / LOD sections
+struct MeshRecord {
+    StringRef name;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint64_t firstVertex;
+    uint64_t firstIndex;
+    uint32_t firstSubmesh;
+    uint32_t submeshCount;
+    uint64_t firstLODIndex;
+    uint32_t lodIndexCount;
+    uint32_t firstLOD;
+    uint32_t lodCount;
+    uint32_t reserved;
+};
+
+struct MaterialRecord {
+    StringRef name;
+    float baseColorFactor[4];
+    float metallicFactor;
+    float roughnessFactor;
+    int32_t baseColorTexture;
+    int32_t metallicRoughnessTexture;
+    int32_t normalTexture;
+    int32_t occlusionTexture;
+    int32_t emissiveTexture;
+    float emissiveFactor[3];
+    uint32_t alphaMode;
+    float alphaCutoff;
+    uint32_t doubleSided;
+};
+
+struct CameraRecord {
+    StringRef name;
+    uint32_t perspective;
+    float fov;
+    float orthoSize;
+    float nearClip;
+    float farClip;
+    float aspectRatio;
+};
+
+struct LightRecord {
+    StringRef name;
+    uint32_t type;
+    float color[3];
+    float intensity;
+    float range;
+    float innerAngle;
+    float outerAngle;
+};
+
+struct NodeRecord {
+    StringRef name;
+    float localTransform[16];
+    int32_t meshIndex;
+    int32_t cameraIndex;
+    int32_t lightIndex;
+    uint32_t firstChild;   // Into the node children section
+    uint32_t childCount;
+};
+
+// Zero-copy view of one mesh inside a mapped file
+struct MeshView {
+    std::string_view name;
+    std::span<const Vertex> vertices;
+    std::span<const uint32_t> indices;
+    std::span<const Submesh> submeshes;
+    std::span<const uint32_t> lodIndices;
+    std::span<const MeshLOD> lods;
+};
+
+// Cache file for a source hash + import settings inside `cacheDirectory`
+std::string GetCachePath(const std::string& cacheDirectory, uint64_t sourceHash, uint64_t settingsHash);
+
+// Write the meshes plus the materials, cameras, lights and node hierarchy of `model` (its GPU
+// meshes are ignored). Written to a temporary file and renamed, so readers never see a partial
+// file. On failure returns false and sets `error`.
+bool Write(const std::string& path, uint64_t sourceHash, uint64_t settingsHash,
+           std::span<const ImportedMesh> meshes, const Model& model, std::string& error);
+
+// Memory-mapped reader; all views returned stay valid while the reader is open.
+class Reader : public NonCopyable {
+public:
+    // Fails if the file is missing or malformed, or was written for another source or settings.
+    // Every record is validated here, so the accessors below cannot fail afterwards.
+    bool Open(const std::string& path, uint64_t sourceHash, uint64_t settingsHash, std::string& error);
+    void Close();
+
+    uint32_t GetMeshCount() const { return static_cast<uint32_t>(m_Meshes.size()); }
+    MeshView GetMesh(uint32_t index) const;
+
+    // Fill the materials, cameras, lights, nodes and root nodes of `model`
+    void ReadModelInfo(Model& model) const;
+
+private:
+    template<typename T>
+    std::span<const T> GetSection(Section section) const;
+    // Out-of-range refs read as empty
+    std::string_view GetString(const StringRef& ref) const;
+
+    MappedFile m_File;
+    const FileHeader* m_Header = nullptr;
+    std::span<const char> m_Strings;
+    std::span<const MeshRecord> m_Meshes;
+};
+
+} // namespace ModelCache
+
+} // namespace lucent::assets
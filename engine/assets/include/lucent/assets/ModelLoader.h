@@ -2,7 +2,7 @@
 
 #include "lucent/core/Core.h"
 #include "lucent/assets/Mesh.h"
-#include "lucent/assets/Texture.h"
+#include "lucent/gfx/TextureCache.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -78,7 +78,7 @@ public:
     
     // Loaded data
     std::vector<std::unique_ptr<Mesh>> meshes;
-    std::vector<std::unique_ptr<Texture>> textures;
+    std::vector<gfx::TextureHandle> textures;   // Shared with the TextureCache (null = failed)
     std::vector<MaterialData> materials;
     std::vector<CameraData> cameras;
     std::vector<LightData> lights;
@@ -92,6 +92,8 @@ public:
     AABB bounds;
 };
 
+struct ImportedMesh;
+
 // glTF/GLB loader
 class ModelLoader : public NonCopyable {
 public:
@@ -103,13 +105,25 @@ public:
     // Load a glTF or GLB file
     std::unique_ptr<Model> LoadGLTF(gfx::Device* device, const std::string& path);
     
+    // CPU half of LoadGLTF: decode and convert the geometry only (no device, no textures).
+    // One entry per glTF mesh, in file order. Used by tools and the loader benchmark.
+    bool LoadGLTFGeometry(const std::string& path, std::vector<ImportedMesh>& outMeshes);
+    
     // Load OBJ file (simpler format)
     std::unique_ptr<Model> LoadOBJ(gfx::Device* device, const std::string& path);
     
     // Get last error message
     const std::string& GetLastError() const { return m_LastError; }
+
+    // Where processed Assimp imports are cached, keyed by source hash and import settings
+    // (empty: import from the source every time). Shared by all loaders.
+    static void SetImportCacheDirectory(const std::string& directory);
+    static const std::string& GetImportCacheDirectory();
     
 private:
+    std::unique_ptr<Model> LoadAssimpCached(gfx::Device* device, const std::string& path,
+                                            const std::string& cachePath, uint64_t sourceHash);
+
     std::string m_LastError;
 };
 
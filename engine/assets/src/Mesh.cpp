@@ -25,17 +25,19 @@ Mesh::~Mesh() {
 }
 
 bool Mesh::Create(gfx::Device* device, 
-                  const std::vector<Vertex>& vertices, 
-                  const std::vector<uint32_t>& indices,
-                  const std::string& name) {
+                  std::span<const Vertex> vertices, 
+                  std::span<const uint32_t> indices,
+                  const std::string& name,
+                  std::span<const uint32_t> lodIndices,
+                  std::span<const MeshLOD> lods) {
     m_Device = device;
     m_Name = name;
     m_VertexCount = static_cast<uint32_t>(vertices.size());
     m_IndexCount = static_cast<uint32_t>(indices.size());
     
     // Store CPU copies for path tracing
-    m_CPUVertices = vertices;
-    m_CPUIndices = indices;
+    m_CPUVertices.assign(vertices.begin(), vertices.end());
+    m_CPUIndices.assign(indices.begin(), indices.end());
     
     // Calculate bounds
     m_Bounds = AABB();
@@ -56,9 +58,17 @@ bool Mesh::Create(gfx::Device* device,
     }
     m_VertexBuffer.Upload(vertices.data(), vbDesc.size);
     
+    // LOD ranges move behind the full mesh's indices; malformed ranges are dropped
+    m_LODs.clear();
+    m_LODs.push_back({ 0, m_IndexCount, 0.0f });
+    for (const MeshLOD& lod : lods) {
+        if (lod.indexOffset > lodIndices.size() || lod.indexCount > lodIndices.size() - lod.indexOffset) continue;
+        m_LODs.push_back({ m_IndexCount + lod.indexOffset, lod.indexCount, lod.error });
+    }
+    
     // Create index buffer
     gfx::BufferDesc ibDesc{};
-    ibDesc.size = indices.size() * sizeof(uint32_t);
+    ibDesc.size = (indices.size() + lodIndices.size()) * sizeof(uint32_t);
     ibDesc.usage = gfx::BufferUsage::Index;
     ibDesc.hostVisible = true;
     ibDesc.debugName = (name + "_IB").c_str();
@@ -67,14 +77,18 @@ bool Mesh::Create(gfx::Device* device,
         LUCENT_CORE_ERROR("Failed to create index buffer for mesh: {}", name);
         return false;
     }
-    m_IndexBuffer.Upload(indices.data(), ibDesc.size);
+    m_IndexBuffer.Upload(indices.data(), indices.size() * sizeof(uint32_t));
+    if (!lodIndices.empty()) {
+        m_IndexBuffer.Upload(lodIndices.data(), lodIndices.size() * sizeof(uint32_t), indices.size() * sizeof(uint32_t));
+    }
     
     // Default submesh covering entire mesh
     if (m_Submeshes.empty()) {
         AddSubmesh(0, m_IndexCount, 0);
     }
     
-    LUCENT_CORE_DEBUG("Created mesh '{}': {} vertices, {} indices", name, m_VertexCount, m_IndexCount);
+    LUCENT_CORE_DEBUG("Created mesh '{}': {} vertices, {} indices, {} LODs", name, m_VertexCount, m_IndexCount,
+        m_LODs.size() - 1);
     return true;
 }
 
@@ -82,6 +96,7 @@ void Mesh::Destroy() {
     m_IndexBuffer.Shutdown();
     m_VertexBuffer.Shutdown();
     m_Submeshes.clear();
+    m_LODs.clear();
     m_VertexCount = 0;
     m_IndexCount = 0;
 }
@@ -93,18 +108,34 @@ void Mesh::Bind(VkCommandBuffer cmd) const {
     vkCmdBindIndexBuffer(cmd, m_IndexBuffer.GetHandle(), 0, VK_INDEX_TYPE_UINT32);
 }
 
-void Mesh::Draw(VkCommandBuffer cmd, uint32_t instanceCount) const {
-    vkCmdDrawIndexed(cmd, m_IndexCount, instanceCount, 0, 0, 0);
+void Mesh::Draw(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod) const {
+    if (lod == 0 || lod >= m_LODs.size()) {
+        vkCmdDrawIndexed(cmd, m_IndexCount, instanceCount, 0, 0, firstInstance);
+        return;
+    }
+    const MeshLOD& range = m_LODs[lod];
+    vkCmdDrawIndexed(cmd, range.indexCount, instanceCount, range.indexOffset, 0, firstInstance);
+}
+
+uint32_t Mesh::SelectLOD(float pixelsPerUnit, float maxErrorPixels) const {
+    // Errors grow with the LOD index, so the first LOD over the budget ends the search
+    uint32_t selected = 0;
+    for (uint32_t lod = 1; lod < m_LODs.size(); lod++) {
+        if (m_LODs[lod].error * pixelsPerUnit > maxErrorPixels) break;
+        selected = lod;
+    }
+    return selected;
 }
 
 void Mesh::AddSubmesh(uint32_t indexOffset, uint32_t indexCount, uint32_t materialIndex) {
     m_Submeshes.push_back({ indexOffset, indexCount, materialIndex });
 }
 
-void Mesh::DrawSubmesh(VkCommandBuffer cmd, uint32_t submeshIndex, uint32_t instanceCount) const {
+void Mesh::DrawSubmesh(VkCommandBuffer cmd, uint32_t submeshIndex, uint32_t instanceCount,
+                       uint32_t firstInstance) const {
     if (submeshIndex >= m_Submeshes.size()) return;
     const auto& submesh = m_Submeshes[submeshIndex];
-    vkCmdDrawIndexed(cmd, submesh.indexCount, instanceCount, submesh.indexOffset, 0, 0);
+    vkCmdDrawIndexed(cmd, submesh.indexCount, instanceCount, submesh.indexOffset, 0, firstInstance);
 }
 
 // ============================================================================
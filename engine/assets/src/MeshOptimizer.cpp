@@ -0,0 +1,461 @@
+#include "lucent/assets/MeshOptimizer.h"
+#include "lucent/assets/ModelCache.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+#include "lucent/mesh/Simplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace lucent::assets {
+
+namespace MeshOptimizer {
+
+namespace {
+
+// ============================================================================
+// Cache simulation
+// ============================================================================
+
+// FIFO cache modelled with timestamps: a vertex is resident if it was (re)loaded within the last
+// cacheSize misses
+class CacheSimulator {
+public:
+    CacheSimulator(size_t vertexCount, uint32_t cacheSize)
+        : m_LoadTime(vertexCount, 0), m_CacheSize(cacheSize), m_Time(cacheSize + 1) {}
+
+    uint32_t Triangle(const uint32_t* tri) {
+        uint32_t misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (m_Time - m_LoadTime[tri[k]] > m_CacheSize) {
+                m_LoadTime[tri[k]] = m_Time++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    // Forget everything loaded so far
+    void Flush() { m_Time += m_CacheSize + 1; }
+
+private:
+    std::vector<uint32_t> m_LoadTime;
+    uint32_t m_CacheSize;
+    uint32_t m_Time;
+};
+
+// ============================================================================
+// Vertex cache (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+// ============================================================================
+
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+float VertexScore(int cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The three vertices of the last triangle score alike so its neighbours are not
+            // favoured by winding order
+            score = kLastTriangleScore;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(kCacheSize - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    // Boost vertices with few triangles left so they are finished off instead of stranded
+    score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+    return score;
+}
+
+} // namespace
+
+// ============================================================================
+// Triangle order
+// ============================================================================
+
+float ComputeACMR(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return 0.0f;
+
+    CacheSimulator cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        misses += cache.Triangle(&indices[t * 3]);
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount) {
+    LUCENT_PROFILE_FUNCTION();
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    // Vertex -> triangle adjacency; each vertex's list shrinks as its triangles are emitted
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        remaining[indices[i]]++;
+    }
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+    }
+
+    std::vector<float> vertexScore(vertexCount);
+    std::vector<int> cachePosition(vertexCount, -1);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    // The cache may briefly hold three extra entries: the triangle just emitted pushes out the
+    // oldest ones, whose scores must still be updated
+    uint32_t cache[kCacheSize + 3];
+    uint32_t newCache[kCacheSize + 3];
+    uint32_t cacheCount = 0;
+
+    size_t bestTriangle = SIZE_MAX;
+    size_t scanCursor = 0;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle == SIZE_MAX) {
+            // Nothing adjacent to the cache is left: restart from the next unemitted triangle
+            while (emitted[scanCursor]) ++scanCursor;
+            bestTriangle = scanCursor;
+        }
+
+        const uint32_t* tri = &indices[bestTriangle * 3];
+        emitted[bestTriangle] = 1;
+        output.insert(output.end(), tri, tri + 3);
+
+        uint32_t newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t v = tri[k];
+            newCache[newCount++] = v;
+
+            // Remove the triangle from the vertex's live adjacency
+            uint32_t* begin = &adjacency[adjacencyOffset[v]];
+            uint32_t* end = begin + remaining[v];
+            uint32_t* found = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+            *found = *(end - 1);
+            remaining[v]--;
+        }
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // Rescore everything that moved in or out of the cache
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            const int position = i < kCacheSize ? static_cast<int>(i) : -1;
+            cachePosition[v] = position;
+            vertexScore[v] = VertexScore(position, remaining[v]);
+        }
+
+        bestTriangle = SIZE_MAX;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            for (uint32_t a = 0; a < remaining[v]; ++a) {
+                const uint32_t t = adjacency[adjacencyOffset[v] + a];
+                const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                                    vertexScore[indices[t * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, kCacheSize);
+        std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold) {
+    LUCENT_PROFILE_FUNCTION();
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    // Hard boundaries: a triangle that misses on all three vertices starts a new strip of
+    // locality, so clusters can be reordered there at no cache cost
+    std::vector<size_t> hardStarts;
+    {
+        CacheSimulator cache(vertices.size(), kCacheSize);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (cache.Triangle(&indices[t * 3]) == 3 || t == 0) {
+                hardStarts.push_back(t);
+            }
+        }
+    }
+    hardStarts.push_back(triangleCount);
+
+    // Soft boundaries: split a hard cluster further wherever the ACMR of the prefix is still
+    // within `threshold` of the whole cluster's
+    std::vector<size_t> clusterStarts;
+    CacheSimulator cache(vertices.size(), kCacheSize);
+    for (size_t h = 0; h + 1 < hardStarts.size(); ++h) {
+        const size_t begin = hardStarts[h];
+        const size_t end = hardStarts[h + 1];
+
+        cache.Flush();
+        size_t clusterMisses = 0;
+        for (size_t t = begin; t < end; ++t) {
+            clusterMisses += cache.Triangle(&indices[t * 3]);
+        }
+        const float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.Flush();
+        size_t start = begin;
+        size_t misses = 0;
+        clusterStarts.push_back(begin);
+        for (size_t t = begin; t < end; ++t) {
+            misses += cache.Triangle(&indices[t * 3]);
+            const float acmr = static_cast<float>(misses) / static_cast<float>(t - start + 1);
+            if (t + 1 < end && acmr <= limit) {
+                clusterStarts.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                cache.Flush();
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    const size_t clusterCount = clusterStarts.size() - 1;
+
+    // Sort key: how far the cluster sits out along its own facing direction, relative to the
+    // mesh centroid. Outward-facing, outer clusters tend to occlude the rest from most views.
+    glm::vec3 meshCentroid(0.0f);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        meshCentroid += vertices[indices[i]].position;
+    }
+    meshCentroid /= static_cast<float>(triangleCount * 3);
+
+    std::vector<float> clusterKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const glm::vec3& p0 = vertices[indices[t * 3]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+            const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);   // Length: twice the area
+            const float a = glm::length(n);
+            centroid += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+        const float normalLength = glm::length(normal);
+        if (area <= 0.0f || normalLength <= 0.0f) {
+            clusterKey[c] = 0.0f;
+            continue;
+        }
+        centroid /= area;
+        clusterKey[c] = glm::dot(centroid - meshCentroid, normal / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return clusterKey[a] > clusterKey[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (uint32_t c : order) {
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+size_t OptimizeVertexFetch(std::span<Vertex> vertices, std::span<uint32_t> indices) {
+    LUCENT_PROFILE_FUNCTION();
+
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        uint32_t& target = remap[index];
+        if (target == UINT32_MAX) {
+            target = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = target;
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices.begin());
+    return reordered.size();
+}
+
+size_t Optimize(std::span<Vertex> vertices, std::span<uint32_t> indices, std::span<const Submesh> submeshes,
+                Stats* outStats) {
+    LUCENT_PROFILE_FUNCTION();
+
+    Stats stats;
+    stats.vertexCountBefore = vertices.size();
+    stats.vertexCountAfter = vertices.size();
+
+    const bool valid = indices.size() % 3 == 0 &&
+        std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); });
+    if (!valid || indices.empty()) {
+        if (!valid) {
+            LUCENT_CORE_WARN("Mesh optimisation skipped: index buffer is not a valid triangle list");
+        }
+        stats.vertexBytes = vertices.size() * sizeof(Vertex);
+        if (outStats) *outStats = stats;
+        return vertices.size();
+    }
+
+    stats.acmrBefore = ComputeACMR(indices, vertices.size());
+
+    auto optimizeRange = [&](size_t offset, size_t count) {
+        std::span<uint32_t> range = indices.subspan(offset, count - count % 3);
+        OptimizeVertexCache(range, vertices.size());
+        OptimizeOverdraw(range, vertices);
+    };
+    if (submeshes.empty()) {
+        optimizeRange(0, indices.size());
+    } else {
+        for (const Submesh& submesh : submeshes) {
+            if (submesh.indexOffset >= indices.size()) continue;
+            optimizeRange(submesh.indexOffset,
+                          std::min<size_t>(submesh.indexCount, indices.size() - submesh.indexOffset));
+        }
+    }
+
+    const size_t vertexCount = OptimizeVertexFetch(vertices, indices);
+    stats.vertexCountAfter = vertexCount;
+    stats.acmrAfter = ComputeACMR(indices, vertexCount);
+    stats.vertexBytes = vertexCount * sizeof(Vertex);
+
+    if (outStats) *outStats = stats;
+    return vertexCount;
+}
+
+Stats Optimize(ImportedMesh& mesh) {
+    Stats stats;
+    const size_t vertexCount = Optimize(mesh.vertices, mesh.indices, mesh.submeshes, &stats);
+    mesh.vertices.resize(vertexCount);
+    return stats;
+}
+
+// ============================================================================
+// Level of detail
+// ============================================================================
+
+namespace {
+
+// Meshes below this are cheap enough that LODs would not pay for their index memory
+constexpr size_t kMinLODTriangles = 256;
+// A level must drop at least this fraction of the previous level's triangles
+constexpr float kMinLODReduction = 0.1f;
+// Attribute weights relative to positions (which are normalized to the mesh extent)
+constexpr float kNormalWeight = 0.5f;
+constexpr float kUVWeight = 0.5f;
+
+} // namespace
+
+size_t GenerateLODs(ImportedMesh& mesh, uint32_t maxLODs, float maxError) {
+    LUCENT_PROFILE_FUNCTION();
+
+    mesh.lods.clear();
+    mesh.lodIndices.clear();
+    const size_t vertexCount = mesh.vertices.size();
+    const bool valid = mesh.indices.size() % 3 == 0 &&
+        std::all_of(mesh.indices.begin(), mesh.indices.end(), [&](uint32_t index) { return index < vertexCount; });
+    if (!valid || mesh.indices.size() < kMinLODTriangles * 3) return 0;
+
+    std::vector<glm::vec3> positions(vertexCount);
+    std::vector<float> attributes(vertexCount * 5);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const Vertex& vertex = mesh.vertices[v];
+        positions[v] = vertex.position;
+        float* a = &attributes[v * 5];
+        a[0] = vertex.normal.x;
+        a[1] = vertex.normal.y;
+        a[2] = vertex.normal.z;
+        a[3] = vertex.uv.x;
+        a[4] = vertex.uv.y;
+    }
+    const float weights[] = { kNormalWeight, kNormalWeight, kNormalWeight, kUVWeight, kUVWeight };
+    const float scale = lucent::mesh::Simplifier::GetScale(positions);
+
+    // Current level, one index list per submesh (or one for the whole mesh)
+    std::vector<std::vector<uint32_t>> level;
+    if (mesh.submeshes.empty()) {
+        level.emplace_back(mesh.indices);
+    } else {
+        for (const Submesh& submesh : mesh.submeshes) {
+            const size_t offset = std::min<size_t>(submesh.indexOffset, mesh.indices.size());
+            const size_t count = std::min<size_t>(submesh.indexCount, mesh.indices.size() - offset);
+            level.emplace_back(mesh.indices.begin() + offset, mesh.indices.begin() + offset + count - count % 3);
+        }
+    }
+
+    lucent::mesh::Simplifier::Options options;
+    options.targetError = maxError;
+    options.lockBorder = level.size() > 1;
+    options.attributes = attributes;
+    options.attributeWeights = weights;
+
+    size_t previousCount = mesh.indices.size();
+    float error = 0.0f;
+    std::vector<uint32_t> simplified;
+    while (mesh.lods.size() < maxLODs) {
+        // Levels chain, so each one's deviation from the full mesh is bounded by the sum
+        float levelError = 0.0f;
+        size_t count = 0;
+        for (std::vector<uint32_t>& indices : level) {
+            options.targetIndexCount = indices.size() / 6 * 3;
+            const lucent::mesh::Simplifier::Result result =
+                lucent::mesh::Simplifier::Simplify(positions, indices, simplified, options);
+            levelError = std::max(levelError, result.error);
+            indices.swap(simplified);
+            count += indices.size();
+        }
+        if (count == 0 || static_cast<float>(count) > static_cast<float>(previousCount) * (1.0f - kMinLODReduction)) {
+            break;
+        }
+
+        error += levelError * scale;
+        MeshLOD lod;
+        lod.indexOffset = static_cast<uint32_t>(mesh.lodIndices.size());
+        lod.indexCount = static_cast<uint32_t>(count);
+        lod.error = error;
+        for (const std::vector<uint32_t>& indices : level) {
+            const size_t offset = mesh.lodIndices.size();
+            mesh.lodIndices.insert(mesh.lodIndices.end(), indices.begin(), indices.end());
+            OptimizeVertexCache(std::span<uint32_t>(mesh.lodIndices).subspan(offset), vertexCount);
+        }
+        mesh.lods.push_back(lod);
+
+        previousCount = count;
+        if (count < kMinLODTriangles * 3) break;
+    }
+    return mesh.lods.size();
+}
+
+} // namespace MeshOptimizer
+
+} // namespace lucent::assets
@@ -1,31 +1,91 @@
 #include "lucent/assets/MeshRegistry.h"
+#include <utility>
 
 namespace lucent::assets {
 
 uint32_t MeshRegistry::Register(std::unique_ptr<Mesh> mesh) {
     if (!mesh) return UINT32_MAX;
     std::scoped_lock lock(m_Mutex);
-    m_Meshes.push_back(std::move(mesh));
+    m_Meshes.push_back({ std::move(mesh), 1 });
     return static_cast<uint32_t>(m_Meshes.size() - 1);
 }
 
+bool MeshRegistry::AddRef(uint32_t id) {
+    std::scoped_lock lock(m_Mutex);
+    if (id >= m_Meshes.size() || !m_Meshes[id].mesh) return false;
+    m_Meshes[id].refCount++;
+    return true;
+}
+
+void MeshRegistry::Release(uint32_t id) {
+    std::scoped_lock lock(m_Mutex);
+    if (id >= m_Meshes.size() || !m_Meshes[id].mesh) return;
+    if (--m_Meshes[id].refCount == 0) {
+        m_Retired.push_back(std::move(m_Meshes[id].mesh));
+    }
+}
+
+std::vector<std::unique_ptr<Mesh>> MeshRegistry::TakeRetired() {
+    std::scoped_lock lock(m_Mutex);
+    return std::exchange(m_Retired, {});
+}
+
+uint32_t MeshRegistry::GetRefCount(uint32_t id) const {
+    std::scoped_lock lock(m_Mutex);
+    if (id >= m_Meshes.size()) return 0;
+    return m_Meshes[id].refCount;
+}
+
 Mesh* MeshRegistry::GetMesh(uint32_t id) {
     std::scoped_lock lock(m_Mutex);
     if (id >= m_Meshes.size()) return nullptr;
-    return m_Meshes[id].get();
+    return m_Meshes[id].mesh.get();
 }
 
 const Mesh* MeshRegistry::GetMesh(uint32_t id) const {
     std::scoped_lock lock(m_Mutex);
     if (id >= m_Meshes.size()) return nullptr;
-    return m_Meshes[id].get();
+    return m_Meshes[id].mesh.get();
 }
 
 void MeshRegistry::Clear() {
     std::scoped_lock lock(m_Mutex);
     m_Meshes.clear();
+    m_Retired.clear();
 }
 
-} // namespace lucent::assets
+MeshHandle MeshHandle::Adopt(uint32_t id) {
+    MeshHandle handle;
+    handle.m_ID = id;
+    return handle;
+}
+
+MeshHandle::MeshHandle(const MeshHandle& other) : m_ID(other.m_ID) {
+    if (IsValid() && !MeshRegistry::Get().AddRef(m_ID)) m_ID = UINT32_MAX;
+}
+
+MeshHandle::MeshHandle(MeshHandle&& other) noexcept : m_ID(std::exchange(other.m_ID, UINT32_MAX)) {}
 
+MeshHandle& MeshHandle::operator=(const MeshHandle& other) {
+    if (this != &other) {
+        // Reference the new mesh first so assigning a handle to the same mesh never retires it
+        MeshHandle copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
 
+MeshHandle& MeshHandle::operator=(MeshHandle&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        m_ID = std::exchange(other.m_ID, UINT32_MAX);
+    }
+    return *this;
+}
+
+void MeshHandle::Reset() {
+    if (IsValid()) MeshRegistry::Get().Release(m_ID);
+    m_ID = UINT32_MAX;
+}
+
+} // namespace lucent::assets
@@ -0,0 +1,494 @@
+#include "lucent/assets/ModelCache.h"
+#include "lucent/assets/ModelLoader.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+
+namespace lucent::assets {
+namespace ModelCache {
+
+static_assert(std::endian::native == std::endian::little, "Model cache format assumes a little-endian host");
+static_assert(std::is_trivially_copyable_v<Vertex> && std::is_trivially_copyable_v<Submesh>,
+    "Mesh arrays are mapped directly");
+static_assert(std::is_trivially_copyable_v<MeshRecord> && std::is_trivially_copyable_v<NodeRecord>);
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Sequential writer that tracks the file offset and pads to section boundaries
+class SectionWriter {
+public:
+    explicit SectionWriter(std::ofstream& out) : m_Out(out) {}
+
+    void Write(const void* data, size_t size) {
+        if (size == 0) return;
+        m_Out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        m_Offset += size;
+    }
+
+    template<typename T>
+    void WriteArray(std::span<const T> values) {
+        Write(values.data(), values.size_bytes());
+    }
+
+    void PadTo(uint64_t alignment) {
+        static constexpr char kZeros[kSectionAlignment] = {};
+        const uint64_t target = AlignUp(m_Offset, alignment);
+        Write(kZeros, static_cast<size_t>(target - m_Offset));
+    }
+
+    uint64_t Offset() const { return m_Offset; }
+
+private:
+    std::ofstream& m_Out;
+    uint64_t m_Offset = 0;
+};
+
+void CopyFloats(float* dst, const float* src, size_t count) {
+    std::memcpy(dst, src, count * sizeof(float));
+}
+
+} // namespace
+
+// ============================================================================
+// Paths
+// ============================================================================
+
+std::string GetCachePath(const std::string& cacheDirectory, uint64_t sourceHash, uint64_t settingsHash) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "%016llx_%016llx.lmc",
+        static_cast<unsigned long long>(sourceHash), static_cast<unsigned long long>(settingsHash));
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+bool Write(const std::string& path, uint64_t sourceHash, uint64_t settingsHash,
+           std::span<const ImportedMesh> meshes, const Model& model, std::string& error) {
+    LUCENT_PROFILE_FUNCTION();
+
+    std::string strings;
+    auto addString = [&strings](const std::string& s) {
+        StringRef ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size()) };
+        strings += s;
+        return ref;
+    };
+
+    std::vector<MeshRecord> meshRecords;
+    meshRecords.reserve(meshes.size());
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    uint32_t submeshCount = 0;
+    uint64_t lodIndexCount = 0;
+    uint32_t lodCount = 0;
+    for (const ImportedMesh& mesh : meshes) {
+        MeshRecord record{};
+        record.name = addString(mesh.name);
+        record.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        record.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        record.firstVertex = vertexCount;
+        record.firstIndex = indexCount;
+        record.firstSubmesh = submeshCount;
+        record.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+        record.firstLODIndex = lodIndexCount;
+        record.lodIndexCount = static_cast<uint32_t>(mesh.lodIndices.size());
+        record.firstLOD = lodCount;
+        record.lodCount = static_cast<uint32_t>(mesh.lods.size());
+        vertexCount += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+        submeshCount += record.submeshCount;
+        lodIndexCount += mesh.lodIndices.size();
+        lodCount += record.lodCount;
+        meshRecords.push_back(record);
+    }
+
+    std::vector<MaterialRecord> materials;
+    materials.reserve(model.materials.size());
+    for (const MaterialData& material : model.materials) {
+        MaterialRecord record{};
+        record.name = addString(material.name);
+        CopyFloats(record.baseColorFactor, &material.baseColorFactor.x, 4);
+        record.metallicFactor = material.metallicFactor;
+        record.roughnessFactor = material.roughnessFactor;
+        record.baseColorTexture = material.baseColorTexture;
+        record.metallicRoughnessTexture = material.metallicRoughnessTexture;
+        record.normalTexture = material.normalTexture;
+        record.occlusionTexture = material.occlusionTexture;
+        record.emissiveTexture = material.emissiveTexture;
+        CopyFloats(record.emissiveFactor, &material.emissiveFactor.x, 3);
+        record.alphaMode = static_cast<uint32_t>(material.alphaMode);
+        record.alphaCutoff = material.alphaCutoff;
+        record.doubleSided = material.doubleSided ? 1u : 0u;
+        materials.push_back(record);
+    }
+
+    std::vector<CameraRecord> cameras;
+    cameras.reserve(model.cameras.size());
+    for (const CameraData& camera : model.cameras) {
+        CameraRecord record{};
+        record.name = addString(camera.name);
+        record.perspective = camera.perspective ? 1u : 0u;
+        record.fov = camera.fov;
+        record.orthoSize = camera.orthoSize;
+        record.nearClip = camera.nearClip;
+        record.farClip = camera.farClip;
+        record.aspectRatio = camera.aspectRatio;
+        cameras.push_back(record);
+    }
+
+    std::vector<LightRecord> lights;
+    lights.reserve(model.lights.size());
+    for (const LightData& light : model.lights) {
+        LightRecord record{};
+        record.name = addString(light.name);
+        record.type = static_cast<uint32_t>(light.type);
+        CopyFloats(record.color, &light.color.x, 3);
+        record.intensity = light.intensity;
+        record.range = light.range;
+        record.innerAngle = light.innerAngle;
+        record.outerAngle = light.outerAngle;
+        lights.push_back(record);
+    }
+
+    std::vector<NodeRecord> nodes;
+    std::vector<uint32_t> children;
+    nodes.reserve(model.nodes.size());
+    for (const NodeData& node : model.nodes) {
+        NodeRecord record{};
+        record.name = addString(node.name);
+        for (int column = 0; column < 4; ++column) {
+            CopyFloats(record.localTransform + column * 4, &node.localTransform[column].x, 4);
+        }
+        record.meshIndex = node.meshIndex;
+        record.cameraIndex = node.cameraIndex;
+        record.lightIndex = node.lightIndex;
+        record.firstChild = static_cast<uint32_t>(children.size());
+        record.childCount = static_cast<uint32_t>(node.children.size());
+        children.insert(children.end(), node.children.begin(), node.children.end());
+        nodes.push_back(record);
+    }
+
+    std::error_code ec;
+    const std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    const std::filesystem::path tempPath = target.string() + ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "Failed to open file for writing: " + tempPath.string();
+            return false;
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.vertexSize = sizeof(Vertex);
+        header.sourceHash = sourceHash;
+        header.settingsHash = settingsHash;
+
+        // Header is rewritten once the section table is known
+        SectionWriter writer(out);
+        writer.Write(&header, sizeof(header));
+
+        auto beginSection = [&](Section section) {
+            writer.PadTo(kSectionAlignment);
+            header.sections[static_cast<uint32_t>(section)].offset = writer.Offset();
+        };
+        auto endSection = [&](Section section) {
+            SectionEntry& entry = header.sections[static_cast<uint32_t>(section)];
+            entry.size = writer.Offset() - entry.offset;
+        };
+
+        beginSection(Section::Strings);
+        writer.Write(strings.data(), strings.size());
+        endSection(Section::Strings);
+
+        beginSection(Section::Meshes);
+        writer.WriteArray(std::span<const MeshRecord>(meshRecords));
+        endSection(Section::Meshes);
+
+        beginSection(Section::Submeshes);
+        for (const ImportedMesh& mesh : meshes) writer.WriteArray(std::span<const Submesh>(mesh.submeshes));
+        endSection(Section::Submeshes);
+
+        beginSection(Section::Vertices);
+        for (const ImportedMesh& mesh : meshes) writer.WriteArray(std::span<const Vertex>(mesh.vertices));
+        endSection(Section::Vertices);
+
+        beginSection(Section::Indices);
+        for (const ImportedMesh& mesh : meshes) writer.WriteArray(std::span<const uint32_t>(mesh.indices));
+        endSection(Section::Indices);
+
+        beginSection(Section::Materials);
+        writer.WriteArray(std::span<const MaterialRecord>(materials));
+        endSection(Section::Materials);
+
+        beginSection(Section::Cameras);
+        writer.WriteArray(std::span<const CameraRecord>(cameras));
+        endSection(Section::Cameras);
+
+        beginSection(Section::Lights);
+        writer.WriteArray(std::span<const LightRecord>(lights));
+        endSection(Section::Lights);
+
+        beginSection(Section::Nodes);
+        writer.WriteArray(std::span<const NodeRecord>(nodes));
+        endSection(Section::Nodes);
+
+        beginSection(Section::NodeChildren);
+        writer.WriteArray(std::span<const uint32_t>(children));
+        endSection(Section::NodeChildren);
+
+        beginSection(Section::RootNodes);
+        writer.WriteArray(std::span<const uint32_t>(model.rootNodes));
+        endSection(Section::RootNodes);
+
+        beginSection(Section::LODs);
+        for (const ImportedMesh& mesh : meshes) writer.WriteArray(std::span<const MeshLOD>(mesh.lods));
+        endSection(Section::LODs);
+
+        beginSection(Section::LODIndices);
+        for (const ImportedMesh& mesh : meshes) writer.WriteArray(std::span<const uint32_t>(mesh.lodIndices));
+        endSection(Section::LODIndices);
+
+        header.fileSize = writer.Offset();
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (!out) {
+            error = "Failed to write model cache: " + tempPath.string();
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, target, ec);
+    if (ec) {
+        error = "Failed to replace model cache: " + ec.message();
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    LUCENT_CORE_DEBUG("Wrote model cache '{}': {} meshes, {} vertices, {} indices", path, meshes.size(),
+        vertexCount, indexCount);
+    return true;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+bool Reader::Open(const std::string& path, uint64_t sourceHash, uint64_t settingsHash, std::string& error) {
+    Close();
+
+    if (!m_File.Open(path)) {
+        error = "Failed to open file: " + path;
+        return false;
+    }
+
+    const std::byte* base = m_File.Data();
+    const uint64_t size = m_File.Size();
+
+    auto fail = [&](const std::string& message) {
+        error = message + ": " + path;
+        Close();
+        return false;
+    };
+
+    if (size < sizeof(FileHeader)) {
+        return fail("Truncated model cache");
+    }
+    m_Header = reinterpret_cast<const FileHeader*>(base);
+    if (std::memcmp(m_Header->magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail("Not a model cache file");
+    }
+    if (m_Header->version != kVersion || m_Header->vertexSize != sizeof(Vertex)) {
+        return fail("Unsupported model cache version " + std::to_string(m_Header->version));
+    }
+    if (m_Header->sourceHash != sourceHash || m_Header->settingsHash != settingsHash) {
+        return fail("Model cache is stale");
+    }
+    if (m_Header->fileSize != size) {
+        return fail("Corrupt model cache header");
+    }
+    for (const SectionEntry& entry : m_Header->sections) {
+        if (entry.offset % kSectionAlignment != 0 || entry.offset > size || entry.size > size - entry.offset) {
+            return fail("Corrupt model cache section table");
+        }
+    }
+
+    m_Strings = GetSection<char>(Section::Strings);
+    m_Meshes = GetSection<MeshRecord>(Section::Meshes);
+
+    // Validate every range up front so the accessors never read outside the mapping
+    const size_t submeshCount = GetSection<Submesh>(Section::Submeshes).size();
+    const size_t vertexCount = GetSection<Vertex>(Section::Vertices).size();
+    const size_t indexCount = GetSection<uint32_t>(Section::Indices).size();
+    const size_t lodCount = GetSection<MeshLOD>(Section::LODs).size();
+    const size_t lodIndexCount = GetSection<uint32_t>(Section::LODIndices).size();
+    for (const MeshRecord& mesh : m_Meshes) {
+        if (mesh.firstVertex > vertexCount || mesh.vertexCount > vertexCount - mesh.firstVertex ||
+            mesh.firstIndex > indexCount || mesh.indexCount > indexCount - mesh.firstIndex ||
+            mesh.firstSubmesh > submeshCount || mesh.submeshCount > submeshCount - mesh.firstSubmesh ||
+            mesh.firstLOD > lodCount || mesh.lodCount > lodCount - mesh.firstLOD ||
+            mesh.firstLODIndex > lodIndexCount || mesh.lodIndexCount > lodIndexCount - mesh.firstLODIndex) {
+            return fail("Corrupt model cache mesh table");
+        }
+        const MeshView view = GetMesh(static_cast<uint32_t>(&mesh - m_Meshes.data()));
+        for (uint32_t index : view.indices) {
+            if (index >= mesh.vertexCount) return fail("Model cache index out of range");
+        }
+        for (uint32_t index : view.lodIndices) {
+            if (index >= mesh.vertexCount) return fail("Model cache index out of range");
+        }
+        for (const MeshLOD& lod : view.lods) {
+            if (lod.indexOffset > mesh.lodIndexCount || lod.indexCount > mesh.lodIndexCount - lod.indexOffset) {
+                return fail("Corrupt model cache LOD table");
+            }
+        }
+        for (const Submesh& submesh : view.submeshes) {
+            if (submesh.indexOffset > mesh.indexCount || submesh.indexCount > mesh.indexCount - submesh.indexOffset) {
+                return fail("Corrupt model cache submesh table");
+            }
+        }
+    }
+
+    const std::span<const NodeRecord> nodes = GetSection<NodeRecord>(Section::Nodes);
+    const std::span<const uint32_t> children = GetSection<uint32_t>(Section::NodeChildren);
+    // -1 means the node has none
+    auto validIndex = [](int32_t index, size_t count) {
+        return index == -1 || (index >= 0 && static_cast<size_t>(index) < count);
+    };
+    const size_t cameraCount = GetSection<CameraRecord>(Section::Cameras).size();
+    const size_t lightCount = GetSection<LightRecord>(Section::Lights).size();
+    for (const NodeRecord& node : nodes) {
+        if (node.firstChild > children.size() || node.childCount > children.size() - node.firstChild ||
+            !validIndex(node.meshIndex, m_Meshes.size()) || !validIndex(node.cameraIndex, cameraCount) ||
+            !validIndex(node.lightIndex, lightCount)) {
+            return fail("Corrupt model cache node table");
+        }
+    }
+    for (uint32_t child : children) {
+        if (child >= nodes.size()) return fail("Model cache node link out of range");
+    }
+    for (uint32_t root : GetSection<uint32_t>(Section::RootNodes)) {
+        if (root >= nodes.size()) return fail("Model cache root node out of range");
+    }
+    return true;
+}
+
+void Reader::Close() {
+    m_File.Close();
+    m_Header = nullptr;
+    m_Strings = {};
+    m_Meshes = {};
+}
+
+template<typename T>
+std::span<const T> Reader::GetSection(Section section) const {
+    const SectionEntry& entry = m_Header->sections[static_cast<uint32_t>(section)];
+    return { reinterpret_cast<const T*>(m_File.Data() + entry.offset), static_cast<size_t>(entry.size / sizeof(T)) };
+}
+
+std::string_view Reader::GetString(const StringRef& ref) const {
+    if (ref.offset > m_Strings.size() || ref.length > m_Strings.size() - ref.offset) {
+        return {};
+    }
+    return { m_Strings.data() + ref.offset, ref.length };
+}
+
+MeshView Reader::GetMesh(uint32_t index) const {
+    const MeshRecord& record = m_Meshes[index];
+    MeshView view;
+    view.name = GetString(record.name);
+    view.vertices = GetSection<Vertex>(Section::Vertices).subspan(record.firstVertex, record.vertexCount);
+    view.indices = GetSection<uint32_t>(Section::Indices).subspan(record.firstIndex, record.indexCount);
+    view.submeshes = GetSection<Submesh>(Section::Submeshes).subspan(record.firstSubmesh, record.submeshCount);
+    view.lodIndices = GetSection<uint32_t>(Section::LODIndices).subspan(record.firstLODIndex, record.lodIndexCount);
+    view.lods = GetSection<MeshLOD>(Section::LODs).subspan(record.firstLOD, record.lodCount);
+    return view;
+}
+
+void Reader::ReadModelInfo(Model& model) const {
+    for (const MaterialRecord& record : GetSection<MaterialRecord>(Section::Materials)) {
+        MaterialData material;
+        material.name = std::string(GetString(record.name));
+        std::memcpy(&material.baseColorFactor.x, record.baseColorFactor, sizeof(record.baseColorFactor));
+        material.metallicFactor = record.metallicFactor;
+        material.roughnessFactor = record.roughnessFactor;
+        material.baseColorTexture = record.baseColorTexture;
+        material.metallicRoughnessTexture = record.metallicRoughnessTexture;
+        material.normalTexture = record.normalTexture;
+        material.occlusionTexture = record.occlusionTexture;
+        material.emissiveTexture = record.emissiveTexture;
+        std::memcpy(&material.emissiveFactor.x, record.emissiveFactor, sizeof(record.emissiveFactor));
+        material.alphaMode = record.alphaMode <= static_cast<uint32_t>(MaterialData::AlphaMode::Blend)
+            ? static_cast<MaterialData::AlphaMode>(record.alphaMode)
+            : MaterialData::AlphaMode::Opaque;
+        material.alphaCutoff = record.alphaCutoff;
+        material.doubleSided = record.doubleSided != 0;
+        model.materials.push_back(std::move(material));
+    }
+
+    for (const CameraRecord& record : GetSection<CameraRecord>(Section::Cameras)) {
+        CameraData camera;
+        camera.name = std::string(GetString(record.name));
+        camera.perspective = record.perspective != 0;
+        camera.fov = record.fov;
+        camera.orthoSize = record.orthoSize;
+        camera.nearClip = record.nearClip;
+        camera.farClip = record.farClip;
+        camera.aspectRatio = record.aspectRatio;
+        model.cameras.push_back(std::move(camera));
+    }
+
+    for (const LightRecord& record : GetSection<LightRecord>(Section::Lights)) {
+        LightData light;
+        light.name = std::string(GetString(record.name));
+        light.type = record.type <= static_cast<uint32_t>(LightData::Type::Spot)
+            ? static_cast<LightData::Type>(record.type)
+            : LightData::Type::Point;
+        std::memcpy(&light.color.x, record.color, sizeof(record.color));
+        light.intensity = record.intensity;
+        light.range = record.range;
+        light.innerAngle = record.innerAngle;
+        light.outerAngle = record.outerAngle;
+        model.lights.push_back(std::move(light));
+    }
+
+    const std::span<const uint32_t> children = GetSection<uint32_t>(Section::NodeChildren);
+    for (const NodeRecord& record : GetSection<NodeRecord>(Section::Nodes)) {
+        NodeData node;
+        node.name = std::string(GetString(record.name));
+        for (int column = 0; column < 4; ++column) {
+            std::memcpy(&node.localTransform[column].x, record.localTransform + column * 4, 4 * sizeof(float));
+        }
+        node.meshIndex = record.meshIndex;
+        node.cameraIndex = record.cameraIndex;
+        node.lightIndex = record.lightIndex;
+        const auto nodeChildren = children.subspan(record.firstChild, record.childCount);
+        node.children.assign(nodeChildren.begin(), nodeChildren.end());
+        model.nodes.push_back(std::move(node));
+    }
+
+    const std::span<const uint32_t> roots = GetSection<uint32_t>(Section::RootNodes);
+    model.rootNodes.assign(roots.begin(), roots.end());
+}
+
+} // namespace ModelCache
+} // namespace lucent::assets
@@ -1,7 +1,10 @@
 #include "lucent/assets/ModelLoader.h"
+#include "lucent/assets/ModelCache.h"
+#include "lucent/assets/MeshOptimizer.h"
+#include "lucent/core/JobSystem.h"
 #include "lucent/core/Log.h"
-
-#include <stb_image.h>
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,11 +14,17 @@
 #include <assimp/postprocess.h>
 
 #define TINYGLTF_IMPLEMENTATION
-#define TINYGLTF_NO_STB_IMAGE        // We already have stb_image in Texture.cpp
+#define TINYGLTF_NO_STB_IMAGE        // Images are decoded by the TextureCache workers
 #define TINYGLTF_NO_STB_IMAGE_WRITE
 #include <tiny_gltf.h>
+#include <nlohmann/json.hpp>
 
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace lucent::assets {
 
@@ -39,55 +48,554 @@ static glm::vec3 SafeNormalize(const glm::vec3& v) {
     return v / len;
 }
 
-// Helper to load image data for tinygltf using our own stb_image
+// Shared between the tinygltf image callback and the texture loop so both derive the same cache keys
+struct GLTFImageContext {
+    std::string modelPath;
+    std::string baseDir;
+    uint64_t modelVersion = 0;
+    // Images the TextureCache already holds; pinned here so they cannot be evicted before use
+    std::unordered_map<int, gfx::TextureHandle> cached;
+    // Still-encoded bytes of the others, decoded on worker threads once requested
+    std::unordered_map<int, std::vector<uint8_t>> encoded;
+    // GLB images tinygltf only sees a placeholder for; read from the mapping after parsing
+    std::unordered_set<int> deferred;
+};
+
+// External images are keyed by their own file so models sharing a texture share the upload;
+// embedded ones by model and image index, invalidated when the model file changes
+static std::string GetImageCacheKey(const GLTFImageContext& context, const tinygltf::Image& image,
+                                    int imageIndex, uint64_t& outVersion) {
+    if (!image.uri.empty()) {
+        std::string path = context.baseDir + image.uri;
+        outVersion = gfx::TextureCache::GetFileVersion(path);
+        return "gltf:" + path;
+    }
+    outVersion = context.modelVersion;
+    return "gltf:" + context.modelPath + "#image" + std::to_string(imageIndex);
+}
+
+// Image callback for tinygltf: keeps the encoded bytes instead of decoding on the loading thread
 static bool LoadImageData(tinygltf::Image* image, const int image_idx, std::string* err,
                           std::string* warn, int req_width, int req_height,
                           const unsigned char* bytes, int size, void* user_data) {
-    (void)image_idx;
     (void)warn;
     (void)req_width;
     (void)req_height;
-    (void)user_data;
     
-    int width, height, channels;
-    unsigned char* data = stbi_load_from_memory(bytes, size, &width, &height, &channels, 4);
-    
-    if (!data) {
+    auto* context = static_cast<GLTFImageContext*>(user_data);
+    if (context->deferred.contains(image_idx)) {
+        return true;
+    }
+    if (!bytes || size <= 0) {
         if (err) {
-            *err = "Failed to load image: " + std::string(stbi_failure_reason());
+            *err = "Failed to load image: no data";
         }
         return false;
     }
     
-    image->width = width;
-    image->height = height;
-    image->component = 4;
-    image->bits = 8;
-    image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
-    image->image.resize(width * height * 4);
-    memcpy(image->image.data(), data, width * height * 4);
+    // Skip copying images whose upload is already cached
+    uint64_t version = 0;
+    const std::string key = GetImageCacheKey(*context, *image, image_idx, version);
+    gfx::TextureCache& cache = gfx::TextureCache::Get();
+    if (cache.Contains(key, version, gfx::TextureColorSpace::sRGB)) {
+        context->cached[image_idx] = cache.AcquireFromPixels(key, version, gfx::TextureColorSpace::sRGB, nullptr, 0, 0);
+        return true;
+    }
     
-    stbi_image_free(data);
+    context->encoded[image_idx].assign(bytes, bytes + size);
     return true;
 }
 
-std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::string& path) {
-    tinygltf::Model gltfModel;
+// Image callback for geometry-only loads: images are neither kept nor decoded
+static bool SkipImageData(tinygltf::Image*, const int, std::string*, std::string*, int, int,
+                          const unsigned char*, int, void*) {
+    return true;
+}
+
+// ============================================================================
+// GLB memory mapping
+// ============================================================================
+
+static constexpr uint32_t kGLBMagic = 0x46546C67;       // "glTF"
+static constexpr uint32_t kGLBChunkJSON = 0x4E4F534A;   // "JSON"
+static constexpr uint32_t kGLBChunkBIN = 0x004E4942;    // "BIN\0"
+
+// One-byte stand-ins handed to tinygltf for data it would otherwise copy out of the GLB
+static constexpr const char* kPlaceholderBufferURI = "data:application/octet-stream;base64,AA==";
+static constexpr const char* kPlaceholderImageURI = "data:image/png;base64,AA==";
+
+// A parsed glTF plus the bytes each of its buffers lives in. For GLB files the BIN chunk is
+// read in place from a memory mapping instead of being copied into tinygltf::Buffer::data.
+struct GLTFDocument {
+    tinygltf::Model model;
+    std::vector<std::span<const uint8_t>> buffers;
+    MappedFile mapping;
+};
+
+// tinygltf's GLB loader reads the whole file and then copies the BIN chunk again. Instead, map
+// the file and give tinygltf only the JSON chunk, with the BIN buffer and the images stored in
+// it replaced by placeholders; accessors then read the mapping directly.
+static bool LoadGLBMapped(tinygltf::TinyGLTF& loader, const std::string& path, const std::string& baseDir,
+                          GLTFDocument& document, GLTFImageContext* imageContext,
+                          std::string& err, std::string& warn) {
+    LUCENT_PROFILE_FUNCTION();
+    if (!document.mapping.Open(path)) {
+        err = "Failed to map " + path;
+        return false;
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(document.mapping.Data());
+    size_t size = document.mapping.Size();
+
+    auto readU32 = [&](size_t offset) {
+        uint32_t value = 0;
+        std::memcpy(&value, bytes + offset, sizeof(value));
+        return value;
+    };
+
+    // 12-byte header, then 8-byte chunk headers; the JSON chunk always comes first
+    if (size < 20 || readU32(0) != kGLBMagic || readU32(4) != 2) {
+        err = "Not a glTF 2.0 binary file: " + path;
+        return false;
+    }
+    size = std::min<size_t>(size, readU32(8));
+    const size_t jsonLength = readU32(12);
+    if (readU32(16) != kGLBChunkJSON || jsonLength > size - 20) {
+        err = "Invalid GLB JSON chunk: " + path;
+        return false;
+    }
+
+    std::span<const uint8_t> binChunk;
+    const size_t binOffset = 20 + ((jsonLength + 3) & ~size_t(3));
+    if (binOffset + 8 <= size && readU32(binOffset + 4) == kGLBChunkBIN) {
+        const size_t binLength = readU32(binOffset);
+        if (binLength > size - binOffset - 8) {
+            err = "Invalid GLB BIN chunk: " + path;
+            return false;
+        }
+        binChunk = { bytes + binOffset + 8, binLength };
+    }
+
+    auto json = nlohmann::json::parse(bytes + 20, bytes + 20 + jsonLength, nullptr, false);
+    if (json.is_discarded() || !json.is_object()) {
+        err = "Invalid GLB JSON: " + path;
+        return false;
+    }
+
+    // The GLB-stored buffer is the first one, and the only one allowed to have no uri
+    bool hasBinBuffer = false;
+    size_t binByteLength = 0;
+    auto buffers = json.find("buffers");
+    if (buffers != json.end() && buffers->is_array() && !buffers->empty() &&
+        (*buffers)[0].is_object() && !(*buffers)[0].contains("uri")) {
+        auto& binBuffer = (*buffers)[0];
+        binByteLength = binBuffer.value("byteLength", size_t(0));
+        if (binByteLength > binChunk.size()) {
+            err = "GLB buffer is larger than its BIN chunk: " + path;
+            return false;
+        }
+        binBuffer["uri"] = kPlaceholderBufferURI;
+        binBuffer["byteLength"] = 1;
+        hasBinBuffer = true;
+    }
+
+    struct DeferredImage {
+        int index;
+        int bufferView;
+        std::string mimeType;
+    };
+    std::vector<DeferredImage> deferredImages;
+    auto images = json.find("images");
+    auto bufferViews = json.find("bufferViews");
+    if (hasBinBuffer && images != json.end() && images->is_array() &&
+        bufferViews != json.end() && bufferViews->is_array()) {
+        for (size_t i = 0; i < images->size(); i++) {
+            auto& image = (*images)[i];
+            if (!image.is_object() || !image.contains("bufferView") || !image["bufferView"].is_number_integer()) continue;
+            const int view = image["bufferView"].get<int>();
+            if (view < 0 || view >= static_cast<int>(bufferViews->size())) continue;
+            if ((*bufferViews)[view].value("buffer", -1) != 0) continue;
+
+            deferredImages.push_back({ static_cast<int>(i), view, image.value("mimeType", std::string()) });
+            image.erase("bufferView");
+            image["uri"] = kPlaceholderImageURI;
+            if (imageContext) imageContext->deferred.insert(static_cast<int>(i));
+        }
+    }
+
+    const std::string text = json.dump();
+    if (!loader.LoadASCIIFromString(&document.model, &err, &warn, text.c_str(),
+                                    static_cast<unsigned int>(text.size()), baseDir)) {
+        return false;
+    }
+
+    document.buffers.clear();
+    for (const auto& buffer : document.model.buffers) {
+        document.buffers.emplace_back(buffer.data.data(), buffer.data.size());
+    }
+    if (hasBinBuffer) {
+        auto& binBuffer = document.model.buffers[0];
+        binBuffer.uri.clear();
+        binBuffer.data.clear();
+        document.buffers[0] = binChunk.first(binByteLength);
+    }
+
+    // Restore the deferred images and hand their bytes over straight from the mapping
+    for (const DeferredImage& deferred : deferredImages) {
+        tinygltf::Image& image = document.model.images[deferred.index];
+        image.uri.clear();
+        image.bufferView = deferred.bufferView;
+        image.mimeType = deferred.mimeType;
+        if (!imageContext) continue;
+
+        imageContext->deferred.erase(deferred.index);
+        const auto& view = document.model.bufferViews[deferred.bufferView];
+        if (view.byteOffset > document.buffers[0].size() || view.byteLength > document.buffers[0].size() - view.byteOffset) {
+            warn += "Image " + std::to_string(deferred.index) + " bufferView is out of range\n";
+            continue;
+        }
+        std::string imageErr;
+        if (!LoadImageData(&image, deferred.index, &imageErr, &warn, 0, 0,
+                           document.buffers[0].data() + view.byteOffset, static_cast<int>(view.byteLength),
+                           imageContext)) {
+            warn += imageErr + "\n";
+        }
+    }
+    return true;
+}
+
+// Parse a .gltf or .glb. Images go to LoadImageData when a context is given, otherwise skipped.
+static bool LoadGLTFDocument(const std::string& path, GLTFDocument& document, GLTFImageContext* imageContext,
+                             std::string& err, std::string& warn) {
     tinygltf::TinyGLTF loader;
-    std::string err, warn;
-    
-    // Set custom image loader
-    loader.SetImageLoader(LoadImageData, nullptr);
-    
+    if (imageContext) {
+        loader.SetImageLoader(LoadImageData, imageContext);
+    } else {
+        loader.SetImageLoader(SkipImageData, nullptr);
+    }
+
     std::filesystem::path filePath(path);
+    std::string baseDir = filePath.parent_path().string();
     std::string extension = filePath.extension().string();
-    
-    bool success = false;
+
     if (extension == ".glb" || extension == ".GLB") {
-        success = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, path);
+        return LoadGLBMapped(loader, path, baseDir, document, imageContext, err, warn);
+    }
+
+    if (!loader.LoadASCIIFromFile(&document.model, &err, &warn, path)) {
+        return false;
+    }
+    document.buffers.clear();
+    for (const auto& buffer : document.model.buffers) {
+        document.buffers.emplace_back(buffer.data.data(), buffer.data.size());
+    }
+    return true;
+}
+
+// Strided view of one accessor's elements inside its buffer
+struct AccessorView {
+    const uint8_t* data = nullptr;
+    size_t stride = 0;
+    size_t count = 0;
+    int componentType = 0;
+
+    bool IsValid() const { return data != nullptr; }
+    const uint8_t* Element(size_t i) const { return data + i * stride; }
+};
+
+// Empty view if the accessor is missing, sparse-only or runs past the end of its buffer
+static AccessorView GetAccessorView(const GLTFDocument& document, int accessorIndex) {
+    const tinygltf::Model& gltfModel = document.model;
+    AccessorView view;
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(gltfModel.accessors.size())) return view;
+    const auto& accessor = gltfModel.accessors[accessorIndex];
+    if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(gltfModel.bufferViews.size())) return view;
+    const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
+    if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(document.buffers.size())) return view;
+    const std::span<const uint8_t> buffer = document.buffers[bufferView.buffer];
+
+    const int stride = accessor.ByteStride(bufferView);
+    const int elementSize = tinygltf::GetComponentSizeInBytes(accessor.componentType) *
+                            tinygltf::GetNumComponentsInType(accessor.type);
+    if (stride <= 0 || elementSize <= 0) return view;
+
+    const size_t start = bufferView.byteOffset + accessor.byteOffset;
+    if (accessor.count > 0 &&
+        start + (accessor.count - 1) * static_cast<size_t>(stride) + static_cast<size_t>(elementSize) > buffer.size()) {
+        return view;
+    }
+
+    view.data = buffer.data() + start;
+    view.stride = static_cast<size_t>(stride);
+    view.count = accessor.count;
+    view.componentType = accessor.componentType;
+    return view;
+}
+
+static AccessorView GetAttributeView(const GLTFDocument& document, const tinygltf::Primitive& prim,
+                                     const char* name, size_t vertexCount) {
+    auto it = prim.attributes.find(name);
+    if (it == prim.attributes.end()) return {};
+    AccessorView view = GetAccessorView(document, it->second);
+    // Only float attributes are read; quantized ones fall back to defaults
+    if (view.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || view.count < vertexCount) return {};
+    return view;
+}
+
+// Per-triangle UV tangents accumulated per vertex, then Gram-Schmidt against the normal
+static void GenerateTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices) {
+    std::vector<glm::vec3> tangents(vertices.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> bitangents(vertices.size(), glm::vec3(0.0f));
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) continue;
+        const Vertex& v0 = vertices[i0];
+        const Vertex& v1 = vertices[i1];
+        const Vertex& v2 = vertices[i2];
+
+        const glm::vec3 e1 = v1.position - v0.position;
+        const glm::vec3 e2 = v2.position - v0.position;
+        const glm::vec2 d1 = v1.uv - v0.uv;
+        const glm::vec2 d2 = v2.uv - v0.uv;
+        const float det = d1.x * d2.y - d2.x * d1.y;
+        if (std::abs(det) < 1e-12f) continue;
+
+        const float r = 1.0f / det;
+        const glm::vec3 t = (e1 * d2.y - e2 * d1.y) * r;
+        const glm::vec3 b = (e2 * d1.x - e1 * d2.x) * r;
+        for (uint32_t index : { i0, i1, i2 }) {
+            tangents[index] += t;
+            bitangents[index] += b;
+        }
+    }
+
+    for (size_t v = 0; v < vertices.size(); v++) {
+        const glm::vec3 n = vertices[v].normal;
+        const glm::vec3 t = tangents[v] - n * glm::dot(n, tangents[v]);
+        if (glm::dot(t, t) < 1e-20f) {
+            vertices[v].tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+            continue;
+        }
+        const float handedness = glm::dot(glm::cross(n, t), bitangents[v]) < 0.0f ? -1.0f : 1.0f;
+        vertices[v].tangent = glm::vec4(glm::normalize(t), handedness);
+    }
+}
+
+// One triangle primitive, converted on a worker into its slice of the owning mesh
+struct GLTFPrimitiveJob {
+    ImportedMesh* mesh = nullptr;
+    size_t vertexOffset = 0;
+    size_t vertexCount = 0;
+    size_t indexOffset = 0;
+    size_t indexCount = 0;
+    AccessorView positions;
+    AccessorView normals;
+    AccessorView texcoords;
+    AccessorView tangents;
+    AccessorView indices;   // Invalid: non-indexed, triangles are consecutive vertices
+};
+
+static void ConvertGLTFPrimitive(const GLTFPrimitiveJob& job) {
+    std::span<Vertex> vertices(job.mesh->vertices.data() + job.vertexOffset, job.vertexCount);
+    std::span<uint32_t> indices(job.mesh->indices.data() + job.indexOffset, job.indexCount);
+
+    for (size_t v = 0; v < job.vertexCount; v++) {
+        Vertex& vertex = vertices[v];
+        const float* p = reinterpret_cast<const float*>(job.positions.Element(v));
+        vertex.position = glm::vec3(p[0], p[1], p[2]);
+
+        if (job.normals.IsValid()) {
+            const float* n = reinterpret_cast<const float*>(job.normals.Element(v));
+            vertex.normal = glm::vec3(n[0], n[1], n[2]);
+        } else {
+            vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+
+        if (job.texcoords.IsValid()) {
+            const float* uv = reinterpret_cast<const float*>(job.texcoords.Element(v));
+            vertex.uv = glm::vec2(uv[0], uv[1]);
+        } else {
+            vertex.uv = glm::vec2(0.0f);
+        }
+
+        if (job.tangents.IsValid()) {
+            const float* t = reinterpret_cast<const float*>(job.tangents.Element(v));
+            vertex.tangent = glm::vec4(t[0], t[1], t[2], t[3]);
+        } else {
+            vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    // Primitive-local indices first (tangent generation works on the primitive alone), then
+    // rebased onto the mesh's shared vertex array
+    if (job.indices.IsValid()) {
+        for (size_t i = 0; i < job.indexCount; i++) {
+            const uint8_t* element = job.indices.Element(i);
+            switch (job.indices.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                    indices[i] = *reinterpret_cast<const uint16_t*>(element);
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                    indices[i] = *reinterpret_cast<const uint32_t*>(element);
+                    break;
+                default:
+                    indices[i] = *element;
+                    break;
+            }
+        }
     } else {
-        success = loader.LoadASCIIFromFile(&gltfModel, &err, &warn, path);
+        for (size_t i = 0; i < job.indexCount; i++) {
+            indices[i] = static_cast<uint32_t>(i);
+        }
     }
+
+    if (!job.tangents.IsValid() && job.normals.IsValid() && job.texcoords.IsValid()) {
+        GenerateTangents(vertices, indices);
+    }
+
+    const uint32_t baseVertex = static_cast<uint32_t>(job.vertexOffset);
+    for (uint32_t& index : indices) {
+        index += baseVertex;
+    }
+}
+
+// Vertex cache, overdraw and vertex fetch ordering plus the LOD chain for every imported mesh,
+// on the JobSystem workers. Logs the cache improvement and what the compact vertex layout would save.
+static void OptimizeImportedMeshes(std::vector<ImportedMesh>& meshes, const std::string& modelName) {
+    LUCENT_PROFILE_FUNCTION();
+
+    std::vector<MeshOptimizer::Stats> stats(meshes.size());
+    JobSystem::Get().ParallelFor(static_cast<uint32_t>(meshes.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            stats[i] = MeshOptimizer::Optimize(meshes[i]);
+            MeshOptimizer::GenerateLODs(meshes[i]);
+        }
+    });
+
+    size_t vertexBytes = 0;
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const MeshOptimizer::Stats& meshStats = stats[i];
+        if (meshStats.vertexCountAfter == 0) continue;
+        LUCENT_CORE_DEBUG("Mesh '{}': ACMR {:.2f} -> {:.2f}, {} -> {} vertices, {} KB vertex data, {} LODs down to {} triangles",
+            meshes[i].name, meshStats.acmrBefore, meshStats.acmrAfter, meshStats.vertexCountBefore,
+            meshStats.vertexCountAfter, meshStats.vertexBytes / 1024, meshes[i].lods.size(),
+            (meshes[i].lods.empty() ? meshes[i].indices.size() : meshes[i].lods.back().indexCount) / 3);
+        vertexBytes += meshStats.vertexBytes;
+    }
+    if (vertexBytes > 0) {
+        LUCENT_CORE_INFO("Optimized {} meshes of '{}': {} KB vertex data", meshes.size(), modelName, vertexBytes / 1024);
+    }
+}
+
+// CPU half of a glTF import: one ImportedMesh per glTF mesh (empty if it has no triangles, so
+// node mesh indices stay valid). Primitives are converted in parallel on the JobSystem.
+static void ConvertGLTFMeshes(const GLTFDocument& document, const std::string& modelName,
+                              std::vector<ImportedMesh>& outMeshes) {
+    LUCENT_PROFILE_FUNCTION();
+    const tinygltf::Model& gltfModel = document.model;
+
+    outMeshes.clear();
+    outMeshes.resize(gltfModel.meshes.size());
+
+    // Serial layout pass: place every primitive in its mesh so the workers never reallocate
+    std::vector<GLTFPrimitiveJob> jobs;
+    for (size_t meshIdx = 0; meshIdx < gltfModel.meshes.size(); meshIdx++) {
+        const auto& gltfMesh = gltfModel.meshes[meshIdx];
+        ImportedMesh& mesh = outMeshes[meshIdx];
+        mesh.name = gltfMesh.name.empty() ? modelName + "_mesh" + std::to_string(meshIdx) : gltfMesh.name;
+
+        size_t vertexTotal = 0;
+        size_t indexTotal = 0;
+        for (const auto& prim : gltfMesh.primitives) {
+            if (prim.mode != TINYGLTF_MODE_TRIANGLES) {
+                LUCENT_CORE_WARN("Skipping non-triangle primitive in mesh '{}'", gltfMesh.name);
+                continue;
+            }
+
+            GLTFPrimitiveJob job;
+            job.mesh = &mesh;
+            auto posIt = prim.attributes.find("POSITION");
+            if (posIt != prim.attributes.end()) {
+                job.positions = GetAccessorView(document, posIt->second);
+            }
+            if (!job.positions.IsValid() || job.positions.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+                LUCENT_CORE_WARN("Skipping primitive without valid float positions in mesh '{}'", gltfMesh.name);
+                continue;
+            }
+            job.vertexCount = job.positions.count;
+            job.normals = GetAttributeView(document, prim, "NORMAL", job.vertexCount);
+            job.texcoords = GetAttributeView(document, prim, "TEXCOORD_0", job.vertexCount);
+            job.tangents = GetAttributeView(document, prim, "TANGENT", job.vertexCount);
+
+            if (prim.indices >= 0) {
+                job.indices = GetAccessorView(document, prim.indices);
+                if (!job.indices.IsValid()) {
+                    LUCENT_CORE_WARN("Skipping primitive with invalid indices in mesh '{}'", gltfMesh.name);
+                    continue;
+                }
+                job.indexCount = job.indices.count;
+            } else {
+                job.indexCount = job.vertexCount - job.vertexCount % 3;
+            }
+
+            job.vertexOffset = vertexTotal;
+            job.indexOffset = indexTotal;
+            vertexTotal += job.vertexCount;
+            indexTotal += job.indexCount;
+
+            const uint32_t materialIndex = prim.material >= 0 ? static_cast<uint32_t>(prim.material) : 0u;
+            mesh.submeshes.push_back({ static_cast<uint32_t>(job.indexOffset), static_cast<uint32_t>(job.indexCount),
+                                       materialIndex });
+            jobs.push_back(job);
+        }
+
+        mesh.vertices.resize(vertexTotal);
+        mesh.indices.resize(indexTotal);
+    }
+
+    JobSystem::Get().ParallelFor(static_cast<uint32_t>(jobs.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            ConvertGLTFPrimitive(jobs[i]);
+        }
+    });
+
+    OptimizeImportedMeshes(outMeshes, modelName);
+}
+
+// Create GPU meshes for imported geometry and add them (and their bounds) to the model
+template<typename MeshSource>
+static void CreateModelMeshes(gfx::Device* device, Model& model, uint32_t meshCount, MeshSource&& getMesh) {
+    model.meshes.reserve(meshCount);
+    for (uint32_t i = 0; i < meshCount; i++) {
+        const ModelCache::MeshView source = getMesh(i);
+        auto mesh = std::make_unique<Mesh>();
+        for (const Submesh& submesh : source.submeshes) {
+            mesh->AddSubmesh(submesh.indexOffset, submesh.indexCount, submesh.materialIndex);
+        }
+        if (mesh->Create(device, source.vertices, source.indices, std::string(source.name), source.lodIndices,
+                         source.lods)) {
+            model.bounds.Expand(mesh->GetBounds().min);
+            model.bounds.Expand(mesh->GetBounds().max);
+            model.meshes.push_back(std::move(mesh));
+        }
+    }
+}
+
+std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::string& path) {
+    LUCENT_PROFILE_FUNCTION();
+    GLTFDocument document;
+    tinygltf::Model& gltfModel = document.model;
+    std::string err, warn;
+    
+    std::filesystem::path filePath(path);
+    
+    GLTFImageContext imageContext;
+    imageContext.modelPath = filePath.lexically_normal().generic_string();
+    imageContext.baseDir = filePath.parent_path().string();
+    if (!imageContext.baseDir.empty()) imageContext.baseDir += "/";
+    imageContext.modelVersion = gfx::TextureCache::GetFileVersion(path);
+    
+    bool success = LoadGLTFDocument(path, document, &imageContext, err, warn);
     
     if (!warn.empty()) {
         LUCENT_CORE_WARN("glTF warning: {}", warn);
@@ -103,10 +611,9 @@ std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::str
     model->name = filePath.stem().string();
     model->sourcePath = path;
     
-    std::string baseDir = filePath.parent_path().string();
-    if (!baseDir.empty()) baseDir += "/";
-    
-    // Load textures
+    // Load textures (through the shared cache, so re-importing a model or another model using the
+    // same image files reuses the GPU upload)
+    gfx::TextureCache& textureCache = gfx::TextureCache::Get();
     for (size_t i = 0; i < gltfModel.textures.size(); i++) {
         const auto& gltfTex = gltfModel.textures[i];
         
@@ -115,36 +622,25 @@ std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::str
             continue;
         }
         
-        const auto& gltfImage = gltfModel.images[gltfTex.source];
-        
-        auto texture = std::make_unique<Texture>();
+        auto cached = imageContext.cached.find(gltfTex.source);
+        if (cached != imageContext.cached.end()) {
+            model->textures.push_back(cached->second);
+            continue;
+        }
         
-        if (!gltfImage.image.empty()) {
-            // Image data is embedded
-            if (texture->CreateFromData(device, gltfImage.image.data(),
-                                        gltfImage.width, gltfImage.height, 4,
-                                        TextureFormat::RGBA8_SRGB,
-                                        model->name + "_tex" + std::to_string(i))) {
-                model->textures.push_back(std::move(texture));
-            } else {
-                model->textures.push_back(nullptr);
-            }
-        } else if (!gltfImage.uri.empty()) {
-            // Load from file
-            TextureDesc desc{};
-            desc.path = baseDir + gltfImage.uri;
-            desc.format = TextureFormat::RGBA8_SRGB;
-            desc.generateMips = true;
-            desc.debugName = (model->name + "_tex" + std::to_string(i)).c_str();
-            
-            if (texture->LoadFromFile(device, desc)) {
-                model->textures.push_back(std::move(texture));
-            } else {
-                model->textures.push_back(nullptr);
-            }
-        } else {
+        auto encoded = imageContext.encoded.find(gltfTex.source);
+        if (encoded == imageContext.encoded.end()) {
             model->textures.push_back(nullptr);
+            continue;
         }
+        
+        // Decoded and uploaded in the background; a second texture sharing the image hits the
+        // pending entry, so the bytes can be handed over
+        uint64_t version = 0;
+        const auto& gltfImage = gltfModel.images[gltfTex.source];
+        const std::string key = GetImageCacheKey(imageContext, gltfImage, gltfTex.source, version);
+        model->textures.push_back(textureCache.AcquireEncodedAsync(
+            key, version, gfx::TextureColorSpace::sRGB, std::move(encoded->second), false));
     }
     
     // Load materials
@@ -294,157 +790,14 @@ std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::str
         }
     }
     
-    // Load meshes
-    for (size_t meshIdx = 0; meshIdx < gltfModel.meshes.size(); meshIdx++) {
-        const auto& gltfMesh = gltfModel.meshes[meshIdx];
-        
-        std::vector<Vertex> allVertices;
-        std::vector<uint32_t> allIndices;
-        
-        auto mesh = std::make_unique<Mesh>();
-        
-        for (size_t primIdx = 0; primIdx < gltfMesh.primitives.size(); primIdx++) {
-            const auto& prim = gltfMesh.primitives[primIdx];
-            
-            if (prim.mode != TINYGLTF_MODE_TRIANGLES) {
-                LUCENT_CORE_WARN("Skipping non-triangle primitive in mesh '{}'", gltfMesh.name);
-                continue;
-            }
-            
-            // Get accessors
-            const float* positions = nullptr;
-            const float* normals = nullptr;
-            const float* texcoords = nullptr;
-            const float* tangents = nullptr;
-            size_t vertexCount = 0;
-            
-            // Position (required)
-            auto posIt = prim.attributes.find("POSITION");
-            if (posIt != prim.attributes.end()) {
-                const auto& accessor = gltfModel.accessors[posIt->second];
-                const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                const auto& buffer = gltfModel.buffers[bufferView.buffer];
-                positions = reinterpret_cast<const float*>(
-                    buffer.data.data() + bufferView.byteOffset + accessor.byteOffset);
-                vertexCount = accessor.count;
-            }
-            
-            // Normal
-            auto normIt = prim.attributes.find("NORMAL");
-            if (normIt != prim.attributes.end()) {
-                const auto& accessor = gltfModel.accessors[normIt->second];
-                const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                const auto& buffer = gltfModel.buffers[bufferView.buffer];
-                normals = reinterpret_cast<const float*>(
-                    buffer.data.data() + bufferView.byteOffset + accessor.byteOffset);
-            }
-            
-            // Texcoord
-            auto uvIt = prim.attributes.find("TEXCOORD_0");
-            if (uvIt != prim.attributes.end()) {
-                const auto& accessor = gltfModel.accessors[uvIt->second];
-                const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                const auto& buffer = gltfModel.buffers[bufferView.buffer];
-                texcoords = reinterpret_cast<const float*>(
-                    buffer.data.data() + bufferView.byteOffset + accessor.byteOffset);
-            }
-            
-            // Tangent
-            auto tanIt = prim.attributes.find("TANGENT");
-            if (tanIt != prim.attributes.end()) {
-                const auto& accessor = gltfModel.accessors[tanIt->second];
-                const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                const auto& buffer = gltfModel.buffers[bufferView.buffer];
-                tangents = reinterpret_cast<const float*>(
-                    buffer.data.data() + bufferView.byteOffset + accessor.byteOffset);
-            }
-            
-            // Build vertices
-            uint32_t baseVertex = static_cast<uint32_t>(allVertices.size());
-            
-            for (size_t v = 0; v < vertexCount; v++) {
-                Vertex vertex{};
-                
-                vertex.position = glm::vec3(
-                    positions[v * 3 + 0],
-                    positions[v * 3 + 1],
-                    positions[v * 3 + 2]
-                );
-                
-                if (normals) {
-                    vertex.normal = glm::vec3(
-                        normals[v * 3 + 0],
-                        normals[v * 3 + 1],
-                        normals[v * 3 + 2]
-                    );
-                } else {
-                    vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
-                }
-                
-                if (texcoords) {
-                    vertex.uv = glm::vec2(
-                        texcoords[v * 2 + 0],
-                        texcoords[v * 2 + 1]
-                    );
-                }
-                
-                if (tangents) {
-                    vertex.tangent = glm::vec4(
-                        tangents[v * 4 + 0],
-                        tangents[v * 4 + 1],
-                        tangents[v * 4 + 2],
-                        tangents[v * 4 + 3]
-                    );
-                } else {
-                    vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-                }
-                
-                allVertices.push_back(vertex);
-            }
-            
-            // Get indices
-            uint32_t indexOffset = static_cast<uint32_t>(allIndices.size());
-            
-            if (prim.indices >= 0) {
-                const auto& accessor = gltfModel.accessors[prim.indices];
-                const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                const auto& buffer = gltfModel.buffers[bufferView.buffer];
-                const uint8_t* indexData = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
-                
-                for (size_t i = 0; i < accessor.count; i++) {
-                    uint32_t index = 0;
-                    
-                    switch (accessor.componentType) {
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                            index = reinterpret_cast<const uint16_t*>(indexData)[i];
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                            index = reinterpret_cast<const uint32_t*>(indexData)[i];
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                            index = indexData[i];
-                            break;
-                    }
-                    
-                    allIndices.push_back(baseVertex + index);
-                }
-                
-                // Add submesh
-                int32_t materialIndex = prim.material >= 0 ? prim.material : 0;
-                mesh->AddSubmesh(indexOffset, static_cast<uint32_t>(accessor.count), materialIndex);
-            }
-        }
-        
-        // Create the mesh
-        std::string meshName = gltfMesh.name.empty() ? 
-            model->name + "_mesh" + std::to_string(meshIdx) : gltfMesh.name;
-            
-        if (mesh->Create(device, allVertices, allIndices, meshName)) {
-            model->bounds.Expand(mesh->GetBounds().min);
-            model->bounds.Expand(mesh->GetBounds().max);
-            model->meshes.push_back(std::move(mesh));
-        }
-    }
+    // Load meshes: attributes are converted on worker threads; only buffer creation stays here
+    std::vector<ImportedMesh> importedMeshes;
+    ConvertGLTFMeshes(document, model->name, importedMeshes);
+    CreateModelMeshes(device, *model, static_cast<uint32_t>(importedMeshes.size()), [&](uint32_t i) {
+        const ImportedMesh& imported = importedMeshes[i];
+        return ModelCache::MeshView{ imported.name, imported.vertices, imported.indices, imported.submeshes,
+                                     imported.lodIndices, imported.lods };
+    });
     
     // Load nodes
     for (size_t nodeIdx = 0; nodeIdx < gltfModel.nodes.size(); nodeIdx++) {
@@ -542,24 +895,89 @@ std::unique_ptr<Model> ModelLoader::LoadGLTF(gfx::Device* device, const std::str
     return model;
 }
 
+bool ModelLoader::LoadGLTFGeometry(const std::string& path, std::vector<ImportedMesh>& outMeshes) {
+    LUCENT_PROFILE_FUNCTION();
+    GLTFDocument document;
+    std::string err, warn;
+    if (!LoadGLTFDocument(path, document, nullptr, err, warn)) {
+        m_LastError = "Failed to load glTF: " + err;
+        LUCENT_CORE_ERROR("{}", m_LastError);
+        return false;
+    }
+
+    ConvertGLTFMeshes(document, std::filesystem::path(path).stem().string(), outMeshes);
+    return true;
+}
+
 std::unique_ptr<Model> ModelLoader::LoadOBJ(gfx::Device* device, const std::string& path) {
     // Route through Assimp to support OBJ (and unify codepaths)
     return LoadAssimp(device, path);
 }
 
+static std::string s_ImportCacheDirectory;
+
+// Post-processing applied to every Assimp import; part of the import cache key
+static constexpr unsigned int kAssimpFlags =
+    aiProcess_Triangulate |
+    aiProcess_GenSmoothNormals |
+    aiProcess_CalcTangentSpace |
+    aiProcess_JoinIdenticalVertices |
+    aiProcess_SortByPType |
+    aiProcess_LimitBoneWeights |
+    aiProcess_OptimizeMeshes;
+// Bump when the conversion from aiScene changes, so stale cache files are not reused
+static constexpr uint32_t kAssimpImportRevision = 2;
+static constexpr uint64_t kAssimpSettingsHash = kAssimpFlags | (uint64_t(kAssimpImportRevision) << 32);
+
+void ModelLoader::SetImportCacheDirectory(const std::string& directory) {
+    s_ImportCacheDirectory = directory;
+}
+
+const std::string& ModelLoader::GetImportCacheDirectory() {
+    return s_ImportCacheDirectory;
+}
+
+std::unique_ptr<Model> ModelLoader::LoadAssimpCached(gfx::Device* device, const std::string& path,
+                                                     const std::string& cachePath, uint64_t sourceHash) {
+    LUCENT_PROFILE_FUNCTION();
+
+    ModelCache::Reader reader;
+    std::string error;
+    if (!reader.Open(cachePath, sourceHash, kAssimpSettingsHash, error)) {
+        LUCENT_CORE_DEBUG("Import cache miss for '{}': {}", path, error);
+        return nullptr;
+    }
+
+    std::filesystem::path filePath(path);
+    auto model = std::make_unique<Model>();
+    model->name = filePath.stem().string();
+    model->sourcePath = path;
+
+    reader.ReadModelInfo(*model);
+    CreateModelMeshes(device, *model, reader.GetMeshCount(), [&](uint32_t i) { return reader.GetMesh(i); });
+
+    LUCENT_CORE_INFO("Loaded model '{}' from import cache: {} meshes, {} materials, {} cameras, {} lights, {} nodes",
+        model->name, model->meshes.size(), model->materials.size(), model->cameras.size(), model->lights.size(), model->nodes.size());
+    return model;
+}
+
 std::unique_ptr<Model> ModelLoader::LoadAssimp(gfx::Device* device, const std::string& path) {
+    LUCENT_PROFILE_FUNCTION();
+
+    // Reuse the processed result of an earlier import of identical source bytes
+    uint64_t sourceHash = 0;
+    std::string cachePath;
+    if (!s_ImportCacheDirectory.empty() && lucent::HashFile(path, sourceHash)) {
+        cachePath = ModelCache::GetCachePath(s_ImportCacheDirectory, sourceHash, kAssimpSettingsHash);
+        if (std::filesystem::exists(cachePath)) {
+            if (auto cached = LoadAssimpCached(device, path, cachePath, sourceHash)) {
+                return cached;
+            }
+        }
+    }
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(
-        path,
-        aiProcess_Triangulate |
-        aiProcess_GenSmoothNormals |
-        aiProcess_CalcTangentSpace |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_ImproveCacheLocality |
-        aiProcess_SortByPType |
-        aiProcess_LimitBoneWeights |
-        aiProcess_OptimizeMeshes
-    );
+    const aiScene* scene = importer.ReadFile(path, kAssimpFlags);
 
     if (!scene || !scene->mRootNode) {
         m_LastError = std::string("Failed to load model (Assimp): ") + importer.GetErrorString();
@@ -609,61 +1027,66 @@ std::unique_ptr<Model> ModelLoader::LoadAssimp(gfx::Device* device, const std::s
         model->materials.push_back(defaultMat);
     }
 
-    // Meshes
-    model->meshes.reserve(scene->mNumMeshes);
+    // Meshes (converted to CPU geometry first so the same data feeds the import cache). Each
+    // aiMesh is independent, so conversion runs on the JobSystem workers.
+    std::vector<uint32_t> sourceMeshes;
+    sourceMeshes.reserve(scene->mNumMeshes);
     for (uint32_t meshIdx = 0; meshIdx < scene->mNumMeshes; meshIdx++) {
         const aiMesh* meshIn = scene->mMeshes[meshIdx];
-        if (!meshIn || meshIn->mNumVertices == 0) continue;
+        if (meshIn && meshIn->mNumVertices > 0) sourceMeshes.push_back(meshIdx);
+    }
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
-        vertices.reserve(meshIn->mNumVertices);
-        indices.reserve(meshIn->mNumFaces * 3);
+    std::vector<ImportedMesh> importedMeshes(sourceMeshes.size());
+    const uint32_t materialCount = static_cast<uint32_t>(model->materials.size());
+    JobSystem::Get().ParallelFor(static_cast<uint32_t>(sourceMeshes.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const uint32_t meshIdx = sourceMeshes[i];
+            const aiMesh* meshIn = scene->mMeshes[meshIdx];
 
-        for (uint32_t v = 0; v < meshIn->mNumVertices; v++) {
-            Vertex out{};
-            out.position = AiToGlm(meshIn->mVertices[v]);
+            ImportedMesh& imported = importedMeshes[i];
+            std::vector<Vertex>& vertices = imported.vertices;
+            std::vector<uint32_t>& indices = imported.indices;
+            vertices.resize(meshIn->mNumVertices);
+            indices.reserve(meshIn->mNumFaces * 3);
 
-            if (meshIn->HasNormals()) {
-                out.normal = SafeNormalize(AiToGlm(meshIn->mNormals[v]));
-            } else {
-                out.normal = glm::vec3(0, 1, 0);
-            }
+            for (uint32_t v = 0; v < meshIn->mNumVertices; v++) {
+                Vertex& out = vertices[v];
+                out.position = AiToGlm(meshIn->mVertices[v]);
 
-            if (meshIn->HasTextureCoords(0)) {
-                out.uv = glm::vec2(meshIn->mTextureCoords[0][v].x, meshIn->mTextureCoords[0][v].y);
-            } else {
-                out.uv = glm::vec2(0.0f);
-            }
+                if (meshIn->HasNormals()) {
+                    out.normal = SafeNormalize(AiToGlm(meshIn->mNormals[v]));
+                } else {
+                    out.normal = glm::vec3(0, 1, 0);
+                }
 
-            if (meshIn->HasTangentsAndBitangents()) {
-                glm::vec3 t = SafeNormalize(AiToGlm(meshIn->mTangents[v]));
-                out.tangent = glm::vec4(t, 1.0f);
-            } else {
-                out.tangent = glm::vec4(1, 0, 0, 1);
-            }
+                if (meshIn->HasTextureCoords(0)) {
+                    out.uv = glm::vec2(meshIn->mTextureCoords[0][v].x, meshIn->mTextureCoords[0][v].y);
+                } else {
+                    out.uv = glm::vec2(0.0f);
+                }
 
-            vertices.push_back(out);
-        }
+                if (meshIn->HasTangentsAndBitangents()) {
+                    glm::vec3 t = SafeNormalize(AiToGlm(meshIn->mTangents[v]));
+                    out.tangent = glm::vec4(t, 1.0f);
+                } else {
+                    out.tangent = glm::vec4(1, 0, 0, 1);
+                }
+            }
 
-        for (uint32_t f = 0; f < meshIn->mNumFaces; f++) {
-            const aiFace& face = meshIn->mFaces[f];
-            if (face.mNumIndices != 3) continue;
-            indices.push_back(face.mIndices[0]);
-            indices.push_back(face.mIndices[1]);
-            indices.push_back(face.mIndices[2]);
-        }
+            for (uint32_t f = 0; f < meshIn->mNumFaces; f++) {
+                const aiFace& face = meshIn->mFaces[f];
+                if (face.mNumIndices != 3) continue;
+                indices.push_back(face.mIndices[0]);
+                indices.push_back(face.mIndices[1]);
+                indices.push_back(face.mIndices[2]);
+            }
 
-        auto mesh = std::make_unique<Mesh>();
-        std::string meshName = meshIn->mName.length > 0 ? meshIn->mName.C_Str() : (model->name + "_mesh" + std::to_string(meshIdx));
-        if (mesh->Create(device, vertices, indices, meshName)) {
-            uint32_t matIndex = meshIn->mMaterialIndex < model->materials.size() ? meshIn->mMaterialIndex : 0;
-            mesh->AddSubmesh(0, static_cast<uint32_t>(indices.size()), matIndex);
-            model->bounds.Expand(mesh->GetBounds().min);
-            model->bounds.Expand(mesh->GetBounds().max);
-            model->meshes.push_back(std::move(mesh));
+            imported.name = meshIn->mName.length > 0 ? meshIn->mName.C_Str() : (model->name + "_mesh" + std::to_string(meshIdx));
+            uint32_t matIndex = meshIn->mMaterialIndex < materialCount ? meshIn->mMaterialIndex : 0;
+            imported.submeshes.push_back({ 0, static_cast<uint32_t>(indices.size()), matIndex });
         }
-    }
+    });
+    OptimizeImportedMeshes(importedMeshes, model->name);
 
     // Cameras
     model->cameras.reserve(scene->mNumCameras);
@@ -739,6 +1162,19 @@ std::unique_ptr<Model> ModelLoader::LoadAssimp(gfx::Device* device, const std::s
     uint32_t rootIdx = buildNode(scene->mRootNode);
     model->rootNodes.push_back(rootIdx);
 
+    if (!cachePath.empty()) {
+        std::string error;
+        if (!ModelCache::Write(cachePath, sourceHash, kAssimpSettingsHash, importedMeshes, *model, error)) {
+            LUCENT_CORE_WARN("Failed to write import cache for '{}': {}", path, error);
+        }
+    }
+
+    CreateModelMeshes(device, *model, static_cast<uint32_t>(importedMeshes.size()), [&](uint32_t i) {
+        const ImportedMesh& imported = importedMeshes[i];
+        return ModelCache::MeshView{ imported.name, imported.vertices, imported.indices, imported.submeshes,
+                                     imported.lodIndices, imported.lods };
+    });
+
     LUCENT_CORE_INFO("Loaded model '{}' via Assimp: {} meshes, {} materials, {} cameras, {} lights, {} nodes",
         model->name, model->meshes.size(), model->materials.size(), model->cameras.size(), model->lights.size(), model->nodes.size());
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace lucent {
+
+// Bump allocator over a chain of blocks obtained from an upstream resource.
+// Individual deallocations are no-ops; memory is reclaimed in bulk with Rewind() or Reset().
+// Derives from std::pmr::memory_resource so std::pmr containers can allocate from it directly.
+// Not thread-safe: each arena belongs to one thread.
+class LinearArena : public std::pmr::memory_resource, public NonMovable {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    // Position in the arena that Rewind() can return to
+    struct Marker {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    explicit LinearArena(size_t blockSize = kDefaultBlockSize,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~LinearArena() override;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    Marker GetMarker() const { return { m_CurrentBlock, m_Offset }; }
+    // Release everything allocated after `marker`. Blocks stay owned by the arena for reuse.
+    void Rewind(const Marker& marker);
+
+    // Release everything. If the previous cycle spilled into several blocks they are merged into
+    // one block of the combined size, so a steady-state workload stops touching the upstream heap.
+    void Reset();
+
+    // Bytes handed out since the last Reset() (including alignment padding)
+    size_t GetUsedBytes() const;
+    size_t GetCapacity() const { return m_Capacity; }
+    // Bytes handed out since construction; never decreases (used for per-frame deltas)
+    uint64_t GetTotalAllocated() const { return m_TotalAllocated; }
+    // Number of blocks requested from the upstream resource since construction
+    uint64_t GetUpstreamAllocations() const { return m_UpstreamAllocations; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Block {
+        std::byte* data = nullptr;
+        size_t size = 0;
+    };
+
+    void AddBlock(size_t minSize);
+    void ReleaseBlocks();
+
+    std::pmr::memory_resource* m_Upstream = nullptr;
+    size_t m_BlockSize = kDefaultBlockSize;
+
+    std::vector<Block> m_Blocks;
+    size_t m_CurrentBlock = 0;
+    size_t m_Offset = 0;
+    size_t m_Capacity = 0;
+
+    uint64_t m_TotalAllocated = 0;
+    uint64_t m_UpstreamAllocations = 0;
+};
+
+struct FrameArenaStats {
+    uint64_t frameBytes = 0;         // Frame arena bytes used by the last completed frame
+    uint64_t scratchBytes = 0;       // Main-thread scratch bytes allocated during the last frame
+    uint64_t upstreamAllocations = 0; // Heap blocks the arenas had to request during the last frame
+    uint64_t peakFrameBytes = 0;
+    size_t capacity = 0;             // Frame + main-thread scratch capacity
+};
+
+// Main-thread arena whose contents live until the start of the next frame.
+// Use for per-frame UI/render temporaries that must outlive a single function.
+class FrameArena {
+public:
+    static LinearArena& Get();
+    static std::pmr::memory_resource* Resource() { return &Get(); }
+
+    // Reset the frame arena and capture stats for the frame that just ended.
+    // Call once per frame from the main loop before anything allocates from it.
+    static void NextFrame();
+
+    static const FrameArenaStats& GetStats();
+};
+
+// Per-thread scratch arena for temporaries that die with the enclosing scope.
+// ScratchScope remembers the arena position on construction and rewinds on destruction,
+// so nested scopes (including callees opening their own) compose naturally. Anything
+// allocated inside the scope must not escape it, and a container from an outer scope must not
+// grow while an inner scope is open (reserve first) or its new storage is rewound with the inner one.
+class ScratchScope : public NonMovable {
+public:
+    ScratchScope();
+    ~ScratchScope();
+
+    LinearArena& Arena() { return *m_Arena; }
+    std::pmr::memory_resource* Resource() { return m_Arena; }
+
+private:
+    LinearArena* m_Arena = nullptr;
+    LinearArena::Marker m_Marker{};
+};
+
+// The calling thread's scratch arena (created on first use)
+LinearArena& GetThreadScratchArena();
+
+} // namespace lucent
@@ -5,4 +5,8 @@
 #include "lucent/core/Base.h"
 #include "lucent/core/Log.h"
 #include "lucent/core/Assert.h"
+#include "lucent/core/JobSystem.h"
 
+#include "lucent/core/Arena.h"
+#include "lucent/core/Profiler.h"
+#include "lucent/core/MappedFile.h"
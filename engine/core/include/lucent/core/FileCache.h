@@ -0,0 +1,79 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace lucent {
+
+struct FileCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writes = 0;
+    uint64_t evictions = 0;
+    size_t diskBytes = 0;
+    size_t maxBytes = 0;
+    uint32_t entryCount = 0;
+};
+
+// Content-addressed cache directory, one file per entry (<key as 16 hex digits><extension>).
+//
+// The caller picks keys that cover everything the entry depends on, so an entry is never stale,
+// only unused, and owns the file format (Load() hands it the bytes to check). Writes go to a
+// temporary file renamed into place. The directory is bounded in size; past the bound the least
+// recently used entries are deleted, with use times kept as file modification times so eviction
+// order survives restarts. Thread safe.
+class FileCache : public NonCopyable {
+public:
+    // Reads one entry's bytes; false if they are corrupt
+    using ReadFunction = std::function<bool(std::span<const std::byte> bytes)>;
+
+    // `name` labels log output
+    FileCache(std::string name, std::string extension);
+
+    // Use `directory` (created if missing) and index the entries already there, deleting
+    // leftovers of interrupted writes. Empty disables the cache: Load() misses and Store() does
+    // nothing.
+    void SetDirectory(const std::string& directory, size_t maxBytes);
+    bool IsEnabled() const;
+
+    // False on a miss. An entry `read` rejects counts as a miss and is deleted.
+    bool Load(uint64_t key, const ReadFunction& read);
+    // Writes `parts` back to back as the entry for `key`, replacing any previous one
+    bool Store(uint64_t key, std::span<const std::span<const std::byte>> parts);
+
+    FileCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        size_t sizeBytes = 0;
+        uint64_t lastUse = 0;
+    };
+
+    std::string GetEntryPath(uint64_t key) const;
+    bool ParseKey(const std::string& filename, uint64_t& outKey) const;
+    // Delete least recently used entries until the directory fits maxBytes. Caller holds m_Mutex.
+    void Trim();
+
+    const std::string m_Name;
+    const std::string m_Extension;
+
+    mutable std::mutex m_Mutex;
+    std::string m_Directory;
+    size_t m_MaxBytes = 0;
+    size_t m_DiskBytes = 0;
+    uint64_t m_UseCounter = 0;
+    std::unordered_map<uint64_t, Entry> m_Entries;
+
+    uint64_t m_Hits = 0;
+    uint64_t m_Misses = 0;
+    uint64_t m_Writes = 0;
+    uint64_t m_Evictions = 0;
+};
+
+} // namespace lucent
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lucent {
+
+using Job = std::function<void()>;
+
+// Completion counter for a group of jobs.
+// Schedule() increments it, each finished job decrements it; a counter at zero means "all done".
+// Jobs scheduled with ScheduleAfter() are held on the counter and released when it reaches zero,
+// which is how task dependencies are expressed.
+class JobCounter : public NonMovable {
+public:
+    JobCounter() = default;
+
+    bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+    uint32_t GetPending() const { return m_Count.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_Count{ 0 };
+
+    // Continuations waiting for this counter to reach zero
+    std::mutex m_Mutex;
+    std::vector<std::pair<Job, JobCounter*>> m_Continuations;
+};
+
+struct JobSystemConfig {
+    // 0 = hardware_concurrency - 1 (the main thread also executes jobs while waiting)
+    uint32_t workerCount = 0;
+};
+
+struct JobSystemStats {
+    uint64_t jobsExecuted = 0;
+    uint64_t jobsStolen = 0;
+    uint64_t mainThreadJobsExecuted = 0;
+};
+
+// Engine-wide job scheduler: a fixed pool of workers, each owning a work-stealing deque.
+// Owners push/pop at the back (LIFO, cache-warm), idle workers steal from the front of other queues.
+// Threads that are not workers (main thread, std::thread users) submit into a shared injection queue.
+//
+// Vulkan objects must be created/destroyed on the main thread: use RunOnMainThread() from a worker
+// and call PumpMainThreadJobs() once per frame from the main loop.
+class JobSystem : public NonMovable {
+public:
+    static JobSystem& Get() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    bool Init(const JobSystemConfig& config = {});
+    void Shutdown();
+    bool IsInitialized() const { return m_Running.load(std::memory_order_acquire); }
+
+    // Schedule a job. If counter is non-null it is incremented now and decremented when the job finishes.
+    // If the system is not initialized the job runs inline on the calling thread.
+    void Schedule(Job job, JobCounter* counter = nullptr);
+
+    // Schedule a job that only becomes runnable once `dependency` reaches zero.
+    void ScheduleAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+    // Block until the counter reaches zero. The calling thread executes pending jobs while it waits,
+    // so waiting from inside a job cannot deadlock the pool. A counter may only be destroyed after
+    // Wait() has returned for it (polling IsDone() alone is not enough).
+    void Wait(JobCounter& counter);
+
+    // Split [0, count) into chunks of at most `grainSize` and run fn(begin, end) across the pool.
+    // Blocks until every chunk has finished. grainSize 0 picks a chunk size from the worker count.
+    void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& fn);
+
+    // Queue work that must run on the main thread (Vulkan resource creation, ImGui state, ...).
+    // If counter is non-null it completes once the job has run in PumpMainThreadJobs().
+    void RunOnMainThread(Job job, JobCounter* counter = nullptr);
+
+    // Execute queued main-thread jobs. Call once per frame from the main thread.
+    void PumpMainThreadJobs();
+
+    bool IsMainThread() const { return std::this_thread::get_id() == m_MainThreadId; }
+
+    // -1 when called from a thread that is not a pool worker
+    static int GetCurrentWorkerIndex();
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+    JobSystemStats GetStats() const;
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    struct WorkItem {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    // Mutex-guarded deque; contention is limited to steals since each worker mostly touches its own.
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<WorkItem> items;
+    };
+
+    void WorkerLoop(uint32_t workerIndex);
+    void Push(WorkItem item);
+    bool PopLocal(uint32_t queueIndex, WorkItem& out);
+    bool Steal(uint32_t thiefQueueIndex, WorkItem& out);
+    bool TryExecuteOne();
+    void Execute(WorkItem& item);
+    void SignalDone(JobCounter* counter);
+
+    std::vector<std::thread> m_Workers;
+    // Queue 0 is the injection queue for non-worker threads; queue i+1 belongs to worker i.
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+
+    std::atomic<bool> m_Running{ false };
+    std::atomic<uint32_t> m_PendingJobs{ 0 };
+    std::mutex m_SleepMutex;
+    std::condition_variable m_SleepCV;
+
+    std::mutex m_MainThreadMutex;
+    std::vector<WorkItem> m_MainThreadJobs;
+    std::thread::id m_MainThreadId = std::this_thread::get_id();
+
+    std::atomic<uint64_t> m_JobsExecuted{ 0 };
+    std::atomic<uint64_t> m_JobsStolen{ 0 };
+    std::atomic<uint64_t> m_MainThreadJobsExecuted{ 0 };
+};
+
+} // namespace lucent
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace lucent {
+
+// Read-only memory mapping of a whole file.
+// The view stays valid until Close() or destruction; pages are faulted in by the OS on first
+// access, so opening a large file is cheap and untouched regions are never read from disk.
+class MappedFile : public NonCopyable {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false (and leaves the object closed) if the file cannot be opened or mapped.
+    // An empty file opens successfully with a null Data() and Size() 0.
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_Open; }
+    const std::byte* Data() const { return m_Data; }
+    size_t Size() const { return m_Size; }
+    std::span<const std::byte> Bytes() const { return { m_Data, m_Size }; }
+
+private:
+    const std::byte* m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_Open = false;
+
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+};
+
+// 64-bit content hash (not cryptographic), fast enough to key caches of large source files
+uint64_t HashBytes(std::span<const std::byte> bytes);
+// Hash of a file's contents, read through a mapping. False if the file cannot be read.
+bool HashFile(const std::string& path, uint64_t& outHash);
+
+} // namespace lucent
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "lucent/core/Base.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// LUCENT_ENABLE_PROFILER is set by CMake (option LUCENT_ENABLE_PROFILER).
+// When it is 0 every LUCENT_PROFILE_* macro expands to nothing.
+#ifndef LUCENT_ENABLE_PROFILER
+    #define LUCENT_ENABLE_PROFILER 0
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define LUCENT_PROFILER_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define LUCENT_PROFILER_RDTSC 1
+#else
+    #define LUCENT_PROFILER_RDTSC 0
+#endif
+
+namespace lucent {
+
+// Scoped CPU profiler with Chrome trace-event export (chrome://tracing, ui.perfetto.dev).
+//
+// Events go into per-thread buffers without locks; recording is off until a capture is started,
+// in which case a zone costs one relaxed atomic load. Timestamps are raw CPU ticks (rdtsc where
+// available) converted to time on export, using a rate calibrated against steady_clock over the
+// capture. Zone and counter names must be string literals (or otherwise outlive the capture):
+// only the pointer is stored.
+class Profiler : public NonMovable {
+public:
+    static Profiler& Get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    // Record until StopCapture()
+    void StartCapture();
+    // Stop recording and write everything captured so far to `path`
+    bool StopCapture(const std::string& path);
+    // Record the next `frameCount` frames (as delimited by BeginFrame()), then write them to `path`
+    void CaptureFrames(uint32_t frameCount, const std::string& path);
+
+    bool IsCapturing() const { return m_Capturing.load(std::memory_order_relaxed); }
+
+    // Frame boundary; drives CaptureFrames(). Call once per frame from the main thread.
+    void BeginFrame();
+
+    // Write the current capture buffers as Chrome trace-event JSON
+    bool WriteChromeTrace(const std::string& path) const;
+
+    // Name the calling thread in exported traces
+    void SetThreadName(const char* name);
+
+    void RecordZone(const char* name, uint64_t startTicks, uint64_t endTicks);
+    void RecordCounter(const char* name, double value);
+
+    // Timestamp source for zones; only differences within one capture are meaningful
+    static uint64_t NowTicks() {
+#if LUCENT_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Events dropped because a thread buffer was full
+    uint64_t GetDroppedEvents() const { return m_DroppedEvents.load(std::memory_order_relaxed); }
+
+private:
+    Profiler() = default;
+    ~Profiler();
+
+    enum class EventType : uint8_t { Zone, Counter };
+
+    struct Event {
+        const char* name;
+        uint64_t startTicks;
+        uint64_t durationTicks; // Zone only
+        double value;           // Counter only
+        EventType type;
+    };
+
+    static constexpr uint32_t kEventsPerChunk = 4096;
+    static constexpr uint32_t kMaxChunks = 256; // ~1M events per thread per capture
+
+    // Single-writer buffer owned by one thread. The exporter reads [0, count) concurrently,
+    // which is safe because slots are only written before count is published. When the thread
+    // exits the buffer is marked inactive and handed, with its chunks, to the next new thread once
+    // its events are no longer part of a capture.
+    struct ThreadBuffer {
+        std::atomic<Event*> chunks[kMaxChunks] = {};
+        std::atomic<uint32_t> count{ 0 };
+        // Capture the events in [0, count) belong to; published after count is reset
+        std::atomic<uint32_t> generation{ 0 };
+        std::atomic<bool> active{ true };
+        uint32_t threadId = 0;       // Guarded by m_BuffersMutex
+        std::string threadName;      // Guarded by m_BuffersMutex
+
+        ~ThreadBuffer();
+    };
+
+    ThreadBuffer* GetThreadBuffer();
+    // An inactive buffer whose events are not needed by a capture, or null. Caller holds m_BuffersMutex.
+    std::shared_ptr<ThreadBuffer> TakeRetiredBuffer();
+    void Push(const Event& event);
+    void BeginCaptureInternal();
+
+    std::atomic<bool> m_Capturing{ false };
+    // Bumped on every capture start; thread buffers reset themselves lazily when they see a new value
+    std::atomic<uint32_t> m_Generation{ 0 };
+    std::atomic<uint64_t> m_DroppedEvents{ 0 };
+    // Tick/clock pairs at capture start and stop, for converting ticks to microseconds
+    uint64_t m_CaptureStartTicks = 0;
+    uint64_t m_CaptureStopTicks = 0;
+    std::chrono::steady_clock::time_point m_CaptureStartTime{};
+    std::chrono::steady_clock::time_point m_CaptureStopTime{};
+
+    mutable std::mutex m_BuffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_Buffers;
+    uint32_t m_NextThreadId = 1;
+
+    // Frame capture state (main thread only)
+    uint32_t m_ArmedFrames = 0;      // CaptureFrames() request waiting for the next frame boundary
+    uint32_t m_FramesRemaining = 0;
+    uint64_t m_FrameStartTicks = 0;
+    std::string m_PendingCapturePath;
+};
+
+// RAII zone; prefer the LUCENT_PROFILE_ZONE macro so it compiles out when disabled
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : m_Name(Profiler::Get().IsCapturing() ? name : nullptr)
+        , m_StartTicks(m_Name ? Profiler::NowTicks() : 0) {
+    }
+
+    ~ProfileZone() {
+        if (m_Name) {
+            Profiler::Get().RecordZone(m_Name, m_StartTicks, Profiler::NowTicks());
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_Name;
+    uint64_t m_StartTicks;
+};
+
+} // namespace lucent
+
+#define LUCENT_PROFILE_CONCAT_INNER(a, b) a##b
+#define LUCENT_PROFILE_CONCAT(a, b) LUCENT_PROFILE_CONCAT_INNER(a, b)
+
+#if LUCENT_ENABLE_PROFILER
+    #define LUCENT_PROFILE_ZONE(name) ::lucent::ProfileZone LUCENT_PROFILE_CONCAT(lucentProfileZone_, __LINE__)(name)
+    #define LUCENT_PROFILE_FUNCTION() LUCENT_PROFILE_ZONE(__func__)
+    #define LUCENT_PROFILE_COUNTER(name, value)                                          \
+        do {                                                                             \
+            if (::lucent::Profiler::Get().IsCapturing()) {                               \
+                ::lucent::Profiler::Get().RecordCounter(name, static_cast<double>(value)); \
+            }                                                                            \
+        } while (false)
+    #define LUCENT_PROFILE_FRAME() ::lucent::Profiler::Get().BeginFrame()
+    #define LUCENT_PROFILE_THREAD(name) ::lucent::Profiler::Get().SetThreadName(name)
+#else
+    #define LUCENT_PROFILE_ZONE(name) ((void)0)
+    #define LUCENT_PROFILE_FUNCTION() ((void)0)
+    #define LUCENT_PROFILE_COUNTER(name, value) ((void)0)
+    #define LUCENT_PROFILE_FRAME() ((void)0)
+    #define LUCENT_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,174 @@
+#include "lucent/core/Arena.h"
+
+#include <algorithm>
+
+namespace lucent {
+
+namespace {
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr size_t kFrameArenaBlockSize = 256 * 1024;
+
+FrameArenaStats s_FrameStats{};
+uint64_t s_LastScratchTotal = 0;
+uint64_t s_LastUpstreamTotal = 0;
+
+} // namespace
+
+// ============================================================================
+// LinearArena
+// ============================================================================
+
+LinearArena::LinearArena(size_t blockSize, std::pmr::memory_resource* upstream)
+    : m_Upstream(upstream ? upstream : std::pmr::new_delete_resource())
+    , m_BlockSize(std::max<size_t>(blockSize, 256)) {
+}
+
+LinearArena::~LinearArena() {
+    ReleaseBlocks();
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+    if (alignment == 0) alignment = 1;
+
+    while (m_CurrentBlock < m_Blocks.size()) {
+        const Block& block = m_Blocks[m_CurrentBlock];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const size_t aligned = AlignUp(base + m_Offset, alignment) - base;
+        if (aligned + size <= block.size) {
+            m_TotalAllocated += (aligned - m_Offset) + size;
+            m_Offset = aligned + size;
+            return block.data + aligned;
+        }
+        // Current block exhausted: move on to the next retained block, if any
+        if (m_CurrentBlock + 1 >= m_Blocks.size()) break;
+        ++m_CurrentBlock;
+        m_Offset = 0;
+    }
+
+    AddBlock(size + alignment);
+    m_CurrentBlock = m_Blocks.size() - 1;
+    m_Offset = 0;
+    return Allocate(size, alignment);
+}
+
+void LinearArena::Rewind(const Marker& marker) {
+    if (marker.block > m_CurrentBlock ||
+        (marker.block == m_CurrentBlock && marker.offset > m_Offset)) {
+        return; // Marker is ahead of the current position
+    }
+    m_CurrentBlock = marker.block;
+    m_Offset = marker.offset;
+}
+
+void LinearArena::Reset() {
+    if (m_Blocks.size() > 1) {
+        const size_t combined = m_Capacity;
+        ReleaseBlocks();
+        AddBlock(combined);
+    }
+    m_CurrentBlock = 0;
+    m_Offset = 0;
+}
+
+size_t LinearArena::GetUsedBytes() const {
+    size_t used = m_Offset;
+    for (size_t i = 0; i < m_CurrentBlock && i < m_Blocks.size(); ++i) {
+        used += m_Blocks[i].size;
+    }
+    return used;
+}
+
+void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+    return Allocate(bytes, alignment);
+}
+
+void LinearArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    (void)p;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void LinearArena::AddBlock(size_t minSize) {
+    Block block;
+    block.size = std::max(m_BlockSize, minSize);
+    block.data = static_cast<std::byte*>(m_Upstream->allocate(block.size, alignof(std::max_align_t)));
+    m_Blocks.push_back(block);
+    m_Capacity += block.size;
+    ++m_UpstreamAllocations;
+}
+
+void LinearArena::ReleaseBlocks() {
+    for (const Block& block : m_Blocks) {
+        m_Upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+    m_Blocks.clear();
+    m_Capacity = 0;
+    m_CurrentBlock = 0;
+    m_Offset = 0;
+}
+
+// ============================================================================
+// FrameArena
+// ============================================================================
+
+LinearArena& FrameArena::Get() {
+    static LinearArena arena(kFrameArenaBlockSize);
+    return arena;
+}
+
+void FrameArena::NextFrame() {
+    LinearArena& frame = Get();
+    LinearArena& scratch = GetThreadScratchArena();
+
+    const uint64_t scratchTotal = scratch.GetTotalAllocated();
+    const uint64_t upstreamTotal = frame.GetUpstreamAllocations() + scratch.GetUpstreamAllocations();
+
+    s_FrameStats.frameBytes = frame.GetUsedBytes();
+    s_FrameStats.scratchBytes = scratchTotal - s_LastScratchTotal;
+    s_FrameStats.upstreamAllocations = upstreamTotal - s_LastUpstreamTotal;
+    s_FrameStats.peakFrameBytes = std::max<uint64_t>(s_FrameStats.peakFrameBytes, s_FrameStats.frameBytes);
+
+    frame.Reset();
+    if (scratch.GetUsedBytes() == 0) {
+        // No scope is open on the main thread between frames; safe to compact
+        scratch.Reset();
+    }
+
+    s_LastScratchTotal = scratchTotal;
+    // Reset() may have merged blocks; count that against the next frame
+    s_LastUpstreamTotal = upstreamTotal;
+    s_FrameStats.capacity = frame.GetCapacity() + scratch.GetCapacity();
+}
+
+const FrameArenaStats& FrameArena::GetStats() {
+    return s_FrameStats;
+}
+
+// ============================================================================
+// Scratch
+// ============================================================================
+
+LinearArena& GetThreadScratchArena() {
+    thread_local LinearArena arena;
+    return arena;
+}
+
+ScratchScope::ScratchScope()
+    : m_Arena(&GetThreadScratchArena())
+    , m_Marker(m_Arena->GetMarker()) {
+}
+
+ScratchScope::~ScratchScope() {
+    m_Arena->Rewind(m_Marker);
+}
+
+} // namespace lucent
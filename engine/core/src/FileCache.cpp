@@ -0,0 +1,225 @@
+#include "lucent/core/FileCache.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lucent {
+
+FileCache::FileCache(std::string name, std::string extension)
+    : m_Name(std::move(name)), m_Extension(std::move(extension)) {}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void FileCache::SetDirectory(const std::string& directory, size_t maxBytes) {
+    LUCENT_PROFILE_FUNCTION();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Directory = directory;
+    m_MaxBytes = maxBytes;
+    m_DiskBytes = 0;
+    m_Entries.clear();
+    if (directory.empty()) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    // Index what previous runs left, oldest use first so the use counter keeps their order
+    struct Found {
+        std::filesystem::file_time_type time;
+        uint64_t key;
+        size_t size;
+    };
+    std::vector<Found> found;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::filesystem::path& path = it->path();
+        std::error_code fileError;
+        if (path.extension() == ".tmp") {
+            // Left by a write that never finished
+            std::filesystem::remove(path, fileError);
+            continue;
+        }
+        uint64_t key = 0;
+        if (!ParseKey(path.filename().string(), key)) continue;
+        const auto size = it->file_size(fileError);
+        const auto time = it->last_write_time(fileError);
+        if (!fileError) found.push_back({ time, key, static_cast<size_t>(size) });
+    }
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time < b.time; });
+
+    for (const Found& entry : found) {
+        m_Entries[entry.key] = { entry.size, ++m_UseCounter };
+        m_DiskBytes += entry.size;
+    }
+    Trim();
+
+    LUCENT_CORE_INFO("{}: {} entries ({:.1f} MB) in {}", m_Name, m_Entries.size(),
+                     m_DiskBytes / (1024.0 * 1024.0), directory);
+}
+
+bool FileCache::IsEnabled() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return !m_Directory.empty();
+}
+
+std::string FileCache::GetEntryPath(uint64_t key) const {
+    char name[20];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_Directory) / (name + m_Extension)).generic_string();
+}
+
+bool FileCache::ParseKey(const std::string& filename, uint64_t& outKey) const {
+    if (filename.size() != 16 + m_Extension.size() || !filename.ends_with(m_Extension)) return false;
+    const auto [end, ec] = std::from_chars(filename.data(), filename.data() + 16, outKey, 16);
+    return ec == std::errc() && end == filename.data() + 16;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+bool FileCache::Load(uint64_t key, const ReadFunction& read) {
+    LUCENT_PROFILE_FUNCTION();
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Directory.empty()) return false;
+        path = GetEntryPath(key);
+    }
+
+    // Read outside the lock; entries are never modified in place
+    bool exists = false;
+    bool valid = false;
+    size_t sizeBytes = 0;
+    {
+        MappedFile file;
+        exists = file.Open(path);
+        if (exists) {
+            sizeBytes = file.Size();
+            valid = read(file.Bytes());
+        }
+    }
+
+    std::error_code ec;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(key);
+    if (!valid) {
+        ++m_Misses;
+        if (exists) {
+            LUCENT_CORE_WARN("{}: discarding corrupt entry {}", m_Name, path);
+            std::filesystem::remove(path, ec);
+        }
+        if (it != m_Entries.end()) {
+            m_DiskBytes -= it->second.sizeBytes;
+            m_Entries.erase(it);
+        }
+        return false;
+    }
+
+    ++m_Hits;
+    if (it == m_Entries.end()) {
+        // Written by another process since the directory was indexed
+        it = m_Entries.emplace(key, Entry{ sizeBytes, 0 }).first;
+        m_DiskBytes += sizeBytes;
+    }
+    it->second.lastUse = ++m_UseCounter;
+    // Persist the use so the next run evicts in the same order
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool FileCache::Store(uint64_t key, std::span<const std::span<const std::byte>> parts) {
+    LUCENT_PROFILE_FUNCTION();
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Directory.empty()) return false;
+        path = GetEntryPath(key);
+    }
+
+    // Unique per thread: two workers may produce the same entry at once
+    const size_t threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const std::string temp = path + "." + std::to_string(threadId) + ".tmp";
+    size_t sizeBytes = 0;
+    std::error_code ec;
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        for (const std::span<const std::byte> part : parts) {
+            out.write(reinterpret_cast<const char*>(part.data()), static_cast<std::streamsize>(part.size()));
+            sizeBytes += part.size();
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp, ec);
+            LUCENT_CORE_WARN("{}: cannot write {}", m_Name, temp);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        LUCENT_CORE_WARN("{}: cannot replace {}", m_Name, path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Entry& entry = m_Entries[key];
+    m_DiskBytes -= entry.sizeBytes;
+    entry.sizeBytes = sizeBytes;
+    entry.lastUse = ++m_UseCounter;
+    m_DiskBytes += entry.sizeBytes;
+    ++m_Writes;
+    Trim();
+    return true;
+}
+
+// ============================================================================
+// Eviction and stats
+// ============================================================================
+
+void FileCache::Trim() {
+    if (m_DiskBytes <= m_MaxBytes) return;
+
+    std::vector<std::pair<uint64_t, uint64_t>> candidates;
+    candidates.reserve(m_Entries.size());
+    for (const auto& [key, entry] : m_Entries) {
+        candidates.emplace_back(entry.lastUse, key);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& [lastUse, key] : candidates) {
+        if (m_DiskBytes <= m_MaxBytes) break;
+
+        std::error_code ec;
+        std::filesystem::remove(GetEntryPath(key), ec);
+        auto it = m_Entries.find(key);
+        m_DiskBytes -= it->second.sizeBytes;
+        m_Entries.erase(it);
+        ++m_Evictions;
+    }
+}
+
+FileCacheStats FileCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    FileCacheStats stats;
+    stats.hits = m_Hits;
+    stats.misses = m_Misses;
+    stats.writes = m_Writes;
+    stats.evictions = m_Evictions;
+    stats.diskBytes = m_DiskBytes;
+    stats.maxBytes = m_MaxBytes;
+    stats.entryCount = static_cast<uint32_t>(m_Entries.size());
+    return stats;
+}
+
+} // namespace lucent
@@ -0,0 +1,324 @@
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+
+namespace lucent {
+
+namespace {
+// Index of the pool worker running on this thread (-1 for main/external threads)
+thread_local int t_WorkerIndex = -1;
+} // namespace
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+bool JobSystem::Init(const JobSystemConfig& config) {
+    if (m_Running.load()) {
+        return true;
+    }
+
+    uint32_t workerCount = config.workerCount;
+    if (workerCount == 0) {
+        const uint32_t hw = std::thread::hardware_concurrency();
+        workerCount = (hw > 1) ? (hw - 1) : 1;
+    }
+
+    m_MainThreadId = std::this_thread::get_id();
+    m_PendingJobs.store(0);
+    m_JobsExecuted.store(0);
+    m_JobsStolen.store(0);
+    m_MainThreadJobsExecuted.store(0);
+
+    m_Queues.clear();
+    m_Queues.reserve(workerCount + 1);
+    for (uint32_t i = 0; i < workerCount + 1; ++i) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_Running.store(true, std::memory_order_release);
+
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+
+    LUCENT_CORE_INFO("Job system initialized with {} worker threads", workerCount);
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!m_Running.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_SleepCV.notify_all();
+
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_Workers.clear();
+
+    // Drain anything still queued so no counter is left waiting forever.
+    WorkItem item;
+    for (uint32_t q = 0; q < m_Queues.size(); ++q) {
+        while (PopLocal(q, item)) {
+            Execute(item);
+        }
+    }
+    PumpMainThreadJobs();
+
+    m_Queues.clear();
+    LUCENT_CORE_INFO("Job system shutdown ({} jobs executed, {} stolen)",
+        m_JobsExecuted.load(), m_JobsStolen.load());
+}
+
+int JobSystem::GetCurrentWorkerIndex() {
+    return t_WorkerIndex;
+}
+
+void JobSystem::Schedule(Job job, JobCounter* counter) {
+    if (!job) return;
+
+    if (counter) {
+        counter->m_Count.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    WorkItem item{ std::move(job), counter };
+    if (!m_Running.load(std::memory_order_acquire)) {
+        // No pool: run inline so callers behave the same with or without workers.
+        Execute(item);
+        return;
+    }
+
+    Push(std::move(item));
+}
+
+void JobSystem::ScheduleAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+    if (!job) return;
+
+    if (counter) {
+        counter->m_Count.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (dependency.m_Count.load(std::memory_order_acquire) != 0) {
+            dependency.m_Continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+
+    // Dependency already satisfied
+    WorkItem item{ std::move(job), counter };
+    if (!m_Running.load(std::memory_order_acquire)) {
+        Execute(item);
+        return;
+    }
+    Push(std::move(item));
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    const bool onMainThread = IsMainThread();
+    while (!counter.IsDone()) {
+        if (TryExecuteOne()) {
+            continue;
+        }
+        // The counter may depend on main-thread work; pumping here avoids self-deadlock.
+        if (onMainThread) {
+            PumpMainThreadJobs();
+        }
+        std::this_thread::yield();
+    }
+
+    // Synchronize with the final SignalDone() so the caller may destroy the counter.
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& fn) {
+    if (count == 0 || !fn) return;
+
+    if (grainSize == 0) {
+        // ~4 chunks per thread keeps load balanced without flooding the queues.
+        const uint32_t threads = GetWorkerCount() + 1;
+        grainSize = std::max(1u, count / (threads * 4));
+    }
+
+    if (grainSize >= count || !m_Running.load(std::memory_order_acquire)) {
+        fn(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += grainSize) {
+        const uint32_t end = std::min(count, begin + grainSize);
+        Schedule([&fn, begin, end]() { fn(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+void JobSystem::RunOnMainThread(Job job, JobCounter* counter) {
+    if (!job) return;
+
+    if (counter) {
+        counter->m_Count.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+    m_MainThreadJobs.push_back(WorkItem{ std::move(job), counter });
+}
+
+void JobSystem::PumpMainThreadJobs() {
+    std::vector<WorkItem> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+        jobs.swap(m_MainThreadJobs);
+    }
+
+    for (auto& item : jobs) {
+        Execute(item);
+        m_MainThreadJobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+JobSystemStats JobSystem::GetStats() const {
+    JobSystemStats stats{};
+    stats.jobsExecuted = m_JobsExecuted.load(std::memory_order_relaxed);
+    stats.jobsStolen = m_JobsStolen.load(std::memory_order_relaxed);
+    stats.mainThreadJobsExecuted = m_MainThreadJobsExecuted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex) {
+    t_WorkerIndex = static_cast<int>(workerIndex);
+#if LUCENT_ENABLE_PROFILER
+    const std::string threadName = "Worker " + std::to_string(workerIndex);
+    LUCENT_PROFILE_THREAD(threadName.c_str());
+#endif
+
+    while (m_Running.load(std::memory_order_acquire)) {
+        if (TryExecuteOne()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        // Timed wait guards against a missed wake-up between the failed pop and the sleep.
+        m_SleepCV.wait_for(lock, std::chrono::milliseconds(2), [this]() {
+            return m_PendingJobs.load(std::memory_order_acquire) > 0 || !m_Running.load(std::memory_order_acquire);
+        });
+    }
+
+    t_WorkerIndex = -1;
+}
+
+void JobSystem::Push(WorkItem item) {
+    const int worker = t_WorkerIndex;
+    const uint32_t queueIndex = (worker >= 0) ? static_cast<uint32_t>(worker) + 1 : 0;
+
+    {
+        WorkQueue& queue = *m_Queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.items.push_back(std::move(item));
+    }
+    m_PendingJobs.fetch_add(1, std::memory_order_release);
+    m_SleepCV.notify_one();
+}
+
+bool JobSystem::PopLocal(uint32_t queueIndex, WorkItem& out) {
+    if (queueIndex >= m_Queues.size()) return false;
+
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.items.empty()) return false;
+
+    out = std::move(queue.items.back());
+    queue.items.pop_back();
+    m_PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool JobSystem::Steal(uint32_t thiefQueueIndex, WorkItem& out) {
+    const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+    for (uint32_t i = 1; i < queueCount; ++i) {
+        const uint32_t victim = (thiefQueueIndex + i) % queueCount;
+        WorkQueue& queue = *m_Queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.items.empty()) continue;
+
+        // Steal the oldest item (largest remaining work in divide-and-conquer patterns)
+        out = std::move(queue.items.front());
+        queue.items.pop_front();
+        m_PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+        m_JobsStolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::TryExecuteOne() {
+    if (m_Queues.empty()) return false;
+
+    const int worker = t_WorkerIndex;
+    const uint32_t queueIndex = (worker >= 0) ? static_cast<uint32_t>(worker) + 1 : 0;
+
+    WorkItem item;
+    if (!PopLocal(queueIndex, item) && !Steal(queueIndex, item)) {
+        return false;
+    }
+
+    Execute(item);
+    return true;
+}
+
+void JobSystem::Execute(WorkItem& item) {
+    LUCENT_PROFILE_ZONE("Job");
+
+    try {
+        item.job();
+    } catch (const std::exception& e) {
+        LUCENT_CORE_ERROR("Job threw exception: {}", e.what());
+    } catch (...) {
+        LUCENT_CORE_ERROR("Job threw unknown exception");
+    }
+    item.job = nullptr;
+
+    m_JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    SignalDone(item.counter);
+}
+
+void JobSystem::SignalDone(JobCounter* counter) {
+    if (!counter) return;
+
+    // Decrement under the counter lock: Wait() takes the same lock before returning, so the
+    // counter (often a stack object) cannot be destroyed while we still touch it.
+    std::vector<std::pair<Job, JobCounter*>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        // Last job of the group: release dependents
+        continuations.swap(counter->m_Continuations);
+    }
+
+    for (auto& [job, dependentCounter] : continuations) {
+        WorkItem next{ std::move(job), dependentCounter };
+        if (m_Running.load(std::memory_order_acquire)) {
+            Push(std::move(next));
+        } else {
+            Execute(next);
+        }
+    }
+}
+
+} // namespace lucent
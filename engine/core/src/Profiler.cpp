@@ -0,0 +1,270 @@
+#include "lucent/core/Profiler.h"
+#include "lucent/core/Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace lucent {
+
+namespace {
+
+// Calling thread's buffer; owned by Profiler::m_Buffers so events outlive the thread
+thread_local void* t_Buffer = nullptr;
+
+// Marks the calling thread's buffer inactive when the thread exits, so it can be recycled
+struct ThreadBufferRelease {
+    std::shared_ptr<std::atomic<bool>> active;
+
+    ~ThreadBufferRelease() {
+        if (active) active->store(false, std::memory_order_release);
+    }
+};
+thread_local ThreadBufferRelease t_BufferRelease;
+
+void WriteJsonString(std::ofstream& out, const char* str) {
+    out << '"';
+    for (const char* c = str; c && *c; ++c) {
+        switch (*c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(*c));
+                    out << buf;
+                } else {
+                    out << *c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+Profiler::ThreadBuffer::~ThreadBuffer() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+Profiler::~Profiler() {
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    m_Buffers.clear();
+}
+
+void Profiler::StartCapture() {
+    m_ArmedFrames = 0;
+    m_FramesRemaining = 0;
+    BeginCaptureInternal();
+}
+
+void Profiler::BeginCaptureInternal() {
+    m_Generation.fetch_add(1, std::memory_order_acq_rel);
+    m_DroppedEvents.store(0, std::memory_order_relaxed);
+    m_CaptureStartTime = std::chrono::steady_clock::now();
+    m_CaptureStartTicks = NowTicks();
+    m_Capturing.store(true, std::memory_order_release);
+    LUCENT_CORE_INFO("Profiler capture started");
+}
+
+bool Profiler::StopCapture(const std::string& path) {
+    if (!m_Capturing.exchange(false)) {
+        return false;
+    }
+    m_CaptureStopTicks = NowTicks();
+    m_CaptureStopTime = std::chrono::steady_clock::now();
+    m_FramesRemaining = 0;
+    return WriteChromeTrace(path);
+}
+
+void Profiler::CaptureFrames(uint32_t frameCount, const std::string& path) {
+    if (frameCount == 0 || IsCapturing()) return;
+    m_ArmedFrames = frameCount;
+    m_PendingCapturePath = path;
+}
+
+void Profiler::BeginFrame() {
+    const uint64_t now = NowTicks();
+    if (IsCapturing() && m_FrameStartTicks != 0) {
+        RecordZone("Frame", m_FrameStartTicks, now);
+    }
+    m_FrameStartTicks = now;
+
+    if (m_FramesRemaining > 0 && --m_FramesRemaining == 0) {
+        StopCapture(m_PendingCapturePath);
+    }
+
+    if (m_ArmedFrames > 0) {
+        m_FramesRemaining = m_ArmedFrames;
+        m_ArmedFrames = 0;
+        BeginCaptureInternal();
+        m_FrameStartTicks = NowTicks();
+    }
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    buffer->threadName = name ? name : "";
+}
+
+void Profiler::RecordZone(const char* name, uint64_t startTicks, uint64_t endTicks) {
+    Push(Event{ name, startTicks, endTicks - startTicks, 0.0, EventType::Zone });
+}
+
+void Profiler::RecordCounter(const char* name, double value) {
+    Push(Event{ name, NowTicks(), 0, value, EventType::Counter });
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+    if (t_Buffer) {
+        return static_cast<ThreadBuffer*>(t_Buffer);
+    }
+
+    std::shared_ptr<ThreadBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_BuffersMutex);
+        buffer = TakeRetiredBuffer();
+        if (!buffer) {
+            buffer = std::make_shared<ThreadBuffer>();
+            m_Buffers.push_back(buffer);
+        }
+        buffer->threadId = m_NextThreadId++;
+        buffer->threadName.clear();
+        buffer->count.store(0, std::memory_order_release);
+        buffer->generation.store(m_Generation.load(std::memory_order_acquire), std::memory_order_release);
+        buffer->active.store(true, std::memory_order_release);
+    }
+    t_Buffer = buffer.get();
+    // Aliases the buffer's lifetime; the flag lives as long as the Profiler keeps the buffer
+    t_BufferRelease.active = std::shared_ptr<std::atomic<bool>>(buffer, &buffer->active);
+    return buffer.get();
+}
+
+std::shared_ptr<Profiler::ThreadBuffer> Profiler::TakeRetiredBuffer() {
+    const bool capturing = IsCapturing();
+    const uint32_t generation = m_Generation.load(std::memory_order_acquire);
+    for (const auto& buffer : m_Buffers) {
+        if (buffer->active.load(std::memory_order_acquire)) continue;
+        // A finished thread's events stay until the capture holding them has been written
+        if (capturing && buffer->generation.load(std::memory_order_acquire) == generation &&
+            buffer->count.load(std::memory_order_acquire) > 0) {
+            continue;
+        }
+        return buffer;
+    }
+    return nullptr;
+}
+
+void Profiler::Push(const Event& event) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+
+    // A new capture started since this thread last recorded: start over
+    const uint32_t generation = m_Generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+        buffer->count.store(0, std::memory_order_release);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    const uint32_t index = buffer->count.load(std::memory_order_relaxed);
+    const uint32_t chunkIndex = index / kEventsPerChunk;
+    if (chunkIndex >= kMaxChunks) {
+        m_DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event* chunk = buffer->chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Event[kEventsPerChunk];
+        buffer->chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    chunk[index % kEventsPerChunk] = event;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        LUCENT_CORE_ERROR("Profiler: failed to open '{}' for writing", path);
+        return false;
+    }
+
+    const uint32_t generation = m_Generation.load(std::memory_order_acquire);
+    const uint64_t originTicks = m_CaptureStartTicks;
+
+    // Calibrate ticks against the wall clock over the capture (still running: up to now)
+    uint64_t endTicks = m_CaptureStopTicks;
+    auto endTime = m_CaptureStopTime;
+    if (IsCapturing()) {
+        endTicks = NowTicks();
+        endTime = std::chrono::steady_clock::now();
+    }
+    const double elapsedUs = std::chrono::duration<double, std::micro>(endTime - m_CaptureStartTime).count();
+    const double usPerTick = (endTicks > originTicks && elapsedUs > 0.0)
+        ? elapsedUs / static_cast<double>(endTicks - originTicks)
+        : 1e-3;
+    size_t eventCount = 0;
+    char buf[128];
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    for (const auto& buffer : m_Buffers) {
+        const bool current = buffer->generation.load(std::memory_order_acquire) == generation;
+        // Threads that have exited only appear with events from this capture
+        if (!current && !buffer->active.load(std::memory_order_acquire)) continue;
+
+        if (!buffer->threadName.empty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":";
+            WriteJsonString(out, buffer->threadName.c_str());
+            out << "}}";
+        }
+
+        // Buffers that have not recorded since the capture started still hold older events
+        if (!current) continue;
+
+        const uint32_t count = buffer->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Event* chunk = buffer->chunks[i / kEventsPerChunk].load(std::memory_order_acquire);
+            const Event& e = chunk[i % kEventsPerChunk];
+            if (e.startTicks < originTicks) continue;
+
+            const double tsUs = static_cast<double>(e.startTicks - originTicks) * usPerTick;
+            separator();
+            out << "{\"name\":";
+            WriteJsonString(out, e.name);
+            if (e.type == EventType::Zone) {
+                std::snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                    tsUs, static_cast<double>(e.durationTicks) * usPerTick, buffer->threadId);
+            } else {
+                std::snprintf(buf, sizeof(buf), ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%g}}",
+                    tsUs, buffer->threadId, e.value);
+            }
+            out << buf;
+            ++eventCount;
+        }
+    }
+    out << "\n]}\n";
+
+    const uint64_t dropped = m_DroppedEvents.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        LUCENT_CORE_WARN("Profiler: {} events dropped (thread buffer full)", dropped);
+    }
+    LUCENT_CORE_INFO("Profiler: wrote {} events to '{}'", eventCount, path);
+    return out.good();
+}
+
+} // namespace lucent
@@ -3,20 +3,24 @@
 #include "lucent/gfx/Device.h"
 #include "lucent/gfx/Image.h"
 #include "lucent/gfx/Buffer.h"
+#include "lucent/gfx/EnvironmentProcessing.h"
 #include <string>
 #include <vector>
 
 namespace lucent::gfx {
 
 // Environment map for HDR IBL lighting with importance sampling
-// Uses equirectangular projection
+// Uses equirectangular projection: RGBA16F with a solid-angle filtered mip chain
 class EnvironmentMap : public NonCopyable {
 public:
     EnvironmentMap() = default;
     ~EnvironmentMap();
     
-    // Load HDR environment from file
-    bool LoadFromFile(Device* device, const std::string& path);
+    // Load HDR environment from file, through the processed cache in cacheDirectory (empty: none)
+    bool LoadFromFile(Device* device, const std::string& path, const std::string& cacheDirectory = {});
+    
+    // Upload an environment processed on the CPU (see EnvironmentProcessing.h)
+    bool Create(Device* device, const ProcessedEnvironment& environment, const std::string& path);
     
     // Create a default procedural sky (gradient)
     bool CreateDefaultSky(Device* device);
@@ -34,6 +38,7 @@ public:
     
     uint32_t GetWidth() const { return m_Width; }
     uint32_t GetHeight() const { return m_Height; }
+    uint32_t GetMipCount() const { return m_MipCount; }
     const std::string& GetPath() const { return m_Path; }
     
     // Environment settings (applied in shader)
@@ -44,7 +49,6 @@ public:
     void SetRotation(float r) { m_Rotation = r; }
     
 private:
-    bool BuildImportanceSamplingTables(const std::vector<float>& luminance);
     bool CreateSampler();
     
 private:
@@ -57,6 +61,7 @@ private:
     
     uint32_t m_Width = 0;
     uint32_t m_Height = 0;
+    uint32_t m_MipCount = 0;
     std::string m_Path;
     
     float m_Intensity = 1.0f;
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "lucent/core/Core.h"
+#include "lucent/core/JobSystem.h"
 #include "lucent/gfx/EnvironmentMap.h"
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -23,9 +25,23 @@ public:
     void Init(Device* device);
     void Shutdown();
 
+    // Processed environments (half-float mips, sampling tables) are cached here between runs,
+    // keyed by the source file's contents. Empty disables the disk cache.
+    void SetDiskCacheDirectory(const std::string& directory) { m_DiskCacheDirectory = directory; }
+
+    // Blocks until the environment is uploaded
     uint32_t LoadFromFile(const std::string& path);
+    // Returns a handle right away and reads (or builds) the processed environment on the JobSystem.
+    // Get(handle)->IsLoaded() stays false until a later Update() uploads it, so callers keep their
+    // current environment meanwhile. InvalidHandle if the file does not exist.
+    uint32_t RequestLoad(const std::string& path);
     uint32_t CreateDefaultSky();
 
+    // Upload finished loads. Call once per frame on the main thread.
+    void Update();
+    // Requested and not yet uploaded (false once it has loaded or failed)
+    bool IsPending(uint32_t handle) const { return m_PendingHandles.count(handle) != 0; }
+
     uint32_t GetDefaultHandle() const { return m_DefaultHandle; }
 
     EnvironmentMap* Get(uint32_t handle);
@@ -34,10 +50,24 @@ public:
 private:
     EnvironmentMapLibrary() = default;
 
+    struct LoadResult {
+        uint32_t handle = InvalidHandle;
+        std::string path;
+        bool success = false;
+        ProcessedEnvironment environment;
+        std::string error;
+    };
+    struct LoadState;
+
     Device* m_Device = nullptr;
     std::vector<std::unique_ptr<EnvironmentMap>> m_Maps;
     std::unordered_map<std::string, uint32_t> m_PathToHandle;
     uint32_t m_DefaultHandle = InvalidHandle;
+
+    std::string m_DiskCacheDirectory;
+    std::shared_ptr<LoadState> m_LoadState;
+    JobCounter m_LoadCounter;
+    std::unordered_set<uint32_t> m_PendingHandles;
 };
 
 } // namespace lucent::gfx
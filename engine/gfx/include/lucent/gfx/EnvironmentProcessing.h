@@ -0,0 +1,52 @@
+#pragma once
+
+#include "lucent/gfx/TextureProcessing.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CPU stages of environment map loading: half-float texels, the radiance mip chain, the importance
+// sampling tables and the disk cache they are kept in. CPU only, like TextureProcessing.h.
+
+namespace lucent::gfx {
+
+// Upload-ready equirectangular environment
+struct ProcessedEnvironment {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TextureLevel> levels;    // Byte ranges of texels, level 0 first
+    std::vector<uint16_t> texels;        // RGBA16F, every level packed
+    std::vector<float> marginalCDF;      // Over rows (height entries), ends at 1
+    std::vector<float> conditionalCDF;   // Over columns within each row (width x height), each row ends at 1
+
+    size_t GetSizeBytes() const {
+        return texels.size() * sizeof(uint16_t) + (marginalCDF.size() + conditionalCDF.size()) * sizeof(float);
+    }
+    uint32_t GetMipCount() const { return static_cast<uint32_t>(levels.size()); }
+};
+
+// Convert an HDR image (RGBA32F) to half floats, filter its full mip chain and build the sampling
+// tables. Mips average by solid angle: each source row is weighted by sin(theta), so the stretched
+// rows near the poles do not dominate. Texels above the half range are clamped, and the tables are
+// built from the clamped values so the sampling pdf matches what the shaders read.
+bool ProcessEnvironment(const DecodedImage& image, ProcessedEnvironment& out, std::string* error = nullptr);
+
+// Cache file (.lenv): header, level texels, marginal CDF, conditional CDF. It records the source
+// file's content hash; a file written for other contents or by another revision is rejected on
+// read so the caller reprocesses. Written to a temporary file and renamed.
+bool WriteEnvironmentCache(const std::string& path, uint64_t sourceHash, const ProcessedEnvironment& environment,
+                           std::string* error = nullptr);
+bool ReadEnvironmentCache(const std::string& path, uint64_t sourceHash, ProcessedEnvironment& out,
+                          std::string* error = nullptr);
+
+// Cache file for a source content hash inside `cacheDirectory`
+std::string GetEnvironmentCachePath(const std::string& cacheDirectory, uint64_t sourceHash);
+
+// Upload-ready environment for an HDR file: read from `cacheDirectory` when a current entry exists,
+// otherwise decoded, processed and written back to it (empty directory: no disk cache). Safe to
+// call from any thread.
+bool LoadEnvironmentFile(const std::string& path, const std::string& cacheDirectory, ProcessedEnvironment& out,
+                         std::string* error = nullptr);
+
+} // namespace lucent::gfx
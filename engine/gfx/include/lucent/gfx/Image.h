@@ -22,6 +22,7 @@ struct ImageDesc {
     VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
     VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT;
     VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    VkComponentMapping components = {}; // View swizzle, identity by default
     bool isCubemap = false;
     const char* debugName = nullptr;
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-hit material programs for the raytraced tracer: the instruction and header layouts read by the
+// closest-hit interpreter (shaders/rt_closesthit.rchit) and the backend pass that allocates their
+// registers and packs every material into one instruction buffer. CPU only.
+
+namespace lucent::gfx {
+
+// Interpreter limits (must match `shaders/rt_closesthit.rchit`). Register 0 always reads as zero and
+// doubles as "no operand".
+constexpr uint32_t RT_MATERIAL_MAX_REGS = 32;
+constexpr uint32_t RT_MATERIAL_MAX_INSTRS = 256;
+
+// The one opcode with a register outside a/b/c: its fourth operand is stored in texIndex
+constexpr uint32_t RT_MATERIAL_OP_COMBINE4 = 39u;
+
+// GPU-evaluated material instruction for raytraced mode (simple IR interpreter in shaders)
+struct RTMaterialInstr {
+    uint32_t type = 0;
+    uint32_t dst = 0;       // destination register (1..RT_MATERIAL_MAX_REGS)
+    uint32_t a = 0;         // operand register (0 = none)
+    uint32_t b = 0;         // operand register (0 = none)
+    uint32_t c = 0;         // operand register / extra (0 = none)
+    uint32_t texIndex = 0;  // global texture index (for texture sampling / swizzles)
+    glm::vec4 imm = glm::vec4(0.0f); // immediates (constants / params)
+};
+
+struct RTMaterialHeader {
+    uint32_t instrOffset = 0;      // start index into the global instruction buffer
+    uint32_t instrCount = 0;       // number of instructions for this material
+    uint32_t baseColorReg = 0;     // vec3 in xyz
+    uint32_t metallicReg = 0;      // float in x
+    uint32_t roughnessReg = 0;     // float in x
+    uint32_t emissiveReg = 0;      // vec3 in xyz
+    uint32_t normalReg = 0;        // vec3 in xyz (0 = use geometry normal)
+    uint32_t alphaReg = 0;         // float in x (optional)
+};
+
+struct RTMaterialProgramStats {
+    uint32_t emittedInstrs = 0;    // As compiled, one register per instruction
+    uint32_t instrCount = 0;       // After common subexpression and dead instruction removal
+    uint32_t registerCount = 0;    // Peak live registers, excluding register 0
+    size_t bytes = 0;              // Header plus the instructions this material added to the buffer
+    bool shared = false;           // Runs another material's instructions
+};
+
+// Optimize a material compiled with one register per instruction (instruction i writes register
+// i + 1; header registers refer to the same numbering) in place: identical instructions are merged,
+// instructions no output reads are dropped and registers are reused as soon as their value is dead,
+// lowest free register first. Fails when the result exceeds the interpreter limits.
+bool AllocateRTMaterialRegisters(std::vector<RTMaterialInstr>& instrs, RTMaterialHeader& header,
+                                 RTMaterialProgramStats* stats, std::string& outError);
+
+// Packs materials into one instruction buffer. Allocation makes register numbering canonical, so
+// materials that compile to the same instructions (different graphs folding to the same program,
+// or differing only in what the RT backend ignores) point at one copy.
+class RTMaterialLinker {
+public:
+    explicit RTMaterialLinker(std::vector<RTMaterialInstr>& buffer);
+
+    // Allocate `instrs` (numbered as for AllocateRTMaterialRegisters) and place them in the buffer,
+    // setting the header's offset, count and output registers. On failure the header is left empty
+    // and the buffer untouched.
+    bool Add(std::span<const RTMaterialInstr> instrs, RTMaterialHeader& header, RTMaterialProgramStats& stats,
+             std::string& outError);
+
+    uint32_t GetMaterialCount() const { return m_MaterialCount; }
+    uint32_t GetSharedCount() const { return m_SharedCount; }
+    uint32_t GetPeakRegisters() const { return m_PeakRegisters; }
+
+private:
+    std::vector<RTMaterialInstr>& m_Buffer;
+    std::unordered_multimap<uint64_t, uint32_t> m_Programs; // Instruction hash -> offset into m_Buffer
+    std::vector<RTMaterialInstr> m_Scratch;
+    uint32_t m_MaterialCount = 0;
+    uint32_t m_SharedCount = 0;
+    uint32_t m_PeakRegisters = 0;
+};
+
+} // namespace lucent::gfx
@@ -142,6 +142,12 @@ public:
     
     // Scene lights for rasterizer
     void SetLights(const std::vector<GPULight>& lights);
+
+    // Per-instance model matrices for the mesh and shadow pipelines (vertex binding 1).
+    // Returns the firstInstance to draw with, or UINT32_MAX on allocation failure. Appending may
+    // replace the frame's buffer, so bind it after appending and before drawing.
+    uint32_t AppendInstances(const glm::mat4* transforms, uint32_t count);
+    void BindInstanceBuffer(VkCommandBuffer cmd) const;
     
 private:
     bool CreateFrameResources();
@@ -278,6 +284,12 @@ private:
     
     // Light buffer for rasterizer
     Buffer m_LightBuffer;
+
+    // Instance transforms, one buffer per frame in flight (grown buffers retire until the
+    // slot's fence is waited on)
+    std::unique_ptr<Buffer> m_InstanceBuffers[MAX_FRAMES_IN_FLIGHT];
+    std::vector<std::unique_ptr<Buffer>> m_RetiredInstanceBuffers[MAX_FRAMES_IN_FLIGHT];
+    uint32_t m_InstanceCount = 0;
 };
 
 } // namespace lucent::gfx
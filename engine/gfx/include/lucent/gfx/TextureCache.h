@@ -0,0 +1,232 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/gfx/Device.h"
+#include "lucent/gfx/Buffer.h"
+#include "lucent/gfx/Image.h"
+#include "lucent/gfx/TextureStreaming.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lucent::gfx {
+
+enum class TextureColorSpace : uint8_t {
+    sRGB,
+    Linear
+};
+
+// Sampled, mipmapped GPU texture owned by the TextureCache and shared through TextureHandle.
+// A texture requested asynchronously samples a placeholder until its upload has completed.
+class CachedTexture : public NonCopyable {
+public:
+    ~CachedTexture();
+
+    VkImageView GetView() const { return m_Resident ? m_Image.GetView() : m_Placeholder->GetView(); }
+    VkSampler GetSampler() const { return m_Resident ? m_Sampler : m_Placeholder->GetSampler(); }
+
+    // False while decoding/uploading, and for textures that failed to load
+    bool IsResident() const { return m_Resident; }
+    bool IsFailed() const { return m_Failed; }
+
+    uint32_t GetWidth() const { return m_Image.GetWidth(); }
+    uint32_t GetHeight() const { return m_Image.GetHeight(); }
+    uint32_t GetMipLevels() const { return m_MipLevels; }
+    VkFormat GetFormat() const { return m_Image.GetFormat(); }
+    const std::string& GetName() const { return m_Name; }
+    // GPU memory including the mip chain
+    size_t GetSizeBytes() const { return m_SizeBytes; }
+
+private:
+    friend class TextureCache;
+
+    Device* m_Device = nullptr;
+    Image m_Image;
+    VkSampler m_Sampler = VK_NULL_HANDLE;
+    uint32_t m_MipLevels = 1;
+    size_t m_SizeBytes = 0;
+    std::string m_Name;
+
+    bool m_Resident = false;
+    bool m_Failed = false;
+    std::shared_ptr<const CachedTexture> m_Placeholder; // Sampled until resident
+};
+
+using TextureHandle = std::shared_ptr<const CachedTexture>;
+
+struct TextureCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t reloads = 0;      // Misses caused by a changed file (subset of misses)
+    uint64_t evictions = 0;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+    uint32_t textureCount = 0;
+    uint32_t referencedCount = 0; // Textures currently held by at least one consumer
+    uint32_t streamingCount = 0;  // Async requests still decoding or uploading
+    size_t stagingBytesInUse = 0;
+};
+
+// Engine-wide texture cache shared by material pipelines, the ray tracer and model import.
+//
+// Entries are keyed by path and colour space and remember the file's modification time, so
+// recompiling a material or rebuilding the RT scene reuses the uploaded image while an edited file
+// is picked up on the next request. Consumers hold TextureHandles; the cache keeps its own
+// reference so released textures stay resident until the memory budget forces them out, least
+// recently used first. Only unreferenced textures are ever evicted.
+//
+// Images are processed on the CPU before upload: full mip chains filtered in linear light and,
+// when the device supports it, BC compression. With a disk cache directory set, processed
+// textures are written there keyed by path and reloaded directly while the source is unchanged.
+//
+// Async requests decode on the JobSystem; Update() copies finished images through a persistent
+// staging ring and submits them in batches with a fence each, so neither decoding nor uploads
+// stall the frame. Until then the handle samples a placeholder; GetResidencyGeneration() changes
+// whenever textures become resident so consumers know to rewrite their descriptors.
+//
+// Main thread only. A consumer must make sure the GPU is done with a texture before dropping its
+// handle, as it would for any resource it owned.
+class TextureCache : public NonCopyable {
+public:
+    static constexpr size_t kDefaultBudgetBytes = size_t(1) << 30; // 1 GiB
+    static constexpr size_t kStagingRingBytes = size_t(64) << 20;
+    // Pixel data copied into staging per Update(); bounds the per-frame cost of streaming
+    static constexpr size_t kUploadBytesPerFrame = size_t(32) << 20;
+
+    static TextureCache& Get() {
+        static TextureCache instance;
+        return instance;
+    }
+
+    void Init(Device* device, size_t budgetBytes = kDefaultBudgetBytes);
+    // Drops every cached texture; call after all consumers released their handles
+    void Shutdown();
+
+    // Texture for an image file (8-bit or HDR), or null if it cannot be loaded. Blocks on decode
+    // and upload.
+    TextureHandle Acquire(const std::string& path, TextureColorSpace colorSpace);
+
+    // Non-blocking Acquire: the handle is returned at once (null only for an empty path) and
+    // becomes resident, or failed, in a later Update()
+    TextureHandle AcquireAsync(const std::string& path, TextureColorSpace colorSpace);
+
+    // Texture for already-decoded RGBA8 pixels under a caller-chosen key. `version` plays the role
+    // of the file time: a different value reuploads.
+    TextureHandle AcquireFromPixels(const std::string& key, uint64_t version, TextureColorSpace colorSpace,
+                                    const void* rgba, uint32_t width, uint32_t height);
+
+    // Non-blocking upload of an encoded image (e.g. a PNG embedded in a glTF) under a caller-chosen key
+    TextureHandle AcquireEncodedAsync(const std::string& key, uint64_t version, TextureColorSpace colorSpace,
+                                      std::vector<uint8_t> encoded, bool flipVertically);
+
+    // True if a request for (key, version, colorSpace) would be a hit (lets callers skip decoding)
+    bool Contains(const std::string& key, uint64_t version, TextureColorSpace colorSpace) const;
+
+    // 1x1 magenta, for slots whose texture is missing
+    TextureHandle GetMissingTexture();
+
+    // Advance async requests: retire finished upload batches and submit new ones. Call once per frame.
+    void Update();
+
+    // Incremented every time async textures become resident (or fail)
+    uint64_t GetResidencyGeneration() const { return m_ResidencyGeneration; }
+
+    // Where processed textures are cached between runs (empty: process on every load)
+    void SetDiskCacheDirectory(const std::string& directory) { m_DiskCacheDirectory = directory; }
+    const std::string& GetDiskCacheDirectory() const { return m_DiskCacheDirectory; }
+
+    void SetBudget(size_t budgetBytes);
+    // Evict unreferenced textures until the cache fits its budget
+    void Trim();
+
+    TextureCacheStats GetStats() const;
+
+    // Modification time used as the cache version for a file (0 if it does not exist)
+    static uint64_t GetFileVersion(const std::string& path);
+
+private:
+    TextureCache() = default;
+
+    struct Entry {
+        std::shared_ptr<CachedTexture> texture;
+        uint64_t version = 0;
+        uint64_t lastUse = 0;
+    };
+
+    // Async request between decode and GPU residency
+    struct PendingTexture {
+        std::shared_ptr<CachedTexture> texture;
+        std::string key;
+    };
+
+    struct UploadBatch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        // With a dedicated transfer queue: graphics-side ownership acquire, run once `cmd` signals
+        VkCommandBuffer acquireCmd = VK_NULL_HANDLE;
+        VkSemaphore transferDone = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE; // Signalled when the whole batch has completed
+        uint64_t ringBatch = 0;
+        std::vector<PendingTexture> textures;
+        std::vector<std::unique_ptr<Buffer>> dedicatedStaging; // Images larger than the ring
+    };
+
+    static std::string MakeKey(const std::string& name, TextureColorSpace colorSpace);
+    static std::string NormalizePath(const std::string& path);
+
+    TextureHandle Lookup(const std::string& key, uint64_t version);
+    TextureHandle Insert(const std::string& key, uint64_t version, std::shared_ptr<CachedTexture> texture);
+    std::shared_ptr<CachedTexture> CreatePending(const std::string& key, uint64_t version, const std::string& name,
+                                                 uint64_t decodeId);
+    // Processing for a cache key; the disk cache is used only for versioned sources
+    TextureProcessSettings MakeProcessSettings(const std::string& key, uint64_t version,
+                                               TextureColorSpace colorSpace) const;
+
+    std::shared_ptr<CachedTexture> Upload(const ProcessedTexture& processed, const std::string& name);
+    // Create the image and record the copy of every mip level from `staging` at `offset`. Given
+    // `acquireCmd`, `cmd` runs on the transfer queue and releases the image to the graphics queue
+    // family, which takes ownership in `acquireCmd`.
+    bool RecordUpload(VkCommandBuffer cmd, VkCommandBuffer acquireCmd, CachedTexture& texture,
+                      const ProcessedTexture& processed, VkBuffer staging, size_t offset);
+    bool CreateSampler(CachedTexture& texture);
+
+    void RetireUploads(bool wait);
+    void SubmitUploads();
+    // Release a batch's command buffers and sync objects once it has completed or failed to submit
+    void FreeBatch(UploadBatch& batch);
+    void MarkFailed(const PendingTexture& pending, const std::string& error);
+    TextureHandle GetLoadingTexture();
+
+    Device* m_Device = nullptr;
+    std::unordered_map<std::string, Entry> m_Entries;
+    TextureHandle m_Missing;
+    TextureHandle m_Loading;
+    size_t m_BudgetBytes = kDefaultBudgetBytes;
+    size_t m_ResidentBytes = 0;
+    uint64_t m_UseCounter = 0;
+    std::string m_DiskCacheDirectory;
+
+    // Streaming
+    std::unique_ptr<TextureDecodeQueue> m_DecodeQueue;
+    std::unordered_map<uint64_t, PendingTexture> m_Decoding; // Decode id -> request
+    std::deque<TextureDecodeQueue::Result> m_Decoded;         // Waiting for staging space
+    StagingRing m_StagingRing;
+    Buffer m_StagingBuffer;
+    uint8_t* m_StagingMapped = nullptr;
+    VkCommandPool m_UploadPool = VK_NULL_HANDLE;  // Transfer queue family when it has its own queue
+    VkCommandPool m_AcquirePool = VK_NULL_HANDLE; // Graphics family; only with a separate transfer queue
+    VkQueue m_UploadQueue = VK_NULL_HANDLE;
+    uint32_t m_UploadFamily = UINT32_MAX;
+    uint32_t m_GraphicsFamily = UINT32_MAX;
+    std::deque<UploadBatch> m_UploadBatches;
+    uint64_t m_ResidencyGeneration = 0;
+
+    uint64_t m_Hits = 0;
+    uint64_t m_Misses = 0;
+    uint64_t m_Reloads = 0;
+    uint64_t m_Evictions = 0;
+};
+
+} // namespace lucent::gfx
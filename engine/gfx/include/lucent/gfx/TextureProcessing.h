@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Offline-style texture processing: CPU mip generation, BC block compression and the on-disk
+// container processed textures are cached in. CPU only, like TextureStreaming.h.
+
+namespace lucent::gfx {
+
+struct DecodedImage {
+    std::vector<uint8_t> pixels;   // RGBA8, or RGBA32F when hdr
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t bytesPerPixel = 4;
+    bool hdr = false;
+
+    size_t GetSizeBytes() const { return pixels.size(); }
+};
+
+enum class TextureBlockFormat : uint8_t {
+    None,   // Uncompressed RGBA8 / RGBA32F
+    BC1,    // Opaque colour, 4 bpp
+    BC4,    // Single channel data, 4 bpp
+    BC5,    // Tangent-space normal XY (Z is reconstructed when sampling), 8 bpp
+    BC6H,   // HDR RGB, unsigned half float, 8 bpp
+    BC7     // Colour with alpha and general RGBA data, 8 bpp
+};
+
+const char* GetBlockFormatName(TextureBlockFormat format);
+// Bytes per 4x4 block (0 for None)
+size_t GetBlockSizeBytes(TextureBlockFormat format);
+// Non-negative float to half-float bits, clamped to the largest finite half (negatives and NaN give 0)
+uint16_t FloatToHalfBits(float value);
+
+enum class TextureContent : uint8_t {
+    Color,
+    Grayscale,
+    NormalMap
+};
+
+struct TextureLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t offset = 0;   // Into ProcessedTexture::data
+    size_t size = 0;
+};
+
+// Upload-ready mip chain, every level packed into one buffer (level 0 first)
+struct ProcessedTexture {
+    TextureBlockFormat format = TextureBlockFormat::None;
+    TextureContent content = TextureContent::Color;
+    bool hdr = false;     // Uncompressed: RGBA32F instead of RGBA8. Always set for BC6H.
+    bool sRGB = false;    // Sampled with sRGB decode (LDR only)
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+
+    size_t GetSizeBytes() const { return data.size(); }
+    uint32_t GetMipCount() const { return static_cast<uint32_t>(levels.size()); }
+};
+
+struct TextureProcessSettings {
+    bool sRGB = false;          // Colour data: mips are filtered in linear light
+    bool generateMips = false;
+    bool compress = false;      // Pick a BC format from the content (needs device BC support)
+    // Processed result is cached here, tagged with sourceVersion (empty: no disk cache)
+    std::string cachePath;
+    uint64_t sourceVersion = 0;
+};
+
+// What an LDR image holds, judged from its pixels. Only linear images can be Grayscale or
+// NormalMap (BC4/BC5 have no sRGB variants).
+TextureContent ClassifyTexture(const DecodedImage& image, bool sRGB);
+TextureBlockFormat ChooseBlockFormat(const DecodedImage& image, bool sRGB, TextureContent content);
+
+// Full chain down to 1x1, level 0 included. Area-weighted box filter; colour is averaged in
+// linear light when sRGB, weighted by alpha, and normal maps are renormalised per texel.
+std::vector<DecodedImage> GenerateMipChain(const DecodedImage& base, bool sRGB, TextureContent content);
+
+// Block-compress one RGBA8 image (RGBA32F for BC6H). Rows of blocks are spread over the JobSystem.
+std::vector<uint8_t> CompressImage(const DecodedImage& image, TextureBlockFormat format);
+
+ProcessedTexture ProcessTexture(const DecodedImage& image, const TextureProcessSettings& settings);
+
+// KTX2-layout container (identifier, header, level index, key/value data, levels). The key/value
+// data records the source version, processing settings and encoder revision; a file written for
+// anything else is rejected on read so the caller reprocesses.
+bool WriteTextureContainer(const std::string& path, const ProcessedTexture& texture,
+                           const TextureProcessSettings& settings, std::string* error = nullptr);
+bool ReadTextureContainer(const std::string& path, const TextureProcessSettings& settings, ProcessedTexture& out,
+                          std::string* error = nullptr);
+
+// Cache file for a texture key (path + colour space) inside `cacheDirectory`
+std::string GetTextureContainerPath(const std::string& cacheDirectory, const std::string& key);
+
+} // namespace lucent::gfx
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/gfx/TextureProcessing.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// CPU stages of texture streaming: image decoding, the decode job queue and the staging ring
+// allocator. Nothing here touches Vulkan, so it runs (and is tested) without a device.
+
+namespace lucent::gfx {
+
+// Decode an image file or encoded bytes (PNG, JPEG, HDR, ...) to RGBA. Safe to call from any thread.
+bool DecodeImageFile(const std::string& path, bool flipVertically, DecodedImage& out, std::string* error = nullptr);
+bool DecodeImageMemory(const void* data, size_t size, bool flipVertically, DecodedImage& out,
+                       std::string* error = nullptr);
+
+// Upload-ready texture for an image: read from settings.cachePath when that container is current,
+// otherwise decoded, processed and written back to it. Safe to call from any thread.
+bool LoadTextureFile(const std::string& path, bool flipVertically, const TextureProcessSettings& settings,
+                     ProcessedTexture& out, std::string* error = nullptr);
+bool LoadTextureMemory(const void* data, size_t size, bool flipVertically, const TextureProcessSettings& settings,
+                       ProcessedTexture& out, std::string* error = nullptr);
+
+// Loads (decodes and processes, or reads from the disk cache) textures on the JobSystem. Results
+// are collected by the owner (typically once per frame) in completion order.
+class TextureDecodeQueue : public NonCopyable {
+public:
+    struct Result {
+        uint64_t id = 0;
+        bool success = false;
+        ProcessedTexture texture;
+        std::string error;
+    };
+
+    TextureDecodeQueue();
+    ~TextureDecodeQueue();
+
+    // Both return the id the matching Result will carry
+    uint64_t EnqueueFile(std::string path, bool flipVertically, TextureProcessSettings settings = {});
+    uint64_t EnqueueMemory(std::vector<uint8_t> encoded, bool flipVertically, TextureProcessSettings settings = {});
+
+    // Take finished results, stopping once `maxBytes` of texture data has been taken (at least one
+    // result is returned when any is ready, however large)
+    std::vector<Result> PopCompleted(size_t maxBytes = SIZE_MAX);
+
+    // Decodes scheduled but not yet popped
+    uint32_t GetPendingCount() const;
+
+    // Block until every scheduled decode has finished (results stay queued)
+    void WaitIdle();
+
+private:
+    struct SharedState;
+
+    uint64_t Schedule(std::function<void(Result&)> decode);
+
+    std::shared_ptr<SharedState> m_State;
+    JobCounter m_Counter;
+    uint64_t m_NextId = 1;
+};
+
+// Ring allocator over a fixed-size staging buffer. Allocations are grouped into batches; once the
+// GPU has consumed a batch (its fence signalled), Retire() hands that space back. Batches must be
+// retired in submission order, which fences on a single queue guarantee.
+class StagingRing {
+public:
+    static constexpr size_t kInvalidOffset = SIZE_MAX;
+
+    StagingRing() = default;
+    explicit StagingRing(size_t capacity, size_t alignment = 16) { Reset(capacity, alignment); }
+
+    // Forget all allocations and batches
+    void Reset(size_t capacity, size_t alignment = 16);
+
+    // Offset of `size` contiguous bytes, or kInvalidOffset if they do not fit until older batches
+    // retire (or ever, when size exceeds the capacity)
+    size_t Allocate(size_t size);
+
+    // Close the current batch; returns its id (0 if nothing was allocated since the last submit)
+    uint64_t Submit();
+
+    // Release the space of `batchId` and every batch submitted before it
+    void Retire(uint64_t batchId);
+
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetUsedBytes() const { return static_cast<size_t>(m_Head - m_Tail); }
+    uint32_t GetInFlightBatchCount() const { return static_cast<uint32_t>(m_Batches.size()); }
+
+private:
+    struct Batch {
+        uint64_t id;
+        uint64_t end; // Ring head when the batch was submitted
+    };
+
+    size_t m_Capacity = 0;
+    size_t m_Alignment = 16;
+    // Monotonic byte positions; the ring offset is position % capacity
+    uint64_t m_Head = 0;
+    uint64_t m_Tail = 0;
+    uint64_t m_BatchStart = 0;
+    uint64_t m_NextBatchId = 1;
+    std::deque<Batch> m_Batches;
+};
+
+} // namespace lucent::gfx
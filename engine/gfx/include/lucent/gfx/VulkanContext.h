@@ -32,6 +32,7 @@ struct DeviceFeatures {
     // Core features (Vulkan 1.2+)
     bool bufferDeviceAddress = false;
     bool descriptorIndexing = false;
+    bool textureCompressionBC = false;
     
     // Vulkan 1.3 features (optional - fallback available)
     bool dynamicRendering = false;
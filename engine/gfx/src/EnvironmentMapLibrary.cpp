@@ -1,13 +1,26 @@
 #include "lucent/gfx/EnvironmentMapLibrary.h"
 #include "lucent/core/Log.h"
 
+#include <filesystem>
+#include <mutex>
+
 namespace lucent::gfx {
 
+// Shared with in-flight load jobs, which may finish after the library has shut down
+struct EnvironmentMapLibrary::LoadState {
+    std::mutex mutex;
+    std::vector<LoadResult> completed;
+};
+
 void EnvironmentMapLibrary::Init(Device* device) {
     m_Device = device;
+    m_LoadState = std::make_shared<LoadState>();
 }
 
 void EnvironmentMapLibrary::Shutdown() {
+    JobSystem::Get().Wait(m_LoadCounter);
+    m_LoadState.reset();
+    m_PendingHandles.clear();
     m_Maps.clear();
     m_PathToHandle.clear();
     m_DefaultHandle = InvalidHandle;
@@ -15,6 +28,19 @@ void EnvironmentMapLibrary::Shutdown() {
 }
 
 uint32_t EnvironmentMapLibrary::LoadFromFile(const std::string& path) {
+    uint32_t handle = RequestLoad(path);
+    if (handle == InvalidHandle) {
+        return InvalidHandle;
+    }
+
+    if (IsPending(handle)) {
+        JobSystem::Get().Wait(m_LoadCounter);
+        Update();
+    }
+    return m_Maps[handle]->IsLoaded() ? handle : InvalidHandle;
+}
+
+uint32_t EnvironmentMapLibrary::RequestLoad(const std::string& path) {
     if (path.empty()) {
         return InvalidHandle;
     }
@@ -24,22 +50,63 @@ uint32_t EnvironmentMapLibrary::LoadFromFile(const std::string& path) {
         return existing->second;
     }
 
-    if (!m_Device) {
+    if (!m_Device || !m_LoadState) {
         LUCENT_CORE_ERROR("EnvironmentMapLibrary: device not initialized");
         return InvalidHandle;
     }
 
-    auto envMap = std::make_unique<EnvironmentMap>();
-    if (!envMap->LoadFromFile(m_Device, path)) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        LUCENT_CORE_ERROR("Failed to load HDR environment: {} - file not found", path);
         return InvalidHandle;
     }
 
-    m_Maps.push_back(std::move(envMap));
+    m_Maps.push_back(std::make_unique<EnvironmentMap>());
     uint32_t handle = static_cast<uint32_t>(m_Maps.size() - 1);
     m_PathToHandle[path] = handle;
+    m_PendingHandles.insert(handle);
+
+    JobSystem::Get().Schedule([state = m_LoadState, handle, path, directory = m_DiskCacheDirectory]() {
+        LoadResult result;
+        result.handle = handle;
+        result.path = path;
+        result.success = LoadEnvironmentFile(path, directory, result.environment, &result.error);
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->completed.push_back(std::move(result));
+    }, &m_LoadCounter);
     return handle;
 }
 
+void EnvironmentMapLibrary::Update() {
+    if (!m_LoadState || m_PendingHandles.empty()) {
+        return;
+    }
+
+    std::vector<LoadResult> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_LoadState->mutex);
+        completed.swap(m_LoadState->completed);
+    }
+
+    for (LoadResult& result : completed) {
+        m_PendingHandles.erase(result.handle);
+        EnvironmentMap& envMap = *m_Maps[result.handle];
+        if (result.success) {
+            if (envMap.Create(m_Device, result.environment, result.path)) {
+                LUCENT_CORE_INFO("Loaded HDR environment: {} ({}x{})", result.path, envMap.GetWidth(),
+                                 envMap.GetHeight());
+                continue;
+            }
+            result.error = "upload failed";
+        }
+
+        LUCENT_CORE_ERROR("Failed to load HDR environment: {} - {}", result.path, result.error);
+        // The handle stays valid (never loaded); forgetting the path lets a later request retry
+        m_PathToHandle.erase(result.path);
+    }
+}
+
 uint32_t EnvironmentMapLibrary::CreateDefaultSky() {
     if (m_DefaultHandle != InvalidHandle) {
         return m_DefaultHandle;
@@ -0,0 +1,326 @@
+#include "lucent/gfx/EnvironmentProcessing.h"
+#include "lucent/gfx/TextureStreaming.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace lucent::gfx {
+
+namespace {
+
+constexpr char kMagic[8] = { 'L', 'U', 'C', 'E', 'N', 'T', 'E', 'V' };
+// Bump when filtering or the table layout changes so stale cache files are regenerated
+constexpr uint32_t kRevision = 1;
+constexpr uint32_t kMaxDimension = 32768;
+constexpr float kPi = 3.14159265359f;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t revision;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t sourceHash;
+    uint64_t fileSize;
+    uint64_t reserved[3];
+};
+static_assert(sizeof(CacheHeader) == 64);
+
+bool Fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+// Full chain down to 1x1, byte ranges into the packed RGBA16F texels
+std::vector<TextureLevel> GetLevelLayout(uint32_t width, uint32_t height) {
+    std::vector<TextureLevel> levels;
+    size_t offset = 0;
+    while (true) {
+        TextureLevel level;
+        level.width = width;
+        level.height = height;
+        level.offset = offset;
+        level.size = static_cast<size_t>(width) * height * 4 * sizeof(uint16_t);
+        offset += level.size;
+        levels.push_back(level);
+        if (width == 1 && height == 1) break;
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+    }
+    return levels;
+}
+
+// Row y of an equirectangular image covers a band of solid angle proportional to this
+float GetRowWeight(uint32_t y, uint32_t height) {
+    return std::sin(kPi * (static_cast<float>(y) + 0.5f) / static_cast<float>(height));
+}
+
+// Clamp into what a half float holds; negatives and NaN become 0
+float ToHalfRange(float value) {
+    return value > 0.0f ? std::min(value, 65504.0f) : 0.0f;
+}
+
+void StoreHalfRow(const float* pixels, uint32_t count, uint16_t* out) {
+    for (uint32_t i = 0; i < count * 4; ++i) out[i] = FloatToHalfBits(pixels[i]);
+}
+
+struct Tap {
+    uint32_t index;
+    float weight;
+};
+
+// Source texels covered by destination texel i; odd sizes give fractional edge coverage
+std::vector<Tap> GetFootprint(uint32_t i, uint32_t srcSize, uint32_t dstSize) {
+    std::vector<Tap> taps;
+    const double begin = static_cast<double>(i) * srcSize / dstSize;
+    const double end = static_cast<double>(i + 1) * srcSize / dstSize;
+    for (uint32_t s = static_cast<uint32_t>(begin); s < srcSize && s < end; ++s) {
+        const double covered = std::min<double>(s + 1, end) - std::max<double>(s, begin);
+        if (covered > 1e-6) taps.push_back({ s, static_cast<float>(covered) });
+    }
+    return taps;
+}
+
+// Box filter to half size with each source row weighted by its solid angle
+std::vector<float> Downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight,
+                              uint32_t dstWidth, uint32_t dstHeight) {
+    std::vector<float> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+    std::vector<std::vector<Tap>> columns(dstWidth);
+    for (uint32_t x = 0; x < dstWidth; ++x) columns[x] = GetFootprint(x, srcWidth, dstWidth);
+
+    JobSystem::Get().ParallelFor(dstHeight, 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t y = begin; y < end; ++y) {
+            std::vector<Tap> rows = GetFootprint(y, srcHeight, dstHeight);
+            for (Tap& row : rows) row.weight *= GetRowWeight(row.index, srcHeight);
+
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                float sum[4] = {};
+                float total = 0.0f;
+                for (const Tap& row : rows) {
+                    const float* srcRow = src.data() + static_cast<size_t>(row.index) * srcWidth * 4;
+                    for (const Tap& column : columns[x]) {
+                        const float w = row.weight * column.weight;
+                        const float* p = srcRow + static_cast<size_t>(column.index) * 4;
+                        for (int c = 0; c < 4; ++c) sum[c] += p[c] * w;
+                        total += w;
+                    }
+                }
+                float* out = dst.data() + (static_cast<size_t>(y) * dstWidth + x) * 4;
+                for (int c = 0; c < 4; ++c) out[c] = total > 0.0f ? sum[c] / total : 0.0f;
+            }
+        }
+    });
+    return dst;
+}
+
+} // namespace
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+bool ProcessEnvironment(const DecodedImage& image, ProcessedEnvironment& out, std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    const uint32_t width = image.width;
+    const uint32_t height = image.height;
+    const size_t texelCount = static_cast<size_t>(width) * height;
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension ||
+        image.pixels.size() != texelCount * (image.hdr ? 16u : 4u)) {
+        return Fail(error, "invalid image");
+    }
+
+    // Float working copy of level 0. LDR images are linearised with gamma 2.2, as stbi_loadf does.
+    std::vector<float> level(texelCount * 4);
+    if (image.hdr) {
+        std::memcpy(level.data(), image.pixels.data(), image.pixels.size());
+    } else {
+        for (size_t i = 0; i < level.size(); ++i) {
+            const float value = static_cast<float>(image.pixels[i]) / 255.0f;
+            level[i] = (i % 4) == 3 ? value : std::pow(value, 2.2f);
+        }
+    }
+
+    ProcessedEnvironment result;
+    result.width = width;
+    result.height = height;
+    result.levels = GetLevelLayout(width, height);
+    result.texels.resize((result.levels.back().offset + result.levels.back().size) / sizeof(uint16_t));
+    result.marginalCDF.resize(height);
+    result.conditionalCDF.resize(texelCount);
+
+    // Level 0 and the per-row (conditional) tables: luminance weighted by the row's solid angle
+    std::vector<double> rowSums(height);
+    JobSystem::Get().ParallelFor(height, 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t y = begin; y < end; ++y) {
+            float* row = level.data() + static_cast<size_t>(y) * width * 4;
+            for (uint32_t i = 0; i < width * 4; ++i) row[i] = ToHalfRange(row[i]);
+            StoreHalfRow(row, width, result.texels.data() + static_cast<size_t>(y) * width * 4);
+
+            const float sinTheta = GetRowWeight(y, height);
+            float* cdf = result.conditionalCDF.data() + static_cast<size_t>(y) * width;
+            double sum = 0.0;
+            for (uint32_t x = 0; x < width; ++x) {
+                const float* p = row + static_cast<size_t>(x) * 4;
+                sum += (0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2]) * sinTheta;
+                cdf[x] = static_cast<float>(sum);
+            }
+            for (uint32_t x = 0; x < width; ++x) {
+                cdf[x] = sum > 0.0 ? static_cast<float>(cdf[x] / sum)
+                                   : static_cast<float>(x + 1) / static_cast<float>(width);
+            }
+            cdf[width - 1] = 1.0f;
+            rowSums[y] = sum;
+        }
+    });
+
+    double total = 0.0;
+    for (double sum : rowSums) total += sum;
+    double running = 0.0;
+    for (uint32_t y = 0; y < height; ++y) {
+        running += rowSums[y];
+        result.marginalCDF[y] = total > 0.0 ? static_cast<float>(running / total)
+                                            : static_cast<float>(y + 1) / static_cast<float>(height);
+    }
+    result.marginalCDF[height - 1] = 1.0f;
+
+    // Each mip is filtered from the previous float level, so rounding to half never compounds
+    for (size_t i = 1; i < result.levels.size(); ++i) {
+        const TextureLevel& src = result.levels[i - 1];
+        const TextureLevel& dst = result.levels[i];
+        level = Downsample(level, src.width, src.height, dst.width, dst.height);
+        StoreHalfRow(level.data(), dst.width * dst.height, result.texels.data() + dst.offset / sizeof(uint16_t));
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+bool WriteEnvironmentCache(const std::string& path, uint64_t sourceHash, const ProcessedEnvironment& environment,
+                           std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    if (environment.levels.empty()) return Fail(error, "environment has no levels");
+
+    const size_t texelBytes = environment.texels.size() * sizeof(uint16_t);
+    const size_t marginalBytes = environment.marginalCDF.size() * sizeof(float);
+    const size_t conditionalBytes = environment.conditionalCDF.size() * sizeof(float);
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.revision = kRevision;
+    header.width = environment.width;
+    header.height = environment.height;
+    header.levelCount = environment.GetMipCount();
+    header.sourceHash = sourceHash;
+    header.fileSize = sizeof(CacheHeader) + texelBytes + marginalBytes + conditionalBytes;
+
+    // Write next to the target and rename, so a concurrent reader never sees a partial file
+    std::error_code ec;
+    const std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    const std::filesystem::path temp = target.string() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return Fail(error, "cannot open " + temp.string());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(environment.texels.data()), static_cast<std::streamsize>(texelBytes));
+        out.write(reinterpret_cast<const char*>(environment.marginalCDF.data()),
+                  static_cast<std::streamsize>(marginalBytes));
+        out.write(reinterpret_cast<const char*>(environment.conditionalCDF.data()),
+                  static_cast<std::streamsize>(conditionalBytes));
+        if (!out) return Fail(error, "write failed: " + temp.string());
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return Fail(error, "cannot replace " + path);
+    }
+    return true;
+}
+
+bool ReadEnvironmentCache(const std::string& path, uint64_t sourceHash, ProcessedEnvironment& out,
+                          std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    MappedFile file;
+    if (!file.Open(path)) return Fail(error, "cannot open " + path);
+
+    CacheHeader header{};
+    if (file.Size() < sizeof(header)) return Fail(error, "not an environment cache file");
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return Fail(error, "not an environment cache file");
+    if (header.revision != kRevision || header.sourceHash != sourceHash) return Fail(error, "stale");
+    if (header.width == 0 || header.height == 0 || header.width > kMaxDimension || header.height > kMaxDimension) {
+        return Fail(error, "corrupt header");
+    }
+
+    ProcessedEnvironment result;
+    result.width = header.width;
+    result.height = header.height;
+    result.levels = GetLevelLayout(header.width, header.height);
+    const size_t texelBytes = result.levels.back().offset + result.levels.back().size;
+    const size_t texelCount = static_cast<size_t>(header.width) * header.height;
+    const size_t expectedSize = sizeof(CacheHeader) + texelBytes + (header.height + texelCount) * sizeof(float);
+    if (header.levelCount != result.GetMipCount() || header.fileSize != expectedSize || file.Size() != expectedSize) {
+        return Fail(error, "corrupt file");
+    }
+
+    const std::byte* data = file.Data() + sizeof(CacheHeader);
+    result.texels.resize(texelBytes / sizeof(uint16_t));
+    std::memcpy(result.texels.data(), data, texelBytes);
+    data += texelBytes;
+    result.marginalCDF.resize(header.height);
+    std::memcpy(result.marginalCDF.data(), data, header.height * sizeof(float));
+    data += header.height * sizeof(float);
+    result.conditionalCDF.resize(texelCount);
+    std::memcpy(result.conditionalCDF.data(), data, texelCount * sizeof(float));
+
+    out = std::move(result);
+    return true;
+}
+
+std::string GetEnvironmentCachePath(const std::string& cacheDirectory, uint64_t sourceHash) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.lenv", static_cast<unsigned long long>(sourceHash));
+    return (std::filesystem::path(cacheDirectory) / name).generic_string();
+}
+
+bool LoadEnvironmentFile(const std::string& path, const std::string& cacheDirectory, ProcessedEnvironment& out,
+                         std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    uint64_t sourceHash = 0;
+    if (!HashFile(path, sourceHash)) return Fail(error, "cannot read " + path);
+
+    std::string cachePath;
+    if (!cacheDirectory.empty()) {
+        cachePath = GetEnvironmentCachePath(cacheDirectory, sourceHash);
+        if (ReadEnvironmentCache(cachePath, sourceHash, out)) return true;
+    }
+
+    DecodedImage image;
+    if (!DecodeImageFile(path, true, image, error)) return false;
+    if (!ProcessEnvironment(image, out, error)) return false;
+
+    if (!cachePath.empty()) {
+        std::string writeError;
+        if (!WriteEnvironmentCache(cachePath, sourceHash, out, &writeError)) {
+            LUCENT_CORE_WARN("Environment cache write failed: {}", writeError);
+        }
+    }
+    return true;
+}
+
+} // namespace lucent::gfx
@@ -80,6 +80,7 @@ bool Image::Init(Device* device, const ImageDesc& desc) {
     }
     
     viewInfo.format = desc.format;
+    viewInfo.components = desc.components;
     viewInfo.subresourceRange.aspectMask = desc.aspect;
     viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = desc.mipLevels;
@@ -0,0 +1,213 @@
+#include "lucent/gfx/RTMaterialProgram.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+namespace lucent::gfx {
+
+namespace {
+
+// Instructions are hashed and compared as raw bytes
+static_assert(sizeof(RTMaterialInstr) == 10 * sizeof(uint32_t), "RTMaterialInstr must not contain padding");
+
+constexpr uint32_t kNoUse = UINT32_MAX;
+
+uint64_t HashInstrs(std::span<const RTMaterialInstr> instrs) {
+    return HashBytes(std::as_bytes(instrs));
+}
+
+bool SameInstr(const RTMaterialInstr& a, const RTMaterialInstr& b) {
+    return std::memcmp(&a, &b, sizeof(RTMaterialInstr)) == 0;
+}
+
+struct InstrHash {
+    size_t operator()(const RTMaterialInstr& ins) const { return static_cast<size_t>(HashInstrs({ &ins, 1 })); }
+};
+
+struct InstrEqual {
+    bool operator()(const RTMaterialInstr& a, const RTMaterialInstr& b) const { return SameInstr(a, b); }
+};
+
+// Every field holding a register read by the instruction
+template <typename Instr, typename Fn>
+void ForEachOperand(Instr& ins, Fn&& fn) {
+    fn(ins.a);
+    fn(ins.b);
+    fn(ins.c);
+    if (ins.type == RT_MATERIAL_OP_COMBINE4) fn(ins.texIndex);
+}
+
+template <typename Header, typename Fn>
+void ForEachOutput(Header& header, Fn&& fn) {
+    fn(header.baseColorReg);
+    fn(header.metallicReg);
+    fn(header.roughnessReg);
+    fn(header.emissiveReg);
+    fn(header.normalReg);
+    fn(header.alphaReg);
+}
+
+} // namespace
+
+// ============================================================================
+// Register allocation
+// ============================================================================
+
+bool AllocateRTMaterialRegisters(std::vector<RTMaterialInstr>& instrs, RTMaterialHeader& header,
+                                 RTMaterialProgramStats* stats, std::string& outError) {
+    LUCENT_PROFILE_FUNCTION();
+
+    const uint32_t count = static_cast<uint32_t>(instrs.size());
+    if (stats) {
+        *stats = RTMaterialProgramStats{};
+        stats->emittedInstrs = count;
+    }
+
+    // Merge identical instructions. Every instruction is pure and reads only earlier registers, so an
+    // instruction equal to an earlier one (after renaming its operands) computes the same value.
+    std::vector<uint32_t> canonical(count + 1, 0);
+    std::unordered_map<RTMaterialInstr, uint32_t, InstrHash, InstrEqual> seen;
+    seen.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        RTMaterialInstr& ins = instrs[i];
+        bool valid = true;
+        ForEachOperand(ins, [&](uint32_t& reg) {
+            if (reg > i) valid = false;
+            else reg = canonical[reg];
+        });
+        if (!valid) {
+            outError = "RT material instruction " + std::to_string(i) + " reads a register it does not follow";
+            return false;
+        }
+        ins.dst = 0;
+        canonical[i + 1] = seen.try_emplace(ins, i + 1).first->second;
+        ins.dst = i + 1;
+    }
+
+    bool validOutputs = true;
+    ForEachOutput(header, [&](uint32_t& reg) {
+        if (reg > count) validOutputs = false;
+        else reg = canonical[reg];
+    });
+    if (!validOutputs) {
+        outError = "RT material output reads a register past its instructions";
+        return false;
+    }
+
+    // Liveness: outputs are read after the last instruction, everything else at its last reader.
+    // Walking backwards keeps only instructions some output depends on.
+    std::vector<uint32_t> lastUse(count + 1, kNoUse);
+    std::vector<bool> live(count + 1, false);
+    ForEachOutput(header, [&](const uint32_t& reg) {
+        if (reg != 0) {
+            live[reg] = true;
+            lastUse[reg] = count;
+        }
+    });
+    for (uint32_t i = count; i-- > 0;) {
+        const RTMaterialInstr& ins = instrs[i];
+        if (!live[ins.dst] || canonical[ins.dst] != ins.dst) continue;
+        ForEachOperand(ins, [&](const uint32_t& reg) {
+            if (reg == 0) return;
+            live[reg] = true;
+            if (lastUse[reg] == kNoUse) lastUse[reg] = i;
+        });
+    }
+
+    // Linear scan in program order. The interpreter reads every operand before writing the result,
+    // so a register freed by its last reader can take that reader's result.
+    std::vector<uint32_t> physical(count + 1, 0);
+    std::vector<bool> busy(count + 2, false);
+    uint32_t peak = 0;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        RTMaterialInstr ins = instrs[i];
+        const uint32_t value = ins.dst;
+        if (!live[value] || canonical[value] != value) continue;
+
+        ForEachOperand(ins, [&](uint32_t& reg) {
+            const uint32_t virtualReg = reg;
+            reg = physical[virtualReg];
+            if (virtualReg != 0 && lastUse[virtualReg] == i) busy[reg] = false;
+        });
+
+        uint32_t reg = 1;
+        while (busy[reg]) ++reg;
+        busy[reg] = true;
+        physical[value] = reg;
+        peak = std::max(peak, reg);
+
+        ins.dst = reg;
+        instrs[kept++] = ins;
+    }
+    instrs.resize(kept);
+    ForEachOutput(header, [&](uint32_t& reg) { reg = physical[reg]; });
+    header.instrCount = kept;
+
+    if (stats) {
+        stats->instrCount = kept;
+        stats->registerCount = peak;
+    }
+    LUCENT_PROFILE_COUNTER("RT Material Registers", peak);
+
+    if (kept > RT_MATERIAL_MAX_INSTRS) {
+        outError = "Material graph too complex for RT interpreter (" + std::to_string(kept) + " instructions, limit " +
+                   std::to_string(RT_MATERIAL_MAX_INSTRS) + ")";
+        return false;
+    }
+    if (peak > RT_MATERIAL_MAX_REGS) {
+        outError = "Material graph too complex for RT interpreter (" + std::to_string(peak) + " registers, limit " +
+                   std::to_string(RT_MATERIAL_MAX_REGS) + ")";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Linker
+// ============================================================================
+
+RTMaterialLinker::RTMaterialLinker(std::vector<RTMaterialInstr>& buffer)
+    : m_Buffer(buffer) {
+}
+
+bool RTMaterialLinker::Add(std::span<const RTMaterialInstr> instrs, RTMaterialHeader& header,
+                           RTMaterialProgramStats& stats, std::string& outError) {
+    m_Scratch.assign(instrs.begin(), instrs.end());
+    RTMaterialHeader allocated = header;
+    if (!AllocateRTMaterialRegisters(m_Scratch, allocated, &stats, outError)) {
+        header = RTMaterialHeader{};
+        return false;
+    }
+
+    ++m_MaterialCount;
+    m_PeakRegisters = std::max(m_PeakRegisters, stats.registerCount);
+    stats.bytes = sizeof(RTMaterialHeader);
+    header = allocated;
+    header.instrOffset = 0;
+    if (m_Scratch.empty()) return true;
+
+    const uint64_t hash = HashInstrs(m_Scratch);
+    auto [first, last] = m_Programs.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        const uint32_t offset = it->second;
+        if (offset + m_Scratch.size() <= m_Buffer.size() &&
+            std::equal(m_Scratch.begin(), m_Scratch.end(), m_Buffer.begin() + offset, SameInstr)) {
+            header.instrOffset = offset;
+            stats.shared = true;
+            ++m_SharedCount;
+            return true;
+        }
+    }
+
+    header.instrOffset = static_cast<uint32_t>(m_Buffer.size());
+    m_Buffer.insert(m_Buffer.end(), m_Scratch.begin(), m_Scratch.end());
+    m_Programs.emplace(hash, header.instrOffset);
+    stats.bytes += m_Scratch.size() * sizeof(RTMaterialInstr);
+    return true;
+}
+
+} // namespace lucent::gfx
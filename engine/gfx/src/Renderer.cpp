@@ -1,10 +1,19 @@
 #include "lucent/gfx/Renderer.h"
 #include "lucent/gfx/DebugUtils.h"
 #include "lucent/gfx/VkResultUtils.h"
+#include <algorithm>
 #include <array>
 
 namespace lucent::gfx {
 
+// A mat4 instance attribute occupies four consecutive vec4 locations of binding 1
+static void AddInstanceAttributes(std::vector<VkVertexInputAttributeDescription>& attributes, uint32_t firstLocation) {
+    for (uint32_t column = 0; column < 4; ++column) {
+        attributes.push_back({ firstLocation + column, 1, VK_FORMAT_R32G32B32A32_SFLOAT,
+                               static_cast<uint32_t>(sizeof(glm::vec4) * column) });
+    }
+}
+
 Renderer::~Renderer() {
     Shutdown();
 }
@@ -173,6 +182,10 @@ void Renderer::Shutdown() {
 #endif
     
     DestroyShadowResources();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        m_InstanceBuffers[i].reset();
+        m_RetiredInstanceBuffers[i].clear();
+    }
     DestroyPipelines();
     DestroyFramebuffers();
     DestroyRenderPasses();
@@ -211,6 +224,10 @@ bool Renderer::BeginFrame() {
         // We'll update the other frame's set when that frame becomes active.
         m_ShadowDescriptorDirty = false;
     }
+
+    // Instance data written for this frame slot last time is no longer read by the GPU
+    m_RetiredInstanceBuffers[m_CurrentFrame].clear();
+    m_InstanceCount = 0;
     
     // Acquire next swapchain image
     if (!m_Swapchain.AcquireNextImage(frame.imageAvailableSemaphore, m_CurrentImageIndex)) {
@@ -550,9 +567,11 @@ bool Renderer::CreatePipelines() {
     }
     
     // Create mesh pipeline with vertex input
-    // Standard mesh vertex format: position, normal, uv, tangent
+    // Standard mesh vertex format: position, normal, uv, tangent; binding 1 holds the
+    // per-instance model matrix (see AppendInstances)
     std::vector<VkVertexInputBindingDescription> meshBindings = {
-        { 0, sizeof(float) * 12, VK_VERTEX_INPUT_RATE_VERTEX } // 3+3+2+4 floats
+        { 0, sizeof(float) * 12, VK_VERTEX_INPUT_RATE_VERTEX }, // 3+3+2+4 floats
+        { 1, sizeof(glm::mat4), VK_VERTEX_INPUT_RATE_INSTANCE }
     };
     std::vector<VkVertexInputAttributeDescription> meshAttributes = {
         { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 },                  // position
@@ -560,6 +579,7 @@ bool Renderer::CreatePipelines() {
         { 2, 0, VK_FORMAT_R32G32_SFLOAT, sizeof(float) * 6 },     // uv
         { 3, 0, VK_FORMAT_R32G32B32A32_SFLOAT, sizeof(float) * 8 } // tangent
     };
+    AddInstanceAttributes(meshAttributes, 4);
     
     PipelineBuilder meshBuilder;
     meshBuilder
@@ -1580,12 +1600,14 @@ bool Renderer::CreateShadowResources() {
     
     // Vertex input for mesh
     std::vector<VkVertexInputBindingDescription> bindings = {
-        {0, sizeof(float) * 12, VK_VERTEX_INPUT_RATE_VERTEX} // pos + normal + uv + tangent
+        {0, sizeof(float) * 12, VK_VERTEX_INPUT_RATE_VERTEX}, // pos + normal + uv + tangent
+        {1, sizeof(glm::mat4), VK_VERTEX_INPUT_RATE_INSTANCE}
     };
     std::vector<VkVertexInputAttributeDescription> attributes = {
         // Shadow shader only needs position
         {0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}
     };
+    AddInstanceAttributes(attributes, 1);
     builder.SetVertexInput(bindings, attributes);
     builder.SetInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
     builder.SetRasterizer(VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE);
@@ -1686,6 +1708,45 @@ void Renderer::SetLights(const std::vector<GPULight>& lights) {
     m_ShadowDescriptorDirty = true;
 }
 
+uint32_t Renderer::AppendInstances(const glm::mat4* transforms, uint32_t count) {
+    auto& buffer = m_InstanceBuffers[m_CurrentFrame];
+    const size_t needed = (static_cast<size_t>(m_InstanceCount) + count) * sizeof(glm::mat4);
+    if (!buffer || buffer->GetSize() < needed) {
+        // Draws recorded earlier this frame still reference the old buffer; keep it alive until
+        // this frame slot's fence has been waited on, and start the new one from instance 0
+        if (buffer) {
+            m_RetiredInstanceBuffers[m_CurrentFrame].push_back(std::move(buffer));
+        }
+        const size_t capacity = std::max<size_t>(needed * 2, sizeof(glm::mat4) * 1024);
+        buffer = std::make_unique<Buffer>();
+
+        BufferDesc desc{};
+        desc.size = capacity;
+        desc.usage = BufferUsage::Vertex;
+        desc.hostVisible = true;
+        desc.debugName = "InstanceTransforms";
+        if (!buffer->Init(m_Device, desc)) {
+            LUCENT_CORE_ERROR("Failed to create instance buffer ({} bytes)", capacity);
+            buffer.reset();
+            return UINT32_MAX;
+        }
+        m_InstanceCount = 0;
+    }
+
+    const uint32_t first = m_InstanceCount;
+    buffer->Upload(transforms, static_cast<size_t>(count) * sizeof(glm::mat4), first * sizeof(glm::mat4));
+    m_InstanceCount += count;
+    return first;
+}
+
+void Renderer::BindInstanceBuffer(VkCommandBuffer cmd) const {
+    const auto& buffer = m_InstanceBuffers[m_CurrentFrame];
+    if (!buffer) return;
+    VkBuffer handle = buffer->GetHandle();
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 1, 1, &handle, &offset);
+}
+
 void Renderer::BeginShadowPass(VkCommandBuffer cmd) {
     VkRenderPassBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
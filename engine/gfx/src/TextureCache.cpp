@@ -0,0 +1,818 @@
+#include "lucent/gfx/TextureCache.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace lucent::gfx {
+
+CachedTexture::~CachedTexture() {
+    if (m_Device && m_Sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(m_Device->GetContext()->GetDevice(), m_Sampler, nullptr);
+        m_Sampler = VK_NULL_HANDLE;
+    }
+    m_Image.Shutdown();
+}
+
+// ============================================================================
+// Lifetime
+// ============================================================================
+
+void TextureCache::Init(Device* device, size_t budgetBytes) {
+    m_Device = device;
+    m_BudgetBytes = budgetBytes;
+    m_DecodeQueue = std::make_unique<TextureDecodeQueue>();
+
+    BufferDesc stagingDesc{};
+    stagingDesc.size = kStagingRingBytes;
+    stagingDesc.usage = BufferUsage::Staging;
+    stagingDesc.hostVisible = true;
+    stagingDesc.debugName = "TextureStagingRing";
+    if (m_StagingBuffer.Init(device, stagingDesc)) {
+        m_StagingMapped = static_cast<uint8_t*>(m_StagingBuffer.Map());
+        m_StagingRing.Reset(kStagingRingBytes);
+    } else {
+        LUCENT_CORE_WARN("TextureCache: staging ring unavailable, streamed textures use dedicated staging");
+    }
+
+    // Streamed copies go to the dedicated transfer queue when there is one, so they overlap
+    // rendering instead of queueing behind it; the graphics queue then acquires each image
+    VulkanContext* context = device->GetContext();
+    m_GraphicsFamily = context->GetQueueFamilies().graphics;
+    m_UploadFamily = m_GraphicsFamily;
+    m_UploadQueue = context->GetGraphicsQueue();
+    const uint32_t transferFamily = context->GetQueueFamilies().transfer;
+    bool fullMipCopies = false;
+    if (transferFamily != UINT32_MAX) {
+        // Small mips can only be copied by families with a 1x1x1 transfer granularity
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(context->GetPhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(context->GetPhysicalDevice(), &familyCount, families.data());
+        if (transferFamily < familyCount) {
+            const VkExtent3D granularity = families[transferFamily].minImageTransferGranularity;
+            fullMipCopies = granularity.width == 1 && granularity.height == 1 && granularity.depth == 1;
+        }
+    }
+    if (fullMipCopies && transferFamily != m_GraphicsFamily && context->GetTransferQueue() != VK_NULL_HANDLE) {
+        m_UploadFamily = transferFamily;
+        m_UploadQueue = context->GetTransferQueue();
+    }
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = m_UploadFamily;
+    if (vkCreateCommandPool(device->GetHandle(), &poolInfo, nullptr, &m_UploadPool) != VK_SUCCESS) {
+        LUCENT_CORE_ERROR("TextureCache: failed to create upload command pool");
+    }
+    if (m_UploadFamily != m_GraphicsFamily) {
+        poolInfo.queueFamilyIndex = m_GraphicsFamily;
+        if (vkCreateCommandPool(device->GetHandle(), &poolInfo, nullptr, &m_AcquirePool) != VK_SUCCESS) {
+            LUCENT_CORE_WARN("TextureCache: no graphics command pool for ownership transfer, uploading on graphics");
+            vkDestroyCommandPool(device->GetHandle(), m_UploadPool, nullptr);
+            m_UploadPool = VK_NULL_HANDLE;
+            m_UploadFamily = m_GraphicsFamily;
+            m_UploadQueue = context->GetGraphicsQueue();
+            poolInfo.queueFamilyIndex = m_UploadFamily;
+            if (vkCreateCommandPool(device->GetHandle(), &poolInfo, nullptr, &m_UploadPool) != VK_SUCCESS) {
+                LUCENT_CORE_ERROR("TextureCache: failed to create upload command pool");
+            }
+        }
+    }
+    LUCENT_CORE_DEBUG("TextureCache: streaming uploads on the {} queue",
+                      m_UploadFamily != m_GraphicsFamily ? "transfer" : "graphics");
+}
+
+void TextureCache::Shutdown() {
+    if (!m_Device) return;
+
+    // Finish in-flight streaming first so no job or batch outlives the resources below
+    m_DecodeQueue.reset();
+    m_Decoding.clear();
+    m_Decoded.clear();
+    RetireUploads(true);
+
+    m_Device->GetContext()->WaitIdle();
+
+    uint32_t stillReferenced = 0;
+    for (const auto& [key, entry] : m_Entries) {
+        if (entry.texture.use_count() > 1) ++stillReferenced;
+    }
+    if (stillReferenced > 0) {
+        LUCENT_CORE_WARN("TextureCache: {} textures still referenced at shutdown", stillReferenced);
+    }
+
+    LUCENT_CORE_INFO("TextureCache: {} hits, {} misses, {} evictions", m_Hits, m_Misses, m_Evictions);
+
+    m_Entries.clear();
+    m_Missing.reset();
+    m_Loading.reset();
+    m_ResidentBytes = 0;
+
+    if (m_UploadPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(m_Device->GetHandle(), m_UploadPool, nullptr);
+        m_UploadPool = VK_NULL_HANDLE;
+    }
+    if (m_AcquirePool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(m_Device->GetHandle(), m_AcquirePool, nullptr);
+        m_AcquirePool = VK_NULL_HANDLE;
+    }
+    m_UploadQueue = VK_NULL_HANDLE;
+    m_StagingMapped = nullptr;
+    m_StagingBuffer.Shutdown();
+    m_Device = nullptr;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+TextureHandle TextureCache::Acquire(const std::string& path, TextureColorSpace colorSpace) {
+    if (path.empty()) return nullptr;
+
+    const std::string key = MakeKey(NormalizePath(path), colorSpace);
+    const uint64_t version = GetFileVersion(path);
+    if (TextureHandle cached = Lookup(key, version)) {
+        return cached;
+    }
+
+    if (!m_Device) {
+        LUCENT_CORE_ERROR("TextureCache: device not initialized");
+        return nullptr;
+    }
+
+    LUCENT_PROFILE_ZONE("TextureCache::Load");
+
+    ProcessedTexture processed;
+    std::string error;
+    if (!LoadTextureFile(path, true, MakeProcessSettings(key, version, colorSpace), processed, &error)) {
+        LUCENT_CORE_ERROR("Failed to load texture: {} - {}", path, error);
+        return nullptr;
+    }
+
+    auto texture = Upload(processed, path);
+    if (!texture) return nullptr;
+    return Insert(key, version, std::move(texture));
+}
+
+TextureHandle TextureCache::AcquireAsync(const std::string& path, TextureColorSpace colorSpace) {
+    if (path.empty()) return nullptr;
+
+    const std::string key = MakeKey(NormalizePath(path), colorSpace);
+    const uint64_t version = GetFileVersion(path);
+    if (TextureHandle cached = Lookup(key, version)) {
+        return cached;
+    }
+
+    if (!m_Device) {
+        LUCENT_CORE_ERROR("TextureCache: device not initialized");
+        return nullptr;
+    }
+
+    const uint64_t decodeId = m_DecodeQueue->EnqueueFile(path, true, MakeProcessSettings(key, version, colorSpace));
+    return CreatePending(key, version, path, decodeId);
+}
+
+TextureHandle TextureCache::AcquireFromPixels(const std::string& key, uint64_t version, TextureColorSpace colorSpace,
+                                              const void* rgba, uint32_t width, uint32_t height) {
+    const std::string fullKey = MakeKey(key, colorSpace);
+    if (TextureHandle cached = Lookup(fullKey, version)) {
+        return cached;
+    }
+
+    if (!m_Device) {
+        LUCENT_CORE_ERROR("TextureCache: device not initialized");
+        return nullptr;
+    }
+    if (!rgba || width == 0 || height == 0) return nullptr;
+
+    LUCENT_PROFILE_ZONE("TextureCache::Load");
+
+    DecodedImage image;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(static_cast<const uint8_t*>(rgba),
+                        static_cast<const uint8_t*>(rgba) + static_cast<size_t>(width) * height * 4);
+
+    // Generated pixels have no source file to version against, so they never go to disk
+    TextureProcessSettings settings = MakeProcessSettings(fullKey, version, colorSpace);
+    settings.cachePath.clear();
+    auto texture = Upload(ProcessTexture(image, settings), key);
+    if (!texture) return nullptr;
+    return Insert(fullKey, version, std::move(texture));
+}
+
+TextureHandle TextureCache::AcquireEncodedAsync(const std::string& key, uint64_t version, TextureColorSpace colorSpace,
+                                                std::vector<uint8_t> encoded, bool flipVertically) {
+    const std::string fullKey = MakeKey(key, colorSpace);
+    if (TextureHandle cached = Lookup(fullKey, version)) {
+        return cached;
+    }
+
+    if (!m_Device) {
+        LUCENT_CORE_ERROR("TextureCache: device not initialized");
+        return nullptr;
+    }
+    if (encoded.empty()) return nullptr;
+
+    const uint64_t decodeId = m_DecodeQueue->EnqueueMemory(std::move(encoded), flipVertically,
+                                                           MakeProcessSettings(fullKey, version, colorSpace));
+    return CreatePending(fullKey, version, key, decodeId);
+}
+
+bool TextureCache::Contains(const std::string& key, uint64_t version, TextureColorSpace colorSpace) const {
+    auto it = m_Entries.find(MakeKey(key, colorSpace));
+    return it != m_Entries.end() && it->second.version == version;
+}
+
+TextureHandle TextureCache::GetMissingTexture() {
+    if (!m_Missing && m_Device) {
+        DecodedImage magenta;
+        magenta.width = magenta.height = 1;
+        magenta.pixels = { 255, 0, 255, 255 };
+        TextureProcessSettings settings;
+        settings.sRGB = true;
+        m_Missing = Upload(ProcessTexture(magenta, settings), "MissingTexture");
+    }
+    return m_Missing;
+}
+
+TextureHandle TextureCache::GetLoadingTexture() {
+    if (!m_Loading && m_Device) {
+        DecodedImage grey;
+        grey.width = grey.height = 1;
+        grey.pixels = { 128, 128, 128, 255 };
+        TextureProcessSettings settings;
+        settings.sRGB = true;
+        m_Loading = Upload(ProcessTexture(grey, settings), "LoadingTexture");
+    }
+    return m_Loading;
+}
+
+TextureHandle TextureCache::Lookup(const std::string& key, uint64_t version) {
+    auto it = m_Entries.find(key);
+    if (it == m_Entries.end()) {
+        ++m_Misses;
+        return nullptr;
+    }
+
+    if (it->second.version != version) {
+        // File changed on disk: forget the entry. Consumers holding the old texture keep it alive
+        // until they rebuild, at which point they pick up the reloaded one.
+        ++m_Misses;
+        ++m_Reloads;
+        if (it->second.texture->IsResident()) m_ResidentBytes -= it->second.texture->GetSizeBytes();
+        m_Entries.erase(it);
+        return nullptr;
+    }
+
+    ++m_Hits;
+    it->second.lastUse = ++m_UseCounter;
+    return it->second.texture;
+}
+
+TextureHandle TextureCache::Insert(const std::string& key, uint64_t version, std::shared_ptr<CachedTexture> texture) {
+    // Streamed textures are accounted once their upload completes
+    if (texture->IsResident()) m_ResidentBytes += texture->GetSizeBytes();
+
+    Entry& entry = m_Entries[key];
+    entry.texture = std::move(texture);
+    entry.version = version;
+    entry.lastUse = ++m_UseCounter;
+
+    // Take the caller's reference before trimming so the new texture is never a candidate
+    TextureHandle handle = entry.texture;
+    if (m_ResidentBytes > m_BudgetBytes) {
+        Trim();
+    }
+    return handle;
+}
+
+std::shared_ptr<CachedTexture> TextureCache::CreatePending(const std::string& key, uint64_t version,
+                                                           const std::string& name, uint64_t decodeId) {
+    auto texture = std::shared_ptr<CachedTexture>(new CachedTexture());
+    texture->m_Device = m_Device;
+    texture->m_Name = name;
+    texture->m_Placeholder = GetLoadingTexture();
+
+    PendingTexture& pending = m_Decoding[decodeId];
+    pending.texture = texture;
+    pending.key = key;
+
+    // Entered right away (size 0 until resident) so repeated requests share the stream
+    Insert(key, version, texture);
+    return texture;
+}
+
+// ============================================================================
+// Budget
+// ============================================================================
+
+void TextureCache::SetBudget(size_t budgetBytes) {
+    m_BudgetBytes = budgetBytes;
+    Trim();
+}
+
+void TextureCache::Trim() {
+    if (m_ResidentBytes <= m_BudgetBytes) return;
+
+    // Only the cache's own reference is left on these, so nothing can be sampling them
+    // (streaming textures are also held by their pending request)
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (const auto& [key, entry] : m_Entries) {
+        if (entry.texture.use_count() == 1) {
+            candidates.emplace_back(entry.lastUse, key);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& [lastUse, key] : candidates) {
+        if (m_ResidentBytes <= m_BudgetBytes) break;
+
+        auto it = m_Entries.find(key);
+        if (it->second.texture->IsResident()) m_ResidentBytes -= it->second.texture->GetSizeBytes();
+        m_Entries.erase(it);
+        ++m_Evictions;
+    }
+
+    if (m_ResidentBytes > m_BudgetBytes) {
+        LUCENT_CORE_DEBUG("TextureCache: {} MB in use exceeds the {} MB budget",
+            m_ResidentBytes >> 20, m_BudgetBytes >> 20);
+    }
+}
+
+TextureCacheStats TextureCache::GetStats() const {
+    TextureCacheStats stats;
+    stats.hits = m_Hits;
+    stats.misses = m_Misses;
+    stats.reloads = m_Reloads;
+    stats.evictions = m_Evictions;
+    stats.residentBytes = m_ResidentBytes;
+    stats.budgetBytes = m_BudgetBytes;
+    stats.textureCount = static_cast<uint32_t>(m_Entries.size());
+    for (const auto& [key, entry] : m_Entries) {
+        if (entry.texture.use_count() > 1) ++stats.referencedCount;
+    }
+    stats.streamingCount = static_cast<uint32_t>(m_Decoding.size());
+    for (const UploadBatch& batch : m_UploadBatches) {
+        stats.streamingCount += static_cast<uint32_t>(batch.textures.size());
+    }
+    stats.stagingBytesInUse = m_StagingRing.GetUsedBytes();
+    return stats;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+uint64_t TextureCache::GetFileVersion(const std::string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return 0;
+    return static_cast<uint64_t>(time.time_since_epoch().count());
+}
+
+TextureProcessSettings TextureCache::MakeProcessSettings(const std::string& key, uint64_t version,
+                                                         TextureColorSpace colorSpace) const {
+    TextureProcessSettings settings;
+    settings.sRGB = colorSpace == TextureColorSpace::sRGB;
+    settings.generateMips = true;
+    settings.compress = m_Device && m_Device->GetContext()->GetDeviceFeatures().textureCompressionBC;
+    settings.sourceVersion = version;
+    if (!m_DiskCacheDirectory.empty() && version != 0) {
+        settings.cachePath = GetTextureContainerPath(m_DiskCacheDirectory, key);
+    }
+    return settings;
+}
+
+std::string TextureCache::MakeKey(const std::string& name, TextureColorSpace colorSpace) {
+    return (colorSpace == TextureColorSpace::sRGB ? "srgb:" : "linear:") + name;
+}
+
+std::string TextureCache::NormalizePath(const std::string& path) {
+    // So "tex/a.png" and "./tex/../tex/a.png" share an entry
+    std::error_code ec;
+    std::filesystem::path absolutePath = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : absolutePath).lexically_normal().generic_string();
+}
+
+static VkFormat GetVkFormat(const ProcessedTexture& processed) {
+    switch (processed.format) {
+        case TextureBlockFormat::BC1: return processed.sRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TextureBlockFormat::BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case TextureBlockFormat::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureBlockFormat::BC6H: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        case TextureBlockFormat::BC7: return processed.sRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureBlockFormat::None: break;
+    }
+    if (processed.hdr) return VK_FORMAT_R32G32B32A32_SFLOAT;
+    return processed.sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+// ============================================================================
+// Upload
+// ============================================================================
+
+std::shared_ptr<CachedTexture> TextureCache::Upload(const ProcessedTexture& processed, const std::string& name) {
+    BufferDesc stagingDesc{};
+    stagingDesc.size = processed.GetSizeBytes();
+    stagingDesc.usage = BufferUsage::Staging;
+    stagingDesc.hostVisible = true;
+    stagingDesc.debugName = "TextureCacheStaging";
+
+    Buffer staging;
+    if (!staging.Init(m_Device, stagingDesc)) {
+        return nullptr;
+    }
+    staging.Upload(processed.data.data(), processed.GetSizeBytes());
+
+    auto texture = std::shared_ptr<CachedTexture>(new CachedTexture());
+    texture->m_Device = m_Device;
+    texture->m_Name = name;
+
+    VkCommandBuffer cmd = m_Device->BeginSingleTimeCommands();
+    const bool recorded = RecordUpload(cmd, VK_NULL_HANDLE, *texture, processed, staging.GetHandle(), 0);
+    m_Device->EndSingleTimeCommands(cmd);
+    staging.Shutdown();
+
+    if (!recorded) return nullptr;
+    texture->m_Resident = true;
+    return texture;
+}
+
+bool TextureCache::RecordUpload(VkCommandBuffer cmd, VkCommandBuffer acquireCmd, CachedTexture& texture,
+                                const ProcessedTexture& processed, VkBuffer staging, size_t offset) {
+    if (processed.levels.empty()) return false;
+
+    // The mip chain arrives complete from the CPU, so nothing is blitted and the image only
+    // needs to be a transfer destination
+    texture.m_MipLevels = processed.GetMipCount();
+    texture.m_SizeBytes = processed.GetSizeBytes();
+
+    ImageDesc imageDesc{};
+    imageDesc.width = processed.width;
+    imageDesc.height = processed.height;
+    imageDesc.format = GetVkFormat(processed);
+    imageDesc.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageDesc.mipLevels = texture.m_MipLevels;
+    imageDesc.debugName = texture.m_Name.c_str();
+    // Single and dual channel formats still read like the RGBA8 they replaced: greyscale as grey
+    // and normal XY with a neutral Z (shaders that decode normals rebuild Z from XY)
+    if (processed.format == TextureBlockFormat::BC4) {
+        imageDesc.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                                 VK_COMPONENT_SWIZZLE_ONE };
+    } else if (processed.format == TextureBlockFormat::BC5) {
+        imageDesc.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_ONE,
+                                 VK_COMPONENT_SWIZZLE_ONE };
+    }
+
+    if (!texture.m_Image.Init(m_Device, imageDesc) || !CreateSampler(texture)) {
+        return false;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = texture.m_Image.GetHandle();
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = texture.m_MipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        0, nullptr, 0, nullptr, 1, &barrier);
+
+    std::vector<VkBufferImageCopy> regions(processed.levels.size());
+    for (size_t i = 0; i < processed.levels.size(); ++i) {
+        const TextureLevel& level = processed.levels[i];
+        VkBufferImageCopy& region = regions[i];
+        region.bufferOffset = static_cast<VkDeviceSize>(offset + level.offset);
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = static_cast<uint32_t>(i);
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { level.width, level.height, 1 };
+    }
+
+    vkCmdCopyBufferToImage(cmd, staging, texture.m_Image.GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+
+    // Sampled by both raster and ray tracing shaders, so release to every stage
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    if (acquireCmd == VK_NULL_HANDLE) {
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+    } else {
+        // Queue family ownership transfer: the same layout change recorded as a release on the
+        // transfer queue and an acquire on the graphics queue. The release's destination and the
+        // acquire's source access are ignored.
+        barrier.srcQueueFamilyIndex = m_UploadFamily;
+        barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(acquireCmd,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    LUCENT_CORE_DEBUG("Cached texture '{}': {}x{}, {} mips, {}", texture.m_Name, processed.width, processed.height,
+        texture.m_MipLevels, GetBlockFormatName(processed.format));
+    return true;
+}
+
+bool TextureCache::CreateSampler(CachedTexture& texture) {
+    VkPhysicalDevice physicalDevice = m_Device->GetContext()->GetPhysicalDevice();
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    // Only enable anisotropy if the feature is enabled on the logical device
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+    if (features.samplerAnisotropy) {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        samplerInfo.anisotropyEnable = VK_TRUE;
+        samplerInfo.maxAnisotropy = props.limits.maxSamplerAnisotropy > 0.0f
+            ? std::min(16.0f, props.limits.maxSamplerAnisotropy)
+            : 1.0f;
+    } else {
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+    }
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(texture.m_MipLevels);
+
+    if (vkCreateSampler(m_Device->GetContext()->GetDevice(), &samplerInfo, nullptr, &texture.m_Sampler) != VK_SUCCESS) {
+        LUCENT_CORE_ERROR("TextureCache: failed to create sampler for '{}'", texture.m_Name);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+void TextureCache::Update() {
+    if (!m_Device || !m_DecodeQueue) return;
+    LUCENT_PROFILE_FUNCTION();
+
+    RetireUploads(false);
+    SubmitUploads();
+}
+
+void TextureCache::RetireUploads(bool wait) {
+    VkDevice device = m_Device->GetHandle();
+
+    bool retired = false;
+    while (!m_UploadBatches.empty()) {
+        UploadBatch& batch = m_UploadBatches.front();
+        if (wait) {
+            vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        } else if (vkGetFenceStatus(device, batch.fence) != VK_SUCCESS) {
+            break; // Batches complete in submission order
+        }
+
+        if (batch.ringBatch != 0) {
+            m_StagingRing.Retire(batch.ringBatch);
+        }
+        for (PendingTexture& pending : batch.textures) {
+            CachedTexture& texture = *pending.texture;
+            texture.m_Resident = true;
+            texture.m_Placeholder.reset();
+
+            // Account it only if the request was not superseded (file edited) in the meantime
+            auto it = m_Entries.find(pending.key);
+            if (it != m_Entries.end() && it->second.texture == pending.texture) {
+                m_ResidentBytes += texture.GetSizeBytes();
+            }
+        }
+
+        FreeBatch(batch);
+        m_UploadBatches.pop_front();
+        retired = true;
+    }
+
+    if (retired) {
+        ++m_ResidencyGeneration;
+        Trim();
+    }
+}
+
+void TextureCache::SubmitUploads() {
+    if (m_Decoded.empty()) {
+        std::vector<TextureDecodeQueue::Result> results = m_DecodeQueue->PopCompleted(kUploadBytesPerFrame);
+        m_Decoded.insert(m_Decoded.end(), std::make_move_iterator(results.begin()),
+                         std::make_move_iterator(results.end()));
+    }
+    if (m_Decoded.empty()) return;
+
+    VkDevice device = m_Device->GetHandle();
+    UploadBatch batch;
+    size_t uploadedBytes = 0;
+
+    while (!m_Decoded.empty()) {
+        TextureDecodeQueue::Result& result = m_Decoded.front();
+        auto pendingIt = m_Decoding.find(result.id);
+        if (pendingIt == m_Decoding.end()) {
+            m_Decoded.pop_front();
+            continue;
+        }
+
+        if (!result.success) {
+            MarkFailed(pendingIt->second, result.error);
+            m_Decoding.erase(pendingIt);
+            m_Decoded.pop_front();
+            continue;
+        }
+
+        // Superseded and unreferenced: nobody will ever sample it
+        if (pendingIt->second.texture.use_count() == 1) {
+            m_Decoding.erase(pendingIt);
+            m_Decoded.pop_front();
+            continue;
+        }
+
+        const size_t size = result.texture.GetSizeBytes();
+        if (uploadedBytes > 0 && uploadedBytes + size > kUploadBytesPerFrame) break;
+
+        VkBuffer staging = VK_NULL_HANDLE;
+        size_t offset = 0;
+        if (m_StagingMapped && size <= m_StagingRing.GetCapacity()) {
+            offset = m_StagingRing.Allocate(size);
+            if (offset == StagingRing::kInvalidOffset) break; // Ring full until earlier batches retire
+            std::memcpy(m_StagingMapped + offset, result.texture.data.data(), size);
+            staging = m_StagingBuffer.GetHandle();
+        } else {
+            BufferDesc stagingDesc{};
+            stagingDesc.size = size;
+            stagingDesc.usage = BufferUsage::Staging;
+            stagingDesc.hostVisible = true;
+            stagingDesc.debugName = "TextureCacheStaging";
+
+            auto dedicated = std::make_unique<Buffer>();
+            if (!dedicated->Init(m_Device, stagingDesc)) {
+                MarkFailed(pendingIt->second, "staging allocation failed");
+                m_Decoding.erase(pendingIt);
+                m_Decoded.pop_front();
+                continue;
+            }
+            dedicated->Upload(result.texture.data.data(), size);
+            staging = dedicated->GetHandle();
+            batch.dedicatedStaging.push_back(std::move(dedicated));
+        }
+
+        if (batch.cmd == VK_NULL_HANDLE) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_UploadPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            vkAllocateCommandBuffers(device, &allocInfo, &batch.cmd);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(batch.cmd, &beginInfo);
+
+            if (m_AcquirePool != VK_NULL_HANDLE) {
+                allocInfo.commandPool = m_AcquirePool;
+                vkAllocateCommandBuffers(device, &allocInfo, &batch.acquireCmd);
+                vkBeginCommandBuffer(batch.acquireCmd, &beginInfo);
+            }
+        }
+
+        PendingTexture pending = std::move(pendingIt->second);
+        m_Decoding.erase(pendingIt);
+        if (RecordUpload(batch.cmd, batch.acquireCmd, *pending.texture, result.texture, staging, offset)) {
+            batch.textures.push_back(std::move(pending));
+        } else {
+            MarkFailed(pending, "image creation failed");
+        }
+
+        uploadedBytes += size;
+        m_Decoded.pop_front();
+    }
+
+    // Always close the ring batch so a failed submit cannot leak its space into the next one
+    batch.ringBatch = m_StagingRing.Submit();
+    if (batch.cmd == VK_NULL_HANDLE) return;
+
+    vkEndCommandBuffer(batch.cmd);
+    if (batch.acquireCmd != VK_NULL_HANDLE) vkEndCommandBuffer(batch.acquireCmd);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    vkCreateFence(device, &fenceInfo, nullptr, &batch.fence);
+
+    VkResult submitRes = VK_SUCCESS;
+    if (batch.acquireCmd == VK_NULL_HANDLE) {
+        // Graphics queue: the final barrier releases the image to every shader stage
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.cmd;
+        submitRes = vkQueueSubmit(m_UploadQueue, 1, &submitInfo, batch.fence);
+    } else {
+        // Copies on the transfer queue, then the ownership acquire on the graphics queue once they
+        // are done. The fence goes on the acquire, which completes last.
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        vkCreateSemaphore(device, &semaphoreInfo, nullptr, &batch.transferDone);
+
+        VkSubmitInfo copyInfo{};
+        copyInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        copyInfo.commandBufferCount = 1;
+        copyInfo.pCommandBuffers = &batch.cmd;
+        copyInfo.signalSemaphoreCount = 1;
+        copyInfo.pSignalSemaphores = &batch.transferDone;
+        submitRes = vkQueueSubmit(m_UploadQueue, 1, &copyInfo, VK_NULL_HANDLE);
+
+        if (submitRes == VK_SUCCESS) {
+            const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            VkSubmitInfo acquireInfo{};
+            acquireInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            acquireInfo.waitSemaphoreCount = 1;
+            acquireInfo.pWaitSemaphores = &batch.transferDone;
+            acquireInfo.pWaitDstStageMask = &waitStage;
+            acquireInfo.commandBufferCount = 1;
+            acquireInfo.pCommandBuffers = &batch.acquireCmd;
+            submitRes = vkQueueSubmit(m_Device->GetContext()->GetGraphicsQueue(), 1, &acquireInfo, batch.fence);
+            if (submitRes != VK_SUCCESS) {
+                // The copy was submitted and signals the semaphore; let it finish before freeing
+                vkQueueWaitIdle(m_UploadQueue);
+            }
+        }
+    }
+
+    if (submitRes != VK_SUCCESS) {
+        LUCENT_CORE_ERROR("TextureCache: upload submit failed: {}", static_cast<int>(submitRes));
+        for (const PendingTexture& pending : batch.textures) {
+            MarkFailed(pending, "upload submit failed");
+        }
+        // Retiring releases older batches too, so let those finish first
+        RetireUploads(true);
+        m_StagingRing.Retire(batch.ringBatch);
+        FreeBatch(batch);
+        return;
+    }
+
+    m_UploadBatches.push_back(std::move(batch));
+}
+
+void TextureCache::FreeBatch(UploadBatch& batch) {
+    VkDevice device = m_Device->GetHandle();
+    vkFreeCommandBuffers(device, m_UploadPool, 1, &batch.cmd);
+    if (batch.acquireCmd != VK_NULL_HANDLE) vkFreeCommandBuffers(device, m_AcquirePool, 1, &batch.acquireCmd);
+    if (batch.transferDone != VK_NULL_HANDLE) vkDestroySemaphore(device, batch.transferDone, nullptr);
+    vkDestroyFence(device, batch.fence, nullptr);
+}
+
+void TextureCache::MarkFailed(const PendingTexture& pending, const std::string& error) {
+    LUCENT_CORE_ERROR("Failed to load texture: {} - {}", pending.texture->m_Name, error);
+
+    pending.texture->m_Failed = true;
+    pending.texture->m_Placeholder = GetMissingTexture();
+
+    // Forget the entry so the next request retries
+    auto it = m_Entries.find(pending.key);
+    if (it != m_Entries.end() && it->second.texture == pending.texture) {
+        m_Entries.erase(it);
+    }
+    ++m_ResidencyGeneration;
+}
+
+} // namespace lucent::gfx
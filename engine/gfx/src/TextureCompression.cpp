@@ -0,0 +1,444 @@
+#include "lucent/gfx/TextureProcessing.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// BC encoders. Each picks its endpoints along the block's principal axis (PCA) and then the
+// nearest palette entry per texel: one fixed mode per format, favouring predictable speed over
+// the last fraction of a dB an exhaustive mode search would buy.
+
+namespace lucent::gfx {
+
+const char* GetBlockFormatName(TextureBlockFormat format) {
+    switch (format) {
+        case TextureBlockFormat::None: return "RGBA";
+        case TextureBlockFormat::BC1: return "BC1";
+        case TextureBlockFormat::BC4: return "BC4";
+        case TextureBlockFormat::BC5: return "BC5";
+        case TextureBlockFormat::BC6H: return "BC6H";
+        case TextureBlockFormat::BC7: return "BC7";
+    }
+    return "Unknown";
+}
+
+size_t GetBlockSizeBytes(TextureBlockFormat format) {
+    switch (format) {
+        case TextureBlockFormat::BC1:
+        case TextureBlockFormat::BC4:
+            return 8;
+        case TextureBlockFormat::BC5:
+        case TextureBlockFormat::BC6H:
+        case TextureBlockFormat::BC7:
+            return 16;
+        case TextureBlockFormat::None:
+            break;
+    }
+    return 0;
+}
+
+uint16_t FloatToHalfBits(float value) {
+    if (!(value > 0.0f)) return 0; // Also catches NaN
+    if (value >= 65504.0f) return 0x7BFF;
+    if (value < 6.103515625e-05f) {
+        return static_cast<uint16_t>(std::lround(value * 16777216.0f)); // Subnormal: value * 2^24
+    }
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t exponent = ((bits >> 23) & 0xFF) - 127 + 15;
+    const uint32_t mantissa = bits & 0x7FFFFF;
+    // Round to nearest; a mantissa carry correctly bumps the exponent
+    const uint32_t half = ((exponent << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1);
+    return static_cast<uint16_t>(std::min<uint32_t>(half, 0x7BFF));
+}
+
+namespace {
+
+// BC7/BC6H 4-bit index interpolation weights
+constexpr int kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// LSB-first bit packing into a 128-bit block
+class BlockBitWriter {
+public:
+    explicit BlockBitWriter(uint8_t* out) : m_Out(out) { std::memset(m_Out, 0, 16); }
+
+    void Write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; ++i, ++m_Bit) {
+            if (value & (1u << i)) {
+                m_Out[m_Bit >> 3] |= static_cast<uint8_t>(1u << (m_Bit & 7));
+            }
+        }
+    }
+
+private:
+    uint8_t* m_Out;
+    uint32_t m_Bit = 0;
+};
+
+// Principal axis of `count` points with `N` channels (power iteration on the covariance)
+template <int N>
+void PrincipalAxis(const float (*points)[N], int count, float mean[N], float axis[N]) {
+    for (int c = 0; c < N; ++c) mean[c] = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        for (int c = 0; c < N; ++c) mean[c] += points[i][c];
+    }
+    for (int c = 0; c < N; ++c) mean[c] /= static_cast<float>(count);
+
+    float cov[N][N] = {};
+    for (int i = 0; i < count; ++i) {
+        float d[N];
+        for (int c = 0; c < N; ++c) d[c] = points[i][c] - mean[c];
+        for (int a = 0; a < N; ++a) {
+            for (int b = 0; b < N; ++b) cov[a][b] += d[a] * d[b];
+        }
+    }
+
+    for (int c = 0; c < N; ++c) axis[c] = 1.0f;
+    for (int iter = 0; iter < 8; ++iter) {
+        float next[N] = {};
+        for (int a = 0; a < N; ++a) {
+            for (int b = 0; b < N; ++b) next[a] += cov[a][b] * axis[b];
+        }
+        float length = 0.0f;
+        for (int c = 0; c < N; ++c) length += next[c] * next[c];
+        length = std::sqrt(length);
+        if (length < 1e-8f) break; // Flat block: any axis will do
+        for (int c = 0; c < N; ++c) axis[c] = next[c] / length;
+    }
+}
+
+// Endpoints at the extremes of the points' projection onto the principal axis
+template <int N>
+void FitEndpoints(const float (*points)[N], int count, float lo, float hi, float e0[N], float e1[N]) {
+    float mean[N], axis[N];
+    PrincipalAxis<N>(points, count, mean, axis);
+
+    float minT = 0.0f, maxT = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        float t = 0.0f;
+        for (int c = 0; c < N; ++c) t += (points[i][c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < N; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * maxT, lo, hi);
+        e1[c] = std::clamp(mean[c] + axis[c] * minT, lo, hi);
+    }
+}
+
+template <int N, typename T>
+uint32_t NearestIndex(const T* value, const T (*palette)[N], uint32_t paletteSize) {
+    uint32_t best = 0;
+    int64_t bestError = INT64_MAX;
+    for (uint32_t p = 0; p < paletteSize; ++p) {
+        int64_t error = 0;
+        for (int c = 0; c < N; ++c) {
+            const int64_t d = static_cast<int64_t>(value[c]) - static_cast<int64_t>(palette[p][c]);
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            best = p;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// BC1
+// ============================================================================
+
+uint16_t PackRGB565(const float rgb[3]) {
+    const auto r = static_cast<uint16_t>(std::lround(rgb[0] * 31.0f / 255.0f));
+    const auto g = static_cast<uint16_t>(std::lround(rgb[1] * 63.0f / 255.0f));
+    const auto b = static_cast<uint16_t>(std::lround(rgb[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void UnpackRGB565(uint16_t c, int rgb[3]) {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void EncodeBC1(const uint8_t (*texels)[4], uint8_t* out) {
+    float points[16][3];
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) points[i][c] = texels[i][c];
+    }
+
+    float e0[3], e1[3];
+    FitEndpoints<3>(points, 16, 0.0f, 255.0f, e0, e1);
+    // Inset by 1/16 of the range: the extremes are rarely hit exactly after 565 rounding
+    for (int c = 0; c < 3; ++c) {
+        const float inset = (e0[c] - e1[c]) / 16.0f;
+        e0[c] -= inset;
+        e1[c] += inset;
+    }
+
+    uint16_t c0 = PackRGB565(e0);
+    uint16_t c1 = PackRGB565(e1);
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        // c0 > c1 selects the opaque four-colour mode
+        if (c0 < c1) std::swap(c0, c1);
+
+        int palette[4][3];
+        UnpackRGB565(c0, palette[0]);
+        UnpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int value[3] = { texels[i][0], texels[i][1], texels[i][2] };
+            indices |= NearestIndex<3, int>(value, palette, 4) << (2 * i);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(c0);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+// ============================================================================
+// BC4 / BC5
+// ============================================================================
+
+void EncodeBC4(const uint8_t (*texels)[4], int channel, uint8_t* out) {
+    int lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        lo = std::min<int>(lo, texels[i][channel]);
+        hi = std::max<int>(hi, texels[i][channel]);
+    }
+
+    out[0] = static_cast<uint8_t>(hi);
+    out[1] = static_cast<uint8_t>(lo);
+    uint64_t indices = 0;
+    if (hi != lo) {
+        // r0 > r1: eight-value mode, entries 2..7 interpolate from r0 to r1
+        int palette[8][1];
+        palette[0][0] = hi;
+        palette[1][0] = lo;
+        for (int p = 2; p < 8; ++p) {
+            palette[p][0] = ((8 - p) * hi + (p - 1) * lo) / 7;
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int value[1] = { texels[i][channel] };
+            indices |= static_cast<uint64_t>(NearestIndex<1, int>(value, palette, 8)) << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+// ============================================================================
+// BC7 (mode 6: one subset, RGBA endpoints 7+1 bits, 4-bit indices)
+// ============================================================================
+
+// 8-bit value -> 7-bit endpoint with shared p-bit; picks the p-bit with the lower error
+void QuantizeBC7Endpoint(const float value[4], bool opaque, uint32_t c7[4], uint32_t& pbit, int rec[4]) {
+    float bestError = 1e30f;
+    for (uint32_t p = 0; p < 2; ++p) {
+        // Opaque blocks need p=1 to reach alpha 255 exactly
+        if (opaque && p == 0) continue;
+
+        float error = 0.0f;
+        uint32_t q[4];
+        for (int c = 0; c < 4; ++c) {
+            const float v = (value[c] - static_cast<float>(p)) / 2.0f;
+            q[c] = static_cast<uint32_t>(std::clamp(std::lround(v), 0L, 127L));
+            const float d = static_cast<float>((q[c] << 1) | p) - value[c];
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pbit = p;
+            for (int c = 0; c < 4; ++c) {
+                c7[c] = q[c];
+                rec[c] = static_cast<int>((q[c] << 1) | p);
+            }
+        }
+    }
+}
+
+void EncodeBC7(const uint8_t (*texels)[4], uint8_t* out) {
+    float points[16][4];
+    bool opaque = true;
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) points[i][c] = texels[i][c];
+        opaque = opaque && texels[i][3] == 255;
+    }
+
+    float e0[4], e1[4];
+    FitEndpoints<4>(points, 16, 0.0f, 255.0f, e0, e1);
+
+    uint32_t q0[4], q1[4], p0 = 1, p1 = 1;
+    int rec[2][4];
+    QuantizeBC7Endpoint(e0, opaque, q0, p0, rec[0]);
+    QuantizeBC7Endpoint(e1, opaque, q1, p1, rec[1]);
+
+    int palette[16][4];
+    for (int p = 0; p < 16; ++p) {
+        for (int c = 0; c < 4; ++c) {
+            palette[p][c] = ((64 - kWeights4[p]) * rec[0][c] + kWeights4[p] * rec[1][c] + 32) >> 6;
+        }
+    }
+    uint32_t indices[16];
+    for (int i = 0; i < 16; ++i) {
+        const int value[4] = { texels[i][0], texels[i][1], texels[i][2], texels[i][3] };
+        indices[i] = NearestIndex<4, int>(value, palette, 16);
+    }
+
+    // The anchor (texel 0) index is stored with its top bit implied zero
+    if (indices[0] >= 8) {
+        std::swap(q0, q1);
+        std::swap(p0, p1);
+        for (uint32_t& index : indices) index = 15 - index;
+    }
+
+    BlockBitWriter bits(out);
+    bits.Write(1u << 6, 7); // Mode 6
+    for (int c = 0; c < 4; ++c) {
+        bits.Write(q0[c], 7);
+        bits.Write(q1[c], 7);
+    }
+    bits.Write(p0, 1);
+    bits.Write(p1, 1);
+    for (int i = 0; i < 16; ++i) {
+        bits.Write(indices[i], i == 0 ? 3 : 4);
+    }
+}
+
+// ============================================================================
+// BC6H (mode 11: one region, 10-bit endpoints, 4-bit indices, unsigned)
+// ============================================================================
+
+int UnquantizeBC6H(int q) {
+    if (q == 0) return 0;
+    if (q == 1023) return 0xFFFF;
+    return ((q << 16) + 0x8000) >> 10;
+}
+
+int FinishBC6H(int unquantized) {
+    return (unquantized * 31) >> 6;
+}
+
+int QuantizeBC6H(float halfBits) {
+    // Inverse of FinishBC6H(UnquantizeBC6H(q)), then a local search for the closest
+    const int guess = static_cast<int>(halfBits * 64.0f / 31.0f) >> 6;
+    int best = 0;
+    float bestError = 1e30f;
+    for (int q = std::max(0, guess - 1); q <= std::min(1023, guess + 1); ++q) {
+        const float error = std::abs(static_cast<float>(FinishBC6H(UnquantizeBC6H(q))) - halfBits);
+        if (error < bestError) {
+            bestError = error;
+            best = q;
+        }
+    }
+    return best;
+}
+
+void EncodeBC6H(const float (*texels)[4], uint8_t* out) {
+    // Fit in half-bit space, which is roughly logarithmic like the interpolation itself
+    float points[16][3];
+    int halves[16][3];
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            halves[i][c] = FloatToHalfBits(texels[i][c]);
+            points[i][c] = static_cast<float>(halves[i][c]);
+        }
+    }
+
+    float e0[3], e1[3];
+    FitEndpoints<3>(points, 16, 0.0f, static_cast<float>(0x7BFF), e0, e1);
+
+    int q0[3], q1[3];
+    for (int c = 0; c < 3; ++c) {
+        q0[c] = QuantizeBC6H(e0[c]);
+        q1[c] = QuantizeBC6H(e1[c]);
+    }
+
+    int palette[16][3];
+    for (int p = 0; p < 16; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            const int a = UnquantizeBC6H(q0[c]);
+            const int b = UnquantizeBC6H(q1[c]);
+            palette[p][c] = FinishBC6H(((64 - kWeights4[p]) * a + kWeights4[p] * b + 32) >> 6);
+        }
+    }
+    uint32_t indices[16];
+    for (int i = 0; i < 16; ++i) {
+        indices[i] = NearestIndex<3, int>(halves[i], palette, 16);
+    }
+
+    if (indices[0] >= 8) {
+        std::swap(q0, q1);
+        for (uint32_t& index : indices) index = 15 - index;
+    }
+
+    BlockBitWriter bits(out);
+    bits.Write(0x03, 5); // Mode 11
+    for (int c = 0; c < 3; ++c) bits.Write(static_cast<uint32_t>(q0[c]), 10);
+    for (int c = 0; c < 3; ++c) bits.Write(static_cast<uint32_t>(q1[c]), 10);
+    for (int i = 0; i < 16; ++i) {
+        bits.Write(indices[i], i == 0 ? 3 : 4);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Image compression
+// ============================================================================
+
+std::vector<uint8_t> CompressImage(const DecodedImage& image, TextureBlockFormat format) {
+    LUCENT_PROFILE_FUNCTION();
+    const size_t blockBytes = GetBlockSizeBytes(format);
+    if (blockBytes == 0 || image.width == 0 || image.height == 0) return {};
+
+    const uint32_t blocksX = (image.width + 3) / 4;
+    const uint32_t blocksY = (image.height + 3) / 4;
+    std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    JobSystem::Get().ParallelFor(blocksY, 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t by = begin; by < end; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                uint8_t* block = out.data() + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+
+                // Gather the 4x4 texels, replicating the edge for partial blocks
+                uint8_t texels[16][4] = {};
+                float texelsF[16][4] = {};
+                for (uint32_t i = 0; i < 16; ++i) {
+                    const uint32_t x = std::min(bx * 4 + (i & 3), image.width - 1);
+                    const uint32_t y = std::min(by * 4 + (i >> 2), image.height - 1);
+                    const size_t pixel = static_cast<size_t>(y) * image.width + x;
+                    if (image.hdr) {
+                        std::memcpy(texelsF[i], image.pixels.data() + pixel * 16, 16);
+                    } else {
+                        std::memcpy(texels[i], image.pixels.data() + pixel * 4, 4);
+                    }
+                }
+
+                switch (format) {
+                    case TextureBlockFormat::BC1: EncodeBC1(texels, block); break;
+                    case TextureBlockFormat::BC4: EncodeBC4(texels, 0, block); break;
+                    case TextureBlockFormat::BC5:
+                        EncodeBC4(texels, 0, block);
+                        EncodeBC4(texels, 1, block + 8);
+                        break;
+                    case TextureBlockFormat::BC6H: EncodeBC6H(texelsF, block); break;
+                    case TextureBlockFormat::BC7: EncodeBC7(texels, block); break;
+                    case TextureBlockFormat::None: break;
+                }
+            }
+        }
+    });
+    return out;
+}
+
+} // namespace lucent::gfx
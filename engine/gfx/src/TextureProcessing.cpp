@@ -0,0 +1,509 @@
+#include "lucent/gfx/TextureProcessing.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <system_error>
+
+namespace lucent::gfx {
+
+namespace {
+
+// Bump when mip filtering or an encoder changes so stale cache files are regenerated
+constexpr uint32_t kEncoderRevision = 1;
+
+// ============================================================================
+// Colour helpers
+// ============================================================================
+
+const std::array<float, 256>& GetSRGBToLinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (int i = 0; i < 256; ++i) {
+            const float c = static_cast<float>(i) / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+uint8_t LinearToSRGB8(float value) {
+    value = std::clamp(value, 0.0f, 1.0f);
+    const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::lround(c * 255.0f));
+}
+
+uint8_t ToUnorm8(float value) {
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+// RGBA float working copy of one mip level. Colour is linear light, normals are in [-1, 1].
+struct FloatImage {
+    std::vector<float> pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+FloatImage ToFloatImage(const DecodedImage& image, bool sRGB, TextureContent content) {
+    FloatImage out;
+    out.width = image.width;
+    out.height = image.height;
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    out.pixels.resize(count * 4);
+
+    if (image.hdr) {
+        std::memcpy(out.pixels.data(), image.pixels.data(), count * 16);
+        return out;
+    }
+
+    const std::array<float, 256>& toLinear = GetSRGBToLinearTable();
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* src = image.pixels.data() + i * 4;
+        float* dst = out.pixels.data() + i * 4;
+        for (int c = 0; c < 3; ++c) {
+            if (content == TextureContent::NormalMap) {
+                dst[c] = static_cast<float>(src[c]) / 127.5f - 1.0f;
+            } else {
+                dst[c] = sRGB ? toLinear[src[c]] : static_cast<float>(src[c]) / 255.0f;
+            }
+        }
+        dst[3] = static_cast<float>(src[3]) / 255.0f;
+    }
+    return out;
+}
+
+DecodedImage FromFloatImage(const FloatImage& image, bool hdr, bool sRGB, TextureContent content) {
+    DecodedImage out;
+    out.width = image.width;
+    out.height = image.height;
+    out.hdr = hdr;
+    out.bytesPerPixel = hdr ? 16u : 4u;
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    out.pixels.resize(count * out.bytesPerPixel);
+
+    if (hdr) {
+        std::memcpy(out.pixels.data(), image.pixels.data(), count * 16);
+        return out;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* src = image.pixels.data() + i * 4;
+        uint8_t* dst = out.pixels.data() + i * 4;
+        for (int c = 0; c < 3; ++c) {
+            if (content == TextureContent::NormalMap) {
+                dst[c] = ToUnorm8(src[c] * 0.5f + 0.5f);
+            } else {
+                dst[c] = sRGB ? LinearToSRGB8(src[c]) : ToUnorm8(src[c]);
+            }
+        }
+        dst[3] = ToUnorm8(src[3]);
+    }
+    return out;
+}
+
+// Area-weighted box filter to half size. Odd dimensions give some destination texels a 3-texel
+// footprint, so every source texel contributes.
+FloatImage Downsample(const FloatImage& src, bool hdr, TextureContent content) {
+    FloatImage dst;
+    dst.width = std::max(1u, src.width / 2);
+    dst.height = std::max(1u, src.height / 2);
+    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+    // Each destination texel covers a src/dst-sized box; odd sizes give fractional edge coverage
+    struct Tap {
+        uint32_t index;
+        float weight;
+    };
+    auto footprint = [](uint32_t i, uint32_t srcSize, uint32_t dstSize) {
+        std::vector<Tap> taps;
+        const double begin = static_cast<double>(i) * srcSize / dstSize;
+        const double end = static_cast<double>(i + 1) * srcSize / dstSize;
+        for (uint32_t s = static_cast<uint32_t>(begin); s < srcSize && s < end; ++s) {
+            const double covered = std::min<double>(s + 1, end) - std::max<double>(s, begin);
+            if (covered > 1e-6) taps.push_back({ s, static_cast<float>(covered) });
+        }
+        return taps;
+    };
+    std::vector<std::vector<Tap>> columns(dst.width);
+    for (uint32_t x = 0; x < dst.width; ++x) columns[x] = footprint(x, src.width, dst.width);
+
+    JobSystem::Get().ParallelFor(dst.height, 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t y = begin; y < end; ++y) {
+            const std::vector<Tap> rows = footprint(y, src.height, dst.height);
+            for (uint32_t x = 0; x < dst.width; ++x) {
+                float sum[4] = {};
+                float weightedRGB[3] = {};
+                float count = 0.0f;
+                for (const Tap& row : rows) {
+                    for (const Tap& column : columns[x]) {
+                        const float w = row.weight * column.weight;
+                        const float* p = src.pixels.data() + (static_cast<size_t>(row.index) * src.width + column.index) * 4;
+                        for (int c = 0; c < 4; ++c) sum[c] += p[c] * w;
+                        for (int c = 0; c < 3; ++c) weightedRGB[c] += p[c] * p[3] * w;
+                        count += w;
+                    }
+                }
+
+                float* out = dst.pixels.data() + (static_cast<size_t>(y) * dst.width + x) * 4;
+                out[3] = sum[3] / count;
+                if (content == TextureContent::NormalMap) {
+                    const float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+                    for (int c = 0; c < 3; ++c) out[c] = length > 1e-6f ? sum[c] / length : (c == 2 ? 1.0f : 0.0f);
+                } else if (!hdr && sum[3] > 1e-6f) {
+                    // Alpha-weighted so transparent texels do not bleed their colour into the edge
+                    for (int c = 0; c < 3; ++c) out[c] = weightedRGB[c] / sum[3];
+                } else {
+                    for (int c = 0; c < 3; ++c) out[c] = sum[c] / count;
+                }
+            }
+        }
+    });
+    return dst;
+}
+
+// ============================================================================
+// Container encoding
+// ============================================================================
+
+constexpr uint8_t kKTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+constexpr char kSourceKey[] = "LucentSource";
+constexpr size_t kHeaderBytes = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+constexpr size_t kLevelAlignment = 16;
+
+// Numeric VkFormat values, so this file stays free of Vulkan headers
+uint32_t GetContainerVkFormat(TextureBlockFormat format, bool hdr, bool sRGB) {
+    switch (format) {
+        case TextureBlockFormat::BC1: return sRGB ? 132u : 131u;   // BC1_RGB_{SRGB,UNORM}_BLOCK
+        case TextureBlockFormat::BC4: return 139u;                 // BC4_UNORM_BLOCK
+        case TextureBlockFormat::BC5: return 141u;                 // BC5_UNORM_BLOCK
+        case TextureBlockFormat::BC6H: return 143u;                // BC6H_UFLOAT_BLOCK
+        case TextureBlockFormat::BC7: return sRGB ? 146u : 145u;   // BC7_{SRGB,UNORM}_BLOCK
+        case TextureBlockFormat::None: break;
+    }
+    if (hdr) return 109u;                                          // R32G32B32A32_SFLOAT
+    return sRGB ? 43u : 37u;                                       // R8G8B8A8_{SRGB,UNORM}
+}
+
+uint8_t GetSettingsFlags(const TextureProcessSettings& settings) {
+    return static_cast<uint8_t>((settings.sRGB ? 1u : 0u) | (settings.generateMips ? 2u : 0u) |
+                                (settings.compress ? 4u : 0u));
+}
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void PutU32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+void PutU64(std::vector<uint8_t>& out, size_t offset, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+uint32_t GetU32(const uint8_t* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    return value;
+}
+
+uint64_t GetU64(const uint8_t* data) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+bool Fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+} // namespace
+
+// ============================================================================
+// Classification
+// ============================================================================
+
+TextureContent ClassifyTexture(const DecodedImage& image, bool sRGB) {
+    if (image.hdr || sRGB || image.width == 0 || image.height == 0) return TextureContent::Color;
+
+    // A strided sample is plenty to tell the content apart
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    const size_t step = std::max<size_t>(1, count / 65536);
+
+    size_t samples = 0, grey = 0, unitVectors = 0;
+    for (size_t i = 0; i < count; i += step, ++samples) {
+        const uint8_t* p = image.pixels.data() + i * 4;
+        if (std::abs(p[0] - p[1]) <= 2 && std::abs(p[1] - p[2]) <= 2) ++grey;
+
+        const float x = p[0] / 127.5f - 1.0f;
+        const float y = p[1] / 127.5f - 1.0f;
+        const float z = p[2] / 127.5f - 1.0f;
+        const float lengthSq = x * x + y * y + z * z;
+        if (z > 0.0f && lengthSq > 0.8f && lengthSq < 1.2f) ++unitVectors;
+    }
+
+    if (grey == samples) return TextureContent::Grayscale;
+    if (unitVectors * 100 >= samples * 95) return TextureContent::NormalMap;
+    return TextureContent::Color;
+}
+
+TextureBlockFormat ChooseBlockFormat(const DecodedImage& image, bool sRGB, TextureContent content) {
+    if (image.hdr) return TextureBlockFormat::BC6H;
+
+    bool opaque = true;
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    for (size_t i = 0; i < count && opaque; ++i) {
+        opaque = image.pixels[i * 4 + 3] == 255;
+    }
+
+    if (content == TextureContent::NormalMap) return TextureBlockFormat::BC5;
+    if (content == TextureContent::Grayscale && opaque) return TextureBlockFormat::BC4;
+    // BC1 halves the size for opaque colour; alpha and packed data keep BC7's precision
+    if (sRGB && opaque) return TextureBlockFormat::BC1;
+    return TextureBlockFormat::BC7;
+}
+
+// ============================================================================
+// Mips
+// ============================================================================
+
+std::vector<DecodedImage> GenerateMipChain(const DecodedImage& base, bool sRGB, TextureContent content) {
+    LUCENT_PROFILE_FUNCTION();
+    std::vector<DecodedImage> chain;
+    chain.push_back(base);
+    if (base.width == 0 || base.height == 0) return chain;
+
+    // Filter in float from the previous level so rounding does not accumulate down the chain
+    FloatImage level = ToFloatImage(base, sRGB, content);
+    while (level.width > 1 || level.height > 1) {
+        level = Downsample(level, base.hdr, content);
+        chain.push_back(FromFloatImage(level, base.hdr, sRGB, content));
+    }
+    return chain;
+}
+
+ProcessedTexture ProcessTexture(const DecodedImage& image, const TextureProcessSettings& settings) {
+    LUCENT_PROFILE_FUNCTION();
+    ProcessedTexture out;
+    out.content = ClassifyTexture(image, settings.sRGB);
+    out.format = settings.compress ? ChooseBlockFormat(image, settings.sRGB, out.content) : TextureBlockFormat::None;
+    out.hdr = image.hdr;
+    out.sRGB = settings.sRGB && !image.hdr;
+    out.width = image.width;
+    out.height = image.height;
+
+    std::vector<DecodedImage> chain;
+    if (settings.generateMips) {
+        chain = GenerateMipChain(image, settings.sRGB, out.content);
+    } else {
+        chain.push_back(image);
+    }
+
+    for (const DecodedImage& level : chain) {
+        TextureLevel entry;
+        entry.width = level.width;
+        entry.height = level.height;
+        entry.offset = AlignUp(out.data.size(), kLevelAlignment);
+
+        if (out.format == TextureBlockFormat::None) {
+            entry.size = level.GetSizeBytes();
+            out.data.resize(entry.offset + entry.size);
+            std::memcpy(out.data.data() + entry.offset, level.pixels.data(), entry.size);
+        } else {
+            std::vector<uint8_t> blocks = CompressImage(level, out.format);
+            entry.size = blocks.size();
+            out.data.resize(entry.offset + entry.size);
+            std::memcpy(out.data.data() + entry.offset, blocks.data(), entry.size);
+        }
+        out.levels.push_back(entry);
+    }
+    return out;
+}
+
+// ============================================================================
+// Container
+// ============================================================================
+
+bool WriteTextureContainer(const std::string& path, const ProcessedTexture& texture,
+                           const TextureProcessSettings& settings, std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    const uint32_t levelCount = texture.GetMipCount();
+    if (levelCount == 0) return Fail(error, "texture has no levels");
+
+    // Key/value data: one entry, length-prefixed and padded to 4 bytes
+    std::vector<uint8_t> value(15);
+    PutU64(value, 0, settings.sourceVersion);
+    PutU32(value, 8, kEncoderRevision);
+    value[12] = static_cast<uint8_t>(texture.format);
+    value[13] = static_cast<uint8_t>(texture.content);
+    value[14] = static_cast<uint8_t>(GetSettingsFlags(settings) | (texture.hdr ? 8u : 0u));
+
+    const size_t levelIndexOffset = kHeaderBytes;
+    const size_t kvdOffset = levelIndexOffset + static_cast<size_t>(levelCount) * 24;
+    const uint32_t kvdEntryBytes = static_cast<uint32_t>(sizeof(kSourceKey) + value.size());
+    const size_t kvdBytes = AlignUp(4 + kvdEntryBytes, 4);
+
+    // KTX2 stores the smallest level first; the level index is still base level first
+    std::vector<size_t> fileOffsets(levelCount);
+    size_t fileSize = kvdOffset + kvdBytes;
+    for (uint32_t i = levelCount; i-- > 0;) {
+        fileSize = AlignUp(fileSize, kLevelAlignment);
+        fileOffsets[i] = fileSize;
+        fileSize += texture.levels[i].size;
+    }
+
+    std::vector<uint8_t> file(fileSize, 0);
+    std::memcpy(file.data(), kKTX2Identifier, sizeof(kKTX2Identifier));
+    const uint32_t blockBytes = static_cast<uint32_t>(GetBlockSizeBytes(texture.format));
+    PutU32(file, 12, GetContainerVkFormat(texture.format, texture.hdr, texture.sRGB));
+    PutU32(file, 16, blockBytes == 0 ? (texture.hdr ? 4u : 1u) : 1u); // typeSize
+    PutU32(file, 20, texture.width);
+    PutU32(file, 24, texture.height);
+    PutU32(file, 28, 0);            // pixelDepth
+    PutU32(file, 32, 0);            // layerCount
+    PutU32(file, 36, 1);            // faceCount
+    PutU32(file, 40, levelCount);
+    PutU32(file, 44, 0);            // supercompressionScheme
+    PutU32(file, 48, 0);            // dfdByteOffset (no data format descriptor: vkFormat is authoritative)
+    PutU32(file, 52, 0);            // dfdByteLength
+    PutU32(file, 56, static_cast<uint32_t>(kvdOffset));
+    PutU32(file, 60, static_cast<uint32_t>(kvdBytes));
+    PutU64(file, 64, 0);            // sgdByteOffset
+    PutU64(file, 72, 0);            // sgdByteLength
+
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const size_t entry = levelIndexOffset + static_cast<size_t>(i) * 24;
+        PutU64(file, entry, fileOffsets[i]);
+        PutU64(file, entry + 8, texture.levels[i].size);
+        PutU64(file, entry + 16, texture.levels[i].size);
+        std::memcpy(file.data() + fileOffsets[i], texture.data.data() + texture.levels[i].offset,
+                    texture.levels[i].size);
+    }
+
+    PutU32(file, kvdOffset, kvdEntryBytes);
+    std::memcpy(file.data() + kvdOffset + 4, kSourceKey, sizeof(kSourceKey));
+    std::memcpy(file.data() + kvdOffset + 4 + sizeof(kSourceKey), value.data(), value.size());
+
+    // Write next to the target and rename, so a concurrent reader never sees a partial file
+    std::error_code ec;
+    const std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    const std::filesystem::path temp = target.string() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return Fail(error, "cannot open " + temp.string());
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out) return Fail(error, "write failed: " + temp.string());
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return Fail(error, "cannot replace " + path);
+    }
+    return true;
+}
+
+bool ReadTextureContainer(const std::string& path, const TextureProcessSettings& settings, ProcessedTexture& out,
+                          std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    MappedFile file;
+    if (!file.Open(path)) return Fail(error, "cannot open " + path);
+
+    const auto* data = reinterpret_cast<const uint8_t*>(file.Data());
+    const size_t size = file.Size();
+    if (size < kHeaderBytes || std::memcmp(data, kKTX2Identifier, sizeof(kKTX2Identifier)) != 0) {
+        return Fail(error, "not a KTX2 file");
+    }
+
+    const uint32_t vkFormat = GetU32(data + 12);
+    const uint32_t width = GetU32(data + 20);
+    const uint32_t height = GetU32(data + 24);
+    const uint32_t levelCount = GetU32(data + 40);
+    const uint32_t kvdOffset = GetU32(data + 56);
+    const uint32_t kvdBytes = GetU32(data + 60);
+    if (width == 0 || height == 0 || levelCount == 0 || levelCount > 32 ||
+        kHeaderBytes + static_cast<size_t>(levelCount) * 24 > size ||
+        static_cast<size_t>(kvdOffset) + kvdBytes > size) {
+        return Fail(error, "corrupt header");
+    }
+
+    // Find our entry in the key/value data
+    const uint8_t* value = nullptr;
+    for (size_t offset = kvdOffset; offset + 4 <= static_cast<size_t>(kvdOffset) + kvdBytes;) {
+        const uint32_t entryBytes = GetU32(data + offset);
+        if (offset + 4 + entryBytes > static_cast<size_t>(kvdOffset) + kvdBytes) break;
+        if (entryBytes >= sizeof(kSourceKey) + 15 &&
+            std::memcmp(data + offset + 4, kSourceKey, sizeof(kSourceKey)) == 0) {
+            value = data + offset + 4 + sizeof(kSourceKey);
+            break;
+        }
+        offset += AlignUp(4 + entryBytes, 4);
+    }
+    if (!value) return Fail(error, "not written by this cache");
+
+    const uint8_t flags = value[14];
+    if (GetU64(value) != settings.sourceVersion || GetU32(value + 8) != kEncoderRevision ||
+        (flags & 7u) != GetSettingsFlags(settings)) {
+        return Fail(error, "stale");
+    }
+
+    ProcessedTexture result;
+    result.format = static_cast<TextureBlockFormat>(value[12]);
+    result.content = static_cast<TextureContent>(value[13]);
+    result.hdr = (flags & 8u) != 0;
+    result.sRGB = settings.sRGB && !result.hdr;
+    result.width = width;
+    result.height = height;
+    if (result.format > TextureBlockFormat::BC7 ||
+        GetContainerVkFormat(result.format, result.hdr, result.sRGB) != vkFormat) {
+        return Fail(error, "format mismatch");
+    }
+
+    const size_t blockBytes = GetBlockSizeBytes(result.format);
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const uint8_t* entry = data + kHeaderBytes + static_cast<size_t>(i) * 24;
+        const uint64_t fileOffset = GetU64(entry);
+        const uint64_t levelBytes = GetU64(entry + 8);
+
+        TextureLevel level;
+        level.width = std::max(1u, width >> i);
+        level.height = std::max(1u, height >> i);
+        const size_t expected = blockBytes != 0
+            ? static_cast<size_t>((level.width + 3) / 4) * ((level.height + 3) / 4) * blockBytes
+            : static_cast<size_t>(level.width) * level.height * (result.hdr ? 16u : 4u);
+        if (levelBytes != expected || fileOffset > size || levelBytes > size - fileOffset) {
+            return Fail(error, "corrupt level " + std::to_string(i));
+        }
+
+        level.offset = AlignUp(result.data.size(), kLevelAlignment);
+        level.size = static_cast<size_t>(levelBytes);
+        result.data.resize(level.offset + level.size);
+        std::memcpy(result.data.data() + level.offset, data + fileOffset, level.size);
+        result.levels.push_back(level);
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+std::string GetTextureContainerPath(const std::string& cacheDirectory, const std::string& key) {
+    // Stable across runs and platforms, unlike std::hash
+    const uint64_t hash = HashBytes(std::as_bytes(std::span(key.data(), key.size())));
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ktx2", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(cacheDirectory) / name).generic_string();
+}
+
+} // namespace lucent::gfx
@@ -0,0 +1,228 @@
+#include "lucent/gfx/TextureStreaming.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <stb_image.h>
+
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace lucent::gfx {
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+static bool FinishDecode(void* data, int width, int height, bool hdr, DecodedImage& out, std::string* error) {
+    if (!data) {
+        if (error) *error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+        return false;
+    }
+
+    out.width = static_cast<uint32_t>(width);
+    out.height = static_cast<uint32_t>(height);
+    out.hdr = hdr;
+    out.bytesPerPixel = hdr ? static_cast<uint32_t>(sizeof(float) * 4) : 4u;
+    out.pixels.resize(static_cast<size_t>(out.width) * out.height * out.bytesPerPixel);
+    std::memcpy(out.pixels.data(), data, out.pixels.size());
+    stbi_image_free(data);
+    return true;
+}
+
+bool DecodeImageFile(const std::string& path, bool flipVertically, DecodedImage& out, std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    // Per-thread flag: decodes run concurrently on workers with different settings
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+
+    int width = 0, height = 0, channels = 0;
+    if (stbi_is_hdr(path.c_str())) {
+        float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 4);
+        return FinishDecode(data, width, height, true, out, error);
+    }
+    stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    return FinishDecode(data, width, height, false, out, error);
+}
+
+bool DecodeImageMemory(const void* data, size_t size, bool flipVertically, DecodedImage& out, std::string* error) {
+    LUCENT_PROFILE_FUNCTION();
+    if (!data || size == 0 || size > static_cast<size_t>(INT_MAX)) {
+        if (error) *error = "invalid image data";
+        return false;
+    }
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+
+    const auto* bytes = static_cast<const stbi_uc*>(data);
+    const int length = static_cast<int>(size);
+    int width = 0, height = 0, channels = 0;
+    if (stbi_is_hdr_from_memory(bytes, length)) {
+        float* pixels = stbi_loadf_from_memory(bytes, length, &width, &height, &channels, 4);
+        return FinishDecode(pixels, width, height, true, out, error);
+    }
+    stbi_uc* pixels = stbi_load_from_memory(bytes, length, &width, &height, &channels, 4);
+    return FinishDecode(pixels, width, height, false, out, error);
+}
+
+static void ProcessAndCache(const DecodedImage& image, const TextureProcessSettings& settings, ProcessedTexture& out) {
+    out = ProcessTexture(image, settings);
+    if (!settings.cachePath.empty()) {
+        std::string error;
+        if (!WriteTextureContainer(settings.cachePath, out, settings, &error)) {
+            LUCENT_CORE_WARN("Texture cache write failed: {}", error);
+        }
+    }
+}
+
+bool LoadTextureFile(const std::string& path, bool flipVertically, const TextureProcessSettings& settings,
+                     ProcessedTexture& out, std::string* error) {
+    if (!settings.cachePath.empty() && ReadTextureContainer(settings.cachePath, settings, out)) {
+        return true;
+    }
+    DecodedImage image;
+    if (!DecodeImageFile(path, flipVertically, image, error)) return false;
+    ProcessAndCache(image, settings, out);
+    return true;
+}
+
+bool LoadTextureMemory(const void* data, size_t size, bool flipVertically, const TextureProcessSettings& settings,
+                       ProcessedTexture& out, std::string* error) {
+    if (!settings.cachePath.empty() && ReadTextureContainer(settings.cachePath, settings, out)) {
+        return true;
+    }
+    DecodedImage image;
+    if (!DecodeImageMemory(data, size, flipVertically, image, error)) return false;
+    ProcessAndCache(image, settings, out);
+    return true;
+}
+
+// ============================================================================
+// TextureDecodeQueue
+// ============================================================================
+
+struct TextureDecodeQueue::SharedState {
+    std::mutex mutex;
+    std::deque<Result> completed;
+    uint32_t pending = 0; // Scheduled and not yet popped
+};
+
+TextureDecodeQueue::TextureDecodeQueue()
+    : m_State(std::make_shared<SharedState>()) {}
+
+TextureDecodeQueue::~TextureDecodeQueue() {
+    WaitIdle();
+}
+
+uint64_t TextureDecodeQueue::EnqueueFile(std::string path, bool flipVertically, TextureProcessSettings settings) {
+    return Schedule([path = std::move(path), flipVertically, settings = std::move(settings)](Result& result) {
+        result.success = LoadTextureFile(path, flipVertically, settings, result.texture, &result.error);
+    });
+}
+
+uint64_t TextureDecodeQueue::EnqueueMemory(std::vector<uint8_t> encoded, bool flipVertically,
+                                           TextureProcessSettings settings) {
+    return Schedule([encoded = std::move(encoded), flipVertically, settings = std::move(settings)](Result& result) {
+        result.success = LoadTextureMemory(encoded.data(), encoded.size(), flipVertically, settings, result.texture,
+                                           &result.error);
+    });
+}
+
+uint64_t TextureDecodeQueue::Schedule(std::function<void(Result&)> decode) {
+    const uint64_t id = m_NextId++;
+    {
+        std::lock_guard<std::mutex> lock(m_State->mutex);
+        ++m_State->pending;
+    }
+
+    JobSystem::Get().Schedule([state = m_State, id, decode = std::move(decode)]() {
+        Result result;
+        result.id = id;
+        decode(result);
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->completed.push_back(std::move(result));
+    }, &m_Counter);
+    return id;
+}
+
+std::vector<TextureDecodeQueue::Result> TextureDecodeQueue::PopCompleted(size_t maxBytes) {
+    std::vector<Result> results;
+    size_t takenBytes = 0;
+
+    std::lock_guard<std::mutex> lock(m_State->mutex);
+    while (!m_State->completed.empty()) {
+        const size_t bytes = m_State->completed.front().texture.GetSizeBytes();
+        if (!results.empty() && takenBytes + bytes > maxBytes) break;
+
+        takenBytes += bytes;
+        results.push_back(std::move(m_State->completed.front()));
+        m_State->completed.pop_front();
+        --m_State->pending;
+    }
+    return results;
+}
+
+uint32_t TextureDecodeQueue::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_State->mutex);
+    return m_State->pending;
+}
+
+void TextureDecodeQueue::WaitIdle() {
+    JobSystem::Get().Wait(m_Counter);
+}
+
+// ============================================================================
+// StagingRing
+// ============================================================================
+
+void StagingRing::Reset(size_t capacity, size_t alignment) {
+    m_Alignment = alignment > 0 ? alignment : 1;
+    // Keep every wrap-around offset aligned
+    m_Capacity = capacity - capacity % m_Alignment;
+    m_Head = 0;
+    m_Tail = 0;
+    m_BatchStart = 0;
+    m_NextBatchId = 1;
+    m_Batches.clear();
+}
+
+size_t StagingRing::Allocate(size_t size) {
+    if (size == 0 || size > m_Capacity) return kInvalidOffset;
+
+    if (m_Head == m_Tail) {
+        // Nothing in flight: restart at the beginning of the buffer so large uploads fit
+        m_Head = (m_Head + m_Capacity - 1) / m_Capacity * m_Capacity;
+        m_Tail = m_Head;
+        m_BatchStart = m_Head;
+    }
+
+    uint64_t start = (m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+    size_t offset = static_cast<size_t>(start % m_Capacity);
+    if (offset + size > m_Capacity) {
+        // Not enough room before the end of the buffer: skip to the start
+        start += m_Capacity - offset;
+        offset = 0;
+    }
+    if (start + size - m_Tail > m_Capacity) return kInvalidOffset;
+
+    m_Head = start + size;
+    return offset;
+}
+
+uint64_t StagingRing::Submit() {
+    if (m_Head == m_BatchStart) return 0;
+
+    const uint64_t id = m_NextBatchId++;
+    m_Batches.push_back({ id, m_Head });
+    m_BatchStart = m_Head;
+    return id;
+}
+
+void StagingRing::Retire(uint64_t batchId) {
+    while (!m_Batches.empty() && m_Batches.front().id <= batchId) {
+        m_Tail = m_Batches.front().end;
+        m_Batches.pop_front();
+    }
+}
+
+} // namespace lucent::gfx
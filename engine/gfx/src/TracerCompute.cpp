@@ -1,6 +1,7 @@
 #include "lucent/gfx/TracerCompute.h"
 #include "lucent/gfx/PipelineBuilder.h"
 #include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
 #include <algorithm>
 
 namespace lucent::gfx {
@@ -10,6 +11,7 @@ namespace lucent::gfx {
 // ============================================================================
 
 void BVHBuilder::Build(const std::vector<Triangle>& triangles) {
+    LUCENT_PROFILE_FUNCTION();
     if (triangles.empty()) return;
     
     m_Triangles = triangles;
@@ -629,6 +631,7 @@ void TracerCompute::UpdateScene(const std::vector<BVHBuilder::Triangle>& inputTr
                                  const std::vector<GPUMaterial>& inputMaterials,
                                  const std::vector<GPULight>& inputLights,
                                  const std::vector<GPUVolume>& inputVolumes) {
+    LUCENT_PROFILE_FUNCTION();
     std::vector<BVHBuilder::Triangle> triangles = inputTriangles;
     std::vector<GPUMaterial> materials = inputMaterials;
     
@@ -1,7 +1,7 @@
 #include "lucent/gfx/TracerRayKHR.h"
 #include "lucent/gfx/PipelineBuilder.h"
 #include "lucent/core/Log.h"
-#include <stb_image.h>
+#include "lucent/core/Profiler.h"
 #include <cstring>
 #include <cmath>
 #include <algorithm>
@@ -32,80 +32,6 @@ static bool CreateRTSampler(VkDevice device, uint32_t mipLevels, VkSampler& outS
     return vkCreateSampler(device, &samplerInfo, nullptr, &outSampler) == VK_SUCCESS;
 }
 
-static void GenerateMipmapsRT(VkCommandBuffer cmd, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels) {
-    if (mipLevels <= 1) return;
-
-    int32_t mipWidth = static_cast<int32_t>(width);
-    int32_t mipHeight = static_cast<int32_t>(height);
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
-
-    for (uint32_t i = 1; i < mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-        vkCmdPipelineBarrier(cmd,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-            0, nullptr, 0, nullptr, 1, &barrier);
-
-        VkImageBlit blit{};
-        blit.srcOffsets[0] = { 0, 0, 0 };
-        blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-
-        int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
-        int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
-
-        blit.dstOffsets[0] = { 0, 0, 0 };
-        blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-
-        vkCmdBlitImage(cmd,
-            image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1, &blit, VK_FILTER_LINEAR);
-
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(cmd,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-            0, nullptr, 0, nullptr, 1, &barrier);
-
-        mipWidth = nextWidth;
-        mipHeight = nextHeight;
-    }
-
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(cmd,
-        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-        0, nullptr, 0, nullptr, 1, &barrier);
-}
-
 static bool CreateSolid1x1Texture(Device* device, VkFormat format, uint8_t r, uint8_t g, uint8_t b, uint8_t a,
                                   const char* debugName, std::unique_ptr<Image>& outImage) {
     if (outImage) return true;
@@ -293,6 +219,21 @@ void TracerRayKHR::Shutdown() {
     m_AccumulationImage.Shutdown();
     m_AlbedoImage.Shutdown();
     m_NormalImage.Shutdown();
+
+    // Release material textures back to the cache and destroy the fallbacks
+    m_MaterialTextures.clear();
+    m_MaterialTextureIsSRGB.clear();
+    m_MaterialTextureCount = 0;
+    m_FallbackTextureSRGB.reset();
+    m_FallbackTextureUNORM.reset();
+    if (m_FallbackSamplerSRGB != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_FallbackSamplerSRGB, nullptr);
+        m_FallbackSamplerSRGB = VK_NULL_HANDLE;
+    }
+    if (m_FallbackSamplerUNORM != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_FallbackSamplerUNORM, nullptr);
+        m_FallbackSamplerUNORM = VK_NULL_HANDLE;
+    }
     
     // Destroy pipeline
     if (m_Pipeline != VK_NULL_HANDLE) {
@@ -655,6 +596,7 @@ bool TracerRayKHR::CreateAccumulationImage(uint32_t width, uint32_t height) {
 }
 
 bool TracerRayKHR::BuildBLAS(const std::vector<BVHBuilder::Triangle>& triangles) {
+    LUCENT_PROFILE_FUNCTION();
     if (triangles.empty()) return false;
     
     // Wait for GPU to finish using old buffers before rebuilding
@@ -858,6 +800,7 @@ bool TracerRayKHR::BuildBLAS(const std::vector<BVHBuilder::Triangle>& triangles)
 }
 
 bool TracerRayKHR::BuildTLAS() {
+    LUCENT_PROFILE_FUNCTION();
     if (m_BLAS.handle == VK_NULL_HANDLE) return false;
     
     VkDevice device = m_Context->GetDevice();
@@ -1011,6 +954,7 @@ bool TracerRayKHR::BuildTLAS() {
 }
 
 bool TracerRayKHR::BuildVolumeBLAS(const std::vector<GPUVolume>& volumes) {
+    LUCENT_PROFILE_FUNCTION();
     // Build a procedural BLAS consisting of AABBs, one per volume.
     if (volumes.empty()) {
         // Destroy any existing volume BLAS
@@ -1154,6 +1098,7 @@ void TracerRayKHR::UpdateScene(const std::vector<BVHBuilder::Triangle>& triangle
                                 const std::vector<RTMaterialInstr>& materialInstrs,
                                 const std::vector<GPULight>& lights,
                                 const std::vector<GPUVolume>& volumes) {
+    LUCENT_PROFILE_FUNCTION();
     if (!m_Supported || triangles.empty()) return;
     
     // Build acceleration structures
@@ -1239,17 +1184,7 @@ void TracerRayKHR::UpdateScene(const std::vector<BVHBuilder::Triangle>& triangle
 
     // Load / keep alive material textures for this RT scene (global pool)
     {
-        // Destroy old samplers (images are owned and will be destroyed by their unique_ptr)
-        for (VkSampler s : m_MaterialTextureSamplers) {
-            if (s != VK_NULL_HANDLE) {
-                vkDestroySampler(m_Context->GetDevice(), s, nullptr);
-            }
-        }
-        m_MaterialTextureImages.clear();
-        m_MaterialTextureSamplers.clear();
         m_MaterialTextureIsSRGB.clear();
-        m_MaterialTextureImages.reserve(std::min<size_t>(materialTextures.size(), kMaxRTMaterialTextures));
-        m_MaterialTextureSamplers.reserve(std::min<size_t>(materialTextures.size(), kMaxRTMaterialTextures));
         m_MaterialTextureIsSRGB.reserve(std::min<size_t>(materialTextures.size(), kMaxRTMaterialTextures));
 
         // Lazy-create fallbacks (one sRGB, one UNORM) + samplers
@@ -1258,81 +1193,25 @@ void TracerRayKHR::UpdateScene(const std::vector<BVHBuilder::Triangle>& triangle
         CreateRTSampler(m_Context->GetDevice(), 1, m_FallbackSamplerSRGB);
         CreateRTSampler(m_Context->GetDevice(), 1, m_FallbackSamplerUNORM);
 
+        // Textures the raster material pipelines already uploaded are reused from the cache. The
+        // previous scene's handles are held until the new set is acquired so a tight budget cannot
+        // evict textures both scenes use.
+        TextureCache& textureCache = TextureCache::Get();
         const size_t loadCount = std::min<size_t>(materialTextures.size(), kMaxRTMaterialTextures);
+        std::vector<TextureHandle> textures;
+        textures.reserve(loadCount);
         for (size_t i = 0; i < loadCount; ++i) {
             const auto& key = materialTextures[i];
             m_MaterialTextureIsSRGB.push_back(key.sRGB ? uint8_t(1) : uint8_t(0));
 
-            // Load texture via stb into a GPU Image
-            std::unique_ptr<Image> img;
-            VkSampler sampler = VK_NULL_HANDLE;
-
-            if (!key.path.empty()) {
-                int w = 0, h = 0, comp = 0;
-                stbi_set_flip_vertically_on_load(1);
-                unsigned char* data = stbi_load(key.path.c_str(), &w, &h, &comp, 4);
-                if (data && w > 0 && h > 0) {
-                    const uint32_t width = static_cast<uint32_t>(w);
-                    const uint32_t height = static_cast<uint32_t>(h);
-                    const uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(w, h)))) + 1u;
-                    const VkFormat format = key.sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
-
-                    BufferDesc stagingDesc{};
-                    stagingDesc.size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4u;
-                    stagingDesc.usage = BufferUsage::Staging;
-                    stagingDesc.hostVisible = true;
-                    stagingDesc.debugName = "RTTexStaging";
-
-                    Buffer staging;
-                    if (staging.Init(m_Device, stagingDesc)) {
-                        staging.Upload(data, stagingDesc.size);
-
-                        img = std::make_unique<Image>();
-                        ImageDesc imageDesc{};
-                        imageDesc.width = width;
-                        imageDesc.height = height;
-                        imageDesc.format = format;
-                        imageDesc.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-                        imageDesc.mipLevels = mipLevels;
-                        imageDesc.debugName = key.path.c_str();
-
-                        if (img->Init(m_Device, imageDesc)) {
-                            VkCommandBuffer cmd = m_Device->BeginSingleTimeCommands();
-                            img->TransitionLayout(cmd, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-                            VkBufferImageCopy region{};
-                            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                            region.imageSubresource.mipLevel = 0;
-                            region.imageSubresource.baseArrayLayer = 0;
-                            region.imageSubresource.layerCount = 1;
-                            region.imageExtent = { width, height, 1 };
-
-                            vkCmdCopyBufferToImage(cmd, staging.GetHandle(), img->GetHandle(),
-                                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-                            GenerateMipmapsRT(cmd, img->GetHandle(), width, height, mipLevels);
-                            if (mipLevels == 1) {
-                                img->TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                            }
-
-                            m_Device->EndSingleTimeCommands(cmd);
-
-                            CreateRTSampler(m_Context->GetDevice(), mipLevels, sampler);
-                        } else {
-                            img.reset();
-                        }
-
-                        staging.Shutdown();
-                    }
-                }
-                if (data) stbi_image_free(data);
-            }
-
             // Keep slot alignment even if load failed (nullptr => fallback in descriptor write)
-            m_MaterialTextureImages.push_back(std::move(img));
-            m_MaterialTextureSamplers.push_back(sampler);
+            textures.push_back(textureCache.AcquireAsync(
+                key.path, key.sRGB ? TextureColorSpace::sRGB : TextureColorSpace::Linear));
         }
 
+        // BuildBLAS has already waited for the GPU, so the previous scene's handles can go
+        m_MaterialTextures = std::move(textures);
+
         m_MaterialTextureCount = static_cast<uint32_t>(loadCount);
     }
     
@@ -1454,6 +1333,16 @@ void TracerRayKHR::Trace(VkCommandBuffer cmd,
     // Update camera
     m_CameraBuffer.Upload(&camera, sizeof(GPUCamera));
 
+    // Streamed material textures became resident since the descriptors were written. The set is not
+    // update-after-bind, so let in-flight traces finish, and restart accumulation so placeholder
+    // samples do not linger in the image.
+    if (m_MaterialTexturesStreaming &&
+        m_MaterialTextureGeneration != TextureCache::Get().GetResidencyGeneration()) {
+        m_Context->WaitIdle();
+        m_DescriptorsDirty = true;
+        ResetAccumulation();
+    }
+
     // Update descriptors only when they actually changed (scene updated, image resized, descriptor set allocated).
     // Updating every frame can trip validation (descriptor set still in use by an in-flight command buffer).
     if (m_DescriptorsDirty) {
@@ -1523,23 +1412,26 @@ void TracerRayKHR::Trace(VkCommandBuffer cmd,
 
         // Material texture array (fixed-size)
         std::vector<VkDescriptorImageInfo> materialTexInfos(kMaxRTMaterialTextures);
+        m_MaterialTexturesStreaming = false;
+        m_MaterialTextureGeneration = TextureCache::Get().GetResidencyGeneration();
         for (uint32_t i = 0; i < kMaxRTMaterialTextures; ++i) {
             const bool wantSRGB = (i < m_MaterialTextureIsSRGB.size()) ? (m_MaterialTextureIsSRGB[i] != 0) : true;
             Image* fallbackImg = wantSRGB ? m_FallbackTextureSRGB.get() : m_FallbackTextureUNORM.get();
             VkSampler fallbackSampler = wantSRGB ? m_FallbackSamplerSRGB : m_FallbackSamplerUNORM;
 
-            Image* img = nullptr;
-            VkSampler sampler = VK_NULL_HANDLE;
-            if (i < m_MaterialTextureCount && i < m_MaterialTextureImages.size()) {
-                img = m_MaterialTextureImages[i].get();
-                sampler = (i < m_MaterialTextureSamplers.size()) ? m_MaterialTextureSamplers[i] : VK_NULL_HANDLE;
-            }
+            const CachedTexture* tex = (i < m_MaterialTextureCount && i < m_MaterialTextures.size())
+                ? m_MaterialTextures[i].get()
+                : nullptr;
 
             VkDescriptorImageInfo info{};
-            info.sampler = (img && sampler != VK_NULL_HANDLE) ? sampler : fallbackSampler;
-            info.imageView = (img ? img : fallbackImg)->GetView();
+            info.sampler = tex ? tex->GetSampler() : fallbackSampler;
+            info.imageView = tex ? tex->GetView() : fallbackImg->GetView();
             info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             materialTexInfos[i] = info;
+
+            if (tex && !tex->IsResident() && !tex->IsFailed()) {
+                m_MaterialTexturesStreaming = true;
+            }
         }
 
         // Environment map textures
@@ -390,6 +390,16 @@ bool VulkanContext::CreateLogicalDevice(const VulkanContextConfig& config) {
     } else {
         LUCENT_CORE_WARN("  samplerAnisotropy: NOT AVAILABLE");
     }
+
+    // BC formats let the texture cache upload block-compressed mip chains
+    if (coreFeatures.textureCompressionBC) {
+        deviceFeatures2.features.textureCompressionBC = VK_TRUE;
+        m_DeviceFeatures.textureCompressionBC = true;
+        LUCENT_CORE_INFO("  textureCompressionBC: ENABLED");
+    } else {
+        m_DeviceFeatures.textureCompressionBC = false;
+        LUCENT_CORE_WARN("  textureCompressionBC: NOT AVAILABLE");
+    }
     
     // Vulkan 1.2 features - only request if device supports them
     VkPhysicalDeviceVulkan12Features vulkan12Features{};
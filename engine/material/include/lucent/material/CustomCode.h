@@ -0,0 +1,57 @@
+#pragma once
+
+#include "lucent/material/MaterialGraph.h"
+#include "lucent/material/MaterialProgram.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lucent::material {
+
+// CustomCode bodies compiled once for the CPU and RT backends (the GLSL backend pastes the source).
+//
+// A body is a list of `type name = expr;`, `name = expr;` and `name op= expr;` statements over the
+// node's pins, using + - * /, swizzles, vector constructors and common GLSL built-ins. It compiles
+// to a flat list of expressions in evaluation order: identifiers are resolved to input slots and
+// earlier expressions at compile time, expressions over constants are folded and expressions no
+// output reads are dropped. Ops follow MaterialProgram (GLSL) semantics.
+
+struct CustomCodePin {
+    std::string name;
+    PinType type = PinType::Float;
+};
+
+struct CustomCodeExpr {
+    MaterialOp op = MaterialOp::Constant;   // Constant, Input, Swizzle, Combine or a math op
+    PinType type = PinType::Float;          // Components written
+    uint8_t argCount = 0;
+    uint32_t args[4] = {};                  // Earlier expressions, read with as many components as needed
+    uint32_t imm = 0;                       // Input: input pin index. Swizzle: selectors (MaterialOp::Swizzle)
+    glm::vec4 value = glm::vec4(0.0f);      // Constant
+};
+
+struct CompiledCustomCode {
+    std::vector<CustomCodeExpr> exprs;
+    std::vector<uint32_t> outputs;          // Expression per output pin, read as the pin's type
+    std::string error;                      // Why the body is not supported (exprs is then empty)
+
+    bool IsValid() const { return error.empty(); }
+};
+
+// Compile a body for the given pins. Input values have their pin's type; outputs never assigned
+// pass `In` through.
+CompiledCustomCode CompileCustomCode(const std::string& source, const std::vector<CustomCodePin>& inputs,
+                                     const std::vector<CustomCodePin>& outputs);
+
+// Compiled body of a CustomCode node. Cached by a hash of the source and the pin names and types,
+// so every graph copy and every evaluation shares one compile, and editing the code compiles it
+// again. Thread safe.
+std::shared_ptr<const CompiledCustomCode> GetCompiledCustomCode(const MaterialGraph& graph, const MaterialNode& node);
+
+// Evaluate a valid body at one point: inputs[i] is the value of input pin i, outputs[o] receives
+// output pin o (read as the pin's type).
+void EvaluateCustomCode(const CompiledCustomCode& code, const glm::vec4* inputs, glm::vec4* outputs);
+
+} // namespace lucent::material
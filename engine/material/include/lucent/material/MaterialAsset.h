@@ -2,15 +2,18 @@
 
 #include "lucent/material/MaterialGraph.h"
 #include "lucent/material/MaterialCompiler.h"
+#include "lucent/material/MaterialCompileQueue.h"
+#include "lucent/gfx/Buffer.h"
 #include "lucent/gfx/Device.h"
-#include "lucent/assets/Texture.h"
+#include "lucent/gfx/TextureCache.h"
 #include <vulkan/vulkan.h>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <future>
 #include <atomic>
+#include <utility>
 
 namespace lucent::material {
 
@@ -31,13 +34,24 @@ public:
     MaterialGraph& GetGraph() { return m_Graph; }
     const MaterialGraph& GetGraph() const { return m_Graph; }
     
-    // Recompile the material (call after editing the graph)
+    // Recompile the material (call after editing the graph). When only values changed (constant
+    // nodes, pin defaults) this just rewrites the parameter buffer.
     bool Recompile();
     
-    // Async recompile (compile shader in background, apply pipeline on main thread)
+    // Async recompile (compile shader in background, apply pipeline on main thread). Parameter-only
+    // edits are applied immediately instead. Compiles go through MaterialCompileQueue::Get().
     void RequestRecompileAsync();
     void PumpAsyncRecompile(); // call periodically from main thread (e.g. per-frame)
     bool IsRecompileInProgress() const { return m_AsyncCompiling.load(); }
+    // True once after an applied compile failed or changed IsValid() or the pipeline, whoever pumped it
+    bool ConsumeCompileStateChanged() { return std::exchange(m_CompileStateChanged, false); }
+    
+    // Where async compiles of this material go in the compile queue (also reprioritizes a queued one)
+    void SetCompilePriority(MaterialCompilePriority priority);
+    MaterialCompilePriority GetCompilePriority() const { return m_CompilePriority; }
+    
+    // False when the edits since the last compile only touched constant node values
+    bool NeedsShaderRecompile() const;
     
     // Check if the material is valid (compiled successfully)
     bool IsValid() const { return m_Valid; }
@@ -56,18 +70,25 @@ public:
     VkPipeline GetPipeline() const { return m_Pipeline; }
     VkPipelineLayout GetPipelineLayout() const { return m_PipelineLayout; }
     
-    // Get descriptor set for material textures
+    // Get descriptor set for material textures and the parameter buffer
     VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
     bool HasDescriptorSet() const { return m_DescriptorSet != VK_NULL_HANDLE; }
     
+    // True once a texture that was still streaming has become resident (or failed)
+    bool NeedsTextureRefresh() const;
+    // Rewrite the texture descriptors; the GPU must not be using the set
+    void RefreshTextureDescriptors();
+    
     // Editor preview helpers (not used by runtime renderer)
     size_t GetLoadedTextureCount() const { return m_Textures.size(); }
-    assets::Texture* GetLoadedTexture(size_t index) const { 
+    const gfx::CachedTexture* GetLoadedTexture(size_t index) const { 
         return index < m_Textures.size() ? m_Textures[index].get() : nullptr; 
     }
     
-    // Graph hash for cache lookup
+    // Structure hash of the compiled graph (MaterialGraph::ComputeStructureHash)
     uint64_t GetGraphHash() const { return m_GraphHash; }
+    // Parameter hash of the values in the parameter buffer (MaterialGraph::ComputeParameterHash)
+    uint64_t GetParameterHash() const { return m_ParameterHash; }
     
     // File path for asset management
     const std::string& GetFilePath() const { return m_FilePath; }
@@ -86,6 +107,9 @@ public:
 private:
     bool CreatePipeline(const std::vector<uint32_t>& fragmentSpirv);
     void DestroyPipeline();
+    void WriteTextureDescriptors();
+    // Pack the graph's constant values and pin defaults into the parameter buffer
+    void UpdateParameterBuffer();
     
     gfx::Device* m_Device = nullptr;
     VkRenderPass m_RenderPass = VK_NULL_HANDLE; // For legacy mode (nullptr = dynamic rendering)
@@ -97,6 +121,8 @@ private:
     std::string m_CompileError;
     std::string m_FilePath;
     uint64_t m_GraphHash = 0;
+    uint64_t m_ParameterHash = 0;
+    MaterialParameterLayout m_ParameterLayout; // Of the compiled shader
     
     // Vulkan resources
     VkShaderModule m_VertexShaderModule = VK_NULL_HANDLE;
@@ -106,16 +132,23 @@ private:
     VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
     VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+    std::unique_ptr<gfx::Buffer> m_ParameterBuffer; // Host visible; see MaterialParameterLayout
     
     // Keep textures alive for the lifetime of the descriptor set
-    std::vector<std::unique_ptr<assets::Texture>> m_Textures;
+    std::vector<gfx::TextureHandle> m_Textures;
+    bool m_TexturesStreaming = false;  // Some descriptors still point at a placeholder
+    uint64_t m_TextureGeneration = 0;  // TextureCache residency generation when last written
     
     // Async compile state (graph->GLSL->SPIRV runs on worker thread; Vulkan pipeline swap runs on main thread)
     std::atomic<bool> m_AsyncCompiling{ false };
-    std::atomic<bool> m_AsyncRecompileQueued{ false };
-    std::future<CompileResult> m_AsyncCompileFuture;
+    MaterialCompilePriority m_CompilePriority = MaterialCompilePriority::Visible;
+    bool m_CompileStateChanged = false;
 };
 
+// Parse a `.lmat` file into a graph without creating an asset (no GPU work, safe on any thread).
+// A file without nodes gives the default graph.
+bool LoadMaterialGraph(const std::string& path, MaterialGraph& outGraph, std::string& outError);
+
 // Manager for material assets (caching, loading, saving)
 class MaterialAssetManager {
 public:
@@ -145,8 +178,16 @@ public:
     // Reload all materials (after shader changes)
     void RecompileAll();
     
-    // Apply any finished async compiles (call from main thread, once per frame)
-    void PumpAsyncCompiles();
+    // Apply any finished async compiles (call from main thread, once per frame). Also sets each
+    // material's compile priority from the selection and last frame's MarkVisible() calls.
+    // Returns the materials whose compile failed or changed their validity or pipeline since the
+    // last call, including compiles applied elsewhere (e.g. by the graph editor), so views built
+    // from them can refresh.
+    std::vector<MaterialAsset*> PumpAsyncCompiles();
+    
+    // Compile priority hints: the material open in the editor, and materials drawn this frame
+    void SetSelectedMaterial(MaterialAsset* material) { m_SelectedMaterial = material; }
+    void MarkVisible(MaterialAsset* material) { m_VisibleMaterials.insert(material); }
     
     // Set the render pass for legacy Vulkan 1.1/1.2 mode (call before creating materials)
     void SetRenderPass(VkRenderPass renderPass) { m_RenderPass = renderPass; }
@@ -165,7 +206,14 @@ private:
     VkRenderPass m_RenderPass = VK_NULL_HANDLE;
     std::string m_MaterialsPath;
     std::unordered_map<std::string, std::unique_ptr<MaterialAsset>> m_Materials;
+    // Raw path -> normalized key. GetMaterial() runs per entity per frame; normalizing hits the
+    // filesystem and allocates, so each distinct spelling is resolved once. Cleared when full.
+    static constexpr size_t kMaxNormalizedPaths = 4096;
+    std::unordered_map<std::string, std::string> m_NormalizedPaths;
     std::unique_ptr<MaterialAsset> m_DefaultMaterial;
+    
+    MaterialAsset* m_SelectedMaterial = nullptr;
+    std::unordered_set<const MaterialAsset*> m_VisibleMaterials; // Since the last PumpAsyncCompiles()
 };
 
 } // namespace lucent::material
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "lucent/material/MaterialGraph.h"
+#include "lucent/material/MaterialProgram.h"
+#include "lucent/assets/Mesh.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lucent::material {
+
+// Bakes the surface outputs of a material graph into textures on the CPU (MaterialProgram, in
+// parallel tiles on the JobSystem), and builds a graph that samples them instead.
+
+struct MaterialBakeSettings {
+    uint32_t resolution = 1024;
+    uint32_t tileSize = 64;         // Texels per side of one job
+    uint32_t padding = 4;           // Texels UV islands are extended by (mesh bakes only)
+    std::string outputDirectory = "Baked";
+    std::string name = "material";  // File name prefix: <name>_basecolor.png, ...
+
+    // Optional mesh whose UV layout is baked, with its positions and normals as shading inputs.
+    // Without one the plain [0, 1] UV square is baked with a (0, 0, 1) normal. Either way the
+    // view direction is the normal, so view-dependent terms are baked as seen head-on.
+    const std::vector<assets::Vertex>* vertices = nullptr;
+    const std::vector<uint32_t>* indices = nullptr;
+};
+
+struct MaterialBakeStats {
+    double bakeMs = 0.0;            // Rasterization and evaluation
+    double writeMs = 0.0;           // Encoding and writing the textures
+    uint32_t tiles = 0;
+    uint64_t texelsEvaluated = 0;
+    // Shader cost per shading point (MaterialProgram instructions and texture samples)
+    uint32_t sourceInstructions = 0;
+    uint32_t bakedInstructions = 0;
+    uint32_t sourceTextureSamples = 0;
+    uint32_t bakedTextureSamples = 0;
+};
+
+struct MaterialBakeResult {
+    // Outputs that vary become textures; outputs that are uniform over the bake become constants
+    MaterialGraph graph;
+    std::vector<std::string> texturePaths;
+    MaterialBakeStats stats;
+};
+
+// Progress/cancellation shared with a BakeMaterialToTextures() call running on another thread
+struct MaterialBakeProgress {
+    std::atomic<float> fraction{ 0.0f };  // Tiles evaluated, 0..1; the textures are written after
+    std::atomic<bool> cancelled{ false };
+};
+
+// Texture sampler for CPU evaluation of `graph` (bakes, previews): every texture slot is decoded
+// from disk once, bilinear with repeat addressing and linear colour like the material sampler.
+// Missing files read magenta.
+MaterialTextureSampler CreateMaterialTextureSampler(const MaterialGraph& graph);
+
+// Returns false on error or cancellation (nothing is written once cancelled) and sets `outError`
+bool BakeMaterialToTextures(const MaterialGraph& graph, const MaterialBakeSettings& settings,
+                            MaterialBakeResult& outResult, std::string& outError,
+                            MaterialBakeProgress* progress = nullptr);
+
+} // namespace lucent::material
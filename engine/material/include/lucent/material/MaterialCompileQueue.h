@@ -0,0 +1,140 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/material/MaterialCompiler.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace lucent::material {
+
+// Lower values compile first
+enum class MaterialCompilePriority : uint8_t {
+    Selected = 0,   // Open in the material editor
+    Visible,        // Drawn in the viewport this frame
+    Background,     // Everything else (off-screen, RecompileAll)
+    Count
+};
+
+struct MaterialCompileQueueStats {
+    uint32_t queued = 0;            // Waiting for a compile slot
+    uint32_t running = 0;
+    uint32_t maxConcurrent = 0;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t deduplicated = 0;      // Same structure already queued or compiling for the owner
+    uint64_t superseded = 0;        // Replaced while queued, or finished after a newer request
+    uint64_t cancelled = 0;
+    // Milliseconds from Submit() to a compile slot, and to the result being ready
+    double totalWaitMs = 0.0;
+    double maxWaitMs = 0.0;
+    double totalLatencyMs = 0.0;
+    double maxLatencyMs = 0.0;
+
+    double GetAverageWaitMs() const { return completed > 0 ? totalWaitMs / static_cast<double>(completed) : 0.0; }
+    double GetAverageLatencyMs() const {
+        return completed > 0 ? totalLatencyMs / static_cast<double>(completed) : 0.0;
+    }
+};
+
+// Background material shader compiles with a bounded number in flight at once.
+//
+// Each owner (a MaterialAsset) has at most one request queued and one compile running. Queued
+// requests start in priority order, oldest first within a priority. Submitting the structure that
+// is already queued or compiling for the owner is a no-op; submitting a different one replaces the
+// queued request and marks a running compile stale, so its result is dropped when it finishes
+// (shaderc cannot be interrupted). Compiles run on the JobSystem; results are collected with
+// TakeResult(), typically from the main thread. The singleton must be Shutdown() while the JobSystem
+// is still running. Thread safe.
+class MaterialCompileQueue : public NonMovable {
+public:
+    using Owner = const void*;
+    using CompileFunction = std::function<CompileResult(const MaterialGraph&)>;
+
+    static MaterialCompileQueue& Get() {
+        static MaterialCompileQueue instance;
+        return instance;
+    }
+
+    // maxConcurrent 0 = half the JobSystem workers (at least one), resolved when compiles start.
+    // Without a compile function MaterialCompiler is used.
+    explicit MaterialCompileQueue(uint32_t maxConcurrent = 0, CompileFunction compile = {});
+    ~MaterialCompileQueue();
+
+    void SetMaxConcurrent(uint32_t maxConcurrent);
+
+    // Queue a compile of `graph` for `owner`. False when it was deduplicated (the priority of the
+    // matching request is still raised to `priority`) or the queue is shut down.
+    bool Submit(Owner owner, MaterialGraph graph, MaterialCompilePriority priority);
+    // Reprioritize the owner's queued request, if any
+    void SetPriority(Owner owner, MaterialCompilePriority priority);
+    // Drop the owner's queued request and unclaimed result; a running compile's result is discarded
+    void Cancel(Owner owner);
+
+    // Queued or compiling, and not yet collected
+    bool IsPending(Owner owner) const;
+    // Move out a finished result. False while nothing has finished for the owner.
+    bool TakeResult(Owner owner, CompileResult& outResult);
+
+    // Block until nothing is queued or running (the caller helps run jobs while it waits)
+    void WaitIdle();
+    // Drop queued requests and results, wait for running compiles, and ignore later submits.
+    // Call before JobSystem::Shutdown(); the destructor only waits if compiles are still running.
+    void Shutdown();
+
+    MaterialCompileQueueStats GetStats() const;
+    // One line with the queue depth and latencies
+    void LogStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        Owner owner = nullptr;
+        MaterialGraph graph;
+        uint64_t structureHash = 0;
+        MaterialCompilePriority priority = MaterialCompilePriority::Background;
+        uint64_t sequence = 0;
+        Clock::time_point submitTime;
+    };
+
+    struct RunningCompile {
+        uint64_t structureHash = 0;
+        uint64_t sequence = 0;
+        bool stale = false;
+    };
+
+    // Move the next startable requests into the running set. Caller holds m_Mutex and schedules
+    // the returned requests after unlocking (without a pool they run inline).
+    std::vector<Request> TakeStartable();
+    void Start(std::vector<Request> requests);
+    void Run(Request& request);
+    uint32_t GetConcurrencyLimit() const;
+
+    CompileFunction m_Compile;
+    JobCounter m_Jobs;
+
+    mutable std::mutex m_Mutex;
+    uint32_t m_MaxConcurrent = 0;
+    uint64_t m_NextSequence = 0;
+    bool m_ShutDown = false;
+    std::vector<Request> m_Queued;                          // Small; scanned for the next request
+    std::unordered_map<Owner, RunningCompile> m_Running;
+    std::unordered_map<Owner, CompileResult> m_Results;
+
+    uint64_t m_Submitted = 0;
+    uint64_t m_Completed = 0;
+    uint64_t m_Deduplicated = 0;
+    uint64_t m_Superseded = 0;
+    uint64_t m_Cancelled = 0;
+    double m_TotalWaitMs = 0.0;
+    double m_MaxWaitMs = 0.0;
+    double m_TotalLatencyMs = 0.0;
+    double m_MaxLatencyMs = 0.0;
+};
+
+} // namespace lucent::material
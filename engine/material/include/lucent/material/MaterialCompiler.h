@@ -7,13 +7,38 @@
 
 namespace lucent::material {
 
+// Constant node values and unconnected input pin defaults are not baked into the generated
+// shader: it reads them from a uniform buffer at set 0, binding 1 (`MaterialParameters { vec4
+// values[N]; }`, one vec4 per constant node, then one per unconnected numeric input pin, each in
+// ID order, counting only nodes that reach the active output). The layout only depends on the
+// graph structure, so editing a value just repacks the buffer.
+struct MaterialParameterLayout {
+    static constexpr uint32_t kBinding = 1;
+
+    std::vector<NodeID> constants;   // Constant node per vec4 slot
+    std::vector<PinID> pinDefaults;  // Input pin per vec4 slot, after the constants
+
+    static MaterialParameterLayout Build(const MaterialGraph& graph);
+
+    bool IsEmpty() const { return GetSlotCount() == 0; }
+    size_t GetSlotCount() const { return constants.size() + pinDefaults.size(); }
+    size_t GetBufferSize() const { return GetSlotCount() * sizeof(glm::vec4); }
+    // Slot of a constant node or an input pin, or -1
+    int FindSlot(NodeID nodeId) const;
+    int FindPinSlot(PinID pinId) const;
+    // Current values of the slotted nodes and pins in `graph`; ones that are gone read as zero
+    void Pack(const MaterialGraph& graph, std::vector<glm::vec4>& outValues) const;
+};
+
 // Result of material compilation
 struct CompileResult {
     bool success = false;
     std::string fragmentShaderGLSL;
     std::vector<uint32_t> fragmentShaderSPIRV;
     std::string errorMessage;
-    uint64_t graphHash = 0;
+    uint64_t graphHash = 0;         // MaterialGraph::ComputeStructureHash() of the compiled graph
+    uint64_t parameterHash = 0;     // MaterialGraph::ComputeParameterHash() of the compiled graph
+    MaterialParameterLayout parameterLayout;
     MaterialDomain domain = MaterialDomain::Surface;
 };
 
@@ -25,21 +50,27 @@ public:
     // Compile the material graph to GLSL and SPIR-V
     CompileResult Compile(const MaterialGraph& graph);
     
+    // The GLSL half of Compile(): hashes, parameter layout and fragment source, without SPIR-V.
+    // Needs neither a GPU nor the shader compiler.
+    CompileResult GenerateGLSL(const MaterialGraph& graph);
+    
     // Get the standard vertex shader SPIR-V (shared by all materials)
     static const std::vector<uint32_t>& GetStandardVertexShaderSPIRV();
     
 private:
-    // Generate GLSL fragment shader from graph (dispatches based on domain)
-    std::string GenerateFragmentGLSL(const MaterialGraph& graph);
+    // Generate GLSL fragment shader from graph (dispatches based on domain), reading parameters
+    // through `layout`
+    std::string GenerateFragmentGLSL(const MaterialGraph& graph, const MaterialParameterLayout& layout);
     
     // Generate GLSL for surface (PBR) materials
-    std::string GenerateSurfaceFragmentGLSL(const MaterialGraph& graph);
+    std::string GenerateSurfaceFragmentGLSL(const MaterialGraph& graph, const MaterialParameterLayout& layout);
     
     // Generate GLSL for volume materials (raymarching)
-    std::string GenerateVolumeFragmentGLSL(const MaterialGraph& graph);
+    std::string GenerateVolumeFragmentGLSL(const MaterialGraph& graph, const MaterialParameterLayout& layout);
     
-    // Compile GLSL to SPIR-V
-    bool CompileGLSLToSPIRV(const std::string& glsl, std::vector<uint32_t>& spirv, std::string& errorMsg);
+    // Compile GLSL to SPIR-V, through the persistent ShaderCache
+    bool CompileGLSLToSPIRV(uint64_t graphHash, const std::string& glsl, std::vector<uint32_t>& spirv,
+                            std::string& errorMsg);
     
     // Topological sort of nodes
     std::vector<NodeID> TopologicalSort(const MaterialGraph& graph);
@@ -56,6 +87,13 @@ private:
     std::string ConvertType(const std::string& value, PinType from, PinType to);
     std::string GetGLSLTypeName(PinType type);
     std::string GetDefaultValue(PinType type, const PinValue& defaultVal);
+    
+    // Uniform block declaration for the parameter buffer (empty without parameters)
+    static std::string GenerateParameterBlock(const MaterialParameterLayout& layout);
+    // Names the buffer reads for every slot of `layout`, keyed by the constant's output pin or the
+    // input pin, so GenerateNodeCode and GetPinValue pick them up
+    static void AddParameterNames(const MaterialGraph& graph, const MaterialParameterLayout& layout,
+                                  std::unordered_map<PinID, std::string>& pinVarNames);
 };
 
 } // namespace lucent::material
@@ -53,6 +53,11 @@ inline int GetPinTypeComponents(PinType type) {
     return 0;
 }
 
+// Float and vector pins. Their unconnected defaults are material parameters, like constant nodes.
+inline bool IsNumericPinType(PinType type) {
+    return GetPinTypeComponents(type) > 0;
+}
+
 // Pin direction
 enum class PinDirection {
     Input,
@@ -246,6 +251,19 @@ inline const char* GetNodeCategory(NodeType type) {
     return "Other";
 }
 
+// Constant nodes: the GLSL backend reads their values from the material parameter buffer, so
+// editing them does not change the generated shader
+inline bool IsConstantNodeType(NodeType type) {
+    return type == NodeType::ConstFloat || type == NodeType::ConstVec2 ||
+           type == NodeType::ConstVec3 || type == NodeType::ConstVec4;
+}
+
+// Noise node parameter (optional, V2): "NOISE2:<type>;<scale>,<detail>,<roughness>,<distortion>"
+// - type: 0=FBM, 1=Value, 2=Ridged, 3=Turbulence
+// The values mirror the Scale/Detail/Roughness/Distortion pin defaults; older graphs store only
+// them, as a vec4.
+bool ParseNoise2Param(const std::string& s, int& outType, glm::vec4& outParams);
+
 // Get human-readable node name
 inline const char* GetNodeTypeName(NodeType type) {
     switch (type) {
@@ -429,8 +447,15 @@ public:
         return m_Domain == MaterialDomain::Volume ? m_VolumeOutputNodeId : m_OutputNodeId;
     }
     
-    // Compute a hash of the graph for caching
+    // Compute a hash of the graph for caching (structure and parameters)
     uint64_t ComputeHash() const;
+    // Everything that changes the generated shader: nodes, links, non-constant node parameters,
+    // texture slots and domain. Constant node values, numeric pin defaults and noise values are
+    // left out.
+    uint64_t ComputeStructureHash() const;
+    // The values left out of the structure hash; a change here needs a parameter buffer update,
+    // not a recompile
+    uint64_t ComputeParameterHash() const;
     
     // Get graph name
     const std::string& GetName() const { return m_Name; }
@@ -19,7 +19,7 @@ struct TracerMaterialConstants {
 
 // Evaluate a MaterialGraph into constant channels for the tracer backends.
 // NOTE: The tracer backends currently consume constant parameters only (no textures/uv-varying evaluation).
-// This evaluator supports a large subset of math nodes + CustomCode (expression-like Out assignment).
+// This evaluator supports a large subset of math nodes + CustomCode (compiled once, see CustomCode.h).
 bool EvaluateTracerConstants(const MaterialGraph& graph, TracerMaterialConstants& out, std::string& outError);
 
 } // namespace lucent::material
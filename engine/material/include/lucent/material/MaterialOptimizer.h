@@ -0,0 +1,37 @@
+#pragma once
+
+#include "lucent/material/MaterialGraph.h"
+#include <cstdint>
+
+namespace lucent::material {
+
+struct MaterialOptimizeStats {
+    uint32_t nodesBefore = 0;
+    uint32_t nodesAfter = 0;
+    uint32_t folded = 0;       // Nodes with constant inputs replaced by their value
+    uint32_t simplified = 0;   // Algebraic identities applied (x * 1, mix(a, b, 0), 1 - (1 - x), ...)
+    uint32_t merged = 0;       // Duplicates of an earlier node with the same inputs
+    uint32_t removed = 0;      // Nodes deleted because they no longer reach the active output
+};
+
+struct MaterialOptimizeOptions {
+    // Constant nodes and unconnected pin defaults are runtime parameters (the GLSL backend reads
+    // them from the material parameter buffer): nothing that depends on their values is folded or
+    // simplified, and equal constants or defaults do not make nodes duplicates.
+    bool constantsAreParameters = false;
+};
+
+// Return an equivalent graph that does less work, for the GLSL, MaterialIR and RT instruction
+// backends to compile instead of the edited graph. In dependency order from the active output:
+//  - nodes whose inputs are all constant are evaluated (with the GLSL backend's semantics) and
+//    replaced by constant nodes
+//  - identities are simplified: x + 0, x * 1, x * 0, x / 1, pow(x, 1), mix(a, b, 0|1), min(x, x),
+//    1 - (1 - x), -(-x), saturate(saturate(x)), float(vec3(x)), vec3(vec4(x, a)) and reroutes
+//  - nodes with the same type, parameter and inputs as an earlier node are merged into it
+//  - nodes that no longer reach the active output are removed
+// Surviving nodes keep their IDs so compile errors still map back to the editor. The input graph
+// is returned unchanged if it has a cycle.
+MaterialGraph OptimizeMaterialGraph(const MaterialGraph& graph, MaterialOptimizeStats* stats = nullptr,
+                                    const MaterialOptimizeOptions& options = {});
+
+} // namespace lucent::material
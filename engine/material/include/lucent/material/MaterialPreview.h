@@ -0,0 +1,120 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/core/FileCache.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/material/MaterialGraph.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lucent::material {
+
+// Material thumbnails rendered on the CPU: a shader ball (analytic sphere lit by a procedural sky
+// and sun) shaded with MaterialProgram. MaterialPreviewCache renders them on the JobSystem and keeps
+// them on disk keyed by graph hash, so a material is rendered again only when its graph changes.
+
+struct MaterialPreviewImage {
+    uint64_t graphHash = 0;
+    uint32_t size = 0;              // Width and height in pixels
+    std::vector<uint8_t> pixels;    // RGBA8 sRGB, top row first, straight alpha (0 around the ball)
+    std::string error;              // Why the graph has no preview (pixels is then empty)
+
+    bool IsValid() const { return !pixels.empty(); }
+};
+
+// Render a thumbnail of `graph` on the calling thread, seen from the angle of the material editor's
+// GPU preview. Fails for volume materials and graphs MaterialProgram cannot compile.
+bool RenderMaterialPreview(const MaterialGraph& graph, uint32_t size, MaterialPreviewImage& outImage,
+                           std::string& outError);
+
+struct MaterialPreviewStats {
+    uint32_t queued = 0;            // Waiting for a render slot
+    uint32_t running = 0;
+    uint64_t rendered = 0;
+    uint64_t diskHits = 0;          // Read from the disk cache instead of rendered
+    uint64_t failed = 0;            // Unreadable files and graphs without a preview
+    double totalRenderMs = 0.0;
+
+    double GetAverageRenderMs() const { return rendered > 0 ? totalRenderMs / static_cast<double>(rendered) : 0.0; }
+};
+
+// Thumbnails for many materials, rendered in the background a few at a time.
+//
+// Each key (typically a material path) shows its latest finished thumbnail while a newer one
+// renders. Requests made while a key is rendering are coalesced: only the latest one runs next, so
+// dragging a parameter slider does not queue a render per frame. Finished thumbnails are written
+// to the disk cache, keyed by graph hash and thumbnail size, and evicted least recently used past a
+// size bound. Thread safe.
+class MaterialPreviewCache : public NonMovable {
+public:
+    explicit MaterialPreviewCache(uint32_t size = 128, uint32_t maxConcurrent = 2);
+    ~MaterialPreviewCache();
+
+    // Keep thumbnails under `directory` (created if missing). Empty keeps them in memory only.
+    void SetDirectory(const std::string& directory, size_t maxBytes = size_t(64) << 20);
+
+    // Thumbnail of `graph` for `key`: a render is scheduled when the graph hash differs from the
+    // key's last request. Returns the latest finished thumbnail (null before the first one).
+    std::shared_ptr<const MaterialPreviewImage> Request(const std::string& key, const MaterialGraph& graph);
+    // Thumbnail of a `.lmat` file, read and hashed on a worker; read again when `writeTime` changes
+    std::shared_ptr<const MaterialPreviewImage> RequestFile(const std::string& path,
+                                                            std::filesystem::file_time_type writeTime);
+
+    uint32_t GetSize() const { return m_Size; }
+
+    // Block until nothing is queued or running (the caller helps run jobs while it waits)
+    void WaitIdle();
+
+    MaterialPreviewStats GetStats() const;
+    void LogStats() const;
+
+private:
+    struct Work {
+        std::string path;                       // File requests: read on the worker
+        std::shared_ptr<const MaterialGraph> graph;
+    };
+
+    struct Entry {
+        uint64_t graphHash = 0;                 // Of the latest graph request
+        std::optional<std::filesystem::file_time_type> writeTime; // Of the latest file request
+        std::optional<Work> next;               // Latest request not started yet
+        bool running = false;
+        std::shared_ptr<const MaterialPreviewImage> image;
+    };
+
+    // Caller holds m_Mutex
+    void Enqueue(const std::string& key, Entry& entry, Work work);
+    std::vector<std::pair<std::string, Work>> TakeStartable();
+    void Start(std::vector<std::pair<std::string, Work>> work);
+    void Run(const std::string& key, const Work& work);
+
+    uint64_t MakeDiskKey(uint64_t graphHash) const;
+    bool LoadFromDisk(uint64_t graphHash, MaterialPreviewImage& outImage);
+    void StoreToDisk(const MaterialPreviewImage& image);
+
+    const uint32_t m_Size;
+    const uint32_t m_MaxConcurrent;
+    JobCounter m_Jobs;
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<std::string, Entry> m_Entries;
+    std::deque<std::string> m_Queue;            // Keys with a `next` request, oldest first
+    uint32_t m_Running = 0;
+
+    FileCache m_DiskCache{ "MaterialPreviewCache", ".thumb" };
+
+    uint64_t m_Rendered = 0;
+    uint64_t m_DiskHits = 0;
+    uint64_t m_Failed = 0;
+    double m_TotalRenderMs = 0.0;
+};
+
+} // namespace lucent::material
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "lucent/material/MaterialGraph.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lucent::material {
+
+// CPU shading engine: a MaterialGraph compiled once into flat register bytecode, then run over
+// batches of shading points (baking, previews, CPU tracing). Values follow the GLSL backend
+// (MaterialCompiler), not the tracer constant evaluator.
+
+enum class MaterialOp : uint8_t {
+    Constant,       // dst = constants[imm]
+    Input,          // dst = shading point input imm (MaterialProgramInput)
+    Swizzle,        // dst[c] = src0[selector c]; 3-bit selectors in imm: 0-3 component, 4 zero, 5 one
+    Combine,        // dst = (src0.x, src1.x, src2.x, src3.x)
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    Min,
+    Max,
+    Clamp,          // clamp(src0, src1, src2)
+    Mix,            // mix(src0, src1, src2)
+    Abs,
+    Floor,
+    Ceil,
+    Fract,
+    Mod,            // GLSL mod: x - y * floor(x / y)
+    Sqrt,
+    Exp,
+    Log,
+    Sin,
+    Cos,
+    Pow,
+    Step,           // step(src0, src1)
+    Smoothstep,     // smoothstep(src0, src1, src2)
+    Dot3,
+    Length3,
+    Normalize3,     // Zero vectors stay zero
+    Cross,
+    Reflect,        // reflect(src0, src1); src1 must be normalized
+    Refract,        // refract(src0, src1, src2.x); src1 must be normalized
+    NoiseDistort,   // src0 + src1.x * vec3(valueNoise3(src0 + offset)...) when src1.x > 0
+    Noise,          // Noise of type imm at src0, octaves src1.x, roughness src2.x
+    ColorRamp,      // ramps[imm] at src0.x
+    Texture,        // Texture slot imm at src0.xy
+};
+
+enum class MaterialProgramInput : uint8_t {
+    UV,
+    WorldPosition,
+    WorldNormal,    // Normalized
+    ViewDirection,  // Normalized, from the surface towards the viewer
+};
+
+struct MaterialInstruction {
+    MaterialOp op = MaterialOp::Constant;
+    uint8_t components = 1;     // Components of dst written
+    uint16_t dst = 0;
+    uint16_t src[4] = {};
+    uint32_t imm = 0;
+};
+
+struct MaterialRampStop {
+    float t = 0.0f;
+    glm::vec4 color = glm::vec4(1.0f);
+};
+
+// Active output node input (e.g. "Base Color"), as written to the output streams
+struct MaterialProgramOutput {
+    std::string name;
+    PinType type = PinType::Float;
+    uint16_t reg = 0;
+    uint32_t row = 0;           // First output stream of this value
+};
+
+// Writes rgba[c][i] for the `count` points (u[i], v[i]) from texture slot `slot` of the graph
+using MaterialTextureSampler = std::function<void(uint32_t slot, const float* u, const float* v,
+                                                  uint32_t count, float* const rgba[4])>;
+
+// Shading points, structure of arrays: each stream holds `count` floats. Null streams read as
+// zero, except normal and view direction which default to (0, 0, 1).
+struct MaterialShadingPoints {
+    uint32_t count = 0;
+    const float* uv[2] = {};
+    const float* position[3] = {};
+    const float* normal[3] = {};
+    const float* viewDirection[3] = {};
+    // Without a sampler textures read as magenta, like a missing texture on the GPU
+    MaterialTextureSampler sampleTexture;
+};
+
+struct MaterialProgram {
+    // Points evaluated together; registers hold kLanes values per component
+    static constexpr uint32_t kLanes = 64;
+
+    MaterialDomain domain = MaterialDomain::Surface;
+    std::vector<MaterialInstruction> instructions;
+    std::vector<glm::vec4> constants;
+    std::vector<std::vector<MaterialRampStop>> ramps;  // Sorted by t, at least two stops
+    std::vector<MaterialProgramOutput> outputs;
+    uint32_t registerCount = 0;
+    uint32_t outputRowCount = 0;    // Sum of the output components
+
+    bool IsValid() const { return !outputs.empty(); }
+    const MaterialProgramOutput* FindOutput(const std::string& name) const;
+
+    // Evaluate all outputs at the given points. Component c of output o for point i is written to
+    // outputs[(o.row + c) * points.count + i]. Safe to call from several threads at once.
+    void Execute(const MaterialShadingPoints& points, float* outputs) const;
+};
+
+// Compile the active output of `graph` (after OptimizeMaterialGraph) into `outProgram`. Fails on
+// cycles and on CustomCode the CPU cannot run: bodies must be a list of `name = expr;` and
+// `type name = expr;` statements over the node's pins, using + - * /, swizzles, vector
+// constructors and common GLSL built-ins.
+bool CompileMaterialProgram(const MaterialGraph& graph, MaterialProgram& outProgram, std::string& outError);
+
+} // namespace lucent::material
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "lucent/gfx/RTMaterialProgram.h"
+#include "lucent/material/MaterialGraph.h"
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace lucent::material {
+
+// Texture slot of the tracer's texture array for one (path, sRGB) pair. Slot 0 is the fallback.
+using RTTextureSlotFunction = std::function<uint32_t(const std::string& path, bool sRGB)>;
+
+// Compile a surface graph to a per-hit program for the raytraced tracer's closest-hit interpreter
+// (shaders/rt_closesthit.rchit): UV, textures, procedural noise, math and Custom Code nodes. The
+// program has one register per instruction, numbered as for gfx::AllocateRTMaterialRegisters.
+// Unconnected Normal and Alpha leave their registers 0. Unsupported nodes read as zero and set
+// `outError`; volume graphs and graphs without a PBR output fail. Without `textureSlot` every
+// texture samples slot 0.
+bool CompileRTMaterialProgram(const MaterialGraph& graph, gfx::RTMaterialHeader& outHeader,
+                              std::pmr::vector<gfx::RTMaterialInstr>& outInstrs, std::string& outError,
+                              const RTTextureSlotFunction& textureSlot = {});
+
+} // namespace lucent::material
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/core/FileCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lucent::material {
+
+struct ShaderCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writes = 0;
+    uint64_t evictions = 0;
+    double secondsSaved = 0.0;   // Compile time recorded with the entries that were hit
+    size_t diskBytes = 0;
+    size_t maxBytes = 0;
+    uint32_t entryCount = 0;
+
+    double GetHitRate() const {
+        const uint64_t lookups = hits + misses;
+        return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+// Persistent SPIR-V cache for generated material shaders, one file per entry (<key>.spv) in a
+// FileCache: bounded in size, least recently used entries evicted first.
+//
+// Entries are content addressed: the key covers the graph hash, the generated GLSL, the compiler
+// build and the compile options, so an entry is never stale, only unused. Each entry carries a
+// hash of its SPIR-V, so a damaged file is a miss rather than a bad shader.
+// Thread safe: background material compiles share the instance.
+class ShaderCache : public NonCopyable {
+public:
+    static constexpr size_t kDefaultMaxBytes = 64ull * 1024 * 1024;
+
+    static ShaderCache& Get() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    ShaderCache() = default;
+
+    // Use `directory` (created if missing) and index the entries already there. Empty disables
+    // the cache: Load() misses and Store() does nothing.
+    void SetDirectory(const std::string& directory, size_t maxBytes = kDefaultMaxBytes);
+    bool IsEnabled() const;
+
+    // Content key for one compile. `compilerOptions` names everything else that changes the output:
+    // compiler build, stage, target environment and optimisation level.
+    static uint64_t MakeKey(uint64_t graphHash, std::string_view glsl, std::string_view compilerOptions);
+
+    // False on a miss. An unreadable or corrupt entry counts as a miss and is deleted.
+    bool Load(uint64_t key, std::vector<uint32_t>& outSpirv);
+    // `compileSeconds` is what the compile cost; later hits add it to the time saved
+    void Store(uint64_t key, std::span<const uint32_t> spirv, double compileSeconds);
+
+    ShaderCacheStats GetStats() const;
+    // One line with the hit rate, time saved and disk use
+    void LogStats() const;
+
+private:
+    FileCache m_Files{ "ShaderCache", ".spv" };
+
+    mutable std::mutex m_Mutex;
+    double m_SecondsSaved = 0.0;
+};
+
+} // namespace lucent::material
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "lucent/core/Core.h"
+#include "lucent/gfx/RTMaterialProgram.h"
+#include "lucent/gfx/TracerCompute.h"
+#include "lucent/material/MaterialGraph.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lucent::material {
+
+struct TracerMaterialStats {
+    size_t instances = 0;       // Add() calls
+    size_t materials = 0;       // Entries added to the material buffer
+    size_t graphBuilds = 0;     // Graphs evaluated (and compiled to RT programs)
+    size_t sharedBytes = 0;     // Material, header and instruction buffers as built (whole buffers)
+    size_t unsharedBytes = 0;   // What they would take with one copy per instance
+};
+
+// Builds the tracer material buffers for a scene, one entry per unique material rather than per
+// mesh instance. Materials are shared in three steps:
+// - by owner: every instance of one loaded asset (the asset manager resolves every spelling of a
+//   path to one asset) reuses the first result without looking at the graph again
+// - by MaterialGraph::ComputeHash, so identical graphs saved under different paths share
+// - instances without a usable graph share one material per distinct set of component values
+//
+// With RT outputs, each new surface graph is optimized, compiled to a per-hit program by the
+// caller's compile function and packed with gfx::RTMaterialLinker.
+class TracerMaterialTable : public NonMovable {
+public:
+    using Owner = const void*;
+    // Compile a graph to RT instructions numbered as for gfx::AllocateRTMaterialRegisters
+    using RTCompileFunction = std::function<bool(const MaterialGraph& graph, gfx::RTMaterialHeader& header,
+                                                 std::pmr::vector<gfx::RTMaterialInstr>& instrs,
+                                                 std::string& outError)>;
+
+    // `headers` and `instrs` are null for the compute tracer; without `compileRT` every header is
+    // left empty. The buffers are appended to, so entries already in them (e.g. a default material)
+    // are kept.
+    TracerMaterialTable(std::vector<gfx::GPUMaterial>& materials, std::vector<gfx::RTMaterialHeader>* headers,
+                        std::vector<gfx::RTMaterialInstr>* instrs, RTCompileFunction compileRT = {});
+
+    // Material index for one instance. `graph` (owned by `owner`, which must stay alive while the
+    // table is used) may be null; `fallback` is used when it is, or when neither evaluator handles
+    // the graph. `name` only labels log output.
+    uint32_t Add(Owner owner, const MaterialGraph* graph, const gfx::GPUMaterial& fallback,
+                 std::string_view name = {});
+
+    TracerMaterialStats GetStats() const;
+    // Null without RT outputs
+    const gfx::RTMaterialLinker* GetRTLinker() const { return m_Linker ? &*m_Linker : nullptr; }
+
+private:
+    static constexpr uint32_t kNoGraphMaterial = UINT32_MAX;
+
+    // GPUMaterial field bits; built field by field so struct padding never splits equal materials
+    using ComponentKey = std::array<uint32_t, 12>;
+    struct ComponentKeyHash {
+        size_t operator()(const ComponentKey& key) const;
+    };
+
+    uint32_t AddGraph(const MaterialGraph& graph, std::string_view name);
+    uint32_t AddComponentMaterial(const gfx::GPUMaterial& material);
+
+    std::vector<gfx::GPUMaterial>& m_Materials;
+    std::vector<gfx::RTMaterialHeader>* m_Headers = nullptr;
+    std::vector<gfx::RTMaterialInstr>* m_Instrs = nullptr;
+    RTCompileFunction m_CompileRT;
+    std::optional<gfx::RTMaterialLinker> m_Linker;
+
+    std::unordered_map<Owner, uint32_t> m_OwnerMaterials;
+    std::unordered_map<uint64_t, uint32_t> m_GraphMaterials;        // Graph hash -> index
+    std::unordered_map<ComponentKey, uint32_t, ComponentKeyHash> m_ComponentMaterials;
+
+    TracerMaterialStats m_Stats;
+};
+
+} // namespace lucent::material
@@ -0,0 +1,778 @@
+#include "lucent/material/CustomCode.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace lucent::material {
+
+namespace {
+
+constexpr uint32_t kSelectZero = 4;
+constexpr uint32_t kSelectOne = 5;
+
+uint32_t EncodeSwizzle(uint32_t s0, uint32_t s1 = kSelectZero, uint32_t s2 = kSelectZero, uint32_t s3 = kSelectZero) {
+    return s0 | (s1 << 3) | (s2 << 6) | (s3 << 9);
+}
+
+PinType GetVectorType(int components) {
+    switch (components) {
+        case 2: return PinType::Vec2;
+        case 3: return PinType::Vec3;
+        case 4: return PinType::Vec4;
+        default: return PinType::Float;
+    }
+}
+
+int Width(PinType type) {
+    return std::max(GetPinTypeComponents(type), 1);
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+// One point at a time, with the same results as MaterialProgram::Execute. Used to fold constants
+// at compile time and by the tracer constant evaluator.
+
+glm::vec4 EvaluateExpr(const CustomCodeExpr& e, const glm::vec4* a) {
+    const int n = Width(e.type);
+    glm::vec4 r(0.0f);
+    auto each1 = [&](auto fn) { for (int c = 0; c < n; ++c) r[c] = fn(a[0][c]); };
+    auto each2 = [&](auto fn) { for (int c = 0; c < n; ++c) r[c] = fn(a[0][c], a[1][c]); };
+    auto each3 = [&](auto fn) { for (int c = 0; c < n; ++c) r[c] = fn(a[0][c], a[1][c], a[2][c]); };
+
+    switch (e.op) {
+        case MaterialOp::Constant: return e.value;
+        case MaterialOp::Swizzle:
+            for (int c = 0; c < n; ++c) {
+                const uint32_t selector = (e.imm >> (3 * c)) & 7u;
+                r[c] = selector < 4 ? a[0][selector] : (selector == kSelectOne ? 1.0f : 0.0f);
+            }
+            break;
+        case MaterialOp::Combine:
+            for (int c = 0; c < n; ++c) r[c] = a[c].x;
+            break;
+
+        case MaterialOp::Add: each2([](float x, float y) { return x + y; }); break;
+        case MaterialOp::Subtract: each2([](float x, float y) { return x - y; }); break;
+        case MaterialOp::Multiply: each2([](float x, float y) { return x * y; }); break;
+        case MaterialOp::Divide: each2([](float x, float y) { return x / y; }); break;
+        case MaterialOp::Negate: each1([](float x) { return -x; }); break;
+        case MaterialOp::Min: each2([](float x, float y) { return std::min(x, y); }); break;
+        case MaterialOp::Max: each2([](float x, float y) { return std::max(x, y); }); break;
+        case MaterialOp::Clamp: each3([](float x, float lo, float hi) { return std::min(std::max(x, lo), hi); }); break;
+        case MaterialOp::Mix: each3([](float x, float y, float t) { return x * (1.0f - t) + y * t; }); break;
+        case MaterialOp::Abs: each1([](float x) { return std::fabs(x); }); break;
+        case MaterialOp::Floor: each1([](float x) { return std::floor(x); }); break;
+        case MaterialOp::Ceil: each1([](float x) { return std::ceil(x); }); break;
+        case MaterialOp::Fract: each1([](float x) { return x - std::floor(x); }); break;
+        case MaterialOp::Mod: each2([](float x, float y) { return x - y * std::floor(x / y); }); break;
+        case MaterialOp::Sqrt: each1([](float x) { return std::sqrt(x); }); break;
+        case MaterialOp::Exp: each1([](float x) { return std::exp(x); }); break;
+        case MaterialOp::Log: each1([](float x) { return std::log(x); }); break;
+        case MaterialOp::Sin: each1([](float x) { return std::sin(x); }); break;
+        case MaterialOp::Cos: each1([](float x) { return std::cos(x); }); break;
+        case MaterialOp::Pow: each2([](float x, float y) { return std::pow(x, y); }); break;
+        case MaterialOp::Step: each2([](float edge, float x) { return x < edge ? 0.0f : 1.0f; }); break;
+        case MaterialOp::Smoothstep:
+            each3([](float e0, float e1, float x) {
+                const float t = std::clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+                return t * t * (3.0f - 2.0f * t);
+            });
+            break;
+
+        case MaterialOp::Dot3: r.x = glm::dot(glm::vec3(a[0]), glm::vec3(a[1])); break;
+        case MaterialOp::Length3: r.x = std::sqrt(glm::dot(glm::vec3(a[0]), glm::vec3(a[0]))); break;
+        case MaterialOp::Normalize3: {
+            const glm::vec3 v(a[0]);
+            const float length = std::sqrt(glm::dot(v, v));
+            r = glm::vec4(length > 0.0f ? v / length : glm::vec3(0.0f), 0.0f);
+            break;
+        }
+        case MaterialOp::Cross: r = glm::vec4(glm::cross(glm::vec3(a[0]), glm::vec3(a[1])), 0.0f); break;
+        case MaterialOp::Reflect: {
+            const glm::vec3 i(a[0]), normal(a[1]);
+            r = glm::vec4(i - 2.0f * glm::dot(normal, i) * normal, 0.0f);
+            break;
+        }
+        case MaterialOp::Refract: {
+            const glm::vec3 i(a[0]), normal(a[1]);
+            const float eta = a[2].x;
+            const float dot = glm::dot(normal, i);
+            const float k = 1.0f - eta * eta * (1.0f - dot * dot);
+            if (k >= 0.0f) r = glm::vec4(eta * i - (eta * dot + std::sqrt(k)) * normal, 0.0f);
+            break;
+        }
+
+        default:
+            // Shading inputs, noise, ramps and textures do not appear in CustomCode
+            break;
+    }
+    return r;
+}
+
+// ============================================================================
+// Lexer
+// ============================================================================
+// Tokens are views into the statement being compiled; nothing is copied until a name is declared.
+
+enum class TokenKind { End, Ident, Number, LParen, RParen, Comma, Dot, Op, Assign, Invalid };
+
+struct Token {
+    TokenKind kind = TokenKind::End;
+    std::string_view text;
+};
+
+class Lexer {
+public:
+    explicit Lexer(std::string_view source) : m_Source(source) {}
+
+    Token Next() {
+        while (m_Pos < m_Source.size() && std::isspace(static_cast<unsigned char>(m_Source[m_Pos]))) ++m_Pos;
+        if (m_Pos >= m_Source.size()) return { TokenKind::End, {} };
+
+        const size_t start = m_Pos;
+        const char c = m_Source[m_Pos];
+        const char next = m_Pos + 1 < m_Source.size() ? m_Source[m_Pos + 1] : '\0';
+        if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && std::isdigit(static_cast<unsigned char>(next)))) {
+            while (m_Pos < m_Source.size()) {
+                const char d = m_Source[m_Pos];
+                const bool exponentSign = (d == '+' || d == '-') && (m_Source[m_Pos - 1] == 'e' || m_Source[m_Pos - 1] == 'E');
+                if (!std::isdigit(static_cast<unsigned char>(d)) && d != '.' && d != 'e' && d != 'E' && !exponentSign) break;
+                ++m_Pos;
+            }
+            const std::string_view text = m_Source.substr(start, m_Pos - start);
+            if (m_Pos < m_Source.size() && (m_Source[m_Pos] == 'f' || m_Source[m_Pos] == 'F')) ++m_Pos;
+            return { TokenKind::Number, text };
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            while (m_Pos < m_Source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(m_Source[m_Pos])) || m_Source[m_Pos] == '_')) ++m_Pos;
+            return { TokenKind::Ident, m_Source.substr(start, m_Pos - start) };
+        }
+
+        ++m_Pos;
+        switch (c) {
+            case '(': return { TokenKind::LParen, m_Source.substr(start, 1) };
+            case ')': return { TokenKind::RParen, m_Source.substr(start, 1) };
+            case ',': return { TokenKind::Comma, m_Source.substr(start, 1) };
+            case '.': return { TokenKind::Dot, m_Source.substr(start, 1) };
+            case '+': case '-': case '*': case '/':
+                if (next == '=') {
+                    ++m_Pos;
+                    return { TokenKind::Assign, m_Source.substr(start, 2) };
+                }
+                return { TokenKind::Op, m_Source.substr(start, 1) };
+            case '=':
+                if (next == '=') break;
+                return { TokenKind::Assign, m_Source.substr(start, 1) };
+            default:
+                break;
+        }
+        return { TokenKind::Invalid, m_Source.substr(start, 1) };
+    }
+
+private:
+    std::string_view m_Source;
+    size_t m_Pos = 0;
+};
+
+// ============================================================================
+// Compiler
+// ============================================================================
+// Builds the expression list directly while parsing (no tree): every parse function returns the
+// expression holding its value. Variables map names to expressions, so an assignment is only a
+// map update and a later read costs nothing at evaluation time.
+
+struct Operand {
+    uint32_t expr = 0;
+    PinType type = PinType::Float;  // Components of `expr` that are meaningful
+};
+
+struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+
+class Compiler {
+public:
+    explicit Compiler(CompiledCustomCode& out) : m_Out(out) {}
+
+    bool Compile(const std::string& source, const std::vector<CustomCodePin>& inputs,
+                 const std::vector<CustomCodePin>& outputs);
+
+private:
+    // Emission
+    Operand Emit(MaterialOp op, PinType type, std::initializer_list<Operand> args, uint32_t imm = 0);
+    Operand Constant(const glm::vec4& value, PinType type);
+    Operand Constant(float value) { return Constant(glm::vec4(value), PinType::Float); }
+    Operand Zero() { return Constant(0.0f); }
+    Operand Convert(const Operand& value, PinType to);
+    Operand Swizzle(const Operand& value, PinType to, uint32_t selectors) {
+        return Emit(MaterialOp::Swizzle, to, { value }, selectors);
+    }
+    Operand Component(const Operand& value, int component);
+    Operand Combine(const std::vector<Operand>& scalars);
+    void RemoveDeadExprs();
+
+    // Parsing
+    bool CompileStatement(std::string_view statement);
+    Operand ParseAdditive();
+    Operand ParseMultiplicative();
+    Operand ParseUnary();
+    Operand ParsePostfix();
+    Operand ParsePrimary();
+    Operand Call(std::string_view name, const std::vector<Operand>& args);
+    Operand Construct(PinType type, const std::vector<Operand>& args);
+    Operand Binary(char op, const Operand& a, const Operand& b);
+    std::vector<Operand> Widen(std::vector<Operand> args);
+    void Advance() { m_Current = m_Lexer->Next(); }
+
+    static int Components(const Operand& v) { return GetPinTypeComponents(v.type); }
+    static bool ParseTypeName(std::string_view text, PinType& outType);
+
+    bool Fail(const std::string& message) {
+        if (m_Out.error.empty()) m_Out.error = "CustomCode: " + message;
+        return false;
+    }
+    bool Failed() const { return !m_Out.error.empty(); }
+
+    CompiledCustomCode& m_Out;
+    std::unordered_map<std::string, Operand, NameHash, std::equal_to<>> m_Variables;
+    std::unordered_set<std::string> m_Assigned;
+    std::unordered_map<std::string, Operand> m_Constants;
+    Lexer* m_Lexer = nullptr;
+    Token m_Current;
+};
+
+Operand Compiler::Emit(MaterialOp op, PinType type, std::initializer_list<Operand> args, uint32_t imm) {
+    CustomCodeExpr e;
+    e.op = op;
+    e.type = type;
+    e.imm = imm;
+    bool constant = op != MaterialOp::Input;
+    for (const Operand& arg : args) {
+        e.args[e.argCount++] = arg.expr;
+        constant = constant && m_Out.exprs[arg.expr].op == MaterialOp::Constant;
+    }
+
+    if (constant) {
+        glm::vec4 values[4] = {};
+        for (uint8_t i = 0; i < e.argCount; ++i) values[i] = m_Out.exprs[e.args[i]].value;
+        return Constant(EvaluateExpr(e, values), type);
+    }
+
+    m_Out.exprs.push_back(e);
+    return { static_cast<uint32_t>(m_Out.exprs.size() - 1), type };
+}
+
+Operand Compiler::Constant(const glm::vec4& value, PinType type) {
+    glm::vec4 v(0.0f);
+    for (int i = 0; i < Width(type); ++i) v[i] = value[i];
+
+    std::string key(reinterpret_cast<const char*>(&type), sizeof(type));
+    key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    auto it = m_Constants.find(key);
+    if (it != m_Constants.end()) return it->second;
+
+    CustomCodeExpr e;
+    e.op = MaterialOp::Constant;
+    e.type = type;
+    e.value = v;
+    m_Out.exprs.push_back(e);
+    const Operand result{ static_cast<uint32_t>(m_Out.exprs.size() - 1), type };
+    m_Constants.emplace(std::move(key), result);
+    return result;
+}
+
+// Same conversions as MaterialCompiler::ConvertType
+Operand Compiler::Convert(const Operand& value, PinType to) {
+    const int fromN = GetPinTypeComponents(value.type);
+    const int toN = GetPinTypeComponents(to);
+    if (toN <= fromN) return { value.expr, to }; // Truncation only reads fewer components
+    if (fromN == 1) return Swizzle(value, to, EncodeSwizzle(0, 0, 0, 0));
+    if (fromN == 2 && toN == 3) return Swizzle(value, to, EncodeSwizzle(0, 1, kSelectZero));
+    if (fromN == 2 && toN == 4) return Swizzle(value, to, EncodeSwizzle(0, 1, kSelectZero, kSelectOne));
+    return Swizzle(value, to, EncodeSwizzle(0, 1, 2, kSelectOne)); // vec3 -> vec4
+}
+
+Operand Compiler::Component(const Operand& value, int component) {
+    if (component == 0) return { value.expr, PinType::Float };
+    return Swizzle(value, PinType::Float, EncodeSwizzle(static_cast<uint32_t>(component)));
+}
+
+Operand Compiler::Combine(const std::vector<Operand>& scalars) {
+    const PinType type = GetVectorType(static_cast<int>(scalars.size()));
+    switch (scalars.size()) {
+        case 2: return Emit(MaterialOp::Combine, type, { scalars[0], scalars[1] });
+        case 3: return Emit(MaterialOp::Combine, type, { scalars[0], scalars[1], scalars[2] });
+        default: return Emit(MaterialOp::Combine, type, { scalars[0], scalars[1], scalars[2], scalars[3] });
+    }
+}
+
+bool Compiler::ParseTypeName(std::string_view text, PinType& outType) {
+    if (text == "float") { outType = PinType::Float; return true; }
+    if (text == "vec2") { outType = PinType::Vec2; return true; }
+    if (text == "vec3") { outType = PinType::Vec3; return true; }
+    if (text == "vec4") { outType = PinType::Vec4; return true; }
+    return false;
+}
+
+bool Compiler::Compile(const std::string& source, const std::vector<CustomCodePin>& inputs,
+                       const std::vector<CustomCodePin>& outputs) {
+    // Drop comments and pin declarations (`in` / `out` / `uniform` lines)
+    std::string body;
+    std::istringstream lines(source);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t comment = line.find("//");
+        if (comment != std::string::npos) line.resize(comment);
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        if (line.compare(first, 3, "in ") == 0 || line.compare(first, 4, "out ") == 0 ||
+            line.compare(first, 8, "uniform ") == 0) continue;
+        body += line;
+        body += '\n';
+    }
+
+    // Inputs are variables of their pin type; outputs become variables once assigned
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        m_Variables[inputs[i].name] = Emit(MaterialOp::Input, inputs[i].type, {}, static_cast<uint32_t>(i));
+    }
+    for (const CustomCodePin& pin : outputs) {
+        if (m_Variables.find(pin.name) == m_Variables.end()) m_Variables[pin.name] = Constant(glm::vec4(0.0f), pin.type);
+    }
+
+    const std::string_view statements(body);
+    size_t start = 0;
+    while (start < statements.size()) {
+        const size_t end = statements.find(';', start);
+        const std::string_view statement = statements.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        if (statement.find_first_not_of(" \t\r\n") != std::string_view::npos) {
+            if (!CompileStatement(statement)) return false;
+        }
+        if (end == std::string_view::npos) break;
+        start = end + 1;
+    }
+
+    // Outputs never assigned pass `In` through, like the GLSL node's default body
+    const auto in = m_Variables.find("In");
+    const Operand passthrough = in != m_Variables.end() ? in->second : Constant(glm::vec4(0.0f), PinType::Vec3);
+    for (const CustomCodePin& pin : outputs) {
+        const Operand value = m_Assigned.count(pin.name) ? m_Variables.find(pin.name)->second : passthrough;
+        m_Out.outputs.push_back(Convert(value, pin.type).expr);
+    }
+    if (Failed()) return false;
+
+    RemoveDeadExprs();
+    return true;
+}
+
+// Drop expressions no output reads (unused inputs, overwritten variables, folded operands)
+void Compiler::RemoveDeadExprs() {
+    std::vector<bool> live(m_Out.exprs.size(), false);
+    for (uint32_t output : m_Out.outputs) live[output] = true;
+    for (size_t i = m_Out.exprs.size(); i-- > 0;) {
+        if (!live[i]) continue;
+        const CustomCodeExpr& e = m_Out.exprs[i];
+        for (uint8_t a = 0; a < e.argCount; ++a) live[e.args[a]] = true;
+    }
+
+    std::vector<uint32_t> remap(m_Out.exprs.size(), 0);
+    size_t kept = 0;
+    for (size_t i = 0; i < m_Out.exprs.size(); ++i) {
+        if (!live[i]) continue;
+        CustomCodeExpr e = m_Out.exprs[i];
+        for (uint8_t a = 0; a < e.argCount; ++a) e.args[a] = remap[e.args[a]];
+        remap[i] = static_cast<uint32_t>(kept);
+        m_Out.exprs[kept++] = e;
+    }
+    m_Out.exprs.resize(kept);
+    for (uint32_t& output : m_Out.outputs) output = remap[output];
+}
+
+bool Compiler::CompileStatement(std::string_view statement) {
+    Lexer lexer(statement);
+    m_Lexer = &lexer;
+    Advance();
+
+    PinType declaredType = PinType::Float;
+    const bool declaration = m_Current.kind == TokenKind::Ident && ParseTypeName(m_Current.text, declaredType);
+    if (declaration) Advance();
+    if (m_Current.kind != TokenKind::Ident) return Fail("Unsupported statement: " + std::string(statement));
+    const std::string_view name = m_Current.text;
+    Advance();
+    if (m_Current.kind != TokenKind::Assign || (declaration && m_Current.text != "=")) {
+        return Fail("Unsupported statement: " + std::string(statement));
+    }
+    const std::string_view assign = m_Current.text;
+    Advance();
+
+    Operand value = ParseAdditive();
+    if (Failed()) return false;
+    if (m_Current.kind != TokenKind::End) {
+        return Fail("Unexpected '" + std::string(m_Current.text) + "' in: " + std::string(statement));
+    }
+
+    auto variable = m_Variables.find(name);
+    PinType type = declaredType;
+    if (!declaration) {
+        if (variable == m_Variables.end()) return Fail("Unknown identifier: " + std::string(name));
+        type = variable->second.type;
+        if (assign != "=") value = Binary(assign[0], variable->second, value);
+    }
+    value = Convert(value, type);
+    if (variable != m_Variables.end()) {
+        variable->second = value;
+    } else {
+        m_Variables.emplace(std::string(name), value);
+    }
+    m_Assigned.emplace(name);
+    return !Failed();
+}
+
+// Operands converted to their widest type (scalars broadcast)
+std::vector<Operand> Compiler::Widen(std::vector<Operand> args) {
+    int n = 1;
+    for (const Operand& a : args) n = std::max(n, Components(a));
+    for (Operand& a : args) a = Convert(a, GetVectorType(n));
+    return args;
+}
+
+Operand Compiler::Binary(char op, const Operand& a, const Operand& b) {
+    const auto args = Widen({ a, b });
+    const MaterialOp code = op == '+' ? MaterialOp::Add : op == '-' ? MaterialOp::Subtract
+                          : op == '*' ? MaterialOp::Multiply : MaterialOp::Divide;
+    return Emit(code, args[0].type, { args[0], args[1] });
+}
+
+Operand Compiler::ParseAdditive() {
+    Operand v = ParseMultiplicative();
+    while (m_Current.kind == TokenKind::Op && (m_Current.text == "+" || m_Current.text == "-")) {
+        const char op = m_Current.text[0];
+        Advance();
+        v = Binary(op, v, ParseMultiplicative());
+    }
+    return v;
+}
+
+Operand Compiler::ParseMultiplicative() {
+    Operand v = ParseUnary();
+    while (m_Current.kind == TokenKind::Op && (m_Current.text == "*" || m_Current.text == "/")) {
+        const char op = m_Current.text[0];
+        Advance();
+        v = Binary(op, v, ParseUnary());
+    }
+    return v;
+}
+
+Operand Compiler::ParseUnary() {
+    if (m_Current.kind == TokenKind::Op && (m_Current.text == "-" || m_Current.text == "+")) {
+        const bool negate = m_Current.text == "-";
+        Advance();
+        const Operand v = ParseUnary();
+        return negate ? Emit(MaterialOp::Negate, v.type, { v }) : v;
+    }
+    return ParsePostfix();
+}
+
+Operand Compiler::ParsePostfix() {
+    Operand v = ParsePrimary();
+    while (m_Current.kind == TokenKind::Dot && !Failed()) {
+        Advance();
+        if (m_Current.kind != TokenKind::Ident || m_Current.text.size() > 4) {
+            Fail("Invalid swizzle");
+            return Zero();
+        }
+        uint32_t selectors[4] = { kSelectZero, kSelectZero, kSelectZero, kSelectZero };
+        for (size_t i = 0; i < m_Current.text.size(); ++i) {
+            const char c = m_Current.text[i];
+            const size_t xyzw = std::string_view("xyzw").find(c);
+            const size_t rgba = std::string_view("rgba").find(c);
+            const size_t stpq = std::string_view("stpq").find(c);
+            const size_t component = xyzw != std::string_view::npos ? xyzw : rgba != std::string_view::npos ? rgba : stpq;
+            if (component == std::string_view::npos || static_cast<int>(component) >= Components(v)) {
+                Fail("Invalid swizzle ." + std::string(m_Current.text));
+                return Zero();
+            }
+            selectors[i] = static_cast<uint32_t>(component);
+        }
+        const PinType type = GetVectorType(static_cast<int>(m_Current.text.size()));
+        v = Swizzle(v, type, EncodeSwizzle(selectors[0], selectors[1], selectors[2], selectors[3]));
+        Advance();
+    }
+    return v;
+}
+
+Operand Compiler::ParsePrimary() {
+    if (m_Current.kind == TokenKind::Number) {
+        float value = 0.0f;
+        const char* first = m_Current.text.data();
+        const char* last = first + m_Current.text.size();
+        const auto [end, ec] = std::from_chars(first, last, value);
+        if (ec != std::errc() || end != last) Fail("Invalid number " + std::string(m_Current.text));
+        Advance();
+        return Constant(value);
+    }
+    if (m_Current.kind == TokenKind::LParen) {
+        Advance();
+        const Operand v = ParseAdditive();
+        if (m_Current.kind != TokenKind::RParen) Fail("Expected ')'");
+        Advance();
+        return v;
+    }
+    if (m_Current.kind == TokenKind::Ident) {
+        const std::string_view name = m_Current.text;
+        Advance();
+        if (m_Current.kind != TokenKind::LParen) {
+            auto it = m_Variables.find(name);
+            if (it == m_Variables.end()) {
+                Fail("Unknown identifier: " + std::string(name));
+                return Zero();
+            }
+            return it->second;
+        }
+
+        Advance();
+        std::vector<Operand> args;
+        if (m_Current.kind != TokenKind::RParen) {
+            args.push_back(ParseAdditive());
+            while (m_Current.kind == TokenKind::Comma && !Failed()) {
+                Advance();
+                args.push_back(ParseAdditive());
+            }
+        }
+        if (m_Current.kind != TokenKind::RParen) {
+            Fail("Expected ')' after arguments of " + std::string(name));
+            return Zero();
+        }
+        Advance();
+        if (Failed()) return Zero();
+        return Call(name, args);
+    }
+    Fail(m_Current.kind == TokenKind::End ? "Unexpected end of expression" : "Unexpected '" + std::string(m_Current.text) + "'");
+    return Zero();
+}
+
+Operand Compiler::Call(std::string_view name, const std::vector<Operand>& args) {
+    PinType constructed = PinType::Float;
+    if (ParseTypeName(name, constructed)) return Construct(constructed, args);
+
+    struct Function { std::string_view name; MaterialOp op; size_t arity; };
+    static constexpr Function kComponentWise[] = {
+        { "sin", MaterialOp::Sin, 1 }, { "cos", MaterialOp::Cos, 1 }, { "abs", MaterialOp::Abs, 1 },
+        { "floor", MaterialOp::Floor, 1 }, { "ceil", MaterialOp::Ceil, 1 }, { "fract", MaterialOp::Fract, 1 },
+        { "exp", MaterialOp::Exp, 1 }, { "log", MaterialOp::Log, 1 }, { "sqrt", MaterialOp::Sqrt, 1 },
+        { "min", MaterialOp::Min, 2 }, { "max", MaterialOp::Max, 2 }, { "pow", MaterialOp::Pow, 2 },
+        { "mod", MaterialOp::Mod, 2 }, { "step", MaterialOp::Step, 2 },
+        { "clamp", MaterialOp::Clamp, 3 }, { "mix", MaterialOp::Mix, 3 }, { "lerp", MaterialOp::Mix, 3 },
+        { "smoothstep", MaterialOp::Smoothstep, 3 },
+    };
+    for (const Function& fn : kComponentWise) {
+        if (name != fn.name) continue;
+        if (args.size() != fn.arity) break;
+        const auto w = Widen(args);
+        if (fn.arity == 1) return Emit(fn.op, w[0].type, { w[0] });
+        if (fn.arity == 2) return Emit(fn.op, w[0].type, { w[0], w[1] });
+        return Emit(fn.op, w[0].type, { w[0], w[1], w[2] });
+    }
+
+    // Geometric functions on up to three components (narrower vectors are zero extended)
+    auto vec3Args = [&](size_t arity) {
+        if (args.size() != arity) return false;
+        for (const Operand& a : args) {
+            if (Components(a) > 3) return false;
+        }
+        return true;
+    };
+    auto asVec3 = [&](const Operand& a) {
+        return Components(a) == 1 ? Combine({ a, Zero(), Zero() }) : Convert(a, PinType::Vec3);
+    };
+    if (name == "dot" && vec3Args(2)) {
+        return Emit(MaterialOp::Dot3, PinType::Float, { asVec3(args[0]), asVec3(args[1]) });
+    }
+    if (name == "length" && vec3Args(1)) {
+        return Emit(MaterialOp::Length3, PinType::Float, { asVec3(args[0]) });
+    }
+    if (name == "normalize" && vec3Args(1)) {
+        const Operand n = Emit(MaterialOp::Normalize3, PinType::Vec3, { asVec3(args[0]) });
+        return { n.expr, args[0].type };
+    }
+    if (name == "cross" && vec3Args(2)) {
+        return Emit(MaterialOp::Cross, PinType::Vec3, { asVec3(args[0]), asVec3(args[1]) });
+    }
+    if (name == "reflect" && vec3Args(2)) {
+        return Emit(MaterialOp::Reflect, PinType::Vec3, { asVec3(args[0]), asVec3(args[1]) });
+    }
+
+    Fail("Unsupported function: " + std::string(name));
+    return Zero();
+}
+
+// vecN(...) / float(...): a single scalar broadcasts, otherwise the arguments' components fill
+// the result in order
+Operand Compiler::Construct(PinType type, const std::vector<Operand>& args) {
+    const int n = GetPinTypeComponents(type);
+    if (args.size() == 1) {
+        if (Components(args[0]) == 1 || Components(args[0]) >= n) return Convert(args[0], type);
+    }
+    std::vector<Operand> components;
+    for (const Operand& a : args) {
+        for (int c = 0; c < Components(a) && static_cast<int>(components.size()) < n; ++c) {
+            components.push_back(Component(a, c));
+        }
+    }
+    if (static_cast<int>(components.size()) < n) {
+        Fail("Not enough components to construct " + std::string(type == PinType::Vec2 ? "vec2" : type == PinType::Vec3 ? "vec3" : "vec4"));
+        return Zero();
+    }
+    return n == 1 ? components[0] : Combine(components);
+}
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+struct CacheEntry {
+    std::string source;
+    std::vector<CustomCodePin> inputs;
+    std::vector<CustomCodePin> outputs;
+    std::shared_ptr<const CompiledCustomCode> code;
+};
+
+struct CustomCodeCache {
+    // Every edit in the code editor compiles a new body; old ones are dropped wholesale past this
+    static constexpr size_t kMaxEntries = 256;
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, CacheEntry> entries;
+};
+
+CustomCodeCache& GetCache() {
+    static CustomCodeCache cache;
+    return cache;
+}
+
+std::vector<CustomCodePin> GetPins(const MaterialGraph& graph, const std::vector<PinID>& pinIds) {
+    std::vector<CustomCodePin> pins;
+    pins.reserve(pinIds.size());
+    for (PinID pinId : pinIds) {
+        const MaterialPin* pin = graph.GetPin(pinId);
+        pins.push_back(pin ? CustomCodePin{ pin->name, pin->type } : CustomCodePin{});
+    }
+    return pins;
+}
+
+// Source and pin signature serialized back to back, each field length-prefixed
+class SignatureKey {
+public:
+    void Append(uint64_t value) {
+        m_Bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void Append(std::string_view s) {
+        Append(static_cast<uint64_t>(s.size()));
+        m_Bytes.append(s);
+    }
+
+    void Append(const MaterialGraph& graph, const std::vector<PinID>& pinIds) {
+        Append(static_cast<uint64_t>(pinIds.size()));
+        for (PinID pinId : pinIds) {
+            const MaterialPin* pin = graph.GetPin(pinId);
+            Append(pin ? std::string_view(pin->name) : std::string_view());
+            Append(static_cast<uint64_t>(pin ? pin->type : PinType::Float));
+        }
+    }
+
+    uint64_t Hash() const { return HashBytes(std::as_bytes(std::span(m_Bytes.data(), m_Bytes.size()))); }
+
+private:
+    std::string m_Bytes;
+};
+
+bool SamePins(const MaterialGraph& graph, const std::vector<PinID>& pinIds, const std::vector<CustomCodePin>& pins) {
+    if (pinIds.size() != pins.size()) return false;
+    for (size_t i = 0; i < pins.size(); ++i) {
+        const MaterialPin* pin = graph.GetPin(pinIds[i]);
+        const std::string_view name = pin ? std::string_view(pin->name) : std::string_view();
+        const PinType type = pin ? pin->type : PinType::Float;
+        if (name != pins[i].name || type != pins[i].type) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CompiledCustomCode CompileCustomCode(const std::string& source, const std::vector<CustomCodePin>& inputs,
+                                     const std::vector<CustomCodePin>& outputs) {
+    LUCENT_PROFILE_FUNCTION();
+    CompiledCustomCode code;
+    Compiler compiler(code);
+    if (!compiler.Compile(source, inputs, outputs)) {
+        code.exprs.clear();
+        code.outputs.clear();
+    }
+    return code;
+}
+
+std::shared_ptr<const CompiledCustomCode> GetCompiledCustomCode(const MaterialGraph& graph, const MaterialNode& node) {
+    static const std::string kEmpty;
+    const std::string* source = std::get_if<std::string>(&node.parameter);
+    if (!source) source = &kEmpty;
+
+    SignatureKey key;
+    key.Append(*source);
+    key.Append(graph, node.inputPins);
+    key.Append(graph, node.outputPins);
+    const uint64_t hash = key.Hash();
+
+    CustomCodeCache& cache = GetCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.entries.find(hash);
+        if (it != cache.entries.end() && it->second.source == *source &&
+            SamePins(graph, node.inputPins, it->second.inputs) && SamePins(graph, node.outputPins, it->second.outputs)) {
+            return it->second.code;
+        }
+    }
+
+    CacheEntry entry;
+    entry.source = *source;
+    entry.inputs = GetPins(graph, node.inputPins);
+    entry.outputs = GetPins(graph, node.outputPins);
+    entry.code = std::make_shared<const CompiledCustomCode>(CompileCustomCode(entry.source, entry.inputs, entry.outputs));
+    std::shared_ptr<const CompiledCustomCode> code = entry.code;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.entries.size() >= CustomCodeCache::kMaxEntries) cache.entries.clear();
+    // A hash collision replaces the other body; it compiles again when next used
+    cache.entries[hash] = std::move(entry);
+    return code;
+}
+
+void EvaluateCustomCode(const CompiledCustomCode& code, const glm::vec4* inputs, glm::vec4* outputs) {
+    std::vector<glm::vec4> values(code.exprs.size());
+    for (size_t i = 0; i < code.exprs.size(); ++i) {
+        const CustomCodeExpr& e = code.exprs[i];
+        if (e.op == MaterialOp::Input) {
+            values[i] = inputs[e.imm];
+            continue;
+        }
+        glm::vec4 args[4] = {};
+        for (uint8_t a = 0; a < e.argCount; ++a) args[a] = values[e.args[a]];
+        values[i] = EvaluateExpr(e, args);
+    }
+    for (size_t o = 0; o < code.outputs.size(); ++o) outputs[o] = values[code.outputs[o]];
+}
+
+} // namespace lucent::material
@@ -1,6 +1,9 @@
 #include "lucent/material/MaterialAsset.h"
+#include "lucent/material/ShaderCache.h"
 #include "lucent/gfx/PipelineBuilder.h"
 #include "lucent/core/Log.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -93,11 +96,16 @@ bool MaterialAsset::Init(gfx::Device* device) {
 }
 
 void MaterialAsset::Shutdown() {
+    // A compile still running finishes, but its result is dropped
+    if (m_AsyncCompiling.exchange(false)) {
+        MaterialCompileQueue::Get().Cancel(this);
+    }
     DestroyPipeline();
     m_Device = nullptr;
 }
 
 bool MaterialAsset::Recompile() {
+    LUCENT_PROFILE_FUNCTION();
     if (!m_Device) {
         m_CompileError = "No device";
         m_Valid = false;
@@ -106,6 +114,20 @@ bool MaterialAsset::Recompile() {
         return false;
     }
     
+    // This compile covers the current graph; a background one would only replace it with an older one
+    if (m_AsyncCompiling.exchange(false)) {
+        MaterialCompileQueue::Get().Cancel(this);
+    }
+    
+    // Only constant values changed: the compiled shader reads them from the parameter buffer
+    if (!NeedsShaderRecompile()) {
+        UpdateParameterBuffer();
+        m_Valid = true;
+        m_CompileError.clear();
+        m_Dirty = false;
+        return true;
+    }
+    
     // Compile the graph
     CompileResult result = m_Compiler.Compile(m_Graph);
     
@@ -118,13 +140,8 @@ bool MaterialAsset::Recompile() {
         return false;
     }
     
-    // Check if hash changed
-    if (result.graphHash == m_GraphHash && m_Pipeline != VK_NULL_HANDLE) {
-        // No change, skip pipeline creation
-        return true;
-    }
-    
     m_GraphHash = result.graphHash;
+    m_ParameterLayout = result.parameterLayout;
     
     // Create pipeline
     if (!CreatePipeline(result.fragmentShaderSPIRV)) {
@@ -132,6 +149,7 @@ bool MaterialAsset::Recompile() {
         m_Valid = false;
         return false;
     }
+    UpdateParameterBuffer();
     
     m_Valid = true;
     m_CompileError.clear();
@@ -150,56 +168,47 @@ void MaterialAsset::RequestRecompileAsync() {
         return;
     }
     
-    // If a compile is already running, just queue another pass (we'll snapshot the latest graph later).
-    if (m_AsyncCompiling.load()) {
-        m_AsyncRecompileQueued.store(true);
+    // Parameter-only edits (slider drags) rewrite the parameter buffer right away. A compile of
+    // another structure that is still in flight is no longer wanted.
+    if (!NeedsShaderRecompile()) {
+        if (m_AsyncCompiling.exchange(false)) {
+            MaterialCompileQueue::Get().Cancel(this);
+        }
+        UpdateParameterBuffer();
+        m_Valid = true;
+        m_CompileError.clear();
+        m_Dirty = false;
         return;
     }
     
-    // Snapshot graph for background compilation so the UI can keep editing safely.
-    // (MaterialGraph is value-copyable.)
-    MaterialGraph snapshot = m_Graph;
-    
+    // The queue snapshots the graph so the UI can keep editing, ignores a structure that is already
+    // queued or compiling, and supersedes a compile of an older one.
     m_AsyncCompiling.store(true);
-    m_AsyncRecompileQueued.store(false);
-    
-    m_AsyncCompileFuture = std::async(std::launch::async, [snapshot]() mutable {
-        MaterialCompiler compiler;
-        return compiler.Compile(snapshot);
-    });
+    MaterialCompileQueue::Get().Submit(this, m_Graph, m_CompilePriority);
+}
+
+void MaterialAsset::SetCompilePriority(MaterialCompilePriority priority) {
+    if (priority == m_CompilePriority) return;
+    m_CompilePriority = priority;
+    if (m_AsyncCompiling.load()) {
+        MaterialCompileQueue::Get().SetPriority(this, priority);
+    }
 }
 
 void MaterialAsset::PumpAsyncRecompile() {
     if (!m_AsyncCompiling.load()) return;
-    if (!m_AsyncCompileFuture.valid()) {
-        m_AsyncCompiling.store(false);
-        return;
-    }
-    
-    using namespace std::chrono_literals;
-    if (m_AsyncCompileFuture.wait_for(0ms) != std::future_status::ready) {
-        return;
-    }
     
+    MaterialCompileQueue& queue = MaterialCompileQueue::Get();
     CompileResult result{};
-    try {
-        result = m_AsyncCompileFuture.get();
-    } catch (const std::exception& e) {
-        m_CompileError = std::string("Async compile exception: ") + e.what();
-        m_Valid = false;
-        // Treat as a completed attempt; only retry on further edits.
-        m_Dirty = false;
-        m_AsyncCompiling.store(false);
-        return;
-    } catch (...) {
-        m_CompileError = "Async compile exception: unknown";
-        m_Valid = false;
-        m_Dirty = false;
+    const bool finished = queue.TakeResult(this, result);
+    // A newer structure may already be queued behind the one that finished
+    if (!queue.IsPending(this)) {
         m_AsyncCompiling.store(false);
-        return;
     }
-    m_AsyncCompiling.store(false);
+    if (!finished) return;
     
+    const bool wasValid = m_Valid;
+    const VkPipeline oldPipeline = m_Pipeline;
     if (!result.success) {
         // Keep old pipeline alive; just report error.
         m_CompileError = result.errorMessage;
@@ -207,13 +216,14 @@ void MaterialAsset::PumpAsyncRecompile() {
         // We attempted a compile; don't keep re-triggering until the user changes something again.
         m_Dirty = false;
     } else {
-        // If unchanged, still clear dirty (important for params that previously didn't affect hash)
+        // If unchanged, still clear dirty (the structure matches; values come from the buffer)
         if (result.graphHash == m_GraphHash && m_Pipeline != VK_NULL_HANDLE) {
             m_Valid = true;
             m_CompileError.clear();
             m_Dirty = false;
         } else {
             m_GraphHash = result.graphHash;
+            m_ParameterLayout = result.parameterLayout;
             
             if (!CreatePipeline(result.fragmentShaderSPIRV)) {
                 m_CompileError = "Failed to create pipeline";
@@ -226,12 +236,16 @@ void MaterialAsset::PumpAsyncRecompile() {
                 m_Dirty = false;
             }
         }
+        // Values edited while compiling are picked up here; the layout is the compiled one
+        UpdateParameterBuffer();
     }
+    // A failure counts even when the material was already invalid: users of the graph were
+    // waiting on this compile and now fall back
+    m_CompileStateChanged |= !result.success || m_Valid != wasValid || m_Pipeline != oldPipeline;
     
-    // If edits happened while compiling (or graph diverged), run one more pass.
-    const uint64_t currentHash = m_Graph.ComputeHash();
-    if (m_AsyncRecompileQueued.load() || (m_Valid && currentHash != m_GraphHash)) {
-        m_AsyncRecompileQueued.store(false);
+    // If the graph diverged from what was compiled and nothing newer is queued, run one more pass.
+    // RequestRecompileAsync() only updates the parameter buffer when the structure still matches.
+    if (!m_AsyncCompiling.load() && m_Valid && m_Graph.ComputeStructureHash() != m_GraphHash) {
         RequestRecompileAsync();
     }
 }
@@ -272,37 +286,48 @@ bool MaterialAsset::CreatePipeline(const std::vector<uint32_t>& fragmentSpirv) {
         return false;
     }
     
-    // Create descriptor set layout for textures (if material uses textures)
+    // Descriptor set layout: textures at binding 0, parameter buffer at binding 1 (each if used)
     const auto& textureSlots = m_Graph.GetTextureSlots();
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorPoolSize> poolSizes;
     if (!textureSlots.empty()) {
         VkDescriptorSetLayoutBinding binding{};
         binding.binding = 0;
         binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         binding.descriptorCount = static_cast<uint32_t>(textureSlots.size());
         binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-        
+        bindings.push_back(binding);
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, binding.descriptorCount });
+    }
+    if (!m_ParameterLayout.IsEmpty()) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = MaterialParameterLayout::kBinding;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings.push_back(binding);
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 });
+    }
+    
+    if (!bindings.empty()) {
         VkDescriptorSetLayoutCreateInfo layoutInfo{};
         layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        layoutInfo.bindingCount = 1;
-        layoutInfo.pBindings = &binding;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
         
         if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS) {
             LUCENT_CORE_WARN("Failed to create material descriptor set layout");
         }
     }
     
-    // Allocate + write descriptor set for textures
-    if (m_DescriptorSetLayout != VK_NULL_HANDLE && !textureSlots.empty()) {
+    // Allocate + write descriptor set
+    if (m_DescriptorSetLayout != VK_NULL_HANDLE) {
         // Create a small descriptor pool for this material
-        VkDescriptorPoolSize poolSize{};
-        poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSize.descriptorCount = static_cast<uint32_t>(textureSlots.size());
-        
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.maxSets = 1;
-        poolInfo.poolSizeCount = 1;
-        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
         
         if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS) {
             LUCENT_CORE_ERROR("Failed to create material descriptor pool");
@@ -319,51 +344,54 @@ bool MaterialAsset::CreatePipeline(const std::vector<uint32_t>& fragmentSpirv) {
             LUCENT_CORE_ERROR("Failed to allocate material descriptor set");
             return false;
         }
-        
-        // Load textures and write descriptors
+    }
+    
+    if (m_DescriptorSet != VK_NULL_HANDLE && !textureSlots.empty()) {
+        // Request textures; streamed ones sample a placeholder until resident
         m_Textures.clear();
         m_Textures.reserve(textureSlots.size());
         
-        std::vector<VkDescriptorImageInfo> imageInfos;
-        imageInfos.reserve(textureSlots.size());
-        
-        for (size_t i = 0; i < textureSlots.size(); ++i) {
-            const auto& slot = textureSlots[i];
-            
-            auto tex = std::make_unique<assets::Texture>();
-            assets::TextureDesc desc{};
-            desc.path = slot.path;
-            desc.type = assets::TextureType::Generic;
-            desc.format = slot.sRGB ? assets::TextureFormat::RGBA8_SRGB : assets::TextureFormat::RGBA8_UNORM;
-            desc.generateMips = true;
-            desc.flipVertically = true;
-            desc.debugName = slot.path.c_str();
-            
-            if (!slot.path.empty() && tex->LoadFromFile(m_Device, desc)) {
-                // ok
-            } else {
+        gfx::TextureCache& textureCache = gfx::TextureCache::Get();
+        for (const auto& slot : textureSlots) {
+            // Shared with other materials and the RT tracer; recompiles reuse the uploaded image
+            gfx::TextureHandle tex = textureCache.AcquireAsync(
+                slot.path, slot.sRGB ? gfx::TextureColorSpace::sRGB : gfx::TextureColorSpace::Linear);
+            if (!tex) {
                 // Fallback: solid magenta to make missing textures obvious
-                tex->CreateSolidColor(m_Device, 255, 0, 255, 255, "MissingTexture");
+                tex = textureCache.GetMissingTexture();
             }
-            
-            VkDescriptorImageInfo info{};
-            info.sampler = tex->GetSampler();
-            info.imageView = tex->GetView();
-            info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfos.push_back(info);
-            
             m_Textures.push_back(std::move(tex));
         }
         
+        WriteTextureDescriptors();
+    }
+    
+    if (m_DescriptorSet != VK_NULL_HANDLE && !m_ParameterLayout.IsEmpty()) {
+        // Constant node values; rewritten in place by UpdateParameterBuffer()
+        gfx::BufferDesc desc{};
+        desc.size = m_ParameterLayout.GetBufferSize();
+        desc.usage = gfx::BufferUsage::Uniform;
+        desc.hostVisible = true;
+        desc.debugName = "MaterialParameters";
+        m_ParameterBuffer = std::make_unique<gfx::Buffer>();
+        if (!m_ParameterBuffer->Init(m_Device, desc)) {
+            LUCENT_CORE_ERROR("Failed to create material parameter buffer");
+            m_ParameterBuffer.reset();
+            return false;
+        }
+        
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = m_ParameterBuffer->GetHandle();
+        bufferInfo.offset = 0;
+        bufferInfo.range = desc.size;
+        
         VkWriteDescriptorSet write{};
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.dstSet = m_DescriptorSet;
-        write.dstBinding = 0;
-        write.dstArrayElement = 0;
-        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        write.descriptorCount = static_cast<uint32_t>(imageInfos.size());
-        write.pImageInfo = imageInfos.data();
-        
+        write.dstBinding = MaterialParameterLayout::kBinding;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
         vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
     }
     
@@ -442,6 +470,61 @@ bool MaterialAsset::CreatePipeline(const std::vector<uint32_t>& fragmentSpirv) {
     return true;
 }
 
+bool MaterialAsset::NeedsShaderRecompile() const {
+    return m_Pipeline == VK_NULL_HANDLE || m_Graph.ComputeStructureHash() != m_GraphHash;
+}
+
+void MaterialAsset::UpdateParameterBuffer() {
+    m_ParameterHash = m_Graph.ComputeParameterHash();
+    if (!m_ParameterBuffer) return;
+    
+    // Host coherent, written in place: a frame still in flight may already see the new values,
+    // which for constants is indistinguishable from the edit landing a frame earlier
+    std::vector<glm::vec4> values;
+    m_ParameterLayout.Pack(m_Graph, values);
+    m_ParameterBuffer->Upload(values.data(), values.size() * sizeof(glm::vec4));
+}
+
+bool MaterialAsset::NeedsTextureRefresh() const {
+    return m_TexturesStreaming &&
+        m_TextureGeneration != gfx::TextureCache::Get().GetResidencyGeneration();
+}
+
+void MaterialAsset::RefreshTextureDescriptors() {
+    if (m_DescriptorSet == VK_NULL_HANDLE || m_Textures.empty()) return;
+    WriteTextureDescriptors();
+}
+
+void MaterialAsset::WriteTextureDescriptors() {
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    imageInfos.reserve(m_Textures.size());
+    
+    m_TexturesStreaming = false;
+    for (const auto& tex : m_Textures) {
+        VkDescriptorImageInfo info{};
+        info.sampler = tex->GetSampler();
+        info.imageView = tex->GetView();
+        info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos.push_back(info);
+        
+        if (!tex->IsResident() && !tex->IsFailed()) {
+            m_TexturesStreaming = true;
+        }
+    }
+    m_TextureGeneration = gfx::TextureCache::Get().GetResidencyGeneration();
+    
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_DescriptorSet;
+    write.dstBinding = 0;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = static_cast<uint32_t>(imageInfos.size());
+    write.pImageInfo = imageInfos.data();
+    
+    vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &write, 0, nullptr);
+}
+
 void MaterialAsset::DestroyPipeline() {
     if (!m_Device) return;
     
@@ -454,12 +537,15 @@ void MaterialAsset::DestroyPipeline() {
         m_DescriptorPool != VK_NULL_HANDLE ||
         m_DescriptorSetLayout != VK_NULL_HANDLE ||
         m_VertexShaderModule != VK_NULL_HANDLE ||
-        m_FragmentShaderModule != VK_NULL_HANDLE) {
+        m_FragmentShaderModule != VK_NULL_HANDLE ||
+        m_ParameterBuffer) {
         vkDeviceWaitIdle(device);
     }
     
-    // Destroy material textures + descriptor pool
+    // Release material textures (the cache keeps them resident) + destroy descriptor pool
     m_Textures.clear();
+    m_TexturesStreaming = false;
+    m_ParameterBuffer.reset();
     if (m_DescriptorPool != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
         m_DescriptorPool = VK_NULL_HANDLE;
@@ -495,8 +581,9 @@ void MaterialAsset::DestroyPipeline() {
 bool MaterialAssetManager::Init(gfx::Device* device, const std::string& assetsPath) {
     m_Device = device;
     
-    // Set up materials directory
+    // Set up materials directory; spellings resolved against a previous one no longer apply
     m_MaterialsPath = assetsPath + "/materials";
+    m_NormalizedPaths.clear();
     
     // Create materials directory if it doesn't exist
     try {
@@ -524,7 +611,12 @@ bool MaterialAssetManager::Init(gfx::Device* device, const std::string& assetsPa
 }
 
 void MaterialAssetManager::Shutdown() {
+    ShaderCache::Get().LogStats();
+    MaterialCompileQueue::Get().LogStats();
+    m_SelectedMaterial = nullptr;
+    m_VisibleMaterials.clear();
     m_Materials.clear();
+    m_NormalizedPaths.clear();
     m_DefaultMaterial.reset();
     m_Device = nullptr;
 }
@@ -589,31 +681,15 @@ MaterialAsset* MaterialAssetManager::CreateMaterial(const std::string& name) {
     return ptr;
 }
 
-MaterialAsset* MaterialAssetManager::LoadMaterial(const std::string& path) {
-    const std::string key = NormalizeMaterialPath(path);
-    // Check if already loaded
-    auto it = m_Materials.find(key);
-    if (it != m_Materials.end()) {
-        return it->second.get();
-    }
-    
-    // Load from file
-    std::ifstream file(key);
+bool LoadMaterialGraph(const std::string& path, MaterialGraph& outGraph, std::string& outError) {
+    std::ifstream file(path);
     if (!file.is_open()) {
-        LUCENT_CORE_ERROR("Failed to open material file: {}", key);
-        return nullptr;
-    }
-    
-    auto material = std::make_unique<MaterialAsset>();
-    if (!material->Init(m_Device)) {
-        return nullptr;
+        outError = "Failed to open material file: " + path;
+        return false;
     }
     
-    material->SetFilePath(key);
-    material->SetRenderPass(m_RenderPass);
-    
     // Parse .lmat file
-    MaterialGraph& graph = material->GetGraph();
+    MaterialGraph& graph = outGraph;
     graph.Clear();
     
     std::string line;
@@ -623,8 +699,8 @@ MaterialAsset* MaterialAssetManager::LoadMaterial(const std::string& path) {
     const bool isV1 = (line == "LUCENT_MATERIAL_V1");
     const bool isV2 = (line == "LUCENT_MATERIAL_V2");
     if (!isV1 && !isV2) {
-        LUCENT_CORE_ERROR("Invalid material file format");
-        return nullptr;
+        outError = "Invalid material file format: " + path;
+        return false;
     }
     
     // Read name
@@ -833,9 +909,37 @@ MaterialAsset* MaterialAssetManager::LoadMaterial(const std::string& path) {
     if (graph.GetNodes().empty()) {
         graph.CreateDefault();
     }
+    return true;
+}
+
+MaterialAsset* MaterialAssetManager::LoadMaterial(const std::string& path) {
+    const std::string key = NormalizeMaterialPath(path);
+    // Check if already loaded
+    auto it = m_Materials.find(key);
+    if (it != m_Materials.end()) {
+        return it->second.get();
+    }
+    
+    // Load from file
+    MaterialGraph graph;
+    std::string error;
+    if (!LoadMaterialGraph(key, graph, error)) {
+        LUCENT_CORE_ERROR("{}", error);
+        return nullptr;
+    }
+    
+    auto material = std::make_unique<MaterialAsset>();
+    if (!material->Init(m_Device)) {
+        return nullptr;
+    }
+    
+    material->SetFilePath(key);
+    material->SetRenderPass(m_RenderPass);
+    material->GetGraph() = std::move(graph);
     
-    // Compile
-    material->Recompile();
+    // Compile in the background: a scene load queues all of its materials at once and draws with
+    // the default pipeline until each one is ready
+    material->RequestRecompileAsync();
     
     MaterialAsset* ptr = material.get();
     m_Materials[key] = std::move(material);
@@ -932,7 +1036,13 @@ bool MaterialAssetManager::SaveMaterial(MaterialAsset* material, const std::stri
 }
 
 MaterialAsset* MaterialAssetManager::GetMaterial(const std::string& path) {
-    const std::string key = NormalizeMaterialPath(path);
+    auto normIt = m_NormalizedPaths.find(path);
+    if (normIt == m_NormalizedPaths.end()) {
+        // Bounded: a long session touching many distinct spellings would otherwise grow it forever
+        if (m_NormalizedPaths.size() >= kMaxNormalizedPaths) m_NormalizedPaths.clear();
+        normIt = m_NormalizedPaths.emplace(path, NormalizeMaterialPath(path)).first;
+    }
+    const std::string& key = normIt->second;
     auto it = m_Materials.find(key);
     if (it != m_Materials.end()) {
         return it->second.get();
@@ -941,26 +1051,61 @@ MaterialAsset* MaterialAssetManager::GetMaterial(const std::string& path) {
 }
 
 void MaterialAssetManager::RecompileAll() {
+    // Queued rather than compiled in turn: the pool compiles several at once, in priority order
     if (m_DefaultMaterial) {
-        m_DefaultMaterial->Recompile();
+        m_DefaultMaterial->RequestRecompileAsync();
     }
     
     for (auto& [path, material] : m_Materials) {
-        material->Recompile();
+        material->RequestRecompileAsync();
     }
     
-    LUCENT_CORE_INFO("Recompiled all materials");
+    LUCENT_CORE_INFO("Queued recompile of {} materials", m_Materials.size() + (m_DefaultMaterial ? 1 : 0));
 }
 
-void MaterialAssetManager::PumpAsyncCompiles() {
-    if (m_DefaultMaterial) {
-        m_DefaultMaterial->PumpAsyncRecompile();
+std::vector<MaterialAsset*> MaterialAssetManager::PumpAsyncCompiles() {
+    LUCENT_PROFILE_FUNCTION();
+    
+    // Streamed textures that became resident: rewrite their descriptor sets (not update-after-bind,
+    // so the GPU must be idle; one wait covers every material)
+    std::vector<MaterialAsset*> refresh;
+    if (m_DefaultMaterial && m_DefaultMaterial->NeedsTextureRefresh()) {
+        refresh.push_back(m_DefaultMaterial.get());
     }
     for (auto& [path, material] : m_Materials) {
-        if (material) {
-            material->PumpAsyncRecompile();
+        if (material && material->NeedsTextureRefresh()) {
+            refresh.push_back(material.get());
+        }
+    }
+    if (!refresh.empty() && m_Device) {
+        vkDeviceWaitIdle(m_Device->GetHandle());
+        for (MaterialAsset* material : refresh) {
+            material->RefreshTextureDescriptors();
         }
     }
+    
+    // Selected first, then whatever was drawn since the last pump, then the rest
+    auto priorityOf = [&](const MaterialAsset* material) {
+        if (material == m_SelectedMaterial) return MaterialCompilePriority::Selected;
+        if (m_VisibleMaterials.count(material)) return MaterialCompilePriority::Visible;
+        return MaterialCompilePriority::Background;
+    };
+    
+    std::vector<MaterialAsset*> changed;
+    auto pump = [&](MaterialAsset* material) {
+        material->SetCompilePriority(priorityOf(material));
+        material->PumpAsyncRecompile();
+        if (material->ConsumeCompileStateChanged()) changed.push_back(material);
+    };
+    if (m_DefaultMaterial) pump(m_DefaultMaterial.get());
+    for (auto& [path, material] : m_Materials) {
+        if (material) pump(material.get());
+    }
+    m_VisibleMaterials.clear();
+    
+    LUCENT_PROFILE_COUNTER("Material compiles queued", MaterialCompileQueue::Get().GetStats().queued);
+    LUCENT_PROFILE_COUNTER("Material compiles running", MaterialCompileQueue::Get().GetStats().running);
+    return changed;
 }
 
 } // namespace lucent::material
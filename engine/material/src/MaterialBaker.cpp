@@ -0,0 +1,639 @@
+#include "lucent/material/MaterialBaker.h"
+#include "lucent/material/MaterialProgram.h"
+#include "lucent/gfx/TextureStreaming.h"
+#include "lucent/core/JobSystem.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+namespace lucent::material {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+float SRGBToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float c) {
+    c = std::clamp(c, 0.0f, 1.0f);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// ============================================================================
+// Source textures
+// ============================================================================
+
+// Linear RGBA, in the orientation TextureCache uploads (so rows match GPU texel rows)
+struct SourceTexture {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    std::vector<float> rgba = { 1.0f, 0.0f, 1.0f, 1.0f };
+};
+
+SourceTexture LoadSourceTexture(const TextureSlot& slot) {
+    SourceTexture texture;
+    gfx::DecodedImage image;
+    std::string error;
+    if (!gfx::DecodeImageFile(slot.path, true, image, &error)) {
+        // Magenta, like the GPU's missing texture
+        LUCENT_CORE_WARN("CPU material evaluation: cannot load texture '{}': {}", slot.path, error);
+        return texture;
+    }
+
+    texture.width = image.width;
+    texture.height = image.height;
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    texture.rgba.resize(count * 4);
+    if (image.hdr) {
+        std::memcpy(texture.rgba.data(), image.pixels.data(), count * 4 * sizeof(float));
+        return texture;
+    }
+    for (size_t i = 0; i < count * 4; ++i) {
+        const float value = static_cast<float>(image.pixels[i]) / 255.0f;
+        texture.rgba[i] = (slot.sRGB && i % 4 != 3) ? SRGBToLinear(value) : value;
+    }
+    return texture;
+}
+
+// Bilinear with repeat addressing, like the material sampler
+void SampleTexture(const SourceTexture& texture, const float* u, const float* v, uint32_t count, float* const rgba[4]) {
+    const int w = static_cast<int>(texture.width);
+    const int h = static_cast<int>(texture.height);
+    auto wrap = [](int i, int size) { return ((i % size) + size) % size; };
+    for (uint32_t i = 0; i < count; ++i) {
+        const float x = u[i] * static_cast<float>(w) - 0.5f;
+        const float y = v[i] * static_cast<float>(h) - 0.5f;
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const float tx = x - fx;
+        const float ty = y - fy;
+        const int x0 = wrap(static_cast<int>(fx), w), x1 = wrap(static_cast<int>(fx) + 1, w);
+        const int y0 = wrap(static_cast<int>(fy), h), y1 = wrap(static_cast<int>(fy) + 1, h);
+        const float* p00 = &texture.rgba[(static_cast<size_t>(y0) * w + x0) * 4];
+        const float* p10 = &texture.rgba[(static_cast<size_t>(y0) * w + x1) * 4];
+        const float* p01 = &texture.rgba[(static_cast<size_t>(y1) * w + x0) * 4];
+        const float* p11 = &texture.rgba[(static_cast<size_t>(y1) * w + x1) * 4];
+        for (int c = 0; c < 4; ++c) {
+            const float top = p00[c] + (p10[c] - p00[c]) * tx;
+            const float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+            rgba[c][i] = top + (bottom - top) * ty;
+        }
+    }
+}
+
+// ============================================================================
+// Mesh UV layout
+// ============================================================================
+
+// Per texel shading inputs of a mesh bake
+struct BakeSurface {
+    std::vector<float> position[3];
+    std::vector<float> normal[3];
+    std::vector<uint8_t> covered;
+};
+
+float Edge(const glm::vec2& a, const glm::vec2& b, const glm::vec2& p) {
+    return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+// Inclusive texel rectangle
+struct TexelRect {
+    int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+
+    bool IsEmpty() const { return x0 > x1 || y0 > y1; }
+    TexelRect Intersect(const TexelRect& other) const {
+        return { std::max(x0, other.x0), std::max(y0, other.y0), std::min(x1, other.x1), std::min(y1, other.y1) };
+    }
+};
+
+// Texels whose centres the UV bounding box of a triangle can cover, clamped to the image
+TexelRect TriangleTexelBounds(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, uint32_t resolution) {
+    const int limit = static_cast<int>(resolution) - 1;
+    const float minX = std::min(a.x, std::min(b.x, c.x)), maxX = std::max(a.x, std::max(b.x, c.x));
+    const float minY = std::min(a.y, std::min(b.y, c.y)), maxY = std::max(a.y, std::max(b.y, c.y));
+    return { std::max(0, static_cast<int>(std::floor(minX - 0.5f))), std::max(0, static_cast<int>(std::floor(minY - 0.5f))),
+             std::min(limit, static_cast<int>(std::ceil(maxX - 0.5f))), std::min(limit, static_cast<int>(std::ceil(maxY - 0.5f))) };
+}
+
+// Rasterize the triangles binned to one tile at texel centres, interpolating position and normal
+void RasterizeTile(const std::vector<assets::Vertex>& vertices, const std::vector<uint32_t>& indices,
+                   const std::vector<uint32_t>& triangles, uint32_t resolution,
+                   const TexelRect& tile, BakeSurface& surface) {
+    const float scale = static_cast<float>(resolution);
+    for (uint32_t triangle : triangles) {
+        const assets::Vertex& v0 = vertices[indices[triangle * 3 + 0]];
+        const assets::Vertex& v1 = vertices[indices[triangle * 3 + 1]];
+        const assets::Vertex& v2 = vertices[indices[triangle * 3 + 2]];
+        const glm::vec2 a = v0.uv * scale, b = v1.uv * scale, c = v2.uv * scale;
+        const float area = Edge(a, b, c);
+        if (std::fabs(area) < 1e-12f) continue;
+
+        const TexelRect bounds = TriangleTexelBounds(a, b, c, resolution).Intersect(tile);
+        for (int y = bounds.y0; y <= bounds.y1; ++y) {
+            for (int x = bounds.x0; x <= bounds.x1; ++x) {
+                const glm::vec2 p(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+                const float w0 = Edge(b, c, p) / area;
+                const float w1 = Edge(c, a, p) / area;
+                const float w2 = 1.0f - w0 - w1;
+                constexpr float kEdgeTolerance = -1e-5f;
+                if (w0 < kEdgeTolerance || w1 < kEdgeTolerance || w2 < kEdgeTolerance) continue;
+
+                const size_t texel = static_cast<size_t>(y) * resolution + static_cast<size_t>(x);
+                const glm::vec3 position = v0.position * w0 + v1.position * w1 + v2.position * w2;
+                glm::vec3 normal = v0.normal * w0 + v1.normal * w1 + v2.normal * w2;
+                const float length = glm::length(normal);
+                normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+                for (int k = 0; k < 3; ++k) {
+                    surface.position[k][texel] = position[k];
+                    surface.normal[k][texel] = normal[k];
+                }
+                surface.covered[texel] = 1;
+            }
+        }
+    }
+}
+
+// Grow the covered region by one texel per pass, averaging covered neighbours, so bilinear
+// filtering and mips near UV seams do not pull in the background
+void DilateValues(std::vector<float>& values, uint32_t rows, uint32_t resolution, std::vector<uint8_t>& covered,
+                  uint32_t passes) {
+    const size_t texelCount = static_cast<size_t>(resolution) * resolution;
+    const int size = static_cast<int>(resolution);
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        std::vector<uint8_t> next = covered;
+        JobSystem::Get().ParallelFor(resolution, 0, [&](uint32_t begin, uint32_t end) {
+            for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+                for (int x = 0; x < size; ++x) {
+                    const size_t texel = static_cast<size_t>(y) * resolution + static_cast<size_t>(x);
+                    if (covered[texel]) continue;
+                    size_t neighbours[8];
+                    uint32_t count = 0;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            const int nx = x + dx, ny = y + dy;
+                            if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= size || ny >= size) continue;
+                            const size_t n = static_cast<size_t>(ny) * resolution + static_cast<size_t>(nx);
+                            if (covered[n]) neighbours[count++] = n;
+                        }
+                    }
+                    if (count == 0) continue;
+                    for (uint32_t row = 0; row < rows; ++row) {
+                        float* plane = values.data() + row * texelCount;
+                        float sum = 0.0f;
+                        for (uint32_t k = 0; k < count; ++k) sum += plane[neighbours[k]];
+                        plane[texel] = sum / static_cast<float>(count);
+                    }
+                    next[texel] = 1;
+                }
+            }
+        });
+        covered.swap(next);
+    }
+}
+
+// ============================================================================
+// Output textures
+// ============================================================================
+
+enum class ChannelEncoding { Linear, SRGB, Signed };
+
+// One component of a written image: a row of baked values, or a constant when row < 0
+struct ImageChannel {
+    int row = -1;
+    float constant = 0.0f;
+    ChannelEncoding encoding = ChannelEncoding::Linear;
+};
+
+struct BakeImage {
+    std::string path;
+    bool hdr = false;
+    std::vector<ImageChannel> channels;
+};
+
+bool WriteBakeImage(const BakeImage& image, const std::vector<float>& values, uint32_t resolution) {
+    const size_t texelCount = static_cast<size_t>(resolution) * resolution;
+    const int components = static_cast<int>(image.channels.size());
+    auto valueAt = [&](const ImageChannel& channel, size_t texel) {
+        return channel.row >= 0 ? values[static_cast<size_t>(channel.row) * texelCount + texel] : channel.constant;
+    };
+
+    // TextureCache flips images on load, so texel row y is stored as file row (resolution - 1 - y)
+    auto texelFor = [&](uint32_t fileRow, uint32_t x) {
+        return static_cast<size_t>(resolution - 1 - fileRow) * resolution + x;
+    };
+
+    const int size = static_cast<int>(resolution);
+    if (image.hdr) {
+        std::vector<float> pixels(texelCount * components);
+        for (uint32_t y = 0; y < resolution; ++y) {
+            for (uint32_t x = 0; x < resolution; ++x) {
+                const size_t texel = texelFor(y, x);
+                float* dst = &pixels[(static_cast<size_t>(y) * resolution + x) * components];
+                for (int c = 0; c < components; ++c) dst[c] = std::max(0.0f, valueAt(image.channels[c], texel));
+            }
+        }
+        return stbi_write_hdr(image.path.c_str(), size, size, components, pixels.data()) != 0;
+    }
+
+    std::vector<uint8_t> pixels(texelCount * components);
+    for (uint32_t y = 0; y < resolution; ++y) {
+        for (uint32_t x = 0; x < resolution; ++x) {
+            const size_t texel = texelFor(y, x);
+            uint8_t* dst = &pixels[(static_cast<size_t>(y) * resolution + x) * components];
+            for (int c = 0; c < components; ++c) {
+                const ImageChannel& channel = image.channels[c];
+                float value = valueAt(channel, texel);
+                if (channel.encoding == ChannelEncoding::SRGB) value = LinearToSRGB(value);
+                else if (channel.encoding == ChannelEncoding::Signed) value = value * 0.5f + 0.5f;
+                dst[c] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+            }
+        }
+    }
+    return stbi_write_png(image.path.c_str(), size, size, components, pixels.data(), size * components) != 0;
+}
+
+// True when every covered texel of `components` rows starting at `row` holds the same value
+bool IsUniform(const std::vector<float>& values, size_t texelCount, uint32_t row, int components,
+               const std::vector<uint8_t>& covered, glm::vec4& outValue) {
+    outValue = glm::vec4(0.0f);
+    bool first = true;
+    for (size_t texel = 0; texel < texelCount; ++texel) {
+        if (!covered.empty() && !covered[texel]) continue;
+        for (int c = 0; c < components; ++c) {
+            const float value = values[(row + c) * texelCount + texel];
+            if (first) outValue[c] = value;
+            else if (std::fabs(value - outValue[c]) > 1e-6f) return false;
+        }
+        first = false;
+    }
+    return true;
+}
+
+uint32_t CountTextureSamples(const MaterialProgram& program) {
+    return static_cast<uint32_t>(std::count_if(program.instructions.begin(), program.instructions.end(),
+        [](const MaterialInstruction& instruction) { return instruction.op == MaterialOp::Texture; }));
+}
+
+PinID FindNodeInput(const MaterialGraph& graph, NodeID nodeId, const std::string& name) {
+    const MaterialNode* node = graph.GetNode(nodeId);
+    if (!node) return INVALID_PIN_ID;
+    for (PinID pinId : node->inputPins) {
+        const MaterialPin* pin = graph.GetPin(pinId);
+        if (pin && pin->name == name) return pinId;
+    }
+    return INVALID_PIN_ID;
+}
+
+} // namespace
+
+MaterialTextureSampler CreateMaterialTextureSampler(const MaterialGraph& graph) {
+    LUCENT_PROFILE_FUNCTION();
+    auto textures = std::make_shared<std::vector<SourceTexture>>();
+    for (const TextureSlot& slot : graph.GetTextureSlots()) textures->push_back(LoadSourceTexture(slot));
+    return [textures](uint32_t slot, const float* u, const float* v, uint32_t count, float* const rgba[4]) {
+        static const SourceTexture missingTexture;
+        SampleTexture(slot < textures->size() ? (*textures)[slot] : missingTexture, u, v, count, rgba);
+    };
+}
+
+bool BakeMaterialToTextures(const MaterialGraph& graph, const MaterialBakeSettings& settings,
+                            MaterialBakeResult& outResult, std::string& outError,
+                            MaterialBakeProgress* progress) {
+    LUCENT_PROFILE_FUNCTION();
+    outError.clear();
+    outResult = MaterialBakeResult{};
+
+    if (graph.GetDomain() != MaterialDomain::Surface) {
+        outError = "Only surface materials can be baked";
+        return false;
+    }
+    if (settings.resolution == 0 || settings.tileSize == 0) {
+        outError = "Bake resolution and tile size must be non-zero";
+        return false;
+    }
+    const bool useMesh = settings.vertices && settings.indices && !settings.indices->empty();
+    if (useMesh) {
+        for (uint32_t index : *settings.indices) {
+            if (index >= settings.vertices->size()) {
+                outError = "Bake mesh has an out-of-range index";
+                return false;
+            }
+        }
+    }
+
+    MaterialProgram program;
+    if (!CompileMaterialProgram(graph, program, outError)) return false;
+    MaterialBakeStats& stats = outResult.stats;
+    stats.sourceInstructions = static_cast<uint32_t>(program.instructions.size());
+    stats.sourceTextureSamples = CountTextureSamples(program);
+
+    const auto bakeStart = Clock::now();
+    const uint32_t resolution = settings.resolution;
+    const size_t texelCount = static_cast<size_t>(resolution) * resolution;
+
+    MaterialTextureSampler sampler;
+    if (stats.sourceTextureSamples > 0) sampler = CreateMaterialTextureSampler(graph);
+
+    // Tiles, with the mesh triangles overlapping each one
+    const uint32_t tileSize = std::min(settings.tileSize, resolution);
+    const uint32_t tilesPerRow = (resolution + tileSize - 1) / tileSize;
+    const uint32_t tileCount = tilesPerRow * tilesPerRow;
+    stats.tiles = tileCount;
+
+    BakeSurface surface;
+    std::vector<std::vector<uint32_t>> bins;
+    if (useMesh) {
+        for (int k = 0; k < 3; ++k) {
+            surface.position[k].assign(texelCount, 0.0f);
+            surface.normal[k].assign(texelCount, k == 2 ? 1.0f : 0.0f);
+        }
+        surface.covered.assign(texelCount, 0);
+        bins.resize(tileCount);
+        const float scale = static_cast<float>(resolution);
+        const auto& vertices = *settings.vertices;
+        const auto& indices = *settings.indices;
+        for (uint32_t triangle = 0; triangle < indices.size() / 3; ++triangle) {
+            const TexelRect bounds = TriangleTexelBounds(vertices[indices[triangle * 3]].uv * scale,
+                vertices[indices[triangle * 3 + 1]].uv * scale, vertices[indices[triangle * 3 + 2]].uv * scale, resolution);
+            if (bounds.IsEmpty()) continue;
+            for (uint32_t ty = static_cast<uint32_t>(bounds.y0) / tileSize; ty <= static_cast<uint32_t>(bounds.y1) / tileSize; ++ty) {
+                for (uint32_t tx = static_cast<uint32_t>(bounds.x0) / tileSize; tx <= static_cast<uint32_t>(bounds.x1) / tileSize; ++tx) {
+                    bins[ty * tilesPerRow + tx].push_back(triangle);
+                }
+            }
+        }
+    }
+
+    // Evaluate every tile on the JobSystem; tiles write disjoint texels
+    std::vector<float> values(static_cast<size_t>(program.outputRowCount) * texelCount, 0.0f);
+    std::atomic<uint64_t> evaluated{ 0 };
+    std::atomic<uint32_t> tilesDone{ 0 };
+    auto cancelled = [progress] { return progress && progress->cancelled.load(std::memory_order_relaxed); };
+    JobSystem::Get().ParallelFor(tileCount, 1, [&](uint32_t begin, uint32_t end) {
+        std::vector<uint32_t> texels;
+        std::vector<float> inputs[11];  // uv, position, normal
+        std::vector<float> outputs;
+        for (uint32_t tile = begin; tile < end; ++tile) {
+            LUCENT_PROFILE_ZONE("Bake tile");
+            if (progress) {
+                // Counted up front so every early `continue` below is included; remaining tiles are
+                // skipped once cancelled
+                const uint32_t done = tilesDone.fetch_add(1, std::memory_order_relaxed) + 1;
+                progress->fraction.store(static_cast<float>(done) / static_cast<float>(tileCount),
+                                         std::memory_order_relaxed);
+                if (cancelled()) continue;
+            }
+            TexelRect rect;
+            rect.x0 = static_cast<int>((tile % tilesPerRow) * tileSize);
+            rect.y0 = static_cast<int>((tile / tilesPerRow) * tileSize);
+            rect.x1 = std::min(rect.x0 + static_cast<int>(tileSize), static_cast<int>(resolution)) - 1;
+            rect.y1 = std::min(rect.y0 + static_cast<int>(tileSize), static_cast<int>(resolution)) - 1;
+            if (useMesh) {
+                if (bins[tile].empty()) continue;
+                RasterizeTile(*settings.vertices, *settings.indices, bins[tile], resolution, rect, surface);
+            }
+
+            texels.clear();
+            for (auto& stream : inputs) stream.clear();
+            for (int y = rect.y0; y <= rect.y1; ++y) {
+                for (int x = rect.x0; x <= rect.x1; ++x) {
+                    const size_t texel = static_cast<size_t>(y) * resolution + static_cast<size_t>(x);
+                    if (useMesh && !surface.covered[texel]) continue;
+                    texels.push_back(static_cast<uint32_t>(texel));
+                    inputs[0].push_back((static_cast<float>(x) + 0.5f) / static_cast<float>(resolution));
+                    inputs[1].push_back((static_cast<float>(y) + 0.5f) / static_cast<float>(resolution));
+                    if (useMesh) {
+                        for (int k = 0; k < 3; ++k) {
+                            inputs[2 + k].push_back(surface.position[k][texel]);
+                            inputs[5 + k].push_back(surface.normal[k][texel]);
+                        }
+                    }
+                }
+            }
+            if (texels.empty()) continue;
+
+            MaterialShadingPoints points;
+            points.count = static_cast<uint32_t>(texels.size());
+            points.uv[0] = inputs[0].data();
+            points.uv[1] = inputs[1].data();
+            if (useMesh) {
+                for (int k = 0; k < 3; ++k) {
+                    points.position[k] = inputs[2 + k].data();
+                    points.normal[k] = inputs[5 + k].data();
+                    points.viewDirection[k] = inputs[5 + k].data();
+                }
+            }
+            points.sampleTexture = sampler;
+
+            outputs.resize(static_cast<size_t>(program.outputRowCount) * points.count);
+            program.Execute(points, outputs.data());
+            for (uint32_t row = 0; row < program.outputRowCount; ++row) {
+                const float* src = outputs.data() + static_cast<size_t>(row) * points.count;
+                float* dst = values.data() + static_cast<size_t>(row) * texelCount;
+                for (uint32_t i = 0; i < points.count; ++i) dst[texels[i]] = src[i];
+            }
+            evaluated.fetch_add(points.count, std::memory_order_relaxed);
+        }
+    });
+    stats.texelsEvaluated = evaluated.load();
+    if (cancelled()) {
+        outError = "Bake cancelled";
+        return false;
+    }
+    if (useMesh && settings.padding > 0) {
+        DilateValues(values, program.outputRowCount, resolution, surface.covered, settings.padding);
+    }
+    stats.bakeMs = MillisecondsSince(bakeStart);
+
+    // Decide per output: constant when uniform, else a texture channel
+    struct Channel {
+        const MaterialProgramOutput* output = nullptr;
+        bool uniform = true;
+        glm::vec4 value = glm::vec4(0.0f);
+    };
+    auto channel = [&](const char* name) {
+        Channel c;
+        c.output = program.FindOutput(name);
+        if (c.output) {
+            c.uniform = IsUniform(values, texelCount, c.output->row, GetPinTypeComponents(c.output->type),
+                                  surface.covered, c.value);
+        }
+        return c;
+    };
+    const Channel baseColor = channel("Base Color");
+    const Channel alpha = channel("Alpha");
+    const Channel metallic = channel("Metallic");
+    const Channel roughness = channel("Roughness");
+    const Channel normal = channel("Normal");
+    const Channel emissive = channel("Emissive");
+    auto row = [](const Channel& c, int component) { return c.output ? static_cast<int>(c.output->row) + component : -1; };
+
+    std::error_code ec;
+    std::filesystem::create_directories(settings.outputDirectory, ec);
+    if (ec) {
+        outError = "Cannot create bake directory '" + settings.outputDirectory + "': " + ec.message();
+        return false;
+    }
+    auto texturePath = [&](const char* suffix) {
+        return (std::filesystem::path(settings.outputDirectory) / (settings.name + suffix)).generic_string();
+    };
+
+    std::vector<BakeImage> images;
+    int baseColorImage = -1, metallicRoughnessImage = -1, normalImage = -1, emissiveImage = -1;
+    if (!baseColor.uniform || !alpha.uniform) {
+        BakeImage image{ texturePath("_basecolor.png"), false, {} };
+        for (int c = 0; c < 3; ++c) image.channels.push_back({ row(baseColor, c), baseColor.value[c], ChannelEncoding::SRGB });
+        if (!alpha.uniform) image.channels.push_back({ row(alpha, 0), 1.0f, ChannelEncoding::Linear });
+        baseColorImage = static_cast<int>(images.size());
+        images.push_back(std::move(image));
+    }
+    if (!metallic.uniform || !roughness.uniform) {
+        // glTF layout: roughness in G, metallic in B
+        BakeImage image{ texturePath("_metallicroughness.png"), false, {} };
+        image.channels.push_back({ -1, 1.0f, ChannelEncoding::Linear });
+        image.channels.push_back({ row(roughness, 0), roughness.value.x, ChannelEncoding::Linear });
+        image.channels.push_back({ row(metallic, 0), metallic.value.x, ChannelEncoding::Linear });
+        metallicRoughnessImage = static_cast<int>(images.size());
+        images.push_back(std::move(image));
+    }
+    if (!normal.uniform) {
+        // The output is normalized by the shader anyway; store unit vectors
+        float* planes[3];
+        for (int c = 0; c < 3; ++c) planes[c] = values.data() + static_cast<size_t>(row(normal, c)) * texelCount;
+        for (size_t texel = 0; texel < texelCount; ++texel) {
+            const glm::vec3 n(planes[0][texel], planes[1][texel], planes[2][texel]);
+            const float length = glm::length(n);
+            for (int c = 0; c < 3; ++c) planes[c][texel] = length > 0.0f ? n[c] / length : (c == 2 ? 1.0f : 0.0f);
+        }
+        BakeImage image{ texturePath("_normal.png"), false, {} };
+        for (int c = 0; c < 3; ++c) image.channels.push_back({ row(normal, c), 0.0f, ChannelEncoding::Signed });
+        normalImage = static_cast<int>(images.size());
+        images.push_back(std::move(image));
+    }
+    if (!emissive.uniform) {
+        // HDR emission keeps its range in Radiance .hdr, anything in [0, 1] fits an sRGB PNG
+        const float* first = values.data() + static_cast<size_t>(row(emissive, 0)) * texelCount;
+        const bool hdr = std::any_of(first, first + 3 * texelCount, [](float v) { return v > 1.0f; });
+        BakeImage image{ texturePath(hdr ? "_emissive.hdr" : "_emissive.png"), hdr, {} };
+        for (int c = 0; c < 3; ++c) {
+            image.channels.push_back({ row(emissive, c), 0.0f, hdr ? ChannelEncoding::Linear : ChannelEncoding::SRGB });
+        }
+        emissiveImage = static_cast<int>(images.size());
+        images.push_back(std::move(image));
+    }
+
+    if (cancelled()) {
+        outError = "Bake cancelled";
+        return false;
+    }
+    const auto writeStart = Clock::now();
+    std::vector<uint8_t> written(images.size(), 0);
+    JobSystem::Get().ParallelFor(static_cast<uint32_t>(images.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) written[i] = WriteBakeImage(images[i], values, resolution) ? 1 : 0;
+    });
+    stats.writeMs = MillisecondsSince(writeStart);
+    for (size_t i = 0; i < images.size(); ++i) {
+        if (!written[i]) {
+            outError = "Failed to write baked texture '" + images[i].path + "'";
+            return false;
+        }
+        outResult.texturePaths.push_back(images[i].path);
+    }
+
+    // Simplified graph: texture samples and constants into a fresh output node
+    MaterialGraph& baked = outResult.graph;
+    baked.Clear();
+    baked.SetName(graph.GetName() + " (Baked)");
+    const NodeID outputNode = baked.CreateNode(NodeType::PBROutput, glm::vec2(600.0f, 200.0f));
+    baked.SetOutputNodeId(outputNode);
+
+    float nodeY = 0.0f;
+    auto nextPosition = [&](float x) {
+        const glm::vec2 position(x, nodeY);
+        nodeY += 160.0f;
+        return position;
+    };
+    std::vector<NodeID> textureNodes(images.size(), INVALID_NODE_ID);
+    auto textureOutput = [&](int image, size_t outputIndex) {
+        if (textureNodes[image] == INVALID_NODE_ID) {
+            const bool sRGB = image == baseColorImage || (image == emissiveImage && !images[image].hdr);
+            baked.AddTextureSlot(images[image].path, sRGB);
+            textureNodes[image] = baked.CreateNode(NodeType::Texture2D, nextPosition(100.0f));
+            baked.GetNode(textureNodes[image])->parameter = images[image].path;
+        }
+        return baked.GetNode(textureNodes[image])->outputPins[outputIndex];
+    };
+    // Uniform outputs equal to the output pin default stay unconnected
+    auto connectConstant = [&](const Channel& c, const char* pinName) {
+        const PinID target = FindNodeInput(baked, outputNode, pinName);
+        const MaterialPin* pin = baked.GetPin(target);
+        if (!c.output || !pin) return;
+        const bool isFloat = c.output->type == PinType::Float;
+        const float* defaultFloat = std::get_if<float>(&pin->defaultValue);
+        const glm::vec3* defaultVec3 = std::get_if<glm::vec3>(&pin->defaultValue);
+        if (isFloat ? (defaultFloat && *defaultFloat == c.value.x) : (defaultVec3 && *defaultVec3 == glm::vec3(c.value))) return;
+        const NodeID node = baked.CreateNode(isFloat ? NodeType::ConstFloat : NodeType::ConstVec3, nextPosition(300.0f));
+        if (isFloat) baked.GetNode(node)->parameter = c.value.x;
+        else baked.GetNode(node)->parameter = glm::vec3(c.value);
+        baked.CreateLink(baked.GetNode(node)->outputPins[0], target);
+    };
+    auto connect = [&](PinID source, const char* pinName) {
+        baked.CreateLink(source, FindNodeInput(baked, outputNode, pinName));
+    };
+
+    // Texture2D outputs: RGB, R, G, B, A
+    if (baseColor.uniform) connectConstant(baseColor, "Base Color");
+    else connect(textureOutput(baseColorImage, 0), "Base Color");
+    if (alpha.uniform) connectConstant(alpha, "Alpha");
+    else connect(textureOutput(baseColorImage, 4), "Alpha");
+    if (metallic.uniform) connectConstant(metallic, "Metallic");
+    else connect(textureOutput(metallicRoughnessImage, 3), "Metallic");
+    if (roughness.uniform) connectConstant(roughness, "Roughness");
+    else connect(textureOutput(metallicRoughnessImage, 2), "Roughness");
+    if (normal.uniform) {
+        connectConstant(normal, "Normal");
+    } else {
+        // [0, 1] back to [-1, 1]
+        const NodeID scale = baked.CreateNode(NodeType::Multiply, nextPosition(300.0f));
+        const NodeID bias = baked.CreateNode(NodeType::Subtract, nextPosition(450.0f));
+        baked.GetPin(baked.GetNode(scale)->inputPins[1])->defaultValue = glm::vec3(2.0f);
+        baked.GetPin(baked.GetNode(bias)->inputPins[1])->defaultValue = glm::vec3(1.0f);
+        baked.CreateLink(textureOutput(normalImage, 0), baked.GetNode(scale)->inputPins[0]);
+        baked.CreateLink(baked.GetNode(scale)->outputPins[0], baked.GetNode(bias)->inputPins[0]);
+        connect(baked.GetNode(bias)->outputPins[0], "Normal");
+    }
+    if (emissive.uniform) connectConstant(emissive, "Emissive");
+    else connect(textureOutput(emissiveImage, 0), "Emissive");
+
+    MaterialProgram bakedProgram;
+    std::string bakedError;
+    if (CompileMaterialProgram(baked, bakedProgram, bakedError)) {
+        stats.bakedInstructions = static_cast<uint32_t>(bakedProgram.instructions.size());
+        stats.bakedTextureSamples = CountTextureSamples(bakedProgram);
+    }
+
+    LUCENT_CORE_INFO("Baked material '{}' at {}x{}: {:.1f} ms ({} tiles, {} texels) + {:.1f} ms writing {} textures",
+                     graph.GetName(), resolution, resolution, stats.bakeMs, stats.tiles, stats.texelsEvaluated,
+                     stats.writeMs, images.size());
+    LUCENT_CORE_INFO("  Shader cost per point: {} -> {} instructions, {} -> {} texture samples",
+                     stats.sourceInstructions, stats.bakedInstructions, stats.sourceTextureSamples,
+                     stats.bakedTextureSamples);
+    return true;
+}
+
+} // namespace lucent::material
@@ -0,0 +1,266 @@
+#include "lucent/material/MaterialCompileQueue.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace lucent::material {
+
+namespace {
+
+double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+MaterialCompileQueue::MaterialCompileQueue(uint32_t maxConcurrent, CompileFunction compile)
+    : m_Compile(std::move(compile))
+    , m_MaxConcurrent(maxConcurrent) {
+}
+
+MaterialCompileQueue::~MaterialCompileQueue() {
+    // Running compiles reference this queue. The singleton is already drained by Shutdown(), so
+    // static destruction never reaches the JobSystem.
+    if (!m_Jobs.IsDone()) Shutdown();
+}
+
+void MaterialCompileQueue::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShutDown = true;
+        m_Cancelled += m_Queued.size();
+        m_Queued.clear();
+        // Running compiles finish, but nobody collects them
+        for (auto& [owner, running] : m_Running) {
+            if (running.stale) continue;
+            running.stale = true;
+            ++m_Cancelled;
+        }
+        m_Results.clear();
+    }
+    JobSystem::Get().Wait(m_Jobs);
+}
+
+void MaterialCompileQueue::SetMaxConcurrent(uint32_t maxConcurrent) {
+    std::vector<Request> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_MaxConcurrent = maxConcurrent;
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+}
+
+bool MaterialCompileQueue::Submit(Owner owner, MaterialGraph graph, MaterialCompilePriority priority) {
+    const uint64_t structureHash = graph.ComputeStructureHash();
+
+    std::vector<Request> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_ShutDown) return false;
+        ++m_Submitted;
+
+        auto queued = std::find_if(m_Queued.begin(), m_Queued.end(),
+                                   [owner](const Request& request) { return request.owner == owner; });
+        auto running = m_Running.find(owner);
+
+        // Already queued: keep the request (and its place in line), only raise its priority
+        if (queued != m_Queued.end() && queued->structureHash == structureHash) {
+            queued->priority = std::min(queued->priority, priority);
+            ++m_Deduplicated;
+            return false;
+        }
+
+        // Already compiling. A queued request is for a different structure and is now superseded;
+        // a stale compile of this structure becomes current again.
+        if (running != m_Running.end() && running->second.structureHash == structureHash) {
+            if (queued != m_Queued.end()) {
+                m_Queued.erase(queued);
+                ++m_Superseded;
+            }
+            running->second.stale = false;
+            ++m_Deduplicated;
+            return false;
+        }
+
+        if (running != m_Running.end() && !running->second.stale) {
+            running->second.stale = true;
+            ++m_Superseded;
+        }
+
+        Request request;
+        request.owner = owner;
+        request.graph = std::move(graph);
+        request.structureHash = structureHash;
+        request.priority = priority;
+        request.sequence = m_NextSequence++;
+        request.submitTime = Clock::now();
+        if (queued != m_Queued.end()) {
+            request.priority = std::min(queued->priority, priority);
+            *queued = std::move(request);
+            ++m_Superseded;
+        } else {
+            m_Queued.push_back(std::move(request));
+        }
+
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+    return true;
+}
+
+void MaterialCompileQueue::SetPriority(Owner owner, MaterialCompilePriority priority) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (Request& request : m_Queued) {
+        if (request.owner == owner) {
+            request.priority = priority;
+            return;
+        }
+    }
+}
+
+void MaterialCompileQueue::Cancel(Owner owner) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto queued = std::find_if(m_Queued.begin(), m_Queued.end(),
+                               [owner](const Request& request) { return request.owner == owner; });
+    if (queued != m_Queued.end()) {
+        m_Queued.erase(queued);
+        ++m_Cancelled;
+    }
+    if (auto running = m_Running.find(owner); running != m_Running.end() && !running->second.stale) {
+        running->second.stale = true;
+        ++m_Cancelled;
+    }
+    m_Results.erase(owner);
+}
+
+bool MaterialCompileQueue::IsPending(Owner owner) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Results.count(owner)) return true;
+    if (auto running = m_Running.find(owner); running != m_Running.end() && !running->second.stale) return true;
+    return std::any_of(m_Queued.begin(), m_Queued.end(),
+                       [owner](const Request& request) { return request.owner == owner; });
+}
+
+bool MaterialCompileQueue::TakeResult(Owner owner, CompileResult& outResult) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Results.find(owner);
+    if (it == m_Results.end()) return false;
+    outResult = std::move(it->second);
+    m_Results.erase(it);
+    return true;
+}
+
+void MaterialCompileQueue::WaitIdle() {
+    JobSystem::Get().Wait(m_Jobs);
+}
+
+uint32_t MaterialCompileQueue::GetConcurrencyLimit() const {
+    if (m_MaxConcurrent > 0) return m_MaxConcurrent;
+    // Leave half the pool for the frame's own jobs (culling, texture decode, ...)
+    return std::max(1u, JobSystem::Get().GetWorkerCount() / 2);
+}
+
+std::vector<MaterialCompileQueue::Request> MaterialCompileQueue::TakeStartable() {
+    std::vector<Request> startable;
+    const uint32_t limit = GetConcurrencyLimit();
+    while (m_Running.size() < limit) {
+        // Most urgent, then oldest. An owner whose stale compile is still running waits for it,
+        // so one material never occupies two slots.
+        auto next = m_Queued.end();
+        for (auto it = m_Queued.begin(); it != m_Queued.end(); ++it) {
+            if (m_Running.count(it->owner)) continue;
+            if (next == m_Queued.end() || it->priority < next->priority ||
+                (it->priority == next->priority && it->sequence < next->sequence)) {
+                next = it;
+            }
+        }
+        if (next == m_Queued.end()) break;
+
+        m_Running[next->owner] = RunningCompile{ next->structureHash, next->sequence, false };
+        startable.push_back(std::move(*next));
+        m_Queued.erase(next);
+    }
+    return startable;
+}
+
+void MaterialCompileQueue::Start(std::vector<Request> requests) {
+    for (Request& request : requests) {
+        JobSystem::Get().Schedule([this, request = std::move(request)]() mutable { Run(request); }, &m_Jobs);
+    }
+}
+
+void MaterialCompileQueue::Run(Request& request) {
+    LUCENT_PROFILE_ZONE("MaterialCompileQueue::Run");
+    const Clock::time_point startTime = Clock::now();
+
+    CompileResult result;
+    try {
+        if (m_Compile) {
+            result = m_Compile(request.graph);
+        } else {
+            MaterialCompiler compiler;
+            result = compiler.Compile(request.graph);
+        }
+    } catch (const std::exception& e) {
+        result = CompileResult{};
+        result.errorMessage = std::string("Async compile exception: ") + e.what();
+    } catch (...) {
+        result = CompileResult{};
+        result.errorMessage = "Async compile exception: unknown";
+    }
+    const Clock::time_point endTime = Clock::now();
+
+    std::vector<Request> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto running = m_Running.find(request.owner);
+        if (running != m_Running.end() && running->second.sequence == request.sequence) {
+            // Stale results were already counted as superseded or cancelled
+            if (!running->second.stale) {
+                m_Results[request.owner] = std::move(result);
+                ++m_Completed;
+                const double waitMs = ElapsedMs(request.submitTime, startTime);
+                const double latencyMs = ElapsedMs(request.submitTime, endTime);
+                m_TotalWaitMs += waitMs;
+                m_MaxWaitMs = std::max(m_MaxWaitMs, waitMs);
+                m_TotalLatencyMs += latencyMs;
+                m_MaxLatencyMs = std::max(m_MaxLatencyMs, latencyMs);
+            }
+            m_Running.erase(running);
+        }
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+}
+
+MaterialCompileQueueStats MaterialCompileQueue::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    MaterialCompileQueueStats stats;
+    stats.queued = static_cast<uint32_t>(m_Queued.size());
+    stats.running = static_cast<uint32_t>(m_Running.size());
+    stats.maxConcurrent = GetConcurrencyLimit();
+    stats.submitted = m_Submitted;
+    stats.completed = m_Completed;
+    stats.deduplicated = m_Deduplicated;
+    stats.superseded = m_Superseded;
+    stats.cancelled = m_Cancelled;
+    stats.totalWaitMs = m_TotalWaitMs;
+    stats.maxWaitMs = m_MaxWaitMs;
+    stats.totalLatencyMs = m_TotalLatencyMs;
+    stats.maxLatencyMs = m_MaxLatencyMs;
+    return stats;
+}
+
+void MaterialCompileQueue::LogStats() const {
+    const MaterialCompileQueueStats stats = GetStats();
+    LUCENT_CORE_INFO("MaterialCompileQueue: {} queued, {} / {} running, {} submitted, {} compiled, {} deduplicated, "
+                     "{} superseded, {} cancelled, wait {:.1f} ms avg ({:.1f} max), latency {:.1f} ms avg ({:.1f} max)",
+                     stats.queued, stats.running, stats.maxConcurrent, stats.submitted, stats.completed,
+                     stats.deduplicated, stats.superseded, stats.cancelled, stats.GetAverageWaitMs(), stats.maxWaitMs,
+                     stats.GetAverageLatencyMs(), stats.maxLatencyMs);
+}
+
+} // namespace lucent::material
@@ -1,28 +1,23 @@
 #include "lucent/material/MaterialCompiler.h"
+#include "lucent/material/MaterialOptimizer.h"
+#include "lucent/material/ShaderCache.h"
 #include "lucent/core/Log.h"
+#include "lucent/core/Profiler.h"
 #include <shaderc/shaderc.hpp>
+#if __has_include(<glslang/build_info.h>)
+    #include <glslang/build_info.h>
+#endif
+#include <chrono>
 #include <sstream>
 #include <queue>
 #include <set>
+#include <unordered_set>
 #include <mutex>
 #include <cctype>
+#include <algorithm>
 
 namespace lucent::material {
 
-// Noise node parameter (optional, V2): "NOISE2:<type>;<scale>,<detail>,<roughness>,<distortion>"
-// - type: 0=FBM, 1=Value, 2=Ridged, 3=Turbulence
-static bool ParseNoise2Param(const std::string& s, int& outType, glm::vec4& outParams) {
-    if (s.rfind("NOISE2:", 0) != 0) return false;
-    int t = 0;
-    float x = 5.0f, y = 4.0f, z = 0.5f, w = 0.0f;
-    if (sscanf_s(s.c_str(), "NOISE2:%d;%f,%f,%f,%f", &t, &x, &y, &z, &w) == 5) {
-        outType = t;
-        outParams = glm::vec4(x, y, z, w);
-        return true;
-    }
-    return false;
-}
-
 namespace {
 struct CustomCodeDecl {
     bool isOutput = false;
@@ -88,6 +83,26 @@ static void ParseCustomCode(const std::string& code, std::vector<CustomCodeDecl>
         outBody += line;
     }
 }
+
+#ifndef LUCENT_SHADER_COMPILER_BUILD
+    #define LUCENT_SHADER_COMPILER_BUILD ""
+#endif
+
+// Everything besides the source that changes the fragment SPIR-V; part of the shader cache key.
+// The compiler is named by its build (set by CMake from the installed ports) and the glslang
+// release, not by the SPIR-V version it emits, which stays the same across compiler upgrades.
+// Must follow the options set in CompileGLSLToSPIRV.
+const std::string& GetFragmentCompileOptionsKey() {
+    static const std::string key = [] {
+        std::string compiler = "shaderc;build=" LUCENT_SHADER_COMPILER_BUILD;
+#ifdef GLSLANG_VERSION_MAJOR
+        compiler += ";glslang-" + std::to_string(GLSLANG_VERSION_MAJOR) + "." + std::to_string(GLSLANG_VERSION_MINOR) +
+                    "." + std::to_string(GLSLANG_VERSION_PATCH) + GLSLANG_VERSION_FLAVOR;
+#endif
+        return compiler + ";fragment;vulkan1.2;performance";
+    }();
+    return key;
+}
 } // namespace
 
 // Standard vertex shader source (same interface as mesh.vert)
@@ -158,12 +173,45 @@ const std::vector<uint32_t>& MaterialCompiler::GetStandardVertexShaderSPIRV() {
 }
 
 CompileResult MaterialCompiler::Compile(const MaterialGraph& graph) {
+    LUCENT_PROFILE_FUNCTION();
+    CompileResult result = GenerateGLSL(graph);
+    if (!result.success) {
+        return result;
+    }
+    
+    // Compile to SPIR-V (or reuse an identical earlier compile from the shader cache)
+    if (!CompileGLSLToSPIRV(result.graphHash, result.fragmentShaderGLSL, result.fragmentShaderSPIRV,
+                            result.errorMessage)) {
+        result.success = false;
+        return result;
+    }
+    
+    return result;
+}
+
+CompileResult MaterialCompiler::GenerateGLSL(const MaterialGraph& graph) {
+    LUCENT_PROFILE_FUNCTION();
     CompileResult result;
-    result.graphHash = graph.ComputeHash();
+    result.graphHash = graph.ComputeStructureHash();
+    result.parameterHash = graph.ComputeParameterHash();
     result.domain = graph.GetDomain();
     
+    // Slots come from the edited graph: the optimizer keeps node and pin IDs, and the constants it
+    // creates by folding are not parameters
+    result.parameterLayout = MaterialParameterLayout::Build(graph);
+    
+    // Generate from the optimized graph. Constant nodes and pin defaults are parameters here, so
+    // nothing that depends on their values is folded into the shader.
+    MaterialOptimizeOptions optimizeOptions;
+    optimizeOptions.constantsAreParameters = true;
+    MaterialOptimizeStats optimizeStats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &optimizeStats, optimizeOptions);
+    LUCENT_CORE_DEBUG("Material '{}' optimized: {} -> {} nodes ({} folded, {} simplified, {} merged, {} removed)",
+                      graph.GetName(), optimizeStats.nodesBefore, optimizeStats.nodesAfter, optimizeStats.folded,
+                      optimizeStats.simplified, optimizeStats.merged, optimizeStats.removed);
+    
     // Generate GLSL based on domain
-    result.fragmentShaderGLSL = GenerateFragmentGLSL(graph);
+    result.fragmentShaderGLSL = GenerateFragmentGLSL(optimized, result.parameterLayout);
     
     if (result.fragmentShaderGLSL.empty()) {
         result.success = false;
@@ -171,25 +219,130 @@ CompileResult MaterialCompiler::Compile(const MaterialGraph& graph) {
         return result;
     }
     
-    // Compile to SPIR-V
-    if (!CompileGLSLToSPIRV(result.fragmentShaderGLSL, result.fragmentShaderSPIRV, result.errorMessage)) {
-        result.success = false;
-        return result;
-    }
-    
     result.success = true;
     return result;
 }
 
-std::string MaterialCompiler::GenerateFragmentGLSL(const MaterialGraph& graph) {
+// ============================================================================
+// Parameter buffer
+// ============================================================================
+
+MaterialParameterLayout MaterialParameterLayout::Build(const MaterialGraph& graph) {
+    MaterialParameterLayout layout;
+
+    // Only nodes feeding the active output end up in the shader
+    std::unordered_set<NodeID> reached;
+    std::vector<NodeID> stack;
+    if (graph.GetNode(graph.GetActiveOutputNodeId())) stack.push_back(graph.GetActiveOutputNodeId());
+    while (!stack.empty()) {
+        const NodeID id = stack.back();
+        stack.pop_back();
+        if (!reached.insert(id).second) continue;
+        const MaterialNode* node = graph.GetNode(id);
+        if (IsConstantNodeType(node->type)) {
+            layout.constants.push_back(id);
+        }
+        for (PinID pinId : node->inputPins) {
+            const MaterialPin* pin = graph.GetPin(pinId);
+            if (!pin) continue;
+            const LinkID linkId = graph.FindLinkByEndPin(pinId);
+            const MaterialLink* link = linkId != INVALID_LINK_ID ? graph.GetLink(linkId) : nullptr;
+            if (link) {
+                const NodeID source = graph.GetPinNodeId(link->startPinId);
+                if (graph.GetNode(source)) stack.push_back(source);
+            } else if (IsNumericPinType(pin->type)) {
+                layout.pinDefaults.push_back(pinId);
+            }
+        }
+    }
+    std::sort(layout.constants.begin(), layout.constants.end());
+    std::sort(layout.pinDefaults.begin(), layout.pinDefaults.end());
+    return layout;
+}
+
+int MaterialParameterLayout::FindSlot(NodeID nodeId) const {
+    auto it = std::lower_bound(constants.begin(), constants.end(), nodeId);
+    return it != constants.end() && *it == nodeId ? static_cast<int>(it - constants.begin()) : -1;
+}
+
+int MaterialParameterLayout::FindPinSlot(PinID pinId) const {
+    auto it = std::lower_bound(pinDefaults.begin(), pinDefaults.end(), pinId);
+    if (it == pinDefaults.end() || *it != pinId) return -1;
+    return static_cast<int>(constants.size() + (it - pinDefaults.begin()));
+}
+
+// A parameter as the generator used to emit its literal: a mismatched value reads as zero
+static glm::vec4 GetParameterValue(const PinValue& value, PinType type) {
+    switch (type) {
+        case PinType::Float:
+            if (auto* f = std::get_if<float>(&value)) return glm::vec4(*f, 0.0f, 0.0f, 0.0f);
+            break;
+        case PinType::Vec2:
+            if (auto* v = std::get_if<glm::vec2>(&value)) return glm::vec4(v->x, v->y, 0.0f, 0.0f);
+            break;
+        case PinType::Vec3:
+            if (auto* v = std::get_if<glm::vec3>(&value)) return glm::vec4(v->x, v->y, v->z, 0.0f);
+            break;
+        case PinType::Vec4:
+            if (auto* v = std::get_if<glm::vec4>(&value)) return *v;
+            break;
+        default:
+            break;
+    }
+    return glm::vec4(0.0f);
+}
+
+void MaterialParameterLayout::Pack(const MaterialGraph& graph, std::vector<glm::vec4>& outValues) const {
+    outValues.assign(GetSlotCount(), glm::vec4(0.0f));
+    for (size_t i = 0; i < constants.size(); ++i) {
+        const MaterialNode* node = graph.GetNode(constants[i]);
+        const MaterialPin* output = node && !node->outputPins.empty() ? graph.GetPin(node->outputPins[0]) : nullptr;
+        if (output) outValues[i] = GetParameterValue(node->parameter, output->type);
+    }
+    for (size_t i = 0; i < pinDefaults.size(); ++i) {
+        const MaterialPin* pin = graph.GetPin(pinDefaults[i]);
+        if (pin) outValues[constants.size() + i] = GetParameterValue(pin->defaultValue, pin->type);
+    }
+}
+
+std::string MaterialCompiler::GenerateParameterBlock(const MaterialParameterLayout& layout) {
+    if (layout.IsEmpty()) return "";
+    std::ostringstream ss;
+    ss << "// Constant node values and unconnected pin defaults (std140, one vec4 each); edited without recompiling\n";
+    ss << "layout(set = 0, binding = " << MaterialParameterLayout::kBinding << ") uniform MaterialParameters {\n";
+    ss << "    vec4 values[" << layout.GetSlotCount() << "];\n";
+    ss << "} params;\n\n";
+    return ss.str();
+}
+
+void MaterialCompiler::AddParameterNames(const MaterialGraph& graph, const MaterialParameterLayout& layout,
+                                         std::unordered_map<PinID, std::string>& pinVarNames) {
+    static const char* kSwizzle[] = { ".x", ".xy", ".xyz", "" };
+    auto name = [&](PinID pinId, size_t slot) {
+        const MaterialPin* pin = graph.GetPin(pinId);
+        if (!pin || !IsNumericPinType(pin->type)) return;
+        pinVarNames[pinId] = "params.values[" + std::to_string(slot) + "]" + kSwizzle[GetPinTypeComponents(pin->type) - 1];
+    };
+    for (size_t i = 0; i < layout.constants.size(); ++i) {
+        // The optimizer may have removed the node (merged or unreachable)
+        const MaterialNode* node = graph.GetNode(layout.constants[i]);
+        if (node && !node->outputPins.empty()) name(node->outputPins[0], i);
+    }
+    for (size_t i = 0; i < layout.pinDefaults.size(); ++i) {
+        name(layout.pinDefaults[i], layout.constants.size() + i);
+    }
+}
+
+std::string MaterialCompiler::GenerateFragmentGLSL(const MaterialGraph& graph, const MaterialParameterLayout& layout) {
     // Dispatch based on material domain
     if (graph.GetDomain() == MaterialDomain::Volume) {
-        return GenerateVolumeFragmentGLSL(graph);
+        return GenerateVolumeFragmentGLSL(graph, layout);
     }
-    return GenerateSurfaceFragmentGLSL(graph);
+    return GenerateSurfaceFragmentGLSL(graph, layout);
 }
 
-std::string MaterialCompiler::GenerateSurfaceFragmentGLSL(const MaterialGraph& graph) {
+std::string MaterialCompiler::GenerateSurfaceFragmentGLSL(const MaterialGraph& graph,
+                                                          const MaterialParameterLayout& layout) {
     std::ostringstream ss;
     
     // Header
@@ -230,6 +383,7 @@ std::string MaterialCompiler::GenerateSurfaceFragmentGLSL(const MaterialGraph& g
     } else if (hasTextureNodes) {
         ss << "layout(set = 0, binding = 0) uniform sampler2D textures[1];\n\n";
     }
+    ss << GenerateParameterBlock(layout);
 
     // Procedural helpers (inject only if needed)
     bool needsNoise = false;
@@ -451,8 +605,9 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     // Topological sort of nodes
     std::vector<NodeID> sortedNodes = TopologicalSort(graph);
     
-    // Map from pin ID to variable name
+    // Map from pin ID to variable name, starting with the parameter buffer reads
     std::unordered_map<PinID, std::string> pinVarNames;
+    AddParameterNames(graph, layout, pinVarNames);
     
     // Generate code for each node
     for (NodeID nodeId : sortedNodes) {
@@ -516,7 +671,8 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     return ss.str();
 }
 
-std::string MaterialCompiler::GenerateVolumeFragmentGLSL(const MaterialGraph& graph) {
+std::string MaterialCompiler::GenerateVolumeFragmentGLSL(const MaterialGraph& graph,
+                                                         const MaterialParameterLayout& layout) {
     std::ostringstream ss;
 
     // Surface-only feature: CustomCode is not supported in volume materials.
@@ -569,6 +725,7 @@ std::string MaterialCompiler::GenerateVolumeFragmentGLSL(const MaterialGraph& gr
     } else if (hasTextureNodes) {
         ss << "layout(set = 0, binding = 0) uniform sampler2D textures[1];\n\n";
     }
+    ss << GenerateParameterBlock(layout);
     
     // Noise helpers (inject if needed)
     bool needsNoise = false;
@@ -661,6 +818,7 @@ bool rayBoxIntersect(vec3 ro, vec3 rd, out float tNear, out float tFar) {
     // Topological sort nodes
     std::vector<NodeID> sortedNodes = TopologicalSort(graph);
     std::unordered_map<PinID, std::string> pinVarNames;
+    AddParameterNames(graph, layout, pinVarNames);
     
     // Generate code for non-output nodes
     for (NodeID nodeId : sortedNodes) {
@@ -757,7 +915,16 @@ bool rayBoxIntersect(vec3 ro, vec3 rd, out float tNear, out float tFar) {
     return ss.str();
 }
 
-bool MaterialCompiler::CompileGLSLToSPIRV(const std::string& glsl, std::vector<uint32_t>& spirv, std::string& errorMsg) {
+bool MaterialCompiler::CompileGLSLToSPIRV(uint64_t graphHash, const std::string& glsl, std::vector<uint32_t>& spirv,
+                                          std::string& errorMsg) {
+    LUCENT_PROFILE_FUNCTION();
+    ShaderCache& cache = ShaderCache::Get();
+    const uint64_t cacheKey = ShaderCache::MakeKey(graphHash, glsl, GetFragmentCompileOptionsKey());
+    if (cache.Load(cacheKey, spirv)) {
+        return true;
+    }
+    
+    const auto start = std::chrono::steady_clock::now();
     shaderc::Compiler compiler;
     shaderc::CompileOptions options;
     options.SetOptimizationLevel(shaderc_optimization_level_performance);
@@ -778,6 +945,7 @@ bool MaterialCompiler::CompileGLSLToSPIRV(const std::string& glsl, std::vector<u
     }
     
     spirv.assign(result.begin(), result.end());
+    cache.Store(cacheKey, spirv, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     return true;
 }
 
@@ -910,33 +1078,35 @@ std::string MaterialCompiler::GenerateNodeCode(const MaterialGraph& graph, const
             break;
         }
             
-        case NodeType::ConstFloat: {
-            float val = std::holds_alternative<float>(node.parameter) ? std::get<float>(node.parameter) : 0.0f;
-            pinVarNames[node.outputPins[0]] = std::to_string(val);
-            break;
-        }
-        
-        case NodeType::ConstVec2: {
-            glm::vec2 val = std::holds_alternative<glm::vec2>(node.parameter) ? std::get<glm::vec2>(node.parameter) : glm::vec2(0.0f);
-            std::ostringstream v;
-            v << "vec2(" << val.x << ", " << val.y << ")";
-            pinVarNames[node.outputPins[0]] = v.str();
-            break;
-        }
-        
-        case NodeType::ConstVec3: {
-            glm::vec3 val = std::holds_alternative<glm::vec3>(node.parameter) ? std::get<glm::vec3>(node.parameter) : glm::vec3(0.0f);
-            std::ostringstream v;
-            v << "vec3(" << val.x << ", " << val.y << ", " << val.z << ")";
-            pinVarNames[node.outputPins[0]] = v.str();
-            break;
-        }
-        
+        case NodeType::ConstFloat:
+        case NodeType::ConstVec2:
+        case NodeType::ConstVec3:
         case NodeType::ConstVec4: {
-            glm::vec4 val = std::holds_alternative<glm::vec4>(node.parameter) ? std::get<glm::vec4>(node.parameter) : glm::vec4(0.0f);
-            std::ostringstream v;
-            v << "vec4(" << val.x << ", " << val.y << ", " << val.z << ", " << val.w << ")";
-            pinVarNames[node.outputPins[0]] = v.str();
+            if (pinVarNames.count(node.outputPins[0])) {
+                // Read from the parameter buffer (AddParameterNames) so value edits reuse this shader
+                break;
+            }
+            
+            // Constants made by the optimizer are not parameters: emit them as literals
+            if (node.type == NodeType::ConstFloat) {
+                float val = std::holds_alternative<float>(node.parameter) ? std::get<float>(node.parameter) : 0.0f;
+                pinVarNames[node.outputPins[0]] = std::to_string(val);
+            } else if (node.type == NodeType::ConstVec2) {
+                glm::vec2 val = std::holds_alternative<glm::vec2>(node.parameter) ? std::get<glm::vec2>(node.parameter) : glm::vec2(0.0f);
+                std::ostringstream v;
+                v << "vec2(" << val.x << ", " << val.y << ")";
+                pinVarNames[node.outputPins[0]] = v.str();
+            } else if (node.type == NodeType::ConstVec3) {
+                glm::vec3 val = std::holds_alternative<glm::vec3>(node.parameter) ? std::get<glm::vec3>(node.parameter) : glm::vec3(0.0f);
+                std::ostringstream v;
+                v << "vec3(" << val.x << ", " << val.y << ", " << val.z << ")";
+                pinVarNames[node.outputPins[0]] = v.str();
+            } else {
+                glm::vec4 val = std::holds_alternative<glm::vec4>(node.parameter) ? std::get<glm::vec4>(node.parameter) : glm::vec4(0.0f);
+                std::ostringstream v;
+                v << "vec4(" << val.x << ", " << val.y << ", " << val.z << ", " << val.w << ")";
+                pinVarNames[node.outputPins[0]] = v.str();
+            }
             break;
         }
         
@@ -992,13 +1162,10 @@ std::string MaterialCompiler::GenerateNodeCode(const MaterialGraph& graph, const
         }
 
         case NodeType::Noise: {
-            // Parameter (optional) controls the *defaults* when pins are unconnected.
-            // Also supports a noise "type" selection via NOISE2 string.
+            // Parameter (optional) selects the noise type via a NOISE2 string
             int noiseType = 0; // 0=FBM, 1=Value, 2=Ridged, 3=Turbulence
             glm::vec4 p = glm::vec4(5.0f, 4.0f, 0.5f, 0.0f); // scale, detail, roughness, distortion
-            if (std::holds_alternative<glm::vec4>(node.parameter)) {
-                p = std::get<glm::vec4>(node.parameter);
-            } else if (std::holds_alternative<std::string>(node.parameter)) {
+            if (std::holds_alternative<std::string>(node.parameter)) {
                 (void)ParseNoise2Param(std::get<std::string>(node.parameter), noiseType, p);
             }
 
@@ -1012,18 +1179,12 @@ std::string MaterialCompiler::GenerateNodeCode(const MaterialGraph& graph, const
             std::string vecIn = isConnected(0)
                 ? GetPinValue(graph, node.inputPins[0], PinType::Vec3, pinVarNames)
                 : "vec3(inUV, 0.0)";
-            std::string scale = isConnected(1)
-                ? GetPinValue(graph, node.inputPins[1], PinType::Float, pinVarNames)
-                : std::to_string(p.x);
-            std::string detail = isConnected(2)
-                ? GetPinValue(graph, node.inputPins[2], PinType::Float, pinVarNames)
-                : std::to_string(p.y);
-            std::string rough = isConnected(3)
-                ? GetPinValue(graph, node.inputPins[3], PinType::Float, pinVarNames)
-                : std::to_string(p.z);
-            std::string distort = isConnected(4)
-                ? GetPinValue(graph, node.inputPins[4], PinType::Float, pinVarNames)
-                : std::to_string(p.w);
+            // Unconnected Scale/Detail/Roughness/Distortion read their pin defaults, which the
+            // editor keeps equal to the parameter values, from the parameter buffer
+            std::string scale = GetPinValue(graph, node.inputPins[1], PinType::Float, pinVarNames);
+            std::string detail = GetPinValue(graph, node.inputPins[2], PinType::Float, pinVarNames);
+            std::string rough = GetPinValue(graph, node.inputPins[3], PinType::Float, pinVarNames);
+            std::string distort = GetPinValue(graph, node.inputPins[4], PinType::Float, pinVarNames);
 
             std::string pVar = varPrefix + "p";
             std::string nVar = varPrefix + "n";
@@ -1528,7 +1689,12 @@ std::string MaterialCompiler::GetPinValue(const MaterialGraph& graph, PinID pinI
         }
     }
 
-    // Not connected: use this pin's default, converted to desired type if needed.
+    // Not connected: use this pin's default, converted to desired type if needed. Defaults in the
+    // parameter layout are read from the buffer; pins the optimizer created keep literals.
+    auto it = pinVarNames.find(pinId);
+    if (it != pinVarNames.end()) {
+        return ConvertType(it->second, pin->type, desiredType);
+    }
     return ConvertType(GetDefaultValue(pin->type, pin->defaultValue), pin->type, desiredType);
 }
 
@@ -1,6 +1,8 @@
 #include "lucent/material/MaterialGraph.h"
 #include "lucent/core/Log.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <cctype>
 
@@ -899,61 +901,98 @@ void MaterialGraph::SetTextureSlot(int index, const std::string& path, bool sRGB
     }
 }
 
-uint64_t MaterialGraph::ComputeHash() const {
-    // Simple FNV-1a hash
+namespace {
+
+// FNV-1a over 64-bit words
+struct GraphHasher {
     uint64_t hash = 14695981039346656037ULL;
-    
-    auto hashCombine = [&hash](uint64_t value) {
+
+    void Combine(uint64_t value) {
         hash ^= value;
         hash *= 1099511628211ULL;
-    };
+    }
+
+    void Combine(float value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Combine(static_cast<uint64_t>(bits));
+    }
+
+    void Combine(const std::string& s) {
+        Combine(static_cast<uint64_t>(s.size()));
+        for (char c : s) {
+            Combine(static_cast<uint64_t>(static_cast<unsigned char>(c)));
+        }
+    }
+
+    void Combine(const PinValue& value) {
+        Combine(static_cast<uint64_t>(value.index()));
+        if (auto* f = std::get_if<float>(&value)) {
+            Combine(*f);
+        } else if (auto* v2 = std::get_if<glm::vec2>(&value)) {
+            Combine(v2->x); Combine(v2->y);
+        } else if (auto* v3 = std::get_if<glm::vec3>(&value)) {
+            Combine(v3->x); Combine(v3->y); Combine(v3->z);
+        } else if (auto* v4 = std::get_if<glm::vec4>(&value)) {
+            Combine(v4->x); Combine(v4->y); Combine(v4->z); Combine(v4->w);
+        } else if (auto* str = std::get_if<std::string>(&value)) {
+            Combine(*str);
+        }
+    }
+};
+
+template <typename Map>
+std::vector<uint64_t> SortedKeys(const Map& map) {
+    std::vector<uint64_t> keys;
+    keys.reserve(map.size());
+    for (const auto& [id, _] : map) {
+        keys.push_back(id);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+uint64_t MaterialGraph::ComputeHash() const {
+    GraphHasher hasher;
+    hasher.Combine(ComputeStructureHash());
+    hasher.Combine(ComputeParameterHash());
+    return hasher.hash;
+}
+
+uint64_t MaterialGraph::ComputeStructureHash() const {
+    GraphHasher hasher;
+    hasher.Combine(static_cast<uint64_t>(m_Domain));
     
-    // Hash nodes (deterministic order)
-    std::vector<NodeID> nodeIds;
-    nodeIds.reserve(m_Nodes.size());
-    for (const auto& [id, _] : m_Nodes) {
-        nodeIds.push_back(id);
-    }
-    std::sort(nodeIds.begin(), nodeIds.end());
-    
-    for (NodeID id : nodeIds) {
-        const auto it = m_Nodes.find(id);
-        if (it == m_Nodes.end()) continue;
-        const auto& node = it->second;
-        
-        hashCombine(id);
-        hashCombine(static_cast<uint64_t>(node.type));
-        
-        // Hash parameter based on type
-        union { float f; uint32_t u; } conv;
-        if (std::holds_alternative<float>(node.parameter)) {
-            conv.f = std::get<float>(node.parameter);
-            hashCombine(conv.u);
-        } else if (std::holds_alternative<glm::vec2>(node.parameter)) {
-            const auto& v = std::get<glm::vec2>(node.parameter);
-            conv.f = v.x; hashCombine(conv.u);
-            conv.f = v.y; hashCombine(conv.u);
-        } else if (std::holds_alternative<glm::vec3>(node.parameter)) {
-            const auto& v = std::get<glm::vec3>(node.parameter);
-            conv.f = v.x; hashCombine(conv.u);
-            conv.f = v.y; hashCombine(conv.u);
-            conv.f = v.z; hashCombine(conv.u);
-        } else if (std::holds_alternative<glm::vec4>(node.parameter)) {
-            const auto& v = std::get<glm::vec4>(node.parameter);
-            conv.f = v.x; hashCombine(conv.u);
-            conv.f = v.y; hashCombine(conv.u);
-            conv.f = v.z; hashCombine(conv.u);
-            conv.f = v.w; hashCombine(conv.u);
-        } else if (std::holds_alternative<std::string>(node.parameter)) {
-            const auto& s = std::get<std::string>(node.parameter);
-            hashCombine(static_cast<uint64_t>(s.size()));
-            for (char c : s) {
-                hashCombine(static_cast<uint64_t>(static_cast<unsigned char>(c)));
-            }
+    // Nodes (deterministic order). Constant nodes contribute their ID and type (which decide the
+    // parameter buffer layout) but not their value; noise nodes only their noise type, since
+    // their values are read through the pin defaults.
+    for (NodeID id : SortedKeys(m_Nodes)) {
+        const MaterialNode& node = m_Nodes.at(id);
+        hasher.Combine(id);
+        hasher.Combine(static_cast<uint64_t>(node.type));
+        if (node.type == NodeType::Noise) {
+            int noiseType = 0;
+            glm::vec4 values(0.0f);
+            if (auto* s = std::get_if<std::string>(&node.parameter)) (void)ParseNoise2Param(*s, noiseType, values);
+            hasher.Combine(static_cast<uint64_t>(noiseType));
+        } else if (!IsConstantNodeType(node.type)) {
+            hasher.Combine(node.parameter);
+        }
+    }
+    
+    // Pins: numeric defaults are parameters, so only their ID and type (the buffer layout) count
+    for (PinID id : SortedKeys(m_Pins)) {
+        const MaterialPin& pin = m_Pins.at(id);
+        hasher.Combine(id);
+        hasher.Combine(static_cast<uint64_t>(pin.type));
+        if (!IsNumericPinType(pin.type)) {
+            hasher.Combine(pin.defaultValue);
         }
     }
     
-    // Hash links (deterministic order)
+    // Links (deterministic order)
     std::vector<std::pair<PinID, PinID>> linkPairs;
     linkPairs.reserve(m_Links.size());
     for (const auto& [_, link] : m_Links) {
@@ -961,19 +1000,46 @@ uint64_t MaterialGraph::ComputeHash() const {
     }
     std::sort(linkPairs.begin(), linkPairs.end());
     for (const auto& [startPin, endPin] : linkPairs) {
-        hashCombine(startPin);
-        hashCombine(endPin);
+        hasher.Combine(startPin);
+        hasher.Combine(endPin);
     }
     
-    // Hash texture slots
+    // Texture slots
     for (const auto& slot : m_TextureSlots) {
-        for (char c : slot.path) {
-            hashCombine(static_cast<uint64_t>(static_cast<unsigned char>(c)));
-        }
-        hashCombine(slot.sRGB ? 1 : 0);
+        hasher.Combine(slot.path);
+        hasher.Combine(static_cast<uint64_t>(slot.sRGB ? 1 : 0));
     }
     
-    return hash;
+    return hasher.hash;
+}
+
+uint64_t MaterialGraph::ComputeParameterHash() const {
+    GraphHasher hasher;
+    for (NodeID id : SortedKeys(m_Nodes)) {
+        const MaterialNode& node = m_Nodes.at(id);
+        if (!IsConstantNodeType(node.type) && node.type != NodeType::Noise) continue;
+        hasher.Combine(id);
+        hasher.Combine(node.parameter);
+    }
+    for (PinID id : SortedKeys(m_Pins)) {
+        const MaterialPin& pin = m_Pins.at(id);
+        if (!IsNumericPinType(pin.type)) continue;
+        hasher.Combine(id);
+        hasher.Combine(pin.defaultValue);
+    }
+    return hasher.hash;
+}
+
+bool ParseNoise2Param(const std::string& s, int& outType, glm::vec4& outParams) {
+    if (s.rfind("NOISE2:", 0) != 0) return false;
+    int t = 0;
+    float x = 5.0f, y = 4.0f, z = 0.5f, w = 0.0f;
+    if (sscanf_s(s.c_str(), "NOISE2:%d;%f,%f,%f,%f", &t, &x, &y, &z, &w) == 5) {
+        outType = t;
+        outParams = glm::vec4(x, y, z, w);
+        return true;
+    }
+    return false;
 }
 
 } // namespace lucent::material
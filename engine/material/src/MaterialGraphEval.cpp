@@ -1,12 +1,13 @@
 #include "lucent/material/MaterialGraphEval.h"
+#include "lucent/material/CustomCode.h"
 #include "lucent/core/Log.h"
 
 #include <variant>
 #include <unordered_map>
-#include <sstream>
-#include <cctype>
 #include <cmath>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace lucent::material {
 
@@ -84,247 +85,6 @@ static glm::vec3 AsVec3(const Value& v, glm::vec3 fallback = glm::vec3(0.0f)) {
     return fallback;
 }
 
-static bool IsIdentChar(char c) {
-    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
-}
-
-// -----------------------
-// Tiny expression parser (for CustomCode Out = <expr>;)
-// Supports: literals (float), vec2/vec3/vec4 constructors, + - * /, parentheses,
-// identifiers (variables), functions: sin, cos, abs, min, max, clamp, mix, pow, sqrt.
-// -----------------------
-enum class TokKind { End, Ident, Number, LParen, RParen, Comma, Op };
-struct Token { TokKind kind; std::string text; };
-
-struct Lexer {
-    const std::string& s;
-    size_t i = 0;
-    explicit Lexer(const std::string& in) : s(in) {}
-
-    void SkipWs() {
-        while (i < s.size() && std::isspace((unsigned char)s[i])) ++i;
-    }
-
-    Token Next() {
-        SkipWs();
-        if (i >= s.size()) return { TokKind::End, "" };
-        char c = s[i];
-        if (c == '(') { ++i; return { TokKind::LParen, "(" }; }
-        if (c == ')') { ++i; return { TokKind::RParen, ")" }; }
-        if (c == ',') { ++i; return { TokKind::Comma, "," }; }
-        if (c == '+' || c == '-' || c == '*' || c == '/') { ++i; return { TokKind::Op, std::string(1, c) }; }
-        if (std::isdigit((unsigned char)c) || c == '.') {
-            size_t start = i;
-            ++i;
-            while (i < s.size() && (std::isdigit((unsigned char)s[i]) || s[i] == '.' || s[i] == 'f')) ++i;
-            return { TokKind::Number, s.substr(start, i - start) };
-        }
-        if (std::isalpha((unsigned char)c) || c == '_') {
-            size_t start = i;
-            ++i;
-            while (i < s.size() && IsIdentChar(s[i])) ++i;
-            return { TokKind::Ident, s.substr(start, i - start) };
-        }
-        // Unknown: skip
-        ++i;
-        return Next();
-    }
-};
-
-struct Parser {
-    Lexer lex;
-    Token cur;
-    const std::unordered_map<std::string, Value>& vars;
-    std::string* err = nullptr;
-
-    Parser(const std::string& expr, const std::unordered_map<std::string, Value>& v, std::string* e)
-        : lex(expr), vars(v), err(e) { cur = lex.Next(); }
-
-    void Fail(const std::string& m) {
-        if (err && err->empty()) *err = m;
-    }
-
-    bool Eat(TokKind k) {
-        if (cur.kind == k) { cur = lex.Next(); return true; }
-        return false;
-    }
-
-    Value ParseExpr() { return ParseAddSub(); }
-
-    Value ParseAddSub() {
-        Value v = ParseMulDiv();
-        while (cur.kind == TokKind::Op && (cur.text == "+" || cur.text == "-")) {
-            char op = cur.text[0];
-            cur = lex.Next();
-            Value rhs = ParseMulDiv();
-            v = BinaryOp(v, rhs, op);
-        }
-        return v;
-    }
-
-    Value ParseMulDiv() {
-        Value v = ParseUnary();
-        while (cur.kind == TokKind::Op && (cur.text == "*" || cur.text == "/")) {
-            char op = cur.text[0];
-            cur = lex.Next();
-            Value rhs = ParseUnary();
-            v = BinaryOp(v, rhs, op);
-        }
-        return v;
-    }
-
-    Value ParseUnary() {
-        if (cur.kind == TokKind::Op && cur.text == "-") {
-            cur = lex.Next();
-            Value v = ParseUnary();
-            return BinaryOp(Value(0.0f), v, '-');
-        }
-        return ParsePrimary();
-    }
-
-    Value ParseCallOrIdent(const std::string& name) {
-        if (!Eat(TokKind::LParen)) {
-            auto it = vars.find(name);
-            if (it != vars.end()) return it->second;
-            Fail("Unknown identifier: " + name);
-            return Value(0.0f);
-        }
-
-        std::vector<Value> args;
-        if (cur.kind != TokKind::RParen && cur.kind != TokKind::End) {
-            args.push_back(ParseExpr());
-            while (Eat(TokKind::Comma)) {
-                args.push_back(ParseExpr());
-            }
-        }
-        if (!Eat(TokKind::RParen)) Fail("Expected ')'");
-
-        auto fn1 = [&](auto f) -> Value {
-            if (args.size() < 1) return Value(0.0f);
-            const int n = Components(args[0]);
-            glm::vec4 a = ToVec4(Convert(args[0], n));
-            glm::vec4 r(0.0f);
-            r.x = f(a.x); r.y = f(a.y); r.z = f(a.z); r.w = f(a.w);
-            return FromVecN(r, n);
-        };
-
-        if (name == "vec2" && args.size() >= 1) {
-            float x = AsFloat(args[0]);
-            float y = (args.size() >= 2) ? AsFloat(args[1]) : x;
-            return glm::vec2(x, y);
-        }
-        if (name == "vec3" && args.size() >= 1) {
-            float x = AsFloat(args[0]);
-            float y = (args.size() >= 2) ? AsFloat(args[1]) : x;
-            float z = (args.size() >= 3) ? AsFloat(args[2]) : x;
-            return glm::vec3(x, y, z);
-        }
-        if (name == "vec4" && args.size() >= 1) {
-            float x = AsFloat(args[0]);
-            float y = (args.size() >= 2) ? AsFloat(args[1]) : x;
-            float z = (args.size() >= 3) ? AsFloat(args[2]) : x;
-            float w = (args.size() >= 4) ? AsFloat(args[3]) : 1.0f;
-            return glm::vec4(x, y, z, w);
-        }
-
-        if (name == "sin") return fn1([](float x) { return std::sin(x); });
-        if (name == "cos") return fn1([](float x) { return std::cos(x); });
-        if (name == "abs") return fn1([](float x) { return std::fabs(x); });
-        if (name == "sqrt") return fn1([](float x) { return std::sqrt(std::max(x, 0.0f)); });
-
-        if ((name == "min" || name == "max") && args.size() >= 2) {
-            const int n = std::max(Components(args[0]), Components(args[1]));
-            glm::vec4 a = ToVec4(Convert(args[0], n));
-            glm::vec4 b = ToVec4(Convert(args[1], n));
-            glm::vec4 r(0.0f);
-            if (name == "min") r = glm::min(a, b);
-            else r = glm::max(a, b);
-            return FromVecN(r, n);
-        }
-
-        if (name == "clamp" && args.size() >= 3) {
-            const int n = std::max({ Components(args[0]), Components(args[1]), Components(args[2]) });
-            glm::vec4 x = ToVec4(Convert(args[0], n));
-            glm::vec4 lo = ToVec4(Convert(args[1], n));
-            glm::vec4 hi = ToVec4(Convert(args[2], n));
-            glm::vec4 r = glm::min(glm::max(x, lo), hi);
-            return FromVecN(r, n);
-        }
-
-        if ((name == "mix" || name == "lerp") && args.size() >= 3) {
-            const int n = std::max(Components(args[0]), Components(args[1]));
-            glm::vec4 a = ToVec4(Convert(args[0], n));
-            glm::vec4 b = ToVec4(Convert(args[1], n));
-            float t = AsFloat(args[2]);
-            glm::vec4 r = (1.0f - t) * a + t * b;
-            return FromVecN(r, n);
-        }
-
-        if (name == "pow" && args.size() >= 2) {
-            const int n = std::max(Components(args[0]), Components(args[1]));
-            glm::vec4 a = ToVec4(Convert(args[0], n));
-            glm::vec4 b = ToVec4(Convert(args[1], n));
-            glm::vec4 r(0.0f);
-            r.x = std::pow(a.x, b.x);
-            r.y = std::pow(a.y, b.y);
-            r.z = std::pow(a.z, b.z);
-            r.w = std::pow(a.w, b.w);
-            return FromVecN(r, n);
-        }
-
-        Fail("Unsupported function: " + name);
-        return Value(0.0f);
-    }
-
-    Value ParsePrimary() {
-        if (cur.kind == TokKind::Number) {
-            float f = 0.0f;
-            try { f = std::stof(cur.text); } catch (...) { f = 0.0f; }
-            cur = lex.Next();
-            return f;
-        }
-        if (cur.kind == TokKind::Ident) {
-            std::string name = cur.text;
-            cur = lex.Next();
-            return ParseCallOrIdent(name);
-        }
-        if (Eat(TokKind::LParen)) {
-            Value v = ParseExpr();
-            if (!Eat(TokKind::RParen)) Fail("Expected ')'");
-            return v;
-        }
-        Fail("Unexpected token");
-        cur = lex.Next();
-        return Value(0.0f);
-    }
-};
-
-static bool ExtractAssignmentExpr(const std::string& code, const std::string& lhs, std::string& outExpr) {
-    // Find a line like: "<lhs> = <expr>;" (very simple scan).
-    std::istringstream ss(code);
-    std::string line;
-    while (std::getline(ss, line)) {
-        // strip comments
-        size_t cpos = line.find("//");
-        if (cpos != std::string::npos) line = line.substr(0, cpos);
-        // trim
-        auto trim = [](std::string s) {
-            size_t a = 0; while (a < s.size() && std::isspace((unsigned char)s[a])) ++a;
-            size_t b = s.size(); while (b > a && std::isspace((unsigned char)s[b - 1])) --b;
-            return s.substr(a, b - a);
-        };
-        std::string t = trim(line);
-        if (t.rfind(lhs, 0) != 0) continue;
-        t = trim(t.substr(lhs.size()));
-        if (t.empty() || t[0] != '=') continue;
-        t = trim(t.substr(1));
-        if (!t.empty() && t.back() == ';') t.pop_back();
-        t = trim(t);
-        if (!t.empty()) { outExpr = t; return true; }
-    }
-    return false;
-}
-
 struct EvalCtx {
     const MaterialGraph& g;
     std::unordered_map<PinID, Value> cache;
@@ -515,35 +275,33 @@ static Value EvalNodeOutput(EvalCtx& ctx, const MaterialNode& node, PinID outPin
         case NodeType::Time: return 0.0f;
 
         case NodeType::CustomCode: {
-            // Evaluate only a simple assignment to Out (or other output name), as an expression.
-            std::string code = std::holds_alternative<std::string>(node.parameter) ? std::get<std::string>(node.parameter) : std::string();
-
-            // Build variables from input pins by name.
-            std::unordered_map<std::string, Value> vars;
-            vars.reserve(node.inputPins.size() + 4);
-            for (PinID pid : node.inputPins) {
-                const MaterialPin* p = ctx.g.GetPin(pid);
-                if (!p) continue;
-                vars[p->name] = EvalInputPin(ctx, pid);
+            // Compiled once per source text (CustomCode.h); every output is evaluated together
+            const std::shared_ptr<const CompiledCustomCode> code = GetCompiledCustomCode(ctx.g, node);
+            const MaterialPin* outPin = ctx.g.GetPin(outPinId);
+            const PinType outType = outPin ? outPin->type : PinType::Float;
+            if (!code->IsValid()) {
+                if (ctx.err && ctx.err->empty()) *ctx.err = code->error;
+                return DefaultForPinType(outType);
             }
-            // Defaults
-            if (vars.find("In") == vars.end()) vars["In"] = glm::vec3(0.0f);
 
-            // Determine which output we need (pin name).
-            std::string outName = "Out";
-            if (const MaterialPin* op = ctx.g.GetPin(outPinId)) outName = op->name;
-
-            std::string expr;
-            if (!ExtractAssignmentExpr(code, outName, expr)) {
-                // Fallback: if no explicit assignment, passthrough Out=In.
-                return vars["In"];
+            std::vector<glm::vec4> inputs(node.inputPins.size(), glm::vec4(0.0f));
+            for (size_t i = 0; i < node.inputPins.size(); ++i) {
+                const MaterialPin* p = ctx.g.GetPin(node.inputPins[i]);
+                if (!p) continue;
+                inputs[i] = ToVec4(Convert(EvalInputPin(ctx, node.inputPins[i]), GetPinTypeComponents(p->type)));
             }
+            std::vector<glm::vec4> outputs(code->outputs.size(), glm::vec4(0.0f));
+            EvaluateCustomCode(*code, inputs.data(), outputs.data());
 
-            std::string parseErr;
-            Parser p(expr, vars, &parseErr);
-            Value r = p.ParseExpr();
-            if (!parseErr.empty() && ctx.err && ctx.err->empty()) *ctx.err = "CustomCode parse error: " + parseErr;
-            return r;
+            Value result = DefaultForPinType(outType);
+            for (size_t i = 0; i < node.outputPins.size() && i < outputs.size(); ++i) {
+                const MaterialPin* p = ctx.g.GetPin(node.outputPins[i]);
+                if (!p) continue;
+                const Value value = FromVecN(outputs[i], GetPinTypeComponents(p->type));
+                ctx.cache[node.outputPins[i]] = value;
+                if (node.outputPins[i] == outPinId) result = value;
+            }
+            return result;
         }
 
         default:
@@ -1,5 +1,6 @@
 #include "lucent/material/MaterialIR.h"
 #include "lucent/material/MaterialGraph.h"
+#include "lucent/material/MaterialOptimizer.h"
 #include "lucent/core/Log.h"
 #include <unordered_map>
 
@@ -68,7 +69,9 @@ MaterialIR::GPUMaterialData MaterialIR::EvaluateConstant() const {
     return data;
 }
 
-bool MaterialIRCompiler::Compile(const MaterialGraph& graph, MaterialIR& outIR, std::string& errorMsg) {
+bool MaterialIRCompiler::Compile(const MaterialGraph& sourceGraph, MaterialIR& outIR, std::string& errorMsg) {
+    // Folded, deduplicated and with dead nodes gone, so only what reaches the output becomes IR
+    const MaterialGraph graph = OptimizeMaterialGraph(sourceGraph);
     outIR = MaterialIR{};
     outIR.name = graph.GetName();
     
@@ -0,0 +1,557 @@
+#include "lucent/material/MaterialOptimizer.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace lucent::material {
+
+namespace {
+
+// ============================================================================
+// Values
+// ============================================================================
+// Constants are held as vec4 with the components past the pin type zeroed, so equal constants
+// compare (and hash) equal.
+
+glm::vec4 Truncate(glm::vec4 v, PinType type) {
+    for (int i = GetPinTypeComponents(type); i < 4; ++i) v[i] = 0.0f;
+    return v;
+}
+
+// Same conversions as MaterialCompiler::ConvertType
+glm::vec4 ConvertValue(const glm::vec4& v, PinType from, PinType to) {
+    if (from == to) return v;
+    const int fromN = GetPinTypeComponents(from);
+    const int toN = GetPinTypeComponents(to);
+    if (fromN == 1) return Truncate(glm::vec4(v.x, v.x, v.x, v.x), to);
+    if (toN == 1 || toN == 2) return Truncate(v, to);
+    if (fromN == 2 && toN == 4) return glm::vec4(v.x, v.y, 0.0f, 1.0f);
+    if (fromN == 3 && toN == 4) return glm::vec4(v.x, v.y, v.z, 1.0f);
+    return Truncate(v, to); // vec2 -> vec3 (z = 0), vec4 -> vec3
+}
+
+// A stored value read as `type`; like MaterialCompiler::GetDefaultValue, a value of another type
+// reads as zero
+glm::vec4 ReadPinValue(const PinValue& value, PinType type) {
+    switch (type) {
+        case PinType::Float:
+            if (auto* f = std::get_if<float>(&value)) return glm::vec4(*f, 0.0f, 0.0f, 0.0f);
+            break;
+        case PinType::Vec2:
+            if (auto* v = std::get_if<glm::vec2>(&value)) return glm::vec4(v->x, v->y, 0.0f, 0.0f);
+            break;
+        case PinType::Vec3:
+            if (auto* v = std::get_if<glm::vec3>(&value)) return glm::vec4(v->x, v->y, v->z, 0.0f);
+            break;
+        case PinType::Vec4:
+            if (auto* v = std::get_if<glm::vec4>(&value)) return *v;
+            break;
+        case PinType::Sampler2D:
+            break;
+    }
+    return glm::vec4(0.0f);
+}
+
+PinValue MakePinValue(const glm::vec4& v, PinType type) {
+    switch (type) {
+        case PinType::Vec2: return glm::vec2(v.x, v.y);
+        case PinType::Vec3: return glm::vec3(v.x, v.y, v.z);
+        case PinType::Vec4: return v;
+        default: return v.x;
+    }
+}
+
+NodeType GetConstantNodeType(PinType type) {
+    switch (type) {
+        case PinType::Vec2: return NodeType::ConstVec2;
+        case PinType::Vec3: return NodeType::ConstVec3;
+        case PinType::Vec4: return NodeType::ConstVec4;
+        default: return NodeType::ConstFloat;
+    }
+}
+
+PinType GetConstantPinType(NodeType type) {
+    switch (type) {
+        case NodeType::ConstVec2: return PinType::Vec2;
+        case NodeType::ConstVec3: return PinType::Vec3;
+        case NodeType::ConstVec4: return PinType::Vec4;
+        default: return PinType::Float;
+    }
+}
+
+bool IsFinite(const glm::vec4& v, PinType type) {
+    for (int i = 0; i < GetPinTypeComponents(type); ++i) {
+        if (!std::isfinite(v[i])) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Constant evaluation
+// ============================================================================
+// Mirrors the GLSL MaterialCompiler emits for each node, including its guards (divide and mod
+// by max(b, 0.0001), sqrt(max(x, 0)), log(max(x, 1e-6))). Returns false where the GLSL result is
+// undefined (pow of a negative base, smoothstep with edge0 >= edge1, normalizing zero) so those
+// stay for the GPU to decide. `in` holds the inputs converted to their pin types.
+
+glm::vec4 Map(const glm::vec4& a, float (*fn)(float)) {
+    return glm::vec4(fn(a.x), fn(a.y), fn(a.z), fn(a.w));
+}
+
+glm::vec4 Map2(const glm::vec4& a, const glm::vec4& b, float (*fn)(float, float)) {
+    return glm::vec4(fn(a.x, b.x), fn(a.y, b.y), fn(a.z, b.z), fn(a.w, b.w));
+}
+
+float Dot3(const glm::vec4& a, const glm::vec4& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+bool Normalize3(const glm::vec4& v, glm::vec4& out) {
+    const float length = std::sqrt(Dot3(v, v));
+    if (!(length > 0.0f)) return false;
+    out = glm::vec4(v.x / length, v.y / length, v.z / length, 0.0f);
+    return true;
+}
+
+bool EvaluateNode(NodeType type, const glm::vec4* in, glm::vec4* out) {
+    switch (type) {
+        case NodeType::Add: out[0] = in[0] + in[1]; return true;
+        case NodeType::Subtract: out[0] = in[0] - in[1]; return true;
+        case NodeType::Multiply: out[0] = in[0] * in[1]; return true;
+        case NodeType::Divide:
+            out[0] = in[0] / Map(in[1], [](float b) { return std::max(b, 0.0001f); });
+            return true;
+        case NodeType::Lerp: out[0] = in[0] * (1.0f - in[2].x) + in[1] * in[2].x; return true;
+        case NodeType::Remap: {
+            const float range = std::max(in[2].x - in[1].x, 0.0001f);
+            const float t = std::clamp((in[0].x - in[1].x) / range, 0.0f, 1.0f);
+            out[0].x = in[3].x * (1.0f - t) + in[4].x * t;
+            return true;
+        }
+        case NodeType::Step: out[0].x = in[1].x < in[0].x ? 0.0f : 1.0f; return true;
+        case NodeType::Smoothstep: {
+            if (!(in[0].x < in[1].x)) return false;
+            const float t = std::clamp((in[2].x - in[0].x) / (in[1].x - in[0].x), 0.0f, 1.0f);
+            out[0].x = t * t * (3.0f - 2.0f * t);
+            return true;
+        }
+        case NodeType::Sin: out[0].x = std::sin(in[0].x); return true;
+        case NodeType::Cos: out[0].x = std::cos(in[0].x); return true;
+        case NodeType::Clamp: out[0].x = std::min(std::max(in[0].x, in[1].x), in[2].x); return true;
+        case NodeType::OneMinus: out[0].x = 1.0f - in[0].x; return true;
+        case NodeType::Abs: out[0].x = std::fabs(in[0].x); return true;
+        case NodeType::Power:
+            if (in[0].x < 0.0f || (in[0].x == 0.0f && in[1].x <= 0.0f)) return false;
+            out[0].x = std::pow(in[0].x, in[1].x);
+            return true;
+        case NodeType::Min: out[0] = Map2(in[0], in[1], [](float a, float b) { return std::min(a, b); }); return true;
+        case NodeType::Max: out[0] = Map2(in[0], in[1], [](float a, float b) { return std::max(a, b); }); return true;
+        case NodeType::Saturate:
+            out[0] = Map(in[0], [](float x) { return std::clamp(x, 0.0f, 1.0f); });
+            return true;
+        case NodeType::Sqrt: out[0].x = std::sqrt(std::max(in[0].x, 0.0f)); return true;
+        case NodeType::Floor: out[0].x = std::floor(in[0].x); return true;
+        case NodeType::Ceil: out[0].x = std::ceil(in[0].x); return true;
+        case NodeType::Fract: out[0].x = in[0].x - std::floor(in[0].x); return true;
+        case NodeType::Mod: {
+            const float b = std::max(in[1].x, 0.0001f);
+            out[0].x = in[0].x - b * std::floor(in[0].x / b);
+            return true;
+        }
+        case NodeType::Exp: out[0].x = std::exp(in[0].x); return true;
+        case NodeType::Log: out[0].x = std::log(std::max(in[0].x, 0.000001f)); return true;
+        case NodeType::Negate: out[0].x = -in[0].x; return true;
+        case NodeType::Dot: out[0].x = Dot3(in[0], in[1]); return true;
+        case NodeType::Length: out[0].x = std::sqrt(Dot3(in[0], in[0])); return true;
+        case NodeType::Normalize: return Normalize3(in[0], out[0]);
+        case NodeType::Cross:
+            out[0] = glm::vec4(in[0].y * in[1].z - in[0].z * in[1].y,
+                               in[0].z * in[1].x - in[0].x * in[1].z,
+                               in[0].x * in[1].y - in[0].y * in[1].x, 0.0f);
+            return true;
+        case NodeType::Reflect: {
+            glm::vec4 n;
+            if (!Normalize3(in[1], n)) return false;
+            out[0] = in[0] - n * (2.0f * Dot3(n, in[0]));
+            return true;
+        }
+        case NodeType::Refract: {
+            glm::vec4 n;
+            if (!Normalize3(in[1], n)) return false;
+            const float eta = in[2].x;
+            const float d = Dot3(n, in[0]);
+            const float k = 1.0f - eta * eta * (1.0f - d * d);
+            out[0] = k < 0.0f ? glm::vec4(0.0f) : in[0] * eta - n * (eta * d + std::sqrt(k));
+            return true;
+        }
+        case NodeType::SeparateVec2:
+        case NodeType::SeparateVec3:
+        case NodeType::SeparateVec4:
+            for (int i = 0; i < 4; ++i) out[i].x = in[0][i];
+            return true;
+        case NodeType::CombineVec2: out[0] = glm::vec4(in[0].x, in[1].x, 0.0f, 0.0f); return true;
+        case NodeType::CombineVec3: out[0] = glm::vec4(in[0].x, in[1].x, in[2].x, 0.0f); return true;
+        case NodeType::CombineVec4: out[0] = glm::vec4(in[0].x, in[1].x, in[2].x, in[3].x); return true;
+        case NodeType::Reroute: out[0] = in[0]; return true;
+        case NodeType::FloatToVec3: out[0] = glm::vec4(in[0].x, in[0].x, in[0].x, 0.0f); return true;
+        case NodeType::Vec3ToFloat: out[0].x = in[0].x; return true;
+        case NodeType::Vec2ToVec3: out[0] = glm::vec4(in[0].x, in[0].y, in[1].x, 0.0f); return true;
+        case NodeType::Vec3ToVec4: out[0] = glm::vec4(in[0].x, in[0].y, in[0].z, in[1].x); return true;
+        case NodeType::Vec4ToVec3: out[0] = glm::vec4(in[0].x, in[0].y, in[0].z, 0.0f); return true;
+        default:
+            // Inputs, textures, noise, ramps, Fresnel, CustomCode and outputs are left to the backends
+            return false;
+    }
+}
+
+// ============================================================================
+// Graph helpers
+// ============================================================================
+
+struct OptimizeContext {
+    MaterialGraph& graph;
+    MaterialOptimizeStats& stats;
+    const MaterialOptimizeOptions& options;
+    // Constant node output per (type, value), so folded and user constants are shared
+    std::unordered_map<std::string, PinID> constants;
+    // First node seen per signature (type, parameter, inputs)
+    std::unordered_map<std::string, NodeID> signatures;
+    // Constant nodes made by folding; never parameters
+    std::unordered_set<NodeID> createdConstants;
+};
+
+template <typename T>
+void AppendBytes(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string MakeConstantKey(PinType type, const glm::vec4& value) {
+    std::string key;
+    AppendBytes(key, type);
+    for (int i = 0; i < GetPinTypeComponents(type); ++i) {
+        AppendBytes(key, value[i] == 0.0f ? 0.0f : value[i]); // -0 and 0 print alike
+    }
+    return key;
+}
+
+PinID GetSourcePin(const MaterialGraph& graph, PinID inputPin) {
+    const LinkID linkId = graph.FindLinkByEndPin(inputPin);
+    const MaterialLink* link = linkId != INVALID_LINK_ID ? graph.GetLink(linkId) : nullptr;
+    return link ? link->startPinId : INVALID_PIN_ID;
+}
+
+const MaterialNode* GetSourceNode(const MaterialGraph& graph, PinID inputPin) {
+    const PinID source = GetSourcePin(graph, inputPin);
+    return source != INVALID_PIN_ID ? graph.GetNode(graph.GetPinNodeId(source)) : nullptr;
+}
+
+// Value of an input that is unconnected or fed by a constant node, converted to the input's type.
+// When constants are parameters only the constants this pass created count: user constants and
+// unconnected pin defaults are read at run time.
+bool GetConstantInput(const OptimizeContext& ctx, PinID inputPin, glm::vec4& out) {
+    const MaterialGraph& graph = ctx.graph;
+    const MaterialPin* pin = graph.GetPin(inputPin);
+    if (!pin) return false;
+    const PinID source = GetSourcePin(graph, inputPin);
+    if (source == INVALID_PIN_ID) {
+        if (ctx.options.constantsAreParameters) return false;
+        out = Truncate(ReadPinValue(pin->defaultValue, pin->type), pin->type);
+        return true;
+    }
+    const MaterialPin* sourcePin = graph.GetPin(source);
+    const MaterialNode* sourceNode = sourcePin ? graph.GetNode(sourcePin->nodeId) : nullptr;
+    if (!sourceNode || !IsConstantNodeType(sourceNode->type)) return false;
+    if (ctx.options.constantsAreParameters && !ctx.createdConstants.count(sourceNode->id)) return false;
+    const glm::vec4 value = ReadPinValue(sourceNode->parameter, sourcePin->type);
+    out = Truncate(ConvertValue(value, sourcePin->type, pin->type), pin->type);
+    return true;
+}
+
+// Point every link leaving `from` at `to` instead
+void Redirect(MaterialGraph& graph, PinID from, PinID to) {
+    std::vector<PinID> consumers;
+    for (const auto& [linkId, link] : graph.GetLinks()) {
+        if (link.startPinId == from) consumers.push_back(link.endPinId);
+    }
+    for (PinID endPin : consumers) {
+        graph.CreateLink(to, endPin); // Replaces the existing link into endPin
+    }
+}
+
+PinID GetConstantPin(OptimizeContext& ctx, PinType type, const glm::vec4& value, const glm::vec2& position) {
+    const glm::vec4 stored = Truncate(value, type);
+    auto [it, inserted] = ctx.constants.try_emplace(MakeConstantKey(type, stored), INVALID_PIN_ID);
+    if (!inserted) return it->second;
+
+    const NodeID nodeId = ctx.graph.CreateNode(GetConstantNodeType(type), position);
+    MaterialNode* node = ctx.graph.GetNode(nodeId);
+    node->parameter = MakePinValue(stored, type);
+    ctx.createdConstants.insert(nodeId);
+    it->second = node->outputPins[0];
+    return it->second;
+}
+
+// Post-order from the active output: every node after the nodes feeding it
+bool Visit(const MaterialGraph& graph, NodeID nodeId, std::unordered_set<NodeID>& visiting,
+           std::unordered_set<NodeID>& visited, std::vector<NodeID>& order) {
+    if (visited.count(nodeId)) return true;
+    if (!visiting.insert(nodeId).second) return false;
+
+    const MaterialNode* node = graph.GetNode(nodeId);
+    if (node) {
+        for (PinID inputPin : node->inputPins) {
+            const PinID source = GetSourcePin(graph, inputPin);
+            if (source == INVALID_PIN_ID) continue;
+            if (!Visit(graph, graph.GetPinNodeId(source), visiting, visited, order)) return false;
+        }
+    }
+
+    visiting.erase(nodeId);
+    visited.insert(nodeId);
+    if (node) order.push_back(nodeId);
+    return true;
+}
+
+bool SortFromOutput(const MaterialGraph& graph, std::vector<NodeID>& order) {
+    order.clear();
+    std::unordered_set<NodeID> visiting, visited;
+    return Visit(graph, graph.GetActiveOutputNodeId(), visiting, visited, order);
+}
+
+// ============================================================================
+// Passes
+// ============================================================================
+
+bool TryFold(OptimizeContext& ctx, const MaterialNode& node) {
+    if (node.inputPins.size() > 5 || node.outputPins.size() > 4) return false;
+
+    glm::vec4 in[5] = {};
+    for (size_t i = 0; i < node.inputPins.size(); ++i) {
+        if (!GetConstantInput(ctx, node.inputPins[i], in[i])) return false;
+    }
+    glm::vec4 out[4] = {};
+    if (!EvaluateNode(node.type, in, out)) return false;
+
+    std::vector<PinType> outTypes;
+    for (size_t i = 0; i < node.outputPins.size(); ++i) {
+        const MaterialPin* pin = ctx.graph.GetPin(node.outputPins[i]);
+        if (!pin || !IsFinite(out[i], pin->type)) return false;
+        outTypes.push_back(pin->type);
+    }
+
+    const std::vector<PinID> outputs = node.outputPins;
+    const glm::vec2 position = node.position;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        Redirect(ctx.graph, outputs[i], GetConstantPin(ctx, outTypes[i], out[i], position));
+    }
+    return true;
+}
+
+bool TrySimplify(OptimizeContext& ctx, const MaterialNode& node) {
+    MaterialGraph& graph = ctx.graph;
+    if (node.outputPins.size() != 1) return false;
+    const MaterialPin* outPin = graph.GetPin(node.outputPins[0]);
+    if (!outPin) return false;
+
+    auto source = [&](size_t i) -> PinID {
+        return i < node.inputPins.size() ? GetSourcePin(graph, node.inputPins[i]) : INVALID_PIN_ID;
+    };
+    // Input i is constant with every component equal to c
+    auto isConstant = [&](size_t i, float c) -> bool {
+        glm::vec4 v;
+        if (i >= node.inputPins.size() || !GetConstantInput(ctx, node.inputPins[i], v)) return false;
+        const MaterialPin* pin = graph.GetPin(node.inputPins[i]);
+        for (int k = 0; k < GetPinTypeComponents(pin->type); ++k) {
+            if (v[k] != c) return false;
+        }
+        return true;
+    };
+    // The node passes `from` through unchanged. Only taken when `from` already has the node's
+    // output type, so every consumer converts it exactly as before.
+    auto bypass = [&](PinID from) -> bool {
+        const MaterialPin* fromPin = from != INVALID_PIN_ID ? graph.GetPin(from) : nullptr;
+        if (!fromPin || fromPin->type != outPin->type) return false;
+        Redirect(graph, node.outputPins[0], from);
+        return true;
+    };
+    auto replaceWithConstant = [&](float c) -> bool {
+        Redirect(graph, node.outputPins[0], GetConstantPin(ctx, outPin->type, glm::vec4(c), node.position));
+        return true;
+    };
+    // Input 0 comes from a node of `type`; its own input 0 is what the pair cancels back to
+    auto cancelsWith = [&](NodeType type) -> bool {
+        const MaterialNode* inner = GetSourceNode(graph, node.inputPins[0]);
+        return inner && inner->type == type && !inner->inputPins.empty() &&
+               bypass(GetSourcePin(graph, inner->inputPins[0]));
+    };
+
+    switch (node.type) {
+        case NodeType::Add:
+            return (isConstant(0, 0.0f) && bypass(source(1))) || (isConstant(1, 0.0f) && bypass(source(0)));
+        case NodeType::Subtract:
+            return isConstant(1, 0.0f) && bypass(source(0));
+        case NodeType::Multiply:
+            if (isConstant(0, 0.0f) || isConstant(1, 0.0f)) return replaceWithConstant(0.0f);
+            return (isConstant(0, 1.0f) && bypass(source(1))) || (isConstant(1, 1.0f) && bypass(source(0)));
+        case NodeType::Divide:
+            if (isConstant(0, 0.0f)) return replaceWithConstant(0.0f);
+            return isConstant(1, 1.0f) && bypass(source(0));
+        case NodeType::Power:
+            return isConstant(1, 1.0f) && bypass(source(0));
+        case NodeType::Lerp:
+            if (isConstant(2, 0.0f)) return bypass(source(0));
+            if (isConstant(2, 1.0f)) return bypass(source(1));
+            return source(0) != INVALID_PIN_ID && source(0) == source(1) && bypass(source(0));
+        case NodeType::Min:
+        case NodeType::Max:
+            return source(0) != INVALID_PIN_ID && source(0) == source(1) && bypass(source(0));
+        case NodeType::OneMinus:
+            return cancelsWith(NodeType::OneMinus);
+        case NodeType::Negate:
+            return cancelsWith(NodeType::Negate);
+        case NodeType::Vec3ToFloat:
+            return cancelsWith(NodeType::FloatToVec3);
+        case NodeType::Vec4ToVec3:
+            return cancelsWith(NodeType::Vec3ToVec4);
+        case NodeType::Saturate: {
+            const MaterialNode* inner = GetSourceNode(graph, node.inputPins[0]);
+            return inner && inner->type == NodeType::Saturate && bypass(source(0));
+        }
+        case NodeType::Reroute:
+            return bypass(source(0));
+        default:
+            return false;
+    }
+}
+
+// Identity of a node's result: type, parameter, where each input comes from (or its default)
+// and the output layout
+std::string MakeSignature(const MaterialGraph& graph, const MaterialNode& node, bool defaultsAreParameters) {
+    std::string key;
+    AppendBytes(key, node.type);
+    AppendBytes(key, node.parameter.index());
+    if (auto* s = std::get_if<std::string>(&node.parameter)) {
+        AppendBytes(key, s->size());
+        key += *s;
+    } else {
+        AppendBytes(key, ReadPinValue(node.parameter, PinType::Vec4));
+        AppendBytes(key, ReadPinValue(node.parameter, PinType::Vec3));
+        AppendBytes(key, ReadPinValue(node.parameter, PinType::Vec2));
+        AppendBytes(key, ReadPinValue(node.parameter, PinType::Float));
+    }
+    for (PinID inputPin : node.inputPins) {
+        const MaterialPin* pin = graph.GetPin(inputPin);
+        if (!pin) continue;
+        AppendBytes(key, pin->type);
+        key += pin->name;
+        key.push_back('\0');
+        const PinID source = GetSourcePin(graph, inputPin);
+        if (source != INVALID_PIN_ID) {
+            key.push_back('L');
+            AppendBytes(key, source);
+        } else if (defaultsAreParameters) {
+            // Each default is its own parameter, so equal values today do not make nodes equal
+            key.push_back('P');
+            AppendBytes(key, inputPin);
+        } else {
+            key.push_back('D');
+            AppendBytes(key, ReadPinValue(pin->defaultValue, pin->type));
+        }
+    }
+    key.push_back('|');
+    for (PinID outputPin : node.outputPins) {
+        const MaterialPin* pin = graph.GetPin(outputPin);
+        if (!pin) continue;
+        AppendBytes(key, pin->type);
+        key += pin->name;
+        key.push_back('\0');
+    }
+    return key;
+}
+
+bool TryMerge(OptimizeContext& ctx, const MaterialNode& node) {
+    const std::string signature = MakeSignature(ctx.graph, node, ctx.options.constantsAreParameters);
+    auto [it, inserted] = ctx.signatures.try_emplace(signature, node.id);
+    if (inserted) return false;
+
+    const MaterialNode* canonical = ctx.graph.GetNode(it->second);
+    if (!canonical || canonical->outputPins.size() != node.outputPins.size()) return false;
+    const std::vector<PinID> outputs = node.outputPins;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        Redirect(ctx.graph, outputs[i], canonical->outputPins[i]);
+    }
+    return true;
+}
+
+// User constants join the constant table; a repeated value is merged into the first
+bool TryShareConstant(OptimizeContext& ctx, const MaterialNode& node) {
+    if (node.outputPins.empty() || ctx.options.constantsAreParameters) return false;
+    const PinType type = GetConstantPinType(node.type);
+    const glm::vec4 value = Truncate(ReadPinValue(node.parameter, type), type);
+    auto [it, inserted] = ctx.constants.try_emplace(MakeConstantKey(type, value), node.outputPins[0]);
+    if (inserted || it->second == node.outputPins[0]) return false;
+    Redirect(ctx.graph, node.outputPins[0], it->second);
+    return true;
+}
+
+} // namespace
+
+MaterialGraph OptimizeMaterialGraph(const MaterialGraph& graph, MaterialOptimizeStats* outStats,
+                                    const MaterialOptimizeOptions& options) {
+    LUCENT_PROFILE_FUNCTION();
+    MaterialOptimizeStats stats;
+    stats.nodesBefore = static_cast<uint32_t>(graph.GetNodes().size());
+
+    MaterialGraph optimized = graph;
+    std::vector<NodeID> order;
+    if (!optimized.GetNode(optimized.GetActiveOutputNodeId()) || !SortFromOutput(optimized, order)) {
+        // No output or a cycle: leave the error to the backends
+        stats.nodesAfter = stats.nodesBefore;
+        if (outStats) *outStats = stats;
+        return optimized;
+    }
+
+    OptimizeContext ctx{ optimized, stats, options, {}, {}, {} };
+    for (NodeID nodeId : order) {
+        // Copy: rewrites below may create nodes and rehash the node map
+        const MaterialNode* current = optimized.GetNode(nodeId);
+        if (!current || current->type == NodeType::PBROutput || current->type == NodeType::VolumetricOutput) continue;
+        const MaterialNode node = *current;
+
+        if (IsConstantNodeType(node.type)) {
+            stats.merged += TryShareConstant(ctx, node) ? 1 : 0;
+        } else if (TryFold(ctx, node)) {
+            ++stats.folded;
+        } else if (TrySimplify(ctx, node)) {
+            ++stats.simplified;
+        } else if (TryMerge(ctx, node)) {
+            ++stats.merged;
+        }
+    }
+
+    // Drop everything the rewrites disconnected, plus nodes that never reached the output
+    SortFromOutput(optimized, order);
+    const std::unordered_set<NodeID> live(order.begin(), order.end());
+    std::vector<NodeID> dead;
+    for (const auto& [nodeId, node] : optimized.GetNodes()) {
+        if (live.count(nodeId) || nodeId == optimized.GetOutputNodeId() ||
+            nodeId == optimized.GetVolumeOutputNodeId()) {
+            continue;
+        }
+        dead.push_back(nodeId);
+    }
+    for (NodeID nodeId : dead) {
+        optimized.DeleteNode(nodeId);
+    }
+
+    stats.removed = static_cast<uint32_t>(dead.size());
+    stats.nodesAfter = static_cast<uint32_t>(optimized.GetNodes().size());
+    if (outStats) *outStats = stats;
+    return optimized;
+}
+
+} // namespace lucent::material
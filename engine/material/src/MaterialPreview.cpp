@@ -0,0 +1,511 @@
+#include "lucent/material/MaterialPreview.h"
+#include "lucent/material/MaterialAsset.h"
+#include "lucent/material/MaterialBaker.h"
+#include "lucent/material/MaterialProgram.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <span>
+
+namespace lucent::material {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float kPi = 3.14159265359f;
+
+constexpr char kMagic[8] = { 'L', 'U', 'C', 'E', 'N', 'T', 'T', 'H' };
+constexpr uint32_t kVersion = 1;
+// Part of the disk key: bump when the scene or shading below changes so old thumbnails are not reused
+constexpr uint32_t kRenderRevision = 1;
+
+struct EntryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;
+    uint64_t key;
+    uint64_t graphHash;
+    uint64_t pixelHash;
+};
+static_assert(sizeof(EntryHeader) == 40);
+
+// ============================================================================
+// Scene: the editor preview's sphere (radius 0.6) seen from (1.4, 1.0, 1.4), orthographic so the
+// ball fills the same share of every thumbnail
+// ============================================================================
+
+constexpr float kSphereRadius = 0.6f;
+constexpr float kBallScreenRadius = 0.92f;   // Of half the thumbnail
+constexpr float kSkyIntensity = 0.6f;
+const glm::vec3 kSunColor(2.2f, 2.1f, 1.95f);
+
+struct PreviewCamera {
+    glm::vec3 back;     // Towards the camera
+    glm::vec3 right;
+    glm::vec3 up;
+};
+
+PreviewCamera MakeCamera() {
+    PreviewCamera camera;
+    camera.back = glm::normalize(glm::vec3(1.4f, 1.0f, 1.4f));
+    camera.right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), camera.back));
+    camera.up = glm::cross(camera.back, camera.right);
+    return camera;
+}
+
+glm::vec3 SunDirection() {
+    return glm::normalize(glm::vec3(0.6f, 0.9f, 0.25f));
+}
+
+const glm::vec3 kZenith(0.32f, 0.48f, 0.80f);
+const glm::vec3 kHorizon(0.85f, 0.87f, 0.90f);
+const glm::vec3 kGround(0.24f, 0.22f, 0.20f);
+
+// Procedural sky: horizon to zenith gradient over a dim ground
+glm::vec3 SkyRadiance(const glm::vec3& direction) {
+    if (direction.y >= 0.0f) return glm::mix(kHorizon, kZenith, std::sqrt(direction.y)) * kSkyIntensity;
+    return glm::mix(kHorizon * 0.5f, kGround, std::min(1.0f, -direction.y * 4.0f)) * kSkyIntensity;
+}
+
+// Cosine-weighted sky over the hemisphere around `normal`, as a sky/ground blend
+glm::vec3 SkyIrradiance(const glm::vec3& normal) {
+    const glm::vec3 sky = glm::mix(kHorizon, kZenith, 0.6f);
+    return glm::mix(kGround, sky, 0.5f + 0.5f * normal.y) * kSkyIntensity;
+}
+
+// Split-sum environment BRDF scale and bias (Karis, fitted by Lazarov)
+glm::vec2 EnvBRDFApprox(float roughness, float NoV) {
+    const float c0x = -1.0f, c0y = -0.0275f, c0z = -0.572f, c0w = 0.022f;
+    const float c1x = 1.0f, c1y = 0.0425f, c1z = 1.04f, c1w = -0.04f;
+    const float rx = roughness * c0x + c1x;
+    const float ry = roughness * c0y + c1y;
+    const float rz = roughness * c0z + c1z;
+    const float rw = roughness * c0w + c1w;
+    const float a004 = std::min(rx * rx, std::exp2(-9.28f * NoV)) * rx + ry;
+    return glm::vec2(a004 * -1.04f + rz, a004 * 1.04f + rw);
+}
+
+// Narkowicz's fit of the ACES filmic curve
+float ToneMap(float x) {
+    x = std::max(x, 0.0f);
+    return std::clamp((x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f), 0.0f, 1.0f);
+}
+
+uint8_t ToSRGB8(float linear) {
+    const float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+glm::vec3 ShadePoint(const glm::vec3& N, const glm::vec3& V, const glm::vec3& baseColor, float metallic,
+                     float roughness, const glm::vec3& emissive) {
+    const glm::vec3 base = glm::max(baseColor, glm::vec3(0.0f));
+    metallic = std::clamp(metallic, 0.0f, 1.0f);
+    roughness = std::clamp(roughness, 0.045f, 1.0f);
+    const glm::vec3 F0 = glm::mix(glm::vec3(0.04f), base, metallic);
+    const glm::vec3 diffuse = base * (1.0f - metallic);
+    const float NoV = std::max(glm::dot(N, V), 1e-4f);
+
+    // Sky: irradiance for diffuse, the sky along the reflection (blurred towards irradiance as
+    // roughness grows) for specular
+    const glm::vec3 R = N * (2.0f * glm::dot(N, V)) - V;
+    const glm::vec3 envSpecular = glm::mix(SkyRadiance(R), SkyIrradiance(R), roughness);
+    const glm::vec2 envBRDF = EnvBRDFApprox(roughness, NoV);
+    glm::vec3 color = diffuse * SkyIrradiance(N) + envSpecular * (F0 * envBRDF.x + glm::vec3(envBRDF.y));
+
+    // Sun: GGX with Smith-Schlick visibility and Schlick Fresnel
+    const glm::vec3 L = SunDirection();
+    const float NoL = glm::dot(N, L);
+    if (NoL > 0.0f) {
+        const glm::vec3 H = glm::normalize(V + L);
+        const float NoH = std::max(glm::dot(N, H), 0.0f);
+        const float VoH = std::max(glm::dot(V, H), 0.0f);
+        const float alpha = roughness * roughness;
+        const float alpha2 = alpha * alpha;
+        const float d = NoH * NoH * (alpha2 - 1.0f) + 1.0f;
+        const float D = alpha2 / (kPi * d * d);
+        const float k = (roughness + 1.0f) * (roughness + 1.0f) / 8.0f;
+        const float G = (NoV / (NoV * (1.0f - k) + k)) * (NoL / (NoL * (1.0f - k) + k));
+        const glm::vec3 F = F0 + (glm::vec3(1.0f) - F0) * std::pow(1.0f - VoH, 5.0f);
+        const glm::vec3 specular = F * (D * G / (4.0f * NoV * NoL));
+        color += (diffuse / kPi + specular) * kSunColor * NoL;
+    }
+    return color + glm::max(emissive, glm::vec3(0.0f));
+}
+
+bool IsOutputLinked(const MaterialGraph& graph, const char* pinName) {
+    const MaterialNode* output = graph.GetNode(graph.GetOutputNodeId());
+    if (!output) return false;
+    for (PinID pinId : output->inputPins) {
+        const MaterialPin* pin = graph.GetPin(pinId);
+        if (pin && pin->name == pinName) return graph.FindLinkByEndPin(pinId) != INVALID_LINK_ID;
+    }
+    return false;
+}
+
+size_t GetEntryBytes(uint32_t size) {
+    return sizeof(EntryHeader) + static_cast<size_t>(size) * size * 4;
+}
+
+double ElapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+// ============================================================================
+// Rendering
+// ============================================================================
+
+bool RenderMaterialPreview(const MaterialGraph& graph, uint32_t size, MaterialPreviewImage& outImage,
+                           std::string& outError) {
+    LUCENT_PROFILE_FUNCTION();
+    outImage = MaterialPreviewImage{};
+    outImage.graphHash = graph.ComputeHash();
+    outImage.size = size;
+
+    if (size == 0) {
+        outError = "Preview size must be positive";
+        return false;
+    }
+    if (graph.GetDomain() == MaterialDomain::Volume) {
+        outError = "Volume materials have no surface preview";
+        return false;
+    }
+
+    MaterialProgram program;
+    if (!CompileMaterialProgram(graph, program, outError)) return false;
+
+    // Covered pixels and their coverage of the ball's silhouette
+    const PreviewCamera camera = MakeCamera();
+    const float pixelToBall = 2.0f / (static_cast<float>(size) * kBallScreenRadius);
+    std::vector<uint32_t> pixels;
+    std::vector<float> coverage;
+    std::vector<float> inputs[11];     // uv, position, normal
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const float sx = ((static_cast<float>(x) + 0.5f) / static_cast<float>(size) * 2.0f - 1.0f) / kBallScreenRadius;
+            const float sy = (1.0f - (static_cast<float>(y) + 0.5f) / static_cast<float>(size) * 2.0f) / kBallScreenRadius;
+            const float r = std::sqrt(sx * sx + sy * sy);
+            const float cover = std::clamp((1.0f - r) / pixelToBall + 0.5f, 0.0f, 1.0f);
+            if (cover <= 0.0f) continue;
+
+            // Edge pixels shade the nearest point of the silhouette
+            const float scale = r > 0.999f ? 0.999f / r : 1.0f;
+            const float lx = sx * scale, ly = sy * scale;
+            const float lz = std::sqrt(std::max(0.0f, 1.0f - lx * lx - ly * ly));
+            const glm::vec3 n = glm::normalize(camera.right * lx + camera.up * ly + camera.back * lz);
+
+            // UVs as laid out by Primitives::GenerateSphere
+            float theta = std::atan2(n.z, n.x);
+            if (theta < 0.0f) theta += 2.0f * kPi;
+            inputs[0].push_back(theta / (2.0f * kPi));
+            inputs[1].push_back(std::acos(std::clamp(n.y, -1.0f, 1.0f)) / kPi);
+            for (int k = 0; k < 3; ++k) {
+                inputs[2 + k].push_back(n[k] * kSphereRadius);
+                inputs[5 + k].push_back(n[k]);
+            }
+            pixels.push_back(y * size + x);
+            coverage.push_back(cover);
+        }
+    }
+
+    MaterialShadingPoints points;
+    points.count = static_cast<uint32_t>(pixels.size());
+    points.uv[0] = inputs[0].data();
+    points.uv[1] = inputs[1].data();
+    for (int k = 0; k < 3; ++k) {
+        points.position[k] = inputs[2 + k].data();
+        points.normal[k] = inputs[5 + k].data();
+        // Orthographic: every point sees the camera along the same direction
+        inputs[8 + k].assign(points.count, camera.back[k]);
+        points.viewDirection[k] = inputs[8 + k].data();
+    }
+    const bool samplesTextures = std::any_of(program.instructions.begin(), program.instructions.end(),
+                                             [](const MaterialInstruction& ins) { return ins.op == MaterialOp::Texture; });
+    if (samplesTextures) points.sampleTexture = CreateMaterialTextureSampler(graph);
+
+    std::vector<float> outputs(static_cast<size_t>(program.outputRowCount) * points.count);
+    program.Execute(points, outputs.data());
+
+    // Output component c at point i, or `fallback` when the output is absent
+    auto stream = [&](const char* name, uint32_t component) -> const float* {
+        const MaterialProgramOutput* output = program.FindOutput(name);
+        if (!output) return nullptr;
+        return outputs.data() + static_cast<size_t>(output->row + component) * points.count;
+    };
+    auto read = [](const float* values, uint32_t i, float fallback) { return values ? values[i] : fallback; };
+    const float* baseColor[3] = { stream("Base Color", 0), stream("Base Color", 1), stream("Base Color", 2) };
+    const float* emissive[3] = { stream("Emissive", 0), stream("Emissive", 1), stream("Emissive", 2) };
+    const float* metallic = stream("Metallic", 0);
+    const float* roughness = stream("Roughness", 0);
+    const float* alpha = stream("Alpha", 0);
+    const bool hasNormal = IsOutputLinked(graph, "Normal");
+    const float* normal[3] = { nullptr, nullptr, nullptr };
+    if (hasNormal) {
+        for (uint32_t c = 0; c < 3; ++c) normal[c] = stream("Normal", c);
+    }
+
+    outImage.pixels.assign(static_cast<size_t>(size) * size * 4, 0);
+    for (uint32_t i = 0; i < points.count; ++i) {
+        glm::vec3 N(inputs[5][i], inputs[6][i], inputs[7][i]);
+        if (normal[0] && normal[1] && normal[2]) {
+            const glm::vec3 shadingNormal(normal[0][i], normal[1][i], normal[2][i]);
+            if (glm::dot(shadingNormal, shadingNormal) > 1e-8f) N = glm::normalize(shadingNormal);
+        }
+        const glm::vec3 color = ShadePoint(
+            N, camera.back,
+            glm::vec3(read(baseColor[0], i, 0.8f), read(baseColor[1], i, 0.8f), read(baseColor[2], i, 0.8f)),
+            read(metallic, i, 0.0f), read(roughness, i, 0.5f),
+            glm::vec3(read(emissive[0], i, 0.0f), read(emissive[1], i, 0.0f), read(emissive[2], i, 0.0f)));
+
+        uint8_t* pixel = outImage.pixels.data() + static_cast<size_t>(pixels[i]) * 4;
+        pixel[0] = ToSRGB8(ToneMap(color.x));
+        pixel[1] = ToSRGB8(ToneMap(color.y));
+        pixel[2] = ToSRGB8(ToneMap(color.z));
+        const float a = coverage[i] * std::clamp(read(alpha, i, 1.0f), 0.0f, 1.0f);
+        pixel[3] = static_cast<uint8_t>(a * 255.0f + 0.5f);
+    }
+    return true;
+}
+
+// ============================================================================
+// Cache: requests and scheduling
+// ============================================================================
+
+MaterialPreviewCache::MaterialPreviewCache(uint32_t size, uint32_t maxConcurrent)
+    : m_Size(std::max(size, 1u))
+    , m_MaxConcurrent(std::max(maxConcurrent, 1u)) {
+}
+
+MaterialPreviewCache::~MaterialPreviewCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const std::string& key : m_Queue) m_Entries[key].next.reset();
+        m_Queue.clear();
+    }
+    // Running renders reference this cache
+    JobSystem::Get().Wait(m_Jobs);
+}
+
+std::shared_ptr<const MaterialPreviewImage> MaterialPreviewCache::Request(const std::string& key,
+                                                                          const MaterialGraph& graph) {
+    const uint64_t graphHash = graph.ComputeHash();
+    std::shared_ptr<const MaterialPreviewImage> image;
+    std::vector<std::pair<std::string, Work>> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Entry& entry = m_Entries[key];
+        image = entry.image;
+        if (entry.graphHash == graphHash) return image;
+
+        entry.graphHash = graphHash;
+        Enqueue(key, entry, Work{ std::string(), std::make_shared<const MaterialGraph>(graph) });
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+    return image;
+}
+
+std::shared_ptr<const MaterialPreviewImage> MaterialPreviewCache::RequestFile(const std::string& path,
+                                                                              std::filesystem::file_time_type writeTime) {
+    std::shared_ptr<const MaterialPreviewImage> image;
+    std::vector<std::pair<std::string, Work>> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Entry& entry = m_Entries[path];
+        image = entry.image;
+        if (entry.writeTime == writeTime) return image;
+
+        entry.writeTime = writeTime;
+        Enqueue(path, entry, Work{ path, nullptr });
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+    return image;
+}
+
+void MaterialPreviewCache::Enqueue(const std::string& key, Entry& entry, Work work) {
+    // A key waiting already keeps its place in line; a running key is queued when it finishes
+    if (!entry.next && !entry.running) m_Queue.push_back(key);
+    entry.next = std::move(work);
+}
+
+std::vector<std::pair<std::string, MaterialPreviewCache::Work>> MaterialPreviewCache::TakeStartable() {
+    std::vector<std::pair<std::string, Work>> startable;
+    while (m_Running < m_MaxConcurrent && !m_Queue.empty()) {
+        const std::string key = std::move(m_Queue.front());
+        m_Queue.pop_front();
+        Entry& entry = m_Entries[key];
+        if (!entry.next) continue;
+
+        entry.running = true;
+        ++m_Running;
+        startable.emplace_back(key, std::move(*entry.next));
+        entry.next.reset();
+    }
+    LUCENT_PROFILE_COUNTER("Material Previews Queued", static_cast<int64_t>(m_Queue.size()));
+    return startable;
+}
+
+void MaterialPreviewCache::Start(std::vector<std::pair<std::string, Work>> work) {
+    for (auto& [key, item] : work) {
+        JobSystem::Get().Schedule([this, key = std::move(key), item = std::move(item)]() { Run(key, item); }, &m_Jobs);
+    }
+}
+
+void MaterialPreviewCache::Run(const std::string& key, const Work& work) {
+    LUCENT_PROFILE_ZONE("MaterialPreviewCache::Run");
+
+    auto image = std::make_shared<MaterialPreviewImage>();
+    image->size = m_Size;
+    bool skipped = false;
+    bool diskHit = false;
+    bool rendered = false;
+    double renderMs = 0.0;
+    try {
+        std::shared_ptr<const MaterialGraph> graph = work.graph;
+        std::string error;
+        if (!work.path.empty()) {
+            auto loaded = std::make_shared<MaterialGraph>();
+            if (LoadMaterialGraph(work.path, *loaded, error)) graph = std::move(loaded);
+            else image->error = error;
+        }
+
+        if (graph) {
+            const uint64_t graphHash = graph->ComputeHash();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                Entry& entry = m_Entries[key];
+                // A file request learns its hash here; a newer graph request waiting wins
+                if (!work.path.empty() && !entry.next) entry.graphHash = graphHash;
+                // e.g. a material saved from the editor, which already requested this graph
+                skipped = entry.image && entry.image->IsValid() && entry.image->graphHash == graphHash;
+            }
+
+            if (!skipped) {
+                diskHit = LoadFromDisk(graphHash, *image);
+                if (!diskHit) {
+                    const Clock::time_point startTime = Clock::now();
+                    rendered = RenderMaterialPreview(*graph, m_Size, *image, error);
+                    renderMs = ElapsedMs(startTime, Clock::now());
+                    if (rendered) StoreToDisk(*image);
+                    else image->error = error;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        *image = MaterialPreviewImage{};
+        image->error = std::string("Preview exception: ") + e.what();
+    }
+
+    std::vector<std::pair<std::string, Work>> startable;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Entry& entry = m_Entries[key];
+        if (!skipped) {
+            entry.image = std::move(image);
+            if (diskHit) {
+                ++m_DiskHits;
+            } else if (rendered) {
+                ++m_Rendered;
+                m_TotalRenderMs += renderMs;
+            } else {
+                ++m_Failed;
+                LUCENT_CORE_WARN("Material preview '{}': {}", key, entry.image->error);
+            }
+        }
+        entry.running = false;
+        if (entry.next) m_Queue.push_back(key);
+        --m_Running;
+        startable = TakeStartable();
+    }
+    Start(std::move(startable));
+}
+
+void MaterialPreviewCache::WaitIdle() {
+    JobSystem::Get().Wait(m_Jobs);
+}
+
+// ============================================================================
+// Cache: disk
+// ============================================================================
+
+void MaterialPreviewCache::SetDirectory(const std::string& directory, size_t maxBytes) {
+    m_DiskCache.SetDirectory(directory, maxBytes);
+}
+
+uint64_t MaterialPreviewCache::MakeDiskKey(uint64_t graphHash) const {
+    const uint64_t values[3] = { graphHash, m_Size, kRenderRevision };
+    return HashBytes(std::as_bytes(std::span<const uint64_t>(values)));
+}
+
+bool MaterialPreviewCache::LoadFromDisk(uint64_t graphHash, MaterialPreviewImage& outImage) {
+    LUCENT_PROFILE_FUNCTION();
+    const uint64_t key = MakeDiskKey(graphHash);
+    return m_DiskCache.Load(key, [&](std::span<const std::byte> bytes) {
+        EntryHeader header{};
+        if (bytes.size() != GetEntryBytes(m_Size)) return false;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+            header.key != key || header.size != m_Size || header.graphHash != graphHash) {
+            return false;
+        }
+        const auto pixels = bytes.subspan(sizeof(EntryHeader));
+        if (HashBytes(pixels) != header.pixelHash) return false;
+
+        outImage = MaterialPreviewImage{};
+        outImage.graphHash = graphHash;
+        outImage.size = m_Size;
+        outImage.pixels.resize(pixels.size());
+        std::memcpy(outImage.pixels.data(), pixels.data(), pixels.size());
+        return true;
+    });
+}
+
+void MaterialPreviewCache::StoreToDisk(const MaterialPreviewImage& image) {
+    LUCENT_PROFILE_FUNCTION();
+    if (!image.IsValid() || image.size != m_Size || !m_DiskCache.IsEnabled()) return;
+
+    const auto pixels = std::as_bytes(std::span<const uint8_t>(image.pixels));
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.size = m_Size;
+    header.key = MakeDiskKey(image.graphHash);
+    header.graphHash = image.graphHash;
+    header.pixelHash = HashBytes(pixels);
+
+    const std::span<const std::byte> parts[] = { std::as_bytes(std::span<const EntryHeader>(&header, 1)), pixels };
+    m_DiskCache.Store(header.key, parts);
+}
+
+// ============================================================================
+// Stats
+// ============================================================================
+
+MaterialPreviewStats MaterialPreviewCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    MaterialPreviewStats stats;
+    stats.queued = static_cast<uint32_t>(m_Queue.size());
+    stats.running = m_Running;
+    stats.rendered = m_Rendered;
+    stats.diskHits = m_DiskHits;
+    stats.failed = m_Failed;
+    stats.totalRenderMs = m_TotalRenderMs;
+    return stats;
+}
+
+void MaterialPreviewCache::LogStats() const {
+    const MaterialPreviewStats stats = GetStats();
+    LUCENT_CORE_INFO("MaterialPreviewCache: {} rendered ({:.1f} ms avg), {} from disk, {} failed",
+                     stats.rendered, stats.GetAverageRenderMs(), stats.diskHits, stats.failed);
+}
+
+} // namespace lucent::material
@@ -0,0 +1,900 @@
+#include "lucent/material/MaterialProgram.h"
+#include "lucent/material/CustomCode.h"
+#include "lucent/material/MaterialOptimizer.h"
+#include "lucent/core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace lucent::material {
+
+namespace {
+
+// ============================================================================
+// Values
+// ============================================================================
+
+// A stored value read as `type`; like MaterialCompiler::GetDefaultValue, a value of another type
+// reads as zero
+glm::vec4 ReadPinValue(const PinValue& value, PinType type) {
+    switch (type) {
+        case PinType::Float:
+            if (auto* f = std::get_if<float>(&value)) return glm::vec4(*f, 0.0f, 0.0f, 0.0f);
+            break;
+        case PinType::Vec2:
+            if (auto* v = std::get_if<glm::vec2>(&value)) return glm::vec4(v->x, v->y, 0.0f, 0.0f);
+            break;
+        case PinType::Vec3:
+            if (auto* v = std::get_if<glm::vec3>(&value)) return glm::vec4(v->x, v->y, v->z, 0.0f);
+            break;
+        case PinType::Vec4:
+            if (auto* v = std::get_if<glm::vec4>(&value)) return *v;
+            break;
+        case PinType::Sampler2D:
+            break;
+    }
+    return glm::vec4(0.0f);
+}
+
+PinType GetVectorType(int components) {
+    switch (components) {
+        case 2: return PinType::Vec2;
+        case 3: return PinType::Vec3;
+        case 4: return PinType::Vec4;
+        default: return PinType::Float;
+    }
+}
+
+constexpr uint32_t kSelectZero = 4;
+constexpr uint32_t kSelectOne = 5;
+
+uint32_t EncodeSwizzle(uint32_t s0, uint32_t s1 = kSelectZero, uint32_t s2 = kSelectZero, uint32_t s3 = kSelectZero) {
+    return s0 | (s1 << 3) | (s2 << 6) | (s3 << 9);
+}
+
+// Stops as the GLSL backend reads them: "RAMP:t,r,g,b;...", black to white when invalid
+std::vector<MaterialRampStop> ParseRamp(const PinValue& parameter) {
+    std::vector<MaterialRampStop> stops;
+    if (std::holds_alternative<std::string>(parameter)) {
+        const std::string& blob = std::get<std::string>(parameter);
+        const std::string prefix = "RAMP:";
+        size_t start = (blob.rfind(prefix, 0) == 0) ? prefix.size() : 0;
+        while (start < blob.size()) {
+            const size_t end = blob.find(';', start);
+            const std::string token = blob.substr(start, end == std::string::npos ? std::string::npos : (end - start));
+            float t = 0, r = 1, g = 1, b = 1;
+            if (!token.empty() && sscanf_s(token.c_str(), "%f,%f,%f,%f", &t, &r, &g, &b) == 4) {
+                stops.push_back({ t, glm::vec4(r, g, b, 1.0f) });
+            }
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+    }
+    if (stops.size() < 2) {
+        stops = { { 0.0f, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) }, { 1.0f, glm::vec4(1.0f) } };
+    }
+    std::stable_sort(stops.begin(), stops.end(), [](const auto& a, const auto& b) { return a.t < b.t; });
+    return stops;
+}
+
+// ============================================================================
+// Noise
+// ============================================================================
+// Scalar ports of the GLSL noise helpers MaterialCompiler emits
+
+float Fract(float x) {
+    return x - std::floor(x);
+}
+
+float Mix(float a, float b, float t) {
+    return a * (1.0f - t) + b * t;
+}
+
+float Hash13(float x, float y, float z) {
+    x = Fract(x * 0.1031f);
+    y = Fract(y * 0.1031f);
+    z = Fract(z * 0.1031f);
+    const float d = x * (z + 31.32f) + y * (y + 31.32f) + z * (x + 31.32f);
+    x += d;
+    y += d;
+    z += d;
+    return Fract((x + y) * z);
+}
+
+float ValueNoise3(float x, float y, float z) {
+    const float ix = std::floor(x), iy = std::floor(y), iz = std::floor(z);
+    const float fx = x - ix, fy = y - iy, fz = z - iz;
+    const float n000 = Hash13(ix, iy, iz);
+    const float n100 = Hash13(ix + 1.0f, iy, iz);
+    const float n010 = Hash13(ix, iy + 1.0f, iz);
+    const float n110 = Hash13(ix + 1.0f, iy + 1.0f, iz);
+    const float n001 = Hash13(ix, iy, iz + 1.0f);
+    const float n101 = Hash13(ix + 1.0f, iy, iz + 1.0f);
+    const float n011 = Hash13(ix, iy + 1.0f, iz + 1.0f);
+    const float n111 = Hash13(ix + 1.0f, iy + 1.0f, iz + 1.0f);
+    const float ux = fx * fx * (3.0f - 2.0f * fx);
+    const float uy = fy * fy * (3.0f - 2.0f * fy);
+    const float uz = fz * fz * (3.0f - 2.0f * fz);
+    const float nxy0 = Mix(Mix(n000, n100, ux), Mix(n010, n110, ux), uy);
+    const float nxy1 = Mix(Mix(n001, n101, ux), Mix(n011, n111, ux), uy);
+    return Mix(nxy0, nxy1, uz);
+}
+
+// type: 0 = fbm, 1 = value, 2 = ridged, 3 = turbulence
+float Noise3(uint32_t type, float x, float y, float z, float octaves, float roughness) {
+    if (type == 1) return ValueNoise3(x, y, z);
+
+    const int iterations = static_cast<int>(std::clamp(octaves, 1.0f, 12.0f));
+    const float gain = std::clamp(roughness, 0.0f, 1.0f);
+    float sum = 0.0f;
+    float amp = 0.5f;
+    float freq = 1.0f;
+    for (int i = 0; i < iterations; ++i) {
+        const float n = ValueNoise3(x * freq, y * freq, z * freq);
+        if (type == 2) sum += amp * (1.0f - std::fabs(n * 2.0f - 1.0f));
+        else if (type == 3) sum += amp * std::fabs(n * 2.0f - 1.0f);
+        else sum += amp * n;
+        freq *= 2.0f;
+        amp *= gain;
+    }
+    return sum;
+}
+
+// ============================================================================
+// Builder
+// ============================================================================
+// Emits code in SSA form over virtual registers; AllocateRegisters() then removes dead code and
+// maps the virtual registers onto as few physical ones as possible.
+
+struct Operand {
+    uint32_t reg = 0;
+    PinType type = PinType::Float;  // Components of `reg` that are meaningful
+};
+
+struct VirtualInstruction {
+    MaterialOp op = MaterialOp::Constant;
+    uint8_t components = 1;
+    uint8_t sourceCount = 0;
+    uint32_t dst = 0;
+    uint32_t src[4] = {};
+    uint32_t imm = 0;
+};
+
+class ProgramBuilder {
+public:
+    ProgramBuilder(const MaterialGraph& graph, MaterialProgram& program, std::string& error)
+        : m_Graph(graph), m_Program(program), m_Error(error) {}
+
+    bool Build();
+
+    // Code emission
+    Operand Emit(MaterialOp op, PinType type, std::initializer_list<Operand> sources, uint32_t imm = 0);
+    Operand Constant(const glm::vec4& value, PinType type);
+    Operand Constant(float value) { return Constant(glm::vec4(value), PinType::Float); }
+    Operand Convert(const Operand& value, PinType to);
+    Operand Swizzle(const Operand& value, PinType to, uint32_t selectors);
+    Operand Component(const Operand& value, int component);
+    Operand Combine(const std::vector<Operand>& scalars);
+    bool Fail(const std::string& message);
+    bool Failed() const { return !m_Error.empty(); }
+
+private:
+    bool CompileNode(const MaterialNode& node);
+    bool CompileCustomCode(const MaterialNode& node);
+    bool IsConnected(PinID inputPin) const { return m_Graph.FindLinkByEndPin(inputPin) != INVALID_LINK_ID; }
+    // Value of a node input (linked output or pin default), converted to `type`
+    Operand In(const MaterialNode& node, size_t index, PinType type);
+    void Set(const MaterialNode& node, size_t outputIndex, const Operand& value);
+    bool AllocateRegisters(std::vector<Operand>& outputs);
+
+    const MaterialGraph& m_Graph;
+    MaterialProgram& m_Program;
+    std::string& m_Error;
+
+    std::vector<VirtualInstruction> m_Code;
+    uint32_t m_NextRegister = 0;
+    std::unordered_map<PinID, Operand> m_PinValues;     // Output pin -> value
+    std::unordered_map<NodeID, uint8_t> m_NodeState;    // 1 = compiling, 2 = done
+    std::unordered_map<std::string, Operand> m_Constants;
+};
+
+Operand ProgramBuilder::Emit(MaterialOp op, PinType type, std::initializer_list<Operand> sources, uint32_t imm) {
+    VirtualInstruction instruction;
+    instruction.op = op;
+    instruction.components = static_cast<uint8_t>(std::max(GetPinTypeComponents(type), 1));
+    instruction.dst = m_NextRegister++;
+    instruction.imm = imm;
+    for (const Operand& source : sources) {
+        instruction.src[instruction.sourceCount++] = source.reg;
+    }
+    m_Code.push_back(instruction);
+    return { instruction.dst, type };
+}
+
+Operand ProgramBuilder::Constant(const glm::vec4& value, PinType type) {
+    glm::vec4 v(0.0f);
+    for (int i = 0; i < GetPinTypeComponents(type); ++i) v[i] = value[i];
+
+    std::string key(reinterpret_cast<const char*>(&type), sizeof(type));
+    key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    auto it = m_Constants.find(key);
+    if (it != m_Constants.end()) return it->second;
+
+    const uint32_t index = static_cast<uint32_t>(m_Program.constants.size());
+    m_Program.constants.push_back(v);
+    const Operand result = Emit(MaterialOp::Constant, type, {}, index);
+    m_Constants.emplace(std::move(key), result);
+    return result;
+}
+
+Operand ProgramBuilder::Swizzle(const Operand& value, PinType to, uint32_t selectors) {
+    return Emit(MaterialOp::Swizzle, to, { value }, selectors);
+}
+
+// Same conversions as MaterialCompiler::ConvertType
+Operand ProgramBuilder::Convert(const Operand& value, PinType to) {
+    const int fromN = GetPinTypeComponents(value.type);
+    const int toN = GetPinTypeComponents(to);
+    if (fromN == toN) return { value.reg, to };
+    if (toN < fromN) return { value.reg, to }; // Truncation only reads fewer components
+    if (fromN == 1) return Swizzle(value, to, EncodeSwizzle(0, 0, 0, 0));
+    if (fromN == 2 && toN == 3) return Swizzle(value, to, EncodeSwizzle(0, 1, kSelectZero));
+    if (fromN == 2 && toN == 4) return Swizzle(value, to, EncodeSwizzle(0, 1, kSelectZero, kSelectOne));
+    return Swizzle(value, to, EncodeSwizzle(0, 1, 2, kSelectOne)); // vec3 -> vec4
+}
+
+Operand ProgramBuilder::Component(const Operand& value, int component) {
+    if (component == 0) return { value.reg, PinType::Float };
+    return Swizzle(value, PinType::Float, EncodeSwizzle(static_cast<uint32_t>(component)));
+}
+
+Operand ProgramBuilder::Combine(const std::vector<Operand>& scalars) {
+    const PinType type = GetVectorType(static_cast<int>(scalars.size()));
+    VirtualInstruction instruction;
+    instruction.op = MaterialOp::Combine;
+    instruction.components = static_cast<uint8_t>(scalars.size());
+    instruction.dst = m_NextRegister++;
+    for (const Operand& scalar : scalars) {
+        instruction.src[instruction.sourceCount++] = scalar.reg;
+    }
+    m_Code.push_back(instruction);
+    return { instruction.dst, type };
+}
+
+bool ProgramBuilder::Fail(const std::string& message) {
+    if (m_Error.empty()) m_Error = message;
+    return false;
+}
+
+Operand ProgramBuilder::In(const MaterialNode& node, size_t index, PinType type) {
+    if (index >= node.inputPins.size()) return Constant(glm::vec4(0.0f), type);
+    const PinID pinId = node.inputPins[index];
+    const MaterialPin* pin = m_Graph.GetPin(pinId);
+    if (!pin) return Constant(glm::vec4(0.0f), type);
+
+    const LinkID linkId = m_Graph.FindLinkByEndPin(pinId);
+    const MaterialLink* link = linkId != INVALID_LINK_ID ? m_Graph.GetLink(linkId) : nullptr;
+    if (link) {
+        const MaterialNode* source = m_Graph.GetNode(m_Graph.GetPinNodeId(link->startPinId));
+        if (!source || !CompileNode(*source)) return Constant(glm::vec4(0.0f), type);
+        auto it = m_PinValues.find(link->startPinId);
+        if (it == m_PinValues.end()) {
+            Fail(std::string("No CPU value for an output of ") + GetNodeTypeName(source->type));
+            return Constant(glm::vec4(0.0f), type);
+        }
+        return Convert(it->second, type);
+    }
+    return Convert(Constant(ReadPinValue(pin->defaultValue, pin->type), pin->type), type);
+}
+
+void ProgramBuilder::Set(const MaterialNode& node, size_t outputIndex, const Operand& value) {
+    if (outputIndex < node.outputPins.size()) m_PinValues[node.outputPins[outputIndex]] = value;
+}
+
+bool ProgramBuilder::CompileNode(const MaterialNode& node) {
+    uint8_t& state = m_NodeState[node.id];
+    if (state == 2) return true;
+    if (state == 1) return Fail("Cycle detected in material graph");
+    state = 1;
+
+    constexpr PinType F = PinType::Float;
+    constexpr PinType V2 = PinType::Vec2;
+    constexpr PinType V3 = PinType::Vec3;
+    constexpr PinType V4 = PinType::Vec4;
+    auto input = [&](MaterialProgramInput which, PinType type) {
+        return Emit(MaterialOp::Input, type, {}, static_cast<uint32_t>(which));
+    };
+    auto unary = [&](MaterialOp op, PinType type) { Set(node, 0, Emit(op, type, { In(node, 0, type) })); };
+    auto binary = [&](MaterialOp op, PinType type) {
+        Set(node, 0, Emit(op, type, { In(node, 0, type), In(node, 1, type) }));
+    };
+
+    switch (node.type) {
+        case NodeType::UV: Set(node, 0, input(MaterialProgramInput::UV, V2)); break;
+        case NodeType::WorldPosition: Set(node, 0, input(MaterialProgramInput::WorldPosition, V3)); break;
+        case NodeType::WorldNormal: Set(node, 0, input(MaterialProgramInput::WorldNormal, V3)); break;
+        case NodeType::ViewDirection: Set(node, 0, input(MaterialProgramInput::ViewDirection, V3)); break;
+        // Placeholders in the GLSL backend
+        case NodeType::VertexColor: Set(node, 0, Constant(glm::vec4(1.0f), V4)); break;
+        case NodeType::Time: Set(node, 0, Constant(0.0f)); break;
+
+        case NodeType::ConstFloat: Set(node, 0, Constant(ReadPinValue(node.parameter, F), F)); break;
+        case NodeType::ConstVec2: Set(node, 0, Constant(ReadPinValue(node.parameter, V2), V2)); break;
+        case NodeType::ConstVec3: Set(node, 0, Constant(ReadPinValue(node.parameter, V3), V3)); break;
+        case NodeType::ConstVec4: Set(node, 0, Constant(ReadPinValue(node.parameter, V4), V4)); break;
+
+        case NodeType::Texture2D: {
+            // Unconnected UVs default to the mesh UVs
+            const Operand uv = IsConnected(node.inputPins[0]) ? In(node, 0, V2) : input(MaterialProgramInput::UV, V2);
+            uint32_t slot = 0;
+            if (auto* path = std::get_if<std::string>(&node.parameter)) {
+                const auto& slots = m_Graph.GetTextureSlots();
+                for (size_t i = 0; i < slots.size(); ++i) {
+                    if (slots[i].path == *path) {
+                        slot = static_cast<uint32_t>(i);
+                        break;
+                    }
+                }
+            }
+            const Operand texel = Emit(MaterialOp::Texture, V4, { uv }, slot);
+            Set(node, 0, { texel.reg, V3 });
+            for (int c = 0; c < 4; ++c) Set(node, 1 + c, Component(texel, c));
+            break;
+        }
+        case NodeType::NormalMap:
+            // The GLSL backend does not sample normal maps yet and passes the surface normal through
+            Set(node, 0, input(MaterialProgramInput::WorldNormal, V3));
+            break;
+
+        case NodeType::Noise: {
+            int noiseType = 0;
+            glm::vec4 p(5.0f, 4.0f, 0.5f, 0.0f); // scale, detail, roughness, distortion
+            if (auto* v = std::get_if<glm::vec4>(&node.parameter)) {
+                p = *v;
+            } else if (auto* s = std::get_if<std::string>(&node.parameter)) {
+                (void)ParseNoise2Param(*s, noiseType, p);
+            }
+            // Unconnected inputs use the node parameter; the coordinate defaults to the UVs
+            auto param = [&](size_t index, float value) {
+                return IsConnected(node.inputPins[index]) ? In(node, index, F) : Constant(value);
+            };
+            const Operand coord = IsConnected(node.inputPins[0])
+                ? In(node, 0, V3) : Convert(input(MaterialProgramInput::UV, V2), V3);
+            const Operand scaled = Emit(MaterialOp::Multiply, V3, { coord, Convert(param(1, p.x), V3) });
+            const Operand distorted = Emit(MaterialOp::NoiseDistort, V3, { scaled, param(4, p.w) });
+            const uint32_t type = noiseType >= 0 && noiseType <= 3 ? static_cast<uint32_t>(noiseType) : 0;
+            const Operand value = Emit(MaterialOp::Noise, F, { distorted, param(2, p.y), param(3, p.z) }, type);
+            Set(node, 0, value);
+            Set(node, 1, Convert(value, V3));
+            break;
+        }
+
+        case NodeType::ColorRamp: {
+            const uint32_t ramp = static_cast<uint32_t>(m_Program.ramps.size());
+            m_Program.ramps.push_back(ParseRamp(node.parameter));
+            const Operand color = Emit(MaterialOp::ColorRamp, V4, { In(node, 0, F) }, ramp);
+            Set(node, 0, { color.reg, V3 });
+            Set(node, 1, Constant(1.0f));
+            break;
+        }
+
+        case NodeType::Add: binary(MaterialOp::Add, V3); break;
+        case NodeType::Subtract: binary(MaterialOp::Subtract, V3); break;
+        case NodeType::Multiply: binary(MaterialOp::Multiply, V3); break;
+        case NodeType::Divide: {
+            const Operand b = Emit(MaterialOp::Max, V3, { In(node, 1, V3), Constant(glm::vec4(0.0001f), V3) });
+            Set(node, 0, Emit(MaterialOp::Divide, V3, { In(node, 0, V3), b }));
+            break;
+        }
+        case NodeType::Lerp:
+            Set(node, 0, Emit(MaterialOp::Mix, V3, { In(node, 0, V3), In(node, 1, V3), Convert(In(node, 2, F), V3) }));
+            break;
+        case NodeType::Remap: {
+            const Operand v = In(node, 0, F);
+            const Operand inMin = In(node, 1, F);
+            const Operand range = Emit(MaterialOp::Max, F, { Emit(MaterialOp::Subtract, F, { In(node, 2, F), inMin }), Constant(0.0001f) });
+            const Operand t = Emit(MaterialOp::Divide, F, { Emit(MaterialOp::Subtract, F, { v, inMin }), range });
+            const Operand saturated = Emit(MaterialOp::Clamp, F, { t, Constant(0.0f), Constant(1.0f) });
+            Set(node, 0, Emit(MaterialOp::Mix, F, { In(node, 3, F), In(node, 4, F), saturated }));
+            break;
+        }
+        case NodeType::Step: binary(MaterialOp::Step, F); break;
+        case NodeType::Smoothstep:
+            Set(node, 0, Emit(MaterialOp::Smoothstep, F, { In(node, 0, F), In(node, 1, F), In(node, 2, F) }));
+            break;
+        case NodeType::Sin: unary(MaterialOp::Sin, F); break;
+        case NodeType::Cos: unary(MaterialOp::Cos, F); break;
+        case NodeType::Clamp:
+            Set(node, 0, Emit(MaterialOp::Clamp, F, { In(node, 0, F), In(node, 1, F), In(node, 2, F) }));
+            break;
+        case NodeType::OneMinus: Set(node, 0, Emit(MaterialOp::Subtract, F, { Constant(1.0f), In(node, 0, F) })); break;
+        case NodeType::Abs: unary(MaterialOp::Abs, F); break;
+        case NodeType::Power: binary(MaterialOp::Pow, F); break;
+        case NodeType::Min: binary(MaterialOp::Min, V3); break;
+        case NodeType::Max: binary(MaterialOp::Max, V3); break;
+        case NodeType::Saturate:
+            Set(node, 0, Emit(MaterialOp::Clamp, V3, { In(node, 0, V3), Constant(glm::vec4(0.0f), V3), Constant(glm::vec4(1.0f), V3) }));
+            break;
+        case NodeType::Sqrt: Set(node, 0, Emit(MaterialOp::Sqrt, F, { Emit(MaterialOp::Max, F, { In(node, 0, F), Constant(0.0f) }) })); break;
+        case NodeType::Floor: unary(MaterialOp::Floor, F); break;
+        case NodeType::Ceil: unary(MaterialOp::Ceil, F); break;
+        case NodeType::Fract: unary(MaterialOp::Fract, F); break;
+        case NodeType::Mod:
+            Set(node, 0, Emit(MaterialOp::Mod, F, { In(node, 0, F), Emit(MaterialOp::Max, F, { In(node, 1, F), Constant(0.0001f) }) }));
+            break;
+        case NodeType::Exp: unary(MaterialOp::Exp, F); break;
+        case NodeType::Log: Set(node, 0, Emit(MaterialOp::Log, F, { Emit(MaterialOp::Max, F, { In(node, 0, F), Constant(0.000001f) }) })); break;
+        case NodeType::Negate: unary(MaterialOp::Negate, F); break;
+
+        case NodeType::Dot: Set(node, 0, Emit(MaterialOp::Dot3, F, { In(node, 0, V3), In(node, 1, V3) })); break;
+        case NodeType::Normalize: unary(MaterialOp::Normalize3, V3); break;
+        case NodeType::Length: Set(node, 0, Emit(MaterialOp::Length3, F, { In(node, 0, V3) })); break;
+        case NodeType::Cross: binary(MaterialOp::Cross, V3); break;
+        case NodeType::Reflect: {
+            const Operand n = Emit(MaterialOp::Normalize3, V3, { In(node, 1, V3) });
+            Set(node, 0, Emit(MaterialOp::Reflect, V3, { In(node, 0, V3), n }));
+            break;
+        }
+        case NodeType::Refract: {
+            const Operand n = Emit(MaterialOp::Normalize3, V3, { In(node, 1, V3) });
+            Set(node, 0, Emit(MaterialOp::Refract, V3, { In(node, 0, V3), n, In(node, 2, F) }));
+            break;
+        }
+        case NodeType::Fresnel: {
+            const Operand n = input(MaterialProgramInput::WorldNormal, V3);
+            const Operand v = input(MaterialProgramInput::ViewDirection, V3);
+            const Operand cosine = Emit(MaterialOp::Clamp, F, { Emit(MaterialOp::Dot3, F, { n, v }), Constant(0.0f), Constant(1.0f) });
+            const Operand base = Emit(MaterialOp::Subtract, F, { Constant(1.0f), cosine });
+            Set(node, 0, Emit(MaterialOp::Pow, F, { base, In(node, 0, F) }));
+            break;
+        }
+
+        case NodeType::SeparateVec2:
+        case NodeType::SeparateVec3:
+        case NodeType::SeparateVec4: {
+            const int n = node.type == NodeType::SeparateVec2 ? 2 : (node.type == NodeType::SeparateVec3 ? 3 : 4);
+            const Operand v = In(node, 0, GetVectorType(n));
+            for (int c = 0; c < n; ++c) Set(node, c, Component(v, c));
+            break;
+        }
+        case NodeType::CombineVec2: Set(node, 0, Combine({ In(node, 0, F), In(node, 1, F) })); break;
+        case NodeType::CombineVec3: Set(node, 0, Combine({ In(node, 0, F), In(node, 1, F), In(node, 2, F) })); break;
+        case NodeType::CombineVec4:
+            Set(node, 0, Combine({ In(node, 0, F), In(node, 1, F), In(node, 2, F), In(node, 3, F) }));
+            break;
+
+        case NodeType::Reroute: Set(node, 0, In(node, 0, V3)); break;
+        case NodeType::FloatToVec3: Set(node, 0, In(node, 0, V3)); break;
+        case NodeType::Vec3ToFloat: Set(node, 0, In(node, 0, F)); break;
+        case NodeType::Vec2ToVec3: {
+            const Operand v = In(node, 0, V2);
+            Set(node, 0, Combine({ Component(v, 0), Component(v, 1), In(node, 1, F) }));
+            break;
+        }
+        case NodeType::Vec3ToVec4: {
+            const Operand v = In(node, 0, V3);
+            Set(node, 0, Combine({ Component(v, 0), Component(v, 1), Component(v, 2), In(node, 1, F) }));
+            break;
+        }
+        case NodeType::Vec4ToVec3: Set(node, 0, In(node, 0, V3)); break;
+
+        case NodeType::CustomCode:
+            if (!CompileCustomCode(node)) return false;
+            break;
+
+        case NodeType::PBROutput:
+        case NodeType::VolumetricOutput:
+        case NodeType::Frame:
+            break;
+    }
+
+    state = 2;
+    return !Failed();
+}
+
+// ============================================================================
+// CustomCode
+// ============================================================================
+// Lowered from the shared compiled form (CustomCode.h), which resolves names and folds constants
+
+bool ProgramBuilder::CompileCustomCode(const MaterialNode& node) {
+    const std::shared_ptr<const CompiledCustomCode> code = GetCompiledCustomCode(m_Graph, node);
+    if (!code->IsValid()) return Fail(code->error);
+
+    std::vector<Operand> values;
+    values.reserve(code->exprs.size());
+    for (const CustomCodeExpr& e : code->exprs) {
+        auto arg = [&](int i) { return values[e.args[i]]; };
+        switch (e.op) {
+            case MaterialOp::Constant: values.push_back(Constant(e.value, e.type)); break;
+            case MaterialOp::Input: values.push_back(In(node, e.imm, e.type)); break;
+            case MaterialOp::Combine: {
+                std::vector<Operand> scalars;
+                for (int i = 0; i < e.argCount; ++i) scalars.push_back(arg(i));
+                values.push_back(Combine(scalars));
+                break;
+            }
+            default:
+                if (e.argCount == 1) values.push_back(Emit(e.op, e.type, { arg(0) }, e.imm));
+                else if (e.argCount == 2) values.push_back(Emit(e.op, e.type, { arg(0), arg(1) }, e.imm));
+                else values.push_back(Emit(e.op, e.type, { arg(0), arg(1), arg(2) }, e.imm));
+                break;
+        }
+        if (Failed()) return false;
+    }
+
+    for (size_t i = 0; i < node.outputPins.size() && i < code->outputs.size(); ++i) {
+        const MaterialPin* pin = m_Graph.GetPin(node.outputPins[i]);
+        if (pin) Set(node, i, { values[code->outputs[i]].reg, pin->type });
+    }
+    return true;
+}
+
+// ============================================================================
+// Register allocation
+// ============================================================================
+
+bool ProgramBuilder::AllocateRegisters(std::vector<Operand>& outputs) {
+    // Dead code: instructions whose result no output depends on
+    std::vector<bool> live(m_NextRegister, false);
+    for (const Operand& output : outputs) live[output.reg] = true;
+    std::vector<bool> keep(m_Code.size(), false);
+    for (size_t i = m_Code.size(); i-- > 0;) {
+        const VirtualInstruction& instruction = m_Code[i];
+        if (!live[instruction.dst]) continue;
+        keep[i] = true;
+        for (uint32_t s = 0; s < instruction.sourceCount; ++s) live[instruction.src[s]] = true;
+    }
+
+    constexpr size_t kLiveToEnd = std::numeric_limits<size_t>::max();
+    std::vector<size_t> lastUse(m_NextRegister, 0);
+    for (size_t i = 0; i < m_Code.size(); ++i) {
+        if (!keep[i]) continue;
+        for (uint32_t s = 0; s < m_Code[i].sourceCount; ++s) lastUse[m_Code[i].src[s]] = i;
+    }
+    for (const Operand& output : outputs) lastUse[output.reg] = kLiveToEnd;
+
+    // Linear scan. The destination is assigned before the sources that die at the instruction are
+    // released, so no instruction writes a register it reads.
+    std::vector<uint32_t> physical(m_NextRegister, 0);
+    std::vector<uint32_t> freeRegisters;
+    uint32_t registerCount = 0;
+    m_Program.instructions.clear();
+    for (size_t i = 0; i < m_Code.size(); ++i) {
+        if (!keep[i]) continue;
+        const VirtualInstruction& v = m_Code[i];
+
+        MaterialInstruction instruction;
+        instruction.op = v.op;
+        instruction.components = v.components;
+        instruction.imm = v.imm;
+        for (uint32_t s = 0; s < v.sourceCount; ++s) {
+            instruction.src[s] = static_cast<uint16_t>(physical[v.src[s]]);
+        }
+        uint32_t dst = 0;
+        if (!freeRegisters.empty()) {
+            dst = freeRegisters.back();
+            freeRegisters.pop_back();
+        } else {
+            dst = registerCount++;
+        }
+        if (dst > std::numeric_limits<uint16_t>::max()) return Fail("Material program needs too many registers");
+        physical[v.dst] = dst;
+        instruction.dst = static_cast<uint16_t>(dst);
+        m_Program.instructions.push_back(instruction);
+
+        for (uint32_t s = 0; s < v.sourceCount; ++s) {
+            const uint32_t source = v.src[s];
+            const bool firstMention = std::find(v.src, v.src + s, source) == v.src + s;
+            if (firstMention && lastUse[source] == i) freeRegisters.push_back(physical[source]);
+        }
+    }
+
+    m_Program.registerCount = registerCount;
+    for (Operand& output : outputs) output.reg = physical[output.reg];
+    return true;
+}
+
+bool ProgramBuilder::Build() {
+    const MaterialNode* outputNode = m_Graph.GetNode(m_Graph.GetActiveOutputNodeId());
+    if (!outputNode) return Fail("No output node");
+
+    std::vector<Operand> outputs;
+    for (size_t i = 0; i < outputNode->inputPins.size(); ++i) {
+        const MaterialPin* pin = m_Graph.GetPin(outputNode->inputPins[i]);
+        if (!pin || GetPinTypeComponents(pin->type) == 0) continue;
+        outputs.push_back(In(*outputNode, i, pin->type));
+        if (Failed()) return false;
+
+        MaterialProgramOutput output;
+        output.name = pin->name;
+        output.type = pin->type;
+        output.row = m_Program.outputRowCount;
+        m_Program.outputs.push_back(output);
+        m_Program.outputRowCount += static_cast<uint32_t>(GetPinTypeComponents(pin->type));
+    }
+
+    if (!AllocateRegisters(outputs)) return false;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        m_Program.outputs[i].reg = static_cast<uint16_t>(outputs[i].reg);
+    }
+    return true;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+// Each instruction runs over all lanes of a batch before the next, as plain loops over contiguous
+// floats that the compiler vectorizes.
+
+template <typename Fn>
+void Lanes1(float* d, const float* a, uint32_t n, Fn fn) {
+    for (uint32_t i = 0; i < n; ++i) d[i] = fn(a[i]);
+}
+
+template <typename Fn>
+void Lanes2(float* d, const float* a, const float* b, uint32_t n, Fn fn) {
+    for (uint32_t i = 0; i < n; ++i) d[i] = fn(a[i], b[i]);
+}
+
+template <typename Fn>
+void Lanes3(float* d, const float* a, const float* b, const float* c, uint32_t n, Fn fn) {
+    for (uint32_t i = 0; i < n; ++i) d[i] = fn(a[i], b[i], c[i]);
+}
+
+class Registers {
+public:
+    explicit Registers(uint32_t count) : m_Values(static_cast<size_t>(count) * 4 * MaterialProgram::kLanes, 0.0f) {}
+
+    float* Get(uint32_t reg, uint32_t component) {
+        return m_Values.data() + (static_cast<size_t>(reg) * 4 + component) * MaterialProgram::kLanes;
+    }
+
+private:
+    std::vector<float> m_Values;
+};
+
+void LoadInput(const float* const* streams, uint32_t componentCount, const glm::vec4& fallback,
+               uint32_t base, uint32_t n, float* const* dst) {
+    for (uint32_t c = 0; c < componentCount; ++c) {
+        if (streams[c]) std::copy(streams[c] + base, streams[c] + base + n, dst[c]);
+        else std::fill(dst[c], dst[c] + n, fallback[c]);
+    }
+}
+
+void NormalizeLanes(float* x, float* y, float* z, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        const float length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+        x[i] *= scale;
+        y[i] *= scale;
+        z[i] *= scale;
+    }
+}
+
+void ExecuteInstruction(const MaterialProgram& program, const MaterialInstruction& in, Registers& r,
+                        const MaterialShadingPoints& points, uint32_t base, uint32_t n) {
+    const uint32_t components = in.components;
+    auto d = [&](uint32_t c) { return r.Get(in.dst, c); };
+    auto s = [&](uint32_t index, uint32_t c) { return r.Get(in.src[index], c); };
+    auto each1 = [&](auto fn) { for (uint32_t c = 0; c < components; ++c) Lanes1(d(c), s(0, c), n, fn); };
+    auto each2 = [&](auto fn) { for (uint32_t c = 0; c < components; ++c) Lanes2(d(c), s(0, c), s(1, c), n, fn); };
+    auto each3 = [&](auto fn) {
+        for (uint32_t c = 0; c < components; ++c) Lanes3(d(c), s(0, c), s(1, c), s(2, c), n, fn);
+    };
+
+    switch (in.op) {
+        case MaterialOp::Constant:
+            for (uint32_t c = 0; c < components; ++c) std::fill(d(c), d(c) + n, program.constants[in.imm][c]);
+            break;
+        case MaterialOp::Input: {
+            float* dst[3] = { d(0), d(1), components > 2 ? d(2) : nullptr };
+            switch (static_cast<MaterialProgramInput>(in.imm)) {
+                case MaterialProgramInput::UV:
+                    LoadInput(points.uv, 2, glm::vec4(0.0f), base, n, dst);
+                    break;
+                case MaterialProgramInput::WorldPosition:
+                    LoadInput(points.position, 3, glm::vec4(0.0f), base, n, dst);
+                    break;
+                case MaterialProgramInput::WorldNormal:
+                    LoadInput(points.normal, 3, glm::vec4(0.0f, 0.0f, 1.0f, 0.0f), base, n, dst);
+                    NormalizeLanes(dst[0], dst[1], dst[2], n);
+                    break;
+                case MaterialProgramInput::ViewDirection:
+                    LoadInput(points.viewDirection, 3, glm::vec4(0.0f, 0.0f, 1.0f, 0.0f), base, n, dst);
+                    NormalizeLanes(dst[0], dst[1], dst[2], n);
+                    break;
+            }
+            break;
+        }
+        case MaterialOp::Swizzle:
+            for (uint32_t c = 0; c < components; ++c) {
+                const uint32_t selector = (in.imm >> (3 * c)) & 7u;
+                if (selector < 4) std::copy(s(0, selector), s(0, selector) + n, d(c));
+                else std::fill(d(c), d(c) + n, selector == kSelectOne ? 1.0f : 0.0f);
+            }
+            break;
+        case MaterialOp::Combine:
+            for (uint32_t c = 0; c < components; ++c) std::copy(s(c, 0), s(c, 0) + n, d(c));
+            break;
+
+        case MaterialOp::Add: each2([](float a, float b) { return a + b; }); break;
+        case MaterialOp::Subtract: each2([](float a, float b) { return a - b; }); break;
+        case MaterialOp::Multiply: each2([](float a, float b) { return a * b; }); break;
+        case MaterialOp::Divide: each2([](float a, float b) { return a / b; }); break;
+        case MaterialOp::Negate: each1([](float a) { return -a; }); break;
+        case MaterialOp::Min: each2([](float a, float b) { return std::min(a, b); }); break;
+        case MaterialOp::Max: each2([](float a, float b) { return std::max(a, b); }); break;
+        case MaterialOp::Clamp: each3([](float x, float lo, float hi) { return std::min(std::max(x, lo), hi); }); break;
+        case MaterialOp::Mix: each3([](float a, float b, float t) { return a * (1.0f - t) + b * t; }); break;
+        case MaterialOp::Abs: each1([](float a) { return std::fabs(a); }); break;
+        case MaterialOp::Floor: each1([](float a) { return std::floor(a); }); break;
+        case MaterialOp::Ceil: each1([](float a) { return std::ceil(a); }); break;
+        case MaterialOp::Fract: each1([](float a) { return a - std::floor(a); }); break;
+        case MaterialOp::Mod: each2([](float a, float b) { return a - b * std::floor(a / b); }); break;
+        case MaterialOp::Sqrt: each1([](float a) { return std::sqrt(a); }); break;
+        case MaterialOp::Exp: each1([](float a) { return std::exp(a); }); break;
+        case MaterialOp::Log: each1([](float a) { return std::log(a); }); break;
+        case MaterialOp::Sin: each1([](float a) { return std::sin(a); }); break;
+        case MaterialOp::Cos: each1([](float a) { return std::cos(a); }); break;
+        case MaterialOp::Pow: each2([](float a, float b) { return std::pow(a, b); }); break;
+        case MaterialOp::Step: each2([](float edge, float x) { return x < edge ? 0.0f : 1.0f; }); break;
+        case MaterialOp::Smoothstep:
+            each3([](float e0, float e1, float x) {
+                const float t = std::clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+                return t * t * (3.0f - 2.0f * t);
+            });
+            break;
+
+        case MaterialOp::Dot3: {
+            const float *ax = s(0, 0), *ay = s(0, 1), *az = s(0, 2);
+            const float *bx = s(1, 0), *by = s(1, 1), *bz = s(1, 2);
+            float* out = d(0);
+            for (uint32_t i = 0; i < n; ++i) out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+            break;
+        }
+        case MaterialOp::Length3: {
+            const float *x = s(0, 0), *y = s(0, 1), *z = s(0, 2);
+            float* out = d(0);
+            for (uint32_t i = 0; i < n; ++i) out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            break;
+        }
+        case MaterialOp::Normalize3:
+            for (uint32_t c = 0; c < 3; ++c) std::copy(s(0, c), s(0, c) + n, d(c));
+            NormalizeLanes(d(0), d(1), d(2), n);
+            break;
+        case MaterialOp::Cross: {
+            const float *ax = s(0, 0), *ay = s(0, 1), *az = s(0, 2);
+            const float *bx = s(1, 0), *by = s(1, 1), *bz = s(1, 2);
+            float *x = d(0), *y = d(1), *z = d(2);
+            for (uint32_t i = 0; i < n; ++i) {
+                x[i] = ay[i] * bz[i] - az[i] * by[i];
+                y[i] = az[i] * bx[i] - ax[i] * bz[i];
+                z[i] = ax[i] * by[i] - ay[i] * bx[i];
+            }
+            break;
+        }
+        case MaterialOp::Reflect:
+        case MaterialOp::Refract: {
+            const float *ix = s(0, 0), *iy = s(0, 1), *iz = s(0, 2);
+            const float *nx = s(1, 0), *ny = s(1, 1), *nz = s(1, 2);
+            const float* eta = in.op == MaterialOp::Refract ? s(2, 0) : nullptr;
+            float *x = d(0), *y = d(1), *z = d(2);
+            for (uint32_t i = 0; i < n; ++i) {
+                const float dot = nx[i] * ix[i] + ny[i] * iy[i] + nz[i] * iz[i];
+                if (!eta) {
+                    x[i] = ix[i] - 2.0f * dot * nx[i];
+                    y[i] = iy[i] - 2.0f * dot * ny[i];
+                    z[i] = iz[i] - 2.0f * dot * nz[i];
+                    continue;
+                }
+                const float k = 1.0f - eta[i] * eta[i] * (1.0f - dot * dot);
+                const float a = k < 0.0f ? 0.0f : eta[i];
+                const float b = k < 0.0f ? 0.0f : eta[i] * dot + std::sqrt(k);
+                x[i] = a * ix[i] - b * nx[i];
+                y[i] = a * iy[i] - b * ny[i];
+                z[i] = a * iz[i] - b * nz[i];
+            }
+            break;
+        }
+
+        case MaterialOp::NoiseDistort: {
+            const float *px = s(0, 0), *py = s(0, 1), *pz = s(0, 2), *distort = s(1, 0);
+            float *x = d(0), *y = d(1), *z = d(2);
+            for (uint32_t i = 0; i < n; ++i) {
+                x[i] = px[i];
+                y[i] = py[i];
+                z[i] = pz[i];
+                if (distort[i] > 0.0f) {
+                    x[i] += distort[i] * ValueNoise3(px[i] + 31.7f, py[i] + 31.7f, pz[i] + 31.7f);
+                    y[i] += distort[i] * ValueNoise3(px[i] + 17.3f, py[i] + 17.3f, pz[i] + 17.3f);
+                    z[i] += distort[i] * ValueNoise3(px[i] + 9.2f, py[i] + 9.2f, pz[i] + 9.2f);
+                }
+            }
+            break;
+        }
+        case MaterialOp::Noise: {
+            const float *px = s(0, 0), *py = s(0, 1), *pz = s(0, 2), *octaves = s(1, 0), *roughness = s(2, 0);
+            float* out = d(0);
+            for (uint32_t i = 0; i < n; ++i) out[i] = Noise3(in.imm, px[i], py[i], pz[i], octaves[i], roughness[i]);
+            break;
+        }
+        case MaterialOp::ColorRamp: {
+            const auto& stops = program.ramps[in.imm];
+            const float* factor = s(0, 0);
+            float* out[4] = { d(0), d(1), d(2), d(3) };
+            for (uint32_t i = 0; i < n; ++i) {
+                // Same piecewise search as the GLSL: the last segment containing t wins
+                const float t = std::clamp(factor[i], stops.front().t, stops.back().t);
+                glm::vec4 color = stops.front().color;
+                for (size_t k = 0; k + 1 < stops.size(); ++k) {
+                    const MaterialRampStop& a = stops[k];
+                    const MaterialRampStop& b = stops[k + 1];
+                    if (t >= a.t && t <= b.t) {
+                        const float u = std::clamp((t - a.t) / std::max(b.t - a.t, 1e-6f), 0.0f, 1.0f);
+                        color = a.color * (1.0f - u) + b.color * u;
+                    }
+                }
+                for (int c = 0; c < 4; ++c) out[c][i] = color[c];
+            }
+            break;
+        }
+        case MaterialOp::Texture: {
+            float* const rgba[4] = { d(0), d(1), d(2), d(3) };
+            if (points.sampleTexture) {
+                points.sampleTexture(in.imm, s(0, 0), s(0, 1), n, rgba);
+            } else {
+                const glm::vec4 missing(1.0f, 0.0f, 1.0f, 1.0f);
+                for (int c = 0; c < 4; ++c) std::fill(rgba[c], rgba[c] + n, missing[c]);
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+const MaterialProgramOutput* MaterialProgram::FindOutput(const std::string& name) const {
+    for (const MaterialProgramOutput& output : outputs) {
+        if (output.name == name) return &output;
+    }
+    return nullptr;
+}
+
+void MaterialProgram::Execute(const MaterialShadingPoints& points, float* outputValues) const {
+    Registers registers(registerCount);
+    for (uint32_t base = 0; base < points.count; base += kLanes) {
+        const uint32_t n = std::min(kLanes, points.count - base);
+        for (const MaterialInstruction& instruction : instructions) {
+            ExecuteInstruction(*this, instruction, registers, points, base, n);
+        }
+        for (const MaterialProgramOutput& output : outputs) {
+            for (int c = 0; c < GetPinTypeComponents(output.type); ++c) {
+                const float* values = registers.Get(output.reg, static_cast<uint32_t>(c));
+                std::copy(values, values + n, outputValues + static_cast<size_t>(output.row + c) * points.count + base);
+            }
+        }
+    }
+}
+
+bool CompileMaterialProgram(const MaterialGraph& sourceGraph, MaterialProgram& outProgram, std::string& outError) {
+    LUCENT_PROFILE_FUNCTION();
+    outError.clear();
+    outProgram = MaterialProgram{};
+    outProgram.domain = sourceGraph.GetDomain();
+
+    const MaterialGraph graph = OptimizeMaterialGraph(sourceGraph);
+    ProgramBuilder builder(graph, outProgram, outError);
+    if (!builder.Build()) {
+        if (outError.empty()) outError = "Failed to compile material program";
+        outProgram = MaterialProgram{};
+        return false;
+    }
+    return true;
+}
+
+} // namespace lucent::material
@@ -0,0 +1,793 @@
+#include "lucent/material/RTMaterialCompiler.h"
+#include "lucent/material/CustomCode.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace lucent::material {
+
+bool CompileRTMaterialProgram(const MaterialGraph& graph, gfx::RTMaterialHeader& outHeader,
+                              std::pmr::vector<gfx::RTMaterialInstr>& outInstrs, std::string& outError,
+                              const RTTextureSlotFunction& textureSlot) {
+    outHeader = gfx::RTMaterialHeader{};
+    outInstrs.clear();
+    outError.clear();
+
+    // V1: surface-only
+    if (graph.GetDomain() == MaterialDomain::Volume) {
+        outError = "Volume domain not supported for RT per-hit evaluation";
+        return false;
+    }
+
+    const NodeID outNodeId = graph.GetOutputNodeId();
+    const MaterialNode* outNode = graph.GetNode(outNodeId);
+    if (!outNode || outNode->type != NodeType::PBROutput) {
+        outError = "Missing PBR output node";
+        return false;
+    }
+
+    // ---------------------------------------------------------------------
+    // RT material IR opcodes (must match `shaders/rt_closesthit.rchit`)
+    // ---------------------------------------------------------------------
+    constexpr uint32_t OP_CONST       = 1u;
+    constexpr uint32_t OP_UV          = 2u;
+    constexpr uint32_t OP_TEX2D       = 3u;
+    constexpr uint32_t OP_ADD         = 4u;
+    constexpr uint32_t OP_MUL         = 5u;
+    constexpr uint32_t OP_LERP        = 6u;
+    constexpr uint32_t OP_CLAMP       = 7u;
+    constexpr uint32_t OP_SATURATE    = 8u;
+    constexpr uint32_t OP_ONEMINUS    = 9u;
+    constexpr uint32_t OP_SWIZZLE     = 10u; // texIndex: 0=x,1=y,2=z,3=w,4=xyz (w=1)
+    constexpr uint32_t OP_COMBINE3    = 11u;
+    constexpr uint32_t OP_FRESNEL     = 12u;
+    constexpr uint32_t OP_SUB         = 13u;
+    constexpr uint32_t OP_DIV         = 14u;
+    constexpr uint32_t OP_POW         = 15u;
+    // NOTE: Remap is expanded into primitive ops on the CPU side (keeps interpreter simpler)
+    constexpr uint32_t OP_STEP        = 17u;
+    constexpr uint32_t OP_SMOOTHSTEP  = 18u;
+    constexpr uint32_t OP_SIN         = 19u;
+    constexpr uint32_t OP_COS         = 20u;
+    constexpr uint32_t OP_ABS         = 21u;
+    constexpr uint32_t OP_MIN         = 22u;
+    constexpr uint32_t OP_MAX         = 23u;
+    constexpr uint32_t OP_SQRT        = 24u;
+    constexpr uint32_t OP_FLOOR       = 25u;
+    constexpr uint32_t OP_CEIL        = 26u;
+    constexpr uint32_t OP_FRACT       = 27u;
+    constexpr uint32_t OP_MOD         = 28u;
+    constexpr uint32_t OP_EXP         = 29u;
+    constexpr uint32_t OP_LOG         = 30u;
+    constexpr uint32_t OP_NEGATE      = 31u;
+    constexpr uint32_t OP_DOT         = 32u;
+    constexpr uint32_t OP_NORMALIZE   = 33u;
+    constexpr uint32_t OP_LENGTH      = 34u;
+    constexpr uint32_t OP_CROSS       = 35u;
+    constexpr uint32_t OP_REFLECT     = 36u;
+    constexpr uint32_t OP_REFRACT     = 37u;
+    constexpr uint32_t OP_COMBINE2    = 38u;
+    constexpr uint32_t OP_COMBINE4    = 39u;
+    constexpr uint32_t OP_WORLDPOS    = 40u;
+    constexpr uint32_t OP_WORLDNORM   = 41u;
+    constexpr uint32_t OP_VIEWDIR     = 42u;
+    constexpr uint32_t OP_TIME        = 43u;
+    constexpr uint32_t OP_VCOLOR      = 44u;
+    constexpr uint32_t OP_NORMALMAP   = 45u;
+    constexpr uint32_t OP_NOISE       = 46u; // imm = (scale, detail, roughness, distortion), texIndex selects type
+
+    auto emit = [&](uint32_t type,
+                    uint32_t a = 0, uint32_t b = 0, uint32_t c = 0,
+                    uint32_t texIndex = 0,
+                    const glm::vec4& imm = glm::vec4(0.0f)) -> uint32_t {
+        gfx::RTMaterialInstr ins{};
+        ins.type = type;
+        ins.dst = static_cast<uint32_t>(outInstrs.size()) + 1u;
+        ins.a = a;
+        ins.b = b;
+        ins.c = c;
+        ins.texIndex = texIndex;
+        ins.imm = imm;
+        outInstrs.push_back(ins);
+        // One register per instruction (reg = instrIndex+1 => size); RTMaterialLinker allocates them
+        return static_cast<uint32_t>(outInstrs.size());
+    };
+
+    auto emitConstFromValue = [&](const PinValue& v) -> uint32_t {
+        if (std::holds_alternative<float>(v)) {
+            return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(std::get<float>(v), 0.0f, 0.0f, 0.0f));
+        }
+        if (std::holds_alternative<glm::vec2>(v)) {
+            auto vv = std::get<glm::vec2>(v);
+            return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(vv.x, vv.y, 0.0f, 0.0f));
+        }
+        if (std::holds_alternative<glm::vec3>(v)) {
+            auto vv = std::get<glm::vec3>(v);
+            return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(vv, 1.0f));
+        }
+        if (std::holds_alternative<glm::vec4>(v)) {
+            return emit(OP_CONST, 0, 0, 0, 0, std::get<glm::vec4>(v));
+        }
+        // String / other: not constant-evaluable here
+        return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(0.0f));
+    };
+
+    auto isConnectedInput = [&](const MaterialNode& node, size_t inputIndex) -> bool {
+        if (inputIndex >= node.inputPins.size()) return false;
+        return graph.FindLinkByEndPin(node.inputPins[inputIndex]) != INVALID_LINK_ID;
+    };
+
+    // Helpers for swizzling components from a packed vec4 register.
+    auto emitSwizzle = [&](uint32_t vReg, uint32_t component) -> uint32_t {
+        return emit(OP_SWIZZLE, vReg, 0u, 0u, component);
+    };
+
+    // Cache per-pin output register. Working maps share the caller's (scratch) allocator.
+    std::pmr::memory_resource* workMem = outInstrs.get_allocator().resource();
+    std::pmr::unordered_map<PinID, uint32_t> pinToReg(workMem);
+    std::pmr::unordered_map<PinID, uint8_t> state(workMem); // 0=unvisited, 1=visiting, 2=done
+
+    // CustomCode outputs as scalar registers per component, lowered once per node
+    std::pmr::unordered_map<NodeID, std::pmr::vector<std::array<uint32_t, 4>>> customOutputs(workMem);
+
+    std::function<uint32_t(PinID)> compilePin;
+    compilePin = [&](PinID pinId) -> uint32_t {
+        if (pinId == INVALID_PIN_ID) return 0u;
+
+        auto itCached = pinToReg.find(pinId);
+        if (itCached != pinToReg.end()) return itCached->second;
+
+        uint8_t& st = state[pinId];
+        if (st == 1) {
+            // cycle
+            return 0u;
+        }
+        st = 1;
+
+        const MaterialPin* pin = graph.GetPin(pinId);
+        if (!pin) { st = 2; return 0u; }
+
+        // Input pins resolve to their connected source, or default value
+        if (pin->direction == PinDirection::Input) {
+            LinkID linkId = graph.FindLinkByEndPin(pinId);
+            if (linkId != INVALID_LINK_ID) {
+                const MaterialLink* link = graph.GetLink(linkId);
+                if (link) {
+                    uint32_t r = compilePin(link->startPinId);
+                    pinToReg[pinId] = r;
+                    st = 2;
+                    return r;
+                }
+            }
+            uint32_t r = emitConstFromValue(pin->defaultValue);
+            pinToReg[pinId] = r;
+            st = 2;
+            return r;
+        }
+
+        const MaterialNode* node = graph.GetNode(pin->nodeId);
+        if (!node) { st = 2; return 0u; }
+
+        // Determine which output index this pin is
+        int outIdx = -1;
+        for (int i = 0; i < (int)node->outputPins.size(); ++i) {
+            if (node->outputPins[i] == pinId) { outIdx = i; break; }
+        }
+
+        uint32_t r = 0u;
+        switch (node->type) {
+            // -------------------------------------------------------------
+            // Inputs
+            // -------------------------------------------------------------
+            case NodeType::UV:
+                r = emit(OP_UV);
+                break;
+            case NodeType::WorldPosition:
+                r = emit(OP_WORLDPOS);
+                break;
+            case NodeType::WorldNormal:
+                r = emit(OP_WORLDNORM);
+                break;
+            case NodeType::ViewDirection:
+                r = emit(OP_VIEWDIR);
+                break;
+            case NodeType::Time:
+                r = emit(OP_TIME);
+                break;
+            case NodeType::VertexColor:
+                // RT vertices currently don't carry color; default to white.
+                r = emit(OP_VCOLOR);
+                break;
+
+            case NodeType::ConstFloat:
+            case NodeType::ConstVec2:
+            case NodeType::ConstVec3:
+            case NodeType::ConstVec4:
+                r = emitConstFromValue(node->parameter);
+                break;
+
+            case NodeType::Texture2D:
+            {
+                uint32_t uvReg = 0u;
+                if (!node->inputPins.empty()) {
+                    // If UV is unconnected, leave uvReg = 0 -> shader defaults to mesh UV input
+                    LinkID linkId = graph.FindLinkByEndPin(node->inputPins[0]);
+                    if (linkId != INVALID_LINK_ID) {
+                        uvReg = compilePin(node->inputPins[0]);
+                    }
+                }
+
+                std::string path;
+                if (std::holds_alternative<std::string>(node->parameter)) path = std::get<std::string>(node->parameter);
+
+                bool sRGB = (node->type == NodeType::Texture2D);
+                if (!path.empty()) {
+                    const auto& slots = graph.GetTextureSlots();
+                    for (const auto& slot : slots) {
+                        if (slot.path == path) { sRGB = slot.sRGB; break; }
+                    }
+                }
+
+                const uint32_t texIndex = textureSlot ? textureSlot(path, sRGB) : 0u;
+
+                uint32_t sampleReg = emit(OP_TEX2D, uvReg, 0u, 0u, texIndex);
+
+                // outputs: 0=RGB, 1=R, 2=G, 3=B, 4=A (see MaterialGraph SetupNodePins)
+                uint32_t swz = 4u;
+                if (outIdx == 1) swz = 0u;
+                else if (outIdx == 2) swz = 1u;
+                else if (outIdx == 3) swz = 2u;
+                else if (outIdx == 4) swz = 3u;
+                r = emit(OP_SWIZZLE, sampleReg, 0u, 0u, swz);
+                break;
+            }
+
+            case NodeType::NormalMap: {
+                uint32_t uvReg = 0u;
+                if (!node->inputPins.empty()) {
+                    LinkID linkId = graph.FindLinkByEndPin(node->inputPins[0]);
+                    if (linkId != INVALID_LINK_ID) {
+                        uvReg = compilePin(node->inputPins[0]);
+                    }
+                }
+                uint32_t strengthReg = (node->inputPins.size() >= 2) ? compilePin(node->inputPins[1]) : emit(OP_CONST, 0, 0, 0, 0, glm::vec4(1, 0, 0, 0));
+
+                std::string path;
+                if (std::holds_alternative<std::string>(node->parameter)) path = std::get<std::string>(node->parameter);
+
+                // Normal maps are data textures by default; honor explicit slot sRGB flag if present.
+                bool sRGB = false;
+                if (!path.empty()) {
+                    const auto& slots = graph.GetTextureSlots();
+                    for (const auto& slot : slots) {
+                        if (slot.path == path) { sRGB = slot.sRGB; break; }
+                    }
+                }
+
+                const uint32_t texIndex = textureSlot ? textureSlot(path, sRGB) : 0u;
+
+                r = emit(OP_NORMALMAP, uvReg, strengthReg, 0u, texIndex);
+                break;
+            }
+
+            // -------------------------------------------------------------
+            // Procedural
+            // -------------------------------------------------------------
+            case NodeType::Noise: {
+                // Provide a useful default for Vector when unconnected: vec3(UV, 0)
+                uint32_t vecReg = 0u;
+                if (isConnectedInput(*node, 0)) {
+                    vecReg = compilePin(node->inputPins[0]);
+                } else {
+                    uint32_t uv2 = emit(OP_UV);
+                    uint32_t z0 = emit(OP_CONST, 0, 0, 0, 0, glm::vec4(0, 0, 0, 0));
+                    uint32_t ux = emitSwizzle(uv2, 0u);
+                    uint32_t uy = emitSwizzle(uv2, 1u);
+                    vecReg = emit(OP_COMBINE3, ux, uy, z0);
+                }
+
+                // Parameters: use node.parameter defaults (pins are allowed but not currently dynamic in RT IR)
+                glm::vec4 p = glm::vec4(5.0f, 4.0f, 0.5f, 0.0f); // scale, detail, roughness, distortion
+                if (std::holds_alternative<glm::vec4>(node->parameter)) {
+                    p = std::get<glm::vec4>(node->parameter);
+                }
+
+                uint32_t noiseType = 0u; // 0=fbm,1=value,2=ridged,3=turbulence
+                if (std::holds_alternative<std::string>(node->parameter)) {
+                    // Keep as FBM for now (parameter may be "NOISE2:..." blob)
+                    noiseType = 0u;
+                }
+
+                // Emit noise; pack as vec4(n, n, n, 1)
+                uint32_t n = emit(OP_NOISE, vecReg, 0u, 0u, noiseType, p);
+
+                // outputs: 0=Value (float), 1=Color (vec3)
+                if (outIdx == 0) r = emitSwizzle(n, 0u);
+                else r = emit(OP_SWIZZLE, n, 0u, 0u, 4u);
+                break;
+            }
+
+            case NodeType::Add:
+                r = emit(OP_ADD, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+
+            case NodeType::Subtract:
+                r = emit(OP_SUB, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+
+            case NodeType::Multiply:
+                r = emit(OP_MUL, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+
+            case NodeType::Divide:
+                r = emit(OP_DIV, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+
+            case NodeType::Lerp:
+                r = emit(OP_LERP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
+                break;
+
+            case NodeType::Clamp:
+                r = emit(OP_CLAMP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
+                break;
+
+            case NodeType::Saturate:
+                r = emit(OP_SATURATE, compilePin(node->inputPins[0]));
+                break;
+
+            case NodeType::OneMinus:
+                r = emit(OP_ONEMINUS, compilePin(node->inputPins[0]));
+                break;
+
+            case NodeType::SeparateVec3: {
+                uint32_t v = compilePin(node->inputPins[0]);
+                uint32_t swz = (outIdx == 1) ? 1u : (outIdx == 2) ? 2u : 0u;
+                r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
+                break;
+            }
+
+            case NodeType::CombineVec3:
+                r = emit(OP_COMBINE3, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
+                break;
+
+            case NodeType::Fresnel:
+                // Fresnel term from N·V (view-dependent; evaluated in shader using current hit normal + ray direction)
+                r = emit(OP_FRESNEL, compilePin(node->inputPins[0]));
+                break;
+
+            case NodeType::Power:
+                r = emit(OP_POW, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Remap:
+                // Expand remap to primitive ops:
+                // t = (x - inMin) / (inMax - inMin); out = outMin + t * (outMax - outMin)
+                {
+                    uint32_t x = compilePin(node->inputPins[0]);
+                    uint32_t inMin = compilePin(node->inputPins[1]);
+                    uint32_t inMax = compilePin(node->inputPins[2]);
+                    uint32_t outMin = compilePin(node->inputPins[3]);
+                    uint32_t outMax = compilePin(node->inputPins[4]);
+                    uint32_t denom = emit(OP_SUB, inMax, inMin);
+                    uint32_t num = emit(OP_SUB, x, inMin);
+                    uint32_t t = emit(OP_DIV, num, denom);
+                    uint32_t range = emit(OP_SUB, outMax, outMin);
+                    uint32_t scaled = emit(OP_MUL, t, range);
+                    r = emit(OP_ADD, scaled, outMin);
+                }
+                break;
+            case NodeType::Step:
+                // step(edge, x)
+                r = emit(OP_STEP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Smoothstep:
+                r = emit(OP_SMOOTHSTEP, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
+                break;
+            case NodeType::Sin:
+                r = emit(OP_SIN, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Cos:
+                r = emit(OP_COS, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Abs:
+                r = emit(OP_ABS, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Min:
+                r = emit(OP_MIN, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Max:
+                r = emit(OP_MAX, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Sqrt:
+                r = emit(OP_SQRT, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Floor:
+                r = emit(OP_FLOOR, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Ceil:
+                r = emit(OP_CEIL, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Fract:
+                r = emit(OP_FRACT, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Mod:
+                r = emit(OP_MOD, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Exp:
+                r = emit(OP_EXP, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Log:
+                r = emit(OP_LOG, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Negate:
+                r = emit(OP_NEGATE, compilePin(node->inputPins[0]));
+                break;
+
+            case NodeType::Dot:
+                r = emit(OP_DOT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Normalize:
+                r = emit(OP_NORMALIZE, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Length:
+                r = emit(OP_LENGTH, compilePin(node->inputPins[0]));
+                break;
+            case NodeType::Cross:
+                r = emit(OP_CROSS, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Reflect:
+                r = emit(OP_REFLECT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::Refract:
+                r = emit(OP_REFRACT, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]), compilePin(node->inputPins[2]));
+                break;
+
+            case NodeType::SeparateVec4: {
+                uint32_t v = compilePin(node->inputPins[0]);
+                uint32_t swz = (outIdx == 3) ? 3u : (outIdx == 2) ? 2u : (outIdx == 1) ? 1u : 0u;
+                r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
+                break;
+            }
+            case NodeType::SeparateVec2: {
+                uint32_t v = compilePin(node->inputPins[0]);
+                uint32_t swz = (outIdx == 1) ? 1u : 0u;
+                r = emit(OP_SWIZZLE, v, 0u, 0u, swz);
+                break;
+            }
+            case NodeType::CombineVec2:
+                r = emit(OP_COMBINE2, compilePin(node->inputPins[0]), compilePin(node->inputPins[1]));
+                break;
+            case NodeType::CombineVec4:
+                {
+                    uint32_t rr = compilePin(node->inputPins[0]);
+                    uint32_t gg = compilePin(node->inputPins[1]);
+                    uint32_t bb = compilePin(node->inputPins[2]);
+                    uint32_t aa = compilePin(node->inputPins[3]);
+                    // OP_COMBINE4 takes rgb operands in (a,b,c) and stores alpha operand register in texIndex.
+                    r = emit(OP_COMBINE4, rr, gg, bb, aa);
+                }
+                break;
+
+            case NodeType::FloatToVec3: {
+                uint32_t f = compilePin(node->inputPins[0]);
+                r = emit(OP_COMBINE3, f, f, f);
+                break;
+            }
+
+            case NodeType::Vec3ToFloat: {
+                uint32_t v = compilePin(node->inputPins[0]);
+                r = emit(OP_SWIZZLE, v, 0u, 0u, 0u);
+                break;
+            }
+
+            case NodeType::Vec4ToVec3: {
+                uint32_t v = compilePin(node->inputPins[0]);
+                r = emit(OP_SWIZZLE, v, 0u, 0u, 4u);
+                break;
+            }
+
+            case NodeType::Vec2ToVec3: {
+                uint32_t v2 = compilePin(node->inputPins[0]);
+                uint32_t z = compilePin(node->inputPins[1]);
+                uint32_t x = emitSwizzle(v2, 0u);
+                uint32_t y = emitSwizzle(v2, 1u);
+                r = emit(OP_COMBINE3, x, y, z);
+                break;
+            }
+
+            case NodeType::Vec3ToVec4: {
+                uint32_t v3 = compilePin(node->inputPins[0]);
+                uint32_t a = compilePin(node->inputPins[1]);
+                // Reuse COMBINE4 by swizzling xyz.
+                uint32_t x = emitSwizzle(v3, 0u);
+                uint32_t y = emitSwizzle(v3, 1u);
+                uint32_t z = emitSwizzle(v3, 2u);
+                r = emit(OP_COMBINE4, x, y, z, a);
+                break;
+            }
+
+            case NodeType::ColorRamp: {
+                // Compile a piecewise-linear color ramp into basic ops.
+                // NOTE: Graph stores stops in node.parameter string: "RAMP:t,r,g,b;...".
+                // We output vec4(color.rgb, alpha=1).
+                uint32_t tReg = compilePin(node->inputPins[0]);
+
+                // Parse stops
+                std::vector<std::pair<float, glm::vec3>> stops;
+                if (std::holds_alternative<std::string>(node->parameter)) {
+                    const std::string blob = std::get<std::string>(node->parameter);
+                    const std::string prefix = "RAMP:";
+                    size_t start = (blob.rfind(prefix, 0) == 0) ? prefix.size() : 0;
+                    while (start < blob.size()) {
+                        size_t end = blob.find(';', start);
+                        std::string token = blob.substr(start, end == std::string::npos ? std::string::npos : (end - start));
+                        if (!token.empty()) {
+                            float tt = 0, rr = 1, gg = 1, bb = 1;
+                            if (sscanf_s(token.c_str(), "%f,%f,%f,%f", &tt, &rr, &gg, &bb) == 4) {
+                                stops.push_back({ tt, glm::vec3(rr, gg, bb) });
+                            }
+                        }
+                        if (end == std::string::npos) break;
+                        start = end + 1;
+                    }
+                }
+                if (stops.empty()) {
+                    stops.push_back({ 0.0f, glm::vec3(0.0f) });
+                    stops.push_back({ 1.0f, glm::vec3(1.0f) });
+                }
+                std::sort(stops.begin(), stops.end(), [](auto& a, auto& b) { return a.first < b.first; });
+                // Limit stop count to keep instruction counts bounded
+                if (stops.size() > 8) {
+                    std::vector<std::pair<float, glm::vec3>> reduced;
+                    reduced.reserve(8);
+                    for (size_t i = 0; i < 8; ++i) {
+                        size_t idx = (i * (stops.size() - 1)) / 7;
+                        reduced.push_back(stops[idx]);
+                    }
+                    stops = std::move(reduced);
+                }
+
+                auto constFloat = [&](float v) { return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(v, 0, 0, 0)); };
+                auto constVec3 = [&](glm::vec3 v) { return emit(OP_CONST, 0, 0, 0, 0, glm::vec4(v, 1)); };
+                auto constOne = [&]() { return constFloat(1.0f); };
+                auto constZero = [&]() { return constFloat(0.0f); };
+
+                // colorAccum = 0
+                uint32_t colorAccum = constVec3(glm::vec3(0.0f));
+
+                // Below first stop: maskBelow = 1 - step(t0, t)
+                const float t0f = stops.front().first;
+                const glm::vec3 c0 = stops.front().second;
+                uint32_t t0 = constFloat(t0f);
+                uint32_t maskBelow = emit(OP_ONEMINUS, emit(OP_STEP, t0, tReg));
+                colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, constVec3(c0), maskBelow));
+
+                // Segments
+                for (size_t i = 0; i + 1 < stops.size(); ++i) {
+                    float ta = stops[i].first;
+                    float tb = stops[i + 1].first;
+                    glm::vec3 ca = stops[i].second;
+                    glm::vec3 cb = stops[i + 1].second;
+
+                    uint32_t taR = constFloat(ta);
+                    uint32_t tbR = constFloat(tb);
+
+                    // segMask = step(ta, t) * (1 - step(tb, t))
+                    uint32_t inA = emit(OP_STEP, taR, tReg);
+                    uint32_t inB = emit(OP_ONEMINUS, emit(OP_STEP, tbR, tReg));
+                    uint32_t segMask = emit(OP_MUL, inA, inB);
+
+                    // u = clamp((t - ta) / (tb - ta), 0..1)
+                    uint32_t denom = emit(OP_SUB, tbR, taR);
+                    uint32_t num = emit(OP_SUB, tReg, taR);
+                    uint32_t u = emit(OP_DIV, num, denom);
+                    u = emit(OP_CLAMP, u, constZero(), constOne());
+
+                    uint32_t caR = constVec3(ca);
+                    uint32_t cbR = constVec3(cb);
+                    uint32_t segColor = emit(OP_LERP, caR, cbR, u);
+
+                    colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, segColor, segMask));
+                }
+
+                // Above last stop: maskAbove = step(tLast, t)
+                const float tLf = stops.back().first;
+                const glm::vec3 cL = stops.back().second;
+                uint32_t tL = constFloat(tLf);
+                uint32_t maskAbove = emit(OP_STEP, tL, tReg);
+                colorAccum = emit(OP_ADD, colorAccum, emit(OP_MUL, constVec3(cL), maskAbove));
+
+                // Pack output as vec4(rgb, 1)
+                r = emit(OP_SWIZZLE, colorAccum, 0u, 0u, 4u);
+                break;
+            }
+
+            case NodeType::CustomCode: {
+                // Lowered from the shared compiled form (names resolved, constants folded). Values
+                // are kept as one scalar register per component: most interpreter ops only read .x.
+                auto lowered = customOutputs.find(node->id);
+                if (lowered == customOutputs.end()) {
+                    const auto code = GetCompiledCustomCode(graph, *node);
+                    if (!code->IsValid()) {
+                        outError = code->error;
+                        r = emit(OP_CONST, 0, 0, 0, 0, glm::vec4(0.0f));
+                        break;
+                    }
+
+                    std::pmr::unordered_map<uint32_t, uint32_t> constRegs(workMem);
+                    auto scalarConst = [&](float v) {
+                        uint32_t bits = 0;
+                        std::memcpy(&bits, &v, sizeof(bits));
+                        auto it = constRegs.find(bits);
+                        if (it != constRegs.end()) return it->second;
+                        const uint32_t reg = emit(OP_CONST, 0, 0, 0, 0, glm::vec4(v, 0.0f, 0.0f, 0.0f));
+                        constRegs.emplace(bits, reg);
+                        return reg;
+                    };
+                    auto width = [](PinType type) { return std::max(GetPinTypeComponents(type), 1); };
+                    auto pack3 = [&](const std::array<uint32_t, 4>& v) { return emit(OP_COMBINE3, v[0], v[1], v[2]); };
+                    auto unpack3 = [&](uint32_t reg) {
+                        return std::array<uint32_t, 4>{ emitSwizzle(reg, 0u), emitSwizzle(reg, 1u), emitSwizzle(reg, 2u), 0u };
+                    };
+
+                    std::pmr::vector<std::array<uint32_t, 4>> values(workMem);
+                    values.reserve(code->exprs.size());
+                    for (const CustomCodeExpr& e : code->exprs) {
+                        const int n = width(e.type);
+                        auto arg = [&](int i) { return values[e.args[i]]; };
+                        std::array<uint32_t, 4> v{};
+                        switch (e.op) {
+                            case MaterialOp::Constant:
+                                for (int c = 0; c < n; ++c) v[c] = scalarConst(e.value[c]);
+                                break;
+                            case MaterialOp::Input: {
+                                // Convert from the linked output's type like MaterialCompiler::ConvertType
+                                const PinID inPin = node->inputPins[e.imm];
+                                const LinkID linkId = graph.FindLinkByEndPin(inPin);
+                                const MaterialLink* link = linkId != INVALID_LINK_ID ? graph.GetLink(linkId) : nullptr;
+                                const MaterialPin* from = graph.GetPin(link ? link->startPinId : inPin);
+                                const int fromN = from ? width(from->type) : n;
+                                const uint32_t reg = compilePin(inPin);
+                                for (int c = 0; c < n; ++c) {
+                                    if (fromN == 1) v[c] = c == 0 ? emitSwizzle(reg, 0u) : v[0];
+                                    else if (c < fromN) v[c] = emitSwizzle(reg, static_cast<uint32_t>(c));
+                                    else v[c] = scalarConst(c == 3 ? 1.0f : 0.0f);
+                                }
+                                break;
+                            }
+                            case MaterialOp::Swizzle:
+                                for (int c = 0; c < n; ++c) {
+                                    const uint32_t selector = (e.imm >> (3 * c)) & 7u;
+                                    v[c] = selector < 4 ? arg(0)[selector] : scalarConst(selector == 5u ? 1.0f : 0.0f);
+                                }
+                                break;
+                            case MaterialOp::Combine:
+                                for (int c = 0; c < n; ++c) v[c] = arg(c)[0];
+                                break;
+                            case MaterialOp::Dot3: v[0] = emit(OP_DOT, pack3(arg(0)), pack3(arg(1))); break;
+                            case MaterialOp::Length3: v[0] = emit(OP_LENGTH, pack3(arg(0))); break;
+                            case MaterialOp::Normalize3: v = unpack3(emit(OP_NORMALIZE, pack3(arg(0)))); break;
+                            case MaterialOp::Cross: v = unpack3(emit(OP_CROSS, pack3(arg(0)), pack3(arg(1)))); break;
+                            case MaterialOp::Reflect: v = unpack3(emit(OP_REFLECT, pack3(arg(0)), pack3(arg(1)))); break;
+                            case MaterialOp::Refract:
+                                v = unpack3(emit(OP_REFRACT, pack3(arg(0)), pack3(arg(1)), arg(2)[0]));
+                                break;
+                            default: {
+                                // Component-wise; the interpreter guards division, sqrt, log, pow and mod
+                                uint32_t opcode = 0u;
+                                switch (e.op) {
+                                    case MaterialOp::Add: opcode = OP_ADD; break;
+                                    case MaterialOp::Subtract: opcode = OP_SUB; break;
+                                    case MaterialOp::Multiply: opcode = OP_MUL; break;
+                                    case MaterialOp::Divide: opcode = OP_DIV; break;
+                                    case MaterialOp::Negate: opcode = OP_NEGATE; break;
+                                    case MaterialOp::Min: opcode = OP_MIN; break;
+                                    case MaterialOp::Max: opcode = OP_MAX; break;
+                                    case MaterialOp::Clamp: opcode = OP_CLAMP; break;
+                                    case MaterialOp::Mix: opcode = OP_LERP; break;
+                                    case MaterialOp::Abs: opcode = OP_ABS; break;
+                                    case MaterialOp::Floor: opcode = OP_FLOOR; break;
+                                    case MaterialOp::Ceil: opcode = OP_CEIL; break;
+                                    case MaterialOp::Fract: opcode = OP_FRACT; break;
+                                    case MaterialOp::Mod: opcode = OP_MOD; break;
+                                    case MaterialOp::Sqrt: opcode = OP_SQRT; break;
+                                    case MaterialOp::Exp: opcode = OP_EXP; break;
+                                    case MaterialOp::Log: opcode = OP_LOG; break;
+                                    case MaterialOp::Sin: opcode = OP_SIN; break;
+                                    case MaterialOp::Cos: opcode = OP_COS; break;
+                                    case MaterialOp::Pow: opcode = OP_POW; break;
+                                    case MaterialOp::Step: opcode = OP_STEP; break;
+                                    case MaterialOp::Smoothstep: opcode = OP_SMOOTHSTEP; break;
+                                    default: break;
+                                }
+                                if (opcode == 0u) {
+                                    outError = "Unsupported CustomCode operation for RT per-hit eval";
+                                    break;
+                                }
+                                for (int c = 0; c < n; ++c) {
+                                    v[c] = emit(opcode, arg(0)[c], e.argCount > 1 ? arg(1)[c] : 0u, e.argCount > 2 ? arg(2)[c] : 0u);
+                                }
+                                break;
+                            }
+                        }
+                        values.push_back(v);
+                    }
+
+                    std::pmr::vector<std::array<uint32_t, 4>> outputs(workMem);
+                    for (uint32_t output : code->outputs) outputs.push_back(values[output]);
+                    lowered = customOutputs.emplace(node->id, std::move(outputs)).first;
+                }
+
+                // Pack the requested output like other nodes' values (vec3 with w = 1)
+                const MaterialPin* outPin = graph.GetPin(pinId);
+                const int n = outPin ? std::max(GetPinTypeComponents(outPin->type), 1) : 1;
+                std::array<uint32_t, 4> v{};
+                if (outIdx >= 0 && outIdx < static_cast<int>(lowered->second.size())) v = lowered->second[outIdx];
+                if (n == 1) r = v[0];
+                else if (n == 2) r = emit(OP_COMBINE2, v[0], v[1]);
+                else if (n == 3) r = emit(OP_COMBINE3, v[0], v[1], v[2]);
+                else r = emit(OP_COMBINE4, v[0], v[1], v[2], v[3]);
+                break;
+            }
+
+            case NodeType::Reroute:
+                r = compilePin(node->inputPins[0]);
+                break;
+
+            default:
+                // Unsupported for RT per-hit evaluation
+                outError = std::string("Unsupported node for RT per-hit eval: ") + GetNodeTypeName(node->type);
+                r = emit(1u, 0, 0, 0, 0, glm::vec4(0.0f));
+                break;
+        }
+
+        pinToReg[pinId] = r;
+        st = 2;
+        return r;
+    };
+
+    // Find PBR output pins by name (compile from inputs so defaults work)
+    PinID baseColorIn = INVALID_PIN_ID;
+    PinID metallicIn = INVALID_PIN_ID;
+    PinID roughnessIn = INVALID_PIN_ID;
+    PinID emissiveIn = INVALID_PIN_ID;
+    PinID normalIn = INVALID_PIN_ID;
+    PinID alphaIn = INVALID_PIN_ID;
+
+    for (PinID pid : outNode->inputPins) {
+        const MaterialPin* p = graph.GetPin(pid);
+        if (!p) continue;
+        if (p->name == "Base Color") baseColorIn = pid;
+        else if (p->name == "Metallic") metallicIn = pid;
+        else if (p->name == "Roughness") roughnessIn = pid;
+        else if (p->name == "Emissive") emissiveIn = pid;
+        else if (p->name == "Normal") normalIn = pid;
+        else if (p->name == "Alpha") alphaIn = pid;
+    }
+
+    outHeader.baseColorReg = compilePin(baseColorIn);
+    outHeader.metallicReg = compilePin(metallicIn);
+    outHeader.roughnessReg = compilePin(roughnessIn);
+    outHeader.emissiveReg = compilePin(emissiveIn);
+    // Important: if Normal is unconnected, keep geometry normal (normalReg = 0).
+    if (normalIn != INVALID_PIN_ID && graph.FindLinkByEndPin(normalIn) != INVALID_LINK_ID) {
+        outHeader.normalReg = compilePin(normalIn);
+    } else {
+        outHeader.normalReg = 0u;
+    }
+    // Alpha currently not used by tracer shading, but we can still evaluate it for future use.
+    if (alphaIn != INVALID_PIN_ID && graph.FindLinkByEndPin(alphaIn) != INVALID_LINK_ID) {
+        outHeader.alphaReg = compilePin(alphaIn);
+    } else {
+        outHeader.alphaReg = 0u;
+    }
+
+    outHeader.instrCount = static_cast<uint32_t>(outInstrs.size());
+    return true;
+}
+
+} // namespace lucent::material
@@ -0,0 +1,128 @@
+#include "lucent/material/ShaderCache.h"
+#include "lucent/core/Log.h"
+#include "lucent/core/MappedFile.h"
+#include "lucent/core/Profiler.h"
+
+#include <cstring>
+#include <span>
+
+namespace lucent::material {
+
+namespace {
+
+constexpr char kMagic[8] = { 'L', 'U', 'C', 'E', 'N', 'T', 'S', 'P' };
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kSpirvMagic = 0x07230203;
+
+struct EntryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t wordCount;
+    uint64_t key;
+    uint64_t spirvHash;
+    float compileSeconds;
+    uint32_t reserved;
+};
+static_assert(sizeof(EntryHeader) == 40);
+
+uint64_t HashSpirv(std::span<const uint32_t> spirv) {
+    return HashBytes(std::as_bytes(spirv));
+}
+
+} // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void ShaderCache::SetDirectory(const std::string& directory, size_t maxBytes) {
+    m_Files.SetDirectory(directory, maxBytes);
+}
+
+bool ShaderCache::IsEnabled() const {
+    return m_Files.IsEnabled();
+}
+
+uint64_t ShaderCache::MakeKey(uint64_t graphHash, std::string_view glsl, std::string_view compilerOptions) {
+    std::string bytes(sizeof(graphHash), '\0');
+    std::memcpy(bytes.data(), &graphHash, sizeof(graphHash));
+    bytes.append(compilerOptions);
+    bytes.push_back('\0');
+    bytes.append(glsl);
+    return HashBytes(std::as_bytes(std::span<const char>(bytes)));
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+bool ShaderCache::Load(uint64_t key, std::vector<uint32_t>& outSpirv) {
+    LUCENT_PROFILE_FUNCTION();
+    EntryHeader header{};
+    const bool hit = m_Files.Load(key, [&](std::span<const std::byte> bytes) {
+        if (bytes.size() < sizeof(EntryHeader)) return false;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        const size_t spirvBytes = static_cast<size_t>(header.wordCount) * sizeof(uint32_t);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+            header.key != key || header.wordCount == 0 || bytes.size() != sizeof(EntryHeader) + spirvBytes) {
+            return false;
+        }
+        outSpirv.resize(header.wordCount);
+        std::memcpy(outSpirv.data(), bytes.data() + sizeof(EntryHeader), spirvBytes);
+        return outSpirv[0] == kSpirvMagic && HashSpirv(outSpirv) == header.spirvHash;
+    });
+    if (!hit) {
+        outSpirv.clear();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_SecondsSaved += header.compileSeconds;
+    return true;
+}
+
+void ShaderCache::Store(uint64_t key, std::span<const uint32_t> spirv, double compileSeconds) {
+    LUCENT_PROFILE_FUNCTION();
+    if (spirv.empty() || !m_Files.IsEnabled()) return;
+
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.wordCount = static_cast<uint32_t>(spirv.size());
+    header.key = key;
+    header.spirvHash = HashSpirv(spirv);
+    header.compileSeconds = static_cast<float>(compileSeconds);
+
+    const std::span<const std::byte> parts[] = { std::as_bytes(std::span<const EntryHeader>(&header, 1)),
+                                                 std::as_bytes(spirv) };
+    m_Files.Store(key, parts);
+}
+
+// ============================================================================
+// Stats
+// ============================================================================
+
+ShaderCacheStats ShaderCache::GetStats() const {
+    const FileCacheStats files = m_Files.GetStats();
+    ShaderCacheStats stats;
+    stats.hits = files.hits;
+    stats.misses = files.misses;
+    stats.writes = files.writes;
+    stats.evictions = files.evictions;
+    stats.diskBytes = files.diskBytes;
+    stats.maxBytes = files.maxBytes;
+    stats.entryCount = files.entryCount;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    stats.secondsSaved = m_SecondsSaved;
+    return stats;
+}
+
+void ShaderCache::LogStats() const {
+    const ShaderCacheStats stats = GetStats();
+    LUCENT_CORE_INFO("ShaderCache: {} hits, {} misses ({:.0f}% hit rate), {:.2f} s of compiles saved, "
+                     "{} entries ({:.1f} / {:.0f} MB), {} evictions",
+                     stats.hits, stats.misses, stats.GetHitRate() * 100.0, stats.secondsSaved, stats.entryCount,
+                     stats.diskBytes / (1024.0 * 1024.0), stats.maxBytes / (1024.0 * 1024.0), stats.evictions);
+}
+
+} // namespace lucent::material
@@ -0,0 +1,136 @@
+#include "lucent/material/TracerMaterials.h"
+#include "lucent/material/MaterialGraphEval.h"
+#include "lucent/material/MaterialIR.h"
+#include "lucent/material/MaterialOptimizer.h"
+#include "lucent/core/MappedFile.h"
+#include <bit>
+#include <span>
+
+namespace lucent::material {
+
+TracerMaterialTable::TracerMaterialTable(std::vector<gfx::GPUMaterial>& materials,
+                                         std::vector<gfx::RTMaterialHeader>* headers,
+                                         std::vector<gfx::RTMaterialInstr>* instrs, RTCompileFunction compileRT)
+    : m_Materials(materials), m_Headers(headers), m_Instrs(instrs), m_CompileRT(std::move(compileRT)) {
+    // Allocates registers for each RT program and shares identical programs between materials
+    if (m_Instrs) m_Linker.emplace(*m_Instrs);
+}
+
+uint32_t TracerMaterialTable::Add(Owner owner, const MaterialGraph* graph, const gfx::GPUMaterial& fallback,
+                                  std::string_view name) {
+    ++m_Stats.instances;
+
+    uint32_t index = kNoGraphMaterial;
+    if (graph) {
+        auto it = m_OwnerMaterials.find(owner);
+        if (it == m_OwnerMaterials.end()) {
+            it = m_OwnerMaterials.emplace(owner, AddGraph(*graph, name)).first;
+        }
+        index = it->second;
+    }
+    if (index == kNoGraphMaterial) index = AddComponentMaterial(fallback);
+
+    m_Stats.unsharedBytes += sizeof(gfx::GPUMaterial);
+    if (m_Headers) {
+        m_Stats.unsharedBytes +=
+            sizeof(gfx::RTMaterialHeader) + (*m_Headers)[index].instrCount * sizeof(gfx::RTMaterialInstr);
+    }
+    return index;
+}
+
+TracerMaterialStats TracerMaterialTable::GetStats() const {
+    TracerMaterialStats stats = m_Stats;
+    stats.sharedBytes = m_Materials.size() * sizeof(gfx::GPUMaterial);
+    if (m_Headers) stats.sharedBytes += m_Headers->size() * sizeof(gfx::RTMaterialHeader);
+    if (m_Instrs) stats.sharedBytes += m_Instrs->size() * sizeof(gfx::RTMaterialInstr);
+    return stats;
+}
+
+uint32_t TracerMaterialTable::AddGraph(const MaterialGraph& graph, std::string_view name) {
+    const uint64_t graphHash = graph.ComputeHash();
+    if (auto it = m_GraphMaterials.find(graphHash); it != m_GraphMaterials.end()) return it->second;
+    ++m_Stats.graphBuilds;
+
+    gfx::GPUMaterial mat{};
+    TracerMaterialConstants baked{};
+    std::string bakeErr;
+    if (EvaluateTracerConstants(graph, baked, bakeErr)) {
+        mat.baseColor = baked.baseColor;
+        mat.emissive = baked.emissive;
+        mat.metallic = baked.metallic;
+        mat.roughness = baked.roughness;
+        mat.ior = baked.ior;
+        mat.flags = baked.flags;
+    } else {
+        // If evaluation fails (unsupported nodes), fall back to IR constant evaluation, then to
+        // the instance's component values
+        MaterialIR ir{};
+        std::string irErr;
+        if (!MaterialIRCompiler::Compile(graph, ir, irErr) || !ir.IsValid()) {
+            m_GraphMaterials.emplace(graphHash, kNoGraphMaterial);
+            return kNoGraphMaterial;
+        }
+        auto data = ir.EvaluateConstant();
+        mat.baseColor = data.baseColor;
+        mat.emissive = data.emissive;
+        mat.metallic = data.metallic;
+        mat.roughness = data.roughness;
+        mat.ior = data.ior;
+        mat.flags = data.flags;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_Materials.size());
+    m_Materials.push_back(mat);
+    ++m_Stats.materials;
+    m_GraphMaterials.emplace(graphHash, index);
+
+    // Optional RT per-hit material evaluation (UV-driven)
+    if (m_Headers) {
+        gfx::RTMaterialHeader hdr{};
+
+        if (m_Linker && m_CompileRT && graph.GetDomain() != MaterialDomain::Volume) {
+            ScratchScope scratch;
+            std::pmr::vector<gfx::RTMaterialInstr> localInstrs(scratch.Resource());
+            std::string irErr;
+            // Folded and deduplicated first: every instruction left runs per hit
+            const MaterialGraph rtGraph = OptimizeMaterialGraph(graph);
+            gfx::RTMaterialProgramStats rtStats{};
+            if (m_CompileRT(rtGraph, hdr, localInstrs, irErr) && hdr.instrCount > 0 &&
+                m_Linker->Add(localInstrs, hdr, rtStats, irErr) && hdr.instrCount > 0) {
+                LUCENT_CORE_DEBUG("RT material '{}': {} -> {} instructions, {} registers, {} bytes{}", name,
+                                  rtStats.emittedInstrs, rtStats.instrCount, rtStats.registerCount, rtStats.bytes,
+                                  rtStats.shared ? " (shared program)" : "");
+            } else {
+                // Leave hdr empty; constants buffer will be used
+                hdr = gfx::RTMaterialHeader{};
+            }
+        }
+
+        m_Headers->push_back(hdr);
+    }
+    return index;
+}
+
+size_t TracerMaterialTable::ComponentKeyHash::operator()(const ComponentKey& key) const {
+    return static_cast<size_t>(HashBytes(std::as_bytes(std::span(key))));
+}
+
+uint32_t TracerMaterialTable::AddComponentMaterial(const gfx::GPUMaterial& material) {
+    const ComponentKey key = {
+        std::bit_cast<uint32_t>(material.baseColor.x), std::bit_cast<uint32_t>(material.baseColor.y),
+        std::bit_cast<uint32_t>(material.baseColor.z), std::bit_cast<uint32_t>(material.baseColor.w),
+        std::bit_cast<uint32_t>(material.emissive.x),  std::bit_cast<uint32_t>(material.emissive.y),
+        std::bit_cast<uint32_t>(material.emissive.z),  std::bit_cast<uint32_t>(material.emissive.w),
+        std::bit_cast<uint32_t>(material.metallic),    std::bit_cast<uint32_t>(material.roughness),
+        std::bit_cast<uint32_t>(material.ior),         material.flags,
+    };
+    auto [it, inserted] = m_ComponentMaterials.try_emplace(key, static_cast<uint32_t>(m_Materials.size()));
+    if (inserted) {
+        m_Materials.push_back(material);
+        ++m_Stats.materials;
+        if (m_Headers) m_Headers->push_back(gfx::RTMaterialHeader{});
+    }
+    return it->second;
+}
+
+} // namespace lucent::material
@@ -7,6 +7,8 @@
 #include <unordered_map>
 #include <cstdint>
 #include <functional>
+#include <memory_resource>
+#include <span>
 
 namespace lucent::mesh {
 
@@ -162,6 +164,11 @@ public:
     // Convert to triangles for rendering
     TriangleOutput ToTriangles() const;
     
+    // Same triangulation, appended to caller-owned buffers (e.g. backed by a ScratchScope).
+    // Reserves outVertices/outIndices up front so they do not grow under nested scratch scopes.
+    void AppendTriangles(std::pmr::vector<TriangleOutput::Vertex>& outVertices,
+                         std::pmr::vector<uint32_t>& outIndices) const;
+    
     // ========================================================================
     // Element Access
     // ========================================================================
@@ -278,6 +285,23 @@ public:
     SerializedData Serialize() const;
     static EditableMesh Deserialize(const SerializedData& data);
     
+    // Flat form used by the binary scene format: face i uses faceSizes[i] consecutive
+    // entries of faceIndices. Arrays are plain PODs so they can be written/mapped directly.
+    struct FlatData {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> uvs;
+        std::vector<uint32_t> faceSizes;
+        std::vector<uint32_t> faceIndices;
+    };
+    
+    FlatData SerializeFlat() const;
+    // Build a mesh straight from (possibly memory-mapped) arrays. uvs may be empty.
+    // Faces with fewer than 3 corners or out-of-range indices are skipped.
+    static EditableMesh FromArrays(std::span<const glm::vec3> positions,
+                                   std::span<const glm::vec2> uvs,
+                                   std::span<const uint32_t> faceSizes,
+                                   std::span<const uint32_t> faceIndices);
+    
 private:
     // Find or create edge between two vertices
     EdgeID FindOrCreateEdge(VertexID v0, VertexID v1);
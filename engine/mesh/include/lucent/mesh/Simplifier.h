@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lucent::mesh {
+
+// Triangle-list simplification by edge collapse with quadric error metrics (Garland-Heckbert),
+// extended with attribute quadrics (Hoppe) so normals/UVs steer which edges collapse.
+// Vertices only ever collapse onto other existing vertices, so the output indexes the input
+// vertex array unchanged. Vertices sharing a position are treated as wedges of one point:
+// attribute seams stay intact and collapse along themselves.
+namespace Simplifier {
+
+struct Options {
+    // Stop once the index count is at or below this
+    size_t targetIndexCount = 0;
+    // Largest collapse error allowed, relative to the mesh extent (0.01 = 1% of its size)
+    float targetError = 0.01f;
+    // Keep open boundaries exactly; otherwise border vertices may slide along the border
+    bool lockBorder = false;
+    // Per-vertex attributes, attributes[v * attributeWeights.size() + k], scaled by the weights.
+    // Errors in weighted attribute units add to the positional error.
+    std::span<const float> attributes;
+    std::span<const float> attributeWeights;
+};
+
+struct Result {
+    size_t indexCount = 0;
+    // Largest collapse error made, relative to the mesh extent
+    float error = 0.0f;
+};
+
+// Writes the simplified triangle list to outIndices (replaced). indices must be a valid
+// triangle list for positions.
+Result Simplify(std::span<const glm::vec3> positions, std::span<const uint32_t> indices,
+                std::vector<uint32_t>& outIndices, const Options& options);
+
+// Largest axis extent of the positions, the unit Result::error is relative to
+float GetScale(std::span<const glm::vec3> positions);
+
+} // namespace Simplifier
+
+} // namespace lucent::mesh
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <vector>
 #include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
 
 namespace lucent::mesh {
 
@@ -13,20 +15,34 @@ public:
     // Returns indices into the input vertex array forming triangles.
     // faceNormal: the polygon's normal (used to determine winding)
     static std::vector<uint32_t> Triangulate(
-        const std::vector<glm::vec3>& vertices,
+        std::span<const glm::vec3> vertices,
         const glm::vec3& faceNormal
     );
     
+    // Allocation-free variant for hot paths: replaces the contents of outIndices.
+    // Working buffers come from the thread's scratch arena.
+    static void Triangulate(
+        std::span<const glm::vec3> vertices,
+        const glm::vec3& faceNormal,
+        std::pmr::vector<uint32_t>& outIndices
+    );
+    
     // 2D triangulation (projects 3D polygon onto best-fit plane)
     static std::vector<uint32_t> Triangulate2D(
-        const std::vector<glm::vec2>& vertices
+        std::span<const glm::vec2> vertices
     );
     
 private:
+    // Ear clipping; appends triangle indices to outIndices
+    static void Triangulate2D(
+        std::span<const glm::vec2> vertices,
+        std::pmr::vector<uint32_t>& outIndices
+    );
+    
     // Check if a vertex is an "ear" (can be clipped)
     static bool IsEar(
-        const std::vector<glm::vec2>& vertices,
-        const std::vector<uint32_t>& indices,
+        std::span<const glm::vec2> vertices,
+        std::span<const uint32_t> indices,
         uint32_t prevIdx,
         uint32_t currIdx,
         uint32_t nextIdx
@@ -48,9 +64,10 @@ private:
     );
     
     // Project 3D polygon to 2D using the face normal
-    static std::vector<glm::vec2> ProjectTo2D(
-        const std::vector<glm::vec3>& vertices,
-        const glm::vec3& normal
+    static void ProjectTo2D(
+        std::span<const glm::vec3> vertices,
+        const glm::vec3& normal,
+        std::pmr::vector<glm::vec2>& outProjected
     );
 };
 
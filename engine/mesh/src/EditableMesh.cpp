@@ -705,7 +705,8 @@ float EditableMesh::ComputeSignedVolume() const {
     for (const auto& face : m_Faces) {
         if (face.id == INVALID_ID) continue;
         
-        std::vector<glm::vec3> facePositions;
+        ScratchScope scratch;
+        std::pmr::vector<glm::vec3> facePositions(scratch.Resource());
         facePositions.reserve(face.vertCount);
         ForEachFaceVertex(face.id, [&](const EMVertex& v) {
             facePositions.push_back(v.position);
@@ -713,7 +714,8 @@ float EditableMesh::ComputeSignedVolume() const {
         if (facePositions.size() < 3) continue;
         
         // Use current face normal for triangulation
-        std::vector<uint32_t> tri = Triangulator::Triangulate(facePositions, face.normal);
+        std::pmr::vector<uint32_t> tri(scratch.Resource());
+        Triangulator::Triangulate(facePositions, face.normal, tri);
         if (tri.size() < 3) continue;
         
         for (size_t i = 0; i + 2 < tri.size(); i += 3) {
@@ -1035,16 +1037,57 @@ EditableMesh EditableMesh::FromFaces(
 }
 
 TriangleOutput EditableMesh::ToTriangles() const {
+    ScratchScope scratch;
+    std::pmr::vector<TriangleOutput::Vertex> vertices(scratch.Resource());
+    std::pmr::vector<uint32_t> indices(scratch.Resource());
+    AppendTriangles(vertices, indices);
+    
     TriangleOutput output;
+    output.vertices.assign(vertices.begin(), vertices.end());
+    output.indices.assign(indices.begin(), indices.end());
+    return output;
+}
+
+void EditableMesh::AppendTriangles(std::pmr::vector<TriangleOutput::Vertex>& outVertices,
+                                   std::pmr::vector<uint32_t>& outIndices) const {
+    // Size the outputs first: they may come from an outer scratch scope and must not
+    // reallocate while ours is open.
+    size_t loopCount = 0;
+    size_t triIndexCount = 0;
+    size_t maxFaceVerts = 0;
+    for (const auto& face : m_Faces) {
+        if (face.id == INVALID_ID) continue;
+        size_t count = 0;
+        ForEachFaceLoop(face.id, [&](const EMLoop& loop) {
+            if (GetVertex(loop.vertex)) ++count;
+        });
+        if (count < 3) continue;
+        loopCount += count;
+        triIndexCount += (count - 2) * 3;
+        maxFaceVerts = std::max(maxFaceVerts, count);
+    }
+    outVertices.reserve(outVertices.size() + loopCount);
+    outIndices.reserve(outIndices.size() + triIndexCount);
+    
+    // Per-face working buffers are reused across faces instead of reallocated
+    ScratchScope scratch;
+    std::pmr::vector<glm::vec3> facePositions(scratch.Resource());
+    std::pmr::vector<glm::vec3> faceNormals(scratch.Resource());
+    std::pmr::vector<glm::vec2> faceUVs(scratch.Resource());
+    std::pmr::vector<uint32_t> triIndices(scratch.Resource());
+    facePositions.reserve(maxFaceVerts);
+    faceNormals.reserve(maxFaceVerts);
+    faceUVs.reserve(maxFaceVerts);
+    triIndices.reserve(maxFaceVerts >= 3 ? (maxFaceVerts - 2) * 3 : 0);
     
     // Triangulate each face
     for (const auto& face : m_Faces) {
         if (face.id == INVALID_ID) continue;
         
         // Collect face vertices
-        std::vector<glm::vec3> facePositions;
-        std::vector<glm::vec3> faceNormals;
-        std::vector<glm::vec2> faceUVs;
+        facePositions.clear();
+        faceNormals.clear();
+        faceUVs.clear();
         
         ForEachFaceLoop(face.id, [&](const EMLoop& loop) {
             const EMVertex* v = GetVertex(loop.vertex);
@@ -1058,33 +1101,31 @@ TriangleOutput EditableMesh::ToTriangles() const {
         if (facePositions.size() < 3) continue;
         
         // Triangulate
-        std::vector<uint32_t> triIndices = Triangulator::Triangulate(facePositions, face.normal);
+        Triangulator::Triangulate(facePositions, face.normal, triIndices);
+        
+        // Calculate tangent (simplified - uses face normal)
+        glm::vec3 tangent = glm::normalize(glm::cross(face.normal, glm::vec3(0, 1, 0)));
+        if (glm::length(tangent) < 0.001f) {
+            tangent = glm::normalize(glm::cross(face.normal, glm::vec3(1, 0, 0)));
+        }
         
         // Add to output
-        uint32_t baseVertex = static_cast<uint32_t>(output.vertices.size());
+        uint32_t baseVertex = static_cast<uint32_t>(outVertices.size());
         
         for (size_t i = 0; i < facePositions.size(); ++i) {
             TriangleOutput::Vertex v;
             v.position = facePositions[i];
             v.normal = faceNormals[i];
             v.uv = faceUVs[i];
-            
-            // Calculate tangent (simplified - uses face normal)
-            glm::vec3 tangent = glm::normalize(glm::cross(face.normal, glm::vec3(0, 1, 0)));
-            if (glm::length(tangent) < 0.001f) {
-                tangent = glm::normalize(glm::cross(face.normal, glm::vec3(1, 0, 0)));
-            }
             v.tangent = glm::vec4(tangent, 1.0f);
             
-            output.vertices.push_back(v);
+            outVertices.push_back(v);
         }
         
         for (uint32_t idx : triIndices) {
-            output.indices.push_back(baseVertex + idx);
+            outIndices.push_back(baseVertex + idx);
         }
     }
-    
-    return output;
 }
 
 // ============================================================================
@@ -1146,4 +1187,85 @@ EditableMesh EditableMesh::Deserialize(const SerializedData& data) {
     return std::move(mesh);
 }
 
+EditableMesh::FlatData EditableMesh::SerializeFlat() const {
+    FlatData data;
+    data.positions.reserve(VertexCount());
+    data.uvs.reserve(VertexCount());
+    data.faceSizes.reserve(FaceCount());
+    data.faceIndices.reserve(m_Loops.size() - m_FreeLoops.size());
+    
+    // Dense remap table (skip free slots); IDs index m_Vertices directly
+    std::vector<uint32_t> vertexRemap(m_Vertices.size(), INVALID_ID);
+    for (const auto& v : m_Vertices) {
+        if (v.id != INVALID_ID) {
+            vertexRemap[v.id] = static_cast<uint32_t>(data.positions.size());
+            data.positions.push_back(v.position);
+            data.uvs.push_back(v.uv);
+        }
+    }
+    
+    for (const auto& face : m_Faces) {
+        if (face.id == INVALID_ID) continue;
+        
+        const size_t faceStart = data.faceIndices.size();
+        ForEachFaceLoop(face.id, [&](const EMLoop& loop) {
+            if (loop.vertex < vertexRemap.size() && vertexRemap[loop.vertex] != INVALID_ID) {
+                data.faceIndices.push_back(vertexRemap[loop.vertex]);
+            }
+        });
+        
+        const size_t corners = data.faceIndices.size() - faceStart;
+        if (corners >= 3) {
+            data.faceSizes.push_back(static_cast<uint32_t>(corners));
+        } else {
+            data.faceIndices.resize(faceStart);
+        }
+    }
+    
+    return data;
+}
+
+EditableMesh EditableMesh::FromArrays(std::span<const glm::vec3> positions,
+                                      std::span<const glm::vec2> uvs,
+                                      std::span<const uint32_t> faceSizes,
+                                      std::span<const uint32_t> faceIndices) {
+    EditableMesh mesh;
+    
+    // Closed manifold meshes have ~1 edge per 2 corners; reserving up front avoids rehash/regrow churn
+    mesh.m_Vertices.reserve(positions.size());
+    mesh.m_Faces.reserve(faceSizes.size());
+    mesh.m_Loops.reserve(faceIndices.size());
+    mesh.m_Edges.reserve(faceIndices.size() / 2 + 1);
+    mesh.m_EdgeMap.reserve(faceIndices.size() / 2 + 1);
+    
+    for (size_t i = 0; i < positions.size(); ++i) {
+        VertexID vid = mesh.AddVertex(positions[i]);
+        if (i < uvs.size()) {
+            mesh.m_Vertices[vid].uv = uvs[i];
+        }
+    }
+    
+    std::vector<VertexID> vids;
+    size_t cursor = 0;
+    for (uint32_t faceSize : faceSizes) {
+        if (faceSize > faceIndices.size() - cursor) break;
+        
+        const auto corners = faceIndices.subspan(cursor, faceSize);
+        cursor += faceSize;
+        
+        if (faceSize < 3) continue;
+        bool inRange = true;
+        for (uint32_t idx : corners) {
+            inRange = inRange && idx < positions.size();
+        }
+        if (!inRange) continue;
+        
+        vids.assign(corners.begin(), corners.end());
+        mesh.AddFace(vids);
+    }
+    
+    mesh.RecalculateNormals();
+    return mesh;
+}
+
 } // namespace lucent::mesh
@@ -0,0 +1,551 @@
+#include "lucent/mesh/Simplifier.h"
+#include "lucent/core/Profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace lucent::mesh {
+namespace Simplifier {
+namespace {
+
+// Border edges get a plane perpendicular to the surface so border vertices slide along them
+constexpr double kBorderWeight = 10.0;
+
+// Symmetric 4x4 error quadric, stored as A (3x3), b and c: Q(p) = p.A.p + 2 b.p + c.
+// w is the accumulated area, so Q(p) / w is an area-weighted mean squared distance.
+struct Quadric {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0, a10 = 0.0, a20 = 0.0, a21 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double w = 0.0;
+
+    void Add(const Quadric& q) {
+        a00 += q.a00; a11 += q.a11; a22 += q.a22;
+        a10 += q.a10; a20 += q.a20; a21 += q.a21;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        w += q.w;
+    }
+
+    // (n.p + d)^2 * weight
+    void AddPlane(const glm::vec3& n, double d, double weight) {
+        a00 += weight * n.x * n.x; a11 += weight * n.y * n.y; a22 += weight * n.z * n.z;
+        a10 += weight * n.y * n.x; a20 += weight * n.z * n.x; a21 += weight * n.z * n.y;
+        b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+        c += weight * d * d;
+        w += weight;
+    }
+
+    double Evaluate(const glm::vec3& p) const {
+        const double rx = a00 * p.x + a10 * p.y + a20 * p.z;
+        const double ry = a10 * p.x + a11 * p.y + a21 * p.z;
+        const double rz = a20 * p.x + a21 * p.y + a22 * p.z;
+        return p.x * rx + p.y * ry + p.z * rz + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+    }
+};
+
+// Per vertex and attribute: area-weighted gradient g and offset d of the attribute over the
+// adjacent triangles, attribute(p) ~ g.p + d
+struct AttributeGradient {
+    double gx = 0.0, gy = 0.0, gz = 0.0, d = 0.0;
+};
+
+enum class VertexKind : uint8_t {
+    Manifold,   // Interior; may collapse onto any neighbour
+    Border,     // On an open boundary; may only collapse along it
+    Locked      // Never moves (non-manifold, or border with lockBorder)
+};
+
+struct Collapse {
+    uint32_t from;      // Wedges of this position move...
+    uint32_t to;        // ...onto the matching wedges here
+    float cost;
+};
+
+uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+struct PositionKeyHash {
+    size_t operator()(const glm::vec3& p) const {
+        uint32_t bits[3];
+        std::memcpy(bits, &p.x, sizeof(float));
+        std::memcpy(bits + 1, &p.y, sizeof(float));
+        std::memcpy(bits + 2, &p.z, sizeof(float));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+    }
+};
+
+struct PositionKeyEqual {
+    bool operator()(const glm::vec3& a, const glm::vec3& b) const {
+        return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+    }
+};
+
+class SimplifierState {
+public:
+    SimplifierState(std::span<const glm::vec3> positions, const Options& options)
+        : m_Options(options), m_AttributeCount(options.attributeWeights.size()) {
+        const size_t vertexCount = positions.size();
+
+        // Work in a unit-sized frame so errors are relative to the mesh extent
+        glm::vec3 minimum(FLT_MAX);
+        for (const glm::vec3& p : positions) minimum = glm::min(minimum, p);
+        const float scale = GetScale(positions);
+        const float invScale = scale > 0.0f ? 1.0f / scale : 1.0f;
+        m_Points.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            m_Points[v] = (positions[v] - minimum) * invScale;
+        }
+
+        // Wedges: vertices with bit-identical positions form one point
+        m_PositionOf.resize(vertexCount);
+        std::unordered_map<glm::vec3, uint32_t, PositionKeyHash, PositionKeyEqual> first;
+        first.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            m_PositionOf[v] = first.try_emplace(positions[v], v).first->second;
+        }
+
+        m_Remap.resize(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) m_Remap[v] = v;
+        m_Kinds.assign(vertexCount, VertexKind::Manifold);
+        m_PositionQuadrics.resize(vertexCount);
+        if (m_AttributeCount > 0) {
+            m_AttributeQuadrics.resize(vertexCount);
+            m_Gradients.resize(vertexCount * m_AttributeCount);
+        }
+    }
+
+    float Attribute(uint32_t v, size_t k) const {
+        return m_Options.attributes[v * m_AttributeCount + k] * m_Options.attributeWeights[k];
+    }
+
+    void RemoveDegenerate(std::vector<uint32_t>& indices) const {
+        size_t write = 0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+            const uint32_t pa = m_PositionOf[a], pb = m_PositionOf[b], pc = m_PositionOf[c];
+            if (pa == pb || pb == pc || pa == pc) continue;
+            indices[write++] = a;
+            indices[write++] = b;
+            indices[write++] = c;
+        }
+        indices.resize(write);
+    }
+
+    void Classify(std::span<const uint32_t> indices) {
+        std::unordered_map<uint64_t, uint32_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = m_PositionOf[indices[i + k]];
+                const uint32_t b = m_PositionOf[indices[i + (k + 1) % 3]];
+                edges[EdgeKey(a, b)]++;
+            }
+        }
+
+        std::vector<uint32_t> borderEdges(m_Points.size(), 0);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = m_PositionOf[indices[i + k]];
+                const uint32_t b = m_PositionOf[indices[i + (k + 1) % 3]];
+                if (edges[EdgeKey(a, b)] > 1) {
+                    // Same directed edge twice: non-manifold or inconsistently wound
+                    m_Kinds[a] = m_Kinds[b] = VertexKind::Locked;
+                    continue;
+                }
+                if (edges.count(EdgeKey(b, a))) continue;
+
+                borderEdges[a]++;
+                borderEdges[b]++;
+                m_HasBorder = true;
+                if (!m_Options.lockBorder) {
+                    AddBorderQuadric(indices[i + k], indices[i + (k + 1) % 3], indices[i + (k + 2) % 3]);
+                }
+            }
+        }
+
+        for (size_t v = 0; v < m_Points.size(); ++v) {
+            if (m_Kinds[v] == VertexKind::Locked || borderEdges[v] == 0) continue;
+            // More than one border loop through the vertex (a bow-tie) cannot slide safely
+            m_Kinds[v] = (m_Options.lockBorder || borderEdges[v] > 2) ? VertexKind::Locked : VertexKind::Border;
+        }
+    }
+
+    void AddTriangleQuadrics(std::span<const uint32_t> indices) {
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t corners[3] = { indices[i], indices[i + 1], indices[i + 2] };
+            const glm::vec3& p0 = m_Points[corners[0]];
+            const glm::vec3 e1 = m_Points[corners[1]] - p0;
+            const glm::vec3 e2 = m_Points[corners[2]] - p0;
+            glm::vec3 normal = glm::cross(e1, e2);
+            const float length = glm::length(normal);
+            if (length <= 0.0f) continue;
+            normal /= length;
+            const double area = 0.5 * length;
+
+            Quadric plane;
+            plane.AddPlane(normal, -glm::dot(normal, p0), area);
+            for (uint32_t corner : corners) {
+                m_PositionQuadrics[m_PositionOf[corner]].Add(plane);
+            }
+
+            if (m_AttributeCount > 0) {
+                AddAttributeQuadrics(corners, p0, e1, e2, area);
+            }
+        }
+    }
+
+    // One pass of independent collapses, cheapest first. Returns false if nothing collapsed.
+    bool Pass(std::vector<uint32_t>& indices, size_t targetIndexCount, double errorLimit, double& maxError) {
+        LUCENT_PROFILE_ZONE("Simplifier::Pass");
+        const size_t triangleCount = indices.size() / 3;
+        BuildAdjacency(indices);
+        if (m_HasBorder && !m_Options.lockBorder) {
+            m_Edges.clear();
+            m_Edges.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    m_Edges.insert(EdgeKey(m_PositionOf[indices[i + k]], m_PositionOf[indices[i + (k + 1) % 3]]));
+                }
+            }
+        }
+
+        // Candidates: the cheaper allowed direction of every edge
+        std::vector<Collapse> candidates;
+        candidates.reserve(triangleCount * 3 / 2 + 1);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = indices[i + k];
+                const uint32_t b = indices[i + (k + 1) % 3];
+                const uint32_t pa = m_PositionOf[a];
+                const uint32_t pb = m_PositionOf[b];
+                // Interior edges are seen from both triangles; take them once
+                if (pa > pb && !IsBorderEdge(pa, pb)) continue;
+
+                const double costAB = CanCollapse(pa, pb) ? EstimateCost(a, b) : DBL_MAX;
+                const double costBA = CanCollapse(pb, pa) ? EstimateCost(b, a) : DBL_MAX;
+                if (costAB == DBL_MAX && costBA == DBL_MAX) continue;
+                if (costAB <= costBA) {
+                    candidates.push_back({ pa, pb, static_cast<float>(costAB) });
+                } else {
+                    candidates.push_back({ pb, pa, static_cast<float>(costBA) });
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        const size_t trianglesToRemove = triangleCount - std::min(triangleCount, targetIndexCount / 3);
+        size_t removed = 0;
+        size_t collapses = 0;
+        m_Locked.assign(m_Points.size(), 0);
+        for (const Collapse& candidate : candidates) {
+            if (candidate.cost > errorLimit) break;
+            if (m_Locked[candidate.from] || m_Locked[candidate.to]) continue;
+
+            if (!MatchWedges(candidate.from, candidate.to) || HasTriangleFlip(candidate.from, candidate.to)) continue;
+            const double cost = Cost(candidate.from, candidate.to);
+            if (cost > errorLimit) continue;
+
+            removed += Apply(candidate.from, candidate.to);
+            maxError = std::max(maxError, cost);
+            collapses++;
+            if (removed >= trianglesToRemove) break;
+        }
+        if (collapses == 0) return false;
+
+        for (uint32_t& index : indices) {
+            index = m_Remap[index];
+        }
+        RemoveDegenerate(indices);
+        return true;
+    }
+
+private:
+    void AddBorderQuadric(uint32_t a, uint32_t b, uint32_t c) {
+        const glm::vec3& pa = m_Points[a];
+        const glm::vec3 edge = m_Points[b] - pa;
+        const glm::vec3 normal = glm::cross(edge, m_Points[c] - pa);
+        glm::vec3 perpendicular = glm::cross(edge, normal);
+        const float length = glm::length(perpendicular);
+        if (length <= 0.0f) return;
+        perpendicular /= length;
+
+        Quadric quadric;
+        const double edgeLength = glm::length(edge);
+        quadric.AddPlane(perpendicular, -glm::dot(perpendicular, pa), kBorderWeight * edgeLength * edgeLength);
+        m_PositionQuadrics[m_PositionOf[a]].Add(quadric);
+        m_PositionQuadrics[m_PositionOf[b]].Add(quadric);
+    }
+
+    // Hoppe's attribute quadric: per attribute, fit s(p) = g.p + d over the triangle (g in its
+    // plane) and accumulate (g.p + d - s)^2 with the attribute value s left free
+    void AddAttributeQuadrics(const uint32_t corners[3], const glm::vec3& p0, const glm::vec3& e1,
+                              const glm::vec3& e2, double area) {
+        const double g11 = glm::dot(e1, e1);
+        const double g12 = glm::dot(e1, e2);
+        const double g22 = glm::dot(e2, e2);
+        const double det = g11 * g22 - g12 * g12;
+        if (det <= 0.0) return;
+
+        Quadric quadric;
+        std::vector<AttributeGradient>& gradients = m_TriangleGradients;
+        gradients.resize(m_AttributeCount);
+        for (size_t k = 0; k < m_AttributeCount; ++k) {
+            const double s0 = Attribute(corners[0], k);
+            const double ds1 = Attribute(corners[1], k) - s0;
+            const double ds2 = Attribute(corners[2], k) - s0;
+            const double u = (g22 * ds1 - g12 * ds2) / det;
+            const double v = (g11 * ds2 - g12 * ds1) / det;
+            const double gx = e1.x * u + e2.x * v;
+            const double gy = e1.y * u + e2.y * v;
+            const double gz = e1.z * u + e2.z * v;
+            const double d = s0 - (gx * p0.x + gy * p0.y + gz * p0.z);
+
+            quadric.a00 += area * gx * gx; quadric.a11 += area * gy * gy; quadric.a22 += area * gz * gz;
+            quadric.a10 += area * gy * gx; quadric.a20 += area * gz * gx; quadric.a21 += area * gz * gy;
+            quadric.b0 += area * gx * d; quadric.b1 += area * gy * d; quadric.b2 += area * gz * d;
+            quadric.c += area * d * d;
+            gradients[k] = { area * gx, area * gy, area * gz, area * d };
+        }
+        quadric.w = area;
+
+        for (int corner = 0; corner < 3; ++corner) {
+            const uint32_t v = corners[corner];
+            m_AttributeQuadrics[v].Add(quadric);
+            for (size_t k = 0; k < m_AttributeCount; ++k) {
+                AttributeGradient& g = m_Gradients[v * m_AttributeCount + k];
+                g.gx += gradients[k].gx;
+                g.gy += gradients[k].gy;
+                g.gz += gradients[k].gz;
+                g.d += gradients[k].d;
+            }
+        }
+    }
+
+    void BuildAdjacency(std::span<const uint32_t> indices) {
+        m_AdjacencyOffset.assign(m_Points.size() + 1, 0);
+        for (uint32_t index : indices) {
+            m_AdjacencyOffset[m_PositionOf[index] + 1]++;
+        }
+        for (size_t v = 0; v < m_Points.size(); ++v) {
+            m_AdjacencyOffset[v + 1] += m_AdjacencyOffset[v];
+        }
+        m_Adjacency.resize(indices.size());
+        std::vector<uint32_t> fill(m_AdjacencyOffset.begin(), m_AdjacencyOffset.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            m_Adjacency[fill[m_PositionOf[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+        m_Indices = indices;
+    }
+
+    std::span<const uint32_t> AdjacentTriangles(uint32_t position) const {
+        return { m_Adjacency.data() + m_AdjacencyOffset[position],
+                 m_AdjacencyOffset[position + 1] - m_AdjacencyOffset[position] };
+    }
+
+    bool IsBorderEdge(uint32_t a, uint32_t b) const {
+        if (!m_HasBorder || m_Options.lockBorder) return false;
+        return m_Edges.count(EdgeKey(a, b)) != m_Edges.count(EdgeKey(b, a));
+    }
+
+    bool CanCollapse(uint32_t from, uint32_t to) const {
+        switch (m_Kinds[from]) {
+            case VertexKind::Manifold: return true;
+            case VertexKind::Border: return IsBorderEdge(from, to);
+            default: return false;
+        }
+    }
+
+    double AttributeError(uint32_t wedge, uint32_t target) const {
+        const Quadric& quadric = m_AttributeQuadrics[wedge];
+        if (quadric.w <= 0.0) return 0.0;
+        const glm::vec3& p = m_Points[target];
+        double error = quadric.Evaluate(p);
+        for (size_t k = 0; k < m_AttributeCount; ++k) {
+            const AttributeGradient& g = m_Gradients[wedge * m_AttributeCount + k];
+            const double s = Attribute(target, k);
+            error += quadric.w * s * s - 2.0 * s * (g.gx * p.x + g.gy * p.y + g.gz * p.z + g.d);
+        }
+        return std::abs(error) / quadric.w;
+    }
+
+    double PositionError(uint32_t from, uint32_t to) const {
+        const Quadric& quadric = m_PositionQuadrics[from];
+        if (quadric.w <= 0.0) return 0.0;
+        return std::abs(quadric.Evaluate(m_Points[to])) / quadric.w;
+    }
+
+    // Candidate ordering only: the attribute error of the one wedge pair on the edge
+    double EstimateCost(uint32_t fromWedge, uint32_t toWedge) const {
+        double cost = PositionError(m_PositionOf[fromWedge], m_PositionOf[toWedge]);
+        if (m_AttributeCount > 0) cost += AttributeError(fromWedge, toWedge);
+        return cost;
+    }
+
+    // Exact cost once the wedge pairing is known (MatchWedges)
+    double Cost(uint32_t from, uint32_t to) const {
+        double cost = PositionError(from, to);
+        if (m_AttributeCount > 0) {
+            for (const auto& [wedge, partner] : m_WedgePairs) {
+                cost += AttributeError(wedge, partner);
+            }
+        }
+        return cost;
+    }
+
+    // Every wedge of `from` used by a triangle must share an edge with exactly one wedge of
+    // `to`; that wedge takes its place. Fails for collapses across attribute seams.
+    bool MatchWedges(uint32_t from, uint32_t to) {
+        m_WedgePairs.clear();
+        m_UsedWedges.clear();
+        for (uint32_t triangle : AdjacentTriangles(from)) {
+            const uint32_t* tri = &m_Indices[triangle * 3];
+            uint32_t fromWedge = UINT32_MAX, toWedge = UINT32_MAX;
+            for (int k = 0; k < 3; ++k) {
+                if (m_PositionOf[tri[k]] == from) fromWedge = tri[k];
+                if (m_PositionOf[tri[k]] == to) toWedge = tri[k];
+            }
+            if (std::find(m_UsedWedges.begin(), m_UsedWedges.end(), fromWedge) == m_UsedWedges.end()) {
+                m_UsedWedges.push_back(fromWedge);
+            }
+            if (toWedge == UINT32_MAX) continue;
+
+            auto it = std::find_if(m_WedgePairs.begin(), m_WedgePairs.end(),
+                [&](const auto& pair) { return pair.first == fromWedge; });
+            if (it == m_WedgePairs.end()) {
+                m_WedgePairs.emplace_back(fromWedge, toWedge);
+            } else if (it->second != toWedge) {
+                return false;
+            }
+        }
+        return m_WedgePairs.size() == m_UsedWedges.size();
+    }
+
+    bool HasTriangleFlip(uint32_t from, uint32_t to) const {
+        const glm::vec3& target = m_Points[to];
+        for (uint32_t triangle : AdjacentTriangles(from)) {
+            const uint32_t* tri = &m_Indices[triangle * 3];
+            glm::vec3 before[3], after[3];
+            bool removed = false;
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t position = m_PositionOf[tri[k]];
+                removed |= position == to;
+                before[k] = m_Points[tri[k]];
+                after[k] = position == from ? target : before[k];
+            }
+            if (removed) continue;
+
+            const glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+            const glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+            if (glm::dot(n0, n1) <= 0.0f) return true;
+        }
+        return false;
+    }
+
+    // Returns the number of triangles the collapse removes
+    size_t Apply(uint32_t from, uint32_t to) {
+        m_PositionQuadrics[to].Add(m_PositionQuadrics[from]);
+        for (const auto& [wedge, partner] : m_WedgePairs) {
+            m_Remap[wedge] = partner;
+            if (m_AttributeCount > 0) {
+                m_AttributeQuadrics[partner].Add(m_AttributeQuadrics[wedge]);
+                for (size_t k = 0; k < m_AttributeCount; ++k) {
+                    AttributeGradient& dst = m_Gradients[partner * m_AttributeCount + k];
+                    const AttributeGradient& src = m_Gradients[wedge * m_AttributeCount + k];
+                    dst.gx += src.gx;
+                    dst.gy += src.gy;
+                    dst.gz += src.gz;
+                    dst.d += src.d;
+                }
+            }
+        }
+
+        // Later collapses in this pass must not see triangles this one changed
+        size_t removed = 0;
+        for (uint32_t triangle : AdjacentTriangles(from)) {
+            const uint32_t* tri = &m_Indices[triangle * 3];
+            bool hasTo = false;
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t position = m_PositionOf[tri[k]];
+                m_Locked[position] = 1;
+                hasTo |= position == to;
+            }
+            removed += hasTo ? 1 : 0;
+        }
+        return removed;
+    }
+
+    const Options& m_Options;
+    size_t m_AttributeCount = 0;
+    bool m_HasBorder = false;
+
+    std::vector<glm::vec3> m_Points;
+    std::vector<uint32_t> m_PositionOf;     // Wedge -> canonical vertex of its position
+    std::vector<uint32_t> m_Remap;
+    std::vector<VertexKind> m_Kinds;        // By canonical vertex
+    std::vector<Quadric> m_PositionQuadrics;
+    std::vector<Quadric> m_AttributeQuadrics;
+    std::vector<AttributeGradient> m_Gradients;
+    std::vector<AttributeGradient> m_TriangleGradients;
+
+    // Per pass
+    std::span<const uint32_t> m_Indices;
+    std::vector<uint32_t> m_AdjacencyOffset;
+    std::vector<uint32_t> m_Adjacency;
+    std::unordered_set<uint64_t> m_Edges;
+    std::vector<uint8_t> m_Locked;
+    std::vector<std::pair<uint32_t, uint32_t>> m_WedgePairs;
+    std::vector<uint32_t> m_UsedWedges;
+};
+
+} // namespace
+
+float GetScale(std::span<const glm::vec3> positions) {
+    if (positions.empty()) return 0.0f;
+    glm::vec3 minimum(FLT_MAX), maximum(-FLT_MAX);
+    for (const glm::vec3& p : positions) {
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+    const glm::vec3 extent = maximum - minimum;
+    return std::max(extent.x, std::max(extent.y, extent.z));
+}
+
+Result Simplify(std::span<const glm::vec3> positions, std::span<const uint32_t> indices,
+                std::vector<uint32_t>& outIndices, const Options& options) {
+    LUCENT_PROFILE_FUNCTION();
+
+    outIndices.assign(indices.begin(), indices.end());
+    outIndices.resize(outIndices.size() - outIndices.size() % 3);
+
+    Result result;
+    result.indexCount = outIndices.size();
+    if (outIndices.size() <= options.targetIndexCount || positions.empty()) return result;
+    if (!options.attributeWeights.empty() &&
+        options.attributes.size() < positions.size() * options.attributeWeights.size()) {
+        return result;
+    }
+
+    SimplifierState state(positions, options);
+    state.RemoveDegenerate(outIndices);
+    state.Classify(outIndices);
+    state.AddTriangleQuadrics(outIndices);
+
+    const double errorLimit = static_cast<double>(options.targetError) * options.targetError;
+    double maxError = 0.0;
+    while (outIndices.size() > options.targetIndexCount) {
+        if (!state.Pass(outIndices, options.targetIndexCount, errorLimit, maxError)) break;
+    }
+
+    result.indexCount = outIndices.size();
+    result.error = static_cast<float>(std::sqrt(maxError));
+    return result;
+}
+
+} // namespace Simplifier
+} // namespace lucent::mesh
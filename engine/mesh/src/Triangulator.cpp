@@ -1,14 +1,17 @@
 #include "lucent/mesh/Triangulator.h"
+#include "lucent/core/Arena.h"
 #include <algorithm>
 #include <cmath>
 
 namespace lucent::mesh {
 
-std::vector<glm::vec2> Triangulator::ProjectTo2D(
-    const std::vector<glm::vec3>& vertices,
-    const glm::vec3& normal
+void Triangulator::ProjectTo2D(
+    std::span<const glm::vec3> vertices,
+    const glm::vec3& normal,
+    std::pmr::vector<glm::vec2>& outProjected
 ) {
-    if (vertices.empty()) return {};
+    outProjected.clear();
+    if (vertices.empty()) return;
     
     // Find the dominant axis of the normal to project onto a 2D plane
     glm::vec3 absNormal = glm::abs(normal);
@@ -23,8 +26,7 @@ std::vector<glm::vec2> Triangulator::ProjectTo2D(
         dropAxis = 2; // Drop Z, project onto XY
     }
     
-    std::vector<glm::vec2> result;
-    result.reserve(vertices.size());
+    outProjected.reserve(vertices.size());
     
     for (const auto& v : vertices) {
         glm::vec2 p;
@@ -33,9 +35,8 @@ std::vector<glm::vec2> Triangulator::ProjectTo2D(
             case 1: p = glm::vec2(v.x, v.z); break;
             case 2: p = glm::vec2(v.x, v.y); break;
         }
-        result.push_back(p);
+        outProjected.push_back(p);
     }
-    return result;
 }
 
 bool Triangulator::IsConvex(
@@ -71,8 +72,8 @@ bool Triangulator::PointInTriangle(
 }
 
 bool Triangulator::IsEar(
-    const std::vector<glm::vec2>& vertices,
-    const std::vector<uint32_t>& indices,
+    std::span<const glm::vec2> vertices,
+    std::span<const uint32_t> indices,
     uint32_t prevIdx,
     uint32_t currIdx,
     uint32_t nextIdx
@@ -106,16 +107,27 @@ bool Triangulator::IsEar(
     return true;
 }
 
-std::vector<uint32_t> Triangulator::Triangulate2D(const std::vector<glm::vec2>& vertices) {
-    std::vector<uint32_t> result;
-    
-    if (vertices.size() < 3) return result;
+std::vector<uint32_t> Triangulator::Triangulate2D(std::span<const glm::vec2> vertices) {
+    ScratchScope scratch;
+    std::pmr::vector<uint32_t> tri(scratch.Resource());
+    Triangulate2D(vertices, tri);
+    return std::vector<uint32_t>(tri.begin(), tri.end());
+}
+
+void Triangulator::Triangulate2D(std::span<const glm::vec2> vertices, std::pmr::vector<uint32_t>& result) {
+    if (vertices.size() < 3) return;
     if (vertices.size() == 3) {
-        return {0, 1, 2};
+        result.insert(result.end(), {0u, 1u, 2u});
+        return;
     }
     
+    // Ear clipping (and the fan fallback) always emit n - 2 triangles. Reserve before opening
+    // our scratch scope: `result` may live in an outer scope of the same arena.
+    result.reserve(result.size() + (vertices.size() - 2) * 3);
+    ScratchScope scratch;
+    
     // Initialize index list
-    std::vector<uint32_t> indices;
+    std::pmr::vector<uint32_t> indices(scratch.Resource());
     indices.reserve(vertices.size());
     for (uint32_t i = 0; i < vertices.size(); ++i) {
         indices.push_back(i);
@@ -169,21 +181,36 @@ std::vector<uint32_t> Triangulator::Triangulate2D(const std::vector<glm::vec2>&
             result.push_back(indices[i + 1]);
         }
     }
-    
-    return result;
 }
 
 std::vector<uint32_t> Triangulator::Triangulate(
-    const std::vector<glm::vec3>& vertices,
+    std::span<const glm::vec3> vertices,
     const glm::vec3& faceNormal
 ) {
-    if (vertices.size() < 3) return {};
+    ScratchScope scratch;
+    std::pmr::vector<uint32_t> tri(scratch.Resource());
+    Triangulate(vertices, faceNormal, tri);
+    return std::vector<uint32_t>(tri.begin(), tri.end());
+}
+
+void Triangulator::Triangulate(
+    std::span<const glm::vec3> vertices,
+    const glm::vec3& faceNormal,
+    std::pmr::vector<uint32_t>& outIndices
+) {
+    outIndices.clear();
+    if (vertices.size() < 3) return;
     if (vertices.size() == 3) {
-        return {0, 1, 2};
+        outIndices.insert(outIndices.end(), {0u, 1u, 2u});
+        return;
     }
     
+    outIndices.reserve((vertices.size() - 2) * 3);
+    ScratchScope scratch;
+    
     // Project to 2D (no reordering here — we keep indices aligned with the input vertex order)
-    std::vector<glm::vec2> projected = ProjectTo2D(vertices, faceNormal);
+    std::pmr::vector<glm::vec2> projected(scratch.Resource());
+    ProjectTo2D(vertices, faceNormal, projected);
     
     // Determine whether we need to reverse polygon order so the triangulation winding
     // matches the supplied face normal (and our convention of CCW front faces).
@@ -219,18 +246,17 @@ std::vector<uint32_t> Triangulator::Triangulate(
     bool needsReverse = (isCCW != normalPositive);
     
     if (!needsReverse) {
-        return Triangulate2D(projected);
+        Triangulate2D(projected, outIndices);
+        return;
     }
     
     // Triangulate a reversed order polygon, then map indices back to the original order.
-    std::vector<glm::vec2> reversedProjected = projected;
-    std::reverse(reversedProjected.begin(), reversedProjected.end());
+    std::reverse(projected.begin(), projected.end());
     
-    std::vector<uint32_t> tri = Triangulate2D(reversedProjected);
-    for (uint32_t& idx : tri) {
+    Triangulate2D(projected, outIndices);
+    for (uint32_t& idx : outIndices) {
         idx = static_cast<uint32_t>(projected.size() - 1u - idx);
     }
-    return tri;
 }
 
 } // namespace lucent::mesh
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "lucent/core/Core.h"
+#include "lucent/assets/MeshRegistry.h"
 #include "lucent/mesh/EditableMesh.h"
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -125,7 +126,7 @@ struct LightComponent {
 
 // Mesh renderer component
 struct MeshRendererComponent {
-    uint32_t meshAssetID = UINT32_MAX; // Reference to mesh asset
+    assets::MeshHandle meshAsset; // Reference to mesh asset (released with the component)
     uint32_t materialAssetID = UINT32_MAX; // Reference to material asset
     std::string materialPath; // Path to material asset file (.lmat)
     bool visible = true;
@@ -192,14 +193,11 @@ struct EditableMeshComponent {
     // Mark mesh as modified (triggers re-triangulation)
     void MarkDirty() { dirty = true; }
     
-    // Get triangulated output for rendering
+    // Get triangulated output for rendering (typically into ScratchScope-backed buffers)
     // Returns true if mesh was re-triangulated
     bool GetTriangulatedOutput(
-        std::vector<glm::vec3>& outPositions,
-        std::vector<glm::vec3>& outNormals,
-        std::vector<glm::vec2>& outUVs,
-        std::vector<glm::vec4>& outTangents,
-        std::vector<uint32_t>& outIndices
+        std::pmr::vector<mesh::TriangleOutput::Vertex>& outVertices,
+        std::pmr::vector<uint32_t>& outIndices
     );
 };
 
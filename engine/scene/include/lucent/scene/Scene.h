@@ -183,6 +183,9 @@ public:
     
     // Clear all entities
     void Clear();
+    // Exchange every entity, component and setting with `other`; Entity handles keep pointing at
+    // the Scene object they were made from
+    void Swap(Scene& other);
     
     // Find primary camera
     Entity GetPrimaryCamera();
@@ -463,49 +463,27 @@ void EditableMeshComponent::InitFromTriangles(
 }
 
 bool EditableMeshComponent::GetTriangulatedOutput(
-    std::vector<glm::vec3>& outPositions,
-    std::vector<glm::vec3>& outNormals,
-    std::vector<glm::vec2>& outUVs,
-    std::vector<glm::vec4>& outTangents,
-    std::vector<uint32_t>& outIndices
+    std::pmr::vector<mesh::TriangleOutput::Vertex>& outVertices,
+    std::pmr::vector<uint32_t>& outIndices
 ) {
     if (!mesh || !dirty) {
         return false;
     }
     
     // Triangulate the editable mesh
-    auto output = mesh->ToTriangles();
+    outVertices.clear();
+    outIndices.clear();
+    mesh->AppendTriangles(outVertices, outIndices);
     
-    if (output.vertices.empty() || output.indices.empty()) {
+    if (outVertices.empty() || outIndices.empty()) {
         LUCENT_CORE_WARN("EditableMesh triangulation produced no geometry");
         return false;
     }
     
-    // Copy to output vectors
-    outPositions.clear();
-    outNormals.clear();
-    outUVs.clear();
-    outTangents.clear();
-    outIndices.clear();
-    
-    outPositions.reserve(output.vertices.size());
-    outNormals.reserve(output.vertices.size());
-    outUVs.reserve(output.vertices.size());
-    outTangents.reserve(output.vertices.size());
-    
-    for (const auto& v : output.vertices) {
-        outPositions.push_back(v.position);
-        outNormals.push_back(v.normal);
-        outUVs.push_back(v.uv);
-        outTangents.push_back(v.tangent);
-    }
-    
-    outIndices = std::move(output.indices);
-    
     dirty = false;
     
     LUCENT_CORE_DEBUG("EditableMesh triangulated: {} vertices, {} indices",
-                      outPositions.size(), outIndices.size());
+                      outVertices.size(), outIndices.size());
     
     return true;
 }
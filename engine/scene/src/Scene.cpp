@@ -1,5 +1,7 @@
 #include "lucent/scene/Scene.h"
 
+#include <utility>
+
 namespace lucent::scene {
 
 Scene::Scene(const std::string& name) 
@@ -75,6 +77,14 @@ void Scene::Clear() {
     LUCENT_CORE_DEBUG("Scene cleared");
 }
 
+void Scene::Swap(Scene& other) {
+    std::swap(m_Name, other.m_Name);
+    std::swap(m_Entities, other.m_Entities);
+    std::swap(m_ComponentArrays, other.m_ComponentArrays);
+    std::swap(m_EnvironmentMapPath, other.m_EnvironmentMapPath);
+    std::swap(m_NextEntityID, other.m_NextEntityID);
+}
+
 Entity Scene::GetPrimaryCamera() {
     auto* cameraArray = GetComponentArray<CameraComponent>();
     if (!cameraArray) return Entity();
@@ -5,6 +5,9 @@ layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec4 inTangent;
 
+// Per-instance model matrix (binding 1, instance rate; locations 4-7)
+layout(location = 4) in mat4 inInstanceModel;
+
 layout(location = 0) out vec3 outWorldPos;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outUV;
@@ -14,7 +17,7 @@ layout(location = 5) out vec4 outShadowCoord;
 
 // Push constants for per-object data
 layout(push_constant) uniform PushConstants {
-    mat4 model;
+    mat4 model;          // Unused: instanced draws take the transform from inInstanceModel
     mat4 viewProj;
     vec4 baseColor;      // RGB + alpha
     vec4 materialParams; // metallic, roughness, emissiveIntensity, shadowBias
@@ -24,11 +27,11 @@ layout(push_constant) uniform PushConstants {
 } pc;
 
 void main() {
-    vec4 worldPos = pc.model * vec4(inPosition, 1.0);
+    vec4 worldPos = inInstanceModel * vec4(inPosition, 1.0);
     outWorldPos = worldPos.xyz;
     
     // Transform normal to world space
-    mat3 normalMatrix = transpose(inverse(mat3(pc.model)));
+    mat3 normalMatrix = transpose(inverse(mat3(inInstanceModel)));
     outNormal = normalize(normalMatrix * inNormal);
     outTangent = normalize(normalMatrix * inTangent.xyz);
     outBitangent = cross(outNormal, outTangent) * inTangent.w;
@@ -4,12 +4,14 @@
 
 layout(location = 0) in vec3 inPosition;
 
+// Per-instance model matrix (binding 1, instance rate)
+layout(location = 1) in mat4 inInstanceModel;
+
 layout(push_constant) uniform PushConstants {
-    mat4 model;
+    mat4 model;          // Unused: instanced draws take the transform from inInstanceModel
     mat4 lightViewProj;
 } pc;
 
 void main() {
-    gl_Position = pc.lightViewProj * pc.model * vec4(inPosition, 1.0);
+    gl_Position = pc.lightViewProj * inInstanceModel * vec4(inPosition, 1.0);
 }
-
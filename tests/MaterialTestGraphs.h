@@ -0,0 +1,70 @@
+#pragma once
+
+#include <lucent/material/MaterialGraph.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Graph-building helpers shared by the material tests and benchmarks
+
+namespace lucent::material::test {
+
+// Input pin of `nodeId` called `name`, or INVALID_PIN_ID
+inline PinID FindInput(const MaterialGraph& graph, NodeID nodeId, const std::string& name) {
+    for (PinID pinId : graph.GetNode(nodeId)->inputPins) {
+        if (graph.GetPin(pinId)->name == name) return pinId;
+    }
+    return INVALID_PIN_ID;
+}
+
+inline PinID Input(const MaterialGraph& graph, NodeID nodeId, size_t index) {
+    return graph.GetNode(nodeId)->inputPins[index];
+}
+
+inline PinID Output(const MaterialGraph& graph, NodeID nodeId, size_t index = 0) {
+    return graph.GetNode(nodeId)->outputPins[index];
+}
+
+// Node whose output feeds `inputPin`, or INVALID_NODE_ID
+inline NodeID SourceNode(const MaterialGraph& graph, PinID inputPin) {
+    const LinkID linkId = graph.FindLinkByEndPin(inputPin);
+    return linkId != INVALID_LINK_ID ? graph.GetPinNodeId(graph.GetLink(linkId)->startPinId) : INVALID_NODE_ID;
+}
+
+inline NodeID AddConst(MaterialGraph& graph, float value) {
+    const NodeID id = graph.CreateNode(NodeType::ConstFloat);
+    graph.GetNode(id)->parameter = value;
+    return id;
+}
+
+inline NodeID AddConst(MaterialGraph& graph, const glm::vec3& value) {
+    const NodeID id = graph.CreateNode(NodeType::ConstVec3);
+    graph.GetNode(id)->parameter = value;
+    return id;
+}
+
+// Node of `type` with the first output of each of `inputs` linked into its inputs in order
+// (INVALID_NODE_ID leaves that input unlinked)
+inline NodeID AddNode(MaterialGraph& graph, NodeType type, std::initializer_list<NodeID> inputs) {
+    const NodeID id = graph.CreateNode(type);
+    size_t index = 0;
+    for (NodeID input : inputs) {
+        if (input != INVALID_NODE_ID) graph.CreateLink(Output(graph, input), Input(graph, id, index));
+        ++index;
+    }
+    return id;
+}
+
+// Link `source` into the output node's input called `outputPin` (e.g. "Base Color")
+inline void LinkToOutput(MaterialGraph& graph, PinID source, const std::string& outputPin) {
+    graph.CreateLink(source, FindInput(graph, graph.GetOutputNodeId(), outputPin));
+}
+
+// Link the first output of `from` into the output node's input called `outputPin`
+inline void ConnectToOutput(MaterialGraph& graph, NodeID from, const std::string& outputPin) {
+    LinkToOutput(graph, Output(graph, from), outputPin);
+}
+
+} // namespace lucent::material::test
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <lucent/core/Log.h>
+
+#include <cstdio>
+
+// Minimal runner shared by the unit tests. CHECK records a failure and carries on, so one run
+// reports every broken expectation; main() returns lucent::test::Finish("Suite") as its exit code.
+
+namespace lucent::test {
+
+inline int s_Failures = 0;
+
+// Log the outcome of the suite; 0 when every CHECK passed, 1 otherwise
+inline int Finish(const char* suite) {
+    if (s_Failures > 0) {
+        LUCENT_ERROR("{} tests failed: {}", suite, s_Failures);
+        return 1;
+    }
+    LUCENT_INFO("{} tests passed!", suite);
+    return 0;
+}
+
+} // namespace lucent::test
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            std::printf("CHECK failed: %s (%s:%d)\n", #cond, __FILE__, __LINE__); \
+            ++::lucent::test::s_Failures;                                       \
+        }                                                                       \
+    } while (false)
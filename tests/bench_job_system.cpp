@@ -0,0 +1,63 @@
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+
+#include <atomic>
+#include <chrono>
+
+// Scheduling-overhead benchmark: measures per-job cost of empty jobs and ParallelFor dispatch.
+// Not registered with CTest; run manually (bench_job_system [workerCount]).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedNs(Clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    lucent::Log::Init();
+
+    lucent::JobSystemConfig config{};
+    if (argc > 1) {
+        config.workerCount = static_cast<uint32_t>(std::atoi(argv[1]));
+    }
+    auto& jobs = lucent::JobSystem::Get();
+    jobs.Init(config);
+
+    constexpr uint32_t kJobCount = 200000;
+    constexpr int kRounds = 5;
+
+    for (int round = 0; round < kRounds; ++round) {
+        // Empty jobs: pure scheduling cost
+        std::atomic<uint32_t> executed{ 0 };
+        lucent::JobCounter counter;
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < kJobCount; ++i) {
+            jobs.Schedule([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        }
+        jobs.Wait(counter);
+        const double emptyNs = ElapsedNs(start) / kJobCount;
+
+        // ParallelFor over a trivially small body: dispatch cost per chunk
+        std::atomic<uint64_t> sink{ 0 };
+        start = Clock::now();
+        for (int i = 0; i < 1000; ++i) {
+            jobs.ParallelFor(1024, 64, [&sink](uint32_t begin, uint32_t end) {
+                sink.fetch_add(end - begin, std::memory_order_relaxed);
+            });
+        }
+        const double pforNs = ElapsedNs(start) / 1000.0;
+
+        LUCENT_INFO("Round {}: {:.1f} ns/job (empty), {:.1f} us per ParallelFor(1024, grain 64)",
+            round, emptyNs, pforNs / 1000.0);
+    }
+
+    const auto stats = jobs.GetStats();
+    LUCENT_INFO("Workers: {}, executed: {}, stolen: {}", jobs.GetWorkerCount(), stats.jobsExecuted, stats.jobsStolen);
+
+    jobs.Shutdown();
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialGraphEval.h>
+#include <lucent/material/MaterialProgram.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// CPU material evaluation throughput: shading points per second for a UV-varying graph (noise,
+// color ramp, math, CustomCode), run one point per call and in batches, next to the tracer
+// constant evaluator walking the same graph once per point.
+// Not registered with CTest; run manually (bench_material_program [resolution]).
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRounds = 3;
+
+// Noise -> ramp -> Base Color, noise -> CustomCode -> Roughness, UV math -> Emissive
+MaterialGraph MakeGraph() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+
+    const NodeID uv = graph.CreateNode(NodeType::UV);
+    const NodeID noise = graph.CreateNode(NodeType::Noise);
+    graph.GetNode(noise)->parameter = std::string("NOISE2:0;6.0,5.0,0.5,0.3");
+    const NodeID ramp = graph.CreateNode(NodeType::ColorRamp);
+    graph.GetNode(ramp)->parameter = std::string("RAMP:0.0,0.1,0.05,0.0;0.5,0.8,0.4,0.1;1.0,1.0,0.9,0.7");
+    const NodeID custom = graph.CreateNode(NodeType::CustomCode);
+    graph.GetNode(custom)->parameter = std::string("Out = vec3(clamp(In.x * In.x * 1.5 + 0.1, 0.0, 1.0));");
+    graph.RebuildNodePins(custom);
+    const NodeID widen = graph.CreateNode(NodeType::Vec2ToVec3);
+    const NodeID sine = graph.CreateNode(NodeType::Multiply);
+
+    graph.CreateLink(graph.GetNode(uv)->outputPins[0], graph.GetNode(widen)->inputPins[0]);
+    graph.CreateLink(graph.GetNode(widen)->outputPins[0], graph.GetNode(noise)->inputPins[0]);
+    graph.CreateLink(graph.GetNode(noise)->outputPins[0], graph.GetNode(ramp)->inputPins[0]);
+    ConnectToOutput(graph, ramp, "Base Color");
+    graph.CreateLink(graph.GetNode(noise)->outputPins[1], graph.GetNode(custom)->inputPins[0]);
+    ConnectToOutput(graph, custom, "Roughness");
+    graph.CreateLink(graph.GetNode(widen)->outputPins[0], graph.GetNode(sine)->inputPins[0]);
+    ConnectToOutput(graph, sine, "Emissive");
+    return graph;
+}
+
+template <typename Fn>
+double Best(Fn fn) {
+    double best = 1e30;
+    for (int round = 0; round < kRounds; ++round) {
+        const auto start = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    lucent::Log::Init();
+
+    const uint32_t resolution = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 512;
+    const uint32_t count = resolution * resolution;
+    std::vector<float> u(count), v(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        u[i] = (static_cast<float>(i % resolution) + 0.5f) / static_cast<float>(resolution);
+        v[i] = (static_cast<float>(i / resolution) + 0.5f) / static_cast<float>(resolution);
+    }
+
+    const MaterialGraph graph = MakeGraph();
+    MaterialProgram program;
+    std::string error;
+    if (!CompileMaterialProgram(graph, program, error)) {
+        LUCENT_ERROR("Compile failed: {}", error);
+        return 1;
+    }
+    LUCENT_INFO("{} points, {} instructions, {} registers (best of {})", count, program.instructions.size(),
+                program.registerCount, kRounds);
+
+    std::vector<float> outputs(static_cast<size_t>(program.outputRowCount) * count);
+    const double batched = Best([&] {
+        MaterialShadingPoints points;
+        points.count = count;
+        points.uv[0] = u.data();
+        points.uv[1] = v.data();
+        program.Execute(points, outputs.data());
+    });
+
+    std::vector<float> one(program.outputRowCount);
+    const double single = Best([&] {
+        MaterialShadingPoints points;
+        points.count = 1;
+        for (uint32_t i = 0; i < count; ++i) {
+            points.uv[0] = &u[i];
+            points.uv[1] = &v[i];
+            program.Execute(points, one.data());
+        }
+    });
+
+    // The tracer evaluator has no per-point inputs; it is timed as one graph walk per point
+    const uint32_t evalCount = std::min(count, 16384u);
+    const double tracer = Best([&] {
+        TracerMaterialConstants constants;
+        for (uint32_t i = 0; i < evalCount; ++i) {
+            (void)EvaluateTracerConstants(graph, constants, error);
+        }
+    });
+
+    auto rate = [](uint32_t n, double seconds) { return static_cast<double>(n) / seconds / 1e6; };
+    LUCENT_INFO("  batched ({} lanes): {:8.3f} ms  {:8.2f} Mpoints/s", MaterialProgram::kLanes, batched * 1e3,
+                rate(count, batched));
+    LUCENT_INFO("  one point per call: {:8.3f} ms  {:8.2f} Mpoints/s", single * 1e3, rate(count, single));
+    LUCENT_INFO("  tracer evaluator:   {:8.3f} ms  {:8.2f} Mpoints/s ({} points)", tracer * 1e3,
+                rate(evalCount, tracer), evalCount);
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+#include <lucent/assets/ModelCache.h>
+#include <lucent/assets/ModelLoader.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #include <Psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// glTF geometry import benchmark: times LoadGLTFGeometry with primitive conversion run inline
+// and then on the JobSystem workers, and reports the process's peak RSS after the first load.
+// Not registered with CTest; run manually (bench_model_loader [model.gltf|model.glb] [workerCount]).
+// Without a model it generates a synthetic multi-mesh GLB (no tangents, so tangent generation
+// is included).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kMeshCount = 256;
+constexpr uint32_t kGridSize = 96;      // Quads per side per mesh
+constexpr int kRounds = 3;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double PeakRssMiB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;   // KiB on Linux
+#endif
+}
+
+template<typename T>
+void Append(std::vector<uint8_t>& bytes, const T& value) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+// Streams one mesh at a time so generating the file does not inflate the peak RSS measurement
+std::string WriteSyntheticModel(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+
+    const uint32_t vertsPerSide = kGridSize + 1;
+    const uint32_t vertexCount = vertsPerSide * vertsPerSide;
+    const uint32_t indexCount = kGridSize * kGridSize * 6;
+    const size_t vertexBytes = size_t(vertexCount) * sizeof(float) * 8;   // Interleaved pos, normal, uv
+    const size_t indexBytes = size_t(indexCount) * sizeof(uint32_t);
+    const size_t meshBytes = vertexBytes + indexBytes;
+    const size_t binBytes = meshBytes * kMeshCount;                       // Multiple of 4
+
+    // Two buffer views per mesh (strided vertices, indices); four accessors per mesh
+    std::string views, accessors, meshes;
+    for (uint32_t m = 0; m < kMeshCount; m++) {
+        const size_t base = size_t(m) * meshBytes;
+        const std::string sep = m == 0 ? "" : ",";
+        views += sep + "{\"buffer\":0,\"byteOffset\":" + std::to_string(base) + ",\"byteLength\":" +
+                 std::to_string(vertexBytes) + ",\"byteStride\":32}," +
+                 "{\"buffer\":0,\"byteOffset\":" + std::to_string(base + vertexBytes) + ",\"byteLength\":" +
+                 std::to_string(indexBytes) + "}";
+
+        const std::string vertexView = std::to_string(m * 2);
+        const std::string count = std::to_string(vertexCount);
+        accessors += sep +
+            "{\"bufferView\":" + vertexView + ",\"byteOffset\":0,\"componentType\":5126,\"count\":" + count +
+            ",\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[" + std::to_string(m + 1) + ",0.1,1]}," +
+            "{\"bufferView\":" + vertexView + ",\"byteOffset\":12,\"componentType\":5126,\"count\":" + count +
+            ",\"type\":\"VEC3\"}," +
+            "{\"bufferView\":" + vertexView + ",\"byteOffset\":24,\"componentType\":5126,\"count\":" + count +
+            ",\"type\":\"VEC2\"}," +
+            "{\"bufferView\":" + std::to_string(m * 2 + 1) + ",\"componentType\":5125,\"count\":" +
+            std::to_string(indexCount) + ",\"type\":\"SCALAR\"}";
+
+        const uint32_t a = m * 4;
+        meshes += sep + "{\"primitives\":[{\"attributes\":{\"POSITION\":" + std::to_string(a) +
+                  ",\"NORMAL\":" + std::to_string(a + 1) + ",\"TEXCOORD_0\":" + std::to_string(a + 2) +
+                  "},\"indices\":" + std::to_string(a + 3) + "}]}";
+    }
+
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},"
+        "\"buffers\":[{\"byteLength\":" + std::to_string(binBytes) + "}],"
+        "\"bufferViews\":[" + views + "],"
+        "\"accessors\":[" + accessors + "],"
+        "\"meshes\":[" + meshes + "]}";
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+    std::vector<uint8_t> bytes;
+    Append(bytes, uint32_t(0x46546C67));  // "glTF"
+    Append(bytes, uint32_t(2));
+    Append(bytes, static_cast<uint32_t>(12 + 8 + json.size() + 8 + binBytes));
+    Append(bytes, static_cast<uint32_t>(json.size()));
+    Append(bytes, uint32_t(0x4E4F534A));  // "JSON"
+    bytes.insert(bytes.end(), json.begin(), json.end());
+    Append(bytes, static_cast<uint32_t>(binBytes));
+    Append(bytes, uint32_t(0x004E4942));  // "BIN\0"
+
+    const auto glbPath = dir / "bench.glb";
+    std::ofstream out(glbPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    for (uint32_t m = 0; m < kMeshCount; m++) {
+        bytes.clear();
+        for (uint32_t y = 0; y < vertsPerSide; y++) {
+            for (uint32_t x = 0; x < vertsPerSide; x++) {
+                const float u = static_cast<float>(x) / kGridSize;
+                const float v = static_cast<float>(y) / kGridSize;
+                for (float f : { u + static_cast<float>(m), 0.1f * u * v, v, 0.0f, 1.0f, 0.0f, u, v }) {
+                    Append(bytes, f);
+                }
+            }
+        }
+        for (uint32_t y = 0; y < kGridSize; y++) {
+            for (uint32_t x = 0; x < kGridSize; x++) {
+                const uint32_t i = y * vertsPerSide + x;
+                for (uint32_t index : { i, i + vertsPerSide, i + 1, i + 1, i + vertsPerSide, i + vertsPerSide + 1 }) {
+                    Append(bytes, index);
+                }
+            }
+        }
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    return glbPath.string();
+}
+
+void RunRounds(const char* label, const std::string& path) {
+    lucent::assets::ModelLoader loader;
+    for (int round = 0; round < kRounds; ++round) {
+        std::vector<lucent::assets::ImportedMesh> meshes;
+        const auto start = Clock::now();
+        if (!loader.LoadGLTFGeometry(path, meshes)) {
+            LUCENT_ERROR("{}", loader.GetLastError());
+            return;
+        }
+        const double ms = ElapsedMs(start);
+
+        size_t vertices = 0, indices = 0;
+        for (const auto& mesh : meshes) {
+            vertices += mesh.vertices.size();
+            indices += mesh.indices.size();
+        }
+        LUCENT_INFO("{} round {}: {:.1f} ms ({} meshes, {} vertices, {} triangles)",
+            label, round, ms, meshes.size(), vertices, indices / 3);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    lucent::Log::Init();
+
+    const auto tempDir = std::filesystem::temp_directory_path() / "lucent_bench_model_loader";
+    const bool synthetic = argc < 2;
+    const std::string path = synthetic ? WriteSyntheticModel(tempDir) : std::string(argv[1]);
+
+    lucent::JobSystemConfig config{};
+    if (argc > 2) {
+        config.workerCount = static_cast<uint32_t>(std::atoi(argv[2]));
+    }
+
+    // ParallelFor runs inline until the job system is started
+    RunRounds("Serial", path);
+    LUCENT_INFO("Peak RSS after first load: {:.1f} MiB", PeakRssMiB());
+
+    auto& jobs = lucent::JobSystem::Get();
+    jobs.Init(config);
+    RunRounds("Parallel", path);
+    LUCENT_INFO("Workers: {}", jobs.GetWorkerCount());
+    jobs.Shutdown();
+
+    if (synthetic) {
+        std::filesystem::remove_all(tempDir);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <lucent/core/Log.h>
+#include <lucent/core/Profiler.h>
+
+#include <chrono>
+#include <filesystem>
+
+// Zone-overhead benchmark: cost of LUCENT_PROFILE_ZONE with capture off and on, plus export time.
+// Not registered with CTest; run manually (bench_profiler).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedNs(Clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+volatile uint32_t s_Sink = 0;
+
+void RunZones(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        LUCENT_PROFILE_ZONE("BenchZone");
+        s_Sink = s_Sink + i;
+    }
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+    LUCENT_PROFILE_THREAD("Bench");
+
+    constexpr uint32_t kZoneCount = 500000;
+    constexpr int kRounds = 5;
+
+    for (int round = 0; round < kRounds; ++round) {
+        auto start = Clock::now();
+        RunZones(kZoneCount);
+        const double idleNs = ElapsedNs(start) / kZoneCount;
+
+#if LUCENT_ENABLE_PROFILER
+        auto& profiler = lucent::Profiler::Get();
+        profiler.StartCapture();
+        start = Clock::now();
+        RunZones(kZoneCount);
+        const double captureNs = ElapsedNs(start) / kZoneCount;
+
+        const auto path = (std::filesystem::temp_directory_path() / "lucent_bench_profile.json").string();
+        start = Clock::now();
+        profiler.StopCapture(path);
+        const double exportMs = ElapsedNs(start) / 1e6;
+        std::filesystem::remove(path);
+
+        LUCENT_INFO("Round {}: {:.1f} ns/zone idle, {:.1f} ns/zone capturing, export {:.1f} ms",
+            round, idleNs, captureNs, exportMs);
+#else
+        LUCENT_INFO("Round {}: {:.1f} ns/zone (profiler compiled out)", round, idleNs);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <lucent/core/Log.h>
+#include <lucent/mesh/Simplifier.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Simplification throughput: input triangles processed per second when reducing a dense,
+// bumpy sphere to a series of targets, with and without attribute quadrics.
+// Not registered with CTest; run manually (bench_simplifier [subdivisions]).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRounds = 3;
+
+struct BenchMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<float> attributes;      // Normal xyz, uv
+    std::vector<uint32_t> indices;
+};
+
+// Latitude/longitude sphere with a displacement so collapse costs vary
+BenchMesh MakeSphere(uint32_t subdivisions) {
+    BenchMesh mesh;
+    const uint32_t rings = subdivisions;
+    const uint32_t segments = subdivisions * 2;
+    for (uint32_t r = 0; r <= rings; ++r) {
+        const float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(rings);
+        for (uint32_t s = 0; s <= segments; ++s) {
+            const float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(segments);
+            const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            const float radius = 1.0f + 0.05f * std::sin(theta * 9.0f) * std::sin(phi * 7.0f);
+            mesh.positions.push_back(normal * radius);
+            mesh.attributes.insert(mesh.attributes.end(), { normal.x, normal.y, normal.z,
+                static_cast<float>(s) / static_cast<float>(segments), static_cast<float>(r) / static_cast<float>(rings) });
+        }
+    }
+    for (uint32_t r = 0; r < rings; ++r) {
+        for (uint32_t s = 0; s < segments; ++s) {
+            const uint32_t i = r * (segments + 1) + s;
+            const uint32_t j = i + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), { i, i + 1, j, i + 1, j + 1, j });
+        }
+    }
+    return mesh;
+}
+
+double Run(const BenchMesh& mesh, const lucent::mesh::Simplifier::Options& options, size_t& outIndexCount) {
+    std::vector<uint32_t> result;
+    double best = 1e30;
+    for (int round = 0; round < kRounds; ++round) {
+        const auto start = Clock::now();
+        lucent::mesh::Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    outIndexCount = result.size();
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    lucent::Log::Init();
+
+    const uint32_t subdivisions = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 384;
+    const BenchMesh mesh = MakeSphere(subdivisions);
+    const size_t triangles = mesh.indices.size() / 3;
+    LUCENT_INFO("Simplifying {} triangles, {} vertices (best of {})", triangles, mesh.positions.size(), kRounds);
+
+    const float weights[] = { 0.5f, 0.5f, 0.5f, 1.0f, 1.0f };
+    for (bool withAttributes : { false, true }) {
+        for (float ratio : { 0.5f, 0.25f, 0.05f }) {
+            lucent::mesh::Simplifier::Options options;
+            options.targetIndexCount = static_cast<size_t>(static_cast<float>(mesh.indices.size()) * ratio) / 3 * 3;
+            options.targetError = 1.0f;
+            if (withAttributes) {
+                options.attributes = mesh.attributes;
+                options.attributeWeights = weights;
+            }
+
+            size_t indexCount = 0;
+            const double seconds = Run(mesh, options, indexCount);
+            LUCENT_INFO("  {:10} -> {:5.1f}%: {:8.2f} ms, {:6.2f} M triangles/s (kept {})",
+                        withAttributes ? "attributes" : "positions", ratio * 100.0f, seconds * 1000.0,
+                        static_cast<double>(triangles) / seconds / 1e6, indexCount / 3);
+        }
+    }
+    return 0;
+}
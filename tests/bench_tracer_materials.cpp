@@ -0,0 +1,134 @@
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/RTMaterialCompiler.h>
+#include <lucent/material/TracerMaterials.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Tracer material gather for a large scene: many mesh instances spread over a few material assets,
+// gathered with one shared entry per material (TracerMaterialTable) and with one copy per instance
+// as BuildTracerSceneData did before. Reports the gather time and the material, header and RT
+// instruction buffer sizes of both.
+// Not registered with CTest; run manually (bench_tracer_materials [instances] [materials]).
+
+namespace {
+
+using namespace lucent;
+using namespace lucent::material;
+using namespace lucent::material::test;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRounds = 3;
+
+// About 30 nodes: UV-driven math into Base Color, so the optimizer leaves a per-hit program to
+// compile, and a constant into Roughness
+MaterialGraph MakeGraph(uint32_t variant) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    NodeID color = AddNode(graph, NodeType::Vec2ToVec3, { graph.CreateNode(NodeType::UV) });
+    for (int i = 0; i < 12; ++i) {
+        const NodeType type = i % 2 == 0 ? NodeType::Multiply : NodeType::Add;
+        const float value = 0.5f + 0.01f * static_cast<float>(i) + 0.1f * static_cast<float>(variant);
+        color = AddNode(graph, type, { color, AddConst(graph, glm::vec3(value, 1.0f - value, 0.5f)) });
+    }
+    ConnectToOutput(graph, color, "Base Color");
+    ConnectToOutput(graph, AddConst(graph, 0.1f + 0.01f * static_cast<float>(variant)), "Roughness");
+    return graph;
+}
+
+gfx::GPUMaterial DefaultMaterial() {
+    gfx::GPUMaterial mat{};
+    mat.baseColor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
+    mat.emissive = glm::vec4(0.0f);
+    mat.metallic = 0.0f;
+    mat.roughness = 0.5f;
+    mat.ior = 1.5f;
+    mat.flags = 0;
+    return mat;
+}
+
+struct Buffers {
+    std::vector<gfx::GPUMaterial> materials;
+    std::vector<gfx::RTMaterialHeader> headers;
+    std::vector<gfx::RTMaterialInstr> instrs;
+
+    void Reset() {
+        materials.assign(1, DefaultMaterial());
+        headers.assign(1, gfx::RTMaterialHeader{});
+        instrs.clear();
+    }
+    size_t Bytes() const {
+        return materials.size() * sizeof(gfx::GPUMaterial) + headers.size() * sizeof(gfx::RTMaterialHeader) +
+               instrs.size() * sizeof(gfx::RTMaterialInstr);
+    }
+};
+
+// The editor's RT material compiler; these graphs sample no textures, so no texture slots
+bool CompileRT(const MaterialGraph& graph, gfx::RTMaterialHeader& header, std::pmr::vector<gfx::RTMaterialInstr>& instrs,
+               std::string& outError) {
+    return CompileRTMaterialProgram(graph, header, instrs, outError);
+}
+
+template <typename Fn>
+double Best(Fn fn) {
+    double best = 1e30;
+    for (int round = 0; round < kRounds; ++round) {
+        const auto start = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    lucent::Log::Init();
+    // The per-material debug lines would dominate the unshared timing
+    lucent::Log::GetCoreLogger()->set_level(spdlog::level::info);
+
+    const uint32_t instances = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 10000;
+    const uint32_t materialCount = std::max(argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 8u, 1u);
+
+    // One graph per material asset; instance i uses material i % materialCount
+    std::vector<MaterialGraph> graphs;
+    for (uint32_t m = 0; m < materialCount; ++m) graphs.push_back(MakeGraph(m));
+    const gfx::GPUMaterial fallback = DefaultMaterial();
+
+    Buffers shared;
+    TracerMaterialStats stats;
+    const double sharedTime = Best([&] {
+        shared.Reset();
+        TracerMaterialTable table(shared.materials, &shared.headers, &shared.instrs, CompileRT);
+        for (uint32_t i = 0; i < instances; ++i) {
+            const MaterialGraph& graph = graphs[i % materialCount];
+            (void)table.Add(&graph, &graph, fallback);
+        }
+        stats = table.GetStats();
+    });
+
+    // A table per instance evaluates, compiles and appends every instance's material again
+    Buffers unshared;
+    const double unsharedTime = Best([&] {
+        unshared.Reset();
+        for (uint32_t i = 0; i < instances; ++i) {
+            TracerMaterialTable table(unshared.materials, &unshared.headers, &unshared.instrs, CompileRT);
+            const MaterialGraph& graph = graphs[i % materialCount];
+            (void)table.Add(&graph, &graph, fallback);
+        }
+    });
+
+    LUCENT_INFO("{} instances, {} materials, {} RT instructions per material (best of {})", instances, materialCount,
+                shared.headers.size() > 1 ? shared.headers[1].instrCount : 0u, kRounds);
+    LUCENT_INFO("  shared:   {:9.3f} ms  {:6} materials  {:10.1f} KB", sharedTime * 1e3, shared.materials.size(),
+                shared.Bytes() / 1024.0);
+    LUCENT_INFO("  unshared: {:9.3f} ms  {:6} materials  {:10.1f} KB", unsharedTime * 1e3,
+                unshared.materials.size(), unshared.Bytes() / 1024.0);
+    LUCENT_INFO("  table estimate of the unshared size: {:.1f} KB", stats.unsharedBytes / 1024.0);
+    return 0;
+}
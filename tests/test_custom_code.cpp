@@ -0,0 +1,158 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/CustomCode.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialGraphEval.h>
+#include <lucent/material/MaterialProgram.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+bool Near(float a, float b, float epsilon = 1e-5f) {
+    return std::fabs(a - b) <= epsilon;
+}
+
+// Default graph with a CustomCode node running `code`, its first output linked into Base Color
+MaterialGraph MakeGraph(const std::string& code, NodeID& outCustom) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    outCustom = graph.CreateNode(NodeType::CustomCode);
+    graph.GetNode(outCustom)->parameter = code;
+    graph.RebuildNodePins(outCustom);
+    ConnectToOutput(graph, outCustom, "Base Color");
+    return graph;
+}
+
+const std::vector<CustomCodePin> kInOut = { { "In", PinType::Vec3 } };
+const std::vector<CustomCodePin> kOut = { { "Out", PinType::Vec3 } };
+
+glm::vec4 Evaluate(const CompiledCustomCode& code, const glm::vec4& in) {
+    glm::vec4 out(0.0f);
+    EvaluateCustomCode(code, &in, &out);
+    return out;
+}
+
+void TestStatements() {
+    const CompiledCustomCode code = CompileCustomCode(
+        "// Locals, compound assignment, swizzles and built-ins\n"
+        "vec3 a = In * 2.0;\n"
+        "a += In.zyx;\n"
+        "float m = max(a.x, a.z);\n"
+        "Out = vec3(a.xy, m) / 2.0;\n",
+        kInOut, kOut);
+    CHECK(code.IsValid());
+    const glm::vec4 out = Evaluate(code, glm::vec4(1.0f, 2.0f, 3.0f, 0.0f));
+    // a = (2, 4, 6) + (3, 2, 1) = (5, 6, 7)
+    CHECK(Near(out.x, 2.5f));
+    CHECK(Near(out.y, 3.0f));
+    CHECK(Near(out.z, 3.5f));
+
+    // Unassigned outputs pass In through
+    const CompiledCustomCode passthrough = CompileCustomCode("", kInOut, kOut);
+    CHECK(passthrough.IsValid());
+    CHECK(Evaluate(passthrough, glm::vec4(4.0f, 5.0f, 6.0f, 0.0f)) == glm::vec4(4.0f, 5.0f, 6.0f, 0.0f));
+
+    const CompiledCustomCode unknown = CompileCustomCode("Out = Missing * 2.0;", kInOut, kOut);
+    CHECK(!unknown.IsValid());
+    CHECK(unknown.error.find("Unknown identifier: Missing") != std::string::npos);
+    CHECK(unknown.exprs.empty());
+}
+
+void TestConstantFolding() {
+    // Everything but In folds; In itself is unused and dropped
+    const CompiledCustomCode folded = CompileCustomCode("float k = 2.0 * 3.0 + sin(0.0);\nOut = vec3(k, k * 0.5, 1.0);", kInOut, kOut);
+    CHECK(folded.IsValid());
+    CHECK(folded.exprs.size() == 1);
+    CHECK(folded.exprs[0].op == MaterialOp::Constant);
+    CHECK(folded.exprs[0].value == glm::vec4(6.0f, 3.0f, 1.0f, 0.0f));
+
+    // Constant subexpressions fold next to varying ones: In, one constant, one multiply
+    const CompiledCustomCode mixed = CompileCustomCode("Out = In * (1.0 + 1.0);", kInOut, kOut);
+    CHECK(mixed.IsValid());
+    CHECK(mixed.exprs.size() == 3);
+    CHECK(mixed.exprs.back().op == MaterialOp::Multiply);
+    CHECK(Near(Evaluate(mixed, glm::vec4(1.5f, 0.0f, 0.0f, 0.0f)).x, 3.0f));
+}
+
+void TestCache() {
+    const std::string code = "Out = In * 2.0;";
+    NodeID a = INVALID_NODE_ID, b = INVALID_NODE_ID;
+    MaterialGraph graphA = MakeGraph(code, a);
+    const MaterialGraph graphB = MakeGraph(code, b);
+
+    // Same source and pins: one compile for every graph and copy
+    const auto first = GetCompiledCustomCode(graphA, *graphA.GetNode(a));
+    CHECK(first == GetCompiledCustomCode(graphB, *graphB.GetNode(b)));
+    const MaterialGraph copy = graphA;
+    CHECK(first == GetCompiledCustomCode(copy, *copy.GetNode(a)));
+
+    // Editing the source invalidates
+    graphA.GetNode(a)->parameter = std::string("Out = In * 3.0;");
+    const auto edited = GetCompiledCustomCode(graphA, *graphA.GetNode(a));
+    CHECK(edited != first);
+    CHECK(Near(Evaluate(*edited, glm::vec4(1.0f)).x, 3.0f));
+
+    // So does changing a pin the body reads
+    graphA.GetNode(a)->parameter = code;
+    graphA.GetPin(FindInput(graphA, a, "In"))->type = PinType::Float;
+    CHECK(GetCompiledCustomCode(graphA, *graphA.GetNode(a)) != first);
+}
+
+// The tracer constant evaluator and the CPU shading program run the same compiled body
+void TestBackendsAgree() {
+    NodeID custom = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(
+        "uniform float Gain;\n"
+        "vec3 c = clamp(In * Gain - vec3(0.25), 0.0, 1.0);\n"
+        "Out = mix(c, c.zyx, 0.25) / 2.0;\n",
+        custom);
+    graph.GetPin(FindInput(graph, custom, "In"))->defaultValue = glm::vec3(0.2f, 0.5f, 0.9f);
+    graph.GetPin(FindInput(graph, custom, "Gain"))->defaultValue = 1.5f;
+
+    TracerMaterialConstants constants;
+    std::string error;
+    CHECK(EvaluateTracerConstants(graph, constants, error));
+    CHECK(error.empty());
+
+    MaterialProgram program;
+    CHECK(CompileMaterialProgram(graph, program, error));
+    MaterialShadingPoints points;
+    points.count = 1;
+    std::vector<float> values(program.outputRowCount);
+    program.Execute(points, values.data());
+    const MaterialProgramOutput* baseColor = program.FindOutput("Base Color");
+    CHECK(baseColor != nullptr);
+    if (!baseColor) return;
+
+    // c = (0.05, 0.5, 1.0); mix with (1.0, 0.5, 0.05) at 0.25, halved
+    const glm::vec3 expected(0.14375f, 0.25f, 0.38125f);
+    for (int c = 0; c < 3; ++c) {
+        CHECK(Near(constants.baseColor[c], expected[c]));
+        CHECK(Near(values[baseColor->row + c], expected[c]));
+    }
+
+    // Bodies the CPU cannot run are reported by both
+    graph.GetNode(custom)->parameter = std::string("if (In.x > 0.0) Out = In;");
+    CHECK(!EvaluateTracerConstants(graph, constants, error));
+    CHECK(error.find("CustomCode") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestStatements();
+    TestConstantFolding();
+    TestCache();
+    TestBackendsAgree();
+
+    return lucent::test::Finish("CustomCode");
+}
@@ -0,0 +1,218 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+#include <lucent/core/MappedFile.h>
+#include <lucent/gfx/EnvironmentProcessing.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lucent::gfx::DecodedImage;
+using lucent::gfx::ProcessedEnvironment;
+
+constexpr float kPi = 3.14159265359f;
+
+DecodedImage MakeHDRImage(uint32_t width, uint32_t height, float (*fn)(uint32_t x, uint32_t y, int c)) {
+    DecodedImage image;
+    image.width = width;
+    image.height = height;
+    image.hdr = true;
+    image.bytesPerPixel = 16;
+    std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            for (int c = 0; c < 4; ++c) {
+                pixels[(static_cast<size_t>(y) * width + x) * 4 + c] = c == 3 ? 1.0f : fn(x, y, c);
+            }
+        }
+    }
+    image.pixels.resize(pixels.size() * sizeof(float));
+    std::memcpy(image.pixels.data(), pixels.data(), image.pixels.size());
+    return image;
+}
+
+float HalfToFloat(uint32_t half) {
+    const uint32_t exponent = (half >> 10) & 31, mantissa = half & 1023;
+    if (exponent == 0) return std::ldexp(static_cast<float>(mantissa), -24);
+    return std::ldexp(static_cast<float>(mantissa | 1024), static_cast<int>(exponent) - 25);
+}
+
+float GetTexel(const ProcessedEnvironment& env, uint32_t level, uint32_t x, uint32_t y, int c) {
+    const lucent::gfx::TextureLevel& l = env.levels[level];
+    return HalfToFloat(env.texels[l.offset / sizeof(uint16_t) + (static_cast<size_t>(y) * l.width + x) * 4 + c]);
+}
+
+bool IsMonotonic(const float* values, size_t count) {
+    for (size_t i = 1; i < count; ++i) {
+        if (values[i] < values[i - 1]) return false;
+    }
+    return true;
+}
+
+void TestSamplingTables() {
+    // Uniform radiance: columns are equally likely, rows follow sin(theta)
+    DecodedImage uniform = MakeHDRImage(16, 8, [](uint32_t, uint32_t, int) { return 1.0f; });
+    ProcessedEnvironment env;
+    CHECK(lucent::gfx::ProcessEnvironment(uniform, env));
+    CHECK(env.marginalCDF.size() == 8 && env.conditionalCDF.size() == 16 * 8);
+    CHECK(IsMonotonic(env.marginalCDF.data(), env.marginalCDF.size()));
+    CHECK(env.marginalCDF.back() == 1.0f);
+    for (uint32_t y = 0; y < 8; ++y) {
+        for (uint32_t x = 0; x < 16; ++x) {
+            CHECK(std::abs(env.conditionalCDF[y * 16 + x] - static_cast<float>(x + 1) / 16.0f) < 1e-5f);
+        }
+    }
+    float sinSum = 0.0f;
+    for (uint32_t y = 0; y < 8; ++y) sinSum += std::sin(kPi * (static_cast<float>(y) + 0.5f) / 8.0f);
+    for (uint32_t y = 0; y < 8; ++y) {
+        const float pdf = env.marginalCDF[y] - (y > 0 ? env.marginalCDF[y - 1] : 0.0f);
+        CHECK(std::abs(pdf - std::sin(kPi * (static_cast<float>(y) + 0.5f) / 8.0f) / sinSum) < 1e-5f);
+    }
+
+    // One bright texel takes all the probability
+    DecodedImage spot = MakeHDRImage(16, 8, [](uint32_t x, uint32_t y, int) { return x == 5 && y == 3 ? 50.0f : 0.0f; });
+    CHECK(lucent::gfx::ProcessEnvironment(spot, env));
+    CHECK(env.marginalCDF[2] == 0.0f && env.marginalCDF[3] == 1.0f);
+    CHECK(env.conditionalCDF[3 * 16 + 4] == 0.0f && env.conditionalCDF[3 * 16 + 5] == 1.0f);
+    // Black rows fall back to uniform columns
+    CHECK(std::abs(env.conditionalCDF[0 * 16 + 7] - 0.5f) < 1e-6f);
+
+    // Beyond the half range: clamped, and the tables see the clamped value
+    DecodedImage hot = MakeHDRImage(4, 2, [](uint32_t x, uint32_t, int) { return x == 0 ? 1e6f : -1.0f; });
+    CHECK(lucent::gfx::ProcessEnvironment(hot, env));
+    CHECK(GetTexel(env, 0, 0, 0, 0) == 65504.0f);
+    CHECK(GetTexel(env, 0, 1, 0, 0) == 0.0f);
+    CHECK(env.conditionalCDF[0] == 1.0f);
+
+    DecodedImage empty;
+    std::string error;
+    CHECK(!lucent::gfx::ProcessEnvironment(empty, env, &error) && !error.empty());
+}
+
+void TestMipChain() {
+    DecodedImage constant = MakeHDRImage(13, 7, [](uint32_t, uint32_t, int) { return 2.0f; });
+    ProcessedEnvironment env;
+    CHECK(lucent::gfx::ProcessEnvironment(constant, env));
+    CHECK(env.GetMipCount() == 4); // 13x7, 6x3, 3x1, 1x1
+    CHECK(env.levels[1].width == 6 && env.levels[1].height == 3);
+    CHECK(env.levels[3].width == 1 && env.levels[3].height == 1);
+    CHECK(env.texels.size() * sizeof(uint16_t) == env.levels[3].offset + env.levels[3].size);
+    for (uint32_t level = 0; level < env.GetMipCount(); ++level) {
+        CHECK(GetTexel(env, level, 0, 0, 1) == 2.0f);
+        CHECK(GetTexel(env, level, env.levels[level].width - 1, env.levels[level].height - 1, 3) == 1.0f);
+    }
+
+    // Rows are weighted by solid angle: the pole row counts for sin(pi/8) against the next
+    // row's sin(3pi/8)
+    DecodedImage polar = MakeHDRImage(2, 4, [](uint32_t, uint32_t y, int) { return y == 0 ? 1.0f : 0.0f; });
+    CHECK(lucent::gfx::ProcessEnvironment(polar, env));
+    const float pole = std::sin(kPi / 8.0f), next = std::sin(3.0f * kPi / 8.0f);
+    CHECK(std::abs(GetTexel(env, 1, 0, 0, 0) - pole / (pole + next)) < 1e-3f);
+    CHECK(GetTexel(env, 1, 0, 1, 0) == 0.0f);
+}
+
+void TestCache() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lucent_test_envcache";
+    std::filesystem::remove_all(directory);
+
+    DecodedImage image = MakeHDRImage(12, 6, [](uint32_t x, uint32_t y, int c) {
+        return static_cast<float>(x * 3 + y * 5 + c) * 0.37f;
+    });
+    ProcessedEnvironment env;
+    CHECK(lucent::gfx::ProcessEnvironment(image, env));
+
+    const std::string path = lucent::gfx::GetEnvironmentCachePath(directory.string(), 0x1234);
+    CHECK(path == lucent::gfx::GetEnvironmentCachePath(directory.string(), 0x1234));
+    CHECK(path != lucent::gfx::GetEnvironmentCachePath(directory.string(), 0x1235));
+
+    std::string error;
+    CHECK(lucent::gfx::WriteEnvironmentCache(path, 0x1234, env, &error));
+
+    ProcessedEnvironment loaded;
+    CHECK(lucent::gfx::ReadEnvironmentCache(path, 0x1234, loaded, &error));
+    CHECK(loaded.width == 12 && loaded.height == 6);
+    CHECK(loaded.GetMipCount() == env.GetMipCount());
+    CHECK(loaded.texels == env.texels);
+    CHECK(loaded.marginalCDF == env.marginalCDF);
+    CHECK(loaded.conditionalCDF == env.conditionalCDF);
+
+    // Other contents or a truncated file are rejected
+    CHECK(!lucent::gfx::ReadEnvironmentCache(path, 0x1235, loaded));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    CHECK(!lucent::gfx::ReadEnvironmentCache(path, 0x1234, loaded, &error));
+    CHECK(!lucent::gfx::ReadEnvironmentCache((directory / "missing.lenv").string(), 0x1234, loaded));
+
+    std::filesystem::remove_all(directory);
+}
+
+void WritePPM(const std::filesystem::path& path, uint32_t width, uint32_t height, uint8_t value) {
+    std::ofstream out(path, std::ios::binary);
+    out << "P6 " << width << " " << height << " 255\n";
+    const std::vector<char> pixels(static_cast<size_t>(width) * height * 3, static_cast<char>(value));
+    out.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+}
+
+void TestLoadFile() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lucent_test_envload";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path source = directory / "sky.ppm";
+    const std::string cacheDirectory = (directory / "cache").string();
+    WritePPM(source, 8, 4, 255);
+
+    ProcessedEnvironment first, second;
+    std::string error;
+    CHECK(lucent::gfx::LoadEnvironmentFile(source.string(), cacheDirectory, first, &error));
+    CHECK(first.width == 8 && first.height == 4 && first.GetMipCount() == 4);
+    CHECK(GetTexel(first, 0, 0, 0, 0) == 1.0f);
+
+    // The second load comes from the cache entry the first one wrote
+    uint64_t hash = 0;
+    CHECK(lucent::HashFile(source.string(), hash));
+    CHECK(std::filesystem::exists(lucent::gfx::GetEnvironmentCachePath(cacheDirectory, hash)));
+    CHECK(lucent::gfx::LoadEnvironmentFile(source.string(), cacheDirectory, second, &error));
+    CHECK(second.texels == first.texels && second.conditionalCDF == first.conditionalCDF);
+
+    // Edited contents get their own entry
+    WritePPM(source, 8, 4, 0);
+    CHECK(lucent::gfx::LoadEnvironmentFile(source.string(), cacheDirectory, second, &error));
+    CHECK(GetTexel(second, 0, 0, 0, 0) == 0.0f);
+    size_t entries = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) {
+        entries += entry.path().extension() == ".lenv" ? 1 : 0;
+    }
+    CHECK(entries == 2);
+
+    CHECK(!lucent::gfx::LoadEnvironmentFile((directory / "missing.hdr").string(), cacheDirectory, second, &error));
+    CHECK(!error.empty());
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestSamplingTables();
+    TestMipChain();
+    TestCache();
+    TestLoadFile();
+
+    // Same results with rows spread over the pool
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+    TestSamplingTables();
+    TestMipChain();
+    TestCache();
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Environment processing");
+}
@@ -0,0 +1,126 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+void TestScheduleAndWait() {
+    auto& jobs = lucent::JobSystem::Get();
+    std::atomic<int> sum{ 0 };
+    lucent::JobCounter counter;
+    for (int i = 1; i <= 1000; ++i) {
+        jobs.Schedule([&sum, i]() { sum.fetch_add(i); }, &counter);
+    }
+    jobs.Wait(counter);
+    CHECK(counter.IsDone());
+    CHECK(sum.load() == 500500);
+}
+
+void TestParallelFor() {
+    auto& jobs = lucent::JobSystem::Get();
+    std::vector<uint32_t> data(100000, 0);
+    jobs.ParallelFor(static_cast<uint32_t>(data.size()), 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) data[i] = i * 2;
+    });
+    bool ok = true;
+    for (uint32_t i = 0; i < data.size(); ++i) ok = ok && (data[i] == i * 2);
+    CHECK(ok);
+
+    // Explicit grain, count not divisible by grain
+    std::atomic<uint32_t> visited{ 0 };
+    jobs.ParallelFor(1001, 64, [&](uint32_t begin, uint32_t end) { visited.fetch_add(end - begin); });
+    CHECK(visited.load() == 1001);
+}
+
+void TestDependencies() {
+    auto& jobs = lucent::JobSystem::Get();
+    std::atomic<int> stage{ 0 };
+    std::atomic<bool> orderOk{ true };
+
+    lucent::JobCounter first;
+    lucent::JobCounter second;
+    for (int i = 0; i < 8; ++i) {
+        jobs.Schedule([&]() { stage.fetch_add(1); }, &first);
+    }
+    jobs.ScheduleAfter(first, [&]() {
+        if (stage.load() != 8) orderOk = false;
+        stage.fetch_add(100);
+    }, &second);
+    jobs.Wait(second);
+
+    CHECK(orderOk.load());
+    CHECK(stage.load() == 108);
+
+    // Dependency already satisfied runs immediately
+    lucent::JobCounter done;
+    lucent::JobCounter third;
+    bool ran = false;
+    jobs.ScheduleAfter(done, [&]() { ran = true; }, &third);
+    jobs.Wait(third);
+    CHECK(ran);
+}
+
+void TestNestedWait() {
+    auto& jobs = lucent::JobSystem::Get();
+    std::atomic<int> leafCount{ 0 };
+    lucent::JobCounter outer;
+    for (int i = 0; i < 16; ++i) {
+        jobs.Schedule([&]() {
+            // Waiting inside a job must not deadlock the pool
+            lucent::JobCounter inner;
+            for (int j = 0; j < 16; ++j) {
+                jobs.Schedule([&]() { leafCount.fetch_add(1); }, &inner);
+            }
+            lucent::JobSystem::Get().Wait(inner);
+        }, &outer);
+    }
+    jobs.Wait(outer);
+    CHECK(leafCount.load() == 256);
+}
+
+void TestMainThreadAffinity() {
+    auto& jobs = lucent::JobSystem::Get();
+    std::atomic<bool> ranOnMain{ false };
+    lucent::JobCounter counter;
+    jobs.Schedule([&]() {
+        jobs.RunOnMainThread([&]() { ranOnMain = jobs.IsMainThread(); }, &counter);
+    }, &counter);
+    // Wait() on the main thread pumps main-thread jobs
+    jobs.Wait(counter);
+    CHECK(ranOnMain.load());
+    CHECK(lucent::JobSystem::GetCurrentWorkerIndex() == -1);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    // Inline execution before Init()
+    {
+        int value = 0;
+        lucent::JobCounter counter;
+        lucent::JobSystem::Get().Schedule([&]() { value = 42; }, &counter);
+        CHECK(counter.IsDone());
+        CHECK(value == 42);
+    }
+
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+    CHECK(lucent::JobSystem::Get().GetWorkerCount() == 4);
+
+    TestScheduleAndWait();
+    TestParallelFor();
+    TestDependencies();
+    TestNestedWait();
+    TestMainThreadAffinity();
+
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Job system");
+}
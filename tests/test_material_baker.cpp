@@ -0,0 +1,197 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/JobSystem.h>
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialBaker.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialProgram.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+// Type of the node linked into an output pin, or Frame when the pin is unconnected
+NodeType LinkedType(const MaterialGraph& graph, const std::string& outputPin) {
+    const LinkID link = graph.FindLinkByEndPin(FindInput(graph, graph.GetOutputNodeId(), outputPin));
+    if (link == INVALID_LINK_ID) return NodeType::Frame;
+    return graph.GetNode(graph.GetPinNodeId(graph.GetLink(link)->startPinId))->type;
+}
+
+std::filesystem::path MakeDirectory(const char* name) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+// UV gradient into Base Color, a constant into Roughness
+MaterialGraph MakeGradientGraph() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    graph.SetName("Gradient");
+
+    const NodeID uv = graph.CreateNode(NodeType::UV);
+    const NodeID widen = graph.CreateNode(NodeType::Vec2ToVec3);
+    graph.CreateLink(graph.GetNode(uv)->outputPins[0], graph.GetNode(widen)->inputPins[0]);
+    ConnectToOutput(graph, widen, "Base Color");
+
+    const NodeID roughness = graph.CreateNode(NodeType::ConstFloat);
+    graph.GetNode(roughness)->parameter = 0.3f;
+    ConnectToOutput(graph, roughness, "Roughness");
+    return graph;
+}
+
+void TestUVSquare() {
+    const std::filesystem::path directory = MakeDirectory("lucent_bake_square");
+    MaterialBakeSettings settings;
+    settings.resolution = 32;
+    settings.tileSize = 8;
+    settings.outputDirectory = directory.string();
+    settings.name = "gradient";
+
+    MaterialBakeResult result;
+    std::string error;
+    CHECK(BakeMaterialToTextures(MakeGradientGraph(), settings, result, error));
+    CHECK(result.stats.tiles == 16);
+    CHECK(result.stats.texelsEvaluated == 32 * 32);
+
+    // Only the varying output becomes a texture
+    CHECK(result.texturePaths.size() == 1);
+    CHECK(result.texturePaths.size() == 1 && std::filesystem::exists(result.texturePaths[0]));
+    CHECK(result.graph.GetTextureSlots().size() == 1);
+    CHECK(result.graph.GetTextureSlots().size() == 1 && result.graph.GetTextureSlots()[0].sRGB);
+    CHECK(LinkedType(result.graph, "Base Color") == NodeType::Texture2D);
+    CHECK(LinkedType(result.graph, "Roughness") == NodeType::ConstFloat);
+    CHECK(LinkedType(result.graph, "Metallic") == NodeType::Frame);
+    CHECK(LinkedType(result.graph, "Normal") == NodeType::Frame);
+    CHECK(result.stats.sourceTextureSamples == 0);
+    CHECK(result.stats.bakedTextureSamples == 1);
+
+    MaterialProgram program;
+    CHECK(CompileMaterialProgram(result.graph, program, error));
+    std::filesystem::remove_all(directory);
+}
+
+void TestShaderCostDrops() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    const NodeID noise = graph.CreateNode(NodeType::Noise);
+    const NodeID ramp = graph.CreateNode(NodeType::ColorRamp);
+    graph.CreateLink(graph.GetNode(noise)->outputPins[0], graph.GetNode(ramp)->inputPins[0]);
+    ConnectToOutput(graph, ramp, "Base Color");
+    ConnectToOutput(graph, noise, "Roughness");
+    ConnectToOutput(graph, noise, "Metallic");
+
+    const std::filesystem::path directory = MakeDirectory("lucent_bake_cost");
+    MaterialBakeSettings settings;
+    settings.resolution = 64;
+    settings.outputDirectory = directory.string();
+
+    MaterialBakeResult result;
+    std::string error;
+    CHECK(BakeMaterialToTextures(graph, settings, result, error));
+    CHECK(result.texturePaths.size() == 2);
+    CHECK(result.stats.bakedTextureSamples == 2);
+    CHECK(result.stats.bakedInstructions < result.stats.sourceInstructions);
+    CHECK(LinkedType(result.graph, "Metallic") == NodeType::Texture2D);
+    std::filesystem::remove_all(directory);
+}
+
+void TestMeshLayout() {
+    // A quad covering the lower-left quarter of UV space
+    std::vector<lucent::assets::Vertex> vertices(4);
+    const glm::vec2 uvs[4] = { { 0.0f, 0.0f }, { 0.5f, 0.0f }, { 0.5f, 0.5f }, { 0.0f, 0.5f } };
+    for (int i = 0; i < 4; ++i) {
+        vertices[i].position = glm::vec3(uvs[i].x, uvs[i].y, 0.0f);
+        vertices[i].normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        vertices[i].uv = uvs[i];
+    }
+    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+    // World normal into Emissive: uniform over the mesh
+    MaterialGraph graph = MakeGradientGraph();
+    const NodeID normal = graph.CreateNode(NodeType::WorldNormal);
+    ConnectToOutput(graph, normal, "Emissive");
+
+    const std::filesystem::path directory = MakeDirectory("lucent_bake_mesh");
+    MaterialBakeSettings settings;
+    settings.resolution = 32;
+    settings.tileSize = 8;
+    settings.padding = 2;
+    settings.outputDirectory = directory.string();
+    settings.vertices = &vertices;
+    settings.indices = &indices;
+
+    MaterialBakeResult result;
+    std::string error;
+    CHECK(BakeMaterialToTextures(graph, settings, result, error));
+    CHECK(result.stats.texelsEvaluated == 16 * 16);
+    CHECK(LinkedType(result.graph, "Emissive") == NodeType::ConstVec3);
+    CHECK(LinkedType(result.graph, "Base Color") == NodeType::Texture2D);
+    std::filesystem::remove_all(directory);
+
+    // Out-of-range indices are rejected
+    const std::vector<uint32_t> broken = { 0, 1, 7 };
+    settings.indices = &broken;
+    CHECK(!BakeMaterialToTextures(graph, settings, result, error));
+}
+
+void TestProgressAndCancel() {
+    const std::filesystem::path directory = MakeDirectory("lucent_bake_cancel");
+    MaterialBakeSettings settings;
+    settings.resolution = 32;
+    settings.tileSize = 8;
+    settings.outputDirectory = directory.string();
+    settings.name = "gradient";
+
+    MaterialBakeProgress progress;
+    MaterialBakeResult result;
+    std::string error;
+    CHECK(BakeMaterialToTextures(MakeGradientGraph(), settings, result, error, &progress));
+    CHECK(progress.fraction.load() == 1.0f);
+
+    // Cancelled before the first tile: fails and writes nothing
+    std::filesystem::remove_all(directory);
+    MaterialBakeProgress cancelled;
+    cancelled.cancelled = true;
+    MaterialBakeResult cancelledResult;
+    CHECK(!BakeMaterialToTextures(MakeGradientGraph(), settings, cancelledResult, error, &cancelled));
+    CHECK(error.find("cancelled") != std::string::npos);
+    CHECK(cancelledResult.texturePaths.empty());
+    CHECK(!std::filesystem::exists(directory));
+    std::filesystem::remove_all(directory);
+}
+
+void TestVolumeRejected() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    graph.SetDomain(MaterialDomain::Volume);
+    MaterialBakeResult result;
+    std::string error;
+    CHECK(!BakeMaterialToTextures(graph, MaterialBakeSettings{}, result, error));
+    CHECK(!error.empty());
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+
+    TestUVSquare();
+    TestShaderCostDrops();
+    TestMeshLayout();
+    TestProgressAndCancel();
+    TestVolumeRejected();
+
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Material baker");
+}
@@ -0,0 +1,223 @@
+#include "TestHarness.h"
+#include <lucent/core/JobSystem.h>
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialCompileQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+
+// Stands in for shaderc: records which graphs were compiled, and holds every compile until the
+// gate opens so the tests decide what is running while they submit.
+struct FakeCompiler {
+    std::atomic<bool> gate{ false };
+    std::mutex mutex;
+    std::vector<std::string> compiled; // Graph names, in compile order
+
+    MaterialCompileQueue::CompileFunction Function() {
+        return [this](const MaterialGraph& graph) {
+            while (!gate.load()) std::this_thread::yield();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                compiled.push_back(graph.GetName());
+            }
+            CompileResult result;
+            result.success = true;
+            result.graphHash = graph.ComputeStructureHash();
+            return result;
+        };
+    }
+};
+
+MaterialGraph MakeGraph(const std::string& name, int extraNodes = 0) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    graph.SetName(name);
+    for (int i = 0; i < extraNodes; ++i) graph.CreateNode(NodeType::ConstFloat);
+    return graph;
+}
+
+void TestPriorityOrder() {
+    FakeCompiler compiler;
+    MaterialCompileQueue queue(1, compiler.Function());
+    int a = 0, b = 0, c = 0, d = 0;
+
+    // `a` takes the only slot; the rest wait and start by priority, not submission order
+    CHECK(queue.Submit(&a, MakeGraph("a"), MaterialCompilePriority::Background));
+    CHECK(queue.Submit(&b, MakeGraph("b"), MaterialCompilePriority::Background));
+    CHECK(queue.Submit(&c, MakeGraph("c"), MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&d, MakeGraph("d"), MaterialCompilePriority::Background));
+    queue.SetPriority(&d, MaterialCompilePriority::Selected);
+
+    const MaterialCompileQueueStats waiting = queue.GetStats();
+    CHECK(waiting.queued == 3);
+    CHECK(waiting.running == 1);
+    CHECK(waiting.maxConcurrent == 1);
+
+    compiler.gate.store(true);
+    queue.WaitIdle();
+    CHECK((compiler.compiled == std::vector<std::string>{ "a", "d", "c", "b" }));
+
+    CompileResult result;
+    CHECK(queue.TakeResult(&b, result) && result.success);
+    CHECK(!queue.TakeResult(&b, result));
+    CHECK(!queue.IsPending(&b));
+    CHECK(queue.IsPending(&a));
+
+    const MaterialCompileQueueStats done = queue.GetStats();
+    CHECK(done.queued == 0 && done.running == 0);
+    CHECK(done.completed == 4);
+    CHECK(done.maxLatencyMs >= done.maxWaitMs);
+    CHECK(done.GetAverageLatencyMs() > 0.0);
+}
+
+void TestDeduplicate() {
+    FakeCompiler compiler;
+    MaterialCompileQueue queue(1, compiler.Function());
+    int a = 0, b = 0;
+
+    CHECK(queue.Submit(&a, MakeGraph("a"), MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&b, MakeGraph("b"), MaterialCompilePriority::Background));
+    // Same structures again: one is compiling, one is queued. Values do not matter.
+    MaterialGraph renamed = MakeGraph("a");
+    renamed.SetName("a2");
+    CHECK(!queue.Submit(&a, renamed, MaterialCompilePriority::Visible));
+    CHECK(!queue.Submit(&b, MakeGraph("b"), MaterialCompilePriority::Selected));
+
+    compiler.gate.store(true);
+    queue.WaitIdle();
+    CHECK(compiler.compiled.size() == 2);
+    const MaterialCompileQueueStats stats = queue.GetStats();
+    CHECK(stats.submitted == 4);
+    CHECK(stats.deduplicated == 2);
+    CHECK(stats.completed == 2);
+}
+
+void TestSupersede() {
+    FakeCompiler compiler;
+    MaterialCompileQueue queue(2, compiler.Function());
+    int a = 0;
+
+    const MaterialGraph first = MakeGraph("first");
+    const MaterialGraph second = MakeGraph("second", 1);
+    const MaterialGraph third = MakeGraph("third", 2);
+
+    CHECK(queue.Submit(&a, first, MaterialCompilePriority::Visible));
+    // The running compile goes stale; the owner waits for it rather than taking a second slot
+    CHECK(queue.Submit(&a, second, MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&a, third, MaterialCompilePriority::Visible));
+    CHECK(queue.GetStats().running == 1);
+    CHECK(queue.GetStats().queued == 1);
+
+    compiler.gate.store(true);
+    queue.WaitIdle();
+    CHECK((compiler.compiled == std::vector<std::string>{ "first", "third" }));
+
+    CompileResult result;
+    CHECK(queue.TakeResult(&a, result));
+    CHECK(result.graphHash == third.ComputeStructureHash());
+    CHECK(!queue.IsPending(&a));
+
+    const MaterialCompileQueueStats stats = queue.GetStats();
+    CHECK(stats.superseded == 2);
+    CHECK(stats.completed == 1);
+
+    // Going back to the structure that is compiling drops the queued request
+    compiler.gate.store(false);
+    CHECK(queue.Submit(&a, first, MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&a, second, MaterialCompilePriority::Visible));
+    CHECK(!queue.Submit(&a, first, MaterialCompilePriority::Visible));
+    compiler.gate.store(true);
+    queue.WaitIdle();
+    CHECK(queue.TakeResult(&a, result));
+    CHECK(result.graphHash == first.ComputeStructureHash());
+}
+
+void TestCancel() {
+    FakeCompiler compiler;
+    MaterialCompileQueue queue(1, compiler.Function());
+    int a = 0, b = 0;
+
+    CHECK(queue.Submit(&a, MakeGraph("a"), MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&b, MakeGraph("b"), MaterialCompilePriority::Visible));
+    queue.Cancel(&a);
+    queue.Cancel(&b);
+    CHECK(!queue.IsPending(&a));
+    CHECK(!queue.IsPending(&b));
+
+    compiler.gate.store(true);
+    queue.WaitIdle();
+    CompileResult result;
+    CHECK(!queue.TakeResult(&a, result));
+    CHECK(!queue.TakeResult(&b, result));
+    // The running compile finishes; the queued one never starts
+    CHECK((compiler.compiled == std::vector<std::string>{ "a" }));
+    CHECK(queue.GetStats().cancelled == 2);
+    CHECK(queue.GetStats().completed == 0);
+}
+
+void TestShutdown() {
+    FakeCompiler compiler;
+    MaterialCompileQueue queue(1, compiler.Function());
+    int a = 0, b = 0;
+
+    CHECK(queue.Submit(&a, MakeGraph("a"), MaterialCompilePriority::Visible));
+    CHECK(queue.Submit(&b, MakeGraph("b"), MaterialCompilePriority::Visible));
+
+    // Shutdown() waits for the running compile, which holds until the gate opens
+    std::thread opener([&compiler] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        compiler.gate.store(true);
+    });
+    queue.Shutdown();
+    opener.join();
+
+    CHECK((compiler.compiled == std::vector<std::string>{ "a" }));
+    CHECK(queue.GetStats().running == 0);
+    CHECK(queue.GetStats().queued == 0);
+    CHECK(queue.GetStats().cancelled == 2);
+    CHECK(queue.GetStats().completed == 0);
+    CHECK(!queue.IsPending(&a));
+    CHECK(!queue.Submit(&a, MakeGraph("c"), MaterialCompilePriority::Selected));
+    CHECK(queue.GetStats().queued == 0);
+}
+
+void TestCompileException() {
+    MaterialCompileQueue queue(1, [](const MaterialGraph&) -> CompileResult { throw std::runtime_error("boom"); });
+    int a = 0;
+    CHECK(queue.Submit(&a, MakeGraph("a"), MaterialCompilePriority::Visible));
+    queue.WaitIdle();
+    CompileResult result;
+    CHECK(queue.TakeResult(&a, result));
+    CHECK(!result.success);
+    CHECK(result.errorMessage.find("boom") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+
+    TestPriorityOrder();
+    TestDeduplicate();
+    TestSupersede();
+    TestCancel();
+    TestShutdown();
+    TestCompileException();
+
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Material compile queue");
+}
@@ -0,0 +1,243 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialGraphEval.h>
+#include <lucent/material/MaterialOptimizer.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+MaterialGraph MakeGraph() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    return graph;
+}
+
+bool Near(const glm::vec4& a, const glm::vec4& b) {
+    return std::fabs(a.x - b.x) < 1e-5f && std::fabs(a.y - b.y) < 1e-5f && std::fabs(a.z - b.z) < 1e-5f &&
+           std::fabs(a.w - b.w) < 1e-5f;
+}
+
+bool SameConstants(const MaterialGraph& a, const MaterialGraph& b) {
+    TracerMaterialConstants ca, cb;
+    std::string errA, errB;
+    if (!EvaluateTracerConstants(a, ca, errA) || !EvaluateTracerConstants(b, cb, errB)) return false;
+    return Near(ca.baseColor, cb.baseColor) && Near(ca.emissive, cb.emissive) &&
+           std::fabs(ca.metallic - cb.metallic) < 1e-5f && std::fabs(ca.roughness - cb.roughness) < 1e-5f;
+}
+
+void TestFolding() {
+    MaterialGraph graph = MakeGraph();
+    const NodeID color = AddConst(graph, glm::vec3(0.2f, 0.4f, 0.6f));
+    const NodeID tint = AddConst(graph, glm::vec3(0.5f, 1.0f, 0.25f));
+    const NodeID mul = AddNode(graph, NodeType::Multiply, { color, tint });
+    const NodeID add = AddNode(graph, NodeType::Add, { mul, AddConst(graph, 0.1f) });
+    ConnectToOutput(graph, add, "Base Color");
+    const NodeID rough = AddNode(graph, NodeType::OneMinus, { AddConst(graph, 0.3f) });
+    ConnectToOutput(graph, rough, "Roughness");
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(SameConstants(graph, optimized));
+    CHECK(stats.folded == 3);
+    CHECK(stats.nodesBefore == static_cast<uint32_t>(graph.GetNodes().size()));
+    CHECK(stats.nodesAfter == static_cast<uint32_t>(optimized.GetNodes().size()));
+
+    // The output reads constants directly: output + 2 folded values (the default 0.8 is unused)
+    const NodeID output = optimized.GetOutputNodeId();
+    const NodeID baseColor = SourceNode(optimized, FindInput(optimized, output, "Base Color"));
+    CHECK(optimized.GetNode(baseColor)->type == NodeType::ConstVec3);
+    const glm::vec3 folded = std::get<glm::vec3>(optimized.GetNode(baseColor)->parameter);
+    CHECK(Near(glm::vec4(folded.x, folded.y, folded.z, 0.0f), glm::vec4(0.2f, 0.5f, 0.25f, 0.0f)));
+    CHECK(optimized.GetNodes().size() == 3);
+    CHECK(optimized.GetNode(mul) == nullptr && optimized.GetNode(add) == nullptr);
+
+    // The source graph is untouched and keeps its hash
+    CHECK(graph.GetNode(mul) != nullptr);
+}
+
+void TestUndefinedNotFolded() {
+    // pow of a negative base is undefined in GLSL: left for the GPU
+    MaterialGraph graph = MakeGraph();
+    const NodeID power = AddNode(graph, NodeType::Power, { AddConst(graph, -2.0f), AddConst(graph, 0.5f) });
+    ConnectToOutput(graph, power, "Metallic");
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(stats.folded == 0);
+    CHECK(optimized.GetNode(power) != nullptr);
+}
+
+void TestIdentities() {
+    MaterialGraph graph = MakeGraph();
+    const NodeID position = graph.CreateNode(NodeType::WorldPosition);
+    const NodeID mulOne = AddNode(graph, NodeType::Multiply, { position, AddConst(graph, 1.0f) });
+    const NodeID addZero = AddNode(graph, NodeType::Add, { AddConst(graph, glm::vec3(0.0f)), mulOne });
+    const NodeID reroute = AddNode(graph, NodeType::Reroute, { addZero });
+    ConnectToOutput(graph, reroute, "Base Color");
+
+    const NodeID scalar = AddNode(graph, NodeType::Vec3ToFloat, { position });
+    const NodeID inner = AddNode(graph, NodeType::OneMinus, { scalar });
+    const NodeID outer = AddNode(graph, NodeType::OneMinus, { inner });
+    ConnectToOutput(graph, outer, "Roughness");
+
+    const NodeID mulZero = AddNode(graph, NodeType::Multiply, { position, AddConst(graph, 0.0f) });
+    ConnectToOutput(graph, mulZero, "Emissive");
+
+    // t = 1 selects B
+    const NodeID lerp = AddNode(graph, NodeType::Lerp, { AddConst(graph, 0.25f), position, AddConst(graph, 1.0f) });
+    ConnectToOutput(graph, AddNode(graph, NodeType::Vec3ToFloat, { lerp }), "Metallic");
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(SameConstants(graph, optimized));
+    CHECK(stats.simplified == 6);
+
+    const NodeID output = optimized.GetOutputNodeId();
+    CHECK(SourceNode(optimized, FindInput(optimized, output, "Base Color")) == position);
+    const NodeID emissive = SourceNode(optimized, FindInput(optimized, output, "Emissive"));
+    CHECK(optimized.GetNode(emissive)->type == NodeType::ConstVec3);
+    CHECK(optimized.GetNode(mulOne) == nullptr && optimized.GetNode(addZero) == nullptr);
+    CHECK(optimized.GetNode(reroute) == nullptr && optimized.GetNode(inner) == nullptr);
+    CHECK(optimized.GetNode(lerp) == nullptr);
+
+    // Once the lerp is bypassed both Vec3ToFloat(position) nodes are one; the repeated 1.0
+    // constant is shared too
+    const NodeID metallic = SourceNode(optimized, FindInput(optimized, output, "Metallic"));
+    CHECK(optimized.GetNode(metallic)->type == NodeType::Vec3ToFloat);
+    CHECK(SourceNode(optimized, FindInput(optimized, output, "Roughness")) == metallic);
+    CHECK(SourceNode(optimized, Input(optimized, metallic, 0)) == position);
+    CHECK(stats.merged == 2);
+}
+
+void TestTypeChangingBypassKept() {
+    // Reroute converts to vec3; bypassing it would hand Metallic a float directly. Both are the
+    // same value, but identities only bypass when the types already match.
+    MaterialGraph graph = MakeGraph();
+    const NodeID time = graph.CreateNode(NodeType::Time);
+    const NodeID reroute = AddNode(graph, NodeType::Reroute, { time });
+    ConnectToOutput(graph, reroute, "Metallic");
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(stats.simplified == 0);
+    CHECK(optimized.GetNode(reroute) != nullptr);
+}
+
+void TestCommonSubexpressions() {
+    MaterialGraph graph = MakeGraph();
+    const NodeID normal = graph.CreateNode(NodeType::WorldNormal);
+    const NodeID a = AddNode(graph, NodeType::Add, { normal, AddConst(graph, 0.5f) });
+    const NodeID b = AddNode(graph, NodeType::Add, { normal, AddConst(graph, 0.5f) });
+    const NodeID sa = AddNode(graph, NodeType::Saturate, { a });
+    const NodeID sb = AddNode(graph, NodeType::Saturate, { b });
+    const NodeID mul = AddNode(graph, NodeType::Multiply, { sa, sb });
+    ConnectToOutput(graph, mul, "Base Color");
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(SameConstants(graph, optimized));
+    // The second 0.5 constant, the second Add and the second Saturate
+    CHECK(stats.merged == 3);
+    CHECK(optimized.GetNode(b) == nullptr && optimized.GetNode(sb) == nullptr);
+    CHECK(SourceNode(optimized, Input(optimized, mul, 0)) == sa);
+    CHECK(SourceNode(optimized, Input(optimized, mul, 1)) == sa);
+}
+
+void TestDeadNodes() {
+    MaterialGraph graph = MakeGraph();
+    const NodeID orphan = AddNode(graph, NodeType::Add, { AddConst(graph, 1.0f), graph.CreateNode(NodeType::UV) });
+    const NodeID frame = graph.CreateNode(NodeType::Frame);
+    const size_t before = graph.GetNodes().size();
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(stats.removed == 4);
+    CHECK(optimized.GetNodes().size() == before - 4);
+    CHECK(optimized.GetNode(orphan) == nullptr && optimized.GetNode(frame) == nullptr);
+    CHECK(optimized.GetNode(optimized.GetOutputNodeId()) != nullptr);
+    CHECK(SameConstants(graph, optimized));
+}
+
+void TestCycleUnchanged() {
+    MaterialGraph graph = MakeGraph();
+    const NodeID a = graph.CreateNode(NodeType::Add);
+    const NodeID b = graph.CreateNode(NodeType::Add);
+    graph.CreateLink(Output(graph, a), Input(graph, b, 0));
+    graph.CreateLink(Output(graph, b), Input(graph, a, 0));
+    ConnectToOutput(graph, b, "Base Color");
+    graph.CreateNode(NodeType::Frame);
+
+    MaterialOptimizeStats stats;
+    const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+    CHECK(optimized.GetNodes().size() == graph.GetNodes().size());
+    CHECK(optimized.GetLinks().size() == graph.GetLinks().size());
+    CHECK(stats.folded == 0 && stats.removed == 0);
+}
+
+// Random constant graphs over nodes where MaterialGraphEval and the GLSL backend agree
+void TestRandomEquivalence() {
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    auto unit = [&]() { return static_cast<float>(next() % 1000) / 1000.0f; };
+
+    const NodeType kBinary[] = { NodeType::Add, NodeType::Subtract, NodeType::Multiply, NodeType::Min, NodeType::Max };
+    const char* kOutputs[] = { "Base Color", "Metallic", "Roughness", "Emissive" };
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        MaterialGraph graph = MakeGraph();
+        std::vector<NodeID> values;
+        for (int i = 0; i < 4; ++i) {
+            values.push_back(next() % 2 ? AddConst(graph, unit()) : AddConst(graph, glm::vec3(unit(), unit(), unit())));
+        }
+        for (int i = 0; i < 16; ++i) {
+            auto pick = [&]() { return values[next() % values.size()]; };
+            NodeID node = INVALID_NODE_ID;
+            switch (next() % 6) {
+                case 0: node = AddNode(graph, NodeType::Lerp, { pick(), pick(), pick() }); break;
+                case 1: node = AddNode(graph, NodeType::OneMinus, { pick() }); break;
+                case 2: node = AddNode(graph, NodeType::Saturate, { pick() }); break;
+                case 3: node = AddNode(graph, NodeType::CombineVec3, { pick(), pick(), pick() }); break;
+                case 4: node = AddNode(graph, NodeType::Reroute, { pick() }); break;
+                default: node = AddNode(graph, kBinary[next() % 5], { pick(), pick() }); break;
+            }
+            values.push_back(node);
+        }
+        for (const char* name : kOutputs) {
+            if (next() % 4 != 0) ConnectToOutput(graph, values[values.size() - 1 - next() % 8], name);
+        }
+
+        MaterialOptimizeStats stats;
+        const MaterialGraph optimized = OptimizeMaterialGraph(graph, &stats);
+        CHECK(SameConstants(graph, optimized));
+        CHECK(stats.nodesAfter <= stats.nodesBefore);
+    }
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestFolding();
+    TestUndefinedNotFolded();
+    TestIdentities();
+    TestTypeChangingBypassKept();
+    TestCommonSubexpressions();
+    TestDeadNodes();
+    TestCycleUnchanged();
+    TestRandomEquivalence();
+
+    return lucent::test::Finish("Material optimizer");
+}
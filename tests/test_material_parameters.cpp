@@ -0,0 +1,185 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialCompiler.h>
+#include <lucent/material/MaterialGraph.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+bool Contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+// Default graph (a ConstVec3 into Base Color) plus a ConstFloat into Roughness
+struct TestMaterial {
+    MaterialGraph graph;
+    NodeID color = INVALID_NODE_ID;
+    NodeID roughness = INVALID_NODE_ID;
+
+    TestMaterial() {
+        graph.CreateDefault();
+        const NodeID output = graph.GetOutputNodeId();
+        const LinkID colorLink = graph.FindLinkByEndPin(FindInput(graph, output, "Base Color"));
+        color = graph.GetPinNodeId(graph.GetLink(colorLink)->startPinId);
+
+        roughness = graph.CreateNode(NodeType::ConstFloat);
+        graph.GetNode(roughness)->parameter = 0.625f;
+        graph.CreateLink(Output(graph, roughness), FindInput(graph, output, "Roughness"));
+    }
+};
+
+void TestConstantsReadFromBuffer() {
+    TestMaterial material;
+    MaterialCompiler compiler;
+    const CompileResult result = compiler.GenerateGLSL(material.graph);
+    CHECK(result.success);
+    CHECK(result.parameterLayout.constants.size() == 2);
+    CHECK(result.parameterLayout.GetBufferSize() == result.parameterLayout.GetSlotCount() * sizeof(glm::vec4));
+    CHECK(Contains(result.fragmentShaderGLSL, "uniform MaterialParameters"));
+    CHECK(Contains(result.fragmentShaderGLSL, "binding = 1"));
+
+    const int slot = result.parameterLayout.FindSlot(material.roughness);
+    CHECK(slot >= 0);
+    CHECK(Contains(result.fragmentShaderGLSL, "params.values[" + std::to_string(slot) + "].x"));
+    CHECK(!Contains(result.fragmentShaderGLSL, "0.625"));
+}
+
+void TestValueEditKeepsShader() {
+    TestMaterial material;
+    MaterialCompiler compiler;
+    const CompileResult before = compiler.GenerateGLSL(material.graph);
+
+    material.graph.GetNode(material.roughness)->parameter = 0.25f;
+    material.graph.GetNode(material.color)->parameter = glm::vec3(0.1f, 0.2f, 0.3f);
+    const CompileResult after = compiler.GenerateGLSL(material.graph);
+
+    CHECK(after.fragmentShaderGLSL == before.fragmentShaderGLSL);
+    CHECK(after.graphHash == before.graphHash);
+    CHECK(after.parameterHash != before.parameterHash);
+    CHECK(after.parameterLayout.constants == before.parameterLayout.constants);
+    CHECK(after.parameterLayout.pinDefaults == before.parameterLayout.pinDefaults);
+
+    // The compiled layout packs the edited values
+    std::vector<glm::vec4> values;
+    before.parameterLayout.Pack(material.graph, values);
+    CHECK(values.size() == before.parameterLayout.GetSlotCount());
+    const int roughnessSlot = before.parameterLayout.FindSlot(material.roughness);
+    const int colorSlot = before.parameterLayout.FindSlot(material.color);
+    CHECK(roughnessSlot >= 0 && values[roughnessSlot].x == 0.25f);
+    CHECK(colorSlot >= 0 && values[colorSlot].x == 0.1f && values[colorSlot].y == 0.2f &&
+          values[colorSlot].z == 0.3f);
+}
+
+void TestStructureEditsChangeHash() {
+    TestMaterial material;
+    const uint64_t base = material.graph.ComputeStructureHash();
+    const NodeID output = material.graph.GetOutputNodeId();
+
+    TestMaterial linked;
+    linked.graph.CreateLink(Output(linked.graph, linked.roughness),
+                            FindInput(linked.graph, output, "Metallic"));
+    CHECK(linked.graph.ComputeStructureHash() != base);
+
+    TestMaterial volume;
+    volume.graph.SetDomain(MaterialDomain::Volume);
+    CHECK(volume.graph.ComputeStructureHash() != base);
+
+    // Unlinking an input moves its default into the parameter buffer
+    TestMaterial unlinked;
+    unlinked.graph.DeleteLink(unlinked.graph.FindLinkByEndPin(FindInput(unlinked.graph, output, "Roughness")));
+    CHECK(unlinked.graph.ComputeStructureHash() != base);
+}
+
+void TestPinDefaultsAreParameters() {
+    TestMaterial material;
+    const NodeID output = material.graph.GetOutputNodeId();
+
+    // Only pin defaults feed this node: it reads them from the buffer instead of being folded
+    const NodeID add = material.graph.CreateNode(NodeType::Add);
+    MaterialNode* addNode = material.graph.GetNode(add);
+    const PinID first = addNode->inputPins[0];
+    material.graph.GetPin(first)->defaultValue = glm::vec3(0.5f);
+    material.graph.GetPin(addNode->inputPins[1])->defaultValue = glm::vec3(0.25f);
+    material.graph.CreateLink(Output(material.graph, add), FindInput(material.graph, output, "Emissive"));
+
+    MaterialCompiler compiler;
+    const CompileResult before = compiler.GenerateGLSL(material.graph);
+    CHECK(before.success);
+    const int slot = before.parameterLayout.FindPinSlot(first);
+    CHECK(slot >= static_cast<int>(before.parameterLayout.constants.size()));
+    CHECK(before.parameterLayout.FindPinSlot(FindInput(material.graph, output, "Alpha")) >= 0);
+    CHECK(before.parameterLayout.FindPinSlot(FindInput(material.graph, output, "Emissive")) < 0); // Linked
+    CHECK(Contains(before.fragmentShaderGLSL, "params.values[" + std::to_string(slot) + "].xyz"));
+    CHECK(!Contains(before.fragmentShaderGLSL, "0.75"));
+
+    // Editing a default keeps the shader and only repacks
+    material.graph.GetPin(first)->defaultValue = glm::vec3(0.125f);
+    const CompileResult after = compiler.GenerateGLSL(material.graph);
+    CHECK(after.fragmentShaderGLSL == before.fragmentShaderGLSL);
+    CHECK(after.graphHash == before.graphHash);
+    CHECK(after.parameterHash != before.parameterHash);
+
+    std::vector<glm::vec4> values;
+    before.parameterLayout.Pack(material.graph, values);
+    CHECK(values[slot].x == 0.125f && values[slot].z == 0.125f);
+}
+
+void TestNoiseValuesAreParameters() {
+    TestMaterial material;
+    const NodeID output = material.graph.GetOutputNodeId();
+    const NodeID noise = material.graph.CreateNode(NodeType::Noise);
+    material.graph.CreateLink(Output(material.graph, noise), FindInput(material.graph, output, "Metallic"));
+
+    MaterialCompiler compiler;
+    const CompileResult before = compiler.GenerateGLSL(material.graph);
+    CHECK(before.success);
+
+    // What the editor's noise sliders write: the parameter and the matching pin defaults
+    MaterialNode* node = material.graph.GetNode(noise);
+    node->parameter = std::string("NOISE2:0;7.5,3.0,0.25,0.5");
+    material.graph.GetPin(node->inputPins[1])->defaultValue = 7.5f;
+    material.graph.GetPin(node->inputPins[2])->defaultValue = 3.0f;
+    material.graph.GetPin(node->inputPins[3])->defaultValue = 0.25f;
+    material.graph.GetPin(node->inputPins[4])->defaultValue = 0.5f;
+    const CompileResult after = compiler.GenerateGLSL(material.graph);
+    CHECK(after.fragmentShaderGLSL == before.fragmentShaderGLSL);
+    CHECK(after.graphHash == before.graphHash);
+    CHECK(after.parameterHash != before.parameterHash);
+
+    // Another noise type is a different shader
+    node->parameter = std::string("NOISE2:2;7.5,3.0,0.25,0.5");
+    CHECK(material.graph.ComputeStructureHash() != after.graphHash);
+}
+
+void TestUnreachableNodesHaveNoSlots() {
+    TestMaterial material;
+    const NodeID loose = material.graph.CreateNode(NodeType::ConstFloat);
+    const NodeID looseAdd = material.graph.CreateNode(NodeType::Add);
+
+    const MaterialParameterLayout layout = MaterialParameterLayout::Build(material.graph);
+    CHECK(layout.FindSlot(loose) < 0);
+    CHECK(layout.FindPinSlot(material.graph.GetNode(looseAdd)->inputPins[0]) < 0);
+    CHECK(layout.FindSlot(material.roughness) >= 0);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestConstantsReadFromBuffer();
+    TestValueEditKeepsShader();
+    TestStructureEditsChangeHash();
+    TestPinDefaultsAreParameters();
+    TestNoiseValuesAreParameters();
+    TestUnreachableNodesHaveNoSlots();
+
+    return lucent::test::Finish("Material parameter");
+}
@@ -0,0 +1,187 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/JobSystem.h>
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialPreview.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+constexpr uint32_t kSize = 32;
+
+std::filesystem::path MakeDirectory(const char* name) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+// A constant colour into Base Color
+MaterialGraph MakeColorGraph(const glm::vec3& color) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    const NodeID node = graph.CreateNode(NodeType::ConstVec3);
+    graph.GetNode(node)->parameter = color;
+    ConnectToOutput(graph, node, "Base Color");
+    return graph;
+}
+
+const uint8_t* Pixel(const MaterialPreviewImage& image, uint32_t x, uint32_t y) {
+    return image.pixels.data() + (static_cast<size_t>(y) * image.size + x) * 4;
+}
+
+void TestRender() {
+    MaterialPreviewImage image;
+    std::string error;
+    CHECK(RenderMaterialPreview(MakeColorGraph(glm::vec3(0.9f, 0.1f, 0.1f)), kSize, image, error));
+    CHECK(image.IsValid());
+    CHECK(image.size == kSize);
+    CHECK(image.pixels.size() == kSize * kSize * 4);
+    if (!image.IsValid()) return;
+
+    // Opaque ball on a transparent background
+    const uint8_t* center = Pixel(image, kSize / 2, kSize / 2);
+    CHECK(center[3] == 255);
+    CHECK(center[0] > center[1] && center[0] > center[2]);
+    CHECK(Pixel(image, 0, 0)[3] == 0);
+    CHECK(Pixel(image, kSize - 1, kSize - 1)[3] == 0);
+
+    // The silhouette is antialiased
+    bool partial = false;
+    for (uint32_t x = 0; x < kSize; ++x) {
+        const uint8_t alpha = Pixel(image, x, kSize / 2)[3];
+        partial |= alpha > 0 && alpha < 255;
+    }
+    CHECK(partial);
+
+    // Different graphs look different
+    MaterialPreviewImage blue;
+    CHECK(RenderMaterialPreview(MakeColorGraph(glm::vec3(0.1f, 0.1f, 0.9f)), kSize, blue, error));
+    CHECK(blue.graphHash != image.graphHash);
+    CHECK(blue.IsValid() && Pixel(blue, kSize / 2, kSize / 2)[2] > Pixel(blue, kSize / 2, kSize / 2)[0]);
+
+    // Volumes have no surface to show
+    MaterialGraph volume;
+    volume.CreateDefault();
+    volume.SetDomain(MaterialDomain::Volume);
+    MaterialPreviewImage volumeImage;
+    error.clear();
+    CHECK(!RenderMaterialPreview(volume, kSize, volumeImage, error));
+    CHECK(!volumeImage.IsValid());
+    CHECK(!error.empty());
+}
+
+void TestCache() {
+    const std::filesystem::path directory = MakeDirectory("lucent_material_previews");
+    const MaterialGraph red = MakeColorGraph(glm::vec3(0.9f, 0.1f, 0.1f));
+    const MaterialGraph green = MakeColorGraph(glm::vec3(0.1f, 0.9f, 0.1f));
+
+    std::shared_ptr<const MaterialPreviewImage> first;
+    {
+        MaterialPreviewCache cache(kSize, 2);
+        cache.SetDirectory(directory.string());
+        cache.Request("red.lmat", red);
+        cache.WaitIdle();
+        first = cache.Request("red.lmat", red);
+        CHECK(first && first->IsValid());
+        CHECK(first && first->graphHash == red.ComputeHash());
+        CHECK(cache.GetStats().rendered == 1);
+
+        // Same graph again: nothing new runs
+        cache.Request("red.lmat", red);
+        cache.WaitIdle();
+        CHECK(cache.Request("red.lmat", red) == first);
+        CHECK(cache.GetStats().rendered == 1);
+
+        // An edit renders again; the old thumbnail stays visible meanwhile
+        const auto shown = cache.Request("red.lmat", green);
+        CHECK(shown == first);
+        cache.WaitIdle();
+        const auto edited = cache.Request("red.lmat", green);
+        CHECK(edited && edited->graphHash == green.ComputeHash());
+        CHECK(cache.GetStats().rendered == 2);
+
+        // Unreadable files give an image with the error
+        cache.RequestFile((directory / "missing.lmat").string(), std::filesystem::file_time_type());
+        cache.WaitIdle();
+        const auto missing =
+            cache.RequestFile((directory / "missing.lmat").string(), std::filesystem::file_time_type());
+        CHECK(missing && !missing->IsValid() && !missing->error.empty());
+        CHECK(cache.GetStats().failed == 1);
+        CHECK(cache.GetStats().queued == 0 && cache.GetStats().running == 0);
+    }
+
+    // A new session reads both thumbnails from disk
+    {
+        MaterialPreviewCache cache(kSize, 1);
+        cache.SetDirectory(directory.string());
+        cache.Request("a", red);
+        cache.Request("b", green);
+        cache.WaitIdle();
+        const auto image = cache.Request("a", red);
+        CHECK(image && image->pixels == first->pixels);
+        CHECK(cache.GetStats().diskHits == 2);
+        CHECK(cache.GetStats().rendered == 0);
+    }
+
+    // Another thumbnail size is a different entry
+    {
+        MaterialPreviewCache cache(kSize * 2, 1);
+        cache.SetDirectory(directory.string());
+        cache.Request("a", red);
+        cache.WaitIdle();
+        const auto image = cache.Request("a", red);
+        CHECK(image && image->size == kSize * 2);
+        CHECK(cache.GetStats().rendered == 1);
+    }
+
+    // Past the size bound the least recently used thumbnails are deleted
+    {
+        MaterialPreviewCache cache(kSize, 1);
+        cache.SetDirectory(directory.string(), 1);
+        size_t files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            files += entry.path().extension() == ".thumb" ? 1 : 0;
+        }
+        CHECK(files == 0);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+void TestCoalescing() {
+    // With one render slot, edits made while a render runs collapse into one follow-up render
+    lucent::JobSystem::Get().Init();
+    {
+        MaterialPreviewCache cache(kSize, 1);
+        for (int i = 0; i < 20; ++i) {
+            cache.Request("slider.lmat", MakeColorGraph(glm::vec3(static_cast<float>(i) / 20.0f, 0.5f, 0.5f)));
+        }
+        cache.WaitIdle();
+        const MaterialPreviewStats stats = cache.GetStats();
+        CHECK(stats.rendered >= 1 && stats.rendered <= 20);
+        const MaterialGraph last = MakeColorGraph(glm::vec3(19.0f / 20.0f, 0.5f, 0.5f));
+        const auto image = cache.Request("slider.lmat", last);
+        CHECK(image && image->graphHash == last.ComputeHash());
+        cache.LogStats();
+    }
+    lucent::JobSystem::Get().Shutdown();
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestRender();
+    TestCache();
+    TestCoalescing();
+
+    return lucent::test::Finish("Material preview");
+}
@@ -0,0 +1,291 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/MaterialProgram.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+bool Near(float a, float b, float epsilon = 1e-5f) {
+    return std::fabs(a - b) <= epsilon;
+}
+
+// Default graph with `source` linked into Base Color
+MaterialGraph MakeGraph(NodeType sourceType, NodeID& outSource) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    outSource = graph.CreateNode(sourceType);
+    return graph;
+}
+
+// Shading points on a diagonal of UV space
+struct Points {
+    std::vector<float> u, v;
+    MaterialShadingPoints points;
+
+    explicit Points(uint32_t count) : u(count), v(count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            u[i] = static_cast<float>(i) / static_cast<float>(count);
+            v[i] = 1.0f - u[i] * 0.5f;
+        }
+        points.count = count;
+        points.uv[0] = u.data();
+        points.uv[1] = v.data();
+    }
+};
+
+float Read(const MaterialProgram& program, const std::vector<float>& values, uint32_t count,
+           const std::string& output, uint32_t component, uint32_t point) {
+    const MaterialProgramOutput* o = program.FindOutput(output);
+    return o ? values[(o->row + component) * count + point] : NAN;
+}
+
+void TestConstants() {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+    CHECK(program.IsValid());
+    CHECK(program.outputRowCount == 3 + 1 + 1 + 3 + 3 + 1);
+
+    Points points(3);
+    std::vector<float> values(program.outputRowCount * 3);
+    program.Execute(points.points, values.data());
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK(Near(Read(program, values, 3, "Roughness", 0, i), 0.5f));
+        CHECK(Near(Read(program, values, 3, "Normal", 2, i), 1.0f));
+        CHECK(Near(Read(program, values, 3, "Alpha", 0, i), 1.0f));
+    }
+}
+
+void TestVaryingAcrossBatches() {
+    NodeID uv = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::UV, uv);
+    const NodeID widen = graph.CreateNode(NodeType::Vec2ToVec3);
+    graph.GetPin(FindInput(graph, widen, "Z"))->defaultValue = 0.25f;
+    graph.CreateLink(Output(graph, uv), graph.GetNode(widen)->inputPins[0]);
+    LinkToOutput(graph, Output(graph, widen), "Base Color");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+
+    // More points than one batch, with a partial last batch
+    const uint32_t count = MaterialProgram::kLanes * 2 + 7;
+    Points points(count);
+    std::vector<float> values(program.outputRowCount * count);
+    program.Execute(points.points, values.data());
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK(Read(program, values, count, "Base Color", 0, i) == points.u[i]);
+        CHECK(Read(program, values, count, "Base Color", 1, i) == points.v[i]);
+        CHECK(Read(program, values, count, "Base Color", 2, i) == 0.25f);
+    }
+}
+
+void TestBatchMatchesSinglePoints() {
+    NodeID noise = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::Noise, noise);
+    graph.GetNode(noise)->parameter = std::string("NOISE2:2;3.0,5.0,0.6,0.4");
+    LinkToOutput(graph, Output(graph, noise, 1), "Base Color");
+    LinkToOutput(graph, Output(graph, noise, 0), "Roughness");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+
+    const uint32_t count = 150;
+    Points points(count);
+    std::vector<float> batch(program.outputRowCount * count);
+    program.Execute(points.points, batch.data());
+
+    bool varies = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        MaterialShadingPoints single;
+        single.count = 1;
+        single.uv[0] = &points.u[i];
+        single.uv[1] = &points.v[i];
+        std::vector<float> one(program.outputRowCount);
+        program.Execute(single, one.data());
+        for (uint32_t row = 0; row < program.outputRowCount; ++row) {
+            CHECK(one[row] == batch[row * count + i]);
+        }
+        const float value = Read(program, batch, count, "Roughness", 0, i);
+        CHECK(value >= 0.0f && value <= 1.5f); // Ridged octaves can sum past 1
+        CHECK(Read(program, batch, count, "Base Color", 2, i) == value);
+        varies |= value != Read(program, batch, count, "Roughness", 0, 0);
+    }
+    CHECK(varies);
+}
+
+void TestCustomCode() {
+    NodeID custom = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::CustomCode, custom);
+    graph.GetNode(custom)->parameter = std::string(
+        "uniform float Strength;\n"
+        "out float Mask;\n"
+        "// Reversed and scaled\n"
+        "vec3 t = In.zyx * Strength;\n"
+        "Out = t + vec3(1.0, 2.0, 3.0);\n"
+        "Mask = clamp(dot(t, vec3(1.0)) / 24.0, 0.0, 1.0);\n");
+    graph.RebuildNodePins(custom);
+    graph.GetPin(FindInput(graph, custom, "In"))->defaultValue = glm::vec3(1.0f, 2.0f, 3.0f);
+    graph.GetPin(FindInput(graph, custom, "Strength"))->defaultValue = 2.0f;
+    LinkToOutput(graph, Output(graph, custom, 0), "Base Color");
+    LinkToOutput(graph, Output(graph, custom, 1), "Roughness");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+
+    Points points(1);
+    std::vector<float> values(program.outputRowCount);
+    program.Execute(points.points, values.data());
+    CHECK(Near(Read(program, values, 1, "Base Color", 0, 0), 7.0f));
+    CHECK(Near(Read(program, values, 1, "Base Color", 1, 0), 6.0f));
+    CHECK(Near(Read(program, values, 1, "Base Color", 2, 0), 5.0f));
+    CHECK(Near(Read(program, values, 1, "Roughness", 0, 0), 0.5f));
+
+    // Control flow is GPU-only
+    graph.GetNode(custom)->parameter = std::string("if (In.x > 0.0) Out = In;");
+    graph.RebuildNodePins(custom);
+    LinkToOutput(graph, Output(graph, custom, 0), "Base Color");
+    CHECK(!CompileMaterialProgram(graph, program, error));
+    CHECK(error.find("CustomCode") != std::string::npos);
+    CHECK(!program.IsValid());
+}
+
+void TestColorRamp() {
+    NodeID uv = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::UV, uv);
+    const NodeID split = graph.CreateNode(NodeType::SeparateVec2);
+    const NodeID ramp = graph.CreateNode(NodeType::ColorRamp);
+    graph.GetNode(ramp)->parameter = std::string("RAMP:1.0,1.0,0.5,0.25;0.0,0.0,0.0,0.0");
+    graph.CreateLink(Output(graph, uv), graph.GetNode(split)->inputPins[0]);
+    graph.CreateLink(Output(graph, split), graph.GetNode(ramp)->inputPins[0]);
+    LinkToOutput(graph, Output(graph, ramp), "Base Color");
+    LinkToOutput(graph, Output(graph, ramp, 1), "Alpha");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+    CHECK(program.ramps.size() == 1);
+
+    const uint32_t count = 4;
+    Points points(count); // u = 0, 0.25, 0.5, 0.75
+    std::vector<float> values(program.outputRowCount * count);
+    program.Execute(points.points, values.data());
+    CHECK(Near(Read(program, values, count, "Base Color", 0, 0), 0.0f));
+    CHECK(Near(Read(program, values, count, "Base Color", 0, 2), 0.5f));
+    CHECK(Near(Read(program, values, count, "Base Color", 1, 2), 0.25f));
+    CHECK(Near(Read(program, values, count, "Base Color", 2, 3), 0.1875f));
+    CHECK(Near(Read(program, values, count, "Alpha", 0, 1), 1.0f));
+}
+
+void TestTextureSampler() {
+    NodeID texture = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::Texture2D, texture);
+    graph.AddTextureSlot("textures/a.png");
+    graph.AddTextureSlot("textures/b.png");
+    graph.GetNode(texture)->parameter = std::string("textures/b.png");
+    LinkToOutput(graph, Output(graph, texture), "Base Color");
+    LinkToOutput(graph, Output(graph, texture, 4), "Alpha");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+
+    const uint32_t count = 70;
+    Points points(count);
+    uint32_t sampled = 0;
+    points.points.sampleTexture = [&](uint32_t slot, const float* u, const float* v, uint32_t n, float* const rgba[4]) {
+        sampled += n;
+        for (uint32_t i = 0; i < n; ++i) {
+            rgba[0][i] = static_cast<float>(slot);
+            rgba[1][i] = u[i];
+            rgba[2][i] = v[i];
+            rgba[3][i] = 0.5f;
+        }
+    };
+    std::vector<float> values(program.outputRowCount * count);
+    program.Execute(points.points, values.data());
+    CHECK(sampled == count);
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK(Read(program, values, count, "Base Color", 0, i) == 1.0f);
+        CHECK(Read(program, values, count, "Base Color", 1, i) == points.u[i]);
+        CHECK(Read(program, values, count, "Base Color", 2, i) == points.v[i]);
+        CHECK(Read(program, values, count, "Alpha", 0, i) == 0.5f);
+    }
+
+    // No sampler: missing texture magenta
+    points.points.sampleTexture = nullptr;
+    program.Execute(points.points, values.data());
+    CHECK(Read(program, values, count, "Base Color", 0, 0) == 1.0f);
+    CHECK(Read(program, values, count, "Base Color", 1, 0) == 0.0f);
+}
+
+void TestRegisterReuse() {
+    // A long chain of Adds on the UVs: values die as soon as the next one is computed
+    NodeID uv = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::UV, uv);
+    PinID previous = Output(graph, uv);
+    for (int i = 0; i < 16; ++i) {
+        const NodeID add = graph.CreateNode(NodeType::Add);
+        graph.GetPin(graph.GetNode(add)->inputPins[1])->defaultValue = glm::vec3(static_cast<float>(i + 1));
+        graph.CreateLink(previous, graph.GetNode(add)->inputPins[0]);
+        previous = Output(graph, add);
+    }
+    LinkToOutput(graph, previous, "Base Color");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(CompileMaterialProgram(graph, program, error));
+    CHECK(program.registerCount < program.instructions.size());
+    CHECK(program.registerCount <= 8);
+
+    Points points(5);
+    std::vector<float> values(program.outputRowCount * 5);
+    program.Execute(points.points, values.data());
+    for (uint32_t i = 0; i < 5; ++i) {
+        CHECK(Near(Read(program, values, 5, "Base Color", 0, i), points.u[i] + 136.0f, 1e-4f));
+        CHECK(Near(Read(program, values, 5, "Base Color", 2, i), 136.0f, 1e-4f));
+    }
+}
+
+void TestCycleFails() {
+    NodeID a = INVALID_NODE_ID;
+    MaterialGraph graph = MakeGraph(NodeType::Sin, a);
+    const NodeID b = graph.CreateNode(NodeType::Cos);
+    graph.CreateLink(Output(graph, a), graph.GetNode(b)->inputPins[0]);
+    graph.CreateLink(Output(graph, b), graph.GetNode(a)->inputPins[0]);
+    LinkToOutput(graph, Output(graph, b), "Roughness");
+
+    MaterialProgram program;
+    std::string error;
+    CHECK(!CompileMaterialProgram(graph, program, error));
+    CHECK(error.find("Cycle") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestConstants();
+    TestVaryingAcrossBatches();
+    TestBatchMatchesSinglePoints();
+    TestCustomCode();
+    TestColorRamp();
+    TestTextureSampler();
+    TestRegisterReuse();
+    TestCycleFails();
+
+    return lucent::test::Finish("Material program");
+}
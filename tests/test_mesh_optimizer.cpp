@@ -0,0 +1,236 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/assets/MeshOptimizer.h>
+#include <lucent/assets/ModelCache.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace lucent::assets;
+
+// Grid of quads with the triangles shuffled, which is close to the worst case for the cache
+ImportedMesh MakeShuffledGrid(uint32_t size, uint32_t seed) {
+    ImportedMesh mesh;
+    const uint32_t side = size + 1;
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            Vertex v{};
+            v.position = glm::vec3(static_cast<float>(x), 0.05f * static_cast<float>(x * y % 7), static_cast<float>(y));
+            v.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            v.uv = glm::vec2(static_cast<float>(x) / size, static_cast<float>(y) / size);
+            v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+            mesh.vertices.push_back(v);
+        }
+    }
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t i = y * side + x;
+            triangles.push_back({ i, i + side, i + 1 });
+            triangles.push_back({ i + 1, i + side, i + side + 1 });
+        }
+    }
+    std::mt19937 rng(seed);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+    for (const auto& tri : triangles) {
+        mesh.indices.insert(mesh.indices.end(), tri.begin(), tri.end());
+    }
+    return mesh;
+}
+
+// Triangles as position triples, rotated to a canonical first vertex (winding preserved)
+std::vector<std::array<float, 9>> CanonicalTriangles(const ImportedMesh& mesh, size_t begin, size_t end) {
+    std::vector<std::array<float, 9>> result;
+    for (size_t i = begin; i < end; i += 3) {
+        std::array<glm::vec3, 3> p = { mesh.vertices[mesh.indices[i]].position,
+                                       mesh.vertices[mesh.indices[i + 1]].position,
+                                       mesh.vertices[mesh.indices[i + 2]].position };
+        auto less = [](const glm::vec3& a, const glm::vec3& b) {
+            return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+        };
+        const size_t first = std::min_element(p.begin(), p.end(), less) - p.begin();
+        std::array<float, 9> tri{};
+        for (size_t k = 0; k < 3; ++k) {
+            const glm::vec3& q = p[(first + k) % 3];
+            tri[k * 3] = q.x;
+            tri[k * 3 + 1] = q.y;
+            tri[k * 3 + 2] = q.z;
+        }
+        result.push_back(tri);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void TestOptimizePreservesTriangles() {
+    ImportedMesh mesh = MakeShuffledGrid(48, 1);
+    // Two submeshes: triangles must stay inside their own range
+    const uint32_t half = static_cast<uint32_t>(mesh.indices.size() / 6) * 3;
+    mesh.submeshes.push_back({ 0, half, 0 });
+    mesh.submeshes.push_back({ half, static_cast<uint32_t>(mesh.indices.size()) - half, 1 });
+
+    const auto firstBefore = CanonicalTriangles(mesh, 0, half);
+    const auto secondBefore = CanonicalTriangles(mesh, half, mesh.indices.size());
+
+    const MeshOptimizer::Stats stats = MeshOptimizer::Optimize(mesh);
+
+    CHECK(CanonicalTriangles(mesh, 0, half) == firstBefore);
+    CHECK(CanonicalTriangles(mesh, half, mesh.indices.size()) == secondBefore);
+    // Each submesh is a random half of the grid, so it cannot reach the ACMR of a whole grid
+    CHECK(stats.acmrAfter < stats.acmrBefore * 0.5f);
+    CHECK(stats.vertexCountAfter == mesh.vertices.size());
+    CHECK(stats.vertexBytes == mesh.vertices.size() * sizeof(Vertex));
+}
+
+void TestVertexCacheOnly() {
+    ImportedMesh mesh = MakeShuffledGrid(64, 2);
+    const float before = MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size());
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    const float after = MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size());
+    // A regular grid optimises to well under one miss per triangle (0.5 is the ideal)
+    CHECK(before > 1.5f);
+    CHECK(after < 0.8f);
+}
+
+void TestOverdrawKeepsCacheEfficiency() {
+    ImportedMesh mesh = MakeShuffledGrid(64, 3);
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    const float cacheOnly = MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size());
+    const auto before = CanonicalTriangles(mesh, 0, mesh.indices.size());
+
+    MeshOptimizer::OptimizeOverdraw(mesh.indices, mesh.vertices, 1.05f);
+    CHECK(CanonicalTriangles(mesh, 0, mesh.indices.size()) == before);
+    // Clusters are cut where the ACMR stays within the threshold; allow some slack for the
+    // misses at the new cluster seams
+    CHECK(MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size()) < cacheOnly * 1.25f);
+}
+
+void TestVertexFetch() {
+    ImportedMesh mesh = MakeShuffledGrid(8, 4);
+    // An unreferenced vertex is dropped
+    mesh.vertices.push_back(mesh.vertices.front());
+
+    const std::vector<Vertex> original = mesh.vertices;
+    const std::vector<uint32_t> originalIndices = mesh.indices;
+    const size_t count = MeshOptimizer::OptimizeVertexFetch(mesh.vertices, mesh.indices);
+    CHECK(count == original.size() - 1);
+
+    // Vertices appear in first-use order and still resolve to the same data
+    uint32_t next = 0;
+    for (size_t i = 0; i < mesh.indices.size(); ++i) {
+        CHECK(mesh.indices[i] <= next);
+        if (mesh.indices[i] == next) ++next;
+        CHECK(mesh.vertices[mesh.indices[i]].position == original[originalIndices[i]].position);
+    }
+    CHECK(next == count);
+}
+
+void TestInvalidIndicesAreLeftAlone() {
+    ImportedMesh mesh = MakeShuffledGrid(4, 5);
+    mesh.indices.back() = static_cast<uint32_t>(mesh.vertices.size());
+    const std::vector<uint32_t> before = mesh.indices;
+    MeshOptimizer::Optimize(mesh);
+    CHECK(mesh.indices == before);
+}
+
+// Smooth bumpy grid (no hard edges) so every level can simplify
+ImportedMesh MakeTerrain(uint32_t size) {
+    ImportedMesh mesh = MakeShuffledGrid(size, 7);
+    for (Vertex& v : mesh.vertices) {
+        v.position.y = 2.0f * std::sin(v.position.x * 0.2f) * std::cos(v.position.z * 0.15f);
+    }
+    return mesh;
+}
+
+void TestGenerateLODs() {
+    ImportedMesh mesh = MakeTerrain(64);
+    MeshOptimizer::Optimize(mesh);
+    const std::vector<Vertex> vertices = mesh.vertices;
+    const std::vector<uint32_t> indices = mesh.indices;
+
+    const size_t count = MeshOptimizer::GenerateLODs(mesh);
+    CHECK(count >= 2 && count <= MeshOptimizer::kMaxLODs);
+    CHECK(count == mesh.lods.size());
+    // Vertices and the full-detail indices are untouched
+    CHECK(mesh.indices == indices);
+    CHECK(mesh.vertices.size() == vertices.size());
+
+    uint32_t previousCount = static_cast<uint32_t>(mesh.indices.size());
+    float previousError = 0.0f;
+    for (const MeshLOD& lod : mesh.lods) {
+        CHECK(lod.indexCount % 3 == 0 && lod.indexCount > 0);
+        CHECK(lod.indexOffset + lod.indexCount <= mesh.lodIndices.size());
+        // At most half the previous level, at a growing error within the object-space budget
+        // (64 units wide, 5% per level)
+        CHECK(lod.indexCount <= previousCount / 2 + 3);
+        CHECK(lod.error >= previousError);
+        CHECK(lod.error <= 64.0f * MeshOptimizer::kMaxLODError * static_cast<float>(&lod - mesh.lods.data() + 1));
+        previousCount = lod.indexCount;
+        previousError = lod.error;
+    }
+    CHECK(std::all_of(mesh.lodIndices.begin(), mesh.lodIndices.end(),
+                      [&](uint32_t index) { return index < mesh.vertices.size(); }));
+
+    // Small meshes and broken index buffers get none
+    ImportedMesh small = MakeTerrain(8);
+    CHECK(MeshOptimizer::GenerateLODs(small) == 0 && small.lods.empty() && small.lodIndices.empty());
+    mesh.indices.back() = static_cast<uint32_t>(mesh.vertices.size());
+    CHECK(MeshOptimizer::GenerateLODs(mesh) == 0 && mesh.lods.empty());
+}
+
+void TestGenerateLODsPerSubmesh() {
+    // Left and right halves of the terrain as two submeshes
+    ImportedMesh mesh = MakeTerrain(64);
+    std::vector<uint32_t> left, right;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const bool isLeft = mesh.vertices[mesh.indices[i]].position.x + mesh.vertices[mesh.indices[i + 1]].position.x +
+                            mesh.vertices[mesh.indices[i + 2]].position.x < 96.0f;
+        (isLeft ? left : right).insert((isLeft ? left : right).end(), mesh.indices.begin() + i, mesh.indices.begin() + i + 3);
+    }
+    mesh.indices = left;
+    mesh.indices.insert(mesh.indices.end(), right.begin(), right.end());
+    const uint32_t half = static_cast<uint32_t>(left.size());
+    mesh.submeshes.push_back({ 0, half, 0 });
+    mesh.submeshes.push_back({ half, static_cast<uint32_t>(mesh.indices.size()) - half, 1 });
+    MeshOptimizer::Optimize(mesh);
+
+    CHECK(MeshOptimizer::GenerateLODs(mesh) >= 2);
+    CHECK(!mesh.lods.empty() && mesh.lods[0].indexCount <= mesh.indices.size() / 2 + 6);
+
+    // The seam between the halves is locked: every vertex on x = 32 survives in the first LOD
+    size_t seamBefore = 0, seamAfter = 0;
+    std::vector<uint8_t> seen(mesh.vertices.size(), 0);
+    for (uint32_t index : mesh.indices) {
+        if (mesh.vertices[index].position.x == 32.0f && !seen[index]++) ++seamBefore;
+    }
+    std::fill(seen.begin(), seen.end(), 0);
+    if (!mesh.lods.empty()) {
+        for (uint32_t i = 0; i < mesh.lods[0].indexCount; ++i) {
+            const uint32_t index = mesh.lodIndices[mesh.lods[0].indexOffset + i];
+            if (mesh.vertices[index].position.x == 32.0f && !seen[index]++) ++seamAfter;
+        }
+    }
+    CHECK(seamBefore == 65 && seamAfter == seamBefore);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestOptimizePreservesTriangles();
+    TestVertexCacheOnly();
+    TestOverdrawKeepsCacheEfficiency();
+    TestVertexFetch();
+    TestInvalidIndicesAreLeftAlone();
+    TestGenerateLODs();
+    TestGenerateLODsPerSubmesh();
+
+    return lucent::test::Finish("Mesh optimizer");
+}
@@ -0,0 +1,217 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/MappedFile.h>
+#include <lucent/assets/ModelCache.h>
+#include <lucent/assets/ModelLoader.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::assets;
+
+const std::filesystem::path kTempDir = std::filesystem::temp_directory_path() / "lucent_test_model_cache";
+
+void WriteFile(const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+ImportedMesh MakeMesh(const std::string& name, uint32_t quads, uint32_t materialIndex) {
+    ImportedMesh mesh;
+    mesh.name = name;
+    for (uint32_t q = 0; q < quads; ++q) {
+        for (uint32_t corner = 0; corner < 4; ++corner) {
+            Vertex v{};
+            v.position = glm::vec3(static_cast<float>(q + (corner & 1)), static_cast<float>(corner >> 1), 0.25f);
+            v.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            v.uv = glm::vec2(static_cast<float>(corner & 1), static_cast<float>(corner >> 1));
+            v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, -1.0f);
+            mesh.vertices.push_back(v);
+        }
+        const uint32_t base = q * 4;
+        for (uint32_t index : { base, base + 1, base + 2, base + 2, base + 1, base + 3 }) {
+            mesh.indices.push_back(index);
+        }
+    }
+    mesh.submeshes.push_back({ 0, static_cast<uint32_t>(mesh.indices.size()), materialIndex });
+    return mesh;
+}
+
+void TestHash() {
+    const auto a = kTempDir / "a.bin";
+    const auto b = kTempDir / "b.bin";
+    WriteFile(a, std::string(1000, 'x') + "tail");
+    WriteFile(b, std::string(1000, 'x') + "tail");
+
+    uint64_t hashA = 0, hashB = 0;
+    CHECK(lucent::HashFile(a.string(), hashA));
+    CHECK(lucent::HashFile(b.string(), hashB));
+    CHECK(hashA == hashB);
+
+    // One byte in the word-aligned body, then one in the tail
+    WriteFile(b, std::string(999, 'x') + "ytail");
+    CHECK(lucent::HashFile(b.string(), hashB) && hashA != hashB);
+    WriteFile(b, std::string(1000, 'x') + "tbil");
+    CHECK(lucent::HashFile(b.string(), hashB) && hashA != hashB);
+
+    CHECK(!lucent::HashFile((kTempDir / "missing.bin").string(), hashB));
+    CHECK(ModelCache::GetCachePath(kTempDir.string(), 1, 2) != ModelCache::GetCachePath(kTempDir.string(), 1, 3));
+}
+
+void TestRoundTrip() {
+    std::vector<ImportedMesh> meshes;
+    meshes.push_back(MakeMesh("Wall", 3, 1));
+    meshes.push_back(MakeMesh("Floor", 1, 0));
+    meshes.push_back(ImportedMesh{ "Empty", {}, {}, {}, {}, {} });
+    meshes[0].lodIndices = { 0, 1, 2, 2, 1, 3, 4, 5, 6 };
+    meshes[0].lods = { { 0, 9, 0.25f }, { 6, 3, 0.5f } };
+
+    Model model;
+    MaterialData material;
+    material.name = "Brick";
+    material.baseColorFactor = glm::vec4(0.5f, 0.25f, 0.125f, 1.0f);
+    material.roughnessFactor = 0.7f;
+    material.normalTexture = 2;
+    material.alphaMode = MaterialData::AlphaMode::Mask;
+    material.doubleSided = true;
+    model.materials.push_back(material);
+    model.materials.push_back(MaterialData{});
+
+    CameraData camera;
+    camera.name = "Cam";
+    camera.fov = 45.0f;
+    model.cameras.push_back(camera);
+
+    LightData light;
+    light.name = "Sun";
+    light.type = LightData::Type::Directional;
+    light.color = glm::vec3(1.0f, 0.9f, 0.8f);
+    model.lights.push_back(light);
+
+    NodeData root;
+    root.name = "Root";
+    root.children = { 1, 2 };
+    NodeData child;
+    child.name = "Child";
+    child.meshIndex = 0;
+    child.localTransform[3] = glm::vec4(1.0f, 2.0f, 3.0f, 1.0f);
+    NodeData leaf;
+    leaf.name = "Leaf";
+    leaf.lightIndex = 0;
+    model.nodes = { root, child, leaf };
+    model.rootNodes = { 0 };
+
+    const std::string path = ModelCache::GetCachePath((kTempDir / "nested").string(), 0x1234, 0x99);
+    std::string error;
+    CHECK(ModelCache::Write(path, 0x1234, 0x99, meshes, model, error));
+
+    ModelCache::Reader reader;
+    CHECK(reader.Open(path, 0x1234, 0x99, error));
+    CHECK(reader.GetMeshCount() == 3);
+    if (reader.GetMeshCount() == 3) {
+        ModelCache::MeshView wall = reader.GetMesh(0);
+        CHECK(wall.name == "Wall");
+        CHECK(wall.vertices.size() == 12 && wall.indices.size() == 18 && wall.submeshes.size() == 1);
+        CHECK(std::memcmp(wall.vertices.data(), meshes[0].vertices.data(), wall.vertices.size_bytes()) == 0);
+        CHECK(wall.indices[17] == 11 && wall.submeshes[0].materialIndex == 1);
+        // Zero copy: views point into the mapping, aligned for the vertex type
+        CHECK(reinterpret_cast<uintptr_t>(wall.vertices.data()) % alignof(Vertex) == 0);
+        CHECK(wall.lodIndices.size() == 9 && wall.lodIndices[6] == 4 && wall.lods.size() == 2);
+        if (wall.lods.size() == 2) {
+            CHECK(wall.lods[1].indexOffset == 6 && wall.lods[1].indexCount == 3 && wall.lods[1].error == 0.5f);
+        }
+
+        ModelCache::MeshView floor = reader.GetMesh(1);
+        CHECK(floor.name == "Floor" && floor.vertices.size() == 4 && floor.indices[5] == 3);
+        CHECK(floor.lods.empty() && floor.lodIndices.empty());
+        CHECK(reader.GetMesh(2).vertices.empty());
+    }
+
+    Model loaded;
+    reader.ReadModelInfo(loaded);
+    CHECK(loaded.materials.size() == 2);
+    if (loaded.materials.size() == 2) {
+        const MaterialData& brick = loaded.materials[0];
+        CHECK(brick.name == "Brick" && brick.baseColorFactor == material.baseColorFactor);
+        CHECK(brick.roughnessFactor == 0.7f && brick.normalTexture == 2 && brick.baseColorTexture == -1);
+        CHECK(brick.alphaMode == MaterialData::AlphaMode::Mask && brick.doubleSided);
+    }
+    CHECK(loaded.cameras.size() == 1 && loaded.cameras[0].name == "Cam" && loaded.cameras[0].fov == 45.0f);
+    CHECK(loaded.lights.size() == 1 && loaded.lights[0].type == LightData::Type::Directional &&
+          loaded.lights[0].color == light.color);
+    CHECK(loaded.nodes.size() == 3 && loaded.rootNodes == std::vector<uint32_t>{ 0 });
+    if (loaded.nodes.size() == 3) {
+        CHECK(loaded.nodes[0].children == root.children);
+        CHECK(loaded.nodes[1].meshIndex == 0 && loaded.nodes[1].localTransform[3] == child.localTransform[3]);
+        CHECK(loaded.nodes[2].name == "Leaf" && loaded.nodes[2].lightIndex == 0 && loaded.nodes[2].meshIndex == -1);
+    }
+    reader.Close();
+
+    // A different source or different import settings never reuse the file
+    CHECK(!reader.Open(path, 0x1235, 0x99, error));
+    CHECK(!reader.Open(path, 0x1234, 0x98, error));
+
+    // Truncated and corrupted files are rejected rather than read out of bounds
+    const auto size = std::filesystem::file_size(path);
+    std::vector<char> bytes(size);
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(bytes.data(), static_cast<std::streamsize>(size));
+    }
+    const auto corruptPath = kTempDir / "corrupt.lmc";
+    WriteFile(corruptPath, std::string(bytes.data(), bytes.size() / 2));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+
+    auto* header = reinterpret_cast<ModelCache::FileHeader*>(bytes.data());
+    header->sections[static_cast<uint32_t>(ModelCache::Section::Vertices)].size = 48;
+    WriteFile(corruptPath, std::string(bytes.data(), bytes.size()));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+
+    // LOD ranges are validated like the others
+    meshes[0].lods[1].indexCount = 4;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+    meshes[0].lods[1].indexCount = 3;
+
+    // So are submesh ranges and the mesh, camera and light a node refers to
+    meshes[1].submeshes[0].indexCount = 7;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+    meshes[1].submeshes[0].indexCount = 6;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+    reader.Close();
+
+    model.nodes[1].meshIndex = 3;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+    model.nodes[1].meshIndex = 0;
+    model.nodes[1].cameraIndex = 1;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+    model.nodes[1].cameraIndex = -1;
+    model.nodes[2].lightIndex = -2;
+    CHECK(ModelCache::Write(corruptPath.string(), 0x1234, 0x99, meshes, model, error));
+    CHECK(!reader.Open(corruptPath.string(), 0x1234, 0x99, error));
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    std::filesystem::remove_all(kTempDir);
+    std::filesystem::create_directories(kTempDir);
+
+    TestHash();
+    TestRoundTrip();
+
+    std::filesystem::remove_all(kTempDir);
+
+    return lucent::test::Finish("Model cache");
+}
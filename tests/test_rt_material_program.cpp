@@ -0,0 +1,235 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/gfx/RTMaterialProgram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent::gfx;
+
+// Subset of the closest-hit opcodes, enough to check that allocation preserves results
+constexpr uint32_t OP_CONST = 1u;
+constexpr uint32_t OP_UV = 2u;
+constexpr uint32_t OP_ADD = 4u;
+constexpr uint32_t OP_MUL = 5u;
+constexpr uint32_t OP_SWIZZLE = 10u;
+constexpr uint32_t OP_COMBINE3 = 11u;
+constexpr uint32_t OP_COMBINE4 = RT_MATERIAL_OP_COMBINE4;
+
+// Builds a program the way the editor's RT compiler does: instruction i writes register i + 1
+struct ProgramBuilder {
+    std::vector<RTMaterialInstr> instrs;
+
+    uint32_t Emit(uint32_t type, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t texIndex = 0,
+                  const glm::vec4& imm = glm::vec4(0.0f)) {
+        RTMaterialInstr ins{};
+        ins.type = type;
+        ins.dst = static_cast<uint32_t>(instrs.size()) + 1u;
+        ins.a = a;
+        ins.b = b;
+        ins.c = c;
+        ins.texIndex = texIndex;
+        ins.imm = imm;
+        instrs.push_back(ins);
+        return ins.dst;
+    }
+    uint32_t Const(float x) { return Emit(OP_CONST, 0, 0, 0, 0, glm::vec4(x, 0.0f, 0.0f, 0.0f)); }
+};
+
+// Reference interpreter for the opcodes above, mirroring rt_closesthit.rchit
+std::vector<glm::vec4> Run(const std::vector<RTMaterialInstr>& instrs, uint32_t registerCount, const glm::vec2& uv) {
+    std::vector<glm::vec4> regs(registerCount + 1, glm::vec4(0.0f));
+    for (const RTMaterialInstr& ins : instrs) {
+        const glm::vec4 a = regs[ins.a], b = regs[ins.b], c = regs[ins.c];
+        glm::vec4 r(0.0f);
+        switch (ins.type) {
+            case OP_CONST: r = ins.imm; break;
+            case OP_UV: r = glm::vec4(uv.x, uv.y, 0.0f, 0.0f); break;
+            case OP_ADD: r = a + b; break;
+            case OP_MUL: r = a * b; break;
+            case OP_SWIZZLE: r = glm::vec4(a[std::min(ins.texIndex, 3u)], 0.0f, 0.0f, 0.0f); break;
+            case OP_COMBINE3: r = glm::vec4(a.x, b.x, c.x, 1.0f); break;
+            case OP_COMBINE4: r = glm::vec4(a.x, b.x, c.x, regs[ins.texIndex].x); break;
+            default: break;
+        }
+        regs[ins.dst] = r;
+    }
+    return regs;
+}
+
+uint32_t MaxRegister(const std::vector<RTMaterialInstr>& instrs) {
+    uint32_t reg = 0;
+    for (const RTMaterialInstr& ins : instrs) reg = std::max(reg, ins.dst);
+    return reg;
+}
+
+bool Near(const glm::vec4& a, const glm::vec4& b) {
+    for (int i = 0; i < 4; ++i) {
+        if (std::fabs(a[i] - b[i]) > 1e-5f) return false;
+    }
+    return true;
+}
+
+// A long chain of short-lived temporaries: one register per instruction before, a handful after
+void TestRegisterReuse() {
+    ProgramBuilder builder;
+    const uint32_t uv = builder.Emit(OP_UV);
+    uint32_t acc = builder.Emit(OP_SWIZZLE, uv, 0, 0, 0);
+    for (int i = 0; i < 60; ++i) {
+        const uint32_t k = builder.Const(0.5f + static_cast<float>(i));
+        acc = builder.Emit(OP_ADD, builder.Emit(OP_MUL, acc, k), k);
+    }
+    const uint32_t y = builder.Emit(OP_SWIZZLE, uv, 0, 0, 1);
+    const uint32_t color = builder.Emit(OP_COMBINE4, acc, y, acc, y);
+    RTMaterialHeader header{};
+    header.baseColorReg = color;
+    header.roughnessReg = y;
+
+    const std::vector<RTMaterialInstr> original = builder.instrs;
+    const RTMaterialHeader originalHeader = header;
+    CHECK(original.size() > RT_MATERIAL_MAX_REGS);
+
+    std::vector<RTMaterialInstr> allocated = original;
+    RTMaterialProgramStats stats{};
+    std::string error;
+    CHECK(AllocateRTMaterialRegisters(allocated, header, &stats, error));
+    CHECK(error.empty());
+    CHECK(stats.emittedInstrs == original.size());
+    CHECK(stats.instrCount == allocated.size());
+    CHECK(stats.registerCount <= 4);
+    CHECK(MaxRegister(allocated) == stats.registerCount);
+    for (const RTMaterialInstr& ins : allocated) CHECK(ins.dst != 0);
+
+    const glm::vec2 uvValue(0.25f, 0.75f);
+    const std::vector<glm::vec4> expected = Run(original, static_cast<uint32_t>(original.size()), uvValue);
+    const std::vector<glm::vec4> actual = Run(allocated, stats.registerCount, uvValue);
+    CHECK(Near(actual[header.baseColorReg], expected[originalHeader.baseColorReg]));
+    CHECK(Near(actual[header.roughnessReg], expected[originalHeader.roughnessReg]));
+    CHECK(header.instrCount == allocated.size());
+}
+
+void TestMergeAndDeadCode() {
+    ProgramBuilder builder;
+    const uint32_t a = builder.Const(2.0f);
+    const uint32_t b = builder.Const(2.0f);      // Same constant
+    const uint32_t uvA = builder.Emit(OP_UV);
+    const uint32_t uvB = builder.Emit(OP_UV);    // Same value
+    builder.Emit(OP_MUL, uvA, a);                // Never read
+    const uint32_t sumA = builder.Emit(OP_ADD, uvA, a);
+    const uint32_t sumB = builder.Emit(OP_ADD, uvB, b); // Same as sumA once its operands merge
+    RTMaterialHeader header{};
+    header.baseColorReg = sumA;
+    header.emissiveReg = sumB;
+
+    std::vector<RTMaterialInstr> instrs = builder.instrs;
+    RTMaterialProgramStats stats{};
+    std::string error;
+    CHECK(AllocateRTMaterialRegisters(instrs, header, &stats, error));
+    CHECK(instrs.size() == 3);                   // const, uv, add
+    CHECK(header.baseColorReg == header.emissiveReg);
+    CHECK(header.metallicReg == 0 && header.normalReg == 0);
+
+    // Operands that read a later register are rejected
+    std::vector<RTMaterialInstr> forward = builder.instrs;
+    forward[0].a = 5;
+    RTMaterialHeader forwardHeader{};
+    CHECK(!AllocateRTMaterialRegisters(forward, forwardHeader, nullptr, error));
+    CHECK(!error.empty());
+}
+
+void TestRegisterLimit() {
+    // Every value stays live until the end: more than the interpreter holds
+    ProgramBuilder builder;
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < RT_MATERIAL_MAX_REGS + 2; ++i) values.push_back(builder.Const(static_cast<float>(i)));
+    uint32_t sum = values[0];
+    for (size_t i = values.size(); i-- > 1;) sum = builder.Emit(OP_ADD, sum, values[i]);
+    RTMaterialHeader header{};
+    header.baseColorReg = sum;
+
+    std::vector<RTMaterialInstr> instrs = builder.instrs;
+    RTMaterialProgramStats stats{};
+    std::string error;
+    CHECK(!AllocateRTMaterialRegisters(instrs, header, &stats, error));
+    CHECK(stats.registerCount > RT_MATERIAL_MAX_REGS);
+    CHECK(error.find("registers") != std::string::npos);
+}
+
+void TestLinkerSharing() {
+    // Programs are shared when they match after allocation, whatever their virtual numbering
+    ProgramBuilder first;
+    const uint32_t k = first.Const(3.0f);
+    first.Const(9.0f);                           // Dead, changes the numbering only
+    RTMaterialHeader firstHeader{};
+    firstHeader.baseColorReg = first.Emit(OP_MUL, first.Emit(OP_UV), k);
+
+    ProgramBuilder second;
+    const uint32_t uv = second.Emit(OP_UV);
+    RTMaterialHeader secondHeader{};
+    secondHeader.baseColorReg = second.Emit(OP_MUL, uv, second.Const(3.0f));
+
+    ProgramBuilder third;
+    RTMaterialHeader thirdHeader{};
+    thirdHeader.baseColorReg = third.Emit(OP_MUL, third.Emit(OP_UV), third.Const(4.0f));
+
+    std::vector<RTMaterialInstr> buffer;
+    RTMaterialLinker linker(buffer);
+    RTMaterialProgramStats stats{};
+    std::string error;
+
+    CHECK(linker.Add(first.instrs, firstHeader, stats, error));
+    CHECK(!stats.shared);
+    CHECK(stats.bytes == sizeof(RTMaterialHeader) + 3 * sizeof(RTMaterialInstr));
+    const size_t afterFirst = buffer.size();
+
+    // Order of independent instructions differs, so this one is a different program
+    CHECK(linker.Add(second.instrs, secondHeader, stats, error));
+    CHECK(!stats.shared);
+    CHECK(linker.Add(third.instrs, thirdHeader, stats, error));
+    CHECK(!stats.shared);
+    CHECK(thirdHeader.instrOffset == buffer.size() - thirdHeader.instrCount);
+
+    // Same instructions with a different dead constant: runs the first material's copy
+    ProgramBuilder again;
+    const uint32_t k2 = again.Const(3.0f);
+    again.Const(-1.0f);
+    RTMaterialHeader againHeader{};
+    againHeader.baseColorReg = again.Emit(OP_MUL, again.Emit(OP_UV), k2);
+    const size_t beforeShared = buffer.size();
+    CHECK(linker.Add(again.instrs, againHeader, stats, error));
+    CHECK(stats.shared);
+    CHECK(stats.bytes == sizeof(RTMaterialHeader));
+    CHECK(buffer.size() == beforeShared);
+    CHECK(againHeader.instrOffset == firstHeader.instrOffset);
+    CHECK(againHeader.instrCount == firstHeader.instrCount);
+    CHECK(againHeader.baseColorReg == firstHeader.baseColorReg);
+
+    CHECK(linker.GetMaterialCount() == 4);
+    CHECK(linker.GetSharedCount() == 1);
+    CHECK(afterFirst == 3);
+
+    // A failed material leaves the buffer alone
+    const size_t before = buffer.size();
+    RTMaterialHeader bad{};
+    bad.baseColorReg = 100;
+    CHECK(!linker.Add(first.instrs, bad, stats, error));
+    CHECK(buffer.size() == before);
+    CHECK(bad.instrCount == 0 && bad.baseColorReg == 0);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestRegisterReuse();
+    TestMergeAndDeadCode();
+    TestRegisterLimit();
+    TestLinkerSharing();
+
+    return lucent::test::Finish("RT material program");
+}
@@ -0,0 +1,230 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+#include <lucent/material/ShaderCache.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lucent::material::ShaderCache;
+using lucent::material::ShaderCacheStats;
+
+constexpr const char* kOptions = "test-compiler;fragment;vulkan1.2;performance";
+
+// A SPIR-V looking blob: the magic word, then filler that depends on `seed`
+std::vector<uint32_t> MakeSpirv(uint32_t seed, size_t words) {
+    std::vector<uint32_t> spirv(words);
+    spirv[0] = 0x07230203;
+    for (size_t i = 1; i < words; ++i) spirv[i] = seed * 2654435761u + static_cast<uint32_t>(i);
+    return spirv;
+}
+
+size_t CountEntries(const std::filesystem::path& directory) {
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        count += entry.path().extension() == ".spv" ? 1 : 0;
+    }
+    return count;
+}
+
+std::filesystem::path MakeDirectory(const char* name) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+void TestKeys() {
+    const uint64_t key = ShaderCache::MakeKey(1, "void main() {}", kOptions);
+    CHECK(key == ShaderCache::MakeKey(1, "void main() {}", kOptions));
+    CHECK(key != ShaderCache::MakeKey(2, "void main() {}", kOptions));
+    CHECK(key != ShaderCache::MakeKey(1, "void main() { }", kOptions));
+    CHECK(key != ShaderCache::MakeKey(1, "void main() {}", "other-compiler;fragment;vulkan1.2;performance"));
+    // The options and the source do not run into each other
+    CHECK(ShaderCache::MakeKey(1, "ab", "x") != ShaderCache::MakeKey(1, "b", "xa"));
+}
+
+void TestRoundTrip() {
+    const std::filesystem::path directory = MakeDirectory("lucent_test_shadercache");
+    ShaderCache cache;
+    cache.SetDirectory(directory.string());
+    CHECK(cache.IsEnabled());
+
+    const uint64_t key = ShaderCache::MakeKey(7, "glsl", kOptions);
+    const std::vector<uint32_t> spirv = MakeSpirv(7, 64);
+    std::vector<uint32_t> loaded;
+    CHECK(!cache.Load(key, loaded));
+    cache.Store(key, spirv, 0.25);
+    CHECK(cache.Load(key, loaded));
+    CHECK(loaded == spirv);
+    CHECK(CountEntries(directory) == 1);
+
+    const ShaderCacheStats stats = cache.GetStats();
+    CHECK(stats.hits == 1 && stats.misses == 1 && stats.writes == 1);
+    CHECK(stats.GetHitRate() == 0.5);
+    CHECK(stats.secondsSaved > 0.24 && stats.secondsSaved < 0.26);
+    CHECK(stats.entryCount == 1 && stats.diskBytes > spirv.size() * sizeof(uint32_t));
+
+    // Storing the same key again replaces the entry without growing the directory
+    cache.Store(key, MakeSpirv(8, 32), 0.1);
+    CHECK(cache.Load(key, loaded) && loaded == MakeSpirv(8, 32));
+    CHECK(cache.GetStats().entryCount == 1 && CountEntries(directory) == 1);
+
+    std::filesystem::remove_all(directory);
+}
+
+void TestCorruptEntry() {
+    const std::filesystem::path directory = MakeDirectory("lucent_test_shadercache_corrupt");
+    ShaderCache cache;
+    cache.SetDirectory(directory.string());
+
+    const uint64_t key = ShaderCache::MakeKey(3, "glsl", kOptions);
+    cache.Store(key, MakeSpirv(3, 16), 0.1);
+    std::filesystem::path entryPath;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) entryPath = entry.path();
+
+    // Flip one SPIR-V word: the content hash no longer matches
+    {
+        std::fstream file(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-4, std::ios::end);
+        const uint32_t garbage = 0xdeadbeef;
+        file.write(reinterpret_cast<const char*>(&garbage), sizeof(garbage));
+    }
+    std::vector<uint32_t> loaded;
+    CHECK(!cache.Load(key, loaded));
+    CHECK(loaded.empty());
+    CHECK(!std::filesystem::exists(entryPath));
+    CHECK(cache.GetStats().entryCount == 0 && cache.GetStats().diskBytes == 0);
+
+    // Truncated entry
+    cache.Store(key, MakeSpirv(3, 16), 0.1);
+    std::filesystem::resize_file(entryPath, 20);
+    CHECK(!cache.Load(key, loaded));
+    CHECK(!std::filesystem::exists(entryPath));
+
+    std::filesystem::remove_all(directory);
+}
+
+void TestEviction() {
+    const std::filesystem::path directory = MakeDirectory("lucent_test_shadercache_lru");
+    const size_t words = 256;                       // ~1 KB per entry
+    const size_t entryBytes = 40 + words * sizeof(uint32_t);
+    ShaderCache cache;
+    cache.SetDirectory(directory.string(), entryBytes * 3);
+
+    std::vector<uint64_t> keys;
+    for (uint32_t i = 0; i < 3; ++i) {
+        keys.push_back(ShaderCache::MakeKey(i, "glsl", kOptions));
+        cache.Store(keys.back(), MakeSpirv(i, words), 0.1);
+    }
+    CHECK(CountEntries(directory) == 3);
+
+    // Touch the oldest; the fourth entry then evicts the second
+    std::vector<uint32_t> loaded;
+    CHECK(cache.Load(keys[0], loaded));
+    keys.push_back(ShaderCache::MakeKey(3, "glsl", kOptions));
+    cache.Store(keys[3], MakeSpirv(3, words), 0.1);
+
+    CHECK(CountEntries(directory) == 3);
+    CHECK(cache.GetStats().evictions == 1);
+    CHECK(cache.GetStats().diskBytes <= entryBytes * 3);
+    CHECK(cache.Load(keys[0], loaded));
+    CHECK(!cache.Load(keys[1], loaded));
+    CHECK(cache.Load(keys[2], loaded));
+    CHECK(cache.Load(keys[3], loaded));
+
+    // A smaller bound on reopening trims what is already on disk
+    ShaderCache reopened;
+    reopened.SetDirectory(directory.string(), entryBytes);
+    CHECK(reopened.GetStats().entryCount == 1);
+    CHECK(CountEntries(directory) == 1);
+
+    std::filesystem::remove_all(directory);
+}
+
+void TestPersistence() {
+    const std::filesystem::path directory = MakeDirectory("lucent_test_shadercache_persist");
+    const uint64_t key = ShaderCache::MakeKey(11, "glsl", kOptions);
+    {
+        ShaderCache cache;
+        cache.SetDirectory(directory.string());
+        cache.Store(key, MakeSpirv(11, 128), 0.5);
+    }
+    // Leftover from an interrupted write
+    std::ofstream(directory / "0000000000000000.spv.1234.tmp") << "partial";
+
+    ShaderCache cache;
+    cache.SetDirectory(directory.string());
+    CHECK(cache.GetStats().entryCount == 1);
+    CHECK(!std::filesystem::exists(directory / "0000000000000000.spv.1234.tmp"));
+    std::vector<uint32_t> loaded;
+    CHECK(cache.Load(key, loaded) && loaded == MakeSpirv(11, 128));
+    CHECK(cache.GetStats().secondsSaved > 0.49);
+
+    std::filesystem::remove_all(directory);
+}
+
+void TestDisabled() {
+    ShaderCache cache;
+    CHECK(!cache.IsEnabled());
+    const uint64_t key = ShaderCache::MakeKey(5, "glsl", kOptions);
+    cache.Store(key, MakeSpirv(5, 16), 0.1);
+    std::vector<uint32_t> loaded;
+    CHECK(!cache.Load(key, loaded));
+    CHECK(cache.GetStats().writes == 0 && cache.GetStats().entryCount == 0);
+}
+
+void TestConcurrentStores() {
+    const std::filesystem::path directory = MakeDirectory("lucent_test_shadercache_jobs");
+    ShaderCache cache;
+    cache.SetDirectory(directory.string());
+
+    // Several workers compile the same few materials at once
+    std::atomic<uint32_t> mismatches{0};
+    lucent::JobCounter counter;
+    for (uint32_t i = 0; i < 32; ++i) {
+        lucent::JobSystem::Get().Schedule([&cache, &mismatches, i]() {
+            const uint32_t material = i % 4;
+            const uint64_t key = ShaderCache::MakeKey(material, "glsl", kOptions);
+            std::vector<uint32_t> loaded;
+            if (cache.Load(key, loaded)) {
+                if (loaded != MakeSpirv(material, 64)) mismatches.fetch_add(1);
+            } else {
+                cache.Store(key, MakeSpirv(material, 64), 0.1);
+            }
+        }, &counter);
+    }
+    lucent::JobSystem::Get().Wait(counter);
+
+    CHECK(mismatches.load() == 0);
+    CHECK(CountEntries(directory) == 4);
+    CHECK(cache.GetStats().entryCount == 4);
+    CHECK(cache.GetStats().hits + cache.GetStats().misses == 32);
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestKeys();
+    TestRoundTrip();
+    TestCorruptEntry();
+    TestEviction();
+    TestPersistence();
+    TestDisabled();
+
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+    TestConcurrentStores();
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Shader cache");
+}
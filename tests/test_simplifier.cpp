@@ -0,0 +1,276 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/mesh/Simplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace {
+
+using namespace lucent::mesh;
+
+struct TestMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<float> uvs;             // Two per vertex
+    std::vector<uint32_t> indices;
+};
+
+// Quad grid in [x0, x1] x [0, 1] on the XZ plane with uv = (x, z)
+void AppendGrid(TestMesh& mesh, uint32_t columns, uint32_t rows, float x0, float x1) {
+    const uint32_t base = static_cast<uint32_t>(mesh.positions.size());
+    for (uint32_t z = 0; z <= rows; ++z) {
+        for (uint32_t x = 0; x <= columns; ++x) {
+            const float px = x0 + (x1 - x0) * static_cast<float>(x) / static_cast<float>(columns);
+            const float pz = static_cast<float>(z) / static_cast<float>(rows);
+            mesh.positions.emplace_back(px, 0.0f, pz);
+            mesh.uvs.push_back(px);
+            mesh.uvs.push_back(pz);
+        }
+    }
+    for (uint32_t z = 0; z < rows; ++z) {
+        for (uint32_t x = 0; x < columns; ++x) {
+            const uint32_t i = base + z * (columns + 1) + x;
+            mesh.indices.insert(mesh.indices.end(), { i, i + columns + 1, i + 1 });
+            mesh.indices.insert(mesh.indices.end(), { i + 1, i + columns + 1, i + columns + 2 });
+        }
+    }
+}
+
+// Unit sphere made of six projected cube faces; face edges are duplicated vertices (wedges)
+TestMesh MakeCubeSphere(uint32_t n) {
+    TestMesh mesh;
+    auto coord = [n](uint32_t i) { return -1.0f + 2.0f * static_cast<float>(i) / static_cast<float>(n); };
+    for (int face = 0; face < 6; ++face) {
+        const uint32_t base = static_cast<uint32_t>(mesh.positions.size());
+        const int axis = face / 2;
+        const bool positive = face % 2 == 0;
+        for (uint32_t v = 0; v <= n; ++v) {
+            for (uint32_t u = 0; u <= n; ++u) {
+                glm::vec3 p;
+                p[axis] = positive ? 1.0f : -1.0f;
+                p[(axis + 1) % 3] = coord(u);
+                p[(axis + 2) % 3] = coord(v);
+                mesh.positions.push_back(glm::normalize(p));
+                mesh.uvs.push_back(static_cast<float>(u) / static_cast<float>(n));
+                mesh.uvs.push_back(static_cast<float>(v) / static_cast<float>(n));
+            }
+        }
+        for (uint32_t v = 0; v < n; ++v) {
+            for (uint32_t u = 0; u < n; ++u) {
+                const uint32_t i = base + v * (n + 1) + u;
+                const uint32_t j = i + n + 1;
+                if (positive) {
+                    mesh.indices.insert(mesh.indices.end(), { i, i + 1, j, i + 1, j + 1, j });
+                } else {
+                    mesh.indices.insert(mesh.indices.end(), { i, j, i + 1, i + 1, j, j + 1 });
+                }
+            }
+        }
+    }
+    return mesh;
+}
+
+bool IsValid(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    return indices.size() % 3 == 0 &&
+           std::all_of(indices.begin(), indices.end(), [&](uint32_t i) { return i < vertexCount; });
+}
+
+void TestFlatGridCollapses() {
+    TestMesh mesh;
+    AppendGrid(mesh, 32, 32, 0.0f, 1.0f);
+
+    Simplifier::Options options;
+    options.targetError = 1e-3f;
+    std::vector<uint32_t> result;
+    const Simplifier::Result r = Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+
+    CHECK(IsValid(result, mesh.positions.size()));
+    CHECK(r.indexCount == result.size());
+    // A plane with straight borders needs only a handful of triangles, at no error
+    CHECK(result.size() * 20 < mesh.indices.size());
+    CHECK(r.error < 1e-4f);
+
+    // The outline survives: all four corners are still referenced
+    const std::set<uint32_t> used(result.begin(), result.end());
+    CHECK(used.count(0) && used.count(32) && used.count(33 * 32) && used.count(33 * 33 - 1));
+}
+
+void TestErrorBound() {
+    const TestMesh mesh = MakeCubeSphere(24);
+    const float scale = Simplifier::GetScale(mesh.positions);
+    CHECK(std::abs(scale - 2.0f) < 1e-4f);
+
+    for (float targetError : { 0.002f, 0.01f, 0.05f }) {
+        Simplifier::Options options;
+        options.targetError = targetError;
+        std::vector<uint32_t> result;
+        const Simplifier::Result r = Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+
+        CHECK(IsValid(result, mesh.positions.size()));
+        CHECK(result.size() < mesh.indices.size());
+        CHECK(r.error <= targetError);
+
+        // Triangle centroids sink below the sphere; the sag, relative to the extent, stays within
+        // a small multiple of the reported error (quadrics measure mean, not maximum, distance)
+        float maxSag = 0.0f;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const glm::vec3 centroid = (mesh.positions[result[i]] + mesh.positions[result[i + 1]] +
+                                        mesh.positions[result[i + 2]]) / 3.0f;
+            maxSag = std::max(maxSag, (1.0f - glm::length(centroid)) / scale);
+        }
+        CHECK(maxSag <= 2.0f * r.error + 1e-3f);
+    }
+
+    // A tighter target keeps more triangles
+    std::vector<uint32_t> coarse, fine;
+    Simplifier::Options options;
+    options.targetError = 0.05f;
+    Simplifier::Simplify(mesh.positions, mesh.indices, coarse, options);
+    options.targetError = 0.002f;
+    Simplifier::Simplify(mesh.positions, mesh.indices, fine, options);
+    CHECK(coarse.size() < fine.size());
+}
+
+void TestTargetIndexCount() {
+    const TestMesh mesh = MakeCubeSphere(16);
+    Simplifier::Options options;
+    options.targetIndexCount = mesh.indices.size() / 4;
+    options.targetError = 1.0f;
+    std::vector<uint32_t> result;
+    const Simplifier::Result r = Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+    CHECK(result.size() <= options.targetIndexCount);
+    // ...without overshooting by much: one pass stops as soon as the target is reached
+    CHECK(result.size() * 2 > options.targetIndexCount);
+    CHECK(r.error > 0.0f);
+
+    // Already at the target: indices come back unchanged
+    options.targetIndexCount = mesh.indices.size();
+    Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+    CHECK(result == mesh.indices);
+}
+
+void TestLockBorder() {
+    // Curved sheet so interior collapses cost something but are still allowed
+    TestMesh mesh;
+    AppendGrid(mesh, 24, 24, 0.0f, 1.0f);
+    for (glm::vec3& p : mesh.positions) {
+        p.y = 0.02f * std::sin(p.x * 3.0f) * std::sin(p.z * 3.0f);
+    }
+
+    Simplifier::Options options;
+    options.targetError = 0.02f;
+    options.lockBorder = true;
+    std::vector<uint32_t> result;
+    Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+    CHECK(result.size() < mesh.indices.size() / 2);
+
+    const std::set<uint32_t> used(result.begin(), result.end());
+    for (uint32_t v = 0; v < mesh.positions.size(); ++v) {
+        const glm::vec3& p = mesh.positions[v];
+        const bool border = p.x == 0.0f || p.x == 1.0f || p.z == 0.0f || p.z == 1.0f;
+        if (border) CHECK(used.count(v));
+    }
+}
+
+void TestSeamsStayIntact() {
+    // Two grids meeting at x = 0.5 with duplicated vertices there; the right half's uvs are
+    // offset so the shared positions are distinct wedges
+    TestMesh mesh;
+    AppendGrid(mesh, 16, 16, 0.0f, 0.5f);
+    const size_t leftVertices = mesh.positions.size();
+    AppendGrid(mesh, 16, 16, 0.5f, 1.0f);
+    for (size_t v = leftVertices; v < mesh.positions.size(); ++v) {
+        mesh.uvs[v * 2] += 10.0f;
+    }
+
+    const float weights[] = { 1.0f, 1.0f };
+    Simplifier::Options options;
+    options.targetError = 1e-3f;
+    options.attributes = mesh.uvs;
+    options.attributeWeights = weights;
+    std::vector<uint32_t> result;
+    Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+    CHECK(IsValid(result, mesh.positions.size()));
+    CHECK(result.size() * 4 < mesh.indices.size());
+
+    // No triangle mixes wedges from both sides, and none crosses the seam
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const bool left = result[i] < leftVertices;
+        float minX = 1.0f, maxX = 0.0f;
+        for (size_t k = 0; k < 3; ++k) {
+            CHECK((result[i + k] < leftVertices) == left);
+            minX = std::min(minX, mesh.positions[result[i + k]].x);
+            maxX = std::max(maxX, mesh.positions[result[i + k]].x);
+        }
+        CHECK(left ? maxX <= 0.5f : minX >= 0.5f);
+    }
+}
+
+void TestAttributesKeepDetail() {
+    // Flat grid whose colour has a sharp ramp: geometry alone would collapse it all
+    TestMesh mesh;
+    AppendGrid(mesh, 32, 32, 0.0f, 1.0f);
+    std::vector<float> colour(mesh.positions.size());
+    for (size_t v = 0; v < mesh.positions.size(); ++v) {
+        colour[v] = std::tanh((mesh.positions[v].x - 0.5f) * 20.0f);
+    }
+
+    Simplifier::Options options;
+    options.targetError = 0.01f;
+    std::vector<uint32_t> plain, weighted;
+    Simplifier::Simplify(mesh.positions, mesh.indices, plain, options);
+
+    const float weights[] = { 0.5f };
+    options.attributes = colour;
+    options.attributeWeights = weights;
+    const Simplifier::Result r = Simplifier::Simplify(mesh.positions, mesh.indices, weighted, options);
+    CHECK(r.error <= options.targetError);
+    CHECK(weighted.size() > plain.size() * 4);
+    CHECK(weighted.size() < mesh.indices.size());
+}
+
+void TestNonManifoldIsLocked() {
+    // Three sheets sharing the edge x in [0, 1] (a fin); two of them wind the edge the same way
+    TestMesh mesh;
+    const glm::vec3 directions[] = { { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    for (const glm::vec3& direction : directions) {
+        const size_t first = mesh.positions.size();
+        AppendGrid(mesh, 8, 8, 0.0f, 1.0f);
+        for (size_t v = first; v < mesh.positions.size(); ++v) {
+            mesh.positions[v] = glm::vec3(mesh.positions[v].x, 0.0f, 0.0f) + direction * mesh.positions[v].z;
+        }
+    }
+
+    Simplifier::Options options;
+    options.targetError = 0.05f;
+    std::vector<uint32_t> result;
+    Simplifier::Simplify(mesh.positions, mesh.indices, result, options);
+    CHECK(IsValid(result, mesh.positions.size()));
+    CHECK(result.size() < mesh.indices.size());
+
+    // Every point on the shared edge is still there
+    std::set<float> edgePoints;
+    for (uint32_t index : result) {
+        const glm::vec3& p = mesh.positions[index];
+        if (p.y == 0.0f && p.z == 0.0f) edgePoints.insert(p.x);
+    }
+    CHECK(edgePoints.size() == 9);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestFlatGridCollapses();
+    TestErrorBound();
+    TestTargetIndexCount();
+    TestLockBorder();
+    TestSeamsStayIntact();
+    TestAttributesKeepDetail();
+    TestNonManifoldIsLocked();
+
+    return lucent::test::Finish("Simplifier");
+}
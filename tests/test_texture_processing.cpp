@@ -0,0 +1,354 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+#include <lucent/gfx/TextureProcessing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lucent::gfx::DecodedImage;
+using lucent::gfx::ProcessedTexture;
+using lucent::gfx::TextureBlockFormat;
+using lucent::gfx::TextureContent;
+
+DecodedImage MakeImage(uint32_t width, uint32_t height, uint8_t (*fn)(uint32_t x, uint32_t y, int c)) {
+    DecodedImage image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * 4);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            for (int c = 0; c < 4; ++c) {
+                image.pixels[(static_cast<size_t>(y) * width + x) * 4 + c] = fn(x, y, c);
+            }
+        }
+    }
+    return image;
+}
+
+// ============================================================================
+// Reference decoders (straight from the format specs, independent of the encoders)
+// ============================================================================
+
+uint32_t ReadBits(const uint8_t* block, uint32_t& bit, uint32_t count) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; ++i, ++bit) {
+        value |= static_cast<uint32_t>((block[bit >> 3] >> (bit & 7)) & 1u) << i;
+    }
+    return value;
+}
+
+void DecodeBC1(const uint8_t* block, uint8_t out[16][4]) {
+    const uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    const uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+    int palette[4][3];
+    for (int e = 0; e < 2; ++e) {
+        const uint16_t c = e == 0 ? c0 : c1;
+        const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        palette[e][0] = (r << 3) | (r >> 2);
+        palette[e][1] = (g << 2) | (g >> 4);
+        palette[e][2] = (b << 3) | (b >> 2);
+    }
+    for (int c = 0; c < 3; ++c) {
+        if (c0 > c1) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        const int index = (block[4 + i / 4] >> (2 * (i % 4))) & 3;
+        for (int c = 0; c < 3; ++c) out[i][c] = static_cast<uint8_t>(palette[index][c]);
+        out[i][3] = 255;
+    }
+}
+
+void DecodeBC4(const uint8_t* block, uint8_t out[16]) {
+    const int r0 = block[0], r1 = block[1];
+    int palette[8] = { r0, r1 };
+    for (int p = 2; p < 8; ++p) {
+        palette[p] = r0 > r1 ? ((8 - p) * r0 + (p - 1) * r1) / 7 : (p < 6 ? ((6 - p) * r0 + (p - 1) * r1) / 5 : (p == 6 ? 0 : 255));
+    }
+    uint32_t bit = 16;
+    for (int i = 0; i < 16; ++i) {
+        out[i] = static_cast<uint8_t>(palette[ReadBits(block, bit, 3)]);
+    }
+}
+
+constexpr int kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Mode 6 only
+bool DecodeBC7Mode6(const uint8_t* block, uint8_t out[16][4]) {
+    uint32_t bit = 0;
+    if (ReadBits(block, bit, 7) != (1u << 6)) return false;
+    uint32_t e[2][4];
+    for (int c = 0; c < 4; ++c) {
+        e[0][c] = ReadBits(block, bit, 7);
+        e[1][c] = ReadBits(block, bit, 7);
+    }
+    const uint32_t p0 = ReadBits(block, bit, 1);
+    const uint32_t p1 = ReadBits(block, bit, 1);
+    for (int c = 0; c < 4; ++c) {
+        e[0][c] = (e[0][c] << 1) | p0;
+        e[1][c] = (e[1][c] << 1) | p1;
+    }
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t index = ReadBits(block, bit, i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; ++c) {
+            out[i][c] = static_cast<uint8_t>(((64 - kWeights4[index]) * e[0][c] + kWeights4[index] * e[1][c] + 32) >> 6);
+        }
+    }
+    return true;
+}
+
+float HalfToFloat(uint32_t half) {
+    const uint32_t exponent = (half >> 10) & 31, mantissa = half & 1023;
+    if (exponent == 0) return std::ldexp(static_cast<float>(mantissa), -24);
+    return std::ldexp(static_cast<float>(mantissa | 1024), static_cast<int>(exponent) - 25);
+}
+
+// Mode 11 only, unsigned
+bool DecodeBC6HMode11(const uint8_t* block, float out[16][3]) {
+    uint32_t bit = 0;
+    if (ReadBits(block, bit, 5) != 0x03) return false;
+    int e[2][3];
+    for (int endpoint = 0; endpoint < 2; ++endpoint) {
+        for (int c = 0; c < 3; ++c) {
+            const int q = static_cast<int>(ReadBits(block, bit, 10));
+            e[endpoint][c] = q == 0 ? 0 : (q == 1023 ? 0xFFFF : ((q << 16) + 0x8000) >> 10);
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t index = ReadBits(block, bit, i == 0 ? 3 : 4);
+        for (int c = 0; c < 3; ++c) {
+            const int v = ((64 - kWeights4[index]) * e[0][c] + kWeights4[index] * e[1][c] + 32) >> 6;
+            out[i][c] = HalfToFloat(static_cast<uint32_t>((v * 31) >> 6));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void TestMipChain() {
+    // 5x3: odd sizes must still reach 1x1 with every texel contributing
+    DecodedImage image = MakeImage(5, 3, [](uint32_t x, uint32_t, int c) -> uint8_t {
+        return c == 3 ? 255 : static_cast<uint8_t>(x * 50);
+    });
+    std::vector<DecodedImage> chain = lucent::gfx::GenerateMipChain(image, false, TextureContent::Color);
+    CHECK(chain.size() == 3);
+    CHECK(chain[1].width == 2 && chain[1].height == 1);
+    CHECK(chain[2].width == 1 && chain[2].height == 1);
+    // Mean of 0, 50, 100, 150, 200
+    CHECK(std::abs(chain[2].pixels[0] - 100) <= 1);
+
+    // sRGB: black and white average to linear 0.5, i.e. ~188 in sRGB (not 128)
+    DecodedImage checker = MakeImage(2, 2, [](uint32_t x, uint32_t y, int c) -> uint8_t {
+        return c == 3 ? 255 : static_cast<uint8_t>(((x + y) & 1) ? 255 : 0);
+    });
+    std::vector<DecodedImage> srgbChain = lucent::gfx::GenerateMipChain(checker, true, TextureContent::Color);
+    CHECK(srgbChain.size() == 2);
+    CHECK(std::abs(srgbChain[1].pixels[0] - 188) <= 1);
+
+    // Fully transparent texels do not darken the colour of the visible ones
+    DecodedImage cutout = MakeImage(2, 1, [](uint32_t x, uint32_t, int c) -> uint8_t {
+        if (c == 3) return x == 0 ? 255 : 0;
+        return x == 0 ? 200 : 0;
+    });
+    std::vector<DecodedImage> cutoutChain = lucent::gfx::GenerateMipChain(cutout, false, TextureContent::Color);
+    CHECK(cutoutChain[1].pixels[0] == 200 && std::abs(cutoutChain[1].pixels[3] - 128) <= 1);
+
+    // Normal maps are renormalised: +X and +Z average to a unit vector at 45 degrees
+    DecodedImage normals = MakeImage(2, 1, [](uint32_t x, uint32_t, int c) -> uint8_t {
+        const float v[4] = { x == 0 ? 1.0f : 0.0f, 0.0f, x == 0 ? 0.0f : 1.0f, 1.0f };
+        return static_cast<uint8_t>(std::lround((v[c] * 0.5f + 0.5f) * 255.0f));
+    });
+    std::vector<DecodedImage> normalChain = lucent::gfx::GenerateMipChain(normals, false, TextureContent::NormalMap);
+    const float nx = normalChain[1].pixels[0] / 127.5f - 1.0f;
+    const float nz = normalChain[1].pixels[2] / 127.5f - 1.0f;
+    CHECK(std::abs(std::sqrt(nx * nx + nz * nz) - 1.0f) < 0.02f);
+}
+
+void TestClassification() {
+    DecodedImage flatNormal = MakeImage(8, 8, [](uint32_t x, uint32_t, int c) -> uint8_t {
+        const uint8_t v[4] = { static_cast<uint8_t>(120 + x), 128, 250, 255 };
+        return v[c];
+    });
+    CHECK(lucent::gfx::ClassifyTexture(flatNormal, false) == TextureContent::NormalMap);
+    CHECK(lucent::gfx::ClassifyTexture(flatNormal, true) == TextureContent::Color);
+    CHECK(lucent::gfx::ChooseBlockFormat(flatNormal, false, TextureContent::NormalMap) == TextureBlockFormat::BC5);
+
+    DecodedImage grey = MakeImage(8, 8, [](uint32_t x, uint32_t y, int c) -> uint8_t {
+        return c == 3 ? 255 : static_cast<uint8_t>(x * 16 + y);
+    });
+    CHECK(lucent::gfx::ClassifyTexture(grey, false) == TextureContent::Grayscale);
+    CHECK(lucent::gfx::ChooseBlockFormat(grey, false, TextureContent::Grayscale) == TextureBlockFormat::BC4);
+
+    DecodedImage colour = MakeImage(8, 8, [](uint32_t x, uint32_t y, int c) -> uint8_t {
+        const uint8_t v[4] = { static_cast<uint8_t>(x * 30), static_cast<uint8_t>(y * 30), 40, 255 };
+        return v[c];
+    });
+    CHECK(lucent::gfx::ChooseBlockFormat(colour, true, TextureContent::Color) == TextureBlockFormat::BC1);
+    colour.pixels[3] = 10;
+    CHECK(lucent::gfx::ChooseBlockFormat(colour, true, TextureContent::Color) == TextureBlockFormat::BC7);
+}
+
+void TestBlockCompression() {
+    // Diagonal gradient with a partial block on each axis (10x6). Colours within a block lie on a
+    // line, which every single-partition mode can represent up to endpoint/index quantisation.
+    DecodedImage image = MakeImage(10, 6, [](uint32_t x, uint32_t y, int c) -> uint8_t {
+        const uint32_t t = x * 12 + y * 9;
+        const uint8_t v[4] = { static_cast<uint8_t>(20 + t), static_cast<uint8_t>(200 - t * 4 / 5),
+                               static_cast<uint8_t>(60 + t / 2), static_cast<uint8_t>(255 - t / 2) };
+        return v[c];
+    });
+    const uint32_t blocksX = 3, blocksY = 2;
+
+    auto maxError = [&](TextureBlockFormat format, int channels) {
+        std::vector<uint8_t> blocks = lucent::gfx::CompressImage(image, format);
+        CHECK(blocks.size() == blocksX * blocksY * lucent::gfx::GetBlockSizeBytes(format));
+        int worst = 0;
+        for (uint32_t b = 0; b < blocksX * blocksY; ++b) {
+            const uint8_t* block = blocks.data() + b * lucent::gfx::GetBlockSizeBytes(format);
+            uint8_t decoded[16][4] = {};
+            if (format == TextureBlockFormat::BC1) {
+                DecodeBC1(block, decoded);
+            } else if (format == TextureBlockFormat::BC7) {
+                CHECK(DecodeBC7Mode6(block, decoded));
+            } else {
+                for (int channel = 0; channel < (format == TextureBlockFormat::BC5 ? 2 : 1); ++channel) {
+                    uint8_t values[16];
+                    DecodeBC4(block + channel * 8, values);
+                    for (int i = 0; i < 16; ++i) decoded[i][channel] = values[i];
+                }
+            }
+            for (uint32_t i = 0; i < 16; ++i) {
+                const uint32_t x = std::min((b % blocksX) * 4 + (i & 3), image.width - 1);
+                const uint32_t y = std::min((b / blocksX) * 4 + (i >> 2), image.height - 1);
+                const uint8_t* source = &image.pixels[(y * image.width + x) * 4];
+                for (int c = 0; c < channels; ++c) worst = std::max(worst, std::abs(decoded[i][c] - source[c]));
+            }
+        }
+        return worst;
+    };
+
+    CHECK(maxError(TextureBlockFormat::BC1, 3) <= 12);
+    CHECK(maxError(TextureBlockFormat::BC4, 1) <= 4);
+    CHECK(maxError(TextureBlockFormat::BC5, 2) <= 4);
+    CHECK(maxError(TextureBlockFormat::BC7, 4) <= 4);
+
+    // A solid block is reproduced exactly by BC4 and within endpoint precision by BC7
+    DecodedImage solid = MakeImage(4, 4, [](uint32_t, uint32_t, int c) -> uint8_t {
+        const uint8_t v[4] = { 90, 140, 17, 255 };
+        return v[c];
+    });
+    std::vector<uint8_t> bc4 = lucent::gfx::CompressImage(solid, TextureBlockFormat::BC4);
+    uint8_t values[16];
+    DecodeBC4(bc4.data(), values);
+    CHECK(values[0] == 90 && values[15] == 90);
+    std::vector<uint8_t> bc7 = lucent::gfx::CompressImage(solid, TextureBlockFormat::BC7);
+    uint8_t decoded[16][4];
+    CHECK(DecodeBC7Mode6(bc7.data(), decoded));
+    CHECK(std::abs(decoded[5][0] - 90) <= 1 && std::abs(decoded[5][1] - 140) <= 1 && decoded[5][3] == 255);
+
+    // HDR: values beyond 1.0 survive BC6H. Interpolation happens on half-float bit patterns, which
+    // is piecewise linear in value, so allow a relative error rather than an absolute one.
+    DecodedImage hdr;
+    hdr.width = 4;
+    hdr.height = 4;
+    hdr.hdr = true;
+    hdr.bytesPerPixel = 16;
+    hdr.pixels.resize(4 * 4 * 16);
+    std::vector<float> source(16 * 4);
+    for (int i = 0; i < 16; ++i) {
+        source[i * 4 + 0] = 0.5f + static_cast<float>(i) * 0.75f;
+        source[i * 4 + 1] = 2.0f;
+        source[i * 4 + 2] = 0.1f + static_cast<float>(i) * 0.01f;
+        source[i * 4 + 3] = 1.0f;
+    }
+    std::memcpy(hdr.pixels.data(), source.data(), hdr.pixels.size());
+    std::vector<uint8_t> bc6 = lucent::gfx::CompressImage(hdr, TextureBlockFormat::BC6H);
+    float hdrDecoded[16][3];
+    CHECK(bc6.size() == 16 && DecodeBC6HMode11(bc6.data(), hdrDecoded));
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const float expected = source[i * 4 + c];
+            CHECK(std::abs(hdrDecoded[i][c] - expected) <= expected * 0.2f);
+        }
+    }
+}
+
+void TestContainer() {
+    DecodedImage image = MakeImage(13, 7, [](uint32_t x, uint32_t y, int c) -> uint8_t {
+        return c == 3 ? 255 : static_cast<uint8_t>(x * 19 + y * 7 + c * 40);
+    });
+
+    lucent::gfx::TextureProcessSettings settings;
+    settings.sRGB = true;
+    settings.generateMips = true;
+    settings.compress = true;
+    settings.sourceVersion = 1234;
+    settings.cachePath = lucent::gfx::GetTextureContainerPath(
+        (std::filesystem::temp_directory_path() / "lucent_test_texcache").string(), "srgb:/textures/a.png");
+    CHECK(settings.cachePath == lucent::gfx::GetTextureContainerPath(
+        (std::filesystem::temp_directory_path() / "lucent_test_texcache").string(), "srgb:/textures/a.png"));
+
+    ProcessedTexture processed = lucent::gfx::ProcessTexture(image, settings);
+    CHECK(processed.format == TextureBlockFormat::BC1 && processed.sRGB);
+    CHECK(processed.GetMipCount() == 4); // 13x7, 6x3, 3x1, 1x1
+    CHECK(processed.levels[1].width == 6 && processed.levels[1].height == 3);
+    CHECK(processed.levels[0].size == 4 * 2 * 8);
+    for (const auto& level : processed.levels) CHECK(level.offset % 16 == 0);
+
+    std::string error;
+    CHECK(lucent::gfx::WriteTextureContainer(settings.cachePath, processed, settings, &error));
+
+    ProcessedTexture loaded;
+    CHECK(lucent::gfx::ReadTextureContainer(settings.cachePath, settings, loaded, &error));
+    CHECK(loaded.format == processed.format && loaded.content == processed.content);
+    CHECK(loaded.width == 13 && loaded.height == 7 && loaded.sRGB);
+    CHECK(loaded.GetMipCount() == processed.GetMipCount());
+    CHECK(loaded.data == processed.data);
+
+    // A changed source or different settings reject the file
+    lucent::gfx::TextureProcessSettings changed = settings;
+    changed.sourceVersion = 1235;
+    CHECK(!lucent::gfx::ReadTextureContainer(settings.cachePath, changed, loaded));
+    changed = settings;
+    changed.compress = false;
+    CHECK(!lucent::gfx::ReadTextureContainer(settings.cachePath, changed, loaded));
+
+    std::filesystem::remove_all(std::filesystem::temp_directory_path() / "lucent_test_texcache");
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestMipChain();
+    TestClassification();
+    TestBlockCompression();
+    TestContainer();
+
+    // Same results with mips and blocks spread over the pool
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+    TestMipChain();
+    TestBlockCompression();
+    TestContainer();
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Texture processing");
+}
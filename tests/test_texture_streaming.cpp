@@ -0,0 +1,154 @@
+#include "TestHarness.h"
+#include <lucent/core/Log.h>
+#include <lucent/core/JobSystem.h>
+#include <lucent/gfx/TextureStreaming.h>
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Binary PPM: the simplest format stb_image decodes. Row y is filled with (y, x, seed).
+std::vector<uint8_t> MakePPM(uint32_t width, uint32_t height, uint8_t seed) {
+    const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    std::vector<uint8_t> data(header.begin(), header.end());
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            data.push_back(static_cast<uint8_t>(y));
+            data.push_back(static_cast<uint8_t>(x));
+            data.push_back(seed);
+        }
+    }
+    return data;
+}
+
+void TestDecodeMemory() {
+    const std::vector<uint8_t> ppm = MakePPM(3, 2, 7);
+
+    lucent::gfx::DecodedImage image;
+    CHECK(lucent::gfx::DecodeImageMemory(ppm.data(), ppm.size(), false, image));
+    CHECK(image.width == 3 && image.height == 2);
+    CHECK(!image.hdr && image.bytesPerPixel == 4);
+    CHECK(image.GetSizeBytes() == 3 * 2 * 4);
+    // Pixel (x=2, y=1): expanded to RGBA with opaque alpha
+    const uint8_t* px = &image.pixels[(1 * 3 + 2) * 4];
+    CHECK(px[0] == 1 && px[1] == 2 && px[2] == 7 && px[3] == 255);
+
+    lucent::gfx::DecodedImage flipped;
+    CHECK(lucent::gfx::DecodeImageMemory(ppm.data(), ppm.size(), true, flipped));
+    CHECK(flipped.pixels[0] == 1); // First row now holds source row 1
+
+    const uint8_t garbage[] = { 'n', 'o', 't', ' ', 'a', 'n', ' ', 'i', 'm', 'a', 'g', 'e' };
+    lucent::gfx::DecodedImage bad;
+    std::string error;
+    CHECK(!lucent::gfx::DecodeImageMemory(garbage, sizeof(garbage), false, bad, &error));
+    CHECK(!error.empty());
+}
+
+void TestDecodeQueue() {
+    lucent::gfx::TextureDecodeQueue queue;
+
+    constexpr uint32_t kImages = 24;
+    std::set<uint64_t> ids;
+    for (uint32_t i = 0; i < kImages; ++i) {
+        ids.insert(queue.EnqueueMemory(MakePPM(16 + i, 8, static_cast<uint8_t>(i)), false));
+    }
+
+    // File requests go through the same queue
+    const std::filesystem::path file = std::filesystem::temp_directory_path() / "lucent_test_texture.ppm";
+    {
+        const std::vector<uint8_t> ppm = MakePPM(4, 4, 99);
+        std::ofstream out(file, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(ppm.data()), static_cast<std::streamsize>(ppm.size()));
+    }
+    const uint64_t fileId = queue.EnqueueFile(file.string(), false);
+    const uint64_t missingId = queue.EnqueueFile((file.parent_path() / "lucent_missing.ppm").string(), false);
+    ids.insert(fileId);
+    ids.insert(missingId);
+    CHECK(ids.size() == kImages + 2);
+
+    queue.WaitIdle();
+    CHECK(queue.GetPendingCount() == kImages + 2);
+
+    // A byte limit smaller than one image still makes progress
+    std::vector<lucent::gfx::TextureDecodeQueue::Result> first = queue.PopCompleted(1);
+    CHECK(first.size() == 1);
+
+    std::vector<lucent::gfx::TextureDecodeQueue::Result> results = queue.PopCompleted();
+    results.insert(results.end(), std::make_move_iterator(first.begin()), std::make_move_iterator(first.end()));
+    CHECK(results.size() == kImages + 2);
+    CHECK(queue.GetPendingCount() == 0);
+
+    for (const auto& result : results) {
+        CHECK(ids.erase(result.id) == 1);
+        if (result.id == missingId) {
+            CHECK(!result.success && !result.error.empty());
+        } else if (result.id == fileId) {
+            CHECK(result.success && result.texture.width == 4 && result.texture.data[2] == 99);
+        } else {
+            CHECK(result.success && result.texture.height == 8 && result.texture.GetMipCount() == 1);
+        }
+    }
+    CHECK(ids.empty());
+    CHECK(queue.PopCompleted().empty());
+
+    std::filesystem::remove(file);
+}
+
+void TestStagingRing() {
+    using lucent::gfx::StagingRing;
+    StagingRing ring(1000, 16);
+    CHECK(ring.GetCapacity() == 992); // Rounded down to the alignment
+
+    CHECK(ring.Allocate(100) == 0);
+    CHECK(ring.Allocate(100) == 112); // Aligned
+    CHECK(ring.Allocate(993) == StagingRing::kInvalidOffset); // Can never fit
+    const uint64_t batch1 = ring.Submit();
+    CHECK(batch1 != 0);
+    CHECK(ring.Submit() == 0); // Empty batch
+
+    CHECK(ring.Allocate(500) == 224);
+    CHECK(ring.Submit() != 0);
+    CHECK(ring.GetInFlightBatchCount() == 2);
+
+    // Does not fit after offset 724, and wrapping would overrun batch1
+    CHECK(ring.Allocate(300) == StagingRing::kInvalidOffset);
+
+    ring.Retire(batch1);
+    CHECK(ring.GetInFlightBatchCount() == 1);
+    CHECK(ring.Allocate(200) == 736);
+    CHECK(ring.Allocate(150) == 0); // Wrapped into batch1's space
+    const uint64_t batch3 = ring.Submit();
+    CHECK(ring.Allocate(300) == StagingRing::kInvalidOffset);
+
+    // Retiring a later batch releases everything before it
+    ring.Retire(batch3);
+    CHECK(ring.GetInFlightBatchCount() == 0);
+    CHECK(ring.GetUsedBytes() == 0);
+
+    // An idle ring restarts at offset 0, so a near-capacity upload fits
+    CHECK(ring.Allocate(990) == 0);
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    // Inline decoding (no workers)
+    TestDecodeMemory();
+    TestDecodeQueue();
+    TestStagingRing();
+
+    // Decoding on the pool
+    lucent::JobSystemConfig config{};
+    config.workerCount = 4;
+    CHECK(lucent::JobSystem::Get().Init(config));
+    TestDecodeQueue();
+    lucent::JobSystem::Get().Shutdown();
+
+    return lucent::test::Finish("Texture streaming");
+}
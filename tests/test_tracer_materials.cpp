@@ -0,0 +1,183 @@
+#include "TestHarness.h"
+#include "MaterialTestGraphs.h"
+#include <lucent/core/Log.h>
+#include <lucent/material/MaterialGraph.h>
+#include <lucent/material/RTMaterialCompiler.h>
+#include <lucent/material/TracerMaterials.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lucent;
+using namespace lucent::material;
+using namespace lucent::material::test;
+
+// A constant colour times a constant into Base Color, a constant into Roughness
+MaterialGraph MakeGraph(const glm::vec3& color, float roughness) {
+    MaterialGraph graph;
+    graph.CreateDefault();
+    ConnectToOutput(graph, AddNode(graph, NodeType::Multiply, { AddConst(graph, color), AddConst(graph, 0.5f) }),
+                    "Base Color");
+    ConnectToOutput(graph, AddConst(graph, roughness), "Roughness");
+    return graph;
+}
+
+gfx::GPUMaterial ComponentMaterial(const glm::vec3& color) {
+    gfx::GPUMaterial mat{};
+    mat.baseColor = glm::vec4(color.x, color.y, color.z, 1.0f);
+    mat.emissive = glm::vec4(0.0f);
+    mat.metallic = 0.0f;
+    mat.roughness = 0.5f;
+    mat.ior = 1.5f;
+    mat.flags = 0;
+    return mat;
+}
+
+// Tracer buffers with the default material at index 0, as BuildTracerSceneData starts them
+struct Buffers {
+    std::vector<gfx::GPUMaterial> materials{ ComponentMaterial(glm::vec3(0.8f)) };
+    std::vector<gfx::RTMaterialHeader> headers{ gfx::RTMaterialHeader{} };
+    std::vector<gfx::RTMaterialInstr> instrs;
+};
+
+struct CountingCompiler {
+    int calls = 0;
+
+    TracerMaterialTable::RTCompileFunction Function() {
+        return [this](const MaterialGraph& graph, gfx::RTMaterialHeader& header,
+                      std::pmr::vector<gfx::RTMaterialInstr>& instrs, std::string& outError) {
+            ++calls;
+            return CompileRTMaterialProgram(graph, header, instrs, outError);
+        };
+    }
+};
+
+void TestInstancesShare() {
+    // N instances of one loaded material: one GPUMaterial, one header, one copy of its instructions
+    constexpr uint32_t kInstances = 1000;
+    const MaterialGraph graph = MakeGraph(glm::vec3(0.9f, 0.2f, 0.1f), 0.3f);
+    const int owner = 0; // Stands in for the MaterialAsset
+
+    Buffers buffers;
+    CountingCompiler compiler;
+    TracerMaterialTable table(buffers.materials, &buffers.headers, &buffers.instrs, compiler.Function());
+
+    const uint32_t first = table.Add(&owner, &graph, ComponentMaterial(glm::vec3(1.0f)), "shared.lmat");
+    CHECK(first == 1);
+    const size_t programSize = buffers.instrs.size();
+    CHECK(programSize > 0);
+
+    bool sameIndex = true;
+    for (uint32_t i = 1; i < kInstances; ++i) {
+        sameIndex &= table.Add(&owner, &graph, ComponentMaterial(glm::vec3(1.0f)), "shared.lmat") == first;
+    }
+    CHECK(sameIndex);
+    CHECK(buffers.materials.size() == 2);
+    CHECK(buffers.headers.size() == 2);
+    CHECK(buffers.instrs.size() == programSize);
+    CHECK(buffers.headers[first].instrCount == programSize);
+    CHECK(buffers.headers[first].instrOffset == 0);
+    CHECK(compiler.calls == 1);
+
+    // Constants come from the graph, not the instance
+    CHECK(std::abs(buffers.materials[first].baseColor.x - 0.45f) < 1e-4f);
+    CHECK(std::abs(buffers.materials[first].roughness - 0.3f) < 1e-4f);
+
+    const TracerMaterialStats stats = table.GetStats();
+    CHECK(stats.instances == kInstances);
+    CHECK(stats.materials == 1);
+    CHECK(stats.graphBuilds == 1);
+    const size_t perInstance =
+        sizeof(gfx::GPUMaterial) + sizeof(gfx::RTMaterialHeader) + programSize * sizeof(gfx::RTMaterialInstr);
+    CHECK(stats.unsharedBytes == kInstances * perInstance);
+    CHECK(stats.sharedBytes == 2 * (sizeof(gfx::GPUMaterial) + sizeof(gfx::RTMaterialHeader)) +
+                                   programSize * sizeof(gfx::RTMaterialInstr));
+    CHECK(table.GetRTLinker() && table.GetRTLinker()->GetMaterialCount() == 1);
+}
+
+void TestIdenticalGraphs() {
+    // The same graph saved under two paths is two assets but one material
+    const MaterialGraph a = MakeGraph(glm::vec3(0.2f, 0.4f, 0.8f), 0.6f);
+    const MaterialGraph b = MakeGraph(glm::vec3(0.2f, 0.4f, 0.8f), 0.6f);
+    const MaterialGraph other = MakeGraph(glm::vec3(0.8f, 0.4f, 0.2f), 0.6f);
+    CHECK(a.ComputeHash() == b.ComputeHash());
+    const int ownerA = 0, ownerB = 0, ownerOther = 0;
+
+    Buffers buffers;
+    CountingCompiler compiler;
+    TracerMaterialTable table(buffers.materials, &buffers.headers, &buffers.instrs, compiler.Function());
+
+    const uint32_t indexA = table.Add(&ownerA, &a, ComponentMaterial(glm::vec3(1.0f)));
+    const size_t programSize = buffers.instrs.size();
+    CHECK(table.Add(&ownerB, &b, ComponentMaterial(glm::vec3(1.0f))) == indexA);
+    CHECK(buffers.instrs.size() == programSize);
+    CHECK(compiler.calls == 1);
+
+    const uint32_t indexOther = table.Add(&ownerOther, &other, ComponentMaterial(glm::vec3(1.0f)));
+    CHECK(indexOther != indexA);
+    CHECK(buffers.materials.size() == 3);
+    CHECK(buffers.headers.size() == 3);
+    CHECK(buffers.instrs.size() == 2 * programSize);
+    CHECK(compiler.calls == 2);
+    CHECK(table.GetStats().graphBuilds == 2);
+}
+
+void TestComponentMaterials() {
+    // Without a graph, instances with the same component values share
+    Buffers buffers;
+    CountingCompiler compiler;
+    TracerMaterialTable table(buffers.materials, &buffers.headers, &buffers.instrs, compiler.Function());
+
+    const uint32_t red = table.Add(nullptr, nullptr, ComponentMaterial(glm::vec3(1.0f, 0.0f, 0.0f)));
+    CHECK(table.Add(nullptr, nullptr, ComponentMaterial(glm::vec3(1.0f, 0.0f, 0.0f))) == red);
+    const uint32_t green = table.Add(nullptr, nullptr, ComponentMaterial(glm::vec3(0.0f, 1.0f, 0.0f)));
+    CHECK(green != red);
+    CHECK(buffers.materials.size() == 3);
+    CHECK(buffers.materials[green].baseColor.y == 1.0f);
+    CHECK(buffers.headers.size() == 3);
+    CHECK(buffers.headers[red].instrCount == 0 && buffers.headers[green].instrCount == 0);
+    CHECK(buffers.instrs.empty());
+    CHECK(compiler.calls == 0);
+
+    // Volumes get constants but no per-hit program
+    MaterialGraph volume;
+    volume.CreateDefault();
+    volume.SetDomain(MaterialDomain::Volume);
+    const int owner = 0;
+    const uint32_t volumeIndex = table.Add(&owner, &volume, ComponentMaterial(glm::vec3(1.0f)));
+    CHECK(volumeIndex == 3);
+    CHECK(buffers.headers.size() == 4 && buffers.headers[volumeIndex].instrCount == 0);
+    CHECK(compiler.calls == 0);
+}
+
+void TestComputeTracer() {
+    // No RT outputs: only the material buffer is written
+    std::vector<gfx::GPUMaterial> materials{ ComponentMaterial(glm::vec3(0.8f)) };
+    TracerMaterialTable table(materials, nullptr, nullptr);
+    CHECK(table.GetRTLinker() == nullptr);
+
+    const MaterialGraph graph = MakeGraph(glm::vec3(0.5f), 0.5f);
+    const int owner = 0;
+    for (int i = 0; i < 10; ++i) table.Add(&owner, &graph, ComponentMaterial(glm::vec3(1.0f)));
+    CHECK(materials.size() == 2);
+
+    const TracerMaterialStats stats = table.GetStats();
+    CHECK(stats.unsharedBytes == 10 * sizeof(gfx::GPUMaterial));
+    CHECK(stats.sharedBytes == 2 * sizeof(gfx::GPUMaterial));
+}
+
+} // namespace
+
+int main() {
+    lucent::Log::Init();
+
+    TestInstancesShare();
+    TestIdenticalGraphs();
+    TestComponentMaterials();
+    TestComputeTracer();
+
+    return lucent::test::Finish("Tracer material");
+}